@@ -214,12 +214,12 @@ extern "C" {
         map->handleShoveGesture(distance);
     }
 
-    JNIEXPORT void JNICALL Java_com_mapzen_tangram_MapController_nativeOnUrlSuccess(JNIEnv* jniEnv, jobject obj, jbyteArray fetchedBytes, jlong callbackPtr) {
-        onUrlSuccess(jniEnv, fetchedBytes, callbackPtr);
+    JNIEXPORT jobject JNICALL Java_com_mapzen_tangram_MapController_nativeGetUrlBodyBuffer(JNIEnv* jniEnv, jobject obj, jlong callbackPtr, jlong size) {
+        return onUrlBodyBuffer(jniEnv, callbackPtr, size);
     }
 
-    JNIEXPORT void JNICALL Java_com_mapzen_tangram_MapController_nativeOnUrlFailure(JNIEnv* jniEnv, jobject obj, jlong callbackPtr) {
-        onUrlFailure(jniEnv, callbackPtr);
+    JNIEXPORT void JNICALL Java_com_mapzen_tangram_MapController_nativeOnUrlComplete(JNIEnv* jniEnv, jobject obj, jlong callbackPtr, jboolean success) {
+        onUrlComplete(jniEnv, callbackPtr, success);
     }
 
     JNIEXPORT void JNICALL Java_com_mapzen_tangram_MapController_nativePickFeature(JNIEnv* jniEnv, jobject obj, jlong mapPtr, jfloat posX, jfloat posY, jobject listener) {
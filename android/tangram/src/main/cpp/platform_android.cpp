@@ -68,6 +68,13 @@ static bool s_isContinuousRendering = false;
 PFNGLBINDVERTEXARRAYOESPROC glBindVertexArrayOESEXT = 0;
 PFNGLDELETEVERTEXARRAYSOESPROC glDeleteVertexArraysOESEXT = 0;
 PFNGLGENVERTEXARRAYSOESPROC glGenVertexArraysOESEXT = 0;
+PFNGLGETPROGRAMBINARYOESPROC glGetProgramBinaryOESEXT = 0;
+PFNGLPROGRAMBINARYOESPROC glProgramBinaryOESEXT = 0;
+PFNGLGENQUERIESEXTPROC glGenQueriesEXTPtr = 0;
+PFNGLDELETEQUERIESEXTPROC glDeleteQueriesEXTPtr = 0;
+PFNGLBEGINQUERYEXTPROC glBeginQueryEXTPtr = 0;
+PFNGLENDQUERYEXTPROC glEndQueryEXTPtr = 0;
+PFNGLGETQUERYOBJECTUIVEXTPROC glGetQueryObjectuivEXTPtr = 0;
 
 // Android assets are distinguished from file paths by the "asset" scheme.
 static const char* aaPrefix = "asset:///";
@@ -320,49 +327,85 @@ std::string resolveScenePath(const char* path) {
     return Tangram::Url(path).resolved("asset:///").string();
 }
 
+// In-flight url request state. The response body vector is owned here so
+// that Java can fill it in place through a direct ByteBuffer instead of
+// materializing a byte[] and copying it across the JNI boundary.
+struct UrlRequest {
+    UrlCallback callback;
+    std::vector<char> content;
+};
+
 bool startUrlRequest(const std::string& _url, UrlCallback _callback) {
 
     JniThreadBinding jniEnv(jvm);
     jstring jUrl = jniEnv->NewStringUTF(_url.c_str());
 
     // This is probably super dangerous. In order to pass a reference to our callback we have to convert it
-    // to a Java type. We allocate a new callback object and then reinterpret the pointer to it as a Java long.
-    // In Java, we associate this long with the current network request and pass it back to native code when
-    // the request completes (either in onUrlSuccess or onUrlFailure), reinterpret the long back into a
-    // pointer, call the callback function if the request succeeded, and delete the heap-allocated UrlCallback
-    // to make sure nothing is leaked.
-    jlong jCallbackPtr = reinterpret_cast<jlong>(new UrlCallback(_callback));
+    // to a Java type. We allocate a new request object and then reinterpret the pointer to it as a Java long.
+    // In Java, we associate this long with the current network request and pass it back to native code as
+    // the body arrives (onUrlBodyBuffer) and when the request completes (onUrlComplete), reinterpret the
+    // long back into a pointer, call the callback function with the accumulated body, and delete the
+    // heap-allocated UrlRequest to make sure nothing is leaked.
+    jlong jCallbackPtr = reinterpret_cast<jlong>(new UrlRequest{_callback, {}});
 
     jboolean methodResult = jniEnv->CallBooleanMethod(tangramInstance, startUrlRequestMID, jUrl, jCallbackPtr);
 
     return methodResult;
 }
 
+bool startUrlRequest(const std::string& _url, const UrlValidators& _validators,
+                     UrlRevalidateCallback _callback) {
+
+    // The Java HttpHandler interface has no request-header support;
+    // fetch in full and report no validators.
+    return startUrlRequest(_url,
+            [callback = std::move(_callback)](std::vector<char>&& _data) mutable {
+                callback(std::move(_data), UrlValidators{}, false);
+            });
+}
+
+bool startUrlRequestStream(const std::string& _url, UrlChunkCallback _chunk,
+                           UrlStreamFinishCallback _finish) {
+
+    // The Java HttpHandler interface only surfaces complete responses;
+    // deliver the body as a single chunk before the finish.
+    return startUrlRequest(_url,
+            [chunk = std::move(_chunk), finish = std::move(_finish)](std::vector<char>&& _data) mutable {
+                if (_data.empty()) {
+                    finish(false, UrlValidators{});
+                    return;
+                }
+                chunk(_data.data(), _data.size());
+                finish(true, UrlValidators{});
+            });
+}
+
 void cancelUrlRequest(const std::string& _url) {
     JniThreadBinding jniEnv(jvm);
     jstring jUrl = jniEnv->NewStringUTF(_url.c_str());
     jniEnv->CallVoidMethod(tangramInstance, cancelUrlRequestMID, jUrl);
 }
 
-void onUrlSuccess(JNIEnv* _jniEnv, jbyteArray _jBytes, jlong _jCallbackPtr) {
-
-    size_t length = _jniEnv->GetArrayLength(_jBytes);
-    std::vector<char> content;
-    content.resize(length);
-
-    _jniEnv->GetByteArrayRegion(_jBytes, 0, length, reinterpret_cast<jbyte*>(content.data()));
+jobject onUrlBodyBuffer(JNIEnv* _jniEnv, jlong _jCallbackPtr, jlong _jSize) {
 
-    UrlCallback* callback = reinterpret_cast<UrlCallback*>(_jCallbackPtr);
-    (*callback)(std::move(content));
-    delete callback;
+    UrlRequest* request = reinterpret_cast<UrlRequest*>(_jCallbackPtr);
+    request->content.resize(_jSize);
+    if (request->content.empty()) {
+        return nullptr;
+    }
+    // The buffer object wraps the vector's storage directly; it is only
+    // valid until onUrlComplete and Java must not retain it beyond that.
+    return _jniEnv->NewDirectByteBuffer(request->content.data(), _jSize);
 }
 
-void onUrlFailure(JNIEnv* _jniEnv, jlong _jCallbackPtr) {
-    std::vector<char> empty;
+void onUrlComplete(JNIEnv* _jniEnv, jlong _jCallbackPtr, jboolean _jSuccess) {
 
-    UrlCallback* callback = reinterpret_cast<UrlCallback*>(_jCallbackPtr);
-    (*callback)(std::move(empty));
-    delete callback;
+    UrlRequest* request = reinterpret_cast<UrlRequest*>(_jCallbackPtr);
+    if (!_jSuccess) {
+        request->content.clear();
+    }
+    request->callback(std::move(request->content));
+    delete request;
 }
 
 void setCurrentThreadPriority(int priority) {
@@ -459,6 +502,13 @@ void initGLExtensions() {
     glBindVertexArrayOESEXT = (PFNGLBINDVERTEXARRAYOESPROC) dlsym(libhandle, "glBindVertexArrayOES");
     glDeleteVertexArraysOESEXT = (PFNGLDELETEVERTEXARRAYSOESPROC) dlsym(libhandle, "glDeleteVertexArraysOES");
     glGenVertexArraysOESEXT = (PFNGLGENVERTEXARRAYSOESPROC) dlsym(libhandle, "glGenVertexArraysOES");
+    glGetProgramBinaryOESEXT = (PFNGLGETPROGRAMBINARYOESPROC) dlsym(libhandle, "glGetProgramBinaryOES");
+    glProgramBinaryOESEXT = (PFNGLPROGRAMBINARYOESPROC) dlsym(libhandle, "glProgramBinaryOES");
+    glGenQueriesEXTPtr = (PFNGLGENQUERIESEXTPROC) dlsym(libhandle, "glGenQueriesEXT");
+    glDeleteQueriesEXTPtr = (PFNGLDELETEQUERIESEXTPROC) dlsym(libhandle, "glDeleteQueriesEXT");
+    glBeginQueryEXTPtr = (PFNGLBEGINQUERYEXTPROC) dlsym(libhandle, "glBeginQueryEXT");
+    glEndQueryEXTPtr = (PFNGLENDQUERYEXTPROC) dlsym(libhandle, "glEndQueryEXT");
+    glGetQueryObjectuivEXTPtr = (PFNGLGETQUERYOBJECTUIVEXTPROC) dlsym(libhandle, "glGetQueryObjectuivEXT");
 }
 
 std::string stringFromJString(JNIEnv* jniEnv, jstring string) {
@@ -7,8 +7,8 @@
 
 void bindJniEnvToThread(JNIEnv* jniEnv);
 void setupJniEnv(JNIEnv* _jniEnv, jobject _tangramInstance, jobject _assetManager);
-void onUrlSuccess(JNIEnv* jniEnv, jbyteArray jFetchedBytes, jlong jCallbackPtr);
-void onUrlFailure(JNIEnv* jniEnv, jlong jCallbackPtr);
+jobject onUrlBodyBuffer(JNIEnv* jniEnv, jlong jCallbackPtr, jlong jSize);
+void onUrlComplete(JNIEnv* jniEnv, jlong jCallbackPtr, jboolean jSuccess);
 
 namespace Tangram {
 struct LabelPickResult;
@@ -11,8 +11,11 @@ import com.mapzen.tangram.TouchInput.Gestures;
 import okhttp3.Call;
 import okhttp3.Callback;
 import okhttp3.Response;
+import okio.Buffer;
+import okio.BufferedSource;
 
 import java.io.IOException;
+import java.nio.ByteBuffer;
 import java.util.ArrayList;
 import java.util.HashMap;
 import java.util.Iterator;
@@ -1004,8 +1007,8 @@ public class MapController implements Renderer {
     private synchronized native void nativeUseCachedGlState(long mapPtr, boolean use);
     private synchronized native void nativeCaptureSnapshot(long mapPtr, int[] buffer);
 
-    private native void nativeOnUrlSuccess(byte[] rawDataBytes, long callbackPtr);
-    private native void nativeOnUrlFailure(long callbackPtr);
+    private native ByteBuffer nativeGetUrlBodyBuffer(long callbackPtr, long size);
+    private native void nativeOnUrlComplete(long callbackPtr, boolean success);
 
     synchronized native long nativeAddDataSource(long mapPtr, String name);
     synchronized native void nativeRemoveDataSource(long mapPtr, long sourcePtr);
@@ -1094,17 +1097,32 @@ public class MapController implements Renderer {
         httpHandler.onRequest(url, new Callback() {
             @Override
             public void onFailure(Call call, IOException e) {
-                nativeOnUrlFailure(callbackPtr);
+                nativeOnUrlComplete(callbackPtr, false);
             }
 
             @Override
             public void onResponse(Call call, Response response) throws IOException {
                 if (!response.isSuccessful()) {
-                    nativeOnUrlFailure(callbackPtr);
+                    nativeOnUrlComplete(callbackPtr, false);
                     throw new IOException("Unexpected response code: " + response);
                 }
-                byte[] bytes = response.body().bytes();
-                nativeOnUrlSuccess(bytes, callbackPtr);
+                // Drain the body straight into native memory: the buffer
+                // returned by nativeGetUrlBodyBuffer wraps the request's
+                // native storage, so no byte[] copy of the body is made.
+                boolean ok = false;
+                try {
+                    BufferedSource source = response.body().source();
+                    source.request(Long.MAX_VALUE);
+                    Buffer buffer = source.buffer();
+                    ByteBuffer body = nativeGetUrlBodyBuffer(callbackPtr, buffer.size());
+                    while (body != null && body.hasRemaining()) {
+                        buffer.read(body);
+                    }
+                    ok = true;
+                } finally {
+                    response.body().close();
+                    nativeOnUrlComplete(callbackPtr, ok);
+                }
             }
         });
         return true;
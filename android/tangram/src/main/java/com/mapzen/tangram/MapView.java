@@ -112,7 +112,15 @@ public class MapView extends FrameLayout {
         glSurfaceView = new GLSurfaceView(getContext());
         glSurfaceView.setEGLContextClientVersion(2);
         glSurfaceView.setPreserveEGLContextOnPause(true);
-        glSurfaceView.setEGLConfigChooser(new ConfigChooser(8, 8, 8, 0, 16, 0));
+        ConfigChooser configChooser = new ConfigChooser(8, 8, 8, 0, 16, 0);
+        glSurfaceView.setEGLConfigChooser(configChooser);
+
+        WarmUpContextFactory contextFactory = new WarmUpContextFactory();
+        glSurfaceView.setEGLContextFactory(contextFactory);
+
+        // Start preparing GL driver state now, while the Activity is still initializing;
+        // the surface's rendering context will join the warmed share group when it is created.
+        contextFactory.warmUpAsync(configChooser);
 
     }
 
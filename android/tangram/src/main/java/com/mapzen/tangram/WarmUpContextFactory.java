@@ -0,0 +1,201 @@
+package com.mapzen.tangram;
+
+import android.opengl.GLES20;
+import android.opengl.GLSurfaceView;
+import android.util.Log;
+
+import javax.microedition.khronos.egl.EGL10;
+import javax.microedition.khronos.egl.EGLConfig;
+import javax.microedition.khronos.egl.EGLContext;
+import javax.microedition.khronos.egl.EGLDisplay;
+import javax.microedition.khronos.egl.EGLSurface;
+
+/**
+ * {@code WarmUpContextFactory} prepares GL driver state on a background thread before the
+ * {@code GLSurfaceView} surface exists, then creates the view's rendering context in the same
+ * share group. Compiling a representative shader program and allocating a texture ahead of the
+ * first frame pulls the driver's shader compiler and texture allocator into memory while the
+ * Activity is still initializing, so the first real frame only pays for the map's own work.
+ */
+class WarmUpContextFactory implements GLSurfaceView.EGLContextFactory {
+
+    private static final String TAG = "Tangram";
+
+    private static final int EGL_CONTEXT_CLIENT_VERSION = 0x3098;
+    private static final int[] CONTEXT_ATTRIBUTES = { EGL_CONTEXT_CLIENT_VERSION, 2, EGL10.EGL_NONE };
+
+    // A small program shaped like the map's tile shaders: enough to make the driver load and
+    // run its GLSL compiler, which dominates first-compile time on most mobile GPUs.
+    private static final String WARM_UP_VS =
+            "uniform mat4 u_mvp;\n" +
+            "attribute vec4 a_position;\n" +
+            "attribute vec2 a_texcoord;\n" +
+            "varying vec2 v_texcoord;\n" +
+            "void main() {\n" +
+            "    v_texcoord = a_texcoord;\n" +
+            "    gl_Position = u_mvp * a_position;\n" +
+            "}\n";
+
+    private static final String WARM_UP_FS =
+            "precision mediump float;\n" +
+            "uniform sampler2D u_tex;\n" +
+            "uniform vec4 u_color;\n" +
+            "varying vec2 v_texcoord;\n" +
+            "void main() {\n" +
+            "    gl_FragColor = texture2D(u_tex, v_texcoord) * u_color;\n" +
+            "}\n";
+
+    // The warm-up thread publishes its context here; the GL thread consumes it once as the
+    // share context for the view's rendering context. Guarded by this.
+    private EGLContext warmUpContext = EGL10.EGL_NO_CONTEXT;
+    private boolean warmUpStarted = false;
+    private boolean warmUpContextReady = false;
+
+    /**
+     * Start driver warm-up on a background thread; safe to call once, as early as possible.
+     * @param configChooser The chooser the {@code GLSurfaceView} will use, so the warm-up
+     * context is created against a compatible framebuffer configuration
+     */
+    synchronized void warmUpAsync(final GLSurfaceView.EGLConfigChooser configChooser) {
+
+        if (warmUpStarted) {
+            return;
+        }
+        warmUpStarted = true;
+
+        new Thread(new Runnable() {
+            @Override
+            public void run() {
+                warmUp(configChooser);
+            }
+        }, "Tangram GL warm-up").start();
+
+    }
+
+    void warmUp(GLSurfaceView.EGLConfigChooser configChooser) {
+
+        EGL10 egl = (EGL10) EGLContext.getEGL();
+
+        EGLDisplay display = egl.eglGetDisplay(EGL10.EGL_DEFAULT_DISPLAY);
+        egl.eglInitialize(display, new int[2]);
+
+        EGLConfig config = configChooser.chooseConfig(egl, display);
+        EGLContext context = egl.eglCreateContext(display, config, EGL10.EGL_NO_CONTEXT, CONTEXT_ATTRIBUTES);
+
+        synchronized (this) {
+            warmUpContext = context;
+            warmUpContextReady = true;
+            notifyAll();
+        }
+
+        if (context == EGL10.EGL_NO_CONTEXT) {
+            Log.w(TAG, "GL warm-up context creation failed");
+            return;
+        }
+
+        int[] surfaceAttributes = { EGL10.EGL_WIDTH, 1, EGL10.EGL_HEIGHT, 1, EGL10.EGL_NONE };
+        EGLSurface surface = egl.eglCreatePbufferSurface(display, config, surfaceAttributes);
+
+        if (surface != EGL10.EGL_NO_SURFACE) {
+            if (egl.eglMakeCurrent(display, surface, surface, context)) {
+                warmUpDriver();
+                egl.eglMakeCurrent(display, EGL10.EGL_NO_SURFACE, EGL10.EGL_NO_SURFACE, EGL10.EGL_NO_CONTEXT);
+            }
+            egl.eglDestroySurface(display, surface);
+        }
+
+        // The context itself stays alive until the rendering context has joined its share
+        // group in createContext.
+
+    }
+
+    private void warmUpDriver() {
+
+        int vertexShader = GLES20.glCreateShader(GLES20.GL_VERTEX_SHADER);
+        GLES20.glShaderSource(vertexShader, WARM_UP_VS);
+        GLES20.glCompileShader(vertexShader);
+
+        int fragmentShader = GLES20.glCreateShader(GLES20.GL_FRAGMENT_SHADER);
+        GLES20.glShaderSource(fragmentShader, WARM_UP_FS);
+        GLES20.glCompileShader(fragmentShader);
+
+        int program = GLES20.glCreateProgram();
+        GLES20.glAttachShader(program, vertexShader);
+        GLES20.glAttachShader(program, fragmentShader);
+        GLES20.glLinkProgram(program);
+
+        GLES20.glDeleteShader(vertexShader);
+        GLES20.glDeleteShader(fragmentShader);
+        GLES20.glDeleteProgram(program);
+
+        // Touch the texture allocation path with an atlas-sized upload.
+        int[] texture = new int[1];
+        GLES20.glGenTextures(1, texture, 0);
+        GLES20.glBindTexture(GLES20.GL_TEXTURE_2D, texture[0]);
+        GLES20.glTexImage2D(GLES20.GL_TEXTURE_2D, 0, GLES20.GL_RGBA, 256, 256, 0,
+                GLES20.GL_RGBA, GLES20.GL_UNSIGNED_BYTE, null);
+        GLES20.glDeleteTextures(1, texture, 0);
+
+        GLES20.glFinish();
+
+    }
+
+    private synchronized EGLContext takeWarmUpContext() {
+
+        if (!warmUpStarted) {
+            return EGL10.EGL_NO_CONTEXT;
+        }
+
+        // The warm-up thread publishes its context right after creation; only an early
+        // surface can race it, so the wait here is short and bounded.
+        long deadline = System.currentTimeMillis() + 1000;
+        while (!warmUpContextReady) {
+            long remaining = deadline - System.currentTimeMillis();
+            if (remaining <= 0) {
+                break;
+            }
+            try {
+                wait(remaining);
+            } catch (InterruptedException e) {
+                break;
+            }
+        }
+
+        EGLContext context = warmUpContext;
+        warmUpContext = EGL10.EGL_NO_CONTEXT;
+        return context;
+
+    }
+
+    @Override
+    public EGLContext createContext(EGL10 egl, EGLDisplay display, EGLConfig config) {
+
+        EGLContext shareContext = takeWarmUpContext();
+
+        EGLContext context = egl.eglCreateContext(display, config, shareContext, CONTEXT_ATTRIBUTES);
+
+        if (context == EGL10.EGL_NO_CONTEXT && shareContext != EGL10.EGL_NO_CONTEXT) {
+            // Sharing can fail across incompatible configurations; a standalone context
+            // still renders correctly, it just forgoes the warmed share group.
+            Log.w(TAG, "Falling back to an unshared GL context");
+            context = egl.eglCreateContext(display, config, EGL10.EGL_NO_CONTEXT, CONTEXT_ATTRIBUTES);
+        }
+
+        if (shareContext != EGL10.EGL_NO_CONTEXT) {
+            // The share group holds the warmed driver state; the warm-up context itself is
+            // no longer needed.
+            egl.eglDestroyContext(display, shareContext);
+        }
+
+        return context;
+
+    }
+
+    @Override
+    public void destroyContext(EGL10 egl, EGLDisplay display, EGLContext context) {
+
+        egl.eglDestroyContext(display, context);
+
+    }
+
+}
@@ -10,7 +10,7 @@
 
 using namespace Tangram;
 
-std::vector<glm::vec3> line = {
+Line line = {
     {0.0, 0.0, 0.0},
     {1.0, 0.0, 0.0},
     {1.0, 1.0, 0.0},
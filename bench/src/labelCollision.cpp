@@ -0,0 +1,156 @@
+#include "tangram.h"
+#include "gl.h"
+
+#include "labels/labelCollider.h"
+#include "labels/labels.h"
+#include "labels/textLabel.h"
+#include "labels/textLabels.h"
+#include "style/textStyle.h"
+#include "tile/tile.h"
+#include "view/view.h"
+
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "benchmark/benchmark_api.h"
+#include "benchmark/benchmark.h"
+
+using namespace Tangram;
+
+namespace {
+
+TextStyle dummyStyle("textStyle", nullptr);
+TextLabels dummyMesh(dummyStyle);
+
+// Deterministic stand-in for a recorded city viewport: point labels in
+// dense clusters (POIs around intersections) and line labels along
+// street-like segments, with mixed priorities and a few repeat groups.
+std::vector<std::unique_ptr<Label>> makeCityLabelSet(size_t _count) {
+
+    std::mt19937 rng(0xc0117de);
+    std::uniform_real_distribution<float> unit(0.f, 1.f);
+    std::normal_distribution<float> jitter(0.f, 0.02f);
+
+    std::vector<glm::vec2> clusters;
+    for (int i = 0; i < 24; i++) {
+        clusters.push_back({unit(rng), unit(rng)});
+    }
+
+    std::vector<std::unique_ptr<Label>> labels;
+    labels.reserve(_count);
+
+    for (size_t i = 0; i < _count; i++) {
+        Label::Options options;
+        options.anchors.anchor[0] = LabelProperty::Anchor::center;
+        options.anchors.count = 1;
+        options.priority = float(rng() % 10);
+
+        if (i % 8 == 0) {
+            options.repeatGroup = rng() % 4;
+            options.repeatDistance = 256.f;
+        }
+
+        if (i % 4 == 3) {
+            // Street segment label
+            glm::vec2 p0 = {unit(rng), unit(rng)};
+            glm::vec2 p1 = p0 + glm::vec2(jitter(rng) * 4.f, jitter(rng) * 4.f);
+
+            labels.push_back(std::make_unique<TextLabel>(
+                    Label::WorldTransform{p0, p1}, Label::Type::line, options,
+                    TextLabel::VertexAttributes{}, glm::vec2{48, 12},
+                    dummyMesh, TextRange{}, TextLabelProperty::Align::none));
+        } else {
+            // Point label near a cluster center
+            glm::vec2 center = clusters[rng() % clusters.size()];
+            glm::vec2 p = center + glm::vec2(jitter(rng), jitter(rng));
+
+            labels.push_back(std::make_unique<TextLabel>(
+                    Label::WorldTransform{glm::vec3(p, 0.f)}, Label::Type::point, options,
+                    TextLabel::VertexAttributes{}, glm::vec2{42, 14},
+                    dummyMesh, TextRange{}, TextLabelProperty::Align::none));
+        }
+    }
+    return labels;
+}
+
+class BenchLabels : public Labels {
+public:
+    BenchLabels(const ViewState& _viewState) {
+        m_isect2d.resize({_viewState.viewportSize.x / 256, _viewState.viewportSize.y / 256},
+                         {_viewState.viewportSize.x, _viewState.viewportSize.y});
+    }
+
+    void addLabel(Label* _label, Tile* _tile) {
+        m_labels.push_back({_label, _tile, false});
+    }
+
+    // The occlusion and fade part of updateLabelSet(), without the
+    // tile/style traversal.
+    void frame(const ViewState& _viewState, float _dt) {
+        sortLabels();
+        handleOcclusions(_viewState);
+        for (auto& entry : m_labels) {
+            entry.label->evalState(_dt);
+        }
+    }
+};
+
+} // namespace
+
+// Build-time collision on a worker thread: one dense tile through
+// LabelCollider::process.
+static void BM_Tangram_LabelColliderProcess(benchmark::State& state) {
+
+    MercatorProjection projection;
+    Tile tile({0, 0, 0}, projection);
+
+    while (state.KeepRunning()) {
+        state.PauseTiming();
+        auto labels = makeCityLabelSet(2000);
+        LabelCollider collider;
+        collider.addLabels(labels);
+        state.ResumeTiming();
+
+        collider.process(tile.getID(), tile.getInverseScale(), 512.f);
+    }
+}
+BENCHMARK(BM_Tangram_LabelColliderProcess);
+
+// Per-frame collision and fade across a simulated pan: every frame moves
+// the view, reprojects each label and runs a full occlusion pass, so one
+// iteration corresponds to one worst-case frame.
+static void BM_Tangram_LabelFrameUpdate(benchmark::State& state) {
+
+    View view(1024, 768);
+    view.setPosition(0, 0);
+    view.setZoom(0);
+    view.update(false);
+
+    Tile tile({0, 0, 0}, view.getMapProjection());
+    tile.update(0, view);
+
+    auto labels = makeCityLabelSet(2000);
+
+    BenchLabels benchLabels(view.state());
+    for (auto& label : labels) {
+        benchLabels.addLabel(label.get(), &tile);
+    }
+
+    double position = 0;
+    while (state.KeepRunning()) {
+        position += 0.0005;
+        view.setPosition(position, 0);
+        view.update(false);
+        tile.update(0.016f, view);
+
+        for (auto& label : labels) {
+            label->update(tile.mvp(), view.state());
+        }
+
+        benchLabels.frame(view.state(), 0.016f);
+    }
+}
+BENCHMARK(BM_Tangram_LabelFrameUpdate);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,199 @@
+#include "tangram.h"
+#include "gl.h"
+#include "log.h"
+#include "data/dataSource.h"
+#include "data/mvtSource.h"
+#include "tile/tileTask.h"
+#include "util/builders.h"
+#include "util/mapProjection.h"
+
+#include <chrono>
+#include <dirent.h>
+#include <fstream>
+#include <map>
+#include <vector>
+
+#include "benchmark/benchmark_api.h"
+#include "benchmark/benchmark.h"
+
+using namespace Tangram;
+
+// Corpus-driven tessellation benchmark. Loads every recorded MVT tile
+// from the 'tiles' directory next to the executable (e.g. downtown,
+// suburb and coastline captures), runs the polygon and polyline
+// builders over each layer, and reports aggregate vertex throughput as
+// items/s. Per-layer feature, vertex and time breakdowns are logged
+// once at startup so a regression can be narrowed down to a layer
+// without re-instrumenting.
+
+namespace {
+
+struct Corpus {
+
+    MercatorProjection projection;
+
+    std::shared_ptr<DataSource> source =
+        std::make_shared<MVTSource>("corpus", "", 0, 18, 18);
+
+    std::vector<std::shared_ptr<TileData>> tiles;
+
+    void load(const char* _path) {
+
+        DIR* dir = opendir(_path);
+        if (!dir) {
+            LOGE("No tile corpus at '%s' - benchmarks will run empty", _path);
+            return;
+        }
+
+        while (dirent* entry = readdir(dir)) {
+            std::string name = entry->d_name;
+            if (name.size() < 4 || name.compare(name.size() - 4, 4, ".mvt") != 0) {
+                continue;
+            }
+            loadTile(std::string(_path) + "/" + name);
+        }
+        closedir(dir);
+
+        logLayerStats();
+    }
+
+    void loadTile(const std::string& _file) {
+
+        std::ifstream resource(_file, std::ifstream::ate | std::ifstream::binary);
+        if (!resource.is_open()) {
+            LOGE("Failed to read tile: %s", _file.c_str());
+            return;
+        }
+
+        size_t size = resource.tellg();
+        resource.seekg(std::ifstream::beg);
+
+        auto rawData = std::make_shared<std::vector<char>>(size);
+        resource.read(rawData->data(), size);
+        resource.close();
+
+        auto task = source->createTask({0, 0, 10, 10, 0});
+        auto& downloadTask = dynamic_cast<DownloadTileTask&>(*task);
+        downloadTask.rawTileData = rawData;
+
+        auto tileData = source->parse(*task, projection);
+        if (tileData) {
+            tiles.push_back(tileData);
+        } else {
+            LOGE("Failed to parse tile: %s", _file.c_str());
+        }
+    }
+
+    // Builds each layer once, logging features, vertices and time so
+    // per-layer throughput is visible next to the aggregate numbers.
+    void logLayerStats() {
+
+        struct Stats {
+            size_t features = 0;
+            size_t vertices = 0;
+            double milliseconds = 0;
+        };
+        std::map<std::string, Stats> layers;
+
+        PolygonBuilder polygonBuilder([](const glm::vec3&, const glm::vec3&, const glm::vec2&){}, false);
+        PolyLineBuilder polyLineBuilder([](const glm::vec3&, const glm::vec2&, const glm::vec2&){});
+
+        for (const auto& tile : tiles) {
+            for (const auto& layer : tile->layers) {
+                auto& stats = layers[layer.name];
+
+                auto start = std::chrono::steady_clock::now();
+
+                for (const auto& feature : layer.features) {
+                    if (feature.geometryType == GeometryType::polygons) {
+                        for (const auto& polygon : feature.polygons) {
+                            Builders::buildPolygon(polygon, 0.f, polygonBuilder);
+                        }
+                        stats.features++;
+                        stats.vertices += polygonBuilder.numVertices;
+                        polygonBuilder.clear();
+                    } else if (feature.geometryType == GeometryType::lines) {
+                        for (const auto& line : feature.lines) {
+                            Builders::buildPolyLine(line, polyLineBuilder);
+                        }
+                        stats.features++;
+                        stats.vertices += polyLineBuilder.numVertices;
+                        polyLineBuilder.clear();
+                    }
+                }
+
+                std::chrono::duration<double, std::milli> elapsed =
+                    std::chrono::steady_clock::now() - start;
+                stats.milliseconds += elapsed.count();
+            }
+        }
+
+        LOG("Corpus: %d tiles", (int)tiles.size());
+        for (const auto& entry : layers) {
+            const auto& s = entry.second;
+            LOG("Layer %-16s features:%6d vertices:%8d time:%8.3fms",
+                entry.first.c_str(), (int)s.features, (int)s.vertices, s.milliseconds);
+        }
+    }
+};
+
+Corpus& corpus() {
+    static Corpus instance;
+    static bool loaded = (instance.load("tiles"), true);
+    (void)loaded;
+    return instance;
+}
+
+}
+
+static void BM_CorpusBuildPolygons(benchmark::State& state) {
+    auto& c = corpus();
+    size_t vertices = 0;
+
+    while (state.KeepRunning()) {
+        vertices = 0;
+        PolygonBuilder builder([](const glm::vec3&, const glm::vec3&, const glm::vec2&){}, false);
+
+        for (const auto& tile : c.tiles) {
+            for (const auto& layer : tile->layers) {
+                for (const auto& feature : layer.features) {
+                    if (feature.geometryType != GeometryType::polygons) { continue; }
+                    for (const auto& polygon : feature.polygons) {
+                        Builders::buildPolygon(polygon, 0.f, builder);
+                    }
+                    vertices += builder.numVertices;
+                    builder.clear();
+                }
+            }
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * vertices);
+}
+BENCHMARK(BM_CorpusBuildPolygons);
+
+static void BM_CorpusBuildPolyLines(benchmark::State& state) {
+    auto& c = corpus();
+    size_t vertices = 0;
+
+    while (state.KeepRunning()) {
+        vertices = 0;
+        PolyLineBuilder builder([](const glm::vec3&, const glm::vec2&, const glm::vec2&){});
+
+        for (const auto& tile : c.tiles) {
+            for (const auto& layer : tile->layers) {
+                for (const auto& feature : layer.features) {
+                    if (feature.geometryType != GeometryType::lines) { continue; }
+                    for (const auto& line : feature.lines) {
+                        Builders::buildPolyLine(line, builder);
+                    }
+                    vertices += builder.numVertices;
+                    builder.clear();
+                }
+            }
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * vertices);
+}
+BENCHMARK(BM_CorpusBuildPolyLines);
+
+BENCHMARK_MAIN();
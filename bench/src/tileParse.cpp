@@ -0,0 +1,182 @@
+#include "log.h"
+#include "data/tileData.h"
+#include "util/pbfParser.h"
+
+#include <chrono>
+#include <dirent.h>
+#include <fstream>
+#include <map>
+#include <vector>
+
+#include "benchmark/benchmark_api.h"
+#include "benchmark/benchmark.h"
+
+using namespace Tangram;
+
+// Parse-only MVT benchmark. Loads the raw bytes of every recorded tile
+// from the 'tiles' directory next to the executable and runs them
+// through PbfParser, without the filter and build stages that the
+// tileLoading benchmark includes. Aggregate feature, property and byte
+// throughput is reported as the benchmark counters; a per-layer
+// breakdown is logged once at startup so a parser regression can be
+// narrowed down to a layer.
+
+namespace {
+
+struct ParseCounters {
+    size_t features = 0;
+    size_t properties = 0;
+    size_t bytes = 0;
+};
+
+struct RawCorpus {
+
+    std::vector<std::vector<char>> tiles;
+
+    void load(const char* _path) {
+
+        DIR* dir = opendir(_path);
+        if (!dir) {
+            LOGE("No tile corpus at '%s' - benchmarks will run empty", _path);
+            return;
+        }
+
+        while (dirent* entry = readdir(dir)) {
+            std::string name = entry->d_name;
+            if (name.size() < 4 || name.compare(name.size() - 4, 4, ".mvt") != 0) {
+                continue;
+            }
+            loadTile(std::string(_path) + "/" + name);
+        }
+        closedir(dir);
+
+        logLayerStats();
+    }
+
+    void loadTile(const std::string& _file) {
+
+        std::ifstream resource(_file, std::ifstream::ate | std::ifstream::binary);
+        if (!resource.is_open()) {
+            LOGE("Failed to read tile: %s", _file.c_str());
+            return;
+        }
+
+        size_t size = resource.tellg();
+        resource.seekg(std::ifstream::beg);
+
+        std::vector<char> rawData(size);
+        resource.read(rawData.data(), size);
+        resource.close();
+
+        tiles.push_back(std::move(rawData));
+    }
+
+    // Parse every tile once, splitting counts and time out per layer.
+    // The loop mirrors MVTSource::parse with a timer around getLayer().
+    void logLayerStats() {
+
+        struct Stats {
+            size_t features = 0;
+            size_t properties = 0;
+            size_t bytes = 0;
+            double milliseconds = 0;
+        };
+        std::map<std::string, Stats> layers;
+
+        for (const auto& rawData : tiles) {
+            protobuf::message item(rawData.data(), rawData.size());
+            PbfParser::ParserContext ctx(0);
+
+            try {
+                while (item.next()) {
+                    if (item.tag != 3) { item.skip(); continue; }
+
+                    auto layerMsg = item.getMessage();
+                    size_t layerBytes = layerMsg.getEnd() - layerMsg.getData();
+
+                    auto start = std::chrono::steady_clock::now();
+                    auto layer = PbfParser::getLayer(ctx, layerMsg);
+                    std::chrono::duration<double, std::milli> elapsed =
+                        std::chrono::steady_clock::now() - start;
+
+                    auto& stats = layers[layer.name];
+                    stats.features += layer.features.size();
+                    for (const auto& feature : layer.features) {
+                        stats.properties += feature.props.items().size();
+                    }
+                    stats.bytes += layerBytes;
+                    stats.milliseconds += elapsed.count();
+                }
+            } catch (const std::exception& e) {
+                LOGE("Cannot parse corpus tile: %s", e.what());
+            }
+        }
+
+        LOG("Corpus: %d tiles", (int)tiles.size());
+        for (const auto& entry : layers) {
+            const auto& s = entry.second;
+            LOG("Layer %-16s features:%6d properties:%7d bytes:%8d time:%8.3fms",
+                entry.first.c_str(), (int)s.features, (int)s.properties,
+                (int)s.bytes, s.milliseconds);
+        }
+    }
+
+    // One full parse pass over the corpus, as the benchmarks run it
+    void parseAll(ParseCounters& _counters) const {
+
+        for (const auto& rawData : tiles) {
+            protobuf::message item(rawData.data(), rawData.size());
+            PbfParser::ParserContext ctx(0);
+
+            while (item.next()) {
+                if (item.tag != 3) { item.skip(); continue; }
+
+                auto layer = PbfParser::getLayer(ctx, item.getMessage());
+                _counters.features += layer.features.size();
+                for (const auto& feature : layer.features) {
+                    _counters.properties += feature.props.items().size();
+                }
+            }
+            _counters.bytes += rawData.size();
+        }
+    }
+};
+
+RawCorpus& corpus() {
+    static RawCorpus instance;
+    static bool loaded = (instance.load("tiles"), true);
+    (void)loaded;
+    return instance;
+}
+
+}
+
+// Features/s as items and raw MVT bytes/s
+static void BM_CorpusParseFeatures(benchmark::State& state) {
+    auto& c = corpus();
+    ParseCounters counters;
+
+    while (state.KeepRunning()) {
+        counters = {};
+        c.parseAll(counters);
+    }
+    state.SetItemsProcessed(state.iterations() * counters.features);
+    state.SetBytesProcessed(state.iterations() * counters.bytes);
+}
+BENCHMARK(BM_CorpusParseFeatures);
+
+// Same parse with decoded properties as items, for tracking the
+// key/value interning work separately from geometry decoding
+static void BM_CorpusParseProperties(benchmark::State& state) {
+    auto& c = corpus();
+    ParseCounters counters;
+
+    while (state.KeepRunning()) {
+        counters = {};
+        c.parseAll(counters);
+    }
+    state.SetItemsProcessed(state.iterations() * counters.properties);
+}
+BENCHMARK(BM_CorpusParseProperties);
+
+BENCHMARK_MAIN();
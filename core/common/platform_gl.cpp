@@ -24,6 +24,9 @@ void GL::lineWidth(GLfloat width) {
 void GL::viewport(GLint x, GLint y, GLsizei width, GLsizei height) {
     GL_CHECK(glViewport(x, y, width, height));
 }
+void GL::scissor(GLint x, GLint y, GLsizei width, GLsizei height) {
+    GL_CHECK(glScissor(x, y, width, height));
+}
 
 void GL::enable(GLenum id) {
     GL_CHECK(glEnable(id));
@@ -177,6 +180,11 @@ void GL::texSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset,
                        GLenum format, GLenum type, const GLvoid *pixels) {
     GL_CHECK(glTexSubImage2D(target, level, xoffset, yoffset, width, height, format, type, pixels)); }
 
+void GL::compressedTexImage2D(GLenum target, GLint level, GLenum internalformat,
+                              GLsizei width, GLsizei height, GLint border,
+                              GLsizei imageSize, const GLvoid *data) {
+    GL_CHECK(glCompressedTexImage2D(target, level, internalformat, width, height, border, imageSize, data)); }
+
 void GL::generateMipmap(GLenum target) {
     GL_CHECK(glGenerateMipmap(target));
 }
@@ -272,6 +280,23 @@ GLboolean GL::unmapBuffer(GLenum target) {
     return result;
 }
 
+// Timer queries
+void GL::genQueries(GLsizei n, GLuint *ids) {
+    GL_CHECK(glGenQueries(n, ids));
+}
+void GL::deleteQueries(GLsizei n, const GLuint *ids) {
+    GL_CHECK(glDeleteQueries(n, ids));
+}
+void GL::beginQuery(GLenum target, GLuint id) {
+    GL_CHECK(glBeginQuery(target, id));
+}
+void GL::endQuery(GLenum target) {
+    GL_CHECK(glEndQuery(target));
+}
+void GL::getQueryObjectuiv(GLuint id, GLenum pname, GLuint *params) {
+    GL_CHECK(glGetQueryObjectuiv(id, pname, params));
+}
+
 void GL::finish(void) {
     GL_CHECK(glFinish());
 }
@@ -287,6 +312,22 @@ void GL::genVertexArrays(GLsizei n, GLuint *arrays) {
     GL_CHECK(glGenVertexArrays(n, arrays));
 }
 
+// Program binary
+void GL::getProgramBinary(GLuint program, GLsizei bufSize, GLsizei *length,
+                          GLenum *binaryFormat, void *binary) {
+#if defined(PLATFORM_ANDROID) || defined(PLATFORM_LINUX)
+    GL_CHECK(glGetProgramBinary(program, bufSize, length, binaryFormat, binary));
+#else
+    // Not exposed on this platform; Hardware::supportsProgramBinary stays false.
+    if (length) { *length = 0; }
+#endif
+}
+void GL::programBinary(GLuint program, GLenum binaryFormat, const void *binary, GLsizei length) {
+#if defined(PLATFORM_ANDROID) || defined(PLATFORM_LINUX)
+    GL_CHECK(glProgramBinary(program, binaryFormat, binary, length));
+#endif
+}
+
 // Framebuffer
 void GL::bindFramebuffer(GLenum target, GLuint framebuffer) {
     GL_CHECK(glBindFramebuffer(target, framebuffer));
@@ -13,10 +13,24 @@
 extern PFNGLBINDVERTEXARRAYOESPROC glBindVertexArrayOESEXT;
 extern PFNGLDELETEVERTEXARRAYSOESPROC glDeleteVertexArraysOESEXT;
 extern PFNGLGENVERTEXARRAYSOESPROC glGenVertexArraysOESEXT;
+extern PFNGLGETPROGRAMBINARYOESPROC glGetProgramBinaryOESEXT;
+extern PFNGLPROGRAMBINARYOESPROC glProgramBinaryOESEXT;
+extern PFNGLGENQUERIESEXTPROC glGenQueriesEXTPtr;
+extern PFNGLDELETEQUERIESEXTPROC glDeleteQueriesEXTPtr;
+extern PFNGLBEGINQUERYEXTPROC glBeginQueryEXTPtr;
+extern PFNGLENDQUERYEXTPROC glEndQueryEXTPtr;
+extern PFNGLGETQUERYOBJECTUIVEXTPROC glGetQueryObjectuivEXTPtr;
 
 #define glDeleteVertexArrays glDeleteVertexArraysOESEXT
 #define glGenVertexArrays glGenVertexArraysOESEXT
 #define glBindVertexArray glBindVertexArrayOESEXT
+#define glGetProgramBinary glGetProgramBinaryOESEXT
+#define glProgramBinary glProgramBinaryOESEXT
+#define glGenQueries glGenQueriesEXTPtr
+#define glDeleteQueries glDeleteQueriesEXTPtr
+#define glBeginQuery glBeginQueryEXTPtr
+#define glEndQuery glEndQueryEXTPtr
+#define glGetQueryObjectuiv glGetQueryObjectuivEXTPtr
 #endif
 
 #ifdef PLATFORM_IOS
@@ -25,6 +39,11 @@ extern PFNGLGENVERTEXARRAYSOESPROC glGenVertexArraysOESEXT;
 #define glDeleteVertexArrays glDeleteVertexArraysOES
 #define glGenVertexArrays glGenVertexArraysOES
 #define glBindVertexArray glBindVertexArrayOES
+#define glGenQueries glGenQueriesEXT
+#define glDeleteQueries glDeleteQueriesEXT
+#define glBeginQuery glBeginQueryEXT
+#define glEndQuery glEndQueryEXT
+#define glGetQueryObjectuiv glGetQueryObjectuivEXT
 #endif
 
 #ifdef PLATFORM_OSX
@@ -60,6 +79,13 @@ static void glBindVertexArray(GLuint array) {}
 static void glDeleteVertexArrays(GLsizei n, const GLuint *arrays) {}
 static void glGenVertexArrays(GLsizei n, GLuint *arrays) {}
 
+// Dummy timer query functions; Hardware::supportsTimerQuery stays false
+static void glGenQueries(GLsizei n, GLuint *ids) { for (GLsizei i = 0; i < n; i++) { ids[i] = 0; } }
+static void glDeleteQueries(GLsizei n, const GLuint *ids) {}
+static void glBeginQuery(GLenum target, GLuint id) {}
+static void glEndQuery(GLenum target) {}
+static void glGetQueryObjectuiv(GLuint id, GLenum pname, GLuint *params) { if (params) { *params = 0; } }
+
 #endif
 
 #if defined(PLATFORM_ANDROID) || defined(PLATFORM_IOS) || defined(PLATFORM_RPI)
@@ -3,10 +3,13 @@ precision mediump float;
 #endif
 
 attribute vec2 a_position;
+attribute vec4 a_color;
 
 uniform mat4 u_proj;
 
+varying vec4 v_color;
+
 void main() {
+    v_color = a_color;
     gl_Position = u_proj * vec4(a_position, 1.0, 1.0);
 }
-
@@ -12,6 +12,8 @@
 #include "tile/tile.h"
 #include "view/view.h"
 
+#include <algorithm>
+#include <cmath>
 #include <regex>
 
 using namespace mapbox::util;
@@ -22,8 +24,18 @@ const double extent = 4096;
 const uint32_t indexMaxPoints = 100000;
 double tolerance = 1E-8;
 
+// Appends go into a small delta store so a single feature does not
+// re-tile the whole dataset; once this many have accumulated they are
+// folded into the base store in one rebuild.
+const size_t maxDeltaFeatures = 512;
+
+// Generation bumps whose changed bounds are remembered for targeted
+// tile invalidation; tiles older than the history are always rebuilt.
+const size_t maxTrackedChanges = 256;
+
 std::shared_ptr<TileTask> ClientGeoJsonSource::createTask(TileID _tileId, int _subTask) {
-    return std::make_shared<TileTask>(_tileId, shared_from_this(), _subTask);
+    return std::allocate_shared<TileTask>(PoolAllocator<TileTask>(m_taskPool),
+                                          _tileId, shared_from_this(), _subTask);
 }
 
 // Transform a geojsonvt::TilePoint into the corresponding Tangram::Point
@@ -70,8 +82,64 @@ void ClientGeoJsonSource::addData(const std::string& _data) {
 
     std::lock_guard<std::mutex> lock(m_mutexStore);
     m_store = std::make_unique<GeoJSONVT>(m_features, m_maxZoom, m_maxZoom, indexMaxPoints, tolerance);
+    m_deltaStore.reset();
+    m_deltaFeatures.clear();
     m_generation++;
+    recordChange(0.0, 0.0, 1.0, 1.0);
+
+}
+
+void ClientGeoJsonSource::recordChange(double _minX, double _minY, double _maxX, double _maxY) {
+
+    m_changes.push_back({m_generation, _minX, _minY, _maxX, _maxY});
+
+    while (m_changes.size() > maxTrackedChanges) {
+        m_trackedFromGeneration = m_changes.front().generation;
+        m_changes.pop_front();
+    }
+}
 
+void ClientGeoJsonSource::indexFeature(geojsonvt::ProjectedFeature&& _feature) {
+
+    std::lock_guard<std::mutex> lock(m_mutexStore);
+
+    m_generation++;
+    recordChange(_feature.min.x, _feature.min.y, _feature.max.x, _feature.max.y);
+
+    m_features.push_back(_feature);
+    m_deltaFeatures.push_back(std::move(_feature));
+
+    if (m_deltaFeatures.size() >= maxDeltaFeatures) {
+        // Fold the accumulated appends into the base store at once
+        m_store = std::make_unique<GeoJSONVT>(m_features, m_maxZoom, m_maxZoom, indexMaxPoints, tolerance);
+        m_deltaStore.reset();
+        m_deltaFeatures.clear();
+    } else {
+        m_deltaStore = std::make_unique<GeoJSONVT>(m_deltaFeatures, m_maxZoom, m_maxZoom,
+                                                   indexMaxPoints, tolerance);
+    }
+}
+
+bool ClientGeoJsonSource::tileNeedsRebuild(const TileID& _tileId, int64_t _builtGeneration) const {
+
+    std::lock_guard<std::mutex> lock(m_mutexStore);
+
+    if (_builtGeneration < m_trackedFromGeneration) { return true; }
+
+    // Tile extent in the unit square of the projected store; the
+    // projected y axis runs north to south like the tile y axis.
+    double size = 1.0 / (1 << _tileId.z);
+    double minX = _tileId.x * size;
+    double minY = _tileId.y * size;
+
+    for (const auto& change : m_changes) {
+        if (change.generation <= _builtGeneration) { continue; }
+        if (change.maxX >= minX && change.minX <= minX + size &&
+            change.maxY >= minY && change.minY <= minY + size) {
+            return true;
+        }
+    }
+    return false;
 }
 
 bool ClientGeoJsonSource::loadTileData(std::shared_ptr<TileTask>&& _task, TileTaskCb _cb) {
@@ -91,7 +159,10 @@ void ClientGeoJsonSource::clearData() {
 
     std::lock_guard<std::mutex> lock(m_mutexStore);
     m_store.reset();
+    m_deltaStore.reset();
+    m_deltaFeatures.clear();
     m_generation++;
+    recordChange(0.0, 0.0, 1.0, 1.0);
 }
 
 void ClientGeoJsonSource::addPoint(const Properties& _tags, LngLat _point) {
@@ -104,11 +175,77 @@ void ClientGeoJsonSource::addPoint(const Properties& _tags, LngLat _point) {
                                               geojsonvt::ProjectedFeatureType::Point,
                                               container.members);
 
-    m_features.push_back(std::move(feature));
+    indexFeature(std::move(feature));
+}
+
+// Project and index a batch of point features in one pass; _makeTags
+// supplies the properties for the feature at each index.
+template<typename MakeTags>
+static void addPointsImpl(const LngLat* _points, size_t _count, MakeTags&& _makeTags,
+                          std::vector<geojsonvt::ProjectedFeature>& _features) {
+
+    _features.reserve(_features.size() + _count);
+
+    for (size_t i = 0; i < _count; i++) {
+        auto container = geojsonvt::Convert::project(
+            { geojsonvt::LonLat(_points[i].longitude, _points[i].latitude) }, tolerance);
+
+        _features.push_back(geojsonvt::Convert::create(geojsonvt::Tags{_makeTags(i)},
+                                                       geojsonvt::ProjectedFeatureType::Point,
+                                                       container.members));
+    }
+}
+
+void ClientGeoJsonSource::addPoints(const Properties& _tags, const LngLat* _points, size_t _count) {
+
+    if (!_points || _count == 0) { return; }
+
+    // One Properties instance is shared by the whole batch
+    auto tags = std::make_shared<Properties>(_tags);
+
+    std::vector<geojsonvt::ProjectedFeature> features;
+    addPointsImpl(_points, _count, [&](size_t) { return tags; }, features);
+
+    indexFeatures(std::move(features));
+}
+
+void ClientGeoJsonSource::addPoints(std::vector<Properties>&& _tags, const LngLat* _points, size_t _count) {
+
+    if (!_points || _count == 0) { return; }
+
+    std::vector<geojsonvt::ProjectedFeature> features;
+    addPointsImpl(_points, _count,
+                  [&](size_t i) {
+                      return i < _tags.size() ? std::make_shared<Properties>(std::move(_tags[i]))
+                                              : std::make_shared<Properties>();
+                  }, features);
+
+    indexFeatures(std::move(features));
+}
+
+void ClientGeoJsonSource::indexFeatures(std::vector<geojsonvt::ProjectedFeature>&& _features) {
+
+    double minX = 1.0, minY = 1.0, maxX = 0.0, maxY = 0.0;
+    for (const auto& f : _features) {
+        minX = std::min(minX, double(f.min.x));
+        minY = std::min(minY, double(f.min.y));
+        maxX = std::max(maxX, double(f.max.x));
+        maxY = std::max(maxY, double(f.max.y));
+    }
 
     std::lock_guard<std::mutex> lock(m_mutexStore);
+
+    for (auto& f : _features) {
+        m_features.push_back(std::move(f));
+    }
+
+    // A bulk batch is indexed like addData: one full re-tiling, which
+    // also folds any pending delta features back into the base store.
     m_store = std::make_unique<GeoJSONVT>(m_features, m_maxZoom, m_maxZoom, indexMaxPoints, tolerance);
+    m_deltaStore.reset();
+    m_deltaFeatures.clear();
     m_generation++;
+    recordChange(minX, minY, maxX, maxY);
 }
 
 void ClientGeoJsonSource::addLine(const Properties& _tags, const Coordinates& _line) {
@@ -120,11 +257,7 @@ void ClientGeoJsonSource::addLine(const Properties& _tags, const Coordinates& _l
                                               geojsonvt::ProjectedFeatureType::LineString,
                                               geometry);
 
-    m_features.push_back(std::move(feature));
-
-    std::lock_guard<std::mutex> lock(m_mutexStore);
-    m_store = std::make_unique<GeoJSONVT>(m_features, m_maxZoom, m_maxZoom, indexMaxPoints, tolerance);
-    m_generation++;
+    indexFeature(std::move(feature));
 }
 
 void ClientGeoJsonSource::addPoly(const Properties& _tags, const std::vector<Coordinates>& _poly) {
@@ -139,11 +272,7 @@ void ClientGeoJsonSource::addPoly(const Properties& _tags, const std::vector<Coo
                                               geojsonvt::ProjectedFeatureType::Polygon,
                                               geometry);
 
-    m_features.push_back(std::move(feature));
-
-    std::lock_guard<std::mutex> lock(m_mutexStore);
-    m_store = std::make_unique<GeoJSONVT>(m_features, m_maxZoom, m_maxZoom, indexMaxPoints, tolerance);
-    m_generation++;
+    indexFeature(std::move(feature));
 }
 
 std::shared_ptr<TileData> ClientGeoJsonSource::parse(const TileTask& _task,
@@ -152,64 +281,105 @@ std::shared_ptr<TileData> ClientGeoJsonSource::parse(const TileTask& _task,
     auto data = std::make_shared<TileData>();
 
     geojsonvt::Tile tile;
+    geojsonvt::Tile deltaTile;
+    bool hasDelta = false;
     {
         std::lock_guard<std::mutex> lock(m_mutexStore);
-        if (!m_store) { return nullptr; }
-        tile = m_store->getTile(_task.tileId().z, _task.tileId().x, _task.tileId().y);
+        if (!m_store && !m_deltaStore) { return nullptr; }
+        if (m_store) {
+            tile = m_store->getTile(_task.tileId().z, _task.tileId().x, _task.tileId().y);
+        }
+        if (m_deltaStore) {
+            deltaTile = m_deltaStore->getTile(_task.tileId().z, _task.tileId().x, _task.tileId().y);
+            hasDelta = true;
+        }
     }
 
     Layer layer(""); // empty name will skip filtering by 'collection'
 
-    for (auto& it : tile.features) {
-
-        Feature feat(m_id);
-
-        const auto& geom = it.tileGeometry;
-        const auto type = it.type;
+    // Density thinning: below the source max zoom, keep at most one
+    // point per cell of a coarse occupancy grid sized to roughly
+    // m_maxPointsPerTile cells, so a dense layer produces tiles of
+    // bounded feature count instead of stacked overdraw.
+    uint32_t gridDim = 0;
+    std::vector<bool> occupied;
+    if (m_maxPointsPerTile > 0 && _task.tileId().z < m_maxZoom) {
+        gridDim = uint32_t(std::ceil(std::sqrt(double(m_maxPointsPerTile))));
+        occupied.assign(size_t(gridDim) * gridDim, false);
+    }
 
-        switch (type) {
-            case geojsonvt::TileFeatureType::Point: {
-                feat.geometryType = GeometryType::points;
-                for (const auto& pt : geom) {
-                    const auto& point = pt.get<geojsonvt::TilePoint>();
-                    feat.points.push_back(transformPoint(point));
-                }
-                break;
-            }
-            case geojsonvt::TileFeatureType::LineString: {
-                feat.geometryType = GeometryType::lines;
-                for (const auto& r : geom) {
-                    Line line;
-                    for (const auto& pt : r.get<geojsonvt::TileRing>().points) {
-                        line.push_back(transformPoint(pt));
+    // Tiles come from the base store and, while recent appends have not
+    // been folded in yet, from the delta store on top.
+    auto addFeatures = [&](const auto& features) {
+
+        for (auto& it : features) {
+
+            Feature feat(m_id);
+
+            const auto& geom = it.tileGeometry;
+            const auto type = it.type;
+
+            switch (type) {
+                case geojsonvt::TileFeatureType::Point: {
+                    feat.geometryType = GeometryType::points;
+                    for (const auto& pt : geom) {
+                        const auto& point = pt.get<geojsonvt::TilePoint>();
+                        auto p = transformPoint(point);
+                        if (gridDim > 0) {
+                            uint32_t cx = std::min(gridDim - 1, uint32_t(std::max(0.f, p.x) * gridDim));
+                            uint32_t cy = std::min(gridDim - 1, uint32_t(std::max(0.f, p.y) * gridDim));
+                            if (occupied[cy * gridDim + cx]) { continue; }
+                            occupied[cy * gridDim + cx] = true;
+                        }
+                        feat.points.push_back(p);
                     }
-                    feat.lines.emplace_back(std::move(line));
+                    break;
                 }
-                break;
-            }
-            case geojsonvt::TileFeatureType::Polygon: {
-                feat.geometryType = GeometryType::polygons;
-                for (const auto& r : geom) {
-                    Line line;
-                    for (const auto& pt : r.get<geojsonvt::TileRing>().points) {
-                        line.push_back(transformPoint(pt));
+                case geojsonvt::TileFeatureType::LineString: {
+                    feat.geometryType = GeometryType::lines;
+                    for (const auto& r : geom) {
+                        Line line;
+                        for (const auto& pt : r.get<geojsonvt::TileRing>().points) {
+                            line.push_back(transformPoint(pt));
+                        }
+                        feat.lines.emplace_back(std::move(line));
                     }
-                    // Polygons are in a flat list of rings, with ccw rings indicating
-                    // the beginning of a new polygon
-                    if (signedArea(line.begin(), line.end()) >= 0 || feat.polygons.empty()) {
-                        feat.polygons.emplace_back();
+                    break;
+                }
+                case geojsonvt::TileFeatureType::Polygon: {
+                    feat.geometryType = GeometryType::polygons;
+                    for (const auto& r : geom) {
+                        Line line;
+                        for (const auto& pt : r.get<geojsonvt::TileRing>().points) {
+                            line.push_back(transformPoint(pt));
+                        }
+                        // Polygons are in a flat list of rings, with ccw rings indicating
+                        // the beginning of a new polygon
+                        if (signedArea(line.begin(), line.end()) >= 0 || feat.polygons.empty()) {
+                            feat.polygons.emplace_back();
+                        }
+                        feat.polygons.back().push_back(std::move(line));
                     }
-                    feat.polygons.back().push_back(std::move(line));
+                    break;
                 }
-                break;
+                default: break;
+            }
+
+            // Point features fully absorbed by occupied cells are dropped
+            if (gridDim > 0 && feat.geometryType == GeometryType::points && feat.points.empty()) {
+                continue;
             }
-            default: break;
+
+            feat.props = *it.tags.map;
+            layer.features.emplace_back(std::move(feat));
+
         }
+    };
 
-        feat.props = *it.tags.map;
-        layer.features.emplace_back(std::move(feat));
+    addFeatures(tile.features);
+    if (hasDelta) { addFeatures(deltaTile.features); }
 
-    }
+    layer.buildKeyBloom();
 
     data->layers.emplace_back(std::move(layer));
 
@@ -3,6 +3,7 @@
 #include "dataSource.h"
 #include "util/types.h"
 
+#include <deque>
 #include <mutex>
 
 namespace mapbox {
@@ -29,6 +30,16 @@ public:
 
     // Add geometry from a GeoJSON string
     void addData(const std::string& _data);
+
+    // Bulk ingestion from a packed coordinate array, adding one point feature per LngLat without
+    // a GeoJSON serialization and parse roundtrip. All features share _tags; the whole batch is
+    // indexed with a single re-tiling and generation bump.
+    void addPoints(const Properties& _tags, const LngLat* _points, size_t _count);
+
+    // As above with per-feature properties, moved into the features; _tags entries beyond _count
+    // are ignored and missing entries get empty properties.
+    void addPoints(std::vector<Properties>&& _tags, const LngLat* _points, size_t _count);
+
     void addPoint(const Properties& _tags, LngLat _point);
     void addLine(const Properties& _tags, const Coordinates& _line);
     void addPoly(const Properties& _tags, const std::vector<Coordinates>& _poly);
@@ -39,16 +50,56 @@ public:
     virtual void cancelLoadingTile(const TileID& _tile) override {};
     virtual void clearData() override;
 
+    virtual bool isClient() const override { return true; }
+
+    virtual bool tileNeedsRebuild(const TileID& _tileId, int64_t _builtGeneration) const override;
+
+    // Bound the point count of tiles below the source max zoom; 0 keeps every point. Dense
+    // layers are thinned per tile on a coarse occupancy grid, keeping one point per cell, so
+    // low-zoom tiles build and draw in bounded time. Scene file key: 'max_points_per_tile'.
+    void setMaxPointsPerTile(uint32_t _max) { m_maxPointsPerTile = _max; }
+
 protected:
 
     virtual std::shared_ptr<TileData> parse(const TileTask& _task,
                                             const MapProjection& _projection) const override;
 
+    // Index a single appended feature: it goes into the small delta
+    // store, which is cheap to re-tile, instead of rebuilding the base
+    // store over the whole dataset; parse() merges tiles from both.
+    void indexFeature(mapbox::util::geojsonvt::ProjectedFeature&& _feature);
+
+    // Record the projected-space bounds changed by the current
+    // generation bump, for tileNeedsRebuild. Called with m_mutexStore held.
+    void recordChange(double _minX, double _minY, double _maxX, double _maxY);
+
+    // Append a projected feature batch and re-tile the base store once,
+    // recording the combined bounds as the changed extent.
+    void indexFeatures(std::vector<mapbox::util::geojsonvt::ProjectedFeature>&& _features);
+
     std::unique_ptr<GeoJSONVT> m_store;
     mutable std::mutex m_mutexStore;
     std::vector<mapbox::util::geojsonvt::ProjectedFeature> m_features;
     bool m_hasPendingData = false;
 
+    // Features appended since the base store was last built, kept in
+    // their own store until enough accumulate to fold into the base.
+    std::unique_ptr<GeoJSONVT> m_deltaStore;
+    std::vector<mapbox::util::geojsonvt::ProjectedFeature> m_deltaFeatures;
+
+    // Bounds of the data changed by each generation bump, in the unit
+    // square of the projected store; lets tiles untouched by an append
+    // keep their built geometry. Bounded history: tiles older than
+    // m_trackedFromGeneration are always rebuilt.
+    struct ChangedExtent {
+        int64_t generation;
+        double minX, minY, maxX, maxY;
+    };
+    std::deque<ChangedExtent> m_changes;
+    int64_t m_trackedFromGeneration = 0;
+
+    uint32_t m_maxPointsPerTile = 0;
+
 };
 
 }
@@ -1,4 +1,9 @@
 #include "dataSource.h"
+#include "data/diskCache.h"
+#include "data/urlRequestRegistry.h"
+#include "debug/trace.h"
+#include "util/asyncWorker.h"
+#include "util/compression.h"
 #include "util/geoJson.h"
 #include "platform.h"
 #include "tileData.h"
@@ -11,6 +16,7 @@
 #include "log.h"
 
 #include <atomic>
+#include <cstdio>
 #include <mutex>
 #include <list>
 #include <functional>
@@ -23,8 +29,22 @@ struct RawCache {
     // Used to ensure safe access from async loading threads
     std::mutex m_mutex;
 
-    // LRU in-memory cache for raw tile data
-    using CacheEntry = std::pair<TileID, std::shared_ptr<std::vector<char>>>;
+    // LRU in-memory cache for raw tile data. Entries are stored
+    // compressed when that shrinks them - the platform layer hands tile
+    // data over inflated - so the byte budget holds several times as
+    // many tiles. Hits are inflated lazily on a tile worker.
+    //
+    // Entries carry the source generation they were fetched at and the
+    // validators of their response. After a generation bump an entry
+    // turns stale: it no longer counts as a hit, but its validators let
+    // the refetch ask the server whether the tile actually changed.
+    struct CacheEntry {
+        TileID id;
+        std::shared_ptr<std::vector<char>> data;
+        bool compressed;
+        int64_t generation;
+        UrlValidators validators;
+    };
     using CacheList = std::list<CacheEntry>;
     using CacheMap = std::unordered_map<TileID, typename CacheList::iterator>;
 
@@ -33,7 +53,15 @@ struct RawCache {
     int m_usage = 0;
     int m_maxUsage = 0;
 
-    bool get(DownloadTileTask& _task) {
+    // Lifetime counters; kept across clear(), which only bumps the
+    // generation anyway. Stale entries count as misses - they still
+    // cost a (conditional) request.
+    uint64_t m_hits = 0;
+    uint64_t m_misses = 0;
+    uint64_t m_evictions = 0;
+    size_t m_highWater = 0;
+
+    bool get(DownloadTileTask& _task, int64_t _generation) {
 
         if (m_maxUsage <= 0) { return false; }
 
@@ -44,24 +72,78 @@ struct RawCache {
         if (it != m_cacheMap.end()) {
             // Move cached entry to start of list
             m_cacheList.splice(m_cacheList.begin(), m_cacheList, it->second);
-            _task.rawTileData = m_cacheList.front().second;
+            auto& entry = m_cacheList.front();
 
-            return true;
+            if (entry.generation == _generation) {
+                _task.rawTileData = entry.data;
+                _task.rawTileDataCompressed = entry.compressed;
+                m_hits++;
+
+                return true;
+            }
+
+            // From before the last generation bump: hand the copy and
+            // its validators to the task, so the refetch turns into a
+            // conditional request instead of a full download.
+            if (!entry.validators.empty()) {
+                _task.rawTileData = entry.data;
+                _task.rawTileDataCompressed = entry.compressed;
+                _task.rawTileDataStale = true;
+                _task.cachedValidators = entry.validators;
+            }
         }
 
+        m_misses++;
+
         return false;
     }
-    void put(const TileID& tileID, std::shared_ptr<std::vector<char>> rawDataRef) {
 
-        if (m_maxUsage <= 0) { return; }
+    // The server confirmed the stale entry unchanged; stamp it for the
+    // current generation so it counts as a hit again
+    bool revalidate(const TileID& tileID, int64_t _generation) {
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        TileID id(tileID.x, tileID.y, tileID.z);
+
+        auto it = m_cacheMap.find(id);
+        if (it == m_cacheMap.end()) { return false; }
+
+        m_cacheList.splice(m_cacheList.begin(), m_cacheList, it->second);
+        m_cacheList.front().generation = _generation;
+
+        return true;
+    }
+
+    // Inserts the entry uncompressed; compression runs later on the
+    // shared cache worker via compressEntry, so the delivery thread -
+    // the single curl session thread on Linux - never stalls its other
+    // multiplexed transfers behind a tile's compression. Returns false
+    // when the cache is disabled.
+    bool put(const TileID& tileID, std::shared_ptr<std::vector<char>> rawDataRef,
+             int64_t _generation, UrlValidators _validators) {
+
+        if (m_maxUsage <= 0) { return false; }
 
         std::lock_guard<std::mutex> lock(m_mutex);
         TileID id(tileID.x, tileID.y, tileID.z);
 
-        m_cacheList.push_front({id, rawDataRef});
+        // Replace a stale copy of the same tile outright
+        auto prev = m_cacheMap.find(id);
+        if (prev != m_cacheMap.end()) {
+            m_usage -= prev->second->data->size();
+            m_cacheList.erase(prev->second);
+        }
+
+        size_t size = rawDataRef->size();
+        m_cacheList.push_front({id, std::move(rawDataRef), false,
+                                _generation, std::move(_validators)});
         m_cacheMap[id] = m_cacheList.begin();
 
-        m_usage += rawDataRef->size();
+        m_usage += size;
+
+        if (size_t(m_usage) > m_highWater) {
+            m_highWater = m_usage;
+        }
 
         while (m_usage > m_maxUsage) {
             if (m_cacheList.empty()) {
@@ -74,11 +156,52 @@ struct RawCache {
             //        double(m_cacheUsage) / (1024*1024));
 
             auto& entry = m_cacheList.back();
-            m_usage -= entry.second->size();
+            m_usage -= entry.data->size();
 
-            m_cacheMap.erase(entry.first);
+            m_cacheMap.erase(entry.id);
             m_cacheList.pop_back();
+            m_evictions++;
         }
+
+        return true;
+    }
+
+    // Swap the stored copy of a tile for its compressed form; runs on
+    // the shared cache worker. The compression happens outside the
+    // lock, and the swap is skipped when the entry was evicted or
+    // replaced by a newer fetch in the meantime. Readers that took the
+    // uncompressed reference before the swap hold their own flag and
+    // stay consistent.
+    void compressEntry(const TileID& tileID, const std::shared_ptr<std::vector<char>>& rawDataRef,
+                       int64_t _generation) {
+
+        auto compressed = std::make_shared<std::vector<char>>();
+        if (!lzCompress(*rawDataRef, *compressed)) { return; }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        TileID id(tileID.x, tileID.y, tileID.z);
+
+        auto it = m_cacheMap.find(id);
+        if (it == m_cacheMap.end()) { return; }
+
+        auto& entry = *it->second;
+        if (entry.data != rawDataRef || entry.generation != _generation) { return; }
+
+        m_usage -= entry.data->size();
+        m_usage += compressed->size();
+        entry.data = std::move(compressed);
+        entry.compressed = true;
+    }
+
+    CacheStats stats() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        CacheStats stats;
+        stats.hits = m_hits;
+        stats.misses = m_misses;
+        stats.evictions = m_evictions;
+        stats.bytes = m_usage;
+        stats.highWaterBytes = m_highWater;
+        return stats;
     }
 
     void clear() {
@@ -89,16 +212,135 @@ struct RawCache {
     }
 };
 
+struct ParsedDataCache {
+
+    // Used to ensure safe access from worker threads
+    std::mutex m_mutex;
+
+    // MRU list of recently parsed tile data, keyed by data-tile
+    // coordinates and source generation. TileData is only read during
+    // builds, so entries can be shared across concurrent tile builds.
+    // The list is bounded by the bytes held in the entries' geometry
+    // arenas, so re-entering a recently visited area only rebuilds
+    // meshes and skips the parse stage.
+    struct Entry {
+        TileID id;
+        int64_t generation;
+        std::shared_ptr<TileData> data;
+        size_t size;
+    };
+
+    std::list<Entry> m_entries;
+    size_t m_usage = 0;
+
+    static constexpr size_t MAX_USAGE = 16 * 1024 * 1024;
+
+    // For parsed data not backed by an arena only the entry count is
+    // meaningfully bounded; charge a nominal size per entry.
+    static size_t entrySize(const TileData& _data) {
+        return _data.arena ? _data.arena->totalBytes() : MAX_USAGE / 16;
+    }
+
+    std::shared_ptr<TileData> get(const TileID& _tileId, int64_t _generation) {
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        TileID id(_tileId.x, _tileId.y, _tileId.z);
+
+        for (auto it = m_entries.begin(); it != m_entries.end(); ++it) {
+            if (it->id == id && it->generation == _generation) {
+                m_entries.splice(m_entries.begin(), m_entries, it);
+                return m_entries.front().data;
+            }
+        }
+        return nullptr;
+    }
+
+    // Re-key the most recent entry for this tile to _generation, when a
+    // conditional refetch confirmed its data unchanged. The parse that
+    // produced it then serves the new generation as well.
+    void revalidate(const TileID& _tileId, int64_t _generation) {
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        TileID id(_tileId.x, _tileId.y, _tileId.z);
+
+        for (auto it = m_entries.begin(); it != m_entries.end(); ++it) {
+            if (it->id == id) {
+                it->generation = _generation;
+                m_entries.splice(m_entries.begin(), m_entries, it);
+                return;
+            }
+        }
+    }
+
+    void put(const TileID& _tileId, int64_t _generation, std::shared_ptr<TileData> _data) {
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        TileID id(_tileId.x, _tileId.y, _tileId.z);
+
+        size_t size = entrySize(*_data);
+
+        m_entries.push_front({ id, _generation, std::move(_data), size });
+        m_usage += size;
+
+        while (m_usage > MAX_USAGE && m_entries.size() > 1) {
+            m_usage -= m_entries.back().size;
+            m_entries.pop_back();
+        }
+    }
+
+    void clear() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_entries.clear();
+        m_usage = 0;
+    }
+};
+
 DataSource::DataSource(const std::string& _name, const std::string& _urlTemplate,
                        int32_t _minDisplayZoom, int32_t _maxDisplayZoom, int32_t _maxZoom) :
     m_name(_name),
     m_minDisplayZoom(_minDisplayZoom), m_maxDisplayZoom(_maxDisplayZoom), m_maxZoom(_maxZoom),
     m_urlTemplate(_urlTemplate),
-    m_cache(std::make_unique<RawCache>()){
+    m_cache(std::make_shared<RawCache>()),
+    m_parsedCache(std::make_unique<ParsedDataCache>()){
 
     static std::atomic<int32_t> s_serial;
 
     m_id = s_serial++;
+
+    parseUrlTemplate();
+}
+
+void DataSource::parseUrlTemplate() {
+
+    size_t pos = 0;
+    while (pos < m_urlTemplate.size()) {
+        size_t slot = m_urlTemplate.find('{', pos);
+
+        UrlSlot type = UrlSlot::none;
+        if (slot != std::string::npos && slot + 2 < m_urlTemplate.size() &&
+            m_urlTemplate[slot + 2] == '}') {
+            switch (m_urlTemplate[slot + 1]) {
+                case 'x': type = UrlSlot::x; break;
+                case 'y': type = UrlSlot::y; break;
+                case 'z': type = UrlSlot::z; break;
+            }
+        }
+
+        if (type == UrlSlot::none) {
+            if (slot == std::string::npos) {
+                // Trailing literal after the last slot
+                m_urlPieces.push_back({m_urlTemplate.substr(pos), UrlSlot::none});
+                return;
+            }
+            // A '{' that opens no known slot stays literal text
+            m_urlPieces.push_back({m_urlTemplate.substr(pos, slot + 1 - pos), UrlSlot::none});
+            pos = slot + 1;
+            continue;
+        }
+
+        m_urlPieces.push_back({m_urlTemplate.substr(pos, slot - pos), type});
+        pos = slot + 3;
+    }
 }
 
 DataSource::~DataSource() {
@@ -106,7 +348,8 @@ DataSource::~DataSource() {
 }
 
 std::shared_ptr<TileTask> DataSource::createTask(TileID _tileId, int _subTask) {
-    auto task = std::make_shared<DownloadTileTask>(_tileId, shared_from_this(), _subTask);
+    auto task = std::allocate_shared<DownloadTileTask>(PoolAllocator<DownloadTileTask>(m_taskPool),
+                                                       _tileId, shared_from_this(), _subTask);
 
     cacheGet(*task);
 
@@ -117,30 +360,111 @@ void DataSource::setCacheSize(size_t _cacheSize) {
     m_cache->m_maxUsage = _cacheSize;
 }
 
+size_t DataSource::cacheMemoryUsage() {
+    size_t bytes = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_cache->m_mutex);
+        bytes += size_t(m_cache->m_usage);
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_parsedCache->m_mutex);
+        bytes += m_parsedCache->m_usage;
+    }
+    return bytes;
+}
+
+CacheStats DataSource::rawCacheStats() {
+    return m_cache->stats();
+}
+
+void DataSource::setDiskCachePath(const std::string& _path) {
+    m_diskCache = std::make_unique<DiskCache>(_path);
+}
+
 bool DataSource::cacheGet(DownloadTileTask& _task) {
-    return m_cache->get(_task);
+
+    if (m_cache->get(_task, m_generation)) { return true; }
+
+    // Fall through to the persistent tier; promote hits into the
+    // in-memory cache so repeated lookups stay off the disk index.
+    if (m_diskCache) {
+        auto rawDataRef = std::make_shared<std::vector<char>>();
+        if (m_diskCache->get(_task.tileId(), m_generation, *rawDataRef)) {
+            _task.rawTileData = rawDataRef;
+            m_cache->put(_task.tileId(), std::move(rawDataRef), m_generation, {});
+            return true;
+        }
+    }
+
+    return false;
 }
 
-void DataSource::cachePut(const TileID& _tileID, std::shared_ptr<std::vector<char>> _rawDataRef) {
-    m_cache->put(_tileID, _rawDataRef);
+namespace {
+
+// One worker for all sources compresses raw cache entries off the
+// network delivery threads; on Linux those collapse into the single
+// curl session thread, which must stay I/O-only or every multiplexed
+// transfer stalls behind a tile's compression.
+AsyncWorker& cacheCompressionWorker() {
+    static AsyncWorker worker;
+    return worker;
+}
+
+}
+
+void DataSource::cachePut(const TileID& _tileID, std::shared_ptr<std::vector<char>> _rawDataRef,
+                          UrlValidators _validators) {
+
+    if (!m_cache->put(_tileID, _rawDataRef, m_generation, std::move(_validators))) {
+        return;
+    }
+
+    // The job holds its own reference to the cache, so it stays valid
+    // even when this source is destroyed before the queue drains.
+    auto cache = m_cache;
+    auto generation = m_generation;
+    cacheCompressionWorker().enqueue(
+        [cache, _tileID, _rawDataRef, generation]() {
+            cache->compressEntry(_tileID, _rawDataRef, generation);
+        });
+}
+
+std::shared_ptr<TileData> DataSource::parsedDataGet(const TileID& _tileId, int64_t _generation) {
+    return m_parsedCache->get(_tileId, _generation);
+}
+
+void DataSource::parsedDataPut(const TileID& _tileId, int64_t _generation, std::shared_ptr<TileData> _data) {
+    m_parsedCache->put(_tileId, _generation, std::move(_data));
 }
 
 void DataSource::clearData() {
-    m_cache->clear();
+    // The cached raw and parsed entries are kept across the bump: they
+    // no longer count as hits, but entries fetched with validators turn
+    // their refetch into a conditional request, and a 304 re-stamps them
+    // for the new generation. Both tiers stay within their byte budgets.
     m_generation++;
 }
 
+namespace {
+
+void appendInt(std::string& _out, int _value) {
+    char buf[16];
+    int length = snprintf(buf, sizeof(buf), "%d", _value);
+    _out.append(buf, length);
+}
+
+}
+
 void DataSource::constructURL(const TileID& _tileCoord, std::string& _url) const {
-    _url.assign(m_urlTemplate);
-    try {
-        size_t xpos = _url.find("{x}");
-        _url.replace(xpos, 3, std::to_string(_tileCoord.x));
-        size_t ypos = _url.find("{y}");
-        _url.replace(ypos, 3, std::to_string(_tileCoord.y));
-        size_t zpos = _url.find("{z}");
-        _url.replace(zpos, 3, std::to_string(_tileCoord.z));
-    } catch(...) {
-        LOGE("Bad URL template!");
+    _url.clear();
+    for (auto& piece : m_urlPieces) {
+        _url.append(piece.literal);
+        switch (piece.slot) {
+            case UrlSlot::x: appendInt(_url, _tileCoord.x); break;
+            case UrlSlot::y: appendInt(_url, _tileCoord.y); break;
+            case UrlSlot::z: appendInt(_url, _tileCoord.z); break;
+            case UrlSlot::none: break;
+        }
     }
 }
 
@@ -158,24 +482,47 @@ bool DataSource::equals(const DataSource& other) const {
     return true;
 }
 
-void DataSource::onTileLoaded(std::vector<char>&& _rawData, std::shared_ptr<TileTask>&& _task,
+void DataSource::onTileLoaded(std::vector<char>&& _rawData, UrlValidators&& _validators,
+                              bool _notModified, std::shared_ptr<TileTask>&& _task,
                               TileTaskCb _cb) {
 
     if (_task->isCanceled()) { return; }
 
+    // Network delivery: hand-over to the worker queue plus cache writes
+    TRACE_SCOPE("tile:data");
+
     TileID tileID = _task->tileId();
+    auto& task = static_cast<DownloadTileTask&>(*_task);
+
+    if (_notModified && task.rawTileDataStale) {
+        // 304: the copy kept across the generation bump is current
+        // again. Re-stamp the cached bytes and the parsed data for this
+        // generation; the task then skips straight to the build stage.
+        task.rawTileDataStale = false;
+        m_cache->revalidate(tileID, task.sourceGeneration());
+        m_parsedCache->revalidate(tileID, task.sourceGeneration());
+
+        _cb.func(std::move(_task));
+        return;
+    }
 
     if (!_rawData.empty()) {
 
-        auto rawDataRef = std::make_shared<std::vector<char>>();
-        std::swap(*rawDataRef, _rawData);
+        // The buffer is adopted from the network callback and shared from
+        // here on; the only copy left on this path is the disk write.
+        auto rawDataRef = std::make_shared<std::vector<char>>(std::move(_rawData));
 
-        auto& task = static_cast<DownloadTileTask&>(*_task);
         task.rawTileData = rawDataRef;
+        task.rawTileDataCompressed = false;
+        task.rawTileDataStale = false;
 
         _cb.func(std::move(_task));
 
-        cachePut(tileID, rawDataRef);
+        if (m_diskCache) {
+            m_diskCache->put(tileID, m_generation, *rawDataRef);
+        }
+
+        cachePut(tileID, std::move(rawDataRef), std::move(_validators));
     }
 }
 
@@ -183,18 +530,32 @@ bool DataSource::loadTileData(std::shared_ptr<TileTask>&& _task, TileTaskCb _cb)
 
     std::string url(constructURL(_task->tileId()));
 
+    auto priority = _task->isPrefetch() ? UrlRequestRegistry::Priority::prefetch
+                  : _task->isProxy() ? UrlRequestRegistry::Priority::proxy
+                  : UrlRequestRegistry::Priority::visible;
+
+    // A stale cached copy turns this fetch into a conditional request
+    UrlValidators validators;
+    {
+        auto& task = static_cast<DownloadTileTask&>(*_task);
+        if (task.rawTileDataStale) { validators = task.cachedValidators; }
+    }
+
     // lambda captured parameters are const by default, we want "task" (moved) to be non-const,
     // hence "mutable"
     // Refer: http://en.cppreference.com/w/cpp/language/lambda
-    return startUrlRequest(url,
-            [this, _cb, task = std::move(_task)](std::vector<char>&& rawData) mutable {
-                this->onTileLoaded(std::move(rawData), std::move(task), _cb);
-            });
+    return UrlRequestRegistry::instance().start(url,
+            [this, _cb, task = std::move(_task)](std::vector<char>&& rawData,
+                                                 UrlValidators&& respValidators,
+                                                 bool notModified) mutable {
+                this->onTileLoaded(std::move(rawData), std::move(respValidators),
+                                   notModified, std::move(task), _cb);
+            }, priority, std::move(validators));
 
 }
 
 void DataSource::cancelLoadingTile(const TileID& _tileID) {
-    cancelUrlRequest(constructURL(_tileID));
+    UrlRequestRegistry::instance().cancel(constructURL(_tileID));
     for (auto& raster : m_rasterSources) {
         TileID rasterID = _tileID.withMaxSourceZoom(raster->maxZoom());
         raster->cancelLoadingTile(rasterID);
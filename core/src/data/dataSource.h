@@ -1,11 +1,14 @@
 #pragma once
 
 
+#include <cstdint>
 #include <string>
 #include <memory>
 #include <vector>
 
 #include "tile/tileTask.h"
+#include "util/blockPool.h"
+#include "util/types.h"
 
 namespace Tangram {
 
@@ -16,6 +19,8 @@ struct Raster;
 class Tile;
 class TileManager;
 struct RawCache;
+struct ParsedDataCache;
+class DiskCache;
 class Texture;
 
 class DataSource : public std::enable_shared_from_this<DataSource> {
@@ -47,6 +52,15 @@ public:
     /* Parse a <TileTask> with data into a <TileData>, returning an empty TileData on failure */
     virtual std::shared_ptr<TileData> parse(const TileTask& _task, const MapProjection& _projection) const = 0;
 
+    /* Fetch recently parsed data for the given data-tile coordinates; returns
+     * null on a miss or when the entry stems from an older generation. Parsed
+     * data only depends on the data-tile coordinates, so rebuilding a tile at
+     * another styling zoom (proxy transitions, overzoom siblings) can reuse
+     * the decode done for its proxy instead of parsing again. */
+    std::shared_ptr<TileData> parsedDataGet(const TileID& _tileId, int64_t _generation);
+
+    void parsedDataPut(const TileID& _tileId, int64_t _generation, std::shared_ptr<TileData> _data);
+
     /* Clears all data associated with this DataSource */
     virtual void clearData();
 
@@ -64,12 +78,34 @@ public:
      */
     void setCacheSize(size_t _cacheSize);
 
+    /* Bytes currently held by the in-memory tile data caches, i.e. the
+     * raw and the parsed tier together */
+    size_t cacheMemoryUsage();
+
+    /* Lookup, eviction and high-water counters of the raw tile data
+     * cache, for tuning the cache size from telemetry */
+    CacheStats rawCacheStats();
+
+    /* @_path: File backing a persistent tier behind the in-memory cache.
+     * Raw tile data is appended to the file as it is downloaded and served
+     * from a memory-mapped read on later runs, so restarts do not refetch
+     * tiles over the network.
+     */
+    void setDiskCachePath(const std::string& _path);
+
     /* ID of this DataSource instance */
     int32_t id() const { return m_id; }
 
     /* Generation ID of DataSource state (incremented for each update, e.g. on clearData()) */
     int64_t generation() const { return m_generation; }
 
+    /* Whether a tile built at _builtGeneration must be rebuilt to reflect the current data.
+     * Sources that track where their data changed override this to exempt tiles the changes
+     * cannot have touched; the default rebuilds on any generation mismatch. */
+    virtual bool tileNeedsRebuild(const TileID& _tileId, int64_t _builtGeneration) const {
+        return true;
+    }
+
     int32_t minDisplayZoom() const { return m_minDisplayZoom; }
     int32_t maxDisplayZoom() const { return m_maxDisplayZoom; }
     int32_t maxZoom() const { return m_maxZoom; }
@@ -89,9 +125,14 @@ public:
     /* Avoid RTTI by adding a boolean check on the data source object */
     virtual bool isRaster() const { return false; }
 
+    /* As above, for client data sources whose content only exists in the
+     * running application */
+    virtual bool isClient() const { return false; }
+
 protected:
 
-    virtual void onTileLoaded(std::vector<char>&& _rawData, std::shared_ptr<TileTask>&& _task,
+    virtual void onTileLoaded(std::vector<char>&& _rawData, UrlValidators&& _validators,
+                              bool _notModified, std::shared_ptr<TileTask>&& _task,
                               TileTaskCb _cb);
 
     /* Constructs the URL of a tile using <m_urlTemplate> */
@@ -103,9 +144,31 @@ protected:
         return url;
     }
 
+    // The URL template split once at construction into the literal spans
+    // between the '{x}', '{y}' and '{z}' slots, so constructURL appends
+    // straight into the caller's buffer instead of doing find/replace on
+    // a fresh copy of the template per tile request.
+    enum class UrlSlot : uint8_t { none, x, y, z };
+
+    struct UrlTemplatePiece {
+        std::string literal; // Literal text preceding the slot
+        UrlSlot slot;
+    };
+
+    void parseUrlTemplate();
+
+    std::vector<UrlTemplatePiece> m_urlPieces;
+
     bool cacheGet(DownloadTileTask& _task);
 
-    void cachePut(const TileID& _tileID, std::shared_ptr<std::vector<char>> _rawDataRef);
+    void cachePut(const TileID& _tileID, std::shared_ptr<std::vector<char>> _rawDataRef,
+                  UrlValidators _validators = {});
+
+    // Freelist backing task allocations for this source; createTask
+    // implementations allocate_shared from it so the task and its
+    // control block recycle through one block during tile churn. The
+    // allocators co-own the pool, so tasks may outlive the source.
+    std::shared_ptr<BlockPool> m_taskPool = std::make_shared<BlockPool>();
 
     // This datasource is used to generate actual tile geometry
     bool m_generateGeometry = false;
@@ -131,7 +194,12 @@ protected:
     // URL template for requesting tiles from a network or filesystem
     std::string m_urlTemplate;
 
-    std::unique_ptr<RawCache> m_cache;
+    // Shared so queued compression jobs can outlive the source
+    std::shared_ptr<RawCache> m_cache;
+
+    std::unique_ptr<ParsedDataCache> m_parsedCache;
+
+    std::unique_ptr<DiskCache> m_diskCache;
 
     /* vector of raster sources (as raster samplers) referenced by this datasource */
     std::vector<std::shared_ptr<DataSource>> m_rasterSources;
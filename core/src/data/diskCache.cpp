@@ -0,0 +1,201 @@
+#include "diskCache.h"
+
+#include "log.h"
+
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace Tangram {
+
+namespace {
+
+constexpr uint32_t RECORD_MAGIC = 0x54475243; // 'TGRC'
+
+struct RecordHeader {
+    uint32_t magic;
+    int32_t x;
+    int32_t y;
+    int32_t z;
+    int64_t generation;
+    uint32_t length;
+};
+
+}
+
+DiskCache::DiskCache(const std::string& _path, size_t _maxSize) :
+    m_path(_path),
+    m_maxSize(_maxSize) {
+
+    if (open()) {
+        scan();
+    }
+}
+
+DiskCache::~DiskCache() {
+    close();
+}
+
+bool DiskCache::open() {
+
+    m_fd = ::open(m_path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (m_fd < 0) {
+        LOGW("Could not open tile cache file '%s'", m_path.c_str());
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(m_fd, &st) != 0) {
+        close();
+        return false;
+    }
+    m_fileSize = st.st_size;
+
+    if (m_fileSize > m_maxSize) {
+        // The log outgrew its budget in an earlier run - start over.
+        reset();
+    }
+
+    return true;
+}
+
+void DiskCache::close() {
+
+    if (m_mapped) {
+        munmap(m_mapped, m_mappedSize);
+        m_mapped = nullptr;
+        m_mappedSize = 0;
+    }
+    if (m_fd >= 0) {
+        ::close(m_fd);
+        m_fd = -1;
+    }
+}
+
+void DiskCache::scan() {
+
+    RecordHeader header;
+    uint64_t offset = 0;
+
+    while (offset + sizeof(header) <= m_fileSize) {
+
+        if (pread(m_fd, &header, sizeof(header), offset) != sizeof(header) ||
+            header.magic != RECORD_MAGIC ||
+            offset + sizeof(header) + header.length > m_fileSize) {
+            // Truncated or torn write from an interrupted run - drop the
+            // tail of the log; everything before it stays usable.
+            if (ftruncate(m_fd, offset) == 0) {
+                m_fileSize = offset;
+            }
+            break;
+        }
+
+        TileID id(header.x, header.y, header.z);
+        auto it = m_index.find(id);
+        if (it == m_index.end() || it->second.generation <= header.generation) {
+            m_index[id] = { offset, header.length, header.generation };
+        }
+
+        offset += sizeof(header) + header.length;
+    }
+}
+
+bool DiskCache::remap(size_t _size) {
+
+    if (m_mapped) {
+        munmap(m_mapped, m_mappedSize);
+        m_mapped = nullptr;
+        m_mappedSize = 0;
+    }
+
+    void* mapped = mmap(nullptr, _size, PROT_READ, MAP_SHARED, m_fd, 0);
+    if (mapped == MAP_FAILED) {
+        return false;
+    }
+
+    m_mapped = static_cast<char*>(mapped);
+    m_mappedSize = _size;
+    return true;
+}
+
+void DiskCache::reset() {
+
+    if (m_mapped) {
+        munmap(m_mapped, m_mappedSize);
+        m_mapped = nullptr;
+        m_mappedSize = 0;
+    }
+    if (ftruncate(m_fd, 0) == 0) {
+        m_fileSize = 0;
+    }
+    m_index.clear();
+}
+
+bool DiskCache::get(const TileID& _tileId, int64_t _generation, std::vector<char>& _data) {
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (m_fd < 0) { return false; }
+
+    TileID id(_tileId.x, _tileId.y, _tileId.z);
+
+    auto it = m_index.find(id);
+    if (it == m_index.end() || it->second.generation != _generation) {
+        return false;
+    }
+
+    const Slot& slot = it->second;
+
+    if (slot.offset + sizeof(RecordHeader) + slot.length > m_mappedSize) {
+        if (!remap(m_fileSize)) { return false; }
+    }
+
+    const char* blob = m_mapped + slot.offset + sizeof(RecordHeader);
+    _data.assign(blob, blob + slot.length);
+
+    return true;
+}
+
+void DiskCache::put(const TileID& _tileId, int64_t _generation, const std::vector<char>& _data) {
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (m_fd < 0) { return; }
+
+    TileID id(_tileId.x, _tileId.y, _tileId.z);
+
+    auto it = m_index.find(id);
+    if (it != m_index.end() && it->second.generation >= _generation) {
+        return;
+    }
+
+    if (m_fileSize + sizeof(RecordHeader) + _data.size() > m_maxSize) {
+        reset();
+    }
+
+    RecordHeader header;
+    header.magic = RECORD_MAGIC;
+    header.x = id.x;
+    header.y = id.y;
+    header.z = id.z;
+    header.generation = _generation;
+    header.length = _data.size();
+
+    uint64_t offset = m_fileSize;
+
+    if (pwrite(m_fd, &header, sizeof(header), offset) != ssize_t(sizeof(header)) ||
+        pwrite(m_fd, _data.data(), _data.size(), offset + sizeof(header)) != ssize_t(_data.size())) {
+        // A partial record would be dropped by the next scan; forget it now.
+        if (ftruncate(m_fd, offset) != 0) {
+            LOGW("Could not truncate tile cache file '%s'", m_path.c_str());
+        }
+        return;
+    }
+
+    m_fileSize = offset + sizeof(header) + _data.size();
+    m_index[id] = { offset, header.length, _generation };
+}
+
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "tile/tileID.h"
+#include "tile/tileHash.h"
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Tangram {
+
+/* Persistent tier behind the in-memory RawCache: an append-only log of
+ * raw tile blobs in a single file, keyed by data-tile coordinates and
+ * source generation. The log is memory-mapped for reads, so a warm
+ * restart serves tiles from the page cache instead of the network.
+ *
+ * Records from older generations stay in the log but are shadowed in
+ * the index; the log is wiped when it outgrows its size budget.
+ */
+class DiskCache {
+
+public:
+
+    explicit DiskCache(const std::string& _path, size_t _maxSize = DEFAULT_MAX_SIZE);
+    ~DiskCache();
+
+    DiskCache(const DiskCache&) = delete;
+    DiskCache& operator=(const DiskCache&) = delete;
+
+    /* Copies the blob stored for the tile into _data; returns false on a
+     * miss or when the stored record is from another generation. */
+    bool get(const TileID& _tileId, int64_t _generation, std::vector<char>& _data);
+
+    /* Appends a blob for the tile, replacing any indexed older record. */
+    void put(const TileID& _tileId, int64_t _generation, const std::vector<char>& _data);
+
+    static constexpr size_t DEFAULT_MAX_SIZE = 64 * 1024 * 1024;
+
+private:
+
+    struct Slot {
+        uint64_t offset;
+        uint32_t length;
+        int64_t generation;
+    };
+
+    bool open();
+    void close();
+    void scan();
+    bool remap(size_t _size);
+    void reset();
+
+    // Guards the index, the mapping and the file offset
+    std::mutex m_mutex;
+
+    std::string m_path;
+    size_t m_maxSize;
+
+    int m_fd = -1;
+    char* m_mapped = nullptr;
+    size_t m_mappedSize = 0;
+    uint64_t m_fileSize = 0;
+
+    std::unordered_map<TileID, Slot> m_index;
+};
+
+}
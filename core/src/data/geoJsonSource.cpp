@@ -1,56 +1,201 @@
 #include "geoJsonSource.h"
 #include "util/mapProjection.h"
 
+#include "data/diskCache.h"
 #include "tileData.h"
 #include "tile/tile.h"
 #include "tile/tileID.h"
 #include "tile/tileTask.h"
 #include "util/geoJson.h"
+#include "util/json.h"
 #include "platform.h"
 #include "log.h"
 
+#include <cstring>
+
 namespace Tangram {
 
+class GeoJsonTileTask : public DownloadTileTask {
+public:
+    GeoJsonTileTask(TileID& _tileId, std::shared_ptr<DataSource> _source, int _subTask)
+        : DownloadTileTask(_tileId, _source, _subTask) {}
+
+    // Document parsed on the worker while the fetch streamed in; when
+    // set, parse() uses it instead of parsing rawTileData again.
+    std::shared_ptr<JsonDocument> document;
+};
+
 GeoJsonSource::GeoJsonSource(const std::string& _name, const std::string& _urlTemplate,
                              int32_t _minDisplayZoom, int32_t _maxDisplayZoom, int32_t _maxZoom) :
     DataSource(_name, _urlTemplate, _minDisplayZoom, _maxDisplayZoom, _maxZoom) {
 }
 
+std::shared_ptr<TileTask> GeoJsonSource::createTask(TileID _tileId, int _subTask) {
+    auto task = std::allocate_shared<GeoJsonTileTask>(PoolAllocator<GeoJsonTileTask>(m_taskPool),
+                                                      _tileId, shared_from_this(), _subTask);
+
+    cacheGet(*task);
+
+    return task;
+}
+
+bool GeoJsonSource::loadTileData(std::shared_ptr<TileTask>&& _task, TileTaskCb _cb) {
+
+    {
+        auto& task = static_cast<DownloadTileTask&>(*_task);
+        if (task.rawTileDataStale) {
+            // A conditional revalidation hopes for a 304, which has no
+            // body to stream; it takes the buffered path instead.
+            return DataSource::loadTileData(std::move(_task), _cb);
+        }
+    }
+
+    TileID tileID = _task->tileId();
+    std::string url(constructURL(tileID));
+
+    // GeoJson tiles run to megabytes of text whose parse takes about as
+    // long as the transfer. Stream the response into an incremental
+    // parse on the worker instead of buffering it first, so the tile is
+    // ready roughly when the slower of the two finishes, not their sum.
+    // The streamed fetch goes straight to the platform, bypassing the
+    // registry lanes; cancelLoadingTile still forwards the abort.
+    auto stream = std::make_shared<StreamedBuffer>();
+    auto validators = std::make_shared<UrlValidators>();
+    {
+        std::lock_guard<std::mutex> lock(m_streamsMutex);
+        m_streams[tileID] = stream;
+    }
+
+    bool started = startUrlRequestStream(url,
+            [stream](const char* _data, size_t _size) {
+                stream->append(_data, _size);
+            },
+            [stream, validators](bool _ok, UrlValidators&& _validators) {
+                *validators = std::move(_validators);
+                stream->finish(_ok);
+            });
+
+    if (!started) {
+        stream->finish(false);
+        std::lock_guard<std::mutex> lock(m_streamsMutex);
+        m_streams.erase(tileID);
+        return false;
+    }
+
+    m_parseWorker.enqueue([this, stream, validators, _cb, task = std::move(_task)]() mutable {
+            parseStreamed(std::move(stream), std::move(validators), std::move(task), _cb);
+        });
+
+    return true;
+}
+
+void GeoJsonSource::parseStreamed(std::shared_ptr<StreamedBuffer> _stream,
+                                  std::shared_ptr<UrlValidators> _validators,
+                                  std::shared_ptr<TileTask> _task, TileTaskCb _cb) {
+
+    const char* error;
+    size_t offset;
+    auto document = std::make_shared<JsonDocument>(JsonParseStream(*_stream, &error, &offset));
+
+    // The parse ran off the end of the stream, so the transfer is over
+    // and the chunks can be folded into the buffer the caches keep
+    std::vector<char> data = _stream->take();
+
+    TileID tileID = _task->tileId();
+    {
+        std::lock_guard<std::mutex> lock(m_streamsMutex);
+        auto it = m_streams.find(tileID);
+        if (it != m_streams.end() && it->second == _stream) {
+            m_streams.erase(it);
+        }
+    }
+
+    // A failed or aborted transfer ends like a failed buffered fetch:
+    // the task is dropped without a callback
+    if (!_stream->success() || data.empty() || _task->isCanceled()) { return; }
+
+    auto rawDataRef = std::make_shared<std::vector<char>>(std::move(data));
+
+    auto& task = static_cast<GeoJsonTileTask&>(*_task);
+    task.rawTileData = rawDataRef;
+    task.rawTileDataCompressed = false;
+    task.rawTileDataStale = false;
+    if (!error) {
+        task.document = std::move(document);
+    }
+    // On a parse error the raw bytes are handed over anyway; parse()
+    // fails on them again and logs, as on the buffered path
+
+    _cb.func(std::move(_task));
+
+    if (m_diskCache) {
+        m_diskCache->put(tileID, m_generation, *rawDataRef);
+    }
+
+    cachePut(tileID, std::move(rawDataRef), std::move(*_validators));
+}
+
+void GeoJsonSource::cancelLoadingTile(const TileID& _tileID) {
+
+    {
+        std::lock_guard<std::mutex> lock(m_streamsMutex);
+        auto it = m_streams.find(_tileID);
+        if (it != m_streams.end()) {
+            // Unblock the parse job waiting on this stream; the platform
+            // abort below may end the transfer without a finish
+            it->second->finish(false);
+            m_streams.erase(it);
+        }
+    }
+
+    DataSource::cancelLoadingTile(_tileID);
+}
+
 std::shared_ptr<TileData> GeoJsonSource::parse(const TileTask& _task,
                                                const MapProjection& _projection) const {
 
-    auto& task = static_cast<const DownloadTileTask&>(_task);
+    auto& task = static_cast<const GeoJsonTileTask&>(_task);
 
     std::shared_ptr<TileData> tileData = std::make_shared<TileData>();
 
-    // Parse data into a JSON document
-    const char* error;
-    size_t offset;
-    auto document = JsonParseBytes(task.rawTileData->data(), task.rawTileData->size(), &error, &offset);
+    std::vector<char> buffer;
+    JsonDocument localDocument;
+    JsonDocument* document = &localDocument;
 
-    if (error) {
-        LOGE("Json parsing failed on tile [%s]: %s (%u)", task.tileId().toString().c_str(), error, offset);
-        return tileData;
+    if (task.document) {
+        // A streamed fetch already parsed the document as it arrived
+        document = task.document.get();
+    } else {
+        // Parse data into a JSON document. The raw buffer is shared with the
+        // DataSource cache, so copy it once into a scratch buffer and parse
+        // that in place; the single memcpy is much cheaper than the per-string
+        // allocations of a DOM parse, and strings in the document then point
+        // straight into the buffer.
+        const char* error;
+        size_t offset;
+        buffer.resize(task.rawTileData->size() + 1);
+        std::memcpy(buffer.data(), task.rawTileData->data(), task.rawTileData->size());
+        localDocument = JsonParseInsitu(buffer.data(), task.rawTileData->size(), &error, &offset);
+
+        if (error) {
+            LOGE("Json parsing failed on tile [%s]: %s (%u)", task.tileId().toString().c_str(), error, offset);
+            return tileData;
+        }
     }
 
     BoundingBox tileBounds(_projection.TileBounds(task.tileId()));
     glm::dvec2 tileOrigin = {tileBounds.min.x, tileBounds.max.y*-1.0};
     double tileInverseScale = 1.0 / tileBounds.width();
 
-    const auto projFn = [&](glm::dvec2 _lonLat){
-        glm::dvec2 tmp = _projection.LonLatToMeters(_lonLat);
-        return Point {
-            (tmp.x - tileOrigin.x) * tileInverseScale,
-            (tmp.y - tileOrigin.y) * tileInverseScale,
-             0
-        };
+    const auto projFn = [&](glm::dvec2* _lonLats, size_t _count){
+        _projection.LonLatToTileUnits(_lonLats, _count, tileOrigin, tileInverseScale);
     };
 
     // Transform JSON data into TileData using GeoJson functions
-    if (GeoJson::isFeatureCollection(document)) {
-        tileData->layers.push_back(GeoJson::getLayer(document, projFn, m_id));
+    if (GeoJson::isFeatureCollection(*document)) {
+        tileData->layers.push_back(GeoJson::getLayer(*document, projFn, m_id));
     } else {
-        for (auto layer = document.MemberBegin(); layer != document.MemberEnd(); ++layer) {
+        for (auto layer = document->MemberBegin(); layer != document->MemberEnd(); ++layer) {
             if (GeoJson::isFeatureCollection(layer->value)) {
                 tileData->layers.push_back(GeoJson::getLayer(layer->value, projFn, m_id));
                 tileData->layers.back().name = layer->name.GetString();
@@ -1,9 +1,17 @@
 #pragma once
 
 #include "dataSource.h"
+#include "tile/tileHash.h"
+#include "util/asyncWorker.h"
+#include "util/streamedBuffer.h"
+
+#include <mutex>
+#include <unordered_map>
 
 namespace Tangram {
 
+class GeoJsonTileTask;
+
 class GeoJsonSource: public DataSource {
 
 protected:
@@ -16,6 +24,32 @@ public:
     GeoJsonSource(const std::string& _name, const std::string& _urlTemplate,
                   int32_t _minDisplayZoom, int32_t _maxDisplayZoom, int32_t _maxZoom);
 
+    /* Fetches over the streaming platform request, feeding the JSON
+     * parser on a worker while chunks arrive; see loadTileData. */
+    virtual bool loadTileData(std::shared_ptr<TileTask>&& _task, TileTaskCb _cb) override;
+
+    virtual void cancelLoadingTile(const TileID& _tile) override;
+
+    virtual std::shared_ptr<TileTask> createTask(TileID _tile, int _subTask = -1) override;
+
+private:
+
+    /* Parse job for one streamed fetch; runs on m_parseWorker and
+     * blocks on the stream until the transfer feeding it ends */
+    void parseStreamed(std::shared_ptr<StreamedBuffer> _stream,
+                       std::shared_ptr<UrlValidators> _validators,
+                       std::shared_ptr<TileTask> _task, TileTaskCb _cb);
+
+    // Streams of fetches in flight, so canceling a tile can unblock the
+    // parse job waiting on its tail. Guarded by m_streamsMutex: streams
+    // are added and canceled on the main thread, removed by parse jobs.
+    std::unordered_map<TileID, std::shared_ptr<StreamedBuffer>> m_streams;
+    std::mutex m_streamsMutex;
+
+    // Runs the document parse of streamed fetches. One thread is enough:
+    // while it drains one stream the chunks of the others pile up in
+    // their buffers, so their parses still overlap most of the transfer.
+    AsyncWorker m_parseWorker;
 };
 
 }
@@ -0,0 +1,132 @@
+#include "packedTileSource.h"
+
+#include "tile/tileID.h"
+#include "log.h"
+
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace Tangram {
+
+namespace {
+
+constexpr uint32_t PACK_MAGIC = 0x5447504b; // 'TGPK'
+constexpr uint32_t PACK_VERSION = 1;
+
+struct PackHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t count;
+};
+
+struct IndexEntry {
+    int32_t z;
+    int32_t x;
+    int32_t y;
+    uint64_t offset;
+    uint32_t length;
+};
+
+}
+
+PackedTileSource::PackedTileSource(const std::string& _name, const std::string& _path,
+                                   int32_t _minDisplayZoom, int32_t _maxDisplayZoom,
+                                   int32_t _maxZoom) :
+    MVTSource(_name, _path, _minDisplayZoom, _maxDisplayZoom, _maxZoom) {
+
+    openPack(_path);
+}
+
+PackedTileSource::~PackedTileSource() {
+    if (m_mapped) {
+        munmap(m_mapped, m_mappedSize);
+    }
+}
+
+void PackedTileSource::openPack(const std::string& _path) {
+
+    int fd = ::open(_path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        LOGE("Could not open tile pack '%s'", _path.c_str());
+        return;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || size_t(st.st_size) < sizeof(PackHeader)) {
+        LOGE("Invalid tile pack '%s'", _path.c_str());
+        ::close(fd);
+        return;
+    }
+
+    void* mapped = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    // The mapping keeps the file alive; the descriptor is not needed.
+    ::close(fd);
+
+    if (mapped == MAP_FAILED) {
+        LOGE("Could not map tile pack '%s'", _path.c_str());
+        return;
+    }
+
+    size_t mappedSize = st.st_size;
+    auto* header = static_cast<const PackHeader*>(mapped);
+
+    if (header->magic != PACK_MAGIC || header->version != PACK_VERSION ||
+        sizeof(PackHeader) + header->count * sizeof(IndexEntry) > mappedSize) {
+        LOGE("Invalid tile pack header in '%s'", _path.c_str());
+        munmap(mapped, mappedSize);
+        return;
+    }
+
+    auto* entries = reinterpret_cast<const IndexEntry*>(static_cast<char*>(mapped) + sizeof(PackHeader));
+
+    m_index.reserve(header->count);
+
+    for (uint32_t i = 0; i < header->count; i++) {
+        const IndexEntry& entry = entries[i];
+
+        if (entry.offset + entry.length > mappedSize) {
+            LOGW("Dropping out-of-bounds record %d in tile pack '%s'", i, _path.c_str());
+            continue;
+        }
+        m_index[TileID(entry.x, entry.y, entry.z)] = { entry.offset, entry.length };
+    }
+
+    m_mapped = static_cast<char*>(mapped);
+    m_mappedSize = mappedSize;
+}
+
+bool PackedTileSource::readTile(const TileID& _tileId, std::vector<char>& _data) const {
+
+    if (!m_mapped) { return false; }
+
+    auto it = m_index.find(TileID(_tileId.x, _tileId.y, _tileId.z));
+    if (it == m_index.end()) { return false; }
+
+    const char* blob = m_mapped + it->second.offset;
+    _data.assign(blob, blob + it->second.length);
+
+    return true;
+}
+
+bool PackedTileSource::loadTileData(std::shared_ptr<TileTask>&& _task, TileTaskCb _cb) {
+
+    auto& task = static_cast<DownloadTileTask&>(*_task);
+
+    if (!task.hasData()) {
+        auto rawDataRef = std::make_shared<std::vector<char>>();
+
+        if (!readTile(task.tileId(), *rawDataRef)) {
+            return false;
+        }
+        task.rawTileData = std::move(rawDataRef);
+    }
+
+    _cb.func(std::move(_task));
+
+    return true;
+}
+
+}
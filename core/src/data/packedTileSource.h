@@ -0,0 +1,60 @@
+#pragma once
+
+#include "data/mvtSource.h"
+#include "tile/tileHash.h"
+
+#include <mutex>
+#include <unordered_map>
+
+namespace Tangram {
+
+/* DataSource reading MVT tiles from a single packed file instead of one
+ * file or URL per tile.
+ *
+ * The pack is a flat archive: a header, a sorted index of tile records
+ * and the raw tile blobs. The whole file is memory-mapped once, so
+ * fetching a tile is an index lookup plus a read from the mapping -
+ * there is no per-tile filesystem metadata or URL request overhead.
+ *
+ * Layout (all integers little-endian):
+ *   PackHeader  { magic 'TGPK', version, tile count }
+ *   IndexEntry  { z, x, y, offset, length } x count, sorted by (z, x, y)
+ *   blobs
+ */
+class PackedTileSource : public MVTSource {
+
+public:
+
+    PackedTileSource(const std::string& _name, const std::string& _path,
+                     int32_t _minDisplayZoom = -1, int32_t _maxDisplayZoom = -1,
+                     int32_t _maxZoom = 18);
+
+    ~PackedTileSource() override;
+
+    /* Serves the tile from the pack on the calling thread; there is no
+     * asynchronous request to wait for or cancel. */
+    bool loadTileData(std::shared_ptr<TileTask>&& _task, TileTaskCb _cb) override;
+
+    void cancelLoadingTile(const TileID& _tile) override {}
+
+    /* Whether the pack was opened and indexed successfully */
+    bool valid() const { return m_mapped != nullptr; }
+
+private:
+
+    struct Slot {
+        uint64_t offset;
+        uint32_t length;
+    };
+
+    void openPack(const std::string& _path);
+
+    bool readTile(const TileID& _tileId, std::vector<char>& _data) const;
+
+    char* m_mapped = nullptr;
+    size_t m_mappedSize = 0;
+
+    std::unordered_map<TileID, Slot> m_index;
+};
+
+}
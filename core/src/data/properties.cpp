@@ -1,6 +1,8 @@
 #include "propertyItem.h"
 #include "properties.h"
 #include <algorithm>
+#include <cstdio>
+#include <cstdlib>
 
 namespace Tangram {
 
@@ -10,41 +12,74 @@ Properties::~Properties() {}
 
 Properties& Properties::operator=(Properties&& _other) {
     props = std::move(_other.props);
+    hashes = std::move(_other.hashes);
     sourceId = _other.sourceId;
     return *this;
 }
 
-void Properties::setSorted(std::vector<Item>&& _items) {
-    props = std::move(_items);
+void Properties::syncHashes() {
+    hashes.clear();
+    hashes.reserve(props.size());
+    for (const auto& item : props) {
+        hashes.push_back(item.keyHash);
+    }
 }
 
-const Value& Properties::get(const std::string& key) const {
+uint32_t Properties::keyHash(const std::string& key) {
+    return propertyKeyHash(key);
+}
 
-    const auto it = std::find_if(props.begin(), props.end(),
-                                 [&](const auto& item) {
-                                     return item.key == key;
-                                 });
-    if (it == props.end()) {
-        return NOT_A_VALUE;
+uint64_t Properties::keyBloom() const {
+    uint64_t bloom = 0;
+    for (auto hash : hashes) {
+        bloom |= 1ull << (hash & 63);
     }
+    return bloom;
+}
 
-    // auto it = std::lower_bound(props.begin(), props.end(), key,
-    //                            [](auto& item, auto& key) {
-    //                                return keyComparator(item.key, key);
-    //                            });
-    // if (it == props.end() || it->key != key) {
-    //     return NOT_FOUND;
-    // }
+size_t Properties::memoryUsage() const {
+    size_t bytes = 0;
+    if (!props.isInline()) { bytes += props.capacity() * sizeof(Item); }
+    if (!hashes.isInline()) { bytes += hashes.capacity() * sizeof(uint32_t); }
+    for (const auto& item : props) {
+        bytes += item.key.capacity();
+        if (item.value.is<std::string>()) {
+            bytes += item.value.get<std::string>().capacity();
+        }
+    }
+    return bytes;
+}
 
-    return it->value;
+const Value& Properties::get(const std::string& key) const {
+    return get(key, propertyKeyHash(key));
 }
 
-void Properties::clear() { props.clear(); }
+const Value& Properties::get(const std::string& key, uint32_t hash) const {
+
+    // Scan the flat hash array; the string compare only runs on a hash
+    // match, so this is one pass of integer compares for the common miss.
+    for (size_t i = 0, n = hashes.size(); i < n; i++) {
+        if (hashes[i] == hash && props[i].key == key) {
+            return props[i].value;
+        }
+    }
+
+    return NOT_A_VALUE;
+}
+
+void Properties::clear() {
+    props.clear();
+    hashes.clear();
+}
 
 bool Properties::contains(const std::string& key) const {
     return !get(key).is<none_type>();
 }
 
+bool Properties::contains(const std::string& key, uint32_t hash) const {
+    return !get(key, hash).is<none_type>();
+}
+
 bool Properties::getNumber(const std::string& key, double& value) const {
     auto& it = get(key);
     if (it.is<double>()) {
@@ -88,7 +123,7 @@ const bool Properties::getAsString(const std::string& key, std::string& value) c
         value = it.get<std::string>();
         return true;
     } else if (it.is<double>()) {
-        value = std::to_string(it.get<double>());
+        value = numberToString(it.get<double>());
         return true;
     }
 
@@ -99,11 +134,44 @@ std::string Properties::asString(const Value& value) const {
     if (value.is<std::string>()) {
         return value.get<std::string>();
     } else if (value.is<double>()) {
-        return std::to_string(value.get<double>());
+        return numberToString(value.get<double>());
     }
     return "";
 }
 
+std::string numberToString(double _value) {
+
+    char buf[32];
+
+    // Integer fast path: house numbers, refs and levels make up most
+    // numeric text sources, and emitting digits directly stays clear of
+    // the float formatting machinery.
+    long long integral = (long long)_value;
+    if (double(integral) == _value &&
+        _value >= -9007199254740992.0 && _value <= 9007199254740992.0) {
+
+        char* p = buf + sizeof(buf);
+        unsigned long long rest = integral < 0
+            ? 0ull - (unsigned long long)integral
+            : (unsigned long long)integral;
+        do {
+            *--p = char('0' + rest % 10);
+            rest /= 10;
+        } while (rest);
+        if (integral < 0) { *--p = '-'; }
+        return std::string(p, buf + sizeof(buf) - p);
+    }
+
+    // Shortest representation that parses back to the same double
+    for (int precision = 15; precision <= 17; precision++) {
+        int n = snprintf(buf, sizeof(buf), "%.*g", precision, _value);
+        if (precision == 17 || std::strtod(buf, nullptr) == _value) {
+            return std::string(buf, n);
+        }
+    }
+    return {}; // not reached
+}
+
 std::string Properties::getAsString(const std::string& key) const {
 
     return asString(get(key));
@@ -112,6 +180,7 @@ std::string Properties::getAsString(const std::string& key) const {
 
 void Properties::sort() {
     std::sort(props.begin(), props.end());
+    syncHashes();
 }
 
 void Properties::set(std::string key, std::string value) {
@@ -123,6 +192,7 @@ void Properties::set(std::string key, std::string value) {
 
     if (it == props.end() || it->key != key) {
         props.emplace(it, std::move(key), std::move(value));
+        syncHashes();
     } else {
         it->value = std::move(value);
     }
@@ -137,6 +207,7 @@ void Properties::set(std::string key, double value) {
 
     if (it == props.end() || it->key != key) {
         props.emplace(it, std::move(key), value);
+        syncHashes();
     } else {
         it->value = value;
     }
@@ -1,33 +1,54 @@
 #pragma once
 
-#include <vector>
+#include "data/propertyItem.h"
+#include "util/smallVector.h"
+
 #include <string>
 
 namespace Tangram {
 
 class Value;
-struct PropertyItem;
 
 struct Properties {
     using Item = PropertyItem;
 
+    // Inline item capacity; the median feature carries a handful of
+    // properties, so most sets never touch the heap.
+    static constexpr size_t max_inline_items = 6;
+
+    using Items = SmallVector<Item, max_inline_items>;
+
     Properties();
     ~Properties();
 
     Properties(const Properties& _other) = default;
     Properties(Properties&& _other) = default;
-    Properties(std::vector<Item>&& _items);
     Properties& operator=(const Properties& _other) = default;
     Properties& operator=(Properties&& _other);
 
     const Value& get(const std::string& key) const;
 
+    /* Lookup with a key hash precomputed via keyHash(); lets hot callers
+     * like Filter::eval resolve the hash once instead of per feature. */
+    const Value& get(const std::string& key, uint32_t hash) const;
+
+    static uint32_t keyHash(const std::string& key);
+
+    /* Bloom mask over the key hashes of this property set; used to
+     * reject layer filters that require a key no feature carries. */
+    uint64_t keyBloom() const;
+
+    /* Approximate heap bytes held by this property set */
+    size_t memoryUsage() const;
+
     void sort();
 
     void clear();
 
     bool contains(const std::string& key) const;
 
+    bool contains(const std::string& key, uint32_t hash) const;
+
     bool getNumber(const std::string& key, double& value) const;
 
     double getNumber(const std::string& key) const;
@@ -47,14 +68,20 @@ struct Properties {
     void set(std::string key, std::string value);
     void set(std::string key, double value);
 
-    void setSorted(std::vector<Item>&& _items);
+    void reserve(size_t _count) {
+        props.reserve(_count);
+        hashes.reserve(_count);
+    }
 
-    // template <typename... Args> void set(std::string key, Args&&... args) {
-    //     props.emplace_back(std::move(key), Value{std::forward<Args>(args)...});
-    //     sort();
-    // }
+    /* Append an item without re-sorting; append in key order or call
+     * sort() when done. Lets parsers fill the inline storage directly
+     * instead of building a temporary vector per feature. */
+    template <typename... Args> void emplaceBack(Args&&... args) {
+        props.emplace_back(std::forward<Args>(args)...);
+        hashes.push_back(props.back().keyHash);
+    }
 
-    const std::vector<Item>& items() const { return props; }
+    const Items& items() const { return props; }
 
     int32_t sourceId;
 
@@ -66,7 +93,20 @@ struct Properties {
         }
     }
 private:
-    std::vector<Item> props;
+    void syncHashes();
+
+    Items props;
+
+    // Key hashes of props, kept parallel as a flat array so lookups scan
+    // contiguous integers instead of striding over the items.
+    SmallVector<uint32_t, max_inline_items> hashes;
 };
 
+/* Format a numeric property value the way feature text expects:
+ * integral values print as plain integers, everything else with the
+ * shortest digit string that parses back to the same number. Shared by
+ * the property accessors and by style functions whose result feeds a
+ * text source or sprite key. */
+std::string numberToString(double _value);
+
 }
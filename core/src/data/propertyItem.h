@@ -4,12 +4,24 @@
 
 namespace Tangram {
 
+// FNV-1a; cheap enough to fold into property construction and collision
+// resistant enough that lookups rarely need the full string compare.
+inline uint32_t propertyKeyHash(const std::string& _key) {
+    uint32_t hash = 2166136261u;
+    for (char c : _key) {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
 struct PropertyItem {
     PropertyItem(std::string _key, Value _value) :
-        key(std::move(_key)), value(std::move(_value)) {}
+        key(std::move(_key)), value(std::move(_value)), keyHash(propertyKeyHash(key)) {}
 
     std::string key;
     Value value;
+    uint32_t keyHash;
     bool operator<(const PropertyItem& _rhs) const {
         return key.size() == _rhs.key.size()
             ? key < _rhs.key
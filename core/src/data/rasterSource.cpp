@@ -1,4 +1,5 @@
 #include "rasterSource.h"
+#include "data/urlRequestRegistry.h"
 #include "propertyItem.h"
 #include "util/mapProjection.h"
 
@@ -8,8 +9,83 @@
 #include "util/geoJson.h"
 #include "platform.h"
 
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <thread>
+
 namespace Tangram {
 
+/* Small dedicated pool for image decompression. Decoding PNG/JPEG on
+ * the tile workers stalls vector tile builds whenever a raster layer is
+ * active; routing decodes here keeps the two pipelines independent.
+ * Threads are started on first use and joined at teardown. */
+class RasterDecodePool {
+
+public:
+
+    static RasterDecodePool& instance() {
+        static RasterDecodePool pool;
+        return pool;
+    }
+
+    void enqueue(std::function<void()> _job) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+
+            if (m_threads.empty()) {
+                for (int i = 0; i < NUM_THREADS; i++) {
+                    m_threads.emplace_back(&RasterDecodePool::run, this);
+                }
+            }
+            m_jobs.push_back(std::move(_job));
+        }
+        m_condition.notify_one();
+    }
+
+private:
+
+    static constexpr int NUM_THREADS = 2;
+
+    RasterDecodePool() {}
+
+    ~RasterDecodePool() {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_running = false;
+        }
+        m_condition.notify_all();
+
+        for (auto& thread : m_threads) {
+            thread.join();
+        }
+    }
+
+    void run() {
+        while (true) {
+            std::function<void()> job;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_condition.wait(lock, [&, this]{
+                        return !m_running || !m_jobs.empty();
+                    });
+
+                if (!m_running && m_jobs.empty()) { return; }
+
+                job = std::move(m_jobs.front());
+                m_jobs.pop_front();
+            }
+            job();
+        }
+    }
+
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::deque<std::function<void()>> m_jobs;
+    std::vector<std::thread> m_threads;
+    bool m_running = true;
+};
+
 class RasterTileTask : public DownloadTileTask {
 public:
     RasterTileTask(TileID& _tileId, std::shared_ptr<DataSource> _source, int _subTask)
@@ -29,13 +105,24 @@ public:
         }
     }
 
-    void process(TileBuilder& _tileBuilder) override {
+    bool needsParsing() const override {
+        return !m_texture;
+    }
+
+    void parse(TileBuilder& _tileBuilder) override {
 
         auto source = reinterpret_cast<RasterSource*>(m_source.get());
 
+        decompressRawData();
+
+        // Decode texture data
+        m_texture = source->createTexture(*rawTileData);
+    }
+
+    void process(TileBuilder& _tileBuilder) override {
+
         if (!m_texture) {
-            // Decode texture data
-            m_texture = source->createTexture(*rawTileData);
+            parse(_tileBuilder);
         }
 
         // Create tile geometries
@@ -83,8 +170,16 @@ std::shared_ptr<Texture> RasterSource::createTexture(const std::vector<char>& _r
         return m_emptyTexture;
     }
 
+    // Tile payloads may be pre-compressed (ETC2/ASTC in a KTX
+    // container); those upload without decoding, see
+    // Texture::loadImageFromMemory.
     auto texture = std::make_shared<Texture>(_rawTileData, m_texOptions, m_genMipmap);
 
+    // A tile texture drawn at its own zoom samples only the base level;
+    // build the mip chain lazily when a zoom-out first minifies it, so
+    // upload cost stays off the pan/zoom-in path.
+    texture->setLazyMipmaps(true);
+
     return texture;
 }
 
@@ -105,12 +200,14 @@ std::shared_ptr<TileData> RasterSource::parse(const TileTask& _task, const MapPr
 
     tileData->layers.emplace_back("");
     tileData->layers.back().features.push_back(rasterFeature);
+    tileData->layers.back().buildKeyBloom();
     return tileData;
 
 }
 
 std::shared_ptr<TileTask> RasterSource::createTask(TileID _tileId, int _subTask) {
-    auto task = std::make_shared<RasterTileTask>(_tileId, shared_from_this(), _subTask);
+    auto task = std::allocate_shared<RasterTileTask>(PoolAllocator<RasterTileTask>(m_taskPool),
+                                                     _tileId, shared_from_this(), _subTask);
 
     // First try existing textures cache
     {
@@ -129,48 +226,130 @@ std::shared_ptr<TileTask> RasterSource::createTask(TileID _tileId, int _subTask)
     return task;
 }
 
-void RasterSource::onTileLoaded(std::vector<char>&& _rawData, std::shared_ptr<TileTask>&& _task,
+void RasterSource::onTileLoaded(std::vector<char>&& _rawData, UrlValidators&& _validators,
+                                bool _notModified, std::shared_ptr<TileTask>&& _task,
                                 TileTaskCb _cb) {
 
-    if (_task->isCanceled()) { return; }
-
     TileID tileID = _task->tileId();
 
-    auto rawDataRef = std::make_shared<std::vector<char>>();
-    std::swap(*rawDataRef, _rawData);
+    auto rawDataRef = std::make_shared<std::vector<char>>(std::move(_rawData));
 
     auto& task = static_cast<DownloadTileTask&>(*_task);
     task.rawTileData = rawDataRef;
-
-    _cb.func(std::move(_task));
-
-    cachePut(tileID, rawDataRef);
+    task.rawTileDataCompressed = false;
+    task.rawTileDataStale = false;
+
+    // Decompress on the raster pool before handing the task on, so the
+    // tile workers see a ready texture and vector builds never wait on
+    // image decoding. Tasks that attached to this fetch while it was in
+    // flight get the same texture; the image is decoded at most once,
+    // even when the lead task was canceled meanwhile. The tasks keep
+    // their source alive.
+    RasterDecodePool::instance().enqueue([this, _cb, task = std::move(_task)]() mutable {
+
+            auto& rasterTask = static_cast<RasterTileTask&>(*task);
+            auto source = reinterpret_cast<RasterSource*>(&rasterTask.source());
+
+            TileID id(rasterTask.tileId().x, rasterTask.tileId().y, rasterTask.tileId().z);
+            std::vector<std::pair<std::shared_ptr<TileTask>, TileTaskCb>> attached;
+            {
+                std::lock_guard<std::mutex> lock(m_pendingMutex);
+                auto pending = m_pending.find(id);
+                if (pending != m_pending.end()) {
+                    attached = std::move(pending->second);
+                    m_pending.erase(pending);
+                }
+            }
+
+            std::shared_ptr<Texture> texture;
+            if (!task->isCanceled()) {
+                texture = source->createTexture(*rasterTask.rawTileData);
+                rasterTask.m_texture = texture;
+            }
+
+            for (auto& waiter : attached) {
+                auto& waiterTask = static_cast<RasterTileTask&>(*waiter.first);
+                if (waiterTask.isCanceled()) { continue; }
+
+                if (!texture) { texture = source->createTexture(*rasterTask.rawTileData); }
+
+                waiterTask.rawTileData = rasterTask.rawTileData;
+                waiterTask.m_texture = texture;
+                waiter.second.func(std::move(waiter.first));
+            }
+
+            if (!task->isCanceled()) { _cb.func(std::move(task)); }
+        });
+
+    cachePut(tileID, std::move(rawDataRef));
 }
 
 bool RasterSource::loadTileData(std::shared_ptr<TileTask>&& _task, TileTaskCb _cb) {
 
+    // Sibling vector tiles past this source's max zoom resolve to the
+    // same raster tile; when its download is already in flight attach
+    // to it instead of fetching and decoding the same image once per
+    // sibling. onTileLoaded fans the texture out to attached tasks.
+    {
+        TileID id(_task->tileId().x, _task->tileId().y, _task->tileId().z);
+
+        std::lock_guard<std::mutex> lock(m_pendingMutex);
+        auto pending = m_pending.find(id);
+        if (pending != m_pending.end()) {
+            pending->second.emplace_back(std::move(_task), _cb);
+            return true;
+        }
+        m_pending[id];
+    }
+
     std::string url(constructURL(_task->tileId()));
 
     auto copyTask = _task;
 
+    auto priority = _task->isPrefetch() ? UrlRequestRegistry::Priority::prefetch
+                  : _task->isProxy() ? UrlRequestRegistry::Priority::proxy
+                  : UrlRequestRegistry::Priority::visible;
+
     // lambda captured parameters are const by default, we want "task" (moved) to be non-const,
     // hence "mutable"
     // Refer: http://en.cppreference.com/w/cpp/language/lambda
-    bool status = startUrlRequest(url,
+    bool status = UrlRequestRegistry::instance().start(url,
             [this, _cb, task = std::move(_task)](std::vector<char>&& rawData) mutable {
-                this->onTileLoaded(std::move(rawData), std::move(task), _cb);
-            });
+                this->onTileLoaded(std::move(rawData), {}, false, std::move(task), _cb);
+            }, priority);
 
     // For "dependent" raster datasources if this returns false make sure to create a black texture
     // for tileID in this task, and consider dependent raster ready
     if (!status) {
         auto& task = static_cast<RasterTileTask&>(*copyTask);
         task.m_texture = m_emptyTexture;
+
+        // Nothing can have attached within this call; just drop the marker
+        TileID id(copyTask->tileId().x, copyTask->tileId().y, copyTask->tileId().z);
+        std::lock_guard<std::mutex> lock(m_pendingMutex);
+        m_pending.erase(id);
     }
 
     return status;
 }
 
+void RasterSource::cancelLoadingTile(const TileID& _tile) {
+    {
+        TileID id(_tile.x, _tile.y, _tile.z);
+
+        std::lock_guard<std::mutex> lock(m_pendingMutex);
+        auto pending = m_pending.find(id);
+        if (pending != m_pending.end()) {
+            if (!pending->second.empty()) {
+                // Other tasks still wait on this fetch - keep it running
+                return;
+            }
+            m_pending.erase(pending);
+        }
+    }
+    DataSource::cancelLoadingTile(_tile);
+}
+
 Raster RasterSource::getRaster(const TileTask& _task) {
     TileID id(_task.tileId().x, _task.tileId().y, _task.tileId().z);
 
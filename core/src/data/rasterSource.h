@@ -20,6 +20,15 @@ class RasterSource : public DataSource {
     bool m_genMipmap;
     std::unordered_map<TileID, std::shared_ptr<Texture>> m_textures;
 
+    // Downloads in flight, keyed like m_textures. Tasks requesting a
+    // raster tile whose download is already running attach here and
+    // share it, so sibling vector tiles past this source's max zoom
+    // fetch and decode their common ancestor image only once. Guarded
+    // by m_pendingMutex: tasks attach on the main thread while fan-out
+    // runs on the decode pool.
+    std::unordered_map<TileID, std::vector<std::pair<std::shared_ptr<TileTask>, TileTaskCb>>> m_pending;
+    std::mutex m_pendingMutex;
+
     std::shared_ptr<Texture> m_emptyTexture;
 
 protected:
@@ -27,7 +36,8 @@ protected:
     virtual std::shared_ptr<TileData> parse(const TileTask& _task,
                                             const MapProjection& _projection) const override;
 
-    virtual void onTileLoaded(std::vector<char>&& _rawData, std::shared_ptr<TileTask>&& _task,
+    virtual void onTileLoaded(std::vector<char>&& _rawData, UrlValidators&& _validators,
+                              bool _notModified, std::shared_ptr<TileTask>&& _task,
                               TileTaskCb _cb) override;
 
 public:
@@ -40,6 +50,8 @@ public:
 
     virtual bool loadTileData(std::shared_ptr<TileTask>&& _task, TileTaskCb _cb) override;
 
+    virtual void cancelLoadingTile(const TileID& _tile) override;
+
     virtual void clearRasters() override;
     virtual void clearRaster(const TileID& id) override;
     virtual bool isRaster() const override { return true; }
@@ -2,7 +2,9 @@
 
 #include "glm/vec3.hpp"
 #include "data/properties.h"
+#include "util/memoryArena.h"
 
+#include <memory>
 #include <vector>
 #include <string>
 
@@ -65,9 +67,12 @@ enum GeometryType {
 
 typedef glm::vec3 Point;
 
-typedef std::vector<Point> Line;
+// Geometry containers draw from the arena installed for the current
+// thread during tile parsing (see MemoryArena); outside of a parse they
+// behave like plain std::vectors on the global heap.
+typedef std::vector<Point, ArenaAllocator<Point>> Line;
 
-typedef std::vector<Line> Polygon;
+typedef std::vector<Line, ArenaAllocator<Line>> Polygon;
 
 struct Feature {
     Feature() {}
@@ -75,9 +80,9 @@ struct Feature {
 
     GeometryType geometryType = GeometryType::polygons;
 
-    std::vector<Point> points;
-    std::vector<Line> lines;
-    std::vector<Polygon> polygons;
+    std::vector<Point, ArenaAllocator<Point>> points;
+    std::vector<Line, ArenaAllocator<Line>> lines;
+    std::vector<Polygon, ArenaAllocator<Polygon>> polygons;
 
     Properties props;
 };
@@ -90,10 +95,26 @@ struct Layer {
 
     std::vector<Feature> features;
 
+    // Bloom mask over the property keys present on any feature of this
+    // layer; lets matching skip scene layers whose filters require a
+    // key that no feature here carries. Built once after parsing.
+    uint64_t keyBloom = 0;
+
+    void buildKeyBloom() {
+        keyBloom = 0;
+        for (const auto& feature : features) {
+            keyBloom |= feature.props.keyBloom();
+        }
+    }
+
 };
 
 struct TileData {
 
+    // Backs the geometry of all layers below; declared first so it is
+    // destroyed after them.
+    std::shared_ptr<MemoryArena> arena;
+
     std::vector<Layer> layers;
 
 };
@@ -37,13 +37,8 @@ std::shared_ptr<TileData> TopoJsonSource::parse(const TileTask& _task,
     glm::dvec2 tileOrigin = {tileBounds.min.x, tileBounds.max.y*-1.0};
     double tileInverseScale = 1.0 / tileBounds.width();
 
-    const auto projFn = [&](glm::dvec2 _lonLat){
-        glm::dvec2 tmp = _projection.LonLatToMeters(_lonLat);
-        return Point {
-            (tmp.x - tileOrigin.x) * tileInverseScale,
-            (tmp.y - tileOrigin.y) * tileInverseScale,
-             0
-        };
+    const auto projFn = [&](glm::dvec2* _lonLats, size_t _count){
+        _projection.LonLatToTileUnits(_lonLats, _count, tileOrigin, tileInverseScale);
     };
 
     // Parse topology and transform
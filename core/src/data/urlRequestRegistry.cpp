@@ -0,0 +1,305 @@
+#include "urlRequestRegistry.h"
+
+#include "debug/sessionRecorder.h"
+
+#include <algorithm>
+
+namespace Tangram {
+
+UrlRequestRegistry& UrlRequestRegistry::instance() {
+    static UrlRequestRegistry registry;
+    return registry;
+}
+
+bool UrlRequestRegistry::start(const std::string& _url, UrlCallback _cb, Priority _priority) {
+
+    return start(_url,
+            [cb = std::move(_cb)](std::vector<char>&& _data, UrlValidators&&, bool) mutable {
+                cb(std::move(_data));
+            }, _priority, {});
+}
+
+bool UrlRequestRegistry::start(const std::string& _url, UrlRevalidateCallback _cb,
+                               Priority _priority, UrlValidators _validators) {
+
+    OfflineProvider provider;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        provider = m_offlineProvider;
+    }
+    if (provider) {
+        // Replay: deliver the recorded bytes synchronously, outside the
+        // lock since the callback may call back into the registry. An
+        // unknown URL gets an empty response - the recording simply
+        // never saw it - instead of falling through to the network.
+        std::vector<char> data;
+        provider(_url, data);
+        _cb(std::move(data), {}, false);
+        return true;
+    }
+
+    StartList toStart;
+    std::string toCancel;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        auto it = m_requests.find(_url);
+        if (it != m_requests.end()) {
+            auto& entry = it->second;
+            entry.callbacks.push_back(std::move(_cb));
+            entry.interested++;
+
+            // A second caller can raise the urgency, e.g. when a
+            // prefetched tile scrolls into view before its fetch ran
+            if (_priority < entry.priority && !entry.inFlight) {
+                laneRemoveLocked(_url, entry.priority);
+                entry.priority = _priority;
+                m_lanes[uint8_t(_priority)].push_back(_url);
+                dispatchLocked(toStart);
+            }
+            if (toStart.empty()) { return true; }
+        } else {
+
+            // The URL is wanted again; a late arrival is no longer waste
+            m_recentlyCanceled.erase(_url);
+
+            auto& entry = m_requests[_url];
+            entry.callbacks.push_back(std::move(_cb));
+            entry.validators = std::move(_validators);
+            entry.interested = 1;
+            entry.priority = _priority;
+
+            if (m_inFlight >= max_in_flight && _priority == Priority::visible) {
+                // Give the visible tile the slot of an in-flight
+                // prefetch; the prefetch rejoins its lane and is
+                // fetched again once the link has capacity.
+                auto demote = std::find_if(m_requests.begin(), m_requests.end(),
+                        [](const auto& r) {
+                            return r.second.inFlight &&
+                                   r.second.priority == Priority::prefetch;
+                        });
+                if (demote != m_requests.end()) {
+                    demote->second.inFlight = false;
+                    m_inFlight--;
+                    m_lanes[uint8_t(Priority::prefetch)].push_back(demote->first);
+                    toCancel = demote->first;
+                }
+            }
+
+            m_lanes[uint8_t(_priority)].push_back(_url);
+            dispatchLocked(toStart);
+        }
+    }
+
+    if (!toCancel.empty()) { cancelUrlRequest(toCancel); }
+    startPlatformRequests(toStart);
+
+    // Queued requests are started when a slot frees up; only an
+    // immediate platform rejection is reported
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_requests.find(_url) != m_requests.end();
+}
+
+void UrlRequestRegistry::warmupHost(const std::string& _urlTemplate) {
+
+    size_t scheme = _urlTemplate.find("://");
+    if (scheme == std::string::npos) { return; }
+
+    // Only remote hosts have a handshake worth overlapping with scene setup
+    std::string protocol = _urlTemplate.substr(0, scheme);
+    if (protocol != "http" && protocol != "https") { return; }
+
+    size_t hostEnd = _urlTemplate.find('/', scheme + 3);
+    std::string root = _urlTemplate.substr(0, hostEnd) + "/";
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_warmedHosts.insert(root).second) { return; }
+    }
+
+    // The response is thrown away; the request exists to run the DNS
+    // lookup and the TCP/TLS handshake while the scene is still being
+    // built, leaving a warm connection in the platform's pool for the
+    // first tile fetches. It bypasses the lanes - at scene load they
+    // are empty anyway - and does not count against the in-flight slots.
+    startUrlRequest(root, [](std::vector<char>&&) {});
+}
+
+void UrlRequestRegistry::cancel(const std::string& _url) {
+
+    StartList toStart;
+    bool cancelPlatform = false;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        auto it = m_requests.find(_url);
+        if (it != m_requests.end()) {
+            auto& entry = it->second;
+            if (--entry.interested > 0) {
+                // Others still wait on this transfer - keep it running.
+                // The canceled caller's task ignores the late callback.
+                return;
+            }
+
+            if (entry.inFlight) {
+                m_inFlight--;
+                cancelPlatform = true;
+            } else {
+                laneRemoveLocked(_url, entry.priority);
+            }
+            m_requests.erase(it);
+
+            dispatchLocked(toStart);
+        } else {
+            cancelPlatform = true;
+        }
+
+        if (cancelPlatform) {
+            m_cancelStats.canceled++;
+            m_recentlyCanceled[_url] = std::chrono::steady_clock::now();
+
+            // Drop stale markers; aborts past this window clearly worked
+            if (m_recentlyCanceled.size() > 256) {
+                auto now = std::chrono::steady_clock::now();
+                for (auto it2 = m_recentlyCanceled.begin(); it2 != m_recentlyCanceled.end();) {
+                    if (now - it2->second > std::chrono::seconds(30)) {
+                        it2 = m_recentlyCanceled.erase(it2);
+                    } else {
+                        ++it2;
+                    }
+                }
+            }
+        }
+    }
+
+    if (cancelPlatform) { cancelUrlRequest(_url); }
+    startPlatformRequests(toStart);
+}
+
+UrlRequestRegistry::CancelStats UrlRequestRegistry::cancelStats() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_cancelStats;
+}
+
+void UrlRequestRegistry::setOfflineProvider(OfflineProvider _provider) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_offlineProvider = std::move(_provider);
+}
+
+void UrlRequestRegistry::complete(const std::string& _url, std::vector<char>&& _data,
+                                  UrlValidators&& _validators, bool _notModified) {
+
+    std::vector<UrlRevalidateCallback> callbacks;
+    StartList toStart;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        auto entry = m_requests.find(_url);
+        if (entry == m_requests.end()) {
+            // Nobody waits on this URL; if it was recently canceled the
+            // platform let the transfer run to completion after all
+            auto canceled = m_recentlyCanceled.find(_url);
+            if (canceled != m_recentlyCanceled.end()) {
+                float latencyMs = std::chrono::duration<float, std::milli>(
+                        std::chrono::steady_clock::now() - canceled->second).count();
+                m_cancelStats.lateArrivals++;
+                m_cancelStats.lateBytes += _data.size();
+                if (latencyMs > m_cancelStats.maxLatencyMs) {
+                    m_cancelStats.maxLatencyMs = latencyMs;
+                }
+                m_recentlyCanceled.erase(canceled);
+            }
+            return;
+        }
+
+        if (entry->second.inFlight) {
+            m_inFlight--;
+        } else {
+            // A demoted transfer delivered before its re-dispatch
+            laneRemoveLocked(_url, entry->second.priority);
+        }
+
+        callbacks = std::move(entry->second.callbacks);
+        m_requests.erase(entry);
+
+        dispatchLocked(toStart);
+    }
+
+    // A 304 carries no body; the recording keeps the bytes of the full
+    // response that preceded it.
+    if (!_notModified) {
+        SessionRecorder::instance().recordResponse(_url, _data);
+    }
+
+    // Only attached duplicates pay for a copy of the data; they would
+    // otherwise have paid for a second download.
+    for (size_t i = 0; i + 1 < callbacks.size(); i++) {
+        std::vector<char> copy = _data;
+        callbacks[i](std::move(copy), UrlValidators(_validators), _notModified);
+    }
+    if (!callbacks.empty()) {
+        callbacks.back()(std::move(_data), std::move(_validators), _notModified);
+    }
+
+    startPlatformRequests(toStart);
+}
+
+void UrlRequestRegistry::dispatchLocked(StartList& _toStart) {
+
+    while (m_inFlight < max_in_flight) {
+
+        std::string url;
+        for (auto& lane : m_lanes) {
+            if (!lane.empty()) {
+                url = std::move(lane.front());
+                lane.pop_front();
+                break;
+            }
+        }
+        if (url.empty()) { return; }
+
+        auto entry = m_requests.find(url);
+        if (entry == m_requests.end() || entry->second.inFlight) { continue; }
+
+        entry->second.inFlight = true;
+        m_inFlight++;
+        _toStart.emplace_back(std::move(url), entry->second.validators);
+    }
+}
+
+void UrlRequestRegistry::startPlatformRequests(const StartList& _requests) {
+
+    for (auto& request : _requests) {
+        auto& url = request.first;
+
+        bool status = startUrlRequest(url, request.second,
+                [this, url](std::vector<char>&& rawData, UrlValidators&& validators, bool notModified) {
+                    complete(url, std::move(rawData), std::move(validators), notModified);
+                });
+
+        if (!status) {
+            StartList toStart;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                auto entry = m_requests.find(url);
+                if (entry != m_requests.end()) {
+                    m_inFlight--;
+                    m_requests.erase(entry);
+                }
+                dispatchLocked(toStart);
+            }
+            startPlatformRequests(toStart);
+        }
+    }
+}
+
+void UrlRequestRegistry::laneRemoveLocked(const std::string& _url, Priority _priority) {
+
+    auto& lane = m_lanes[uint8_t(_priority)];
+    auto it = std::find(lane.begin(), lane.end(), _url);
+    if (it != lane.end()) { lane.erase(it); }
+}
+
+}
@@ -0,0 +1,134 @@
+#pragma once
+
+#include "platform.h"
+
+#include <chrono>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace Tangram {
+
+/* Coalesces identical in-flight URL requests across data sources and
+ * dispatches them to the platform in priority lanes.
+ *
+ * Sources with overlapping URL templates, proxies and prefetches can ask
+ * for a tile whose download is already running; instead of issuing a
+ * duplicate platform request, later callers attach their callback to the
+ * existing transfer and every callback fires when it completes. The
+ * platform request is only canceled once all interested parties have
+ * given up on it.
+ *
+ * A bounded number of requests is handed to the platform at a time, the
+ * rest wait in lanes served visible-first, so on constrained links a
+ * prefetch never sits in front of a tile the user is looking at. When
+ * the in-flight slots are all taken, a visible request evicts an
+ * in-flight prefetch back into its lane.
+ */
+class UrlRequestRegistry {
+
+public:
+
+    /* Lanes in dispatch order */
+    enum class Priority : uint8_t {
+        visible = 0, // Tiles in the current view
+        proxy = 1,   // Stand-ins covering a zoom or pan transition
+        prefetch = 2 // Speculative fetches around the view
+    };
+
+    static UrlRequestRegistry& instance();
+
+    /* Start a request for _url, or attach _cb to one already in flight.
+     * Returns false when the platform rejected a new request. */
+    bool start(const std::string& _url, UrlCallback _cb,
+               Priority _priority = Priority::visible);
+
+    /* As above, revalidating a cached copy: _validators are sent as
+     * conditional request headers and _cb receives the validators of
+     * the response, with _notModified set on a 304. */
+    bool start(const std::string& _url, UrlRevalidateCallback _cb,
+               Priority _priority, UrlValidators _validators);
+
+    /* Open a connection to the host of _urlTemplate ahead of the first
+     * real request for it, so tile fetches made moments later find the
+     * DNS lookup and the TCP/TLS handshake already done. Each host is
+     * warmed once per run; non-http(s) templates are ignored. */
+    void warmupHost(const std::string& _urlTemplate);
+
+    /* Note that one interested party gave up on _url. While others
+     * remain the transfer keeps running and their callbacks still fire;
+     * with none left the platform request is canceled. */
+    void cancel(const std::string& _url);
+
+    /* Counters verifying that platform cancellation actually aborts
+     * transfers (see cancelUrlRequest): data that still arrives after a
+     * cancel was bandwidth spent on a tile nobody wants. Shown in the
+     * debug overlay. */
+    struct CancelStats {
+        // Requests forwarded to cancelUrlRequest
+        size_t canceled = 0;
+        // Canceled requests whose data arrived anyway, and its volume
+        size_t lateArrivals = 0;
+        size_t lateBytes = 0;
+        // Milliseconds between the cancel and the late arrival
+        float maxLatencyMs = 0.f;
+    };
+
+    CancelStats cancelStats();
+
+    /* Returns the recorded bytes for a URL, or false when it holds none */
+    using OfflineProvider = std::function<bool(const std::string&, std::vector<char>&)>;
+
+    /* Serve all requests synchronously from _provider instead of the
+     * platform, for deterministic replay of recorded sessions. URLs the
+     * provider does not know are delivered as empty responses, so a
+     * replay never touches the network. An empty provider restores
+     * normal operation. */
+    void setOfflineProvider(OfflineProvider _provider);
+
+private:
+
+    /* Concurrent platform requests; more wait in the lanes */
+    static constexpr size_t max_in_flight = 16;
+
+    void complete(const std::string& _url, std::vector<char>&& _data,
+                  UrlValidators&& _validators, bool _notModified);
+
+    /* The locked helpers below collect requests whose platform transfer
+     * must be started after the lock is released */
+    using StartList = std::vector<std::pair<std::string, UrlValidators>>;
+    void dispatchLocked(StartList& _toStart);
+    void startPlatformRequests(const StartList& _requests);
+
+    void laneRemoveLocked(const std::string& _url, Priority _priority);
+
+    struct Entry {
+        std::vector<UrlRevalidateCallback> callbacks;
+        UrlValidators validators;
+        int interested = 0;
+        Priority priority = Priority::visible;
+        bool inFlight = false;
+    };
+
+    std::mutex m_mutex;
+    std::unordered_map<std::string, Entry> m_requests;
+
+    size_t m_inFlight = 0;
+    std::list<std::string> m_lanes[3];
+
+    // Host roots a warmup request was already issued for
+    std::unordered_set<std::string> m_warmedHosts;
+
+    // URLs recently forwarded to cancelUrlRequest with the time of the
+    // cancel, matched against data that still arrives for them
+    std::unordered_map<std::string, std::chrono::steady_clock::time_point> m_recentlyCanceled;
+    CancelStats m_cancelStats;
+
+    OfflineProvider m_offlineProvider;
+};
+
+}
@@ -1,17 +1,21 @@
 #include "debug/frameInfo.h"
 
 #include "tangram.h"
+#include "data/urlRequestRegistry.h"
 #include "debug/textDisplay.h"
 #include "tile/tileManager.h"
 #include "tile/tile.h"
 #include "tile/tileCache.h"
+#include "gl/hardware.h"
 #include "gl/primitives.h"
 #include "view/view.h"
 #include "gl.h"
 #include "gl/error.h"
 
+#include <algorithm>
 #include <deque>
 #include <ctime>
+#include <vector>
 
 #define TIME_TO_MS(start, end) (float(end - start) / CLOCKS_PER_SEC * 1000.0f)
 
@@ -26,6 +30,59 @@ static clock_t s_startFrameTime = 0,
     s_startUpdateTime = 0,
     s_endUpdateTime = 0;
 
+// GPU pass timing. A timer query per pass; results lag the draw by a
+// few frames and are polled in draw(), so nothing here stalls the
+// pipeline. All state lives on the render thread.
+namespace {
+
+struct GpuPass {
+    std::string name;
+    GLuint query;
+};
+
+// Queries whose result has not come back yet, oldest first
+static std::deque<GpuPass> s_pendingPasses;
+// Finished query objects available for reuse
+static std::vector<GLuint> s_queryPool;
+static GLuint s_activeQuery = 0;
+
+// Smoothed milliseconds per pass name, in order of first appearance
+static std::vector<std::pair<std::string, float>> s_passTimes;
+
+}
+
+void FrameInfo::beginPass(const std::string& _name) {
+
+    if (!Hardware::supportsTimerQuery) { return; }
+    if (!getDebugFlag(DebugFlags::tangram_infos) && !getDebugFlag(DebugFlags::tangram_stats)) {
+        return;
+    }
+    // Only one timer query can be active; skip a nested pass rather
+    // than break the enclosing one
+    if (s_activeQuery) { return; }
+
+    GLuint query = 0;
+    if (!s_queryPool.empty()) {
+        query = s_queryPool.back();
+        s_queryPool.pop_back();
+    } else {
+        GL::genQueries(1, &query);
+    }
+    if (!query) { return; }
+
+    GL::beginQuery(GL_TIME_ELAPSED, query);
+    s_activeQuery = query;
+    s_pendingPasses.push_back({_name, query});
+}
+
+void FrameInfo::endPass() {
+
+    if (!s_activeQuery) { return; }
+
+    GL::endQuery(GL_TIME_ELAPSED);
+    s_activeQuery = 0;
+}
+
 void FrameInfo::beginUpdate() {
 
     if (getDebugFlag(DebugFlags::tangram_infos) || getDebugFlag(DebugFlags::tangram_stats)) {
@@ -55,6 +112,33 @@ void FrameInfo::beginFrame() {
 void FrameInfo::draw(RenderState& rs, const View& _view, TileManager& _tileManager) {
 
     if (getDebugFlag(DebugFlags::tangram_infos) || getDebugFlag(DebugFlags::tangram_stats)) {
+
+        // Collect timer query results that have become available; they
+        // come back in submission order, so stop at the first pending one
+        while (!s_pendingPasses.empty()) {
+            auto& pass = s_pendingPasses.front();
+
+            GLuint available = 0;
+            GL::getQueryObjectuiv(pass.query, GL_QUERY_RESULT_AVAILABLE, &available);
+            if (!available) { break; }
+
+            GLuint nanoseconds = 0;
+            GL::getQueryObjectuiv(pass.query, GL_QUERY_RESULT, &nanoseconds);
+            float ms = nanoseconds / 1.0e6f;
+
+            auto it = std::find_if(s_passTimes.begin(), s_passTimes.end(),
+                                   [&](const auto& t) { return t.first == pass.name; });
+            if (it == s_passTimes.end()) {
+                s_passTimes.emplace_back(pass.name, ms);
+            } else {
+                // Smooth over frames, like the CPU-side averages above
+                it->second = it->second * 0.9f + ms * 0.1f;
+            }
+
+            s_queryPool.push_back(pass.query);
+            s_pendingPasses.pop_front();
+        }
+
         static int cpt = 0;
 
         static std::deque<float> updatetime;
@@ -108,25 +192,46 @@ void FrameInfo::draw(RenderState& rs, const View& _view, TileManager& _tileManag
         }
 
         if (getDebugFlag(DebugFlags::tangram_infos)) {
-            std::vector<std::string> debuginfos;
-
-            debuginfos.push_back("visible tiles:"
-                                 + std::to_string(_tileManager.getVisibleTiles().size()));
-            debuginfos.push_back("selectable features:"
-                                 + std::to_string(features));
-            debuginfos.push_back("tile cache size:"
-                                 + std::to_string(_tileManager.getTileCache()->getMemoryUsage() / 1024) + "kb");
-            debuginfos.push_back("tile size:" + std::to_string(memused / 1024) + "kb");
-            debuginfos.push_back("avg frame cpu time:" + to_string_with_precision(avgTimeCpu, 2) + "ms");
-            debuginfos.push_back("avg frame render time:" + to_string_with_precision(avgTimeRender, 2) + "ms");
-            debuginfos.push_back("avg frame update time:" + to_string_with_precision(avgTimeUpdate, 2) + "ms");
-            debuginfos.push_back("zoom:" + std::to_string(_view.getZoom()));
-            debuginfos.push_back("pos:" + std::to_string(_view.getPosition().x) + "/"
-                                 + std::to_string(_view.getPosition().y));
-            debuginfos.push_back("tilt:" + std::to_string(_view.getPitch() * 57.3) + "deg");
-            debuginfos.push_back("pixel scale:" + std::to_string(_view.pixelScale()));
-
-            TextDisplay::Instance().draw(rs, debuginfos);
+            // Format into the display's preallocated line buffers; the
+            // overlay should not allocate while measuring the frame
+            auto& display = TextDisplay::Instance();
+            display.beginInfos();
+
+            display.addInfo("visible tiles:%d", int(_tileManager.getVisibleTiles().size()));
+            display.addInfo("selectable features:%d", int(features));
+            display.addInfo("tile cache size:%dkb",
+                            int(_tileManager.getTileCache()->getMemoryUsage() / 1024));
+            display.addInfo("tile size:%dkb", int(memused / 1024));
+            display.addInfo("avg frame cpu time:%.2fms", avgTimeCpu);
+            display.addInfo("avg frame render time:%.2fms", avgTimeRender);
+            display.addInfo("avg frame update time:%.2fms", avgTimeUpdate);
+            display.addInfo("zoom:%f", _view.getZoom());
+            display.addInfo("pos:%f/%f", _view.getPosition().x, _view.getPosition().y);
+            display.addInfo("tilt:%fdeg", _view.getPitch() * 57.3);
+            display.addInfo("pixel scale:%f", _view.pixelScale());
+
+            // Data arriving after a cancel means the platform did not
+            // abort the transfer; see cancelUrlRequest
+            auto cancels = UrlRequestRegistry::instance().cancelStats();
+            display.addInfo("canceled requests:%d late:%d (%dkb)",
+                            int(cancels.canceled), int(cancels.lateArrivals),
+                            int(cancels.lateBytes / 1024));
+            if (cancels.lateArrivals > 0) {
+                display.addInfo("max cancel latency:%.2fms", cancels.maxLatencyMs);
+            }
+
+            if (Hardware::supportsTimerQuery && !s_passTimes.empty()) {
+                float gpuTotal = 0.f;
+                for (auto& pass : s_passTimes) {
+                    gpuTotal += pass.second;
+                    display.addInfo("gpu %s:%.2fms", pass.first.c_str(), pass.second);
+                }
+                // Passes run back to back, so their sum stands in for
+                // the GPU frame time
+                display.addInfo("gpu total:%.2fms", gpuTotal);
+            }
+
+            display.draw(rs);
         }
 
         if (getDebugFlag(DebugFlags::tangram_stats)) {
@@ -147,6 +252,8 @@ void FrameInfo::draw(RenderState& rs, const View& _view, TileManager& _tileManag
             Primitives::setColor(rs, 0xff0000);
             Primitives::drawLine(rs, glm::vec2(0.0, 16.6 * scale),
                 glm::vec2(DEBUG_STATS_MAX_SIZE * 4 * _view.pixelScale() + 4, 16.6 * scale));
+
+            Primitives::flush(rs);
         }
     }
 }
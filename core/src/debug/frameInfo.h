@@ -1,5 +1,7 @@
 #pragma once
 
+#include <string>
+
 namespace Tangram {
 
 class RenderState;
@@ -13,6 +15,15 @@ struct FrameInfo {
 
     static void endUpdate();
 
+    /* Time a render pass on the GPU with a GL timer query; results are
+     * read back a few frames later and shown in the debug overlay, so
+     * jank can be attributed to the CPU or to a particular pass. Passes
+     * must not nest - only one GL timer query can be active - and both
+     * calls must come from the render thread. No-ops when the driver
+     * has no timer queries or the debug overlay is off. */
+    static void beginPass(const std::string& _name);
+    static void endPass();
+
     static void draw(RenderState& rs, const View& _view, TileManager& _tileManager);
 };
 
@@ -0,0 +1,102 @@
+#include "debug/framePacing.h"
+
+#include <chrono>
+#include <mutex>
+
+namespace Tangram {
+
+namespace {
+
+constexpr float default_budget_ms = 1000.f / 60.f;
+constexpr int num_stages = 3;
+
+std::mutex s_mutex;
+FramePacingStats s_stats;
+float s_budgetMs = default_budget_ms;
+
+// Start of the frame currently being measured; negative before the
+// first frame and after clear(), so no bogus interval is recorded.
+int64_t s_frameStart = -1;
+float s_stageMs[num_stages] = {};
+
+int64_t timeNowMicroseconds() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int bucketForDuration(float _ms) {
+    int bucket = 0;
+    while (bucket < FramePacingStats::num_buckets - 1 && _ms >= float(1u << bucket)) {
+        bucket++;
+    }
+    return bucket;
+}
+
+}
+
+void FramePacing::startFrame() {
+
+    int64_t now = timeNowMicroseconds();
+
+    std::lock_guard<std::mutex> lock(s_mutex);
+
+    if (s_frameStart >= 0) {
+        float intervalMs = (now - s_frameStart) / 1000.f;
+
+        s_stats.frames++;
+        s_stats.intervalCounts[bucketForDuration(intervalMs)]++;
+        if (intervalMs > s_stats.longestFrameMs) {
+            s_stats.longestFrameMs = intervalMs;
+        }
+
+        if (intervalMs > s_budgetMs) {
+            s_stats.missedFrames++;
+
+            float measured = s_stageMs[0] + s_stageMs[1] + s_stageMs[2];
+
+            if (measured < 0.5f * intervalMs) {
+                s_stats.missedOnOther++;
+            } else if (s_stageMs[int(Stage::draw)] >= s_stageMs[int(Stage::tiles)] &&
+                       s_stageMs[int(Stage::draw)] >= s_stageMs[int(Stage::labels)]) {
+                s_stats.missedOnDraw++;
+            } else if (s_stageMs[int(Stage::tiles)] >= s_stageMs[int(Stage::labels)]) {
+                s_stats.missedOnTiles++;
+            } else {
+                s_stats.missedOnLabels++;
+            }
+        }
+    }
+
+    s_frameStart = now;
+    for (auto& stage : s_stageMs) { stage = 0.f; }
+}
+
+FramePacing::Scope::Scope(Stage _stage)
+    : m_stage(_stage),
+      m_start(timeNowMicroseconds()) {}
+
+FramePacing::Scope::~Scope() {
+    float ms = (timeNowMicroseconds() - m_start) / 1000.f;
+
+    std::lock_guard<std::mutex> lock(s_mutex);
+    s_stageMs[int(m_stage)] += ms;
+}
+
+void FramePacing::setFrameBudget(float _budgetMs) {
+    std::lock_guard<std::mutex> lock(s_mutex);
+    s_budgetMs = _budgetMs > 0.f ? _budgetMs : default_budget_ms;
+}
+
+FramePacingStats FramePacing::getStats() {
+    std::lock_guard<std::mutex> lock(s_mutex);
+    return s_stats;
+}
+
+void FramePacing::clear() {
+    std::lock_guard<std::mutex> lock(s_mutex);
+    s_stats = FramePacingStats{};
+    s_frameStart = -1;
+    for (auto& stage : s_stageMs) { stage = 0.f; }
+}
+
+}
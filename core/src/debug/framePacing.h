@@ -0,0 +1,75 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+namespace Tangram {
+
+/* Aggregated frame pacing numbers, collected between successive
+ * Map::update calls on the render thread and cheap enough to stay on in
+ * production. The interval histogram shows how frames are distributed
+ * around the vsync budget, and missed frames are attributed to the
+ * dominant engine stage of that frame so telemetry can tell a label
+ * placement spike from a heavy draw. */
+struct FramePacingStats {
+
+    static constexpr int num_buckets = 16;
+
+    /* Frame intervals in power-of-two millisecond buckets:
+     * intervalCounts[0] holds frames below 1ms, intervalCounts[i] those
+     * in [2^(i-1), 2^i) ms and the last bucket everything beyond */
+    std::array<uint32_t, num_buckets> intervalCounts = {};
+
+    uint32_t frames = 0;
+
+    // Frames whose interval exceeded the budget
+    uint32_t missedFrames = 0;
+
+    // Missed frames broken down by their dominant measured stage. Mesh
+    // uploads happen lazily inside the draw stage and are counted there.
+    uint32_t missedOnTiles = 0;  // Tile set bookkeeping in update
+    uint32_t missedOnLabels = 0; // Label placement and fading
+    uint32_t missedOnDraw = 0;   // Rendering, including mesh uploads
+    // Missed frames where the measured stages cover less than half the
+    // interval - time went to the host application, swap or untracked
+    // engine work
+    uint32_t missedOnOther = 0;
+
+    float longestFrameMs = 0.f;
+};
+
+class FramePacing {
+
+public:
+
+    enum class Stage : int {
+        tiles = 0,
+        labels = 1,
+        draw = 2,
+    };
+
+    /* Called at the start of Map::update; closes out the previous frame,
+     * bucketing its interval and attributing it when over budget */
+    static void startFrame();
+
+    /* Accumulates the lifetime of the scope into a stage of the current
+     * frame; a stage may run in several scopes per frame */
+    class Scope {
+    public:
+        Scope(Stage _stage);
+        ~Scope();
+    private:
+        Stage m_stage;
+        int64_t m_start;
+    };
+
+    /* Frame intervals above _budgetMs count as missed; 0 restores the
+     * 60Hz default */
+    static void setFrameBudget(float _budgetMs);
+
+    static FramePacingStats getStats();
+
+    static void clear();
+};
+
+}
@@ -0,0 +1,142 @@
+#include "debug/jsProfiler.h"
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Tangram {
+namespace JsProfiler {
+
+std::atomic<bool> s_enabled{false};
+
+namespace {
+
+struct Entry {
+    uint64_t calls = 0;
+    int64_t nanoseconds = 0;
+};
+
+// Per-thread counters: record() only ever locks the mutex of its own
+// thread's instance, which is uncontended unless a report is running.
+struct Counters {
+    std::mutex mutex;
+    std::map<std::pair<uint32_t, const std::string*>, Entry> entries;
+};
+
+std::mutex s_registryMutex;
+std::vector<std::shared_ptr<Counters>> s_registry;
+
+Counters& threadCounters() {
+    static thread_local std::shared_ptr<Counters> counters = []() {
+        auto instance = std::make_shared<Counters>();
+        std::lock_guard<std::mutex> lock(s_registryMutex);
+        s_registry.push_back(instance);
+        return instance;
+    }();
+    return *counters;
+}
+
+}
+
+void setEnabled(bool _on) {
+    s_enabled.store(_on, std::memory_order_relaxed);
+}
+
+void record(uint32_t _functionId, const std::string* _layer, int64_t _ns) {
+
+    auto& counters = threadCounters();
+
+    std::lock_guard<std::mutex> lock(counters.mutex);
+    auto& entry = counters.entries[{_functionId, _layer}];
+    entry.calls++;
+    entry.nanoseconds += _ns;
+}
+
+std::string report() {
+
+    // Sum the per-thread counters into per-function totals with their
+    // layer breakdown
+    struct LayerEntry {
+        const std::string* layer;
+        Entry entry;
+    };
+    struct FunctionEntry {
+        Entry total;
+        std::vector<LayerEntry> layers;
+    };
+    std::map<uint32_t, FunctionEntry> functions;
+
+    {
+        std::lock_guard<std::mutex> registryLock(s_registryMutex);
+
+        for (auto& counters : s_registry) {
+            std::lock_guard<std::mutex> lock(counters->mutex);
+
+            for (const auto& entry : counters->entries) {
+                auto& function = functions[entry.first.first];
+                function.total.calls += entry.second.calls;
+                function.total.nanoseconds += entry.second.nanoseconds;
+
+                auto it = std::find_if(function.layers.begin(), function.layers.end(),
+                                       [&](const auto& l) { return l.layer == entry.first.second; });
+                if (it == function.layers.end()) {
+                    function.layers.push_back({entry.first.second, entry.second});
+                } else {
+                    it->entry.calls += entry.second.calls;
+                    it->entry.nanoseconds += entry.second.nanoseconds;
+                }
+            }
+            counters->entries.clear();
+        }
+    }
+
+    std::vector<std::pair<uint32_t, FunctionEntry>> sorted;
+    for (auto& function : functions) {
+        sorted.emplace_back(function.first, std::move(function.second));
+    }
+    std::sort(sorted.begin(), sorted.end(),
+              [](const auto& a, const auto& b) {
+                  return a.second.total.nanoseconds > b.second.total.nanoseconds;
+              });
+
+    std::string out = "JS function profile:\n";
+    char line[160];
+
+    for (auto& function : sorted) {
+        snprintf(line, sizeof(line), "fn #%-4u %10llu calls %10.3fms\n",
+                 function.first,
+                 (unsigned long long)function.second.total.calls,
+                 function.second.total.nanoseconds / 1.0e6);
+        out += line;
+
+        std::sort(function.second.layers.begin(), function.second.layers.end(),
+                  [](const auto& a, const auto& b) {
+                      return a.entry.nanoseconds > b.entry.nanoseconds;
+                  });
+
+        for (const auto& layer : function.second.layers) {
+            snprintf(line, sizeof(line), "    %-24s %10llu calls %10.3fms\n",
+                     layer.layer ? layer.layer->c_str() : "(no layer)",
+                     (unsigned long long)layer.entry.calls,
+                     layer.entry.nanoseconds / 1.0e6);
+            out += line;
+        }
+    }
+
+    if (sorted.empty()) { out += "    no calls recorded\n"; }
+
+    return out;
+}
+
+void clear() {
+    std::lock_guard<std::mutex> registryLock(s_registryMutex);
+    for (auto& counters : s_registry) {
+        std::lock_guard<std::mutex> lock(counters->mutex);
+        counters->entries.clear();
+    }
+}
+
+}
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace Tangram {
+
+/* Counts duktape VM invocations per scene function, attributed to the
+ * data layer whose rules triggered them, with the time spent inside the
+ * VM. Collection is enabled through the js_profile debug flag; turning
+ * the flag off logs the report. Style authors get "function #7 ran 1.2M
+ * times for layer 'buildings'" without attaching a native profiler.
+ *
+ * Counters are kept per worker thread and only aggregated for the
+ * report, so enabled profiling does not serialize the tile builders.
+ * Layer names are referenced from the scene; drop the counters with
+ * clear() before tearing the scene down. */
+namespace JsProfiler {
+
+extern std::atomic<bool> s_enabled;
+
+inline bool isEnabled() {
+    return s_enabled.load(std::memory_order_relaxed);
+}
+
+void setEnabled(bool _on);
+
+/* Count one VM invocation of function _functionId for layer _layer
+ * (may be null outside of layer matching) taking _ns nanoseconds */
+void record(uint32_t _functionId, const std::string* _layer, int64_t _ns);
+
+/* Aggregate the counters of all threads into a readable report, most
+ * expensive function first, and reset them */
+std::string report();
+
+void clear();
+
+}
+
+}
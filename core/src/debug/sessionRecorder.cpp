@@ -0,0 +1,180 @@
+#include "debug/sessionRecorder.h"
+
+#include "log.h"
+
+#include <cstring>
+
+namespace Tangram {
+
+/* The file is a sequence of tagged records after a small header:
+ *
+ *   "TGSR" magic, uint32 version
+ *   'F' frame:    SessionFrame fields in declaration order
+ *   'R' response: uint32 url length, url bytes,
+ *                 uint32 data length, data bytes
+ *
+ * All integers little-endian host layout; recordings are a developer
+ * exchange format, not a portable archive.
+ */
+
+namespace {
+
+const char magic[4] = {'T', 'G', 'S', 'R'};
+constexpr uint32_t version = 1;
+
+template<typename T>
+bool writeValue(FILE* _file, const T& _value) {
+    return fwrite(&_value, sizeof(T), 1, _file) == 1;
+}
+
+template<typename T>
+bool readValue(FILE* _file, T& _value) {
+    return fread(&_value, sizeof(T), 1, _file) == 1;
+}
+
+} // namespace
+
+SessionRecorder& SessionRecorder::instance() {
+    static SessionRecorder recorder;
+    return recorder;
+}
+
+bool SessionRecorder::start(const std::string& _path) {
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (m_file) {
+        fclose(m_file);
+        m_file = nullptr;
+    }
+    m_seenUrls.clear();
+
+    m_file = fopen(_path.c_str(), "wb");
+    if (!m_file) {
+        LOGE("Could not open session recording '%s'", _path.c_str());
+        return false;
+    }
+
+    fwrite(magic, sizeof(magic), 1, m_file);
+    writeValue(m_file, version);
+
+    return true;
+}
+
+void SessionRecorder::stop() {
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (m_file) {
+        fclose(m_file);
+        m_file = nullptr;
+    }
+    m_seenUrls.clear();
+}
+
+bool SessionRecorder::isRecording() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_file != nullptr;
+}
+
+void SessionRecorder::recordFrame(const SessionFrame& _frame) {
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_file) { return; }
+
+    writeValue(m_file, uint8_t('F'));
+    writeValue(m_file, _frame.dt);
+    writeValue(m_file, _frame.longitude);
+    writeValue(m_file, _frame.latitude);
+    writeValue(m_file, _frame.zoom);
+    writeValue(m_file, _frame.rotation);
+    writeValue(m_file, _frame.tilt);
+}
+
+void SessionRecorder::recordResponse(const std::string& _url, const std::vector<char>& _data) {
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_file) { return; }
+
+    if (!m_seenUrls.insert(_url).second) { return; }
+
+    writeValue(m_file, uint8_t('R'));
+    writeValue(m_file, uint32_t(_url.size()));
+    fwrite(_url.data(), 1, _url.size(), m_file);
+    writeValue(m_file, uint32_t(_data.size()));
+    fwrite(_data.data(), 1, _data.size(), m_file);
+}
+
+bool SessionReplay::load(const std::string& _path) {
+
+    m_frames.clear();
+    m_responses.clear();
+
+    FILE* file = fopen(_path.c_str(), "rb");
+    if (!file) {
+        LOGE("Could not open session recording '%s'", _path.c_str());
+        return false;
+    }
+
+    char header[4];
+    uint32_t fileVersion = 0;
+    if (fread(header, sizeof(header), 1, file) != 1 ||
+        memcmp(header, magic, sizeof(magic)) != 0 ||
+        !readValue(file, fileVersion) || fileVersion != version) {
+        LOGE("'%s' is not a session recording", _path.c_str());
+        fclose(file);
+        return false;
+    }
+
+    bool ok = true;
+    uint8_t tag;
+
+    while (readValue(file, tag)) {
+        if (tag == 'F') {
+            SessionFrame frame;
+            ok = readValue(file, frame.dt) &&
+                 readValue(file, frame.longitude) &&
+                 readValue(file, frame.latitude) &&
+                 readValue(file, frame.zoom) &&
+                 readValue(file, frame.rotation) &&
+                 readValue(file, frame.tilt);
+            if (!ok) { break; }
+            m_frames.push_back(frame);
+
+        } else if (tag == 'R') {
+            uint32_t urlSize, dataSize;
+            std::string url;
+            if (!(ok = readValue(file, urlSize))) { break; }
+            url.resize(urlSize);
+            if (!(ok = (fread(&url[0], 1, urlSize, file) == urlSize))) { break; }
+            if (!(ok = readValue(file, dataSize))) { break; }
+            std::vector<char> data(dataSize);
+            if (!(ok = (fread(data.data(), 1, dataSize, file) == dataSize))) { break; }
+            m_responses[std::move(url)] = std::move(data);
+
+        } else {
+            ok = false;
+            break;
+        }
+    }
+
+    fclose(file);
+
+    if (!ok) {
+        LOGE("Session recording '%s' is truncated or corrupt", _path.c_str());
+        m_frames.clear();
+        m_responses.clear();
+    }
+    return ok;
+}
+
+bool SessionReplay::getResponse(const std::string& _url, std::vector<char>& _data) const {
+
+    auto it = m_responses.find(_url);
+    if (it == m_responses.end()) { return false; }
+
+    _data = it->second;
+    return true;
+}
+
+}
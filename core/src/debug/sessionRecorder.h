@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace Tangram {
+
+/* Record and replay of map sessions, for reproducing performance issues
+ * from the field.
+ *
+ * A recording captures the view state of every frame together with the
+ * bytes of every network response delivered through the request
+ * registry. Replaying applies the recorded view state frame by frame
+ * and serves tile fetches from the recorded bytes instead of the
+ * network, so the same pan and zoom sequence runs against the same tile
+ * data on every machine - an apples-to-apples harness for comparing
+ * optimizations.
+ *
+ * The view state recorded per frame is the state Map::update settled
+ * on, not the raw input events; eases and inertial motion are thereby
+ * baked into the recording and replay does not depend on their timing.
+ * Fetches that bypass the registry, i.e. streamed client sources, are
+ * not captured.
+ */
+
+/* One Map::update of a recorded session */
+struct SessionFrame {
+    // Seconds passed to Map::update
+    float dt = 0.f;
+    // View state after the update
+    double longitude = 0.0;
+    double latitude = 0.0;
+    float zoom = 0.f;
+    float rotation = 0.f;
+    float tilt = 0.f;
+};
+
+class SessionRecorder {
+
+public:
+
+    static SessionRecorder& instance();
+
+    /* Begin writing a recording to _path, truncating an existing file;
+     * returns false when the file cannot be opened */
+    bool start(const std::string& _path);
+
+    void stop();
+
+    bool isRecording();
+
+    /* Called once per Map::update with the view state the frame settled
+     * on; frames are written in order */
+    void recordFrame(const SessionFrame& _frame);
+
+    /* Called for every response delivered by the request registry. A
+     * URL's bytes do not change within a session, so only its first
+     * response is stored. */
+    void recordResponse(const std::string& _url, const std::vector<char>& _data);
+
+private:
+
+    std::mutex m_mutex;
+    FILE* m_file = nullptr;
+
+    // URLs already written to the recording
+    std::unordered_set<std::string> m_seenUrls;
+};
+
+class SessionReplay {
+
+public:
+
+    /* Read a recording written by SessionRecorder; returns false when
+     * the file cannot be read or is not a recording */
+    bool load(const std::string& _path);
+
+    size_t frameCount() const { return m_frames.size(); }
+
+    const SessionFrame& frame(size_t _index) const { return m_frames[_index]; }
+
+    /* Copy the recorded response bytes for _url into _data; returns
+     * false when the recording holds no response for it */
+    bool getResponse(const std::string& _url, std::vector<char>& _data) const;
+
+private:
+
+    std::vector<SessionFrame> m_frames;
+    std::unordered_map<std::string, std::vector<char>> m_responses;
+};
+
+}
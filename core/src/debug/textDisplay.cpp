@@ -1,5 +1,6 @@
 #include "textDisplay.h"
 #include <cstdarg>
+#include <cstring>
 #include "platform.h"
 #include "gl/error.h"
 #include "gl/vertexLayout.h"
@@ -14,12 +15,24 @@ namespace Tangram {
 
 TextDisplay::TextDisplay() : m_textDisplayResolution(350.0), m_initialized(false) {
     m_vertexBuffer = new char[VERTEX_BUFFER_SIZE];
+    for (auto& line : m_infoLines) { line[0] = '\0'; }
+    for (auto& line : m_log) { line[0] = '\0'; }
 }
 
 TextDisplay::~TextDisplay() {
     delete[] m_vertexBuffer;
 }
 
+void TextDisplay::setResolution(glm::vec2 _textDisplayResolution) {
+    if (m_textDisplayResolution == _textDisplayResolution) { return; }
+    m_textDisplayResolution = _textDisplayResolution;
+
+    // Cached vertices carry screen positions
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_logDirty = true;
+    m_infoHash = 0;
+}
+
 void TextDisplay::init() {
     if (m_initialized) {
         return;
@@ -64,49 +77,67 @@ void TextDisplay::deinit() {
 
 }
 
+void TextDisplay::beginInfos() {
+    m_infoCount = 0;
+}
+
+void TextDisplay::addInfo(const char* fmt, ...) {
+    if (m_infoCount >= max_info_lines) { return; }
+
+    va_list args;
+    va_start(args, fmt);
+    vsnprintf(m_infoLines[m_infoCount], max_line_size, fmt, args);
+    va_end(args);
+
+    m_infoCount++;
+}
+
 void TextDisplay::log(const char* fmt, ...) {
-    static char text[99999];
+    char text[max_line_size];
 
     va_list args;
     va_start(args, fmt);
-    vsprintf(text, fmt, args);
+    vsnprintf(text, max_line_size, fmt, args);
     va_end(args);
 
     {
         std::lock_guard<std::mutex> lock(m_mutex);
 
-        for (int i = LOG_CAPACITY - 1; i >= 1; i--) {
-            m_log[i] = m_log[i - 1];
-        }
-
-        m_log[0] = std::string(text);
+        m_logHead = (m_logHead + 1) % LOG_CAPACITY;
+        memcpy(m_log[m_logHead], text, max_line_size);
+        m_logDirty = true;
     }
 }
 
-void TextDisplay::draw(RenderState& rs, const std::string& _text, int _posx, int _posy) {
-    static VertexLayout vertexLayout({{"a_position", 2, GL_FLOAT, false, 0}});
-    std::vector<glm::vec2> vertices;
-    int nquads;
+void TextDisplay::buildText(const char* _text, int _posx, int _posy,
+                            std::vector<glm::vec2>& _vertices) {
 
-    nquads = stb_easy_font_print(_posx, _posy, _text.c_str(), NULL, m_vertexBuffer, VERTEX_BUFFER_SIZE);
+    int nquads = stb_easy_font_print(_posx, _posy, _text, NULL,
+                                     m_vertexBuffer, VERTEX_BUFFER_SIZE);
 
     float* data = reinterpret_cast<float*>(m_vertexBuffer);
 
-    vertices.reserve(nquads * 6);
     for (int quad = 0, stride = 0; quad < nquads; ++quad, stride += 16) {
-        vertices.push_back({data[(0 * 4) + stride], data[(0 * 4) + 1 + stride]});
-        vertices.push_back({data[(1 * 4) + stride], data[(1 * 4) + 1 + stride]});
-        vertices.push_back({data[(2 * 4) + stride], data[(2 * 4) + 1 + stride]});
-        vertices.push_back({data[(2 * 4) + stride], data[(2 * 4) + 1 + stride]});
-        vertices.push_back({data[(3 * 4) + stride], data[(3 * 4) + 1 + stride]});
-        vertices.push_back({data[(0 * 4) + stride], data[(0 * 4) + 1 + stride]});
+        _vertices.push_back({data[(0 * 4) + stride], data[(0 * 4) + 1 + stride]});
+        _vertices.push_back({data[(1 * 4) + stride], data[(1 * 4) + 1 + stride]});
+        _vertices.push_back({data[(2 * 4) + stride], data[(2 * 4) + 1 + stride]});
+        _vertices.push_back({data[(2 * 4) + stride], data[(2 * 4) + 1 + stride]});
+        _vertices.push_back({data[(3 * 4) + stride], data[(3 * 4) + 1 + stride]});
+        _vertices.push_back({data[(0 * 4) + stride], data[(0 * 4) + 1 + stride]});
     }
-    vertexLayout.enable(rs, *m_shader, 0, (void*)vertices.data());
+}
+
+void TextDisplay::drawVertices(RenderState& rs, const std::vector<glm::vec2>& _vertices) {
+    static VertexLayout vertexLayout({{"a_position", 2, GL_FLOAT, false, 0}});
 
-    GL::drawArrays(GL_TRIANGLES, 0, nquads * 6);
+    if (_vertices.empty()) { return; }
+
+    vertexLayout.enable(rs, *m_shader, 0, (void*)_vertices.data());
+
+    GL::drawArrays(GL_TRIANGLES, 0, _vertices.size());
 }
 
-void TextDisplay::draw(RenderState& rs, const std::vector<std::string>& _infos) {
+void TextDisplay::draw(RenderState& rs) {
     GLint boundbuffer = -1;
 
     if (!m_shader->use(rs)) { return; }
@@ -122,26 +153,53 @@ void TextDisplay::draw(RenderState& rs, const std::vector<std::string>& _infos)
     glm::mat4 orthoProj = glm::ortho(0.f, (float)m_textDisplayResolution.x, (float)m_textDisplayResolution.y, 0.f, -1.f, 1.f);
     m_shader->setUniformMatrix4f(rs, m_uOrthoProj, orthoProj);
 
+    // Regenerate the info quads only when a line changed; with the map
+    // at rest the overlay redraws from the cached vertices.
+    size_t hash = 14695981039346656037ull;
+    for (int i = 0; i < m_infoCount; i++) {
+        for (const char* c = m_infoLines[i]; *c; c++) {
+            hash = (hash ^ size_t(*c)) * 1099511628211ull;
+        }
+        hash = (hash ^ size_t('\n')) * 1099511628211ull;
+    }
+
+    if (hash != m_infoHash) {
+        m_infoHash = hash;
+        m_infoVertices.clear();
+
+        int offset = 0;
+        for (int i = 0; i < m_infoCount; i++) {
+            buildText(m_infoLines[i], 3, 3 + offset, m_infoVertices);
+            offset += 10;
+        }
+    }
+
     // Display Tangram info messages
     m_shader->setUniformf(rs, m_uColor, 0.f, 0.f, 0.f);
-    int offset = 0;
-    for (auto& text : _infos) {
-        draw(rs, text, 3, 3 + offset);
-        offset += 10;
+    drawVertices(rs, m_infoVertices);
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (m_logDirty) {
+            m_logDirty = false;
+            m_logVertices.clear();
+
+            int offset = 0;
+            for (int i = 0; i < LOG_CAPACITY; i++) {
+                const char* line = m_log[(m_logHead - i + LOG_CAPACITY) % LOG_CAPACITY];
+                buildText(line, 3, m_textDisplayResolution.y - 10 + offset, m_logVertices);
+                offset -= 10;
+            }
+        }
     }
 
     // Display screen log
-    offset = 0;
     m_shader->setUniformf(rs, m_uColor, 51 / 255.f, 73 / 255.f, 120 / 255.f);
-    for (int i = 0; i < LOG_CAPACITY; ++i) {
-        draw(rs, m_log[i], 3, m_textDisplayResolution.y - 10 + offset);
-        offset -= 10;
-    }
+    drawVertices(rs, m_logVertices);
 
     rs.culling(GL_TRUE);
     rs.vertexBuffer(boundbuffer);
 }
 
 }
-
-
@@ -1,15 +1,13 @@
 #pragma once
 
-#include <string>
-#include <vector>
+#include <memory>
 #include <mutex>
+#include <vector>
 #include <cstdio>
 #include "gl/texture.h"
 #include "gl/mesh.h"
 #include "gl/shaderProgram.h"
 #include "glm/vec2.hpp"
-#include <sstream>
-#include <iomanip>
 
 namespace Tangram {
 
@@ -19,17 +17,17 @@ namespace Tangram {
 typedef int FontID;
 class RenderState;
 
-template <typename T>
-std::string to_string_with_precision(const T a_value, const int n = 6) {
-    std::ostringstream out;
-    out << std::fixed << std::setprecision(n) << a_value;
-    return out.str();
-}
-
+/* Renders the debug overlay text. The overlay exists to measure the
+ * engine, so it must not perturb it: info lines are formatted into
+ * preallocated line buffers and their vertices are only regenerated
+ * when the text actually changed since the last frame. */
 class TextDisplay {
 
 public:
 
+    static constexpr int max_info_lines = 64;
+    static constexpr int max_line_size = 128;
+
     static TextDisplay& Instance() {
         static TextDisplay instance;
         instance.init();
@@ -38,13 +36,20 @@ public:
 
     ~TextDisplay();
 
-    void setResolution(glm::vec2 _textDisplayResolution) { m_textDisplayResolution = _textDisplayResolution; }
+    void setResolution(glm::vec2 _textDisplayResolution);
 
     void init();
     void deinit();
 
-    /* Draw stacked messages added through log and draw _infos string list */
-    void draw(RenderState& rs, const std::vector<std::string>& _infos);
+    /* Reset the overlay info lines for this frame */
+    void beginInfos();
+
+    /* Append one printf-formatted info line, reusing the preallocated
+     * line storage; lines beyond max_info_lines are dropped */
+    void addInfo(const char* fmt, ...);
+
+    /* Draw the info lines and the stacked screen log */
+    void draw(RenderState& rs);
 
     /* Stack the log message to be displayed in the screen log */
     void log(const char* fmt, ...);
@@ -53,12 +58,33 @@ private:
 
     TextDisplay();
 
-    void draw(RenderState& rs, const std::string& _text, int _posx, int _posy);
+    /* Append the quads of one text line at (_posx, _posy) */
+    void buildText(const char* _text, int _posx, int _posy,
+                   std::vector<glm::vec2>& _vertices);
+
+    void drawVertices(RenderState& rs, const std::vector<glm::vec2>& _vertices);
 
     glm::vec2 m_textDisplayResolution;
     bool m_initialized;
     std::unique_ptr<ShaderProgram> m_shader;
-    std::string m_log[LOG_CAPACITY];
+
+    char m_infoLines[max_info_lines][max_line_size];
+    int m_infoCount = 0;
+
+    // Ring of log lines, m_logHead pointing at the most recent one
+    char m_log[LOG_CAPACITY][max_line_size];
+    int m_logHead = 0;
+    bool m_logDirty = true;
+
+    // Content hash of the vertices currently in m_infoVertices; the
+    // quads are only regenerated when a value changed
+    size_t m_infoHash = 0;
+
+    // Built text quads, kept across frames; cleared but never shrunk,
+    // so steady-state rebuilds allocate nothing
+    std::vector<glm::vec2> m_infoVertices;
+    std::vector<glm::vec2> m_logVertices;
+
     std::mutex m_mutex;
     char* m_vertexBuffer;
 
@@ -0,0 +1,92 @@
+#include "debug/tileStats.h"
+
+#include <cmath>
+
+namespace Tangram {
+
+TileStats& TileStats::instance() {
+    static TileStats instance;
+    return instance;
+}
+
+uint32_t TileStats::Histogram::total() const {
+    uint32_t sum = 0;
+    for (auto count : counts) { sum += count; }
+    return sum;
+}
+
+float TileStats::Histogram::percentile(float _fraction) const {
+
+    uint32_t sum = total();
+    if (sum == 0) { return 0.f; }
+
+    uint32_t target = uint32_t(std::ceil(_fraction * sum));
+    uint32_t cumulative = 0;
+
+    for (int i = 0; i < num_buckets; i++) {
+        cumulative += counts[i];
+        if (cumulative >= target) {
+            return float(1u << i);
+        }
+    }
+    return float(1u << (num_buckets - 1));
+}
+
+static int bucketForDuration(float _ms) {
+    int bucket = 0;
+    while (bucket < TileStats::num_buckets - 1 && _ms >= float(1u << bucket)) {
+        bucket++;
+    }
+    return bucket;
+}
+
+void TileStats::report(const TileID& _tileId, const std::string& _sourceName,
+                       float _queueWaitMs, float _parseMs, float _buildMs,
+                       const std::vector<std::pair<std::string, float>>& _styleMs) {
+
+    float thresholdMs = 0.f;
+    SlowTileCallback callback;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        m_histograms[int(Stage::queueWait)].counts[bucketForDuration(_queueWaitMs)]++;
+        m_histograms[int(Stage::parse)].counts[bucketForDuration(_parseMs)]++;
+        m_histograms[int(Stage::build)].counts[bucketForDuration(_buildMs)]++;
+
+        thresholdMs = m_slowThresholdMs;
+        callback = m_slowTileCallback;
+    }
+
+    if (!callback) { return; }
+    if (_queueWaitMs + _parseMs + _buildMs <= thresholdMs) { return; }
+
+    SlowTileReport report;
+    report.tileId = _tileId;
+    report.sourceName = _sourceName;
+    report.queueWaitMs = _queueWaitMs;
+    report.parseMs = _parseMs;
+    report.buildMs = _buildMs;
+    report.styleMs = _styleMs;
+
+    callback(report);
+}
+
+void TileStats::setSlowTileCallback(float _thresholdMs, SlowTileCallback _callback) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_slowThresholdMs = _thresholdMs;
+    m_slowTileCallback = std::move(_callback);
+}
+
+TileStats::Histogram TileStats::histogram(Stage _stage) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_histograms[int(_stage)];
+}
+
+void TileStats::clear() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (auto& histogram : m_histograms) {
+        histogram = Histogram{};
+    }
+}
+
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "tile/tileID.h"
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Tangram {
+
+/* Collects per-tile pipeline stage durations - queue wait, parse and
+ * build - into histograms, and optionally reports tiles that exceed a
+ * threshold together with their per-style build breakdown.
+ *
+ * Averages hide the tiles users actually complain about; the histogram
+ * tail shows how slow the slowest percentile is, and the slow-tile
+ * callback turns a vague region report into a list of tile IDs to
+ * reproduce with. Mesh uploads happen lazily inside the draw and are
+ * not attributed per tile; their cost shows up in the render pass
+ * timers of the debug overlay instead.
+ */
+class TileStats {
+
+public:
+
+    enum class Stage : int {
+        queueWait = 0, // Time spent waiting in the worker queues
+        parse = 1,     // Raw data decode
+        build = 2,     // Styling, label layout and mesh generation
+    };
+
+    static constexpr int num_stages = 3;
+    static constexpr int num_buckets = 16;
+
+    /* Durations in power-of-two millisecond buckets: counts[0] holds
+     * durations below 1ms, counts[i] those in [2^(i-1), 2^i) ms and the
+     * last bucket everything beyond. */
+    struct Histogram {
+        std::array<uint32_t, num_buckets> counts = {};
+
+        uint32_t total() const;
+
+        /* Upper bound in milliseconds of the bucket at which the
+         * cumulative count reaches _fraction of the total, e.g. 0.99
+         * bounds the duration of all but the slowest 1% of tiles */
+        float percentile(float _fraction) const;
+    };
+
+    struct SlowTileReport {
+        TileID tileId = {0, 0, 0};
+        std::string sourceName;
+        float queueWaitMs = 0.f;
+        float parseMs = 0.f;
+        float buildMs = 0.f;
+        // Milliseconds of the build spent per style
+        std::vector<std::pair<std::string, float>> styleMs;
+    };
+
+    /* Runs on a tile worker thread; keep it cheap and do not call back
+     * into the map from it. */
+    using SlowTileCallback = std::function<void(const SlowTileReport&)>;
+
+    static TileStats& instance();
+
+    /* Record the stage durations of one finished tile, firing the slow
+     * tile callback when their sum exceeds the threshold */
+    void report(const TileID& _tileId, const std::string& _sourceName,
+                float _queueWaitMs, float _parseMs, float _buildMs,
+                const std::vector<std::pair<std::string, float>>& _styleMs);
+
+    /* Report tiles whose summed stage durations exceed _thresholdMs;
+     * an empty callback turns reporting off */
+    void setSlowTileCallback(float _thresholdMs, SlowTileCallback _callback);
+
+    Histogram histogram(Stage _stage);
+
+    void clear();
+
+private:
+
+    std::mutex m_mutex;
+    Histogram m_histograms[num_stages];
+
+    float m_slowThresholdMs = 0.f;
+    SlowTileCallback m_slowTileCallback;
+};
+
+}
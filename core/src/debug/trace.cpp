@@ -0,0 +1,107 @@
+#include "debug/trace.h"
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Tangram {
+
+std::atomic<bool> Trace::s_enabled{false};
+
+namespace {
+
+constexpr size_t ring_size = 4096;
+
+struct Event {
+    const char* name;
+    int64_t start;
+    int64_t duration;
+};
+
+// Completed events of one thread. record() only touches members of its
+// own thread's ring, so the hot path never takes a lock; the registry
+// lock below is only held to add a ring or to dump.
+struct EventRing {
+    int tid = 0;
+    size_t head = 0;
+    bool wrapped = false;
+    Event events[ring_size];
+};
+
+std::mutex s_ringsMutex;
+std::vector<std::shared_ptr<EventRing>> s_rings;
+
+EventRing& threadRing() {
+    // The registry co-owns the ring, so events of a thread that exited
+    // before the dump still appear in it
+    static thread_local std::shared_ptr<EventRing> s_ring = [] {
+            auto ring = std::make_shared<EventRing>();
+            std::lock_guard<std::mutex> lock(s_ringsMutex);
+            ring->tid = int(s_rings.size());
+            s_rings.push_back(ring);
+            return ring;
+        }();
+    return *s_ring;
+}
+
+}
+
+int64_t Trace::timestamp() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void Trace::record(const char* _name, int64_t _start, int64_t _end) {
+
+    auto& ring = threadRing();
+
+    auto& event = ring.events[ring.head];
+    event.name = _name;
+    event.start = _start;
+    event.duration = _end - _start;
+
+    if (++ring.head == ring_size) {
+        ring.head = 0;
+        ring.wrapped = true;
+    }
+}
+
+std::string Trace::dump() {
+
+    std::string out = "{\"traceEvents\":[";
+    bool first = true;
+
+    std::lock_guard<std::mutex> lock(s_ringsMutex);
+
+    for (auto& ring : s_rings) {
+
+        size_t count = ring->wrapped ? ring_size : ring->head;
+        size_t begin = ring->wrapped ? ring->head : 0;
+
+        for (size_t i = 0; i < count; i++) {
+            auto& event = ring->events[(begin + i) % ring_size];
+
+            if (!first) { out += ","; }
+            first = false;
+
+            out += "{\"name\":\"";
+            out += event.name;
+            out += "\",\"ph\":\"X\",\"pid\":0,\"tid\":";
+            out += std::to_string(ring->tid);
+            out += ",\"ts\":";
+            out += std::to_string(event.start);
+            out += ",\"dur\":";
+            out += std::to_string(event.duration);
+            out += "}";
+        }
+
+        ring->head = 0;
+        ring->wrapped = false;
+    }
+
+    out += "]}";
+    return out;
+}
+
+}
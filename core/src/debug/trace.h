@@ -0,0 +1,84 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace Tangram {
+
+/* Scoped event tracing across the tile pipeline.
+ *
+ * FrameInfo shows per-frame averages; this answers where the time of
+ * one slow tile went across threads - fetch delivery, parse, build,
+ * label placement, render. Scopes record into a fixed ring per thread
+ * without taking a lock, so instrumentation points stay cheap enough to
+ * leave in release builds: a disabled scope is one relaxed atomic load.
+ *
+ * dump() serializes all rings as Chrome trace JSON, which loads into
+ * chrome://tracing or Perfetto. Typical use from application code:
+ *
+ *     Trace::enable(true);
+ *     ... reproduce the slow interaction ...
+ *     Trace::enable(false);
+ *     writeFile("tangram-trace.json", Trace::dump());
+ */
+class Trace {
+
+public:
+
+    /* Start or stop collecting events; off by default */
+    static void enable(bool _enabled) {
+        s_enabled.store(_enabled, std::memory_order_relaxed);
+    }
+
+    static bool isEnabled() {
+        return s_enabled.load(std::memory_order_relaxed);
+    }
+
+    /* Serialize the rings of all threads as Chrome trace JSON and clear
+     * them. A full ring overwrites its oldest events, so the dump holds
+     * the most recent ones. Disable tracing first for a consistent
+     * snapshot; events recorded during the dump may be dropped. */
+    static std::string dump();
+
+    /* Times the enclosing scope as one event; use through TRACE_SCOPE.
+     * _name must be a string literal - events store the pointer. */
+    class Scope {
+
+    public:
+
+        explicit Scope(const char* _name) {
+            if (isEnabled()) {
+                m_name = _name;
+                m_start = timestamp();
+            }
+        }
+
+        ~Scope() {
+            if (m_name) { record(m_name, m_start, timestamp()); }
+        }
+
+    private:
+
+        const char* m_name = nullptr;
+        int64_t m_start = 0;
+    };
+
+private:
+
+    /* Microseconds on the steady clock, the unit of the trace format */
+    static int64_t timestamp();
+
+    static void record(const char* _name, int64_t _start, int64_t _end);
+
+    static std::atomic<bool> s_enabled;
+};
+
+}
+
+#define TRACE_JOIN_IMPL(a, b) a##b
+#define TRACE_JOIN(a, b) TRACE_JOIN_IMPL(a, b)
+
+/* Record the enclosing scope as one trace event; _name must be a string
+ * literal */
+#define TRACE_SCOPE(_name) Tangram::Trace::Scope TRACE_JOIN(traceScope, __LINE__)(_name)
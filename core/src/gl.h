@@ -152,6 +152,14 @@ typedef char            GLchar;
 #define GL_CLAMP                        0x2900
 #define GL_REPEAT                       0x2901
 
+/* Compressed texture formats (ES 3.0 / KHR_texture_compression_astc_ldr).
+ * The ASTC block sizes form a contiguous enum range; only the endpoints
+ * are named here. */
+#define GL_COMPRESSED_RGB8_ETC2         0x9274
+#define GL_COMPRESSED_RGBA8_ETC2_EAC    0x9278
+#define GL_COMPRESSED_RGBA_ASTC_4x4_KHR 0x93B0
+#define GL_COMPRESSED_RGBA_ASTC_12x12_KHR 0x93BD
+
 /* texture_cube_map */
 #define GL_NORMAL_MAP                   0x8511
 #define GL_REFLECTION_MAP               0x8512
@@ -214,6 +222,10 @@ typedef char            GLchar;
 #define GL_INCR                         0x1E02
 #define GL_DECR                         0x1E03
 
+/* Scissor */
+#define GL_SCISSOR_BOX                  0x0C10
+#define GL_SCISSOR_TEST                 0x0C11
+
 /* Texture mapping */
 #define GL_NEAREST_MIPMAP_NEAREST       0x2700
 #define GL_NEAREST_MIPMAP_LINEAR        0x2702
@@ -258,6 +270,8 @@ typedef char            GLchar;
 #define GL_ELEMENT_ARRAY_BUFFER         0x8893
 #define GL_ARRAY_BUFFER_BINDING         0x8894
 #define GL_ELEMENT_ARRAY_BUFFER_BINDING 0x8895
+#define GL_PIXEL_PACK_BUFFER            0x88EB
+#define GL_STREAM_READ                  0x88E1
 #define GL_STATIC_DRAW                  0x88E4
 #define GL_DYNAMIC_DRAW                 0x88E8
 
@@ -268,11 +282,19 @@ typedef char            GLchar;
 #define GL_LINK_STATUS                  0x8B82
 #define GL_INFO_LOG_LENGTH              0x8B84
 
+// Program binary (OES_get_program_binary / ARB_get_program_binary)
+#define GL_PROGRAM_BINARY_LENGTH        0x8741
+
 // mapbuffer
 #define GL_READ_ONLY                    0x88B8
 #define GL_WRITE_ONLY                   0x88B9
 #define GL_READ_WRITE                   0x88BA
 
+// Timer queries (EXT_disjoint_timer_query / ARB_timer_query)
+#define GL_TIME_ELAPSED                 0x88BF
+#define GL_QUERY_RESULT                 0x8866
+#define GL_QUERY_RESULT_AVAILABLE       0x8867
+
 #define GL_MAX_TEXTURE_SIZE             0x0D33
 #define GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS 0x8B4D
 
@@ -284,6 +306,7 @@ struct GL {
     static void clear(GLbitfield mask);
     static void lineWidth(GLfloat width);
     static void viewport(GLint x, GLint y, GLsizei width, GLsizei height);
+    static void scissor(GLint x, GLint y, GLsizei width, GLsizei height);
 
     static void enable(GLenum);
     static void disable(GLenum);
@@ -318,6 +341,10 @@ struct GL {
     static GLint getAttribLocation(GLuint program, const GLchar *name);
     static void getProgramiv(GLuint program, GLenum pname, GLint *params);
     static void getShaderiv(GLuint shader, GLenum pname, GLint *params);
+    static void getProgramBinary(GLuint program, GLsizei bufSize, GLsizei *length,
+                                 GLenum *binaryFormat, void *binary);
+    static void programBinary(GLuint program, GLenum binaryFormat,
+                              const void *binary, GLsizei length);
 
     // Buffers
     static void bindBuffer(GLenum target, GLuint buffer);
@@ -369,6 +396,12 @@ struct GL {
                               GLenum format, GLenum type,
                               const GLvoid *pixels);
 
+    static void compressedTexImage2D(GLenum target, GLint level,
+                                     GLenum internalformat,
+                                     GLsizei width, GLsizei height,
+                                     GLint border, GLsizei imageSize,
+                                     const GLvoid *data);
+
     static void generateMipmap(GLenum target);
 
 
@@ -408,6 +441,16 @@ struct GL {
     static void *mapBuffer(GLenum target, GLenum access);
     static GLboolean unmapBuffer(GLenum target);
 
+    // Timer queries; no-ops where the platform's GL bindings lack the
+    // entry points, Hardware::supportsTimerQuery stays false there.
+    // Only the 32-bit result getter is exposed: at nanosecond units it
+    // wraps past ~4s, plenty for a render pass.
+    static void genQueries(GLsizei n, GLuint *ids);
+    static void deleteQueries(GLsizei n, const GLuint *ids);
+    static void beginQuery(GLenum target, GLuint id);
+    static void endQuery(GLenum target);
+    static void getQueryObjectuiv(GLuint id, GLenum pname, GLuint *params);
+
     static void finish(void);
 
     static void readPixels(GLint x, GLint y, GLsizei width, GLsizei height,
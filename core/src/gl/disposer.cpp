@@ -3,10 +3,12 @@
 
 namespace Tangram {
 
-void Disposer::operator()(std::function<void(RenderState&)> _task) {
+void Disposer::operator()(Task _task) {
     if (!m_rs) { return; }
 
-    m_rs->jobQueue.add(std::bind(_task, std::ref(*m_rs)));
+    m_rs->jobQueue.add([task = std::move(_task), rs = m_rs]() mutable {
+            task(*rs);
+        });
 }
 
 } // namespace Tangram
@@ -1,6 +1,6 @@
 #pragma once
 
-#include <functional>
+#include "util/inlineFunction.h"
 
 namespace Tangram {
 
@@ -10,11 +10,15 @@ class Disposer {
 
 public:
 
+    // Resource destructors capture a few GL handles and a generation;
+    // the inline storage covers those without a per-dispose allocation.
+    using Task = InlineFunction<void(RenderState&), 64>;
+
     Disposer() : m_rs(nullptr){}
 
     Disposer(RenderState& _rs) : m_rs(&_rs) {}
 
-    void operator()(std::function<void(RenderState&)> _task);
+    void operator()(Task _task);
 
 private:
     RenderState* m_rs = nullptr;
@@ -12,6 +12,13 @@
 
 namespace Tangram {
 
+// Quads are expanded to four vertices on the CPU each frame. An instanced
+// path (one quad instanced per feature) would cut that expansion and ~4x of
+// the vertex bandwidth, but it needs instanced-arrays entry points that the
+// ES2-level GL bindings do not expose, and the corner positions are computed
+// CPU-side in clip space - a path shared with flat sprites and text glyphs,
+// whose four corners are independent and cannot be derived from a per-
+// instance center in the shader. Revisit when a GLES3 context is available.
 template<class T>
 class DynamicQuadMesh : public StyledMesh, protected MeshBase {
 
@@ -83,9 +90,9 @@ void DynamicQuadMesh<T>::upload(RenderState& rs) {
 
     MeshBase::checkValidity(rs);
 
-    // Generate vertex buffer, if needed
+    // Acquire vertex buffer, if needed
     if (m_glVertexBuffer == 0) {
-        GL::genBuffers(1, &m_glVertexBuffer);
+        m_glVertexBuffer = rs.acquireBuffer();
     }
 
     MeshBase::subDataUpload(rs, reinterpret_cast<GLbyte*>(m_vertices.data()));
@@ -61,15 +61,60 @@ void FrameBuffer::bind(RenderState& _rs) const {
     }
 }
 
-GLuint FrameBuffer::readAt(float _normalizedX, float _normalizedY) const {
+void FrameBuffer::readRect(int _x, int _y, int _width, int _height,
+                           std::vector<GLuint>& _pixels) const {
 
-    glm::vec2 position(_normalizedX * m_width, _normalizedY * m_height);
+    _pixels.resize(size_t(_width) * _height);
 
-    GLuint pixel;
-    GL::readPixels(floorf(position.x), floorf(position.y),
-                   1, 1, GL_RGBA, GL_UNSIGNED_BYTE, &pixel);
+    GL::readPixels(_x, _y, _width, _height, GL_RGBA, GL_UNSIGNED_BYTE, _pixels.data());
+}
+
+GLuint FrameBuffer::queueReadRect(int _x, int _y, int _width, int _height) {
+
+    if (!Hardware::supportsPixelBuffer) { return 0; }
+
+    GLuint buffer = 0;
+    if (!m_readBuffersFree.empty()) {
+        buffer = m_readBuffersFree.back();
+        m_readBuffersFree.pop_back();
+    } else {
+        GL::genBuffers(1, &buffer);
+    }
+
+    GL::bindBuffer(GL_PIXEL_PACK_BUFFER, buffer);
+    GL::bufferData(GL_PIXEL_PACK_BUFFER, size_t(_width) * _height * sizeof(GLuint),
+                   nullptr, GL_STREAM_READ);
+
+    // With a pack buffer bound the read returns immediately and the
+    // transfer overlaps the following rendering.
+    GL::readPixels(_x, _y, _width, _height, GL_RGBA, GL_UNSIGNED_BYTE, 0);
+
+    GL::bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
 
-    return pixel;
+    return buffer;
+}
+
+bool FrameBuffer::completeReadRect(GLuint _buffer, size_t _pixelCount, std::vector<GLuint>& _pixels) {
+
+    GL::bindBuffer(GL_PIXEL_PACK_BUFFER, _buffer);
+
+    bool ok = false;
+    if (void* data = GL::mapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY)) {
+        _pixels.assign(static_cast<GLuint*>(data),
+                       static_cast<GLuint*>(data) + _pixelCount);
+        GL::unmapBuffer(GL_PIXEL_PACK_BUFFER);
+        ok = true;
+    } else {
+        // The driver advertises pack buffers but cannot map them for
+        // reading; disable the asynchronous path so later picks use the
+        // blocking read instead of failing every frame.
+        Hardware::supportsPixelBuffer = false;
+    }
+
+    GL::bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    m_readBuffersFree.push_back(_buffer);
+
+    return ok;
 }
 
 void FrameBuffer::init(RenderState& _rs) {
@@ -154,12 +199,17 @@ FrameBuffer::~FrameBuffer() {
 
     int generation = m_generation;
     GLuint glHandle = m_glFrameBufferHandle;
+    std::vector<GLuint> readBuffers = m_readBuffersFree;
 
     m_disposer([=](RenderState& rs) {
         if (rs.isValidGeneration(generation)) {
             rs.framebufferUnset(glHandle);
 
             GL::deleteFramebuffers(1, &glHandle);
+
+            if (!readBuffers.empty()) {
+                GL::deleteBuffers(readBuffers.size(), readBuffers.data());
+            }
         }
     });
 }
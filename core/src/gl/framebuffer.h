@@ -1,6 +1,7 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 
 #include "glm/vec4.hpp"
 #include "gl/disposer.h"
@@ -31,7 +32,17 @@ public:
 
     void bind(RenderState& _rs) const;
 
-    GLuint readAt(float _normalizedX, float _normalizedY) const;
+    /* Read back a rectangle of pixels, in framebuffer coordinates */
+    void readRect(int _x, int _y, int _width, int _height, std::vector<GLuint>& _pixels) const;
+
+    /* Queue an asynchronous read of the given pixel rectangle into a pooled pixel pack buffer
+     * and return its handle, or 0 when the driver cannot read through buffer objects; callers
+     * then fall back to the blocking readRect. */
+    GLuint queueReadRect(int _x, int _y, int _width, int _height);
+
+    /* Fetch the result of a queued read and recycle its buffer. Call at least a frame after
+     * queueReadRect, once the transfer has completed, so the map does not stall the pipeline. */
+    bool completeReadRect(GLuint _buffer, size_t _pixelCount, std::vector<GLuint>& _pixels);
 
     void drawDebug(RenderState& _rs, glm::vec2 _dim);
 
@@ -49,6 +60,9 @@ private:
 
     GLuint m_glColorRenderBufferHandle;
 
+    // Recycled pixel pack buffers for queued reads
+    std::vector<GLuint> m_readBuffersFree;
+
     int m_generation;
 
     bool m_valid;
@@ -13,9 +13,14 @@ namespace Tangram {
 namespace Hardware {
 
 bool supportsMapBuffer = false;
+bool supportsPixelBuffer = false;
 bool supportsVAOs = false;
 bool supportsTextureNPOT = false;
 bool supportsGLRGBA8OES = false;
+bool supportsProgramBinary = false;
+bool supportsTimerQuery = false;
+bool supportsTextureETC2 = false;
+bool supportsTextureASTC = false;
 
 uint32_t maxTextureSize = 0;
 uint32_t maxCombinedTextureUnits = 0;
@@ -53,14 +58,44 @@ void loadExtensions() {
     }
 
     supportsMapBuffer = isAvailable("mapbuffer");
+    // Asynchronous readback needs pack buffers that can be mapped for
+    // reading; the write-only OES mapbuffer path does not qualify, so
+    // the first failing map disables this again at runtime.
+    supportsPixelBuffer = isAvailable("pixel_buffer_object") && supportsMapBuffer;
     supportsVAOs = isAvailable("vertex_array_object");
     supportsTextureNPOT = isAvailable("texture_non_power_of_two");
     supportsGLRGBA8OES = isAvailable("rgb8_rgba8");
 
+    // Only platforms whose GL bindings expose the entry points can use
+    // program binaries, regardless of what the driver advertises.
+#if defined(PLATFORM_ANDROID) || defined(PLATFORM_LINUX) || defined(PLATFORM_TIZEN)
+    supportsProgramBinary = isAvailable("get_program_binary");
+#endif
+
+    // Same for GPU timer queries: GLES drivers advertise
+    // EXT_disjoint_timer_query, desktop GL ARB/EXT_timer_query.
+#if defined(PLATFORM_ANDROID) || defined(PLATFORM_IOS)
+    supportsTimerQuery = isAvailable("disjoint_timer_query");
+#elif defined(PLATFORM_LINUX) || defined(PLATFORM_OSX)
+    supportsTimerQuery = isAvailable("timer_query");
+#endif
+
+    // ETC2 decode is mandatory from ES 3.0 on; ES 2.0 drivers that
+    // support it advertise the compatibility extension, desktop drivers
+    // ARB_ES3_compatibility.
+    supportsTextureETC2 = isAvailable("compressed_ETC2_texture")
+                       || isAvailable("ES3_compatibility");
+    supportsTextureASTC = isAvailable("texture_compression_astc");
+
+    LOG("Driver supports timer query: %d", supportsTimerQuery);
+    LOG("Driver supports program binary: %d", supportsProgramBinary);
     LOG("Driver supports map buffer: %d", supportsMapBuffer);
+    LOG("Driver supports pixel buffer: %d", supportsPixelBuffer);
     LOG("Driver supports vaos: %d", supportsVAOs);
     LOG("Driver supports rgb8_rgba8: %d", supportsGLRGBA8OES);
     LOG("Driver supports NPOT texture: %d", supportsTextureNPOT);
+    LOG("Driver supports ETC2 textures: %d", supportsTextureETC2);
+    LOG("Driver supports ASTC textures: %d", supportsTextureASTC);
 
     // find extension symbols if needed
     initGLExtensions();
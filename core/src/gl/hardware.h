@@ -6,9 +6,14 @@ namespace Tangram {
 namespace Hardware {
 
 extern bool supportsMapBuffer;
+extern bool supportsPixelBuffer;
 extern bool supportsVAOs;
 extern bool supportsTextureNPOT;
 extern bool supportsGLRGBA8OES;
+extern bool supportsProgramBinary;
+extern bool supportsTimerQuery;
+extern bool supportsTextureETC2;
+extern bool supportsTextureASTC;
 extern uint32_t maxTextureSize;
 extern uint32_t maxCombinedTextureUnits;
 
@@ -6,8 +6,86 @@
 #include "gl/error.h"
 #include "log.h"
 
+#include <algorithm>
+#include <mutex>
+
 namespace Tangram {
 
+namespace {
+
+// Pool of recycled staging blocks for compiled mesh data. Builders
+// acquire a block on a worker thread and upload releases it on the GL
+// thread right after the data is handed to the driver. The bytes kept
+// for reuse are bounded; blocks released beyond the bound are freed so
+// an occasional oversized mesh does not pin its memory.
+struct StagingPool {
+
+    // Roughly one batch of arriving tile meshes.
+    static constexpr size_t max_pool_bytes = 16 * 1024 * 1024;
+
+    std::mutex mutex;
+    std::vector<std::pair<GLbyte*, size_t>> blocks;
+    size_t poolBytes = 0;
+
+    GLbyte* acquire(size_t _bytes, size_t& _capacity) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+
+            // Pick the smallest block that fits, keeping the larger
+            // blocks available for the larger requests.
+            int best = -1;
+            for (int i = 0; i < int(blocks.size()); i++) {
+                if (blocks[i].second < _bytes) { continue; }
+                if (best < 0 || blocks[i].second < blocks[best].second) { best = i; }
+            }
+            if (best >= 0) {
+                auto block = blocks[best];
+                blocks.erase(blocks.begin() + best);
+                poolBytes -= block.second;
+                _capacity = block.second;
+                return block.first;
+            }
+        }
+        _capacity = _bytes;
+        return new GLbyte[_bytes];
+    }
+
+    void release(GLbyte* _block, size_t _capacity) {
+        if (!_block) { return; }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (poolBytes + _capacity <= max_pool_bytes) {
+                blocks.emplace_back(_block, _capacity);
+                poolBytes += _capacity;
+                return;
+            }
+        }
+        delete[] _block;
+    }
+};
+
+StagingPool s_stagingPool;
+
+}
+
+bool MeshBase::s_retainCompiled = false;
+
+void MeshBase::retainCompiledData(bool _retain) {
+    s_retainCompiled = _retain;
+}
+
+bool MeshBase::retainsCompiledData() {
+    return s_retainCompiled;
+}
+
+GLbyte* MeshBase::acquireStaging(size_t _bytes, size_t& _capacity) {
+    return s_stagingPool.acquire(_bytes, _capacity);
+}
+
+void MeshBase::releaseStaging(GLbyte* _block, size_t _capacity) {
+    s_stagingPool.release(_block, _capacity);
+}
+
 
 MeshBase::MeshBase() {
     m_drawMode = GL_TRIANGLES;
@@ -43,30 +121,25 @@ MeshBase::~MeshBase() {
     auto glIndexBuffer = m_glIndexBuffer;
 
     m_disposer([=](RenderState& rs) mutable {
-        // Deleting a index/array buffer being used ends up setting up the current vertex/index buffer to 0
-        // after the driver finishes using it, force the render state to be 0 for vertex/index buffer
+        // Releasing a index/array buffer being used ends up setting up the current vertex/index buffer to 0
+        // after the driver finishes using it, force the render state to be 0 for vertex/index buffer.
+        // Handles go back to the RenderState pool for the next mesh instead of being deleted.
         if (rs.isValidGeneration(generation)) {
             if (glVertexBuffer) {
                 rs.vertexBufferUnset(glVertexBuffer);
-                GL::deleteBuffers(1, &glVertexBuffer);
+                rs.releaseBuffer(glVertexBuffer);
             }
             if (glIndexBuffer) {
                 rs.indexBufferUnset(glIndexBuffer);
-                GL::deleteBuffers(1, &glIndexBuffer);
+                rs.releaseBuffer(glIndexBuffer);
             }
-            vaos.dispose();
+            vaos.dispose(rs);
         }
     });
 
 
-    if (m_glVertexData) {
-        delete[] m_glVertexData;
-    }
-
-    if (m_glIndexData) {
-        delete[] m_glIndexData;
-    }
-
+    releaseStaging(m_glVertexData, m_vertexStagingCapacity);
+    releaseStaging(reinterpret_cast<GLbyte*>(m_glIndexData), m_indexStagingCapacity);
 }
 
 void MeshBase::setVertexLayout(std::shared_ptr<VertexLayout> _vertexLayout) {
@@ -103,10 +176,19 @@ void MeshBase::subDataUpload(RenderState& rs, GLbyte* _data) {
 
     rs.vertexBuffer(m_glVertexBuffer);
 
-    long vertexBytes = m_nVertices * m_vertexLayout->getStride();
+    size_t vertexBytes = m_nVertices * m_vertexLayout->getStride();
+
+    // Orphan the previous data store so the driver hands back fresh
+    // memory instead of stalling while the last frame still reads the
+    // old one. The store keeps a stable capacity across frames:
+    // re-specifying a different size each frame forces a reallocation
+    // inside the driver, while orphaning at the same size is a cheap
+    // buffer rename that streaming uploads never block on.
+    if (vertexBytes > m_bufferCapacity) {
+        m_bufferCapacity = std::max(vertexBytes, m_bufferCapacity * 2);
+    }
 
-    // invalidate/orphane the data store on the driver
-    GL::bufferData(GL_ARRAY_BUFFER, vertexBytes, NULL, m_hint);
+    GL::bufferData(GL_ARRAY_BUFFER, m_bufferCapacity, NULL, m_hint);
 
     if (Hardware::supportsMapBuffer) {
         GLvoid* dataStore = GL::mapBuffer(GL_ARRAY_BUFFER, GL_WRITE_ONLY);
@@ -117,9 +199,9 @@ void MeshBase::subDataUpload(RenderState& rs, GLbyte* _data) {
         GL::unmapBuffer(GL_ARRAY_BUFFER);
     } else {
 
-        // if this buffer is still used by gpu on current frame this call will not wait
-        // for the frame to finish using the vbo but "directly" send command to upload the data
-        GL::bufferData(GL_ARRAY_BUFFER, vertexBytes, data, m_hint);
+        // The store was just orphaned, so this write cannot synchronize
+        // with frames still reading the previous store
+        GL::bufferSubData(GL_ARRAY_BUFFER, 0, vertexBytes, data);
     }
 
     m_dirty = false;
@@ -127,9 +209,16 @@ void MeshBase::subDataUpload(RenderState& rs, GLbyte* _data) {
 
 void MeshBase::upload(RenderState& rs) {
 
-    // Generate vertex buffer, if needed
+    // Keep a copy of the compiled buffers before the staging memory is
+    // released below, so a lost context can re-upload this mesh. Dynamic
+    // meshes are refilled every frame and need no copy.
+    if (s_retainCompiled && m_hint == GL_STATIC_DRAW && m_retainedData.empty()) {
+        serializeCompiled(m_retainedData);
+    }
+
+    // Acquire vertex buffer, if needed
     if (m_glVertexBuffer == 0) {
-        GL::genBuffers(1, &m_glVertexBuffer);
+        m_glVertexBuffer = rs.acquireBuffer();
     }
 
     // Buffer vertex data
@@ -138,13 +227,14 @@ void MeshBase::upload(RenderState& rs) {
     rs.vertexBuffer(m_glVertexBuffer);
     GL::bufferData(GL_ARRAY_BUFFER, vertexBytes, m_glVertexData, m_hint);
 
-    delete[] m_glVertexData;
+    releaseStaging(m_glVertexData, m_vertexStagingCapacity);
     m_glVertexData = nullptr;
+    m_vertexStagingCapacity = 0;
 
     if (m_glIndexData) {
 
         if (m_glIndexBuffer == 0) {
-            GL::genBuffers(1, &m_glIndexBuffer);
+            m_glIndexBuffer = rs.acquireBuffer();
         }
 
         // Buffer element index data
@@ -152,8 +242,9 @@ void MeshBase::upload(RenderState& rs) {
 
         GL::bufferData(GL_ELEMENT_ARRAY_BUFFER, m_nIndices * sizeof(GLushort), m_glIndexData, m_hint);
 
-        delete[] m_glIndexData;
+        releaseStaging(reinterpret_cast<GLbyte*>(m_glIndexData), m_indexStagingCapacity);
         m_glIndexData = nullptr;
+        m_indexStagingCapacity = 0;
     }
 
     m_generation = rs.generation();
@@ -241,6 +332,15 @@ bool MeshBase::checkValidity(RenderState& rs) {
 
         m_generation = rs.generation();
 
+        // With a retained copy the staging buffers can be refilled right
+        // here, so the next draw re-uploads this mesh instead of leaving
+        // it dead until its tile is rebuilt.
+        if (!m_retainedData.empty() && m_glVertexData == nullptr) {
+            m_isCompiled = false;
+            m_vertexOffsets.clear();
+            restoreCompiled(m_retainedData.data(), m_retainedData.size());
+        }
+
         return false;
     }
 
@@ -251,6 +351,75 @@ size_t MeshBase::bufferSize() const {
     return m_nVertices * m_vertexLayout->getStride() + m_nIndices * sizeof(GLushort);
 }
 
+bool MeshBase::serializeCompiled(std::vector<char>& _out) const {
+
+    if (!m_isCompiled || m_isUploaded || !m_vertexLayout) { return false; }
+
+    auto append = [&](const void* _data, size_t _size) {
+        auto* bytes = reinterpret_cast<const char*>(_data);
+        _out.insert(_out.end(), bytes, bytes + _size);
+    };
+
+    uint32_t header[4] = { uint32_t(m_nVertices),
+                           uint32_t(m_vertexLayout->getStride()),
+                           uint32_t(m_nIndices),
+                           uint32_t(m_vertexOffsets.size()) };
+    append(header, sizeof(header));
+    append(m_vertexOffsets.data(),
+           m_vertexOffsets.size() * sizeof(std::pair<uint32_t, uint32_t>));
+    append(m_glVertexData, m_nVertices * m_vertexLayout->getStride());
+    if (m_nIndices > 0) {
+        append(m_glIndexData, m_nIndices * sizeof(GLushort));
+    }
+
+    return true;
+}
+
+bool MeshBase::restoreCompiled(const char* _data, size_t _size) {
+
+    if (m_isCompiled || !m_vertexLayout) { return false; }
+
+    uint32_t header[4];
+    if (_size < sizeof(header)) { return false; }
+    std::memcpy(header, _data, sizeof(header));
+
+    uint32_t nVertices = header[0];
+    uint32_t stride = header[1];
+    uint32_t nIndices = header[2];
+    uint32_t nOffsets = header[3];
+
+    size_t offsetBytes = nOffsets * sizeof(std::pair<uint32_t, uint32_t>);
+    size_t vertexBytes = size_t(nVertices) * stride;
+    size_t indexBytes = size_t(nIndices) * sizeof(GLushort);
+
+    if (stride != uint32_t(m_vertexLayout->getStride()) ||
+        _size != sizeof(header) + offsetBytes + vertexBytes + indexBytes) {
+        return false;
+    }
+
+    const char* pos = _data + sizeof(header);
+
+    m_vertexOffsets.resize(nOffsets);
+    std::memcpy(m_vertexOffsets.data(), pos, offsetBytes);
+    pos += offsetBytes;
+
+    m_nVertices = nVertices;
+    m_glVertexData = acquireStaging(vertexBytes, m_vertexStagingCapacity);
+    std::memcpy(m_glVertexData, pos, vertexBytes);
+    pos += vertexBytes;
+
+    m_nIndices = nIndices;
+    if (nIndices > 0) {
+        m_glIndexData = reinterpret_cast<GLushort*>(
+            acquireStaging(indexBytes, m_indexStagingCapacity));
+        std::memcpy(m_glIndexData, pos, indexBytes);
+    }
+
+    m_isCompiled = true;
+
+    return true;
+}
+
 // Add indices by collecting them into batches to draw as much as
 // possible in one draw call.  The indices must be shifted by the
 // number of vertices that are present in the current batch.
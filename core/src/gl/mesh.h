@@ -74,6 +74,29 @@ public:
 
     size_t bufferSize() const;
 
+    /*
+     * Appends the compiled vertex and index buffers plus their offsets to
+     * _out; only valid between compile and upload, when the CPU-side copy
+     * still exists. Used by the tile mesh disk cache.
+     */
+    bool serializeCompiled(std::vector<char>& _out) const;
+
+    /*
+     * Fills the mesh from buffers written by serializeCompiled() in an
+     * earlier run; fails when the data does not match the vertex layout
+     */
+    bool restoreCompiled(const char* _data, size_t _size);
+
+    /*
+     * When enabled, static meshes keep a serialized copy of their
+     * compiled buffers after upload, so a GL context loss re-uploads
+     * them from memory instead of leaving them dead until their tile is
+     * rebuilt. Costs one CPU-side copy of the uploaded geometry; only
+     * affects meshes uploaded after the call.
+     */
+    static void retainCompiledData(bool _retain);
+    static bool retainsCompiledData();
+
 protected:
 
     int m_generation; // Generation in which this mesh's GL handles were created
@@ -87,6 +110,10 @@ protected:
     size_t m_nVertices;
     GLuint m_glVertexBuffer;
 
+    // Size of the GPU-side vertex store for streaming uploads; kept
+    // stable across frames so orphaning can rename instead of reallocate
+    size_t m_bufferCapacity = 0;
+
     Vao m_vaos;
 
     // Compiled vertices for upload
@@ -111,6 +138,26 @@ protected:
 
     bool checkValidity(RenderState& rs);
 
+    // Staging memory for compiled vertex and index data, drawn from a
+    // pool shared across all meshes (see mesh.cpp): builders fill a
+    // recycled block and upload returns it right after handing the data
+    // to GL, so a batch of tiles awaiting upload cycles through a few
+    // blocks instead of holding one allocation per mesh.
+    static GLbyte* acquireStaging(size_t _bytes, size_t& _capacity);
+    static void releaseStaging(GLbyte* _block, size_t _capacity);
+
+    // Capacities of the staging blocks currently held, which may exceed
+    // the bytes in use; needed to return the blocks to the pool.
+    size_t m_vertexStagingCapacity = 0;
+    size_t m_indexStagingCapacity = 0;
+
+    // Serialized compiled buffers kept past upload when retention is
+    // enabled; checkValidity refills the staging buffers from this copy
+    // after a context loss.
+    std::vector<char> m_retainedData;
+
+    static bool s_retainCompiled;
+
     size_t compileIndices(const std::vector<std::pair<uint32_t, uint32_t>>& _offsets,
                           const std::vector<uint16_t>& _indices, size_t _offset);
 
@@ -156,6 +203,15 @@ public:
         return MeshBase::draw(rs, shader, useVao);
     }
 
+    // Overrides both StyledMesh::upload and MeshBase::upload
+    void upload(RenderState& rs) override {
+        MeshBase::upload(rs);
+    }
+
+    bool serialize(std::vector<char>& _out) const override {
+        return serializeCompiled(_out);
+    }
+
     void compile(const std::vector<MeshData<T>>& _meshes);
 
     void compile(const MeshData<T>& _mesh);
@@ -189,7 +245,7 @@ void Mesh<T>::compile(const std::vector<MeshData<T>>& _meshes) {
     }
 
     int stride = m_vertexLayout->getStride();
-    m_glVertexData = new GLbyte[m_nVertices * stride];
+    m_glVertexData = acquireStaging(m_nVertices * stride, m_vertexStagingCapacity);
 
     size_t offset = 0;
     for (auto& m : _meshes) {
@@ -204,7 +260,8 @@ void Mesh<T>::compile(const std::vector<MeshData<T>>& _meshes) {
     assert(offset == m_nVertices * stride);
 
     if (m_nIndices > 0) {
-        m_glIndexData = new GLushort[m_nIndices];
+        m_glIndexData = reinterpret_cast<GLushort*>(
+            acquireStaging(m_nIndices * sizeof(GLushort), m_indexStagingCapacity));
 
         size_t offset = 0;
         for (auto& m : _meshes) {
@@ -223,14 +280,15 @@ void Mesh<T>::compile(const MeshData<T>& _mesh) {
     m_nIndices = _mesh.indices.size();
 
     int stride = m_vertexLayout->getStride();
-    m_glVertexData = new GLbyte[m_nVertices * stride];
+    m_glVertexData = acquireStaging(m_nVertices * stride, m_vertexStagingCapacity);
 
     std::memcpy(m_glVertexData,
                 (const GLbyte*)_mesh.vertices.data(),
                 m_nVertices * stride);
 
     if (m_nIndices > 0) {
-        m_glIndexData = new GLushort[m_nIndices];
+        m_glIndexData = reinterpret_cast<GLushort*>(
+            acquireStaging(m_nIndices * sizeof(GLushort), m_indexStagingCapacity));
         compileIndices(_mesh.offsets, _mesh.indices, 0);
     }
 
@@ -300,4 +358,36 @@ void Mesh<T>::updateVertices(Range _vertexRange, const T& _newVertexValue) {
     setDirty(start, end - start);
 }
 
+/*
+ * Mesh restored from buffers written by an earlier run for the tile mesh
+ * disk cache; drawable like a compiled Mesh, but no geometry can be added
+ */
+class RestoredMesh : public StyledMesh, protected MeshBase {
+public:
+
+    RestoredMesh(std::shared_ptr<VertexLayout> _vertexLayout, GLenum _drawMode)
+        : MeshBase(_vertexLayout, _drawMode) {}
+
+    size_t bufferSize() const override {
+        return MeshBase::bufferSize();
+    }
+
+    bool draw(RenderState& rs, ShaderProgram& shader, bool useVao = true) override {
+        return MeshBase::draw(rs, shader, useVao);
+    }
+
+    // Overrides both StyledMesh::upload and MeshBase::upload
+    void upload(RenderState& rs) override {
+        MeshBase::upload(rs);
+    }
+
+    bool serialize(std::vector<char>& _out) const override {
+        return serializeCompiled(_out);
+    }
+
+    bool restore(const char* _data, size_t _size) {
+        return restoreCompiled(_data, _size);
+    }
+};
+
 }
@@ -15,6 +15,9 @@
 #include "shaders/debugTexture_vs.h"
 #include "shaders/debugTexture_fs.h"
 
+#include <cstdint>
+#include <vector>
+
 namespace Tangram {
 
 namespace Primitives {
@@ -23,9 +26,18 @@ static bool s_initialized;
 static std::unique_ptr<ShaderProgram> s_shader;
 static std::unique_ptr<VertexLayout> s_layout;
 
-static UniformLocation s_uColor{"u_color"};
 static UniformLocation s_uProj{"u_proj"};
 
+struct DebugVertex {
+    glm::vec2 position;
+    uint32_t color; // abgr
+};
+
+// Queued line segments with the color baked in per vertex; drawn all at
+// once by flush(). The buffer keeps its capacity across frames.
+static std::vector<DebugVertex> s_batch;
+static uint32_t s_color = 0xff000000;
+
 
 static std::unique_ptr<ShaderProgram> s_textureShader;
 static std::unique_ptr<VertexLayout> s_textureLayout;
@@ -43,6 +55,7 @@ void init() {
 
         s_layout = std::unique_ptr<VertexLayout>(new VertexLayout({
             {"a_position", 2, GL_FLOAT, false, 0},
+            {"a_color", 4, GL_UNSIGNED_BYTE, true, 0},
         }));
 
 
@@ -68,32 +81,16 @@ void deinit() {
     s_layout.reset(nullptr);
     s_textureShader.reset(nullptr);
     s_textureLayout.reset(nullptr);
+    s_batch.clear();
+    s_batch.shrink_to_fit();
     s_initialized = false;
 
 }
 
 void drawLine(RenderState& rs, const glm::vec2& _origin, const glm::vec2& _destination) {
 
-    init();
-
-    glm::vec2 verts[2] = {
-        glm::vec2(_origin.x, _origin.y),
-        glm::vec2(_destination.x, _destination.y)
-    };
-
-    if (!s_shader->use(rs)) { return; }
-
-    GLint boundBuffer;
-    GL::getIntegerv(GL_ARRAY_BUFFER_BINDING, &boundBuffer);
-    rs.vertexBuffer(0);
-    rs.depthTest(GL_FALSE);
-
-    // enable the layout for the line vertices
-    s_layout->enable(rs, *s_shader, 0, &verts);
-
-    GL::drawArrays(GL_LINES, 0, 2);
-
-    rs.vertexBuffer(boundBuffer);
+    s_batch.push_back({_origin, s_color});
+    s_batch.push_back({_destination, s_color});
 }
 
 void drawRect(RenderState& rs, const glm::vec2& _origin, const glm::vec2& _destination) {
@@ -104,21 +101,35 @@ void drawRect(RenderState& rs, const glm::vec2& _origin, const glm::vec2& _desti
 }
 
 void drawPoly(RenderState& rs, const glm::vec2* _polygon, size_t _n) {
+
+    // The closed outline becomes _n segments, so polys batch together
+    // with lines and rects
+    for (size_t i = 0; i < _n; i++) {
+        drawLine(rs, _polygon[i], _polygon[(i + 1) % _n]);
+    }
+}
+
+void flush(RenderState& rs) {
+
+    if (s_batch.empty()) { return; }
+
     init();
 
-    if (!s_shader->use(rs)) { return; }
+    if (!s_shader->use(rs)) { s_batch.clear(); return; }
 
     GLint boundBuffer;
     GL::getIntegerv(GL_ARRAY_BUFFER_BINDING, &boundBuffer);
     rs.vertexBuffer(0);
     rs.depthTest(GL_FALSE);
 
-    // enable the layout for the _polygon vertices
-    s_layout->enable(rs, *s_shader, 0, (void*)_polygon);
+    // enable the layout for the batched vertices
+    s_layout->enable(rs, *s_shader, 0, s_batch.data());
 
-    GL::drawArrays(GL_LINE_LOOP, 0, _n);
+    GL::drawArrays(GL_LINES, 0, s_batch.size());
 
     rs.vertexBuffer(boundBuffer);
+
+    s_batch.clear();
 }
 
 void drawTexture(RenderState& rs, Texture& _tex, glm::vec2 _pos, glm::vec2 _dim) {
@@ -159,13 +170,13 @@ void drawTexture(RenderState& rs, Texture& _tex, glm::vec2 _pos, glm::vec2 _dim)
 }
 
 void setColor(RenderState& rs, unsigned int _color) {
-    init();
 
-    float r = (_color >> 16 & 0xff) / 255.0;
-    float g = (_color >> 8  & 0xff) / 255.0;
-    float b = (_color       & 0xff) / 255.0;
+    uint32_t r = _color >> 16 & 0xff;
+    uint32_t g = _color >> 8  & 0xff;
+    uint32_t b = _color       & 0xff;
 
-    s_shader->setUniformf(rs, s_uColor, r, g, b);
+    // Baked into the queued vertices as abgr, no uniform to set
+    s_color = 0xff000000 | b << 16 | g << 8 | r;
 }
 
 void setResolution(RenderState& rs, float _width, float _height) {
@@ -18,15 +18,24 @@ void setResolution(RenderState& rs, float _width, float _height);
 /* Sets the current primitive color */
 void setColor(RenderState& rs, unsigned int _color);
 
-/* Draws a line from _origin to _destination for the screen resolution _resolution */
+/* Lines, rects and polys are batched with the current color baked into
+ * their vertices; nothing reaches the GPU until flush(). A dense debug
+ * view draws thousands of label boxes - one buffer and one draw call
+ * instead of a state setup per primitive keeps it interactive. */
+
+/* Queues a line from _origin to _destination for the screen resolution _resolution */
 void drawLine(RenderState& rs, const glm::vec2& _origin, const glm::vec2& _destination);
 
-/* Draws a rect from _origin to _destination for the screen resolution _resolution */
+/* Queues a rect from _origin to _destination for the screen resolution _resolution */
 void drawRect(RenderState& rs, const glm::vec2& _origin, const glm::vec2& _destination);
 
-/* Draws a polyon of containing _n points in screen space for the screen resolution _resolution */
+/* Queues a polyon of containing _n points in screen space for the screen resolution _resolution */
 void drawPoly(RenderState& rs, const glm::vec2* _polygon, size_t _n);
 
+/* Draws all queued primitives in a single call; each debug pass flushes
+ * what it queued before handing the frame on */
+void flush(RenderState& rs);
+
 void drawTexture(RenderState& rs, Texture& _tex, glm::vec2 _pos, glm::vec2 _dim);
 
 }
@@ -37,6 +37,8 @@ RenderState::RenderState() {
     m_framebuffer = { 0, false };
     m_viewport = { 0, 0, 0, 0, false };
 
+    m_attributePointers.fill({ 0, nullptr, 0, 0, 0, 0, false });
+
 }
 
 GLuint RenderState::getTextureUnit(GLuint _unit) {
@@ -47,6 +49,7 @@ RenderState::~RenderState() {
 
     deleteQuadIndexBuffer();
     deleteDefaultPointTexture();
+    deletePooledHandles();
 
 }
 
@@ -72,6 +75,12 @@ void RenderState::invalidate() {
     m_framebuffer.set = false;
 
     attributeBindings.fill(0);
+    m_attributePointers.fill({ 0, nullptr, 0, 0, 0, 0, false });
+
+    // Pooled handles belonged to the invalidated context; drop them
+    // without glDelete calls, the names died with the context.
+    m_bufferPool.clear();
+    m_vertexArrayPool.clear();
 
     GL::depthFunc(GL_LESS);
     GL::clearDepth(1.0);
@@ -289,10 +298,35 @@ bool RenderState::indexBuffer(GLuint handle) {
     return true;
 }
 
+void RenderState::vertexAttribPointer(GLint location, GLint size, GLenum type,
+                                      GLboolean normalized, GLsizei stride, const void* pointer) {
+
+    GLuint buffer = m_vertexBuffer.set ? m_vertexBuffer.handle : 0;
+    auto& state = m_attributePointers[location];
+
+    // Client-side arrays may be rewritten in place between draws, so only
+    // pointers into buffer objects are safe to elide.
+    if (buffer != 0 && state.set && state.buffer == buffer &&
+        state.pointer == pointer && state.size == size && state.type == type &&
+        state.normalized == normalized && state.stride == stride) {
+        return;
+    }
+
+    GL::vertexAttribPointer(location, size, type, normalized, stride, pointer);
+    state = { buffer, pointer, size, type, normalized, stride, true };
+}
+
 void RenderState::vertexBufferUnset(GLuint handle) {
     if (m_vertexBuffer.handle == handle) {
         m_vertexBuffer.set = false;
     }
+    // Attribute pointers referencing the buffer must be re-issued once the
+    // handle is deleted or recycled.
+    for (auto& state : m_attributePointers) {
+        if (state.buffer == handle) {
+            state.set = false;
+        }
+    }
 }
 
 void RenderState::indexBufferUnset(GLuint handle) {
@@ -353,6 +387,59 @@ void RenderState::generateQuadIndexBuffer() {
 
 }
 
+GLuint RenderState::acquireBuffer() {
+    if (!m_bufferPool.empty()) {
+        GLuint handle = m_bufferPool.back();
+        m_bufferPool.pop_back();
+        return handle;
+    }
+    GLuint handle = 0;
+    GL::genBuffers(1, &handle);
+    return handle;
+}
+
+void RenderState::releaseBuffer(GLuint handle) {
+    if (handle == 0) { return; }
+    if (m_bufferPool.size() < MAX_POOLED_HANDLES) {
+        m_bufferPool.push_back(handle);
+    } else {
+        GL::deleteBuffers(1, &handle);
+    }
+}
+
+GLuint RenderState::acquireVertexArray(bool& _recycled) {
+    if (!m_vertexArrayPool.empty()) {
+        GLuint handle = m_vertexArrayPool.back();
+        m_vertexArrayPool.pop_back();
+        _recycled = true;
+        return handle;
+    }
+    GLuint handle = 0;
+    GL::genVertexArrays(1, &handle);
+    _recycled = false;
+    return handle;
+}
+
+void RenderState::releaseVertexArray(GLuint handle) {
+    if (handle == 0) { return; }
+    if (m_vertexArrayPool.size() < MAX_POOLED_HANDLES) {
+        m_vertexArrayPool.push_back(handle);
+    } else {
+        GL::deleteVertexArrays(1, &handle);
+    }
+}
+
+void RenderState::deletePooledHandles() {
+    if (!m_bufferPool.empty()) {
+        GL::deleteBuffers(m_bufferPool.size(), m_bufferPool.data());
+        m_bufferPool.clear();
+    }
+    if (!m_vertexArrayPool.empty()) {
+        GL::deleteVertexArrays(m_vertexArrayPool.size(), m_vertexArrayPool.data());
+        m_vertexArrayPool.clear();
+    }
+}
+
 Texture* RenderState::getDefaultPointTexture() {
     if (m_defaultPointTexture == nullptr) {
         generateDefaultPointTexture();
@@ -369,7 +456,9 @@ void RenderState::generateDefaultPointTexture() {
     TextureOptions options = { GL_RGBA, GL_RGBA, { GL_LINEAR, GL_LINEAR }, { GL_CLAMP_TO_EDGE, GL_CLAMP_TO_EDGE } };
     std::vector<char> defaultPoint;
     defaultPoint.insert(defaultPoint.begin(), default_point_texture_data, default_point_texture_data + default_point_texture_size);
-    m_defaultPointTexture = new Texture(defaultPoint, options, true);
+    // No mipmaps: the LINEAR min filter above never samples them, and
+    // points draw at screen-space sizes anyway.
+    m_defaultPointTexture = new Texture(defaultPoint, options, false);
 }
 
 bool RenderState::framebuffer(GLuint handle) {
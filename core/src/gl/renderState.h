@@ -4,6 +4,7 @@
 #include "gl/disposer.h"
 #include "util/jobQueue.h"
 #include <array>
+#include <vector>
 
 namespace Tangram {
 
@@ -90,6 +91,12 @@ public:
 
     bool viewport(GLint x, GLint y, GLsizei width, GLsizei height);
 
+    // Issue glVertexAttribPointer only when the parameters differ from the
+    // ones last issued for this location; consecutive draws sharing a
+    // layout, buffer and offset then cost no attribute calls at all.
+    void vertexAttribPointer(GLint location, GLint size, GLenum type,
+                             GLboolean normalized, GLsizei stride, const void* pointer);
+
     void vertexBufferUnset(GLuint handle);
 
     void indexBufferUnset(GLuint handle);
@@ -106,6 +113,21 @@ public:
 
     GLuint getQuadIndexBuffer();
 
+    // Hand out a buffer object, reusing a recycled handle when one is
+    // available. The data store is respecified on the next upload, so
+    // handles need no size bucketing.
+    GLuint acquireBuffer();
+
+    // Return a buffer object for later reuse, or delete it when the pool
+    // is full. Callers unset any cached binding themselves.
+    void releaseBuffer(GLuint handle);
+
+    // Hand out a vertex array object; _recycled tells the caller whether
+    // the array still carries attribute state from a previous owner.
+    GLuint acquireVertexArray(bool& _recycled);
+
+    void releaseVertexArray(GLuint handle);
+
     Texture* getDefaultPointTexture();
 
     std::array<GLuint, MAX_ATTRIBUTES> attributeBindings = { { 0 } };
@@ -121,6 +143,14 @@ private:
     void deleteQuadIndexBuffer();
     void generateQuadIndexBuffer();
 
+    // Recycled GL object handles. Fast pans create and drop hundreds of
+    // tile meshes per second; pooling their handles keeps the matching
+    // glGen/glDelete round-trips out of the driver.
+    static constexpr size_t MAX_POOLED_HANDLES = 256;
+    std::vector<GLuint> m_bufferPool;
+    std::vector<GLuint> m_vertexArrayPool;
+    void deletePooledHandles();
+
     Texture* m_defaultPointTexture = nullptr;
     void deleteDefaultPointTexture();
     void generateDefaultPointTexture();
@@ -201,6 +231,20 @@ private:
         bool set;
     } m_viewport;
 
+    // Last vertex attribute pointer issued per location, keyed on the array
+    // buffer that was bound at the time of the call. Only tracks the default
+    // vertex array; VAOs carry their own attribute state and bypass this.
+    struct AttributePointerState {
+        GLuint buffer;
+        const void* pointer;
+        GLint size;
+        GLenum type;
+        GLboolean normalized;
+        GLsizei stride;
+        bool set;
+    };
+    std::array<AttributePointerState, MAX_ATTRIBUTES> m_attributePointers;
+
     GLint m_defaultFramebuffer = 0;
 
 };
@@ -0,0 +1,122 @@
+#include "shaderBinaryCache.h"
+
+#include "gl/hardware.h"
+#include "log.h"
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace Tangram {
+namespace ShaderBinaryCache {
+
+static std::string s_cachePath;
+
+static uint64_t fnv1a(uint64_t _hash, const char* _data, size_t _size) {
+    for (size_t i = 0; i < _size; i++) {
+        _hash = (_hash ^ uint8_t(_data[i])) * 0x100000001b3;
+    }
+    return _hash;
+}
+
+// Key the entry on the assembled sources and the driver identity, so a
+// system update that changes the binary format simply misses the cache.
+static std::string entryPath(const std::string& _fragSrc, const std::string& _vertSrc) {
+
+    uint64_t hash = 0xcbf29ce484222325;
+    hash = fnv1a(hash, _fragSrc.data(), _fragSrc.size());
+    hash = fnv1a(hash, _vertSrc.data(), _vertSrc.size());
+
+    for (GLenum name : { GL_VENDOR, GL_RENDERER, GL_VERSION }) {
+        const char* str = reinterpret_cast<const char*>(GL::getString(name));
+        if (str) { hash = fnv1a(hash, str, strlen(str)); }
+    }
+
+    char name[32];
+    snprintf(name, sizeof(name), "%016" PRIx64 ".tgsb", hash);
+
+    return s_cachePath + "/" + name;
+}
+
+void setCachePath(const std::string& _path) {
+    s_cachePath = _path;
+}
+
+GLuint loadProgram(const std::string& _fragSrc, const std::string& _vertSrc) {
+
+    if (s_cachePath.empty() || !Hardware::supportsProgramBinary) { return 0; }
+
+    auto path = entryPath(_fragSrc, _vertSrc);
+
+    FILE* file = fopen(path.c_str(), "rb");
+    if (!file) { return 0; }
+
+    GLenum format = 0;
+    std::vector<char> binary;
+
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    bool ok = size > long(sizeof(format));
+    if (ok) {
+        binary.resize(size - sizeof(format));
+        ok = fread(&format, sizeof(format), 1, file) == 1 &&
+             fread(binary.data(), binary.size(), 1, file) == 1;
+    }
+    fclose(file);
+
+    if (!ok) {
+        remove(path.c_str());
+        return 0;
+    }
+
+    GLuint program = GL::createProgram();
+    GL::programBinary(program, format, binary.data(), binary.size());
+
+    GLint isLinked = 0;
+    GL::getProgramiv(program, GL_LINK_STATUS, &isLinked);
+
+    if (isLinked == GL_FALSE) {
+        // The driver rejected the binary - most likely stale after a
+        // driver update the identity strings did not reflect.
+        GL::deleteProgram(program);
+        remove(path.c_str());
+        return 0;
+    }
+
+    return program;
+}
+
+void storeProgram(GLuint _program, const std::string& _fragSrc, const std::string& _vertSrc) {
+
+    if (s_cachePath.empty() || !Hardware::supportsProgramBinary) { return; }
+
+    GLint length = 0;
+    GL::getProgramiv(_program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) { return; }
+
+    std::vector<char> binary(length);
+    GLenum format = 0;
+    GLsizei written = 0;
+    GL::getProgramBinary(_program, length, &written, &format, binary.data());
+    if (written <= 0) { return; }
+
+    auto path = entryPath(_fragSrc, _vertSrc);
+
+    FILE* file = fopen(path.c_str(), "wb");
+    if (!file) {
+        LOGW("Could not write shader binary cache entry: %s", path.c_str());
+        return;
+    }
+
+    bool ok = fwrite(&format, sizeof(format), 1, file) == 1 &&
+              fwrite(binary.data(), written, 1, file) == 1;
+    fclose(file);
+
+    if (!ok) { remove(path.c_str()); }
+}
+
+}
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "gl.h"
+
+#include <string>
+
+namespace Tangram {
+
+/*
+ * ShaderBinaryCache - On-disk cache of linked program binaries, keyed by a
+ * hash of the assembled shader sources and the driver identity. Warm launches
+ * load the binary instead of recompiling the scene's shaders, which saves
+ * several hundred milliseconds of setup on mobile GPUs. The cache is inactive
+ * until the host application provides a writable directory with setCachePath()
+ * and the driver supports program binaries (see Hardware::supportsProgramBinary).
+ */
+namespace ShaderBinaryCache {
+
+/* Set the directory used to store program binaries; an empty string disables
+ * the cache. The directory must already exist and be writable. */
+void setCachePath(const std::string& _path);
+
+/* Try to create a program from a cached binary for these sources; returns 0
+ * when the cache is disabled, has no entry, or the driver rejects the binary
+ * (e.g. after a driver update - the stale entry is then removed). */
+GLuint loadProgram(const std::string& _fragSrc, const std::string& _vertSrc);
+
+/* Store the binary of a successfully linked program. */
+void storeProgram(GLuint _program, const std::string& _fragSrc, const std::string& _vertSrc);
+
+}
+
+}
@@ -5,6 +5,7 @@
 #include "gl/disposer.h"
 #include "gl/error.h"
 #include "gl/renderState.h"
+#include "gl/shaderBinaryCache.h"
 #include "glm/gtc/type_ptr.hpp"
 #include "log.h"
 
@@ -130,6 +131,7 @@ bool ShaderProgram::use(RenderState& rs) {
 bool ShaderProgram::build(RenderState& rs) {
 
     m_needsBuild = false;
+    m_buildNumber++;
     m_generation = rs.generation();
 
     if (m_invalidShaderSource) { return false; }
@@ -141,29 +143,40 @@ bool ShaderProgram::build(RenderState& rs) {
     auto vertSrc = applySourceBlocks(m_vertexShaderSource, false);
     auto fragSrc = applySourceBlocks(m_fragmentShaderSource, true);
 
-    // Try to compile vertex and fragment shaders, releasing resources and quiting on failure
+    // A cached program binary skips compiling and linking entirely.
 
-    GLint vertexShader = makeCompiledShader(vertSrc, GL_VERTEX_SHADER);
+    GLint vertexShader = 0;
+    GLint fragmentShader = 0;
+    GLint program = ShaderBinaryCache::loadProgram(fragSrc, vertSrc);
 
-    if (vertexShader == 0) {
-        return false;
-    }
+    if (program == 0) {
 
-    GLint fragmentShader = makeCompiledShader(fragSrc, GL_FRAGMENT_SHADER);
+        // Try to compile vertex and fragment shaders, releasing resources and quiting on failure
 
-    if (fragmentShader == 0) {
-        GL::deleteShader(vertexShader);
-        return false;
-    }
+        vertexShader = makeCompiledShader(vertSrc, GL_VERTEX_SHADER);
 
-    // Try to link shaders into a program, releasing resources and quiting on failure
+        if (vertexShader == 0) {
+            return false;
+        }
 
-    GLint program = makeLinkedShaderProgram(fragmentShader, vertexShader);
+        fragmentShader = makeCompiledShader(fragSrc, GL_FRAGMENT_SHADER);
 
-    if (program == 0) {
-        GL::deleteShader(vertexShader);
-        GL::deleteShader(fragmentShader);
-        return false;
+        if (fragmentShader == 0) {
+            GL::deleteShader(vertexShader);
+            return false;
+        }
+
+        // Try to link shaders into a program, releasing resources and quiting on failure
+
+        program = makeLinkedShaderProgram(fragmentShader, vertexShader);
+
+        if (program == 0) {
+            GL::deleteShader(vertexShader);
+            GL::deleteShader(fragmentShader);
+            return false;
+        }
+
+        ShaderBinaryCache::storeProgram(program, fragSrc, vertSrc);
     }
 
     // Delete handles for old shaders and program; values of 0 are silently ignored
@@ -176,9 +189,12 @@ bool ShaderProgram::build(RenderState& rs) {
     m_glVertexShader = vertexShader;
     m_glProgram = program;
 
-    // Clear any cached shader locations
+    // Clear any cached shader locations and uniform values; a relinked
+    // program starts over with default uniforms, so cached values no
+    // longer reflect the driver state and must not elide uploads.
 
     m_attribMap.clear();
+    m_uniformCache.clear();
     m_disposer = Disposer(rs);
 
     return true;
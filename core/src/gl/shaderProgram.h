@@ -57,6 +57,15 @@ public:
     // Return true if this object represents a valid OpenGL shader program.
     bool isValid(RenderState& rs) const { return m_glProgram != 0; };
 
+    // Whether the next use() will compile and link; lets callers warm
+    // not-yet-needed programs at a time of their choosing.
+    bool needsBuild() const { return m_needsBuild; }
+
+    // Bumped by every build; value caches layered above this program
+    // (material and light change detection) tag against it, since a
+    // relinked program starts over with default uniforms.
+    int buildNumber() const { return m_buildNumber; }
+
     // Bind the program in OpenGL if it is not already bound; If the shader sources
     // have been modified since the last time build() was called, also calls build().
     // Returns true if shader can be used (i.e. is valid).
@@ -140,6 +149,7 @@ private:
 
     bool m_needsBuild = true;
     bool m_invalidShaderSource = false;
+    int m_buildNumber = 0;
 
     Disposer m_disposer;
 
@@ -17,10 +17,52 @@
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
 
+#include <algorithm>
 #include <cstring> // for memset
 
 namespace Tangram {
 
+namespace {
+
+// KTX 1.1 container header; this is the only container accepted for
+// block-compressed payloads, it carries both ETC2 and ASTC.
+struct KtxHeader {
+    uint8_t identifier[12];
+    uint32_t endianness;
+    uint32_t glType;
+    uint32_t glTypeSize;
+    uint32_t glFormat;
+    uint32_t glInternalFormat;
+    uint32_t glBaseInternalFormat;
+    uint32_t pixelWidth;
+    uint32_t pixelHeight;
+    uint32_t pixelDepth;
+    uint32_t numberOfArrayElements;
+    uint32_t numberOfFaces;
+    uint32_t numberOfMipmapLevels;
+    uint32_t bytesOfKeyValueData;
+};
+
+const uint8_t ktxIdentifier[12] = {
+    0xAB, 'K', 'T', 'X', ' ', '1', '1', 0xBB, '\r', '\n', 0x1A, '\n'
+};
+
+bool isCompressedFormatSupported(GLenum _internalFormat) {
+    switch (_internalFormat) {
+        case GL_COMPRESSED_RGB8_ETC2:
+        case GL_COMPRESSED_RGBA8_ETC2_EAC:
+            return Hardware::supportsTextureETC2;
+        default:
+            if (_internalFormat >= GL_COMPRESSED_RGBA_ASTC_4x4_KHR &&
+                _internalFormat <= GL_COMPRESSED_RGBA_ASTC_12x12_KHR) {
+                return Hardware::supportsTextureASTC;
+            }
+            return false;
+    }
+}
+
+}
+
 Texture::Texture(unsigned int _width, unsigned int _height, TextureOptions _options, bool _generateMipmaps)
     : m_options(_options), m_generateMipmaps(_generateMipmaps) {
 
@@ -55,6 +97,14 @@ Texture::~Texture() {
 }
 
 bool Texture::loadImageFromMemory(const std::vector<char>& _data) {
+
+    // Block-compressed payloads skip the decode entirely and stay
+    // compressed on the GPU - a fraction of the memory and bandwidth of
+    // the RGBA8 path below.
+    if (loadCompressedImageFromMemory(_data)) {
+        return true;
+    }
+
     unsigned char* pixels = nullptr;
     int width, height, comp;
 
@@ -88,6 +138,84 @@ bool Texture::loadImageFromMemory(const std::vector<char>& _data) {
     return false;
 }
 
+bool Texture::loadCompressedImageFromMemory(const std::vector<char>& _data) {
+
+    if (_data.size() < sizeof(KtxHeader)) { return false; }
+
+    KtxHeader header;
+    std::memcpy(&header, _data.data(), sizeof(header));
+
+    if (std::memcmp(header.identifier, ktxIdentifier, sizeof(ktxIdentifier)) != 0) {
+        // Not a KTX payload; the caller falls through to the image decoder
+        return false;
+    }
+
+    // All targets are little-endian; byte-swapped files are not handled
+    if (header.endianness != 0x04030201) {
+        LOGW("KTX payload has foreign endianness");
+        return false;
+    }
+
+    // glType/glFormat are zero only for block-compressed data
+    if (header.glType != 0 || header.glFormat != 0) {
+        LOGW("KTX payload is not block compressed");
+        return false;
+    }
+
+    if (header.pixelDepth > 1 || header.numberOfArrayElements > 0 ||
+        header.numberOfFaces > 1) {
+        LOGW("Only 2D single-face KTX payloads are supported");
+        return false;
+    }
+
+    // There is no CPU decoder to fall back on; on hardware without the
+    // format the texture fails to load like a broken image would.
+    if (!isCompressedFormatSupported(header.glInternalFormat)) {
+        LOGW("Compressed texture format 0x%x is not supported by this hardware",
+             header.glInternalFormat);
+        return false;
+    }
+
+    size_t pos = sizeof(KtxHeader) + header.bytesOfKeyValueData;
+    uint32_t levels = std::max(1u, header.numberOfMipmapLevels);
+
+    std::vector<CompressedLevel> parsed;
+    for (uint32_t level = 0; level < levels; level++) {
+        if (pos + sizeof(uint32_t) > _data.size()) { return false; }
+
+        uint32_t imageSize;
+        std::memcpy(&imageSize, _data.data() + pos, sizeof(imageSize));
+        pos += sizeof(imageSize);
+
+        if (pos + imageSize > _data.size()) { return false; }
+
+        parsed.push_back({pos, imageSize});
+        // Mip levels are padded to 4-byte boundaries
+        pos = (pos + imageSize + 3) & ~size_t(3);
+    }
+
+    m_options.internalFormat = header.glInternalFormat;
+    m_options.format = header.glBaseInternalFormat;
+
+    // Mip levels must come pre-built in the file; glGenerateMipmap
+    // cannot write compressed levels.
+    if (m_generateMipmaps && levels == 1) {
+        LOGW("Cannot generate mipmaps for a compressed texture; falling back to LINEAR filtering");
+        m_options.filtering = {GL_LINEAR, GL_LINEAR};
+    }
+    m_generateMipmaps = false;
+
+    // Block data cannot be reordered at load time, so compressed
+    // payloads must be authored bottom-up to match the GL orientation
+    // the decoded path produces with flipImageData.
+    resize(header.pixelWidth, header.pixelHeight);
+
+    m_compressedData = _data;
+    m_compressedLevels = std::move(parsed);
+
+    return true;
+}
+
 Texture::Texture(Texture&& _other) {
     *this = std::move(_other);
 }
@@ -98,6 +226,8 @@ Texture& Texture::operator=(Texture&& _other) {
 
     m_options = _other.m_options;
     m_data = std::move(_other.m_data);
+    m_compressedData = std::move(_other.m_compressedData);
+    m_compressedLevels = std::move(_other.m_compressedLevels);
     m_dirtyRanges = std::move(_other.m_dirtyRanges);
     m_shouldResize = _other.m_shouldResize;
     m_width = _other.m_width;
@@ -105,6 +235,8 @@ Texture& Texture::operator=(Texture&& _other) {
     m_target = _other.m_target;
     m_generation = _other.m_generation;
     m_generateMipmaps = _other.m_generateMipmaps;
+    m_lazyMipmaps = _other.m_lazyMipmaps;
+    m_mipmapsPending = _other.m_mipmapsPending;
     m_disposer = std::move(_other.m_disposer);
 
     return *this;
@@ -203,6 +335,18 @@ void Texture::generate(RenderState& rs, GLuint _textureUnit) {
     m_disposer = Disposer(rs);
 }
 
+void Texture::ensureMipmaps(RenderState& rs, GLuint _textureUnit) {
+
+    if (!m_mipmapsPending || !isValid(rs)) { return; }
+
+    bind(rs, _textureUnit);
+
+    GL::generateMipmap(m_target);
+    GL::texParameteri(m_target, GL_TEXTURE_MIN_FILTER, m_options.filtering.min);
+
+    m_mipmapsPending = false;
+}
+
 void Texture::checkValidity(RenderState& rs) {
 
     if (!rs.isValidGeneration(m_generation)) {
@@ -223,7 +367,7 @@ void Texture::update(RenderState& rs, GLuint _textureUnit) {
         return;
     }
 
-    if (m_glHandle == 0) {
+    if (m_glHandle == 0 && m_compressedLevels.empty()) {
         if (m_data.size() == 0) {
             size_t divisor = sizeof(GLuint) / bytesPerPixel();
             m_data.resize((m_width * m_height) / divisor, 0);
@@ -256,13 +400,35 @@ void Texture::update(RenderState& rs, GLuint _textureUnit, const GLuint* data) {
             LOGW("The hardware maximum texture size is currently reached");
         }
 
-        GL::texImage2D(m_target, 0, m_options.internalFormat,
-                       m_width, m_height, 0, m_options.format,
-                       GL_UNSIGNED_BYTE, data);
-
-        if (data && m_generateMipmaps) {
-            // generate the mipmaps for this texture
-            GL::generateMipmap(m_target);
+        if (!m_compressedLevels.empty()) {
+            // Upload the pre-built mip chain as-is; there is no partial
+            // update path for compressed textures.
+            unsigned int w = m_width;
+            unsigned int h = m_height;
+            for (size_t level = 0; level < m_compressedLevels.size(); level++) {
+                auto& entry = m_compressedLevels[level];
+                GL::compressedTexImage2D(m_target, level, m_options.internalFormat,
+                                         w, h, 0, entry.size,
+                                         m_compressedData.data() + entry.offset);
+                w = std::max(1u, w / 2);
+                h = std::max(1u, h / 2);
+            }
+        } else {
+            GL::texImage2D(m_target, 0, m_options.internalFormat,
+                           m_width, m_height, 0, m_options.format,
+                           GL_UNSIGNED_BYTE, data);
+
+            if (data && m_generateMipmaps) {
+                if (m_lazyMipmaps) {
+                    // Put off the mip chain and sample the base level
+                    // alone until ensureMipmaps() sees a minified use.
+                    GL::texParameteri(m_target, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+                    m_mipmapsPending = true;
+                } else {
+                    // generate the mipmaps for this texture
+                    GL::generateMipmap(m_target);
+                }
+            }
         }
         m_shouldResize = false;
         m_dirtyRanges.clear();
@@ -271,6 +437,23 @@ void Texture::update(RenderState& rs, GLuint _textureUnit, const GLuint* data) {
     size_t bpp = bytesPerPixel();
     size_t divisor = sizeof(GLuint) / bpp;
 
+    // A batch of new glyphs or sprites dirties many small, scattered row
+    // spans. Merge spans separated by only a few rows before flushing:
+    // one slightly taller glTexSubImage2D call is cheaper than a driver
+    // round-trip per span.
+    const size_t maxRowGap = 8;
+    if (m_dirtyRanges.size() > 1) {
+        auto out = m_dirtyRanges.begin();
+        for (auto it = out + 1; it != m_dirtyRanges.end(); ++it) {
+            if (it->min - out->max <= maxRowGap) {
+                out->max = it->max;
+            } else {
+                *++out = *it;
+            }
+        }
+        m_dirtyRanges.erase(out + 1, m_dirtyRanges.end());
+    }
+
     for (auto& range : m_dirtyRanges) {
         size_t offset =  (range.min * m_width) / divisor;
         GL::texSubImage2D(m_target, 0, 0, range.min, m_width, range.max - range.min,
@@ -291,6 +474,7 @@ void Texture::resize(const unsigned int _width, const unsigned int _height) {
         LOGW("Falling back to LINEAR Filtering");
         m_options.filtering = {GL_LINEAR, GL_LINEAR};
         m_generateMipmaps = false;
+        m_mipmapsPending = false;
     }
 
     m_shouldResize = true;
@@ -301,6 +485,23 @@ bool Texture::isRepeatWrapping(TextureWrapping _wrapping) {
     return _wrapping.wraps == GL_REPEAT || _wrapping.wrapt == GL_REPEAT;
 }
 
+size_t Texture::gpuMemoryUsage() {
+    if (!m_compressedLevels.empty()) {
+        size_t bytes = 0;
+        for (auto& entry : m_compressedLevels) {
+            bytes += entry.size;
+        }
+        return bytes;
+    }
+
+    size_t bytes = m_width * m_height * bytesPerPixel();
+    if (m_generateMipmaps) {
+        // The mip chain adds one third on top of the base level.
+        bytes += bytes / 3;
+    }
+    return bytes;
+}
+
 size_t Texture::bytesPerPixel() {
     switch (m_options.internalFormat) {
         case GL_ALPHA:
@@ -62,8 +62,26 @@ public:
     unsigned int getWidth() const { return m_width; }
     unsigned int getHeight() const { return m_height; }
 
+    const TextureOptions& options() const { return m_options; }
+
+    /* Decoded RGBA pixels retained on the CPU; empty for compressed
+     * textures and for textures whose data has not arrived yet */
+    const std::vector<GLuint>& pixelData() const { return m_data; }
+
     void bind(RenderState& rs, GLuint _unit);
 
+    /* Defer mipmap generation until the first minified use. The texture
+     * uploads with only its base level and samples it with LINEAR
+     * minification until ensureMipmaps() runs, so textures that are
+     * never minified never pay for building the mip chain. Only
+     * meaningful for textures created with _generateMipmaps. */
+    void setLazyMipmaps(bool _lazyMipmaps) { m_lazyMipmaps = _lazyMipmaps; }
+
+    /* Build the deferred mip chain of a lazy-mipmap texture and restore
+     * its configured minification filter; no-op when the mips are
+     * already built or the texture has not been uploaded yet. */
+    void ensureMipmaps(RenderState& rs, GLuint _textureUnit);
+
     void setDirty(size_t yOffset, size_t height);
 
     GLuint getGlHandle() { return m_glHandle; }
@@ -81,6 +99,10 @@ public:
     /* Checks whether the texture has valid data and has been successfully uploaded to GPU */
     bool isValid(RenderState& rs) const;
 
+    /* Approximate GPU memory used by this texture in bytes, including
+     * generated mipmap levels */
+    size_t gpuMemoryUsage();
+
     typedef std::pair<GLuint, GLuint> TextureSlot;
 
     static void invalidateAllTextures();
@@ -89,6 +111,10 @@ public:
 
     bool loadImageFromMemory(const std::vector<char>& _data);
 
+    /* Whether this texture was loaded from a block-compressed payload;
+     * compressed textures upload as-is and have no CPU pixel data */
+    bool isCompressed() const { return !m_compressedLevels.empty(); }
+
     static void flipImageData(unsigned char *result, int w, int h, int depth);
     static void flipImageData(GLuint *result, int w, int h);
 
@@ -122,7 +148,26 @@ private:
 
     size_t bytesPerPixel();
 
+    bool loadCompressedImageFromMemory(const std::vector<char>& _data);
+
+    // Byte range of one mip level within m_compressedData
+    struct CompressedLevel {
+        size_t offset;
+        size_t size;
+    };
+
+    // Block-compressed payload (ETC2/ASTC in a KTX container), kept
+    // verbatim for upload and for re-upload after a context loss;
+    // empty for textures decoded to RGBA via m_data.
+    std::vector<char> m_compressedData;
+    std::vector<CompressedLevel> m_compressedLevels;
+
     bool m_generateMipmaps;
+
+    // Put off building the mip chain until ensureMipmaps() reports the
+    // first minified use; pending marks an upload whose chain is owed.
+    bool m_lazyMipmaps = false;
+    bool m_mipmapsPending = false;
 };
 
 }
@@ -12,8 +12,6 @@ void Vao::initialize(RenderState& rs, ShaderProgram& _program, const std::vector
 
     m_glVAOs.resize(_vertexOffsets.size());
 
-    GL::genVertexArrays(m_glVAOs.size(), m_glVAOs.data());
-
     fastmap<std::string, GLuint> locations;
 
     // FIXME (use a bindAttrib instead of getLocation) to make those locations shader independent
@@ -26,8 +24,20 @@ void Vao::initialize(RenderState& rs, ShaderProgram& _program, const std::vector
     for (size_t i = 0; i < _vertexOffsets.size(); ++i) {
         auto vertexIndexOffset = _vertexOffsets[i];
         int nVerts = vertexIndexOffset.second;
+
+        bool recycled = false;
+        m_glVAOs[i] = rs.acquireVertexArray(recycled);
         GL::bindVertexArray(m_glVAOs[i]);
 
+        if (recycled) {
+            // A recycled vertex array still records the attribute state of
+            // its previous owner; disable everything before capturing the
+            // new layout.
+            for (size_t location = 0; location < RenderState::MAX_ATTRIBUTES; location++) {
+                GL::disableVertexAttribArray(location);
+            }
+        }
+
         rs.vertexBufferUnset(_vertexBuffer);
         rs.vertexBuffer(_vertexBuffer);
 
@@ -58,11 +68,11 @@ void Vao::unbind() {
     GL::bindVertexArray(0);
 }
 
-void Vao::dispose() {
-    if (!m_glVAOs.empty()) {
-        GL::deleteVertexArrays(m_glVAOs.size(), m_glVAOs.data());
-        m_glVAOs.clear();
+void Vao::dispose(RenderState& rs) {
+    for (auto handle : m_glVAOs) {
+        rs.releaseVertexArray(handle);
     }
+    m_glVAOs.clear();
 }
 
 }
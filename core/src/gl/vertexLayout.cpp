@@ -88,7 +88,7 @@ void VertexLayout::enable(RenderState& rs, ShaderProgram& _program, size_t _byte
             }
 
             void* data = (unsigned char*)_ptr + attrib.offset + _byteOffset;
-            GL::vertexAttribPointer(location, attrib.size, attrib.type, attrib.normalized, m_stride, data);
+            rs.vertexAttribPointer(location, attrib.size, attrib.type, attrib.normalized, m_stride, data);
         }
     }
 
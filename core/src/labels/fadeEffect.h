@@ -17,19 +17,26 @@ public:
     FadeEffect() {}
 
     FadeEffect(bool _in, Interpolation _interpolation, float _duration)
-        : m_interpolation(_interpolation), m_duration(_duration), m_in(_in) {}
+        : m_interpolation(_interpolation), m_in(_in) {
+        setDuration(_duration);
+    }
 
+    // Kept cheap on purpose: after a tile arrives this runs for every
+    // label of the fade burst each frame. Single-precision math
+    // throughout - the promoted double sin()/cos() and the per-call
+    // division dominated the per-label cost here.
     float update(float _dt) {
         m_step += _dt;
-        float st = m_step / m_duration;
+        float st = m_step * m_invDuration;
 
         switch (m_interpolation) {
             case Interpolation::linear:
-                return m_in ? st : -st + 1;
+                return m_in ? st : 1.f - st;
             case Interpolation::pow:
-                return m_in ? st * st : -(st * st) + 1;
+                return m_in ? st * st : 1.f - st * st;
             case Interpolation::sine:
-                return m_in ? sin(st * M_PI * 0.5) : cos(st * M_PI * 0.5);
+                return m_in ? sinf(st * float(M_PI) * 0.5f)
+                            : cosf(st * float(M_PI) * 0.5f);
         }
 
         return st;
@@ -38,7 +45,7 @@ public:
     void reset(bool _in, Interpolation _interpolation, float _duration) {
         m_in = _in;
         m_interpolation = _interpolation;
-        m_duration = _duration;
+        setDuration(_duration);
         m_step = 0.f;
     }
 
@@ -48,8 +55,16 @@ public:
 
 private:
 
+    void setDuration(float _duration) {
+        m_duration = _duration;
+        // A zero duration yields an infinite step, finishing the fade
+        // on its first update - same as the division did
+        m_invDuration = 1.f / _duration;
+    }
+
     Interpolation m_interpolation = Interpolation::linear;
     float m_duration = 0.0f;
+    float m_invDuration = 0.0f;
     float m_step = 0.0f;
     bool m_in = false;
 };
@@ -159,6 +159,7 @@ void Label::resetState() {
     m_occludedLastFrame = false;
     m_occluded = false;
     m_anchorIndex = 0;
+    m_transformValid = false;
     enterState(State::none, 0.0);
 }
 
@@ -201,7 +202,8 @@ bool Label::setAnchorIndex(int _index) {
     return true;
 }
 
-bool Label::update(const glm::mat4& _mvp, const ViewState& _viewState, bool _drawAllLabels) {
+bool Label::update(const glm::mat4& _mvp, const ViewState& _viewState, bool _drawAllLabels,
+                   bool _transformChanged) {
 
     m_occludedLastFrame = m_occluded;
     m_occluded = false;
@@ -214,17 +216,22 @@ bool Label::update(const glm::mat4& _mvp, const ViewState& _viewState, bool _dra
         }
     }
 
-    bool ruleSatisfied = updateScreenTransform(_mvp, _viewState, _drawAllLabels);
+    if (_transformChanged || !m_transformValid) {
+        m_ruleSatisfied = updateScreenTransform(_mvp, _viewState, _drawAllLabels);
+        m_transformValid = true;
+
+        // update the view-space bouding box
+        if (m_ruleSatisfied) {
+            updateBBoxes(_viewState.fractZoom);
+        }
+    }
 
     // one of the label rules has not been satisfied
-    if (!ruleSatisfied) {
+    if (!m_ruleSatisfied) {
         enterState(State::sleep, 0.0);
         return false;
     }
 
-    // update the view-space bouding box
-    updateBBoxes(_viewState.fractZoom);
-
     // checks whether the label is out of the viewport
     if (offViewport(_viewState.viewportSize)) {
         enterState(State::out_of_screen, 0.0);
@@ -112,15 +112,24 @@ public:
 
     virtual uint32_t selectionColor() = 0;
 
+    // Update the label state for the current frame. When _transformChanged
+    // is false the screen transform and bounding boxes computed on a
+    // previous frame are reused; callers pass false only when neither the
+    // mvp nor the view state changed since then.
     bool update(const glm::mat4& _mvp,
                 const ViewState& _viewState,
-                bool _drawAllLabels = false);
+                bool _drawAllLabels = false,
+                bool _transformChanged = true);
 
     bool evalState(float _dt);
 
     // Occlude the label
     void occlude(bool _occlusion = true) { m_occluded = _occlusion; }
 
+    // Force the next update() to recompute the screen transform, e.g.
+    // after an update against a transform that is not the view's.
+    void invalidateScreenTransform() { m_transformValid = false; }
+
     // Checks whether the label is in a state where it can occlusion
     bool canOcclude();
 
@@ -202,6 +211,12 @@ protected:
 
     bool m_occluded;
 
+    // Result of the last updateScreenTransform and whether it can be
+    // reused for frames where the transform inputs did not change.
+    bool m_ruleSatisfied = false;
+
+    bool m_transformValid = false;
+
     Type m_type;
 
     OBB m_obb;
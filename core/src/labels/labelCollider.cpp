@@ -1,15 +1,69 @@
 #include "labelCollider.h"
 
 #include "labels/labelSet.h"
+#include "util/hash.h"
 #include "view/view.h" // ViewState
 
 #include "glm/gtc/matrix_transform.hpp"
 #include "glm/gtx/norm.hpp"
 
+#include <mutex>
+#include <unordered_map>
+
 #define MAX_SCALE 2
 
 namespace Tangram {
 
+namespace {
+
+// Final placement verdicts of one process() run, in the order the
+// labels were added.
+struct PlacementVerdicts {
+    int8_t styleZoom;
+    bool anyOccluded;
+    std::vector<unsigned char> occluded;
+};
+
+// Verdicts from recent runs, keyed by data tile and label-set
+// fingerprint. Over-zoomed tiles (s > z) style the same data tile again
+// at every zoom step, mostly producing the identical label set; carrying
+// the verdicts forward skips the collision pass for those builds. Shared
+// by the builders on all tile workers.
+std::mutex s_verdictMutex;
+std::unordered_map<size_t, PlacementVerdicts> s_verdictCache;
+
+constexpr size_t max_cache_entries = 512;
+
+size_t labelSetFingerprint(TileID _tileID, const std::vector<Label*>& _labels) {
+
+    size_t seed = 0;
+    hash_combine(seed, _tileID.x);
+    hash_combine(seed, _tileID.y);
+    hash_combine(seed, _tileID.z);
+    hash_combine(seed, _labels.size());
+
+    for (auto* label : _labels) {
+        hash_combine(seed, label->hash());
+        hash_combine(seed, int(label->type()));
+        hash_combine(seed, label->options().priority);
+        hash_combine(seed, label->options().repeatGroup);
+
+        auto& transform = label->worldTransform();
+        if (label->type() == Label::Type::line) {
+            hash_combine(seed, transform.positions[0].x);
+            hash_combine(seed, transform.positions[0].y);
+            hash_combine(seed, transform.positions[1].x);
+            hash_combine(seed, transform.positions[1].y);
+        } else {
+            hash_combine(seed, transform.position.x);
+            hash_combine(seed, transform.position.y);
+        }
+    }
+    return seed;
+}
+
+}
+
 
 void LabelCollider::addLabels(std::vector<std::unique_ptr<Label>>& _labels) {
 
@@ -53,6 +107,40 @@ void LabelCollider::handleRepeatGroup(size_t startPos) {
 
 void LabelCollider::process(TileID _tileID, float _tileInverseScale, float _tileSize) {
 
+    if (m_labels.empty()) { return; }
+
+    // Check whether the placement of this label set was already resolved,
+    // either for this exact tile or for its over-zoom parent. The build
+    // verdicts only pre-filter the frame-time collision in Labels, so an
+    // all-visible parent result safely carries down: the same pixel-sized
+    // boxes spread further apart when the tile is scaled up one zoom.
+    size_t fingerprint = labelSetFingerprint(_tileID, m_labels);
+    {
+        std::lock_guard<std::mutex> lock(s_verdictMutex);
+        auto it = s_verdictCache.find(fingerprint);
+        if (it != s_verdictCache.end() &&
+            it->second.occluded.size() == m_labels.size() &&
+            (it->second.styleZoom == _tileID.s ||
+             (it->second.styleZoom < _tileID.s && !it->second.anyOccluded))) {
+
+            for (size_t i = 0; i < m_labels.size(); i++) {
+                Label* label = m_labels[i];
+                if (it->second.occluded[i]) {
+                    label->occlude();
+                    label->enterState(Label::State::dead, 0.0f);
+                } else {
+                    label->enterState(Label::State::none, 0.0f);
+                }
+                label->invalidateScreenTransform();
+            }
+            m_labels.clear();
+            return;
+        }
+    }
+
+    // Keep the insertion order; the verdicts are stored against it.
+    std::vector<Label*> ordered = m_labels;
+
     // Sort labels so that all labels of one repeat group are next to each other
     std::sort(m_labels.begin(), m_labels.end(),
               [](auto* l1, auto* l2) {
@@ -104,7 +192,14 @@ void LabelCollider::process(TileID _tileID, float _tileInverseScale, float _tile
         m_aabbs.push_back(label->aabb());
     }
 
-    m_isect2d.resize({screenSize.x / 128, screenSize.y / 128}, screenSize);
+    if (screenSize != m_gridSize) {
+        m_isect2d.resize({screenSize.x / 128, screenSize.y / 128}, screenSize);
+        m_gridSize = screenSize;
+    } else {
+        // Same grid geometry as the last build: keep the warm cell
+        // allocations and just drop their contents
+        m_isect2d.clear();
+    }
 
     m_isect2d.intersect(m_aabbs);
 
@@ -155,11 +250,26 @@ void LabelCollider::process(TileID _tileID, float _tileInverseScale, float _tile
     //    when reaching a collision pair with lower priority
     // This allows to remove repeated labels before they occlude other candidates
 
+    // Resolve the pure geometry up front: copy the OBBs into one
+    // contiguous array and test every collision pair in a single tight
+    // pass. The SAT tests are independent of the occlusion state evolving
+    // below, and the flat, branch-light loop is the narrowphase hot spot
+    // once the pair count grows into the thousands in dense POI areas.
+    for (auto* label : m_labels) {
+        m_obbs.push_back(label->obb());
+    }
+
+    m_overlaps.reserve(m_isect2d.pairs.size());
+    for (auto& pair : m_isect2d.pairs) {
+        m_overlaps.push_back(intersect(m_obbs[pair.first], m_obbs[pair.second]));
+    }
+
     size_t repeatGroup = 0;
 
     // Narrow Phase, resolve conflicts
-    for (auto& pair : m_isect2d.pairs) {
+    for (size_t i = 0; i < m_isect2d.pairs.size(); i++) {
 
+        auto& pair = m_isect2d.pairs[i];
         auto* l1 = m_labels[pair.first];
         auto* l2 = m_labels[pair.second];
 
@@ -189,7 +299,7 @@ void LabelCollider::process(TileID _tileID, float _tileInverseScale, float _tile
             continue;
         }
 
-        if (!intersect(l1->obb(), l2->obb())) {
+        if (!m_overlaps[i]) {
             continue;
         }
 
@@ -228,10 +338,34 @@ void LabelCollider::process(TileID _tileID, float _tileInverseScale, float _tile
         } else {
             label->enterState(Label::State::none, 0.0f);
         }
+
+        // The update() above ran against the tile-local projection, not
+        // the view; never reuse its transform on the frame path.
+        label->invalidateScreenTransform();
+    }
+
+    PlacementVerdicts verdicts;
+    verdicts.styleZoom = _tileID.s;
+    verdicts.anyOccluded = false;
+    verdicts.occluded.reserve(ordered.size());
+
+    for (auto* label : ordered) {
+        verdicts.occluded.push_back(label->isOccluded());
+        if (label->isOccluded()) { verdicts.anyOccluded = true; }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(s_verdictMutex);
+        while (s_verdictCache.size() >= max_cache_entries) {
+            s_verdictCache.erase(s_verdictCache.begin());
+        }
+        s_verdictCache[fingerprint] = std::move(verdicts);
     }
 
     m_labels.clear();
     m_aabbs.clear();
+    m_obbs.clear();
+    m_overlaps.clear();
 }
 
 }
@@ -19,6 +19,11 @@ public:
 
     void addLabels(std::vector<std::unique_ptr<Label>>& _labels);
 
+    // Resolves build-time collisions between the added labels, leaving
+    // each one either alive or dead. Verdicts are cached per data tile
+    // and label-set fingerprint, so over-zoomed builds that style the
+    // identical label set again carry the parent placement forward
+    // instead of repeating the pairwise pass.
     void process(TileID _tileID, float _tileInverseScale, float _tileSize);
 
 private:
@@ -33,8 +38,20 @@ private:
     std::vector<Label*> m_labels;
     std::vector<AABB> m_aabbs;
 
+    // Scratch buffers for the narrowphase: OBBs copied into one contiguous
+    // array and the per-pair overlap results resolved in a single pass over
+    // that array, so the conflict loop reads geometry sequentially instead
+    // of chasing Label pointers per pair.
+    std::vector<OBB> m_obbs;
+    std::vector<unsigned char> m_overlaps;
+
     isect2d::ISect2D<glm::vec2> m_isect2d;
 
+    // Screen size the broadphase grid is currently sized for; process()
+    // only resizes on change, so consecutive builds at the same overzoom
+    // reuse the warm cell allocations
+    glm::vec2 m_gridSize = { 0.f, 0.f };
+
 };
 
 }
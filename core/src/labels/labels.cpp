@@ -1,6 +1,7 @@
 #include "labels.h"
 
 #include "tangram.h"
+#include "debug/trace.h"
 #include "platform.h"
 #include "gl/shaderProgram.h"
 #include "gl/primitives.h"
@@ -13,12 +14,16 @@
 #include "labels/labelSet.h"
 #include "labels/textLabel.h"
 #include "marker/marker.h"
+#include "util/geom.h"
 
 #include "glm/glm.hpp"
 #include "glm/gtc/matrix_transform.hpp"
 #include "glm/gtx/rotate_vector.hpp"
 #include "glm/gtx/norm.hpp"
 
+#include <algorithm>
+#include <limits>
+
 namespace Tangram {
 
 Labels::Labels()
@@ -35,14 +40,18 @@ void Labels::processLabelUpdate(const ViewState& viewState,
                                 StyledMesh* mesh, Tile* tile,
                                 const glm::mat4& mvp,
                                 float dt, bool drawAll,
-                                bool onlyTransitions, bool isProxy) {
+                                bool onlyTransitions, bool isProxy,
+                                bool transformChanged) {
 
     if (!mesh) { return; }
     auto labelMesh = dynamic_cast<const LabelSet*>(mesh);
     if (!labelMesh) { return; }
 
     for (auto& label : labelMesh->getLabels()) {
-        if (!label->update(mvp, viewState, drawAll)) {
+        // Dropped by the density pre-cull; not a candidate this update.
+        if (!m_preCulled.empty() && m_preCulled.count(label.get()) > 0) { continue; }
+
+        if (!label->update(mvp, viewState, drawAll, transformChanged)) {
             // skip dead labels
             continue;
         }
@@ -80,14 +89,59 @@ std::pair<Label*, Tile*> Labels::getLabel(uint32_t _selectionColor) const {
     return {nullptr, nullptr};
 }
 
+uint32_t Labels::getLabelColorAt(glm::vec2 _screenPosition) const {
+
+    uint32_t color = 0;
+    float distance2 = std::numeric_limits<float>::max();
+
+    for (auto& entry : m_selectionLabels) {
+        auto* label = entry.label;
+
+        if (!label->visibleState()) { continue; }
+
+        // The point is inside the oriented bounding box when it lies on
+        // the same side of all four edges
+        auto& quad = label->obb().getQuad();
+
+        bool inside = true;
+        bool positive = false;
+        for (int i = 0; i < 4 && inside; i++) {
+            glm::vec2 a = quad[i];
+            glm::vec2 b = quad[(i + 1) % 4];
+            float side = (b.x - a.x) * (_screenPosition.y - a.y) -
+                         (b.y - a.y) * (_screenPosition.x - a.x);
+            if (i == 0) {
+                positive = side > 0.f;
+            } else if ((side > 0.f) != positive) {
+                inside = false;
+            }
+        }
+        if (!inside) { continue; }
+
+        float d2 = label->screenDistance2(_screenPosition);
+        if (d2 < distance2) {
+            distance2 = d2;
+            color = label->selectionColor();
+        }
+    }
+
+    return color;
+}
+
 
 void Labels::updateLabels(const ViewState& _viewState, float _dt,
                           const std::vector<std::unique_ptr<Style>>& _styles,
-                          const std::vector<std::shared_ptr<Tile>>& _tiles,
+                          const std::vector<Tile*>& _tiles,
                           const std::vector<std::unique_ptr<Marker>>& _markers,
                           bool _onlyTransitions) {
 
-    if (!_onlyTransitions) { m_labels.clear(); }
+    TRACE_SCOPE("labels:update");
+
+    if (!_onlyTransitions) {
+        m_labels.clear();
+
+        preCullLabels(_viewState, _styles, _tiles);
+    }
 
     m_selectionLabels.clear();
 
@@ -108,10 +162,13 @@ void Labels::updateLabels(const ViewState& _viewState, float _dt,
 
         glm::mat4 mvp = tile->mvp();
 
+        // Tile mvps only move with the view; on idle frames the labels can
+        // reuse the screen transforms computed on a previous frame.
         for (const auto& style : _styles) {
             const auto& mesh = tile->getMesh(*style);
-            processLabelUpdate(_viewState, mesh.get(), tile.get(), mvp,
-                               _dt, drawAllLabels, _onlyTransitions, proxyTile);
+            processLabelUpdate(_viewState, mesh.get(), tile, mvp,
+                               _dt, drawAllLabels, _onlyTransitions, proxyTile,
+                               _viewState.changedOnLastUpdate);
         }
     }
 
@@ -122,14 +179,97 @@ void Labels::updateLabels(const ViewState& _viewState, float _dt,
 
             const auto& mesh = marker->mesh();
 
+            // Easing markers move their own mvp even when the view is idle.
             processLabelUpdate(_viewState, mesh, nullptr,
                                marker->modelViewProjectionMatrix(),
-                               _dt, drawAllLabels, _onlyTransitions, false);
+                               _dt, drawAllLabels, _onlyTransitions, false,
+                               _viewState.changedOnLastUpdate || marker->isEasing());
         }
     }
 }
 
-void Labels::skipTransitions(const std::vector<const Style*>& _styles, Tile& _tile, Tile& _proxy) const {
+void Labels::preCullLabels(const ViewState& _viewState,
+                           const std::vector<std::unique_ptr<Style>>& _styles,
+                           const std::vector<Tile*>& _tiles) {
+
+    TRACE_SCOPE("labels:precull");
+
+    m_preCulled.clear();
+    m_preCullScratch.clear();
+
+    glm::vec2 screenSize = _viewState.viewportSize;
+    const float cellSize = 256.f;
+    uint32_t cols = uint32_t(std::max(1.f, std::ceil(screenSize.x / cellSize)));
+    uint32_t rows = uint32_t(std::max(1.f, std::ceil(screenSize.y / cellSize)));
+
+    for (const auto& tile : _tiles) {
+
+        glm::mat4 mvp = tile->mvp();
+
+        for (const auto& style : _styles) {
+            auto* mesh = dynamic_cast<const LabelSet*>(tile->getMesh(*style).get());
+            if (!mesh) { continue; }
+
+            for (auto& label : mesh->getLabels()) {
+                // Only never-placed labels compete for a cell slot; labels
+                // that placed before keep full processing, so the cap
+                // cannot touch their fades or current placements.
+                if (!label->canOcclude()) { continue; }
+                if (label->state() != Label::State::none) { continue; }
+
+                glm::vec2 wp;
+                if (label->type() == Label::Type::line) {
+                    const auto& t = label->worldTransform();
+                    wp = 0.5f * (t.positions[0] + t.positions[1]);
+                } else {
+                    wp = glm::vec2(label->worldTransform().position);
+                }
+
+                bool clipped = false;
+                glm::vec2 sp = worldToScreenSpace(mvp, glm::vec4(wp, 0.f, 1.f),
+                                                  screenSize, clipped);
+                // Behind the camera; leave it to the full update.
+                if (clipped) { continue; }
+
+                // Clamp into the grid so offscreen candidates compete in
+                // the edge cells instead of escaping the cap.
+                int cx = glm::clamp(int(sp.x / cellSize), 0, int(cols) - 1);
+                int cy = glm::clamp(int(sp.y / cellSize), 0, int(rows) - 1);
+
+                m_preCullScratch.push_back({label.get(), label->options().priority,
+                                            uint32_t(cy) * cols + uint32_t(cx)});
+            }
+        }
+    }
+
+    // Not enough candidates to exceed the cap anywhere.
+    if (m_preCullScratch.size() <= size_t(MAX_CANDIDATES_PER_CELL)) { return; }
+
+    // Group by cell with the best priorities first. A plain sort on three
+    // scalars is far cheaper than running the full label comparator over
+    // candidates that are dropped right after.
+    std::sort(m_preCullScratch.begin(), m_preCullScratch.end(),
+              [](const PreCullEntry& _a, const PreCullEntry& _b) {
+                  if (_a.cell != _b.cell) { return _a.cell < _b.cell; }
+                  if (_a.priority != _b.priority) { return _a.priority < _b.priority; }
+                  return _a.label < _b.label;
+              });
+
+    uint32_t cell = m_preCullScratch[0].cell;
+    int count = 0;
+
+    for (const auto& entry : m_preCullScratch) {
+        if (entry.cell != cell) {
+            cell = entry.cell;
+            count = 0;
+        }
+        if (++count > MAX_CANDIDATES_PER_CELL) {
+            m_preCulled.insert(entry.label);
+        }
+    }
+}
+
+void Labels::skipTransitions(const ArenaVector<const Style*>& _styles, Tile& _tile, Tile& _proxy) const {
 
     for (const auto& style : _styles) {
 
@@ -162,12 +302,14 @@ void Labels::skipTransitions(const std::vector<const Style*>& _styles, Tile& _ti
     }
 }
 
-std::shared_ptr<Tile> findProxy(int32_t _sourceID, const TileID& _proxyID,
-                                const std::vector<std::shared_ptr<Tile>>& _tiles,
-                                TileCache& _cache) {
+Tile* findProxy(int32_t _sourceID, const TileID& _proxyID,
+                const std::vector<Tile*>& _tiles,
+                TileCache& _cache) {
 
+    // The cache keeps its reference, so the raw pointer stays valid for
+    // the duration of the update
     auto proxy = _cache.contains(_sourceID, _proxyID);
-    if (proxy) { return proxy; }
+    if (proxy) { return proxy.get(); }
 
     for (auto& tile : _tiles) {
         if (tile->getID() == _proxyID && tile->sourceID() == _sourceID) {
@@ -178,10 +320,11 @@ std::shared_ptr<Tile> findProxy(int32_t _sourceID, const TileID& _proxyID,
 }
 
 void Labels::skipTransitions(const std::vector<std::unique_ptr<Style>>& _styles,
-                             const std::vector<std::shared_ptr<Tile>>& _tiles,
+                             const std::vector<Tile*>& _tiles,
                              TileCache& _cache, float _currentZoom) const {
 
-    std::vector<const Style*> styles;
+    // Lives for this update only, so it can draw from the frame arena
+    ArenaVector<const Style*> styles;
 
     for (const auto& style : _styles) {
         if (dynamic_cast<const TextStyle*>(style.get()) ||
@@ -192,7 +335,7 @@ void Labels::skipTransitions(const std::vector<std::unique_ptr<Style>>& _styles,
 
     for (const auto& tile : _tiles) {
         TileID tileID = tile->getID();
-        std::shared_ptr<Tile> proxy;
+        Tile* proxy = nullptr;
 
         if (m_lastZoom < _currentZoom) {
             // zooming in, add the one cached parent tile
@@ -269,6 +412,9 @@ void Labels::handleOcclusions(const ViewState& _viewState) {
     m_isect2d.clear();
     m_repeatGroups.clear();
 
+    int placementBudget = MAX_NEW_LABEL_PLACEMENTS_PER_FRAME;
+    m_deferredScratch.clear();
+
     for (auto& entry : m_labels){
         auto* l = entry.label;
 
@@ -281,6 +427,18 @@ void Labels::handleOcclusions(const ViewState& _viewState) {
             }
         }
 
+        // Amortize placement of newly arrived labels over several frames:
+        // m_labels is sorted by priority, so the budget goes to the most
+        // important labels first and the rest fade in on later frames.
+        if (l->state() == Label::State::none || m_deferredLabels.count(l) > 0) {
+            if (placementBudget == 0) {
+                l->occlude();
+                m_deferredScratch.insert(l);
+                continue;
+            }
+            placementBudget--;
+        }
+
         // Skip label if another label of this repeatGroup is
         // within repeatDistance.
         if (l->options().repeatDistance > 0.f) {
@@ -340,32 +498,111 @@ void Labels::handleOcclusions(const ViewState& _viewState) {
         }
 
         if (l->options().repeatDistance > 0.f) {
-            m_repeatGroups[l->options().repeatGroup].push_back(l);
+            addToRepeatGroup(l);
+        }
+    }
+
+    std::swap(m_deferredLabels, m_deferredScratch);
+}
+
+bool Labels::occlusionsNeedUpdate(const ViewState& _viewState) const {
+
+    // Deferred labels still await their first placement.
+    if (!m_deferredLabels.empty()) { return true; }
+
+    if (m_labels.size() != m_occlusionSnapshot.size()) { return true; }
+    if (m_occlusionViewport != _viewState.viewportSize) { return true; }
+
+    // Deviation in pixels from a uniform translation of the whole layout
+    // above which placements from the last pass can no longer be trusted.
+    const float threshold2 = 1.f;
+
+    glm::vec2 offset;
+
+    for (size_t i = 0; i < m_labels.size(); i++) {
+        Label* l = m_labels[i].label;
+        const auto& snapshot = m_occlusionSnapshot[i];
+
+        // The set or ordering of labels changed.
+        if (l != snapshot.label) { return true; }
+
+        // Labels entering or leaving the viewport need a new decision.
+        if (l->offViewport(_viewState.viewportSize) != snapshot.offViewport) {
+            return true;
+        }
+
+        glm::vec2 delta = l->center() - snapshot.screenCenter;
+        if (i == 0) {
+            offset = delta;
+        } else if (glm::length2(delta - offset) > threshold2) {
+            // Zooms, rotations and pitches move labels non-uniformly and
+            // land here with the very first label pair.
+            return true;
         }
     }
+
+    return false;
+}
+
+static uint64_t repeatCellKey(int _x, int _y) {
+    return (uint64_t(uint32_t(_x)) << 32) | uint32_t(_y);
 }
 
 bool Labels::withinRepeatDistance(Label *_label) {
-    float threshold2 = pow(_label->options().repeatDistance, 2);
 
     auto it = m_repeatGroups.find(_label->options().repeatGroup);
-    if (it != m_repeatGroups.end()) {
-        for (auto* ll : it->second) {
-            float d2 = glm::distance2(_label->center(), ll->center());
-            if (d2 < threshold2) {
-                return true;
+    if (it == m_repeatGroups.end()) { return false; }
+
+    const auto& group = it->second;
+
+    float threshold = _label->options().repeatDistance;
+    float threshold2 = threshold * threshold;
+    glm::vec2 center = _label->center();
+
+    // Probe every cell the repeat distance can reach; with uniform repeat
+    // distances within a group this is the 3x3 neighborhood.
+    int radius = int(std::ceil(threshold / group.cellSize));
+    int cx = int(std::floor(center.x / group.cellSize));
+    int cy = int(std::floor(center.y / group.cellSize));
+
+    for (int y = cy - radius; y <= cy + radius; y++) {
+        for (int x = cx - radius; x <= cx + radius; x++) {
+            auto cell = group.cells.find(repeatCellKey(x, y));
+            if (cell == group.cells.end()) { continue; }
+
+            for (auto* ll : cell->second) {
+                float d2 = glm::distance2(center, ll->center());
+                if (d2 < threshold2) {
+                    return true;
+                }
             }
         }
     }
     return false;
 }
 
+void Labels::addToRepeatGroup(Label* _label) {
+
+    auto& group = m_repeatGroups[_label->options().repeatGroup];
+    if (group.cells.empty()) {
+        group.cellSize = std::max(_label->options().repeatDistance, 1.f);
+    }
+
+    glm::vec2 center = _label->center();
+    int cx = int(std::floor(center.x / group.cellSize));
+    int cy = int(std::floor(center.y / group.cellSize));
+
+    group.cells[repeatCellKey(cx, cy)].push_back(_label);
+}
+
 void Labels::updateLabelSet(const ViewState& _viewState, float _dt,
                             const std::vector<std::unique_ptr<Style>>& _styles,
-                            const std::vector<std::shared_ptr<Tile>>& _tiles,
+                            const std::vector<Tile*>& _tiles,
                             const std::vector<std::unique_ptr<Marker>>& _markers,
                             TileCache& _cache) {
 
+    TRACE_SCOPE("labels:place");
+
     /// Collect and update labels from visible tiles
     updateLabels(_viewState, _dt, _styles, _tiles, _markers, false);
 
@@ -378,10 +615,34 @@ void Labels::updateLabelSet(const ViewState& _viewState, float _dt,
         m_lastZoom = _viewState.zoom;
     }
 
-    m_isect2d.resize({_viewState.viewportSize.x / 256, _viewState.viewportSize.y / 256},
-                     {_viewState.viewportSize.x, _viewState.viewportSize.y});
+    if (occlusionsNeedUpdate(_viewState)) {
+
+        // Size the broadphase grid for the bounding square of the
+        // viewport and only ever grow it: a rotation swaps width and
+        // height, and rebuilding the grid would pair an allocation storm
+        // with the re-layout it already triggers. Cells stay 256px; the
+        // extra cells beyond the short side simply remain empty.
+        float side = std::max(_viewState.viewportSize.x, _viewState.viewportSize.y);
+        if (side > m_isectGridSide) {
+            m_isect2d.resize({side / 256, side / 256}, {side, side});
+            m_isectGridSide = side;
+        }
+
+        handleOcclusions(_viewState);
 
-    handleOcclusions(_viewState);
+        m_occlusionViewport = _viewState.viewportSize;
+        m_occlusionSnapshot.clear();
+        for (auto& entry : m_labels) {
+            m_occlusionSnapshot.push_back({ entry.label, entry.label->center(),
+                                            entry.label->offViewport(_viewState.viewportSize) });
+        }
+    } else {
+        // The layout only translated uniformly since the last pass, so
+        // reapply the placements decided then.
+        for (auto& entry : m_labels) {
+            if (entry.label->occludedLastFrame()) { entry.label->occlude(); }
+        }
+    }
 
     /// Update label meshes
 
@@ -391,6 +652,9 @@ void Labels::updateLabelSet(const ViewState& _viewState, float _dt,
         m_needUpdate |= label->evalState(_dt);
         label->addVerticesToMesh();
     }
+
+    // Keep updating until deferred labels have had their placement pass.
+    m_needUpdate |= hasPendingPlacements();
 }
 
 void Labels::drawDebug(RenderState& rs, const View& _view) {
@@ -503,6 +767,8 @@ void Labels::drawDebug(RenderState& rs, const View& _view) {
             }
         }
     }
+
+    Primitives::flush(rs);
 }
 
 }
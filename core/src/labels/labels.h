@@ -4,6 +4,7 @@
 #include "spriteLabel.h"
 #include "tile/tileID.h"
 #include "data/properties.h"
+#include "util/memoryArena.h"
 #include "isect2d.h"
 #include "glm_vec.h" // for isect2d.h
 
@@ -12,6 +13,7 @@
 #include <vector>
 #include <map>
 #include <unordered_map>
+#include <unordered_set>
 #include <set>
 
 #define PERF_TRACE __attribute__ ((noinline))
@@ -35,20 +37,42 @@ public:
 
     void updateLabelSet(const ViewState& _viewState, float _dt,
                         const std::vector<std::unique_ptr<Style>>& _styles,
-                        const std::vector<std::shared_ptr<Tile>>& _tiles,
+                        const std::vector<Tile*>& _tiles,
                         const std::vector<std::unique_ptr<Marker>>& _markers,
                         TileCache& _cache);
 
     PERF_TRACE void updateLabels(const ViewState& _viewState, float _dt,
                                  const std::vector<std::unique_ptr<Style>>& _styles,
-                                 const std::vector<std::shared_ptr<Tile>>& _tiles,
+                                 const std::vector<Tile*>& _tiles,
                                  const std::vector<std::unique_ptr<Marker>>& _markers,
                                  bool _onlyTransitions = true);
 
     bool needUpdate() const { return m_needUpdate; }
 
+    // Whether newly arrived labels were deferred past the per-frame
+    // placement budget and still await their first occlusion pass.
+    bool hasPendingPlacements() const { return !m_deferredLabels.empty(); }
+
+    // Maximum number of newly arrived labels to place per frame. Placement
+    // of labels beyond this budget is deferred to the following frames,
+    // highest priority first, trading a staggered fade-in for bounded
+    // per-frame occlusion cost when a batch of tiles arrives.
+    const static int MAX_NEW_LABEL_PLACEMENTS_PER_FRAME = 256;
+
+    // Maximum number of never-placed candidate labels per 256px screen
+    // cell that enter transform and occlusion processing, kept highest
+    // priority first. Caps the per-update label cost by screen area: at
+    // far zooms the visible tiles carry far more candidates than could
+    // ever be placed.
+    const static int MAX_CANDIDATES_PER_CELL = 64;
+
     std::pair<Label*, Tile*> getLabel(uint32_t _selectionColor) const;
 
+    /* Hit test the screen position against the bounds of the current
+     * labels; returns the selection color of the closest visible label
+     * containing the point, or 0 when none does */
+    uint32_t getLabelColorAt(glm::vec2 _screenPosition) const;
+
 protected:
 
     using AABB = isect2d::AABB<glm::vec2>;
@@ -57,25 +81,47 @@ protected:
 
 
     void skipTransitions(const std::vector<std::unique_ptr<Style>>& _styles,
-                         const std::vector<std::shared_ptr<Tile>>& _tiles,
+                         const std::vector<Tile*>& _tiles,
                          TileCache& _cache, float _currentZoom) const;
 
-    PERF_TRACE void skipTransitions(const std::vector<const Style*>& _styles, Tile& _tile, Tile& _proxy) const;
+    PERF_TRACE void skipTransitions(const ArenaVector<const Style*>& _styles, Tile& _tile, Tile& _proxy) const;
 
     PERF_TRACE void sortLabels();
 
     PERF_TRACE void handleOcclusions(const ViewState& _viewState);
 
+    // Whether the label layout changed in a way that can alter occlusion
+    // results since the last full occlusion pass. A layout that only
+    // translated uniformly (panning) keeps every pairwise overlap intact,
+    // so the previous placements can be reused.
+    bool occlusionsNeedUpdate(const ViewState& _viewState) const;
+
+    // Bin never-placed candidate labels by screen cell, spending a single
+    // world position projection per label, and keep only the
+    // <MAX_CANDIDATES_PER_CELL> highest priority candidates per cell; the
+    // rest are skipped before any transform or collision work.
+    PERF_TRACE void preCullLabels(const ViewState& _viewState,
+                                  const std::vector<std::unique_ptr<Style>>& _styles,
+                                  const std::vector<Tile*>& _tiles);
+
     PERF_TRACE bool withinRepeatDistance(Label *_label);
 
+    void addToRepeatGroup(Label* _label);
+
     void processLabelUpdate(const ViewState& viewState, StyledMesh* mesh, Tile* tile,
                             const glm::mat4& mvp, float dt, bool drawAll,
-                            bool onlyTransitions, bool isProxy);
+                            bool onlyTransitions, bool isProxy,
+                            bool transformChanged);
 
     bool m_needUpdate;
 
     isect2d::ISect2D<glm::vec2> m_isect2d;
 
+    // Side length of the square the broadphase grid is sized for; the
+    // grid only ever grows, so rotations and multi-window resizes reuse
+    // its warm cell allocations instead of rebuilding it mid-animation
+    float m_isectGridSide = 0.f;
+
     struct LabelEntry {
 
         LabelEntry(Label* _label, Tile* _tile, bool _proxy)
@@ -95,7 +141,52 @@ protected:
     std::vector<LabelEntry> m_labels;
     std::vector<LabelEntry> m_selectionLabels;
 
-    std::unordered_map<size_t, std::vector<Label*>> m_repeatGroups;
+    // Spatial hash over the labels placed per repeat group, bucketed by
+    // screen cells of the group's repeat distance; duplicate suppression
+    // then probes a fixed cell neighborhood instead of scanning the whole
+    // group. Rebuilt per occlusion pass, since the keys are screen
+    // positions.
+    struct RepeatGroup {
+        float cellSize;
+        std::unordered_map<uint64_t, std::vector<Label*>> cells;
+    };
+
+    std::unordered_map<size_t, RepeatGroup> m_repeatGroups;
+
+    // Screen placement of each label recorded after the last full
+    // occlusion pass, in the same order as m_labels.
+    struct OcclusionEntry {
+        Label* label;
+        glm::vec2 screenCenter;
+        bool offViewport;
+    };
+
+    std::vector<OcclusionEntry> m_occlusionSnapshot;
+    glm::vec2 m_occlusionViewport = { 0.f, 0.f };
+
+    // Labels deferred past the placement budget on the last occlusion
+    // pass; only used for membership tests, entries may go stale when
+    // their tile is dropped.
+    std::unordered_set<Label*> m_deferredLabels;
+
+    // Swapped with m_deferredLabels after each occlusion pass; keeping
+    // both sets around lets the pass reuse their buckets instead of
+    // reallocating the table every time.
+    std::unordered_set<Label*> m_deferredScratch;
+
+    // Candidates collected by the density pre-cull; a member so the
+    // storage is reused across updates.
+    struct PreCullEntry {
+        Label* label;
+        float priority;
+        uint32_t cell;
+    };
+
+    std::vector<PreCullEntry> m_preCullScratch;
+
+    // Labels dropped by the last pre-cull; consulted before the label
+    // transform update, entries may go stale when their tile is dropped.
+    std::unordered_set<Label*> m_preCulled;
 
     float m_lastZoom;
 };
@@ -70,19 +70,19 @@ bool TextLabel::updateScreenTransform(const glm::mat4& _mvp, const ViewState& _v
             // project label position from mercator world space to screen coordinates
             glm::vec2 p0 = m_worldTransform.positions[0];
             glm::vec2 p2 = m_worldTransform.positions[1];
-            glm::vec2 position;
 
-            glm::vec2 ap0 = worldToScreenSpace(_mvp, glm::vec4(p0, 0.0, 1.0),
-                                               _viewState.viewportSize, clipped);
-            glm::vec2 ap2 = worldToScreenSpace(_mvp, glm::vec4(p2, 0.0, 1.0),
-                                               _viewState.viewportSize, clipped);
+            glm::vec4 c0 = worldToClipSpace(_mvp, glm::vec4(p0, 0.0, 1.0));
+            glm::vec4 c2 = worldToClipSpace(_mvp, glm::vec4(p2, 0.0, 1.0));
 
             // check whether the label is behind the camera using the
             // perspective division factor
-            if (clipped) {
+            if (c0.w <= 0.0f || c2.w <= 0.0f) {
                 return false;
             }
 
+            glm::vec2 ap0 = clipToScreenSpace(c0, _viewState.viewportSize);
+            glm::vec2 ap2 = clipToScreenSpace(c2, _viewState.viewportSize);
+
             float length = glm::length(ap2 - ap0);
 
             // default heuristic : allow label to be 30% wider than segment
@@ -92,13 +92,12 @@ bool TextLabel::updateScreenTransform(const glm::mat4& _mvp, const ViewState& _v
                 return false;
             }
 
-            glm::vec2 p1 = glm::vec2(p2 + p0) * 0.5f;
-
-            glm::vec2 ap1 = worldToScreenSpace(_mvp, glm::vec4(p1, 0.0, 1.0),
-                                               _viewState.viewportSize, clipped);
-
+            // Projection is linear in homogeneous coordinates, so the world
+            // midpoint projects to the clip-space midpoint; this saves the
+            // third matrix multiply per line label.
             // Keep screen position center at world center (less sliding in tilted view)
-            position = ap1;
+            glm::vec2 position = clipToScreenSpace((c0 + c2) * 0.5f,
+                                                   _viewState.viewportSize);
 
             glm::vec2 rotation = (ap0.x <= ap2.x ? ap2 - ap0 : ap0 - ap2) / length;
             rotation = glm::vec2{rotation.x, -rotation.y};
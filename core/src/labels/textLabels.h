@@ -9,6 +9,12 @@
 
 namespace Tangram {
 
+/* Tile-side text label data. Holds only the CPU-side glyph quads and
+ * the atlas references; there are no per-tile GL buffers for text.
+ * Visible labels push their transformed quads each frame into the
+ * TextStyle's per-atlas DynamicQuadMesh, so text for all tiles of a
+ * style is drawn from shared buffers with one bind per style and one
+ * draw range per atlas texture. */
 class TextLabels : public LabelSet {
 
 public:
@@ -8,8 +8,25 @@
 #include "selection/featureSelection.h"
 #include "log.h"
 
+#include <cmath>
+
 namespace Tangram {
 
+// Marker geometry is stored in marker-local coordinates, scaled by the
+// extent of its bounds; a purely translated shape therefore produces
+// the same local coordinates with a different origin. Comparing against
+// the previously built coordinates detects such moves, which then only
+// update the marker transform instead of rebuilding the mesh.
+static bool sameLocalCoordinates(const Line& _a, const Line& _b) {
+    if (_a.size() != _b.size()) { return false; }
+    const float epsilon = 1e-6f;
+    for (size_t i = 0; i < _a.size(); i++) {
+        if (std::abs(_a[i].x - _b[i].x) > epsilon ||
+            std::abs(_a[i].y - _b[i].y) > epsilon) { return false; }
+    }
+    return true;
+}
+
 void MarkerManager::setScene(std::shared_ptr<Scene> scene) {
 
     m_scene = scene;
@@ -30,7 +47,9 @@ MarkerID MarkerManager::add() {
 
     // Add a new empty marker object to the list of markers.
     auto id = ++m_idCounter;
-    m_markers.push_back(std::make_unique<Marker>(id));
+    auto marker = std::make_unique<Marker>(id);
+    m_markersById[id] = marker.get();
+    m_markers.push_back(std::move(marker));
 
     // Sort the marker list by draw order.
     std::stable_sort(m_markers.begin(), m_markers.end(), Marker::compareByDrawOrder);
@@ -43,6 +62,15 @@ MarkerID MarkerManager::add() {
 bool MarkerManager::remove(MarkerID markerID) {
     for (auto it = m_markers.begin(), end = m_markers.end(); it != end; ++it) {
         if (it->get()->id() == markerID) {
+            auto idIt = m_markersById.find(markerID);
+            if (idIt != m_markersById.end()) { m_markersById.erase(idIt); }
+            if (auto color = it->get()->selectionColor()) {
+                auto colorIt = m_markersBySelectionColor.find(color);
+                if (colorIt != m_markersBySelectionColor.end()) {
+                    m_markersBySelectionColor.erase(colorIt);
+                }
+                m_scene->featureSelection()->releaseColorIdentifier(color);
+            }
             m_markers.erase(it);
             return true;
         }
@@ -56,6 +84,11 @@ bool MarkerManager::setStyling(MarkerID markerID, const char* styling) {
 
     marker->setStylingString(std::string(styling));
 
+    if (m_batch) {
+        m_batchDirty[markerID] |= batch_styling | batch_geometry;
+        return true;
+    }
+
     // Create a draw rule from the styling string.
     if (!buildStyling(*marker)) { return false; }
 
@@ -76,7 +109,11 @@ bool MarkerManager::setBitmap(MarkerID markerID, int width, int height, const un
 
     // The geometry is unchanged, but the mesh must be rebuilt because DynamicQuadMesh contains
     // texture batches as part of its data.
-    buildGeometry(*marker, m_zoom);
+    if (m_batch) {
+        m_batchDirty[markerID] |= batch_geometry;
+    } else {
+        buildGeometry(*marker, m_zoom);
+    }
 
     return true;
 }
@@ -103,7 +140,11 @@ bool MarkerManager::setDrawOrder(MarkerID markerID, int drawOrder) {
     marker->setDrawOrder(drawOrder);
 
     // Sort the marker list by draw order.
-    std::stable_sort(m_markers.begin(), m_markers.end(), Marker::compareByDrawOrder);
+    if (m_batch) {
+        m_batchOrderDirty = true;
+    } else {
+        std::stable_sort(m_markers.begin(), m_markers.end(), Marker::compareByDrawOrder);
+    }
     return true;
 }
 
@@ -120,7 +161,11 @@ bool MarkerManager::setPoint(MarkerID markerID, LngLat lngLat) {
         feature->geometryType = GeometryType::points;
         feature->points.emplace_back();
         marker->setFeature(std::move(feature));
-        buildGeometry(*marker, m_zoom);
+        if (m_batch) {
+            m_batchDirty[markerID] |= batch_geometry;
+        } else {
+            buildGeometry(*marker, m_zoom);
+        }
     }
 
     // Update the marker's bounds to the given coordinates.
@@ -185,11 +230,26 @@ bool MarkerManager::setPolyline(MarkerID markerID, LngLat* coordinates, int coun
         line.emplace_back((meters.x - origin.x) * scale, (meters.y - origin.y) * scale, 0.f);
     }
 
+    // A rigid move of the polyline keeps the mesh valid; the bounds set
+    // above already placed the marker at its new position. The built
+    // mesh is scaled by the extent at build time, so the extent must be
+    // unchanged too.
+    auto prev = marker->feature();
+    if (marker->mesh() && prev && prev->geometryType == GeometryType::lines &&
+        std::abs(marker->modelMatrix()[0][0] - marker->extent()) <= marker->extent() * 1e-4f &&
+        prev->lines.size() == 1 && sameLocalCoordinates(prev->lines[0], line)) {
+        return true;
+    }
+
     // Update the feature data for the marker.
     marker->setFeature(std::move(feature));
 
     // Build a new mesh for the marker.
-    buildGeometry(*marker, m_zoom);
+    if (m_batch) {
+        m_batchDirty[markerID] |= batch_geometry;
+    } else {
+        buildGeometry(*marker, m_zoom);
+    }
 
     return true;
 }
@@ -245,15 +305,56 @@ bool MarkerManager::setPolygon(MarkerID markerID, LngLat* coordinates, int* coun
         ring += count;
     }
 
+    // As for polylines, a rigid move with unchanged extent keeps the
+    // mesh valid.
+    auto prev = marker->feature();
+    if (marker->mesh() && prev && prev->geometryType == GeometryType::polygons &&
+        std::abs(marker->modelMatrix()[0][0] - marker->extent()) <= marker->extent() * 1e-4f &&
+        prev->polygons.size() == 1 && prev->polygons[0].size() == polygon.size()) {
+        bool same = true;
+        for (size_t i = 0; i < polygon.size() && same; i++) {
+            same = sameLocalCoordinates(prev->polygons[0][i], polygon[i]);
+        }
+        if (same) { return true; }
+    }
+
     // Update the feature data for the marker.
     marker->setFeature(std::move(feature));
 
     // Build a new mesh for the marker.
-    buildGeometry(*marker, m_zoom);
+    if (m_batch) {
+        m_batchDirty[markerID] |= batch_geometry;
+    } else {
+        buildGeometry(*marker, m_zoom);
+    }
 
     return true;
 }
 
+void MarkerManager::beginBatch() {
+    m_batch = true;
+}
+
+void MarkerManager::commitBatch() {
+    if (!m_batch) { return; }
+    m_batch = false;
+
+    for (auto& entry : m_batchDirty) {
+        Marker* marker = getMarkerOrNull(entry.first);
+        // Removed while the batch was open
+        if (!marker) { continue; }
+
+        if ((entry.second & batch_styling) && !buildStyling(*marker)) { continue; }
+        buildGeometry(*marker, m_zoom);
+    }
+    m_batchDirty.clear();
+
+    if (m_batchOrderDirty) {
+        std::stable_sort(m_markers.begin(), m_markers.end(), Marker::compareByDrawOrder);
+        m_batchOrderDirty = false;
+    }
+}
+
 bool MarkerManager::update(int zoom) {
 
     if (zoom == m_zoom) {
@@ -272,7 +373,15 @@ bool MarkerManager::update(int zoom) {
 
 void MarkerManager::removeAll() {
 
+    for (const auto& marker : m_markers) {
+        if (auto color = marker->selectionColor()) {
+            m_scene->featureSelection()->releaseColorIdentifier(color);
+        }
+    }
+
     m_markers.clear();
+    m_markersById.clear();
+    m_markersBySelectionColor.clear();
 
 }
 
@@ -352,7 +461,25 @@ bool MarkerManager::buildGeometry(Marker& marker, int zoom) {
         rule->selectionColor = 0;
     }
 
-    if (!styler->addFeature(*feature, *rule)) { return false; }
+    if (!styler->addFeature(*feature, *rule)) {
+        if (selectionColor) {
+            m_scene->featureSelection()->releaseColorIdentifier(selectionColor);
+        }
+        return false;
+    }
+
+    // Interactive markers get a fresh selection color on each rebuild;
+    // move the marker's index entry along with it.
+    if (auto oldColor = marker.selectionColor()) {
+        auto colorIt = m_markersBySelectionColor.find(oldColor);
+        if (colorIt != m_markersBySelectionColor.end()) {
+            m_markersBySelectionColor.erase(colorIt);
+        }
+        m_scene->featureSelection()->releaseColorIdentifier(oldColor);
+    }
+    if (selectionColor) {
+        m_markersBySelectionColor[selectionColor] = &marker;
+    }
 
     marker.setSelectionColor(selectionColor);
     marker.setMesh(styler->style().getID(), zoom, styler->build());
@@ -361,20 +488,16 @@ bool MarkerManager::buildGeometry(Marker& marker, int zoom) {
 }
 
 const Marker* MarkerManager::getMarkerOrNullBySelectionColor(uint32_t selectionColor) const {
-    for (const auto& marker : m_markers) {
-        if (marker->selectionColor() == selectionColor) {
-            return marker.get();
-        }
-    }
+    auto it = m_markersBySelectionColor.find(selectionColor);
+    if (it != m_markersBySelectionColor.end()) { return it->second; }
 
     return nullptr;
 }
 
 Marker* MarkerManager::getMarkerOrNull(MarkerID markerID) {
     if (!markerID) { return nullptr; }
-    for (const auto& entry : m_markers) {
-        if (entry->id() == markerID) { return entry.get(); }
-    }
+    auto it = m_markersById.find(markerID);
+    if (it != m_markersById.end()) { return it->second; }
     return nullptr;
 }
 
@@ -53,6 +53,13 @@ public:
     // Set a marker to a polygon feature at the given position; returns true if the marker was found and updated.
     bool setPolygon(MarkerID markerID, LngLat* coordinates, int* counts, int rings);
 
+    // Begin a mutation batch: until commitBatch, marker changes defer their styling and mesh
+    // rebuilds and only flag the marker. Repeated changes to one marker then cost one rebuild.
+    void beginBatch();
+
+    // Rebuild every marker flagged since beginBatch and apply a deferred draw-order sort.
+    void commitBatch();
+
     // Update the zoom level for all markers; markers are built for one zoom level at a time so when the current zoom
     // changes, all marker meshes are rebuilt.
     bool update(int zoom);
@@ -77,6 +84,20 @@ private:
     StyleContext m_styleContext;
     std::shared_ptr<Scene> m_scene;
     std::vector<std::unique_ptr<Marker>> m_markers;
+
+    // Lookup indexes over m_markers, which stays sorted by draw order
+    // for rendering and so cannot be searched by id directly. Marker
+    // pointers are owned by m_markers and stable until removal. Kept in
+    // sync by add/remove/removeAll and by buildGeometry when a marker's
+    // selection color is reassigned.
+    fastmap<MarkerID, Marker*> m_markersById;
+    fastmap<uint32_t, Marker*> m_markersBySelectionColor;
+
+    // Rebuild flags collected per marker while a batch is open.
+    enum BatchDirty : uint8_t { batch_styling = 1 << 0, batch_geometry = 1 << 1 };
+    fastmap<MarkerID, uint8_t> m_batchDirty;
+    bool m_batch = false;
+    bool m_batchOrderDirty = false;
     std::vector<std::string> m_jsFnList;
     fastmap<std::string, std::unique_ptr<StyleBuilder>> m_styleBuilders;
     MapProjection* m_mapProjection = nullptr;
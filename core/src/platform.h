@@ -46,6 +46,23 @@ std::vector<char> bytesFromFile(const char* _path);
 /* Function type for receiving data from a successful network request */
 using UrlCallback = std::function<void(std::vector<char>&&)>;
 
+/* Validators naming the copy of a resource a cache holds, taken from the
+ * ETag and Last-Modified headers of the response it came from */
+struct UrlValidators {
+    std::string etag;
+    std::string lastModified;
+
+    bool empty() const { return etag.empty() && lastModified.empty(); }
+};
+
+/* As UrlCallback, additionally receiving the validators of the response.
+ * When the server answered 304 Not Modified, _notModified is true, the
+ * data is empty and the cached copy named by the request validators is
+ * still current. Platforms may deliver the body without decoding its
+ * transport Content-Encoding, to keep their transfer threads I/O-only;
+ * consumers detect and inflate gzip payloads on a worker. */
+using UrlRevalidateCallback = std::function<void(std::vector<char>&&, UrlValidators&&, bool _notModified)>;
+
 /* Start retrieving data from a URL asynchronously
  *
  * When the request is finished, the callback @_callback will be
@@ -53,7 +70,39 @@ using UrlCallback = std::function<void(std::vector<char>&&)>;
  */
 bool startUrlRequest(const std::string& _url, UrlCallback _callback);
 
+/* As above, revalidating the cached copy named by @_validators: they are
+ * sent as If-None-Match and If-Modified-Since request headers, and an
+ * unchanged resource is answered through _notModified instead of a full
+ * download. Platforms without header support may ignore @_validators and
+ * always deliver a full response. */
+bool startUrlRequest(const std::string& _url, const UrlValidators& _validators,
+                     UrlRevalidateCallback _callback);
+
+/* Receives one chunk of response data as it arrives, on the transfer
+ * thread; chunks are delivered in order */
+using UrlChunkCallback = std::function<void(const char* _data, size_t _size)>;
+
+/* Ends a streamed request. _ok is false when the transfer failed; the
+ * validators of the response are passed along as for a buffered fetch. */
+using UrlStreamFinishCallback = std::function<void(bool _ok, UrlValidators&& _validators)>;
+
+/* As startUrlRequest, but delivering response data incrementally:
+ * @_chunk runs for each piece of the body as it arrives and @_finish
+ * once afterwards, so the caller can consume the response while it is
+ * still in transit. Platforms whose HTTP stack only surfaces complete
+ * responses deliver the whole body as a single chunk before the finish.
+ * A request aborted through cancelUrlRequest may end without its finish
+ * callback running; owners of a stream must unblock their own consumers
+ * when canceling. */
+bool startUrlRequestStream(const std::string& _url, UrlChunkCallback _chunk,
+                           UrlStreamFinishCallback _finish);
+
 /* Stop retrieving data from a URL that was previously requested
+ *
+ * Implementations must abort the transfer itself - within roughly one
+ * progress or data callback - not merely discard its result, so that
+ * tiles scrolled out of view stop consuming bandwidth. The callback of
+ * an aborted request is not invoked.
  */
 void cancelUrlRequest(const std::string& _url);
 
@@ -12,12 +12,17 @@ class DataLayer : public SceneLayer {
     std::string m_source;
     std::vector<std::string> m_collections;
 
+    // Geometry simplification tolerance in pixels; 0 disables the pass
+    float m_simplifyTolerance = 0.f;
+
 public:
 
-    DataLayer(SceneLayer _layer, const std::string& _source, const std::vector<std::string>& _collections);
+    DataLayer(SceneLayer _layer, const std::string& _source, const std::vector<std::string>& _collections,
+              float _simplifyTolerance = 0.f);
 
     const auto& source() const { return m_source; }
     const auto& collections() const { return m_collections; }
+    float simplifyTolerance() const { return m_simplifyTolerance; }
 
 };
 
@@ -20,6 +20,7 @@ DirectionalLight::DirectionalLight(const std::string& _name, bool _dynamic) :
 DirectionalLight::~DirectionalLight() {}
 
 void DirectionalLight::setDirection(const glm::vec3 &_dir) {
+    m_generation++;
     m_direction = glm::normalize(_dir);
 }
 
@@ -16,10 +16,11 @@
 namespace Tangram {
 
 DrawRuleData::DrawRuleData(std::string _name, int _id,
-                           std::vector<StyleParam> _parameters)
+                           std::vector<StyleParam> _parameters, int _styleId)
     : parameters(std::move(_parameters)),
       name(std::move(_name)),
-      id(_id) {}
+      id(_id),
+      styleId(_styleId) {}
 
 std::string DrawRuleData::toString() const {
     std::string str = "{\n";
@@ -37,7 +38,8 @@ std::string DrawRuleData::toString() const {
 
 DrawRule::DrawRule(const DrawRuleData& _ruleData, const std::string& _layerName, size_t _layerDepth) :
     name(&_ruleData.name),
-    id(_ruleData.id) {
+    id(_ruleData.id),
+    styleId(_ruleData.styleId) {
 
     for (const auto& param : _ruleData.parameters) {
         auto key = static_cast<uint8_t>(param.key);
@@ -62,6 +64,11 @@ void DrawRule::merge(const DrawRuleData& _ruleData, const SceneLayer& _layer) {
             (depthNew == param.depth && strcmp(layerNew, param.name) > 0)) {
             param = { &paramNew, layerNew, depthNew };
             active[key] = true;
+
+            // The effective style follows the winning 'style' parameter
+            if (paramNew.key == StyleParamKey::style) {
+                styleId = _ruleData.styleId;
+            }
         }
     }
 }
@@ -113,11 +120,14 @@ void DrawRule::logGetError(StyleParamKey _expectedKey, const StyleParam& _param)
     LOGE("wrong type '%d'for StyleParam '%d'", _param.value.which(), _expectedKey);
 }
 
-bool DrawRuleMergeSet::match(const Feature& _feature, const SceneLayer& _layer, StyleContext& _ctx) {
+bool DrawRuleMergeSet::match(const Feature& _feature, const SceneLayer& _layer, StyleContext& _ctx,
+                             bool _skipRootFilter) {
 
     _ctx.setFeature(_feature);
+    _ctx.setCurrentLayer(&_layer.name());
     m_matchedRules.clear();
     m_queuedLayers.clear();
+    m_matchedLayers.clear();
 
     // If uber layer is marked not visible return immediately
     if (!_layer.visible()) {
@@ -125,19 +135,19 @@ bool DrawRuleMergeSet::match(const Feature& _feature, const SceneLayer& _layer,
     }
 
     // If the first filter doesn't match, return immediately
-    if (!_layer.filter().eval(_feature, _ctx)) { return false; }
+    if (!_skipRootFilter && !_layer.filterProgram().eval(_feature, _ctx)) { return false; }
 
     m_queuedLayers.push_back(&_layer);
 
-    // Iterate depth-first over the layer hierarchy
+    // Iterate depth-first over the layer hierarchy, collecting the
+    // layers whose filters match
     while (!m_queuedLayers.empty()) {
 
         // Pop a layer off the top of the stack
         const auto& layer = *m_queuedLayers.back();
         m_queuedLayers.pop_back();
 
-        // Merge rules from layer into accumulated set
-        mergeRules(layer);
+        m_matchedLayers.push_back(&layer);
 
         // Push each of the layer's matching sublayers onto the stack
         for (const auto& sublayer : layer.sublayers()) {
@@ -146,12 +156,35 @@ bool DrawRuleMergeSet::match(const Feature& _feature, const SceneLayer& _layer,
                 continue;
             }
 
-            if (sublayer.filter().eval(_feature, _ctx)) {
+            if (sublayer.filterProgram().eval(_feature, _ctx)) {
                 m_queuedLayers.push_back(&sublayer);
             }
         }
     }
 
+    // Reuse the merged rules of the last feature that matched the same
+    // layer combination
+    size_t signature = 0;
+    for (auto* layer : m_matchedLayers) {
+        hash_combine(signature, layer);
+    }
+
+    auto entry = m_mergeCache.find(signature);
+    if (entry != m_mergeCache.end() && entry->second.layers == m_matchedLayers) {
+        m_matchedRules = entry->second.rules;
+        return true;
+    }
+
+    // Merge rules from each matched layer into the accumulated set
+    for (auto* layer : m_matchedLayers) {
+        mergeRules(*layer);
+    }
+
+    if (m_mergeCache.size() >= max_merge_cache_entries) {
+        m_mergeCache.clear();
+    }
+    m_mergeCache.emplace(signature, CachedMerge{m_matchedLayers, m_matchedRules});
+
     return true;
 }
 
@@ -191,7 +224,22 @@ bool DrawRuleMergeSet::evaluateRuleForContext(DrawRule& rule, StyleContext& ctx)
                 m_evaluated[i] = *param;
                 param = &m_evaluated[i];
 
-                Stops::eval(*param->stops, param->key, ctx.getKeywordZoom(), m_evaluated[i].value);
+                float zoom = ctx.getKeywordZoom();
+                if (zoom != m_stopsCacheZoom) {
+                    m_stopsCache.clear();
+                    m_stopsCacheZoom = zoom;
+                }
+
+                auto entry = m_stopsCache.find(param->stops);
+                if (entry != m_stopsCache.end() && entry->second.key == param->key) {
+                    m_evaluated[i].value = entry->second.value;
+                } else {
+                    Stops::eval(*param->stops, param->key, zoom, m_evaluated[i].value);
+                    if (entry == m_stopsCache.end()) {
+                        m_stopsCache.emplace(param->stops,
+                                             StopsCacheEntry{param->key, m_evaluated[i].value});
+                    }
+                }
             }
         }
 
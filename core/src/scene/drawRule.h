@@ -5,6 +5,7 @@
 #include <vector>
 #include <set>
 #include <bitset>
+#include <unordered_map>
 
 namespace Tangram {
 
@@ -46,7 +47,14 @@ struct DrawRuleData {
     std::string name;
     int id;
 
-    DrawRuleData(std::string _name, int _id, std::vector<StyleParam> _parameters);
+    // Index of the style this rule targets in the scene's style vector,
+    // resolved once at scene load from the rule name or a static 'style'
+    // parameter. -1 when the style is dynamic or unknown; rule
+    // application then falls back to resolving the name.
+    int styleId = -1;
+
+    DrawRuleData(std::string _name, int _id, std::vector<StyleParam> _parameters,
+                 int _styleId = -1);
 
     std::string toString() const;
 
@@ -75,6 +83,9 @@ struct DrawRule {
     // draw-style name and id
     const std::string* name = nullptr;
     int id;
+    // Scene style index of the merged rule, following the winning
+    // 'style' parameter; see DrawRuleData::styleId.
+    int styleId = -1;
     bool isOutlineOnly = false;
     uint32_t selectionColor = 0;
     FeatureSelection* featureSelection = nullptr;
@@ -89,6 +100,8 @@ struct DrawRule {
 
     const std::string& getStyleName() const;
 
+    int getStyleId() const { return styleId; }
+
     const char* getLayerName(StyleParamKey _key) const;
 
     size_t getParamSetHash() const;
@@ -122,21 +135,52 @@ public:
     bool evaluateRuleForContext(DrawRule& rule, StyleContext& ctx);
 
     // internal
-    bool match(const Feature& _feature, const SceneLayer& _layer, StyleContext& _ctx);
+    // _skipRootFilter: the caller already evaluated _layer's own filter
+    // for _feature, e.g. in a batched sweep; only the sublayer cascade
+    // and rule merge run.
+    bool match(const Feature& _feature, const SceneLayer& _layer, StyleContext& _ctx,
+               bool _skipRootFilter = false);
 
     // internal
     void mergeRules(const SceneLayer& _layer);
 
     auto& matchedRules() { return m_matchedRules; }
 
+    /* Maximum number of cached merged rule sets */
+    static constexpr size_t max_merge_cache_entries = 512;
+
 private:
     // Reusable containers 'matchedRules' and 'queuedLayers'
     std::vector<DrawRule> m_matchedRules;
     std::vector<const SceneLayer*> m_queuedLayers;
 
+    // Merged rules cached by the set of matched layers: features in a
+    // tile overwhelmingly match identical layer combinations, so the
+    // second and following features with the same matched set copy the
+    // merged parameter pointers instead of re-merging layer by layer.
+    // Layer pointers are stable for the scene this builder belongs to.
+    struct CachedMerge {
+        std::vector<const SceneLayer*> layers;
+        std::vector<DrawRule> rules;
+    };
+    std::vector<const SceneLayer*> m_matchedLayers;
+    std::unordered_map<size_t, CachedMerge> m_mergeCache;
+
     // Container for dynamically-evaluated parameters
     StyleParam m_evaluated[StyleParamKeySize];
 
+    // Stops results memoized for the current zoom: a tile build applies
+    // the same few Stops to thousands of features at one fixed zoom, so
+    // each Stops is evaluated once per zoom instead of per feature. The
+    // param key is kept to guard against one Stops shared between
+    // differently-typed parameters.
+    struct StopsCacheEntry {
+        StyleParamKey key;
+        StyleParam::Value value;
+    };
+    float m_stopsCacheZoom = -1.f;
+    std::unordered_map<const Stops*, StopsCacheEntry> m_stopsCache;
+
 };
 
 }
@@ -16,12 +16,12 @@ void evalConflict(const DrawRule& rule, const DrawRuleData& data, const SceneLay
 
         auto k = static_cast<uint8_t>(param.key);
 
-        if (rule.depths[k] == layer.depth()) {
+        if (rule.active[k] && rule.params[k].depth == layer.depth()) {
 
             std::lock_guard<std::mutex> lock(logMutex);
 
             std::string logString = "Draw parameter '" + StyleParam::keyName(param.key) + "' in rule '" +
-                data.name + "' in layer '" + layer.name() + "' conflicts with layer '" + rule.layers[k] + "'";
+                data.name + "' in layer '" + layer.name() + "' conflicts with layer '" + rule.params[k].name + "'";
 
             if (log.insert(logString).second) {
                 LOGW("%s", logString.c_str());
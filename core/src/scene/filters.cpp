@@ -125,6 +125,53 @@ int Filter::filterCost() const {
     return 0;
 }
 
+uint64_t Filter::requiredKeysBloom() const {
+
+    auto keyBit = [](uint32_t _keyHash) { return 1ull << (_keyHash & 63); };
+
+    switch (data.which()) {
+    case Data::type<OperatorAll>::value: {
+        // Every conjunct must match, so their requirements accumulate
+        uint64_t bloom = 0;
+        for (auto& f : operands()) { bloom |= f.requiredKeysBloom(); }
+        return bloom;
+    }
+    case Data::type<OperatorAny>::value: {
+        // Only bits that every disjunct requires are required overall:
+        // a feature matching any one disjunct carries at least that
+        // disjunct's bits, hence at least the intersection.
+        auto& ops = operands();
+        if (ops.empty()) { return 0; }
+
+        uint64_t bloom = ~0ull;
+        for (auto& f : ops) { bloom &= f.requiredKeysBloom(); }
+        return bloom;
+    }
+    case Data::type<Existence>::value: {
+        auto& f = data.get<Existence>();
+        return f.exists ? keyBit(f.keyHash) : 0;
+    }
+    // Equality, EqualitySet and Range never match a missing property,
+    // so their keys are required - unless they test a keyword, which
+    // is not a feature property at all.
+    case Data::type<EqualitySet>::value: {
+        auto& f = data.get<EqualitySet>();
+        return f.keyword == FilterKeyword::undefined ? keyBit(f.keyHash) : 0;
+    }
+    case Data::type<Equality>::value: {
+        auto& f = data.get<Equality>();
+        return f.keyword == FilterKeyword::undefined ? keyBit(f.keyHash) : 0;
+    }
+    case Data::type<Filter::Range>::value: {
+        auto& f = data.get<Range>();
+        return f.keyword == FilterKeyword::undefined ? keyBit(f.keyHash) : 0;
+    }
+    // OperatorNone and Function can match features of any shape
+    default:
+        return 0;
+    }
+}
+
 const std::string& Filter::key() const {
     static const std::string empty = "";
 
@@ -346,25 +393,25 @@ struct matcher {
         return true;
     }
     bool operator() (const Filter::Existence& f) const {
-        return f.exists == props.contains(f.key);
+        return f.exists == props.contains(f.key, f.keyHash);
     }
     bool operator() (const Filter::EqualitySet& f) const {
         auto& value = (f.keyword == FilterKeyword::undefined)
-            ? props.get(f.key)
+            ? props.get(f.key, f.keyHash)
             : ctx.getKeyword(f.keyword);
 
         return Value::visit(value, match_equal_set{f.values});
     }
     bool operator() (const Filter::Equality& f) const {
         auto& value = (f.keyword == FilterKeyword::undefined)
-            ? props.get(f.key)
+            ? props.get(f.key, f.keyHash)
             : ctx.getKeyword(f.keyword);
 
         return Value::visit(value, match_equal{f.value});
     }
     bool operator() (const Filter::Range& f) const {
         auto& value = (f.keyword == FilterKeyword::undefined)
-            ? props.get(f.key)
+            ? props.get(f.key, f.keyHash)
             : ctx.getKeyword(f.keyword);
 
         return Value::visit(value, match_range{f});
@@ -381,4 +428,235 @@ bool Filter::eval(const Feature& feat, StyleContext& ctx) const {
     return Data::visit(data, matcher(feat, ctx));
 }
 
+Filter::ZoomMatch Filter::matchAtZoom(float _zoom) const {
+
+    switch (data.which()) {
+
+    case Data::type<OperatorAll>::value: {
+        ZoomMatch result = ZoomMatch::yes;
+        for (auto& f : operands()) {
+            ZoomMatch m = f.matchAtZoom(_zoom);
+            if (m == ZoomMatch::no) { return ZoomMatch::no; }
+            if (m == ZoomMatch::maybe) { result = ZoomMatch::maybe; }
+        }
+        return result;
+    }
+    case Data::type<OperatorAny>::value: {
+        auto& ops = operands();
+        if (ops.empty()) { return ZoomMatch::no; }
+
+        ZoomMatch result = ZoomMatch::no;
+        for (auto& f : ops) {
+            ZoomMatch m = f.matchAtZoom(_zoom);
+            if (m == ZoomMatch::yes) { return ZoomMatch::yes; }
+            if (m == ZoomMatch::maybe) { result = ZoomMatch::maybe; }
+        }
+        return result;
+    }
+    case Data::type<OperatorNone>::value: {
+        ZoomMatch result = ZoomMatch::yes;
+        for (auto& f : operands()) {
+            ZoomMatch m = f.matchAtZoom(_zoom);
+            if (m == ZoomMatch::yes) { return ZoomMatch::no; }
+            if (m == ZoomMatch::maybe) { result = ZoomMatch::maybe; }
+        }
+        return result;
+    }
+    case Data::type<EqualitySet>::value: {
+        auto& f = data.get<EqualitySet>();
+        if (f.keyword != FilterKeyword::zoom) { return ZoomMatch::maybe; }
+        return match_equal_set{f.values}(double(_zoom)) ? ZoomMatch::yes : ZoomMatch::no;
+    }
+    case Data::type<Equality>::value: {
+        auto& f = data.get<Equality>();
+        if (f.keyword != FilterKeyword::zoom) { return ZoomMatch::maybe; }
+        return match_equal{f.value}(double(_zoom)) ? ZoomMatch::yes : ZoomMatch::no;
+    }
+    case Data::type<Range>::value: {
+        auto& f = data.get<Range>();
+        if (f.keyword != FilterKeyword::zoom) { return ZoomMatch::maybe; }
+        return match_range{f}(double(_zoom)) ? ZoomMatch::yes : ZoomMatch::no;
+    }
+    case Data::type<none_type>::value:
+        return ZoomMatch::yes;
+
+    // Existence and Function predicates depend on the feature
+    default:
+        return ZoomMatch::maybe;
+    }
+}
+
+void FilterProgram::compile(const Filter& _filter) {
+
+    // Labels are placeholders for jump targets while the tree is
+    // flattened; ids 0 and 1 are reserved for accept and reject and all
+    // labels are resolved to program counters once emission is done.
+    std::vector<uint16_t> labels = {0, 0};
+
+    emit(_filter.data, 0, 1, labels);
+
+    labels[0] = uint16_t(m_instructions.size());
+    labels[1] = uint16_t(m_instructions.size() + 1);
+
+    for (auto& in : m_instructions) {
+        in.onMatch = labels[in.onMatch];
+        in.onMiss = labels[in.onMiss];
+    }
+}
+
+void FilterProgram::emit(const Filter::Data& _data, uint16_t _onMatch, uint16_t _onMiss,
+                         std::vector<uint16_t>& _labels) {
+
+    switch (_data.which()) {
+
+    case Filter::Data::type<Filter::OperatorAll>::value: {
+        // Each operand falls through to the next on a match; the first
+        // miss short-circuits to <_onMiss>.
+        auto& operands = _data.get<Filter::OperatorAll>().operands;
+        if (operands.empty()) {
+            m_instructions.push_back({Op::always, 0, _onMatch, _onMatch});
+            break;
+        }
+        for (size_t i = 0; i < operands.size(); i++) {
+            if (i + 1 == operands.size()) {
+                emit(operands[i].data, _onMatch, _onMiss, _labels);
+            } else {
+                uint16_t next = uint16_t(_labels.size());
+                _labels.push_back(0);
+                emit(operands[i].data, next, _onMiss, _labels);
+                _labels[next] = uint16_t(m_instructions.size());
+            }
+        }
+        break;
+    }
+    case Filter::Data::type<Filter::OperatorAny>::value: {
+        auto& operands = _data.get<Filter::OperatorAny>().operands;
+        if (operands.empty()) {
+            m_instructions.push_back({Op::always, 0, _onMiss, _onMiss});
+            break;
+        }
+        for (size_t i = 0; i < operands.size(); i++) {
+            if (i + 1 == operands.size()) {
+                emit(operands[i].data, _onMatch, _onMiss, _labels);
+            } else {
+                uint16_t next = uint16_t(_labels.size());
+                _labels.push_back(0);
+                emit(operands[i].data, _onMatch, next, _labels);
+                _labels[next] = uint16_t(m_instructions.size());
+            }
+        }
+        break;
+    }
+    case Filter::Data::type<Filter::OperatorNone>::value: {
+        // Inverted any: a matching operand rejects, running out of
+        // operands accepts.
+        auto& operands = _data.get<Filter::OperatorNone>().operands;
+        if (operands.empty()) {
+            m_instructions.push_back({Op::always, 0, _onMatch, _onMatch});
+            break;
+        }
+        for (size_t i = 0; i < operands.size(); i++) {
+            if (i + 1 == operands.size()) {
+                emit(operands[i].data, _onMiss, _onMatch, _labels);
+            } else {
+                uint16_t next = uint16_t(_labels.size());
+                _labels.push_back(0);
+                emit(operands[i].data, _onMiss, next, _labels);
+                _labels[next] = uint16_t(m_instructions.size());
+            }
+        }
+        break;
+    }
+    case Filter::Data::type<Filter::Existence>::value:
+        m_existences.push_back(_data.get<Filter::Existence>());
+        m_instructions.push_back({Op::existence, uint16_t(m_existences.size() - 1),
+                                  _onMatch, _onMiss});
+        break;
+
+    case Filter::Data::type<Filter::Equality>::value:
+        m_equalities.push_back(_data.get<Filter::Equality>());
+        m_instructions.push_back({Op::equality, uint16_t(m_equalities.size() - 1),
+                                  _onMatch, _onMiss});
+        break;
+
+    case Filter::Data::type<Filter::EqualitySet>::value:
+        m_equalitySets.push_back(_data.get<Filter::EqualitySet>());
+        m_instructions.push_back({Op::equalitySet, uint16_t(m_equalitySets.size() - 1),
+                                  _onMatch, _onMiss});
+        break;
+
+    case Filter::Data::type<Filter::Range>::value:
+        m_ranges.push_back(_data.get<Filter::Range>());
+        m_instructions.push_back({Op::range, uint16_t(m_ranges.size() - 1),
+                                  _onMatch, _onMiss});
+        break;
+
+    case Filter::Data::type<Filter::Function>::value:
+        m_functions.push_back(_data.get<Filter::Function>().id);
+        m_instructions.push_back({Op::function, uint16_t(m_functions.size() - 1),
+                                  _onMatch, _onMiss});
+        break;
+
+    default:
+        // none_type matches everything
+        m_instructions.push_back({Op::always, 0, _onMatch, _onMatch});
+        break;
+    }
+}
+
+bool FilterProgram::eval(const Feature& _feat, StyleContext& _ctx) const {
+
+    const Properties& props = _feat.props;
+
+    const uint32_t accept = m_instructions.size();
+    uint32_t pc = 0;
+
+    while (pc < accept) {
+        const Instruction& in = m_instructions[pc];
+        bool match = false;
+
+        switch (in.op) {
+        case Op::always:
+            match = true;
+            break;
+        case Op::existence: {
+            auto& f = m_existences[in.data];
+            match = (f.exists == props.contains(f.key, f.keyHash));
+            break;
+        }
+        case Op::equality: {
+            auto& f = m_equalities[in.data];
+            auto& value = (f.keyword == FilterKeyword::undefined)
+                ? props.get(f.key, f.keyHash)
+                : _ctx.getKeyword(f.keyword);
+            match = Value::visit(value, match_equal{f.value});
+            break;
+        }
+        case Op::equalitySet: {
+            auto& f = m_equalitySets[in.data];
+            auto& value = (f.keyword == FilterKeyword::undefined)
+                ? props.get(f.key, f.keyHash)
+                : _ctx.getKeyword(f.keyword);
+            match = Value::visit(value, match_equal_set{f.values});
+            break;
+        }
+        case Op::range: {
+            auto& f = m_ranges[in.data];
+            auto& value = (f.keyword == FilterKeyword::undefined)
+                ? props.get(f.key, f.keyHash)
+                : _ctx.getKeyword(f.keyword);
+            match = Value::visit(value, match_range{f});
+            break;
+        }
+        case Op::function:
+            match = _ctx.evalFilter(m_functions[in.data]);
+            break;
+        }
+
+        pc = match ? in.onMatch : in.onMiss;
+    }
+
+    return pc == accept;
+}
+
 }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "data/properties.h"
 #include "util/variant.h"
 
 #include <vector>
@@ -27,25 +28,31 @@ struct Filter {
         std::vector<Filter> operands;
     };
 
+    // Filters resolve their key hash once at construction, so evaluation
+    // never re-hashes the key per feature.
     struct EqualitySet {
         std::string key;
         std::vector<Value> values;
         FilterKeyword keyword;
+        uint32_t keyHash;
     };
     struct Equality {
         std::string key;
         Value value;
         FilterKeyword keyword;
+        uint32_t keyHash;
     };
     struct Range {
         std::string key;
         float min;
         float max;
         FilterKeyword keyword;
+        uint32_t keyHash;
     };
     struct Existence {
         std::string key;
         bool exists;
+        uint32_t keyHash;
     };
     struct Function {
         uint32_t id;
@@ -82,18 +89,18 @@ struct Filter {
     // Create an 'equality' filter
     inline static Filter MatchEquality(const std::string& k, const std::vector<Value>& vals) {
         if (vals.size() == 1) {
-            return { Equality{ k, vals[0], keywordType(k) }};
+            return { Equality{ k, vals[0], keywordType(k), Properties::keyHash(k) }};
         } else {
-            return { EqualitySet{ k, vals, keywordType(k) }};
+            return { EqualitySet{ k, vals, keywordType(k), Properties::keyHash(k) }};
         }
     }
     // Create a 'range' filter
     inline static Filter MatchRange(const std::string& k, float min, float max) {
-        return { Range{ k, min, max, keywordType(k) }};
+        return { Range{ k, min, max, keywordType(k), Properties::keyHash(k) }};
     }
     // Create an 'existence' filter
     inline static Filter MatchExistence(const std::string& k, bool ex) {
-        return { Existence{ k, ex }};
+        return { Existence{ k, ex, Properties::keyHash(k) }};
     }
     // Create an 'function' filter with reference to Scene function id
     inline static Filter MatchFunction(uint32_t id) {
@@ -109,6 +116,23 @@ struct Filter {
         return  FilterKeyword::undefined;
     }
 
+    // Bloom mask over the property keys a feature must carry for this
+    // filter to possibly match; compared against Layer::keyBloom to
+    // reject whole collections without evaluating the filter.
+    uint64_t requiredKeysBloom() const;
+
+    // Tri-state outcome of evaluating only the predicates that test the
+    // $zoom keyword; 'maybe' means the outcome depends on feature
+    // properties.
+    enum class ZoomMatch : uint8_t { no, yes, maybe };
+
+    /* Evaluate the $zoom predicates of this filter once for a whole tile
+     * build, where zoom is constant. Returns 'no' when no feature can
+     * match at _zoom, letting the tile builder skip the layer before its
+     * feature loop; 'yes' when the filter matches regardless of feature
+     * properties. */
+    ZoomMatch matchAtZoom(float _zoom) const;
+
     /* Public for testing */
     static void sort(std::vector<Filter>& filters);
     void print(int _indent = 0) const;
@@ -120,4 +144,54 @@ struct Filter {
     bool isValid() const { return !data.is<none_type>(); }
     operator bool() const { return isValid(); }
 };
+
+// Flattened, compiled form of a filter tree. The any/all/none structure
+// is encoded as jump targets between leaf predicates, so per-feature
+// evaluation is one loop over a contiguous instruction array instead of
+// a recursive walk with variant dispatch. Compiled once per layer when
+// the scene is loaded.
+class FilterProgram {
+
+public:
+
+    FilterProgram() {}
+    explicit FilterProgram(const Filter& _filter) { compile(_filter); }
+
+    bool eval(const Feature& _feat, StyleContext& _ctx) const;
+
+private:
+
+    enum class Op : uint8_t {
+        always,
+        existence,
+        equality,
+        equalitySet,
+        range,
+        function,
+    };
+
+    // Predicate data lives in the per-op vectors below, indexed by
+    // <data>. <onMatch> and <onMiss> are the program counters to
+    // continue at; the counters one and two past the last instruction
+    // encode accept and reject.
+    struct Instruction {
+        Op op;
+        uint16_t data;
+        uint16_t onMatch;
+        uint16_t onMiss;
+    };
+
+    void compile(const Filter& _filter);
+
+    void emit(const Filter::Data& _data, uint16_t _onMatch, uint16_t _onMiss,
+              std::vector<uint16_t>& _labels);
+
+    std::vector<Instruction> m_instructions;
+    std::vector<Filter::Existence> m_existences;
+    std::vector<Filter::Equality> m_equalities;
+    std::vector<Filter::EqualitySet> m_equalitySets;
+    std::vector<Filter::Range> m_ranges;
+    std::vector<uint32_t> m_functions;
+};
+
 }
@@ -47,7 +47,9 @@ Node Importer::applySceneImports(const Url& scenePath, const Url& resourceRoot)
             path = m_sceneQueue.back();
             m_sceneQueue.pop_back();
 
-            if (m_scenes.find(path) != m_scenes.end()) { continue; }
+            // Fetch each url only once, even while its first download
+            // is still in flight
+            if (!m_requested.insert(path).second) { continue; }
         }
 
         if (path.hasHttpScheme()) {
@@ -44,12 +44,19 @@ private:
     // import scene to respective root nodes
     std::unordered_map<Url, Node> m_scenes;
 
+    // Urls already dispatched for fetching; deduplicates imports that
+    // appear several times across the import graph, including those
+    // whose download is still in flight.
+    std::unordered_set<Url> m_requested;
+
     std::vector<Url> m_sceneQueue;
     static std::atomic_uint progressCounter;
     std::mutex sceneMutex;
     std::condition_variable m_condition;
 
-    const unsigned int MAX_SCENE_DOWNLOAD = 4;
+    // High enough that every import of a typical scene graph downloads
+    // concurrently; resolution time then approaches the slowest fetch.
+    const unsigned int MAX_SCENE_DOWNLOAD = 16;
 };
 
 }
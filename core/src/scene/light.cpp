@@ -3,6 +3,7 @@
 #include "glm/gtx/string_cast.hpp"
 #include "platform.h"
 #include "gl/shaderProgram.h"
+#include "view/view.h"
 
 #include "shaders/lights_glsl.h"
 
@@ -29,22 +30,46 @@ void Light::setInstanceName(const std::string &_name) {
 }
 
 void Light::setAmbientColor(const glm::vec4 _ambient) {
+    m_generation++;
     m_ambient = _ambient;
 }
 
 void Light::setDiffuseColor(const glm::vec4 _diffuse) {
+    m_generation++;
     m_diffuse = _diffuse;
 }
 
 void Light::setSpecularColor(const glm::vec4 _specular) {
+    m_generation++;
     m_specular = _specular;
 }
 
 void Light::setOrigin(LightOrigin origin) {
+    m_generation++;
     m_dynamic = true;
     m_origin = origin;
 }
 
+bool Light::upToDate(const View& _view, LightUniforms& _uniforms) {
+
+    // Ambient lights have no direction or position to transform, so
+    // only their own values matter; everything else re-sends when the
+    // view moved.
+    int64_t viewGeneration = (m_type == LightType::ambient) ? 0 : _view.generation();
+
+    if (_uniforms.generation == m_generation &&
+        _uniforms.viewGeneration == viewGeneration &&
+        _uniforms.buildNumber == _uniforms.shader.buildNumber()) {
+        return true;
+    }
+
+    _uniforms.generation = m_generation;
+    _uniforms.viewGeneration = viewGeneration;
+    _uniforms.buildNumber = _uniforms.shader.buildNumber();
+
+    return false;
+}
+
 void Light::injectSourceBlocks(ShaderProgram& _shader) {
 
     // Inject all needed #defines for this light instance
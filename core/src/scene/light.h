@@ -48,6 +48,12 @@ struct LightUniforms {
 
     ShaderProgram& shader;
 
+    // Light generation, view generation and program build the values
+    // were last uploaded for; see Light::upToDate
+    int64_t generation = -1;
+    int64_t viewGeneration = -1;
+    int buildNumber = -1;
+
     UniformLocation ambient;
     UniformLocation diffuse;
     UniformLocation specular;
@@ -83,6 +89,10 @@ public:
     /*  Get the origin relative to which this light is positioned */
     LightOrigin getOrigin() const { return m_origin; }
 
+    /*  Whether this light passes its values as uniforms; non-dynamic lights
+     *  have their values baked into the shader source. */
+    bool isDynamic() const { return m_dynamic; }
+
     /*  Get the instances light name defined on the shader */
     virtual std::string getInstanceName();
 
@@ -101,6 +111,14 @@ public:
     /*  Pass the uniforms for this particular DYNAMICAL light on the passed shader */
     virtual void setupProgram(RenderState& rs, const View& _view, LightUniforms& _uniforms);
 
+    /*  Whether the values last uploaded through _uniforms are still
+     *  current, letting the caller skip setupProgram altogether. Tags
+     *  the uniforms as current on a miss, so call it once per frame and
+     *  follow a false return with setupProgram. Non-ambient lights are
+     *  re-sent whenever the view changed, since their direction or
+     *  position is transformed into camera space per frame. */
+    bool upToDate(const View& _view, LightUniforms& _uniforms);
+
     /*  STATIC Function that compose sourceBlocks with Lights on a ProgramShader */
     static void assembleLights(std::map<std::string, std::vector<std::string>>& _sourceBlocks);
 
@@ -143,6 +161,10 @@ protected:
     /*  This determines if postion and direction of the light is related to the camera, ground or world */
     LightOrigin m_origin;
 
+    /*  Bumped by every setter here and in the subclasses; paired with
+     *  the tags in LightUniforms for change detection */
+    int64_t m_generation = 1;
+
     bool m_dynamic;
 
 };
@@ -23,19 +23,23 @@ PointLight::PointLight(const std::string& _name, bool _dynamic) :
 PointLight::~PointLight() {}
 
 void PointLight::setPosition(UnitVec<glm::vec3> pos) {
+    m_generation++;
     m_position = pos;
 }
 
 void PointLight::setAttenuation(float _att) {
+    m_generation++;
     m_attenuation = _att;
 }
 
 void PointLight::setRadius(float _outer) {
+    m_generation++;
     m_innerRadius = 0.0;
     m_outerRadius = _outer;
 }
 
 void PointLight::setRadius(float _inner, float _outer) {
+    m_generation++;
     m_innerRadius = _inner;
     m_outerRadius = _outer;
 }
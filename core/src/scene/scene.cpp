@@ -2,6 +2,7 @@
 
 #include "data/dataSource.h"
 #include "gl/shaderProgram.h"
+#include "gl/texture.h"
 #include "platform.h"
 #include "scene/dataLayer.h"
 #include "scene/light.h"
@@ -19,16 +20,18 @@
 #include <atomic>
 #include <algorithm>
 #include <regex>
+#include <set>
 
 namespace Tangram {
 
 static std::atomic<int32_t> s_serial;
 
-Scene::Scene(const std::string& _path)
+Scene::Scene(const std::string& _path, std::shared_ptr<FontContext> _fontContext)
     : id(s_serial++),
       m_path(_path),
-      m_fontContext(std::make_shared<FontContext>()),
-      m_featureSelection(std::make_unique<FeatureSelection>()) {
+      m_fontContext(_fontContext ? std::move(_fontContext)
+                                 : std::make_shared<FontContext>()),
+      m_featureSelection(std::make_shared<FeatureSelection>()) {
 
     std::regex r("^(http|https):/");
     std::smatch match;
@@ -59,7 +62,7 @@ Scene::Scene(const std::string& _path)
 
 Scene::Scene(const Scene& _other)
     : id(s_serial++),
-      m_featureSelection(std::make_unique<FeatureSelection>()) {
+      m_featureSelection(std::make_shared<FeatureSelection>()) {
 
     m_config = _other.m_config;
     m_fontContext = _other.m_fontContext;
@@ -72,7 +75,13 @@ Scene::Scene(const Scene& _other)
     m_mapProjection.reset(new MercatorProjection());
 }
 
-Scene::~Scene() {}
+Scene::~Scene() {
+    // Free the scene document in one operation on a worker; for large
+    // scenes this is the bulk of the teardown and would otherwise run on
+    // whichever thread drops the last Scene reference, usually the render
+    // thread during a scene swap.
+    releaseDocumentAsync(m_config);
+}
 
 const Style* Scene::findStyle(const std::string& _name) const {
 
@@ -132,6 +141,17 @@ std::shared_ptr<Texture> Scene::getTexture(const std::string& textureName) const
     return texIt->second;
 }
 
+size_t Scene::textureMemoryUsage() const {
+    size_t bytes = 0;
+    std::set<Texture*> counted;
+    for (const auto& entry : m_textures) {
+        if (entry.second && counted.insert(entry.second.get()).second) {
+            bytes += entry.second->gpuMemoryUsage();
+        }
+    }
+    return bytes;
+}
+
 std::shared_ptr<DataSource> Scene::getDataSource(const std::string& name) {
     auto it = std::find_if(m_dataSources.begin(), m_dataSources.end(),
                            [&](auto& s){ return s->name() == name; });
@@ -58,7 +58,10 @@ public:
         yes, no, none
     };
 
-    Scene(const std::string& _path = "");
+    // When _fontContext is given the scene shares it - the map hands
+    // its own context to every scene it loads so glyph atlases survive
+    // reloads - otherwise the scene builds a fresh one.
+    Scene(const std::string& _path = "", std::shared_ptr<FontContext> _fontContext = nullptr);
     Scene(const Scene& _other);
     ~Scene();
 
@@ -71,6 +74,7 @@ public:
     auto& styles() { return m_styles; };
     auto& lights() { return m_lights; };
     auto& textures() { return m_textures; };
+    auto& sharedTextures() { return m_sharedTextures; };
     auto& functions() { return m_jsFunctions; };
     auto& spriteAtlases() { return m_spriteAtlases; };
     auto& stops() { return m_stops; }
@@ -117,6 +121,10 @@ public:
 
     std::shared_ptr<Texture> getTexture(const std::string& name) const;
 
+    // Total GPU memory used by this scene's textures in bytes; textures
+    // deduplicated across names are counted once.
+    size_t textureMemoryUsage() const;
+
     float pixelScale() { return m_pixelScale; }
     void setPixelScale(float _scale) { m_pixelScale = _scale; }
 
@@ -140,6 +148,10 @@ private:
     std::vector<std::unique_ptr<Style>> m_styles;
     std::vector<std::unique_ptr<Light>> m_lights;
     std::unordered_map<std::string, std::shared_ptr<Texture>> m_textures;
+
+    // Textures keyed by a hash of their source content and sampling options,
+    // so the same image referenced under several names shares one GL texture.
+    std::unordered_map<uint64_t, std::shared_ptr<Texture>> m_sharedTextures;
     std::unordered_map<std::string, std::shared_ptr<SpriteAtlas>> m_spriteAtlases;
 
     // Records the YAML Nodes for which global values have been swapped; keys are
@@ -158,7 +170,7 @@ private:
 
     std::shared_ptr<FontContext> m_fontContext;
 
-    std::unique_ptr<FeatureSelection> m_featureSelection;
+    std::shared_ptr<FeatureSelection> m_featureSelection;
 
     animate m_animated = none;
 
@@ -0,0 +1,125 @@
+#include "sceneCache.h"
+
+#include "platform.h"
+#include "log.h"
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+
+namespace Tangram {
+namespace SceneCache {
+
+static std::string s_cachePath;
+
+// Bump whenever the artifact layout or the meaning of the resolved
+// configuration changes; old entries then simply miss.
+static const uint32_t format_version = 1;
+
+static const char format_magic[4] = { 'T', 'G', 'S', 'C' };
+
+struct EntryHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t size;
+};
+
+static uint64_t fnv1a(uint64_t _hash, const char* _data, size_t _size) {
+    for (size_t i = 0; i < _size; i++) {
+        _hash = (_hash ^ uint8_t(_data[i])) * 0x100000001b3;
+    }
+    return _hash;
+}
+
+// Key the entry on the scene path, the root document contents and the
+// update set. Edits to the root file miss the cache; edits to imported
+// files are deliberately not revalidated (see header).
+static std::string entryPath(const std::string& _scenePath,
+                             const std::vector<SceneUpdate>& _updates) {
+
+    uint64_t hash = 0xcbf29ce484222325;
+    hash = fnv1a(hash, _scenePath.data(), _scenePath.size());
+
+    auto root = stringFromFile(_scenePath.c_str());
+    hash = fnv1a(hash, root.data(), root.size());
+
+    for (const auto& update : _updates) {
+        hash = fnv1a(hash, update.path.data(), update.path.size());
+        hash = fnv1a(hash, update.value.data(), update.value.size());
+    }
+
+    char name[32];
+    snprintf(name, sizeof(name), "%016" PRIx64 ".tgsc", hash);
+
+    return s_cachePath + "/" + name;
+}
+
+void setCachePath(const std::string& _path) {
+    s_cachePath = _path;
+}
+
+YAML::Node loadConfig(const std::string& _scenePath,
+                      const std::vector<SceneUpdate>& _updates) {
+
+    if (s_cachePath.empty()) { return YAML::Node(YAML::NodeType::Undefined); }
+
+    auto path = entryPath(_scenePath, _updates);
+
+    FILE* file = fopen(path.c_str(), "rb");
+    if (!file) { return YAML::Node(YAML::NodeType::Undefined); }
+
+    EntryHeader header;
+    std::string document;
+
+    bool ok = fread(&header, sizeof(header), 1, file) == 1 &&
+              memcmp(header.magic, format_magic, sizeof(format_magic)) == 0 &&
+              header.version == format_version;
+    if (ok) {
+        document.resize(header.size);
+        ok = fread(&document[0], 1, document.size(), file) == document.size();
+    }
+    fclose(file);
+
+    if (ok) {
+        try {
+            return YAML::Load(document);
+        } catch (YAML::ParserException e) {
+            LOGW("Malformed scene cache entry: %s", e.what());
+            ok = false;
+        }
+    }
+
+    remove(path.c_str());
+    return YAML::Node(YAML::NodeType::Undefined);
+}
+
+void storeConfig(const std::string& _scenePath,
+                 const std::vector<SceneUpdate>& _updates,
+                 const YAML::Node& _config) {
+
+    if (s_cachePath.empty() || !_config) { return; }
+
+    auto document = YAML::Dump(_config);
+
+    auto path = entryPath(_scenePath, _updates);
+
+    FILE* file = fopen(path.c_str(), "wb");
+    if (!file) {
+        LOGW("Could not write scene cache entry: %s", path.c_str());
+        return;
+    }
+
+    EntryHeader header;
+    memcpy(header.magic, format_magic, sizeof(format_magic));
+    header.version = format_version;
+    header.size = uint32_t(document.size());
+
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+              fwrite(document.data(), 1, document.size(), file) == document.size();
+    fclose(file);
+
+    if (!ok) { remove(path.c_str()); }
+}
+
+}
+}
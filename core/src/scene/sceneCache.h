@@ -0,0 +1,44 @@
+#pragma once
+
+#include "tangram.h"
+
+#include <string>
+#include <vector>
+
+#include "yaml-cpp/yaml.h"
+
+namespace Tangram {
+
+/*
+ * SceneCache - On-disk cache of resolved scene configurations, keyed by a
+ * hash of the scene path, the root document contents and the applied scene
+ * updates. A cached entry holds the configuration after imports have been
+ * fetched and merged and updates applied, so warm launches fetch and parse
+ * a single document instead of the whole import graph. The cache is
+ * inactive until the host application provides a writable directory with
+ * setCachePath().
+ *
+ * Changes to the root scene file invalidate its entries; changes to
+ * imported files do not, since revalidating them would mean fetching them
+ * again. Hosts that edit imports should clear the cache directory.
+ */
+namespace SceneCache {
+
+/* Set the directory used to store resolved configurations; an empty string
+ * disables the cache. The directory must already exist and be writable. */
+void setCachePath(const std::string& _path);
+
+/* Load the resolved configuration for this scene and update set; returns a
+ * null node when the cache is disabled, has no matching entry, or the entry
+ * is malformed (the stale entry is then removed). */
+YAML::Node loadConfig(const std::string& _scenePath,
+                      const std::vector<SceneUpdate>& _updates);
+
+/* Store a resolved configuration - imports merged and updates applied. */
+void storeConfig(const std::string& _scenePath,
+                 const std::vector<SceneUpdate>& _updates,
+                 const YAML::Node& _config);
+
+}
+
+}
@@ -9,10 +9,12 @@ SceneLayer::SceneLayer(std::string _name, Filter _filter,
                        std::vector<SceneLayer> _sublayers,
                        bool _visible) :
     m_filter(std::move(_filter)),
+    m_filterProgram(m_filter),
     m_name(_name),
     m_rules(_rules),
     m_sublayers(std::move(_sublayers)),
-    m_visible(_visible) {
+    m_visible(_visible),
+    m_requiredKeysBloom(m_filter.requiredKeysBloom()) {
 
     setDepth(1);
 
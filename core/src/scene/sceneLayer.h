@@ -14,11 +14,13 @@ struct Feature;
 class SceneLayer {
 
     Filter m_filter;
+    FilterProgram m_filterProgram;
     std::string m_name;
     std::vector<DrawRuleData> m_rules;
     std::vector<SceneLayer> m_sublayers;
     size_t m_depth = 0;
     bool m_visible;
+    uint64_t m_requiredKeysBloom = 0;
 
 public:
 
@@ -29,11 +31,20 @@ public:
 
     const auto& name() const { return m_name; }
     const auto& filter() const { return m_filter; }
+    const auto& filterProgram() const { return m_filterProgram; }
     const auto& rules() const { return m_rules; }
     const auto& sublayers() const { return m_sublayers; }
+
+    // Mutable access for scene-load passes that rewrite rule parameters
+    auto& rules() { return m_rules; }
+    auto& sublayers() { return m_sublayers; }
     const auto& depth() const { return m_depth; }
     const auto& visible() const { return m_visible; }
 
+    // Property keys this layer's filter requires of a feature, as a
+    // bloom mask over key hashes; see Filter::requiredKeysBloom()
+    uint64_t requiredKeysBloom() const { return m_requiredKeysBloom; }
+
     void setDepth(size_t _d);
 };
 
@@ -5,8 +5,10 @@
 #include "data/clientGeoJsonSource.h"
 #include "data/geoJsonSource.h"
 #include "data/mvtSource.h"
+#include "data/packedTileSource.h"
 #include "data/topoJsonSource.h"
 #include "data/rasterSource.h"
+#include "data/urlRequestRegistry.h"
 #include "gl/shaderProgram.h"
 #include "style/material.h"
 #include "style/polygonStyle.h"
@@ -19,11 +21,14 @@
 #include "scene/dataLayer.h"
 #include "scene/filters.h"
 #include "scene/importer.h"
+#include "scene/sceneCache.h"
 #include "scene/sceneLayer.h"
 #include "scene/spriteAtlas.h"
 #include "scene/stops.h"
+#include "scene/styleContext.h"
 #include "scene/styleMixer.h"
 #include "scene/styleParam.h"
+#include "tile/tileMeshCache.h"
 #include "util/base64.h"
 #include "util/yamlHelper.h"
 #include "view/view.h"
@@ -35,6 +40,7 @@
 #include <algorithm>
 #include <iterator>
 #include <regex>
+#include <thread>
 
 using YAML::Node;
 using YAML::NodeType;
@@ -54,22 +60,34 @@ std::mutex SceneLoader::m_textureMutex;
 
 bool SceneLoader::loadScene(std::shared_ptr<Scene> _scene, const std::vector<SceneUpdate>& _updates) {
 
-    Importer sceneImporter;
+    // A cached entry already has imports merged and updates applied;
+    // otherwise resolve the scene through the importer and cache the
+    // result for the next launch.
+    _scene->config() = SceneCache::loadConfig(_scene->path(), _updates);
 
-    _scene->config() = sceneImporter.applySceneImports(_scene->path(), _scene->resourceRoot());
+    if (!_scene->config()) {
 
-    if (_scene->config()) {
+        Importer sceneImporter;
 
-        applyUpdates(*_scene, _updates);
+        _scene->config() = sceneImporter.applySceneImports(_scene->path(), _scene->resourceRoot());
 
-        // Load font resources
-        _scene->fontContext()->loadFonts();
+        if (!_scene->config()) { return false; }
 
-        applyConfig(_scene);
+        applyUpdates(*_scene, _updates);
 
-        return true;
+        SceneCache::storeConfig(_scene->path(), _updates, _scene->config());
     }
-    return false;
+
+    // Bind the tile mesh cache to this scene resolution, so built tiles
+    // stored by earlier runs of the same scene can be restored.
+    TileMeshCache::setScene(_scene->path(), _updates);
+
+    // Load font resources
+    _scene->fontContext()->loadFonts();
+
+    applyConfig(_scene);
+
+    return true;
 }
 
 void SceneLoader::applyUpdates(Scene& scene, const std::vector<SceneUpdate>& updates) {
@@ -234,7 +252,9 @@ bool SceneLoader::applyConfig(const std::shared_ptr<Scene>& _scene) {
         styles[i]->setID(i);
     }
 
+    bool hasLayers = false;
     if (Node layers = config["layers"]) {
+        hasLayers = true;
         for (const auto& layer : layers) {
             try { loadLayer(layer, _scene); }
             catch (YAML::RepresentationException e) {
@@ -279,13 +299,111 @@ bool SceneLoader::applyConfig(const std::shared_ptr<Scene>& _scene) {
         _scene->animated(animated.as<bool>());
     }
 
+    // The remaining passes are independent of each other: folding pure
+    // style functions touches layer rules, stops and the scene globals
+    // with its own JS context, while the style builds assemble shader
+    // sources and vertex layouts. Run the layer-side passes on a helper
+    // thread alongside the style builds; the YAML document is only read
+    // by the helper, as all main-thread document work is done above.
+    std::thread layerFinalize([&]() {
+            if (hasLayers) {
+                foldStyleFunctions(_scene);
+            }
+
+            // All stops are in place after folding, build their
+            // per-zoom frame lookups
+            for (auto& stops : _scene->stops()) {
+                stops.buildLookup();
+            }
+        });
+
     for (auto& style : _scene->styles()) {
         style->build(*_scene);
     }
 
+    layerFinalize.join();
+
     return true;
 }
 
+static void foldLayerFunctions(SceneLayer& _layer, StyleContext& _context,
+                               Scene& _scene, int _maxZoom) {
+
+    for (auto& rule : _layer.rules()) {
+        for (auto& param : rule.parameters) {
+            if (param.function < 0) { continue; }
+
+            std::vector<StyleParam::Value> results;
+            if (!_context.probeStyleFunction(param.function, param.key,
+                                             _maxZoom, results)) {
+                continue;
+            }
+
+            bool constant = true;
+            for (const auto& value : results) {
+                if (!(value == results[0])) {
+                    constant = false;
+                    break;
+                }
+            }
+
+            if (constant) {
+                param.value = results[0];
+                param.function = -1;
+                continue;
+            }
+
+            // Zoom-dependent: rewrite as stops with one frame per integer
+            // zoom, which reproduces the sampled results exactly at the
+            // zooms draw rules are evaluated at. Width and size
+            // parameters go through unit conversions that stops built
+            // here would bypass, those stay on the JS path.
+            if (StyleParam::isWidth(param.key) || StyleParam::isSize(param.key)) {
+                continue;
+            }
+
+            std::vector<Stops::Frame> frames;
+            for (size_t z = 0; z < results.size(); z++) {
+                const auto& value = results[z];
+                if (StyleParam::isColor(param.key) && value.is<uint32_t>()) {
+                    frames.emplace_back(float(z), Color(value.get<uint32_t>()));
+                } else if (StyleParam::isOffsets(param.key) && value.is<glm::vec2>()) {
+                    frames.emplace_back(float(z), value.get<glm::vec2>());
+                } else if (value.is<float>()) {
+                    frames.emplace_back(float(z), value.get<float>());
+                } else {
+                    frames.clear();
+                    break;
+                }
+            }
+            if (frames.empty()) { continue; }
+
+            _scene.stops().push_back(Stops(frames));
+            param.stops = &(_scene.stops().back());
+            param.function = -1;
+        }
+    }
+
+    for (auto& sublayer : _layer.sublayers()) {
+        foldLayerFunctions(sublayer, _context, _scene, _maxZoom);
+    }
+}
+
+void SceneLoader::foldStyleFunctions(const std::shared_ptr<Scene>& _scene) {
+
+    // Draw rules are evaluated at the integer zoom of the tile being
+    // built, so probing each integer zoom covers the function's whole
+    // input range.
+    const int maxZoom = 24;
+
+    StyleContext context;
+    context.initFunctions(*_scene);
+
+    for (auto& layer : _scene->layers()) {
+        foldLayerFunctions(layer, context, *_scene, maxZoom);
+    }
+}
+
 void SceneLoader::loadShaderConfig(Node shaders, Style& style, const std::shared_ptr<Scene>& scene) {
 
     if (!shaders) { return; }
@@ -541,6 +659,24 @@ void SceneLoader::updateSpriteNodes(const std::string& texName,
     }
 }
 
+// Dedup key for a texture: a hash of its source bytes (or url, for remote
+// textures whose content is not known yet) folded with the sampling options,
+// so only textures that would be byte-identical on the GPU are shared.
+static uint64_t textureKey(const char* _data, size_t _length,
+        const TextureOptions& _options, bool _generateMipmaps) {
+
+    uint64_t key = 0xcbf29ce484222325;
+    auto fold = [&](const void* bytes, size_t length) {
+        for (size_t i = 0; i < length; i++) {
+            key = (key ^ static_cast<const uint8_t*>(bytes)[i]) * 0x100000001b3;
+        }
+    };
+    fold(_data, _length);
+    fold(&_options, sizeof(_options));
+    fold(&_generateMipmaps, sizeof(_generateMipmaps));
+    return key;
+}
+
 std::shared_ptr<Texture> SceneLoader::fetchTexture(const std::string& name, const std::string& url,
         const TextureOptions& options, bool generateMipmaps, const std::shared_ptr<Scene>& scene) {
 
@@ -550,6 +686,17 @@ std::shared_ptr<Texture> SceneLoader::fetchTexture(const std::string& name, cons
     std::smatch match;
     // TODO: generalize using URI handlers
     if (std::regex_search(url, match, r)) {
+        {
+            // Remote textures dedup on the url; a second name for the same
+            // url shares the texture without starting another download.
+            uint64_t key = textureKey(url.data(), url.size(), options, generateMipmaps);
+            std::lock_guard<std::mutex> lock(m_textureMutex);
+            auto& shared = scene->sharedTextures()[key];
+            if (shared) { return shared; }
+            std::vector<char> textureData = {};
+            shared = std::make_shared<Texture>(textureData, options, generateMipmaps);
+            texture = shared;
+        }
         scene->pendingTextures++;
         startUrlRequest(url, [=](std::vector<char>&& rawData) {
                 std::lock_guard<std::mutex> lock(m_textureMutex);
@@ -566,10 +713,10 @@ std::shared_ptr<Texture> SceneLoader::fetchTexture(const std::string& name, cons
                     }
                 }
             });
-        std::vector<char> textureData = {};
-        texture = std::make_shared<Texture>(textureData, options, generateMipmaps);
     } else {
 
+        std::vector<char> textureData;
+
         if (url.substr(0, 22) == "data:image/png;base64,") {
             // Skip data: prefix
             auto data = url.substr(22);
@@ -586,28 +733,30 @@ std::shared_ptr<Texture> SceneLoader::fetchTexture(const std::string& name, cons
                 LOGE("Can't decode Base64 texture");
                 return nullptr;
             }
-            texture = std::make_shared<Texture>(0, 0, options, generateMipmaps);
 
-            std::vector<char> textureData;
             auto cdata = reinterpret_cast<char*>(blob.data());
             textureData.insert(textureData.begin(), cdata, cdata + blob.size());
-            if (!texture->loadImageFromMemory(textureData)) {
-                LOGE("Invalid Base64 texture");
-            }
 
         } else {
-            auto data = bytesFromFile(url.c_str());
+            textureData = bytesFromFile(url.c_str());
 
-            if (data.size() == 0) {
+            if (textureData.size() == 0) {
                 LOGE("Can't load texture resource at url '%s'", url.c_str());
                 return nullptr;
             }
+        }
 
-            texture = std::make_shared<Texture>(0, 0, options, generateMipmaps);
-            if (!texture->loadImageFromMemory(data)) {
-                LOGE("Invalid texture data '%s'", url.c_str());
-            }
+        // Identical image bytes with identical options share one texture.
+        uint64_t key = textureKey(textureData.data(), textureData.size(), options, generateMipmaps);
+        std::lock_guard<std::mutex> lock(m_textureMutex);
+        auto& shared = scene->sharedTextures()[key];
+        if (shared) { return shared; }
+
+        texture = std::make_shared<Texture>(0, 0, options, generateMipmaps);
+        if (!texture->loadImageFromMemory(textureData)) {
+            LOGE("Invalid texture data '%s'", url.c_str());
         }
+        shared = texture;
     }
 
     return texture;
@@ -649,6 +798,14 @@ void SceneLoader::loadTexture(const std::pair<Node, Node>& node, const std::shar
         }
     }
 
+    // Sprite sheets draw as screen-space billboards at a fixed pixel
+    // size, so their mip levels are never sampled; skip building them
+    // even when the scene asks for mipmap filtering.
+    if (generateMipmaps && textureConfig["sprites"]) {
+        options.filtering.min = GL_LINEAR;
+        generateMipmaps = false;
+    }
+
     auto texture = fetchTexture(name, file, options, generateMipmaps, scene);
     if (!texture) { return; }
 
@@ -669,6 +826,16 @@ void SceneLoader::loadTexture(const std::pair<Node, Node>& node, const std::shar
                 atlas->addSpriteNode(spriteName, pos, size);
             }
         }
+
+        // Optionally repack generated sprite sheets into a tight atlas;
+        // remote textures repack once their pixels arrive.
+        if (Node repack = textureConfig["repack"]) {
+            if (repack.as<bool>(false)) {
+                atlas->setRepackOnLoad(true);
+                atlas->repack();
+            }
+        }
+
         scene->spriteAtlases()[name] = atlas;
     }
     scene->textures().emplace(name, texture);
@@ -963,12 +1130,20 @@ void SceneLoader::loadSource(const std::string& name, const Node& source, const
         if (tiled) {
             sourcePtr = std::shared_ptr<DataSource>(new GeoJsonSource(name, url, minDisplayZoom, maxDisplayZoom, maxZoom));
         } else {
-            sourcePtr = std::shared_ptr<DataSource>(new ClientGeoJsonSource(name, url, minDisplayZoom, maxDisplayZoom, maxZoom));
+            auto clientSourcePtr = new ClientGeoJsonSource(name, url, minDisplayZoom, maxDisplayZoom, maxZoom);
+            // Bound the point count of low-zoom tiles for dense layers
+            if (auto maxPointsNode = source["max_points_per_tile"]) {
+                clientSourcePtr->setMaxPointsPerTile(maxPointsNode.as<uint32_t>(0));
+            }
+            sourcePtr = std::shared_ptr<DataSource>(clientSourcePtr);
         }
     } else if (type == "TopoJSON") {
         sourcePtr = std::shared_ptr<DataSource>(new TopoJsonSource(name, url, minDisplayZoom, maxDisplayZoom, maxZoom));
     } else if (type == "MVT") {
         sourcePtr = std::shared_ptr<DataSource>(new MVTSource(name, url, minDisplayZoom, maxDisplayZoom, maxZoom));
+    } else if (type == "PackedMVT") {
+        // Offline package: one file holding all tiles, read locally
+        sourcePtr = std::shared_ptr<DataSource>(new PackedTileSource(name, url, minDisplayZoom, maxDisplayZoom, maxZoom));
     } else if (type == "Raster") {
         TextureOptions options = {GL_RGBA, GL_RGBA, {GL_LINEAR, GL_LINEAR}, {GL_CLAMP_TO_EDGE, GL_CLAMP_TO_EDGE} };
         bool generateMipmaps = false;
@@ -985,6 +1160,10 @@ void SceneLoader::loadSource(const std::string& name, const Node& source, const
     if (sourcePtr) {
         sourcePtr->setCacheSize(CACHE_SIZE);
         _scene->dataSources().push_back(sourcePtr);
+
+        // Overlap the handshake to this source's host with the rest of
+        // scene setup, so the first tile fetches hit a warm connection.
+        UrlRequestRegistry::instance().warmupHost(url);
     }
 
     if (auto rasters = source["rasters"]) {
@@ -1612,7 +1791,24 @@ SceneLayer SceneLoader::loadSublayer(Node layer, const std::string& layerName, c
                 const std::string& ruleName = ruleNode.first.Scalar();
                 int ruleId = scene->addIdForName(ruleName);
 
-                rules.push_back({ ruleName, ruleId, std::move(params) });
+                // Resolve the targeted style to its scene index now, so
+                // rule application dispatches without comparing names. A
+                // static 'style' parameter overrides the rule name; a
+                // dynamic one leaves the id unresolved (-1).
+                const std::string* styleName = &ruleName;
+                for (auto& param : params) {
+                    if (param.key == StyleParamKey::style &&
+                        param.function < 0 && !param.stops &&
+                        param.value.is<std::string>()) {
+                        styleName = &param.value.get<std::string>();
+                    }
+                }
+                int styleId = -1;
+                if (auto* style = scene->findStyle(*styleName)) {
+                    styleId = int(style->getID());
+                }
+
+                rules.push_back({ ruleName, ruleId, std::move(params), styleId });
             }
         } else if (key == "filter") {
             filter = generateFilter(member.second, *scene);
@@ -1639,6 +1835,7 @@ void SceneLoader::loadLayer(const std::pair<Node, Node>& layer, const std::share
 
     std::string source;
     std::vector<std::string> collections;
+    float simplifyTolerance = 0.f;
 
     if (Node data = layer.second["data"]) {
         if (Node data_source = data["source"]) {
@@ -1660,6 +1857,12 @@ void SceneLoader::loadLayer(const std::pair<Node, Node>& layer, const std::share
                 collections = data_layer.as<std::vector<std::string>>();
             }
         }
+
+        if (Node data_simplify = data["simplify"]) {
+            if (data_simplify.IsScalar()) {
+                simplifyTolerance = data_simplify.as<float>();
+            }
+        }
     }
 
     if (collections.empty()) {
@@ -1668,7 +1871,7 @@ void SceneLoader::loadLayer(const std::pair<Node, Node>& layer, const std::share
 
     auto sublayer = loadSublayer(layer.second, name, scene);
 
-    scene->layers().push_back({ std::move(sublayer), source, collections });
+    scene->layers().push_back({ std::move(sublayer), source, collections, simplifyTolerance });
 }
 
 void SceneLoader::loadBackground(Node background, const std::shared_ptr<Scene>& scene) {
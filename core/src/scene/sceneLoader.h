@@ -53,6 +53,9 @@ struct SceneLoader {
                                   const std::shared_ptr<Scene>& scene);
     static void loadTexture(const std::pair<Node, Node>& texture, const std::shared_ptr<Scene>& scene);
     static void loadLayer(const std::pair<Node, Node>& layer, const std::shared_ptr<Scene>& scene);
+    /* Replace feature-independent JS style functions with equivalent
+     * constants or stops, so they skip per-feature VM dispatch */
+    static void foldStyleFunctions(const std::shared_ptr<Scene>& scene);
     static void loadLight(const std::pair<Node, Node>& light, const std::shared_ptr<Scene>& scene);
     static void loadCameras(Node cameras, const std::shared_ptr<Scene>& scene);
     static void loadCamera(const Node& camera, const std::shared_ptr<Scene>& scene);
@@ -1,5 +1,9 @@
 #include "spriteAtlas.h"
 #include "platform.h"
+#include "log.h"
+
+#include <algorithm>
+#include <cmath>
 
 namespace Tangram {
 
@@ -14,7 +18,7 @@ void SpriteAtlas::addSpriteNode(const std::string& _name, glm::vec2 _origin, glm
     float uvB = 1.f - _origin.y / atlasHeight;
     float uvT = uvB - _size.y / atlasHeight;
 
-    m_spritesNodes[_name] = SpriteNode { { uvL, uvB }, { uvR, uvT }, _size, _origin };
+    m_spritesNodes[_name] = SpriteNode { { uvL, uvB }, { uvR, uvT }, _size, _origin, false };
 }
 
 bool SpriteAtlas::getSpriteNode(const std::string& _name, SpriteNode& _node) const {
@@ -29,10 +33,155 @@ bool SpriteAtlas::getSpriteNode(const std::string& _name, SpriteNode& _node) con
 
 void SpriteAtlas::updateSpriteNodes(std::shared_ptr<Texture> _texture) {
     m_texture = _texture;
+    m_repacked = false;
     for (auto& spriteNode : m_spritesNodes) {
         // Use the origin of the spriteNode set when the node was created
         addSpriteNode(spriteNode.first.k, spriteNode.second.m_origin, spriteNode.second.m_size);
     }
+
+    if (m_repackOnLoad) { repack(); }
+}
+
+bool SpriteAtlas::repack() {
+
+    if (m_repacked) { return true; }
+
+    auto& pixels = m_texture->pixelData();
+    int srcWidth = m_texture->getWidth();
+    int srcHeight = m_texture->getHeight();
+
+    // Without decoded pixels there is nothing to blit from; remote atlas
+    // textures come through here again from updateSpriteNodes once their
+    // download finished.
+    if (m_spritesNodes.empty() || srcWidth <= 0 || srcHeight <= 0 ||
+        pixels.size() != size_t(srcWidth) * srcHeight ||
+        m_texture->options().format != GL_RGBA) {
+        return false;
+    }
+
+    // One transparent pixel between sprites, so linear sampling cannot
+    // bleed across neighbors
+    const int gutter = 1;
+
+    struct Placement {
+        SpriteNode* node;
+        int w, h;     // extent in the packed atlas, after rotation
+        bool rotated;
+        int x, y;
+    };
+
+    std::vector<Placement> placements;
+    placements.reserve(m_spritesNodes.size());
+
+    long area = 0;
+    int width = 0;
+
+    for (auto& entry : m_spritesNodes) {
+        auto& node = entry.second;
+        int w = int(node.m_size.x);
+        int h = int(node.m_size.y);
+
+        if (w <= 0 || h <= 0 ||
+            int(node.m_origin.x) + w > srcWidth ||
+            int(node.m_origin.y) + h > srcHeight) {
+            LOGW("Sprite '%s' outside its atlas texture, not repacking",
+                 entry.first.k.c_str());
+            return false;
+        }
+
+        // Lay the longer side horizontally, so the shelves stay shallow
+        bool rotated = h > w;
+        Placement p { &node, rotated ? h : w, rotated ? w : h, rotated, 0, 0 };
+
+        area += long(p.w + gutter) * (p.h + gutter);
+        width = std::max(width, p.w);
+        placements.push_back(p);
+    }
+
+    // Shelf packing: aim at a square atlas, sort by placed height and
+    // fill rows left to right.
+    width = std::max(width, int(std::ceil(std::sqrt(double(area)))));
+
+    std::sort(placements.begin(), placements.end(),
+              [](const Placement& a, const Placement& b) {
+                  if (a.h != b.h) { return a.h > b.h; }
+                  return a.w > b.w;
+              });
+
+    int x = 0;
+    int y = 0;
+    int shelf = 0;
+
+    for (auto& p : placements) {
+        if (x + p.w > width) {
+            x = 0;
+            y += shelf;
+            shelf = 0;
+        }
+        p.x = x;
+        p.y = y;
+        x += p.w + gutter;
+        shelf = std::max(shelf, p.h + gutter);
+    }
+    int height = y + shelf;
+
+    if (long(width) * height >= long(srcWidth) * srcHeight) {
+        // The authored sheet is already at least as tight
+        return false;
+    }
+
+    std::vector<GLuint> packed(size_t(width) * height, 0);
+
+    // Rows are stored bottom-up; address pixels in image space (y down
+    // from the top) to match the authored sprite origins.
+    auto src = [&](int _x, int _y) {
+        return pixels[size_t(srcHeight - 1 - _y) * srcWidth + _x];
+    };
+
+    for (auto& p : placements) {
+        int originX = int(p.node->m_origin.x);
+        int originY = int(p.node->m_origin.y);
+
+        for (int row = 0; row < p.h; row++) {
+            GLuint* dst = &packed[size_t(height - 1 - (p.y + row)) * width + p.x];
+
+            if (!p.rotated) {
+                for (int col = 0; col < p.w; col++) {
+                    dst[col] = src(originX + col, originY + row);
+                }
+            } else {
+                // Stored rotated 90 degrees clockwise: the sprite's
+                // columns become the placement's rows
+                for (int col = 0; col < p.w; col++) {
+                    dst[col] = src(originX + row, originY + p.w - 1 - col);
+                }
+            }
+        }
+    }
+
+    auto texture = std::make_shared<Texture>(width, height, m_texture->options());
+    texture->setData(packed.data(), packed.size());
+
+    LOG("Repacked sprite atlas %dx%d into %dx%d", srcWidth, srcHeight, width, height);
+
+    m_texture = texture;
+
+    // Remap the UVs onto the packed layout. The authored origins and
+    // sizes are kept, so updateSpriteNodes can always regenerate the
+    // nodes against a reloaded source texture.
+    for (auto& p : placements) {
+        auto& node = *p.node;
+        float uvL = p.x / float(width);
+        float uvR = (p.x + p.w) / float(width);
+        float uvB = 1.f - p.y / float(height);
+        float uvT = uvB - p.h / float(height);
+        node.m_uvBL = { uvL, uvB };
+        node.m_uvTR = { uvR, uvT };
+        node.m_rotated = p.rotated;
+    }
+
+    m_repacked = true;
+    return true;
 }
 
 void SpriteAtlas::bind(RenderState& rs, GLuint _slot) {
@@ -13,6 +13,10 @@ struct SpriteNode {
     glm::vec2 m_uvTR;
     glm::vec2 m_size;
     glm::vec2 m_origin;
+    // Whether repacking stored this sprite rotated 90 degrees clockwise;
+    // consumers then assign the quad corner UVs rotated to match (see
+    // PointStyleBuilder::addLabel)
+    bool m_rotated;
 };
 
 class SpriteAtlas {
@@ -25,6 +29,18 @@ public:
     bool getSpriteNode(const std::string& _name, SpriteNode& _node) const;
     void updateSpriteNodes(std::shared_ptr<Texture> _texture);
 
+    /* Repack the sprites into a tight atlas texture with shelf packing,
+     * rotating sprites where that lays them flatter; generated sheets
+     * often waste a third of their pixels. The node UVs are remapped in
+     * place, so consumers pick up the new layout transparently. Returns
+     * false when the texture pixels are not available (yet) or the
+     * authored sheet is already at least as tight. */
+    bool repack();
+
+    /* Whether to repack whenever the atlas texture (re)loads; remote
+     * atlas textures have no pixels until their download finishes */
+    void setRepackOnLoad(bool _repack) { m_repackOnLoad = _repack; }
+
     /* Bind the atlas in the driver */
     void bind(RenderState& rs, GLuint _slot);
 
@@ -33,6 +49,9 @@ public:
 private:
     fastmap<std::string, SpriteNode> m_spritesNodes;
     std::shared_ptr<Texture> m_texture;
+
+    bool m_repackOnLoad = false;
+    bool m_repacked = false;
 };
 
 }
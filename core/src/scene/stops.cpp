@@ -389,10 +389,35 @@ auto Stops::evalSize(float _key) const -> StyleParam::Value {
 
 auto Stops::nearestHigherFrame(float _key) const -> std::vector<Frame>::const_iterator {
 
+    if (!zoomLookup.empty()) {
+        int zoom = int(_key);
+        if (zoom < 0) { zoom = 0; }
+        if (zoom > max_lookup_zoom) { zoom = max_lookup_zoom; }
+
+        // The table entry holds the result for the integer zoom; frames
+        // with non-integer keys inside the interval need at most a few
+        // steps from there.
+        auto it = frames.begin() + zoomLookup[zoom];
+        while (it != frames.end() && it->key < _key) { ++it; }
+        return it;
+    }
+
     return std::lower_bound(frames.begin(), frames.end(), _key,
                             [](const Frame& f, float z) { return f.key < z; });
 }
 
+void Stops::buildLookup() {
+
+    zoomLookup.clear();
+    zoomLookup.reserve(max_lookup_zoom + 1);
+
+    uint16_t index = 0;
+    for (int zoom = 0; zoom <= max_lookup_zoom; zoom++) {
+        while (index < frames.size() && frames[index].key < float(zoom)) { index++; }
+        zoomLookup.push_back(index);
+    }
+}
+
 void Stops::eval(const Stops& _stops, StyleParamKey _key, float _zoom, StyleParam::Value& _result) {
     if (StyleParam::isColor(_key)) {
         _result = _stops.evalColor(_zoom);
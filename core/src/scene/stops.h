@@ -27,6 +27,14 @@ struct Stops {
     };
 
     std::vector<Frame> frames;
+
+    // Dense per-zoom index into <frames>, built once the scene is
+    // loaded: evaluation starts at the frame its integer zoom maps to
+    // instead of binary-searching the frame list per call.
+    std::vector<uint16_t> zoomLookup;
+
+    static constexpr int max_lookup_zoom = 24;
+
     static Stops Colors(const YAML::Node& _node);
     static Stops Widths(const YAML::Node& _node, const MapProjection& _projection, const std::vector<Unit>& _units);
     static Stops FontSize(const YAML::Node& _node);
@@ -46,6 +54,10 @@ struct Stops {
     auto evalSize(float _key) const -> StyleParam::Value;
     auto nearestHigherFrame(float _key) const -> std::vector<Frame>::const_iterator;
 
+    /* Build <zoomLookup> from the current frames; called at scene load
+     * after all frames are in place */
+    void buildLookup();
+
     static void eval(const Stops& _stops, StyleParamKey _key, float _zoom, StyleParam::Value& _result);
 };
 
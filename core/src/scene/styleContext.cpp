@@ -3,6 +3,7 @@
 #include "platform.h"
 #include "data/propertyItem.h"
 #include "data/tileData.h"
+#include "debug/jsProfiler.h"
 #include "scene/filters.h"
 #include "scene/scene.h"
 #include "util/builders.h"
@@ -10,6 +11,10 @@
 
 #include "duktape.h"
 
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+
 #define DUMP(...) // do { logMsg(__VA_ARGS__); duk_dump_context_stderr(m_ctx); } while(0)
 #define DBG(...) do { logMsg(__VA_ARGS__); duk_dump_context_stderr(m_ctx); } while(0)
 
@@ -29,8 +34,27 @@ static const std::vector<std::string> s_geometryStrings = {
     "polygon",
 };
 
+// Initialized duktape heaps pooled across StyleContext instances: a
+// scene swap tears down and recreates every worker's context, and
+// duk_create_heap rebuilding all the ECMAScript built-ins dominates
+// that cost. Pooled heaps keep their built-ins; scene-bound globals are
+// scrubbed when a heap is returned and the adopting context re-binds
+// its own feature proxy and function set.
+static std::mutex s_heapPoolMutex;
+static std::vector<duk_context*> s_heapPool;
+static constexpr size_t max_pooled_heaps = 8;
+
 StyleContext::StyleContext() {
-    m_ctx = duk_create_heap_default();
+
+    m_ctx = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(s_heapPoolMutex);
+        if (!s_heapPool.empty()) {
+            m_ctx = s_heapPool.back();
+            s_heapPool.pop_back();
+        }
+    }
+    if (!m_ctx) { m_ctx = duk_create_heap_default(); }
 
     //// Create global geometry constants
     // TODO make immutable
@@ -80,7 +104,25 @@ StyleContext::StyleContext() {
 }
 
 StyleContext::~StyleContext() {
-    duk_destroy_heap(m_ctx);
+
+    // Drop scene-bound globals so a pooled heap holds no references to
+    // the outgoing scene's functions and globals, then hand the heap
+    // back for the next scene's contexts.
+    duk_push_global_object(m_ctx);
+    duk_del_prop_string(m_ctx, -1, FUNC_ID);
+    duk_del_prop_string(m_ctx, -1, "global");
+    duk_del_prop_string(m_ctx, -1, "feature");
+    duk_pop(m_ctx);
+    duk_gc(m_ctx, 0);
+
+    {
+        std::lock_guard<std::mutex> lock(s_heapPoolMutex);
+        if (s_heapPool.size() < max_pooled_heaps) {
+            s_heapPool.push_back(m_ctx);
+            m_ctx = nullptr;
+        }
+    }
+    if (m_ctx) { duk_destroy_heap(m_ctx); }
 }
 
 // Convert a scalar node to a boolean, double, or string (in that order)
@@ -200,6 +242,8 @@ bool StyleContext::setFunctions(const std::vector<std::string>& _functions) {
 
     m_functionCount = id;
 
+    m_functionCache.assign(size_t(m_functionCount), FunctionCache{});
+
     DUMP("setFunctions\n");
     return ok;
 }
@@ -231,6 +275,8 @@ bool StyleContext::addFunction(const std::string& _function) {
     // Pop the functions array off the stack
     duk_pop(m_ctx);
 
+    m_functionCache.emplace_back();
+
     return ok;
 }
 
@@ -283,9 +329,26 @@ const Value& StyleContext::getKeyword(const std::string& _key) const {
 
 void StyleContext::clear() {
     m_feature = nullptr;
+    m_currentLayer = nullptr;
 }
 
 bool StyleContext::evalFunction(FunctionID id) {
+
+    // Memoized results skip this function entirely, so every call here
+    // is a real VM invocation - exactly what the profiler should count.
+    if (JsProfiler::isEnabled()) {
+        auto start = std::chrono::steady_clock::now();
+        bool result = evalFunctionImpl(id);
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        JsProfiler::record(id, m_currentLayer, ns);
+        return result;
+    }
+
+    return evalFunctionImpl(id);
+}
+
+bool StyleContext::evalFunctionImpl(FunctionID id) {
     // Get all functions (array) in context
     if (!duk_get_global_string(m_ctx, FUNC_ID)) {
         LOGE("EvalFilterFn - functions array not initialized");
@@ -314,8 +377,121 @@ bool StyleContext::evalFunction(FunctionID id) {
     return true;
 }
 
+// Append a tagged value to the cache key, so values of different types
+// never collide.
+static void appendCacheValue(std::string& _key, const Value& _value) {
+    if (_value.is<std::string>()) {
+        _key += 's';
+        _key += _value.get<std::string>();
+    } else if (_value.is<double>()) {
+        double num = _value.get<double>();
+        _key += 'd';
+        _key.append(reinterpret_cast<const char*>(&num), sizeof(num));
+    } else {
+        _key += 'u';
+    }
+    _key += '\x1f';
+}
+
+const std::string& StyleContext::cacheKey(const FunctionCache& _cache, char _prefix) const {
+
+    std::string& key = m_cacheKeyScratch;
+    key.clear();
+    key += _prefix;
+    key += char(m_keywordGeom);
+    key += '\x1f';
+    appendCacheValue(key, getKeyword(FilterKeyword::zoom));
+
+    for (const auto& prop : _cache.keys) {
+        appendCacheValue(key, m_feature->props.get(prop.first, prop.second));
+    }
+    return key;
+}
+
+bool StyleContext::recordAccessedKeys(FunctionCache& _cache) {
+
+    bool grown = false;
+    for (const auto& prop : m_accessedProps) {
+        auto it = std::find_if(_cache.keys.begin(), _cache.keys.end(),
+                               [&](const auto& entry) { return entry.first == prop; });
+        if (it == _cache.keys.end()) {
+            _cache.keys.push_back({ prop, Properties::keyHash(prop) });
+            grown = true;
+        }
+    }
+    if (grown) {
+        // Earlier entries were keyed on fewer properties and may alias
+        // features that differ on the new ones.
+        _cache.filterResults.clear();
+        _cache.styleResults.clear();
+    }
+    return grown;
+}
+
+bool StyleContext::probeStyleFunction(FunctionID _id, StyleParamKey _key, int _maxZoom,
+                                      std::vector<StyleParam::Value>& _results) {
+
+    // Probe with an empty feature: property reads go through the proxy
+    // and are recorded in m_accessedProps. The geometry keyword is read
+    // as a plain global and cannot be trapped, so each zoom is probed
+    // once per geometry type and differing results disqualify.
+    Feature probe;
+    m_feature = &probe;
+
+    bool pure = true;
+    _results.clear();
+
+    for (int zoom = 0; zoom <= _maxZoom && pure; zoom++) {
+        setKeywordZoom(zoom);
+
+        for (int geom = 0; geom < int(s_geometryStrings.size()); geom++) {
+            setKeyword(key_geom, s_geometryStrings[geom]);
+
+            m_accessedProps.clear();
+
+            if (!evalFunction(_id)) {
+                pure = false;
+                break;
+            }
+
+            StyleParam::Value value = none_type{};
+            parseStyleResult(_key, value);
+            duk_pop(m_ctx);
+
+            if (!m_accessedProps.empty() ||
+                value.is<none_type>() || value.is<Undefined>()) {
+                pure = false;
+                break;
+            }
+
+            if (geom == 0) {
+                _results.push_back(std::move(value));
+            } else if (!(_results.back() == value)) {
+                pure = false;
+                break;
+            }
+        }
+    }
+
+    m_feature = nullptr;
+    m_keywordGeom = -1;
+
+    return pure;
+}
+
 bool StyleContext::evalFilter(FunctionID _id) {
 
+    FunctionCache* cache = nullptr;
+
+    if (m_feature && _id < m_functionCache.size()) {
+        cache = &m_functionCache[_id];
+
+        auto it = cache->filterResults.find(cacheKey(*cache, 0));
+        if (it != cache->filterResults.end()) { return it->second; }
+    }
+
+    m_accessedProps.clear();
+
     if (!evalFunction(_id)) { return false; };
 
     // Evaluate the "truthiness" of the function result at the top of the stack.
@@ -324,11 +500,35 @@ bool StyleContext::evalFilter(FunctionID _id) {
     // pop result
     duk_pop(m_ctx);
 
+    if (cache) {
+        recordAccessedKeys(*cache);
+        if (cache->filterResults.size() >= max_function_cache_entries) {
+            cache->filterResults.clear();
+        }
+        // The key is copied into the map only on this miss; hits above
+        // never allocate.
+        cache->filterResults.emplace(cacheKey(*cache, 0), result);
+    }
+
     return result;
 }
 
 bool StyleContext::evalStyle(FunctionID _id, StyleParamKey _key, StyleParam::Value& _val) {
 
+    FunctionCache* cache = nullptr;
+
+    if (m_feature && _id < m_functionCache.size()) {
+        cache = &m_functionCache[_id];
+
+        auto it = cache->styleResults.find(cacheKey(*cache, char(_key)));
+        if (it != cache->styleResults.end()) {
+            _val = it->second;
+            return !_val.is<none_type>();
+        }
+    }
+
+    m_accessedProps.clear();
+
     if (!evalFunction(_id)) { return false; }
 
     // parse evaluated result at stack top
@@ -337,6 +537,14 @@ bool StyleContext::evalStyle(FunctionID _id, StyleParamKey _key, StyleParam::Val
     // pop result, empty stack
     duk_pop(m_ctx);
 
+    if (cache) {
+        recordAccessedKeys(*cache);
+        if (cache->styleResults.size() >= max_function_cache_entries) {
+            cache->styleResults.clear();
+        }
+        cache->styleResults.emplace(cacheKey(*cache, char(_key)), _val);
+    }
+
     return !_val.is<none_type>();
 }
 
@@ -444,6 +652,17 @@ void StyleContext::parseStyleResult(StyleParamKey _key, StyleParam::Value& _val)
                 _val = static_cast<float>(duk_get_number(m_ctx, -1));
                 break;
             }
+            case StyleParamKey::text_source:
+            case StyleParamKey::sprite:
+            case StyleParamKey::sprite_default:
+            case StyleParamKey::text_repeat_group: {
+                // Numeric results resolve directly to their digit
+                // string; authors previously had to stringify numbers
+                // inside the function, paying a JS round-trip per
+                // feature.
+                _val = numberToString(duk_get_number(m_ctx, -1));
+                break;
+            }
             case StyleParamKey::order:
             case StyleParamKey::outline_order:
             case StyleParamKey::priority:
@@ -480,6 +699,9 @@ duk_ret_t StyleContext::jsHasProperty(duk_context *_ctx) {
     }
 
     const char* key = duk_require_string(_ctx, 1);
+
+    attr->m_accessedProps.emplace_back(key);
+
     duk_push_boolean(_ctx, attr->m_feature->props.contains(key));
 
     return 1;
@@ -500,6 +722,8 @@ duk_ret_t StyleContext::jsGetProperty(duk_context *_ctx) {
     // Get the property name (second parameter)
     const char* key = duk_require_string(_ctx, 1);
 
+    attr->m_accessedProps.emplace_back(key);
+
     auto it = attr->m_feature->props.get(key);
     if (it.is<std::string>()) {
         duk_push_string(_ctx, it.get<std::string>().c_str());
@@ -8,6 +8,7 @@
 #include <memory>
 #include <array>
 #include <unordered_map>
+#include <vector>
 
 struct duk_hthread;
 typedef struct duk_hthread duk_context;
@@ -58,11 +59,29 @@ public:
     /* Called from DrawRule::eval */
     bool evalStyle(FunctionID id, StyleParamKey _key, StyleParam::Value& _val);
 
+    /*
+     * Evaluate a style function over the integer zoom range with no
+     * feature set. Returns false when the function reads feature
+     * properties, depends on the geometry keyword or fails to produce a
+     * usable result; otherwise fills one parsed result per zoom in
+     * [0, _maxZoom]. Used by SceneLoader to fold pure functions into
+     * constants or stops at scene load.
+     */
+    bool probeStyleFunction(FunctionID _id, StyleParamKey _key, int _maxZoom,
+                            std::vector<StyleParam::Value>& _results);
+
     /*
      * Setup filter and style functions from @_scene
      */
     void initFunctions(const Scene& _scene);
 
+    /*
+     * Set the data layer whose rules are being evaluated, for the JS
+     * invocation profiler; the pointed-to name must outlive the
+     * evaluation. Pass null outside of layer matching.
+     */
+    void setCurrentLayer(const std::string* _layerName) { m_currentLayer = _layerName; }
+
     /*
      * Unset Feature handle
      */
@@ -75,11 +94,35 @@ public:
     void setKeyword(const std::string& _key, Value _value);
     const Value& getKeyword(const std::string& _key) const;
 
+    /* Maximum number of memoized results kept per function */
+    static constexpr size_t max_function_cache_entries = 4096;
+
 private:
     static int jsGetProperty(duk_context *_ctx);
     static int jsHasProperty(duk_context *_ctx);
 
+    // Memoized results of one JS function. Functions read feature data
+    // only through the property proxy, so the properties each function
+    // accesses are recorded on evaluation; results are keyed by the
+    // values of those properties plus the zoom and geometry keywords,
+    // and features with identical inputs skip the duktape VM entirely.
+    struct FunctionCache {
+        // Properties the function has been observed to read, with their
+        // key hash resolved once so lookups do not re-hash per feature.
+        // Cached results are keyed on the property values, so all
+        // entries are dropped whenever this set grows.
+        std::vector<std::pair<std::string, uint32_t>> keys;
+        std::unordered_map<std::string, bool> filterResults;
+        std::unordered_map<std::string, StyleParam::Value> styleResults;
+    };
+
+    /* Build the memoization key for the current feature into
+     * m_cacheKeyScratch; valid until the next call */
+    const std::string& cacheKey(const FunctionCache& _cache, char _prefix) const;
+    bool recordAccessedKeys(FunctionCache& _cache);
+
     bool evalFunction(FunctionID id);
+    bool evalFunctionImpl(FunctionID id);
     void parseStyleResult(StyleParamKey _key, StyleParam::Value& _val) const;
     void parseSceneGlobals(const YAML::Node& node);
 
@@ -93,6 +136,18 @@ private:
 
     const Feature* m_feature = nullptr;
 
+    const std::string* m_currentLayer = nullptr;
+
+    std::vector<FunctionCache> m_functionCache;
+
+    // Properties read by the function currently being evaluated;
+    // filled from the property proxy callbacks.
+    mutable std::vector<std::string> m_accessedProps;
+
+    // Reused between evaluations so building a key allocates nothing
+    // once it has grown to its working size.
+    mutable std::string m_cacheKeyScratch;
+
     mutable duk_context *m_ctx;
 };
 
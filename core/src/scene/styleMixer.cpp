@@ -4,10 +4,30 @@
 #include "yaml-cpp/yaml.h"
 
 #include <algorithm>
+#include <mutex>
 #include <set>
+#include <unordered_map>
 
 namespace Tangram {
 
+// Mixed-style results from previous loads, serialized so that no yaml-cpp
+// node is ever shared between scene-loading threads. Scene reloads that only
+// change a data source URL hit this cache and skip the mixing cascade.
+static std::mutex s_mixCacheMutex;
+static std::unordered_map<uint64_t, std::string> s_mixCache;
+static constexpr size_t max_cached_mixes = 16;
+
+uint64_t StyleMixer::stylesKey(const Node& _styles) {
+
+    std::string dump = YAML::Dump(_styles);
+
+    uint64_t key = 0xcbf29ce484222325;
+    for (char c : dump) {
+        key = (key ^ static_cast<uint8_t>(c)) * 0x100000001b3;
+    }
+    return key;
+}
+
 std::vector<std::string> StyleMixer::getStylesToMix(const Node& _style) {
 
     std::vector<std::string> names;
@@ -55,6 +75,18 @@ std::vector<std::string> StyleMixer::getMixingOrder(const Node& _styles) {
 
 void StyleMixer::mixStyleNodes(Node _styles) {
 
+    uint64_t key = 0;
+    if (_styles.IsMap()) {
+        key = stylesKey(_styles);
+
+        std::lock_guard<std::mutex> lock(s_mixCacheMutex);
+        auto cached = s_mixCache.find(key);
+        if (cached != s_mixCache.end()) {
+            _styles = YAML::Load(cached->second);
+            return;
+        }
+    }
+
     // First determine the order of nodes to evaluate.
     auto styleNamesSorted = getMixingOrder(_styles);
 
@@ -84,6 +116,12 @@ void StyleMixer::mixStyleNodes(Node _styles) {
 
         applyStyleMixins(style, mixins);
     }
+
+    if (_styles.IsMap()) {
+        std::lock_guard<std::mutex> lock(s_mixCacheMutex);
+        if (s_mixCache.size() >= max_cached_mixes) { s_mixCache.clear(); }
+        s_mixCache[key] = YAML::Dump(_styles);
+    }
 }
 
 void StyleMixer::applyStyleMixins(Node _style, const std::vector<Node>& _mixins) {
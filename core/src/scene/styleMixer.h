@@ -24,8 +24,15 @@ public:
     // 'b', 'b' will always precede 'a' in the sequence.
     std::vector<std::string> getMixingOrder(const Node& _styles);
 
+    // Hash of a styles subtree; the key under which mixStyleNodes caches
+    // its results. Exposed so tooling can compute the key for a scene and
+    // pre-warm the cache.
+    static uint64_t stylesKey(const Node& _styles);
+
     // Apply mixing to all styles in the input map with modifications in-place
-    // unless otherwise noted.
+    // unless otherwise noted. Results are cached per stylesKey across
+    // instances, so reloading a scene with an unchanged styles subtree
+    // skips the mixing cascade.
     void mixStyleNodes(Node _styles);
 
     // Apply the given list of 'mixin' styles to the first style.
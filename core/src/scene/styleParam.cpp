@@ -217,9 +217,22 @@ StyleParam::Value StyleParam::parseString(StyleParamKey key, const std::string&
         }
         return anchors;
     }
-    case StyleParamKey::text_align:
+    case StyleParamKey::text_transform: {
+        TextLabelProperty::Transform transform = TextLabelProperty::Transform::none;
+        if (!TextLabelProperty::transform(_value, transform)) {
+            LOGW("Invalid text transform '%s'", _value.c_str());
+        }
+        return static_cast<uint32_t>(transform);
+    }
+    case StyleParamKey::text_align: {
+        TextLabelProperty::Align align;
+        if (TextLabelProperty::align(_value, align)) {
+            return static_cast<uint32_t>(align);
+        }
+        LOGW("Invalid text align '%s'", _value.c_str());
+        break;
+    }
     case StyleParamKey::text_source:
-    case StyleParamKey::text_transform:
     case StyleParamKey::sprite:
     case StyleParamKey::sprite_default:
     case StyleParamKey::style:
@@ -360,13 +373,11 @@ std::string StyleParam::toString() const {
     case StyleParamKey::text_font_weight:
     case StyleParamKey::text_font_style:
     case StyleParamKey::text_source:
-    case StyleParamKey::text_transform:
     case StyleParamKey::text_wrap:
     case StyleParamKey::text_repeat_group:
     case StyleParamKey::sprite:
     case StyleParamKey::sprite_default:
     case StyleParamKey::style:
-    case StyleParamKey::text_align:
         if (!value.is<std::string>()) break;
         return k + value.get<std::string>();
     case StyleParamKey::anchor:
@@ -406,6 +417,8 @@ std::string StyleParam::toString() const {
     case StyleParamKey::outline_cap:
     case StyleParamKey::join:
     case StyleParamKey::outline_join:
+    case StyleParamKey::text_transform:
+    case StyleParamKey::text_align:
         if (!value.is<uint32_t>()) break;
         return k + std::to_string(value.get<uint32_t>());
     case StyleParamKey::miter_limit:
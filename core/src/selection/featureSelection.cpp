@@ -8,6 +8,16 @@ FeatureSelection::FeatureSelection() :
 
 uint32_t FeatureSelection::nextColorIdentifier() {
 
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (!m_freeEntries.empty()) {
+            uint32_t entry = m_freeEntries.front();
+            m_freeEntries.pop_front();
+            return entry;
+        }
+    }
+
     uint32_t entry = m_entry++;
 
     // skip zero every 2^32 features
@@ -18,4 +28,20 @@ uint32_t FeatureSelection::nextColorIdentifier() {
     return entry;
 }
 
+void FeatureSelection::reserveColorIdentifiers(uint32_t _maxEntry) {
+
+    uint32_t current = m_entry;
+    while (current <= _maxEntry &&
+           !m_entry.compare_exchange_weak(current, _maxEntry + 1)) {}
+}
+
+void FeatureSelection::releaseColorIdentifier(uint32_t _entry) {
+
+    if (_entry == 0) { return; }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_freeEntries.push_back(_entry);
+}
+
 }
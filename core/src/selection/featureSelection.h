@@ -1,6 +1,8 @@
 #pragma once
 
 #include <atomic>
+#include <deque>
+#include <mutex>
 
 namespace Tangram {
 
@@ -12,10 +14,25 @@ public:
 
     uint32_t nextColorIdentifier();
 
+    /* Return an identifier to the pool once the geometry referencing it
+     * is destroyed; it will be handed out again by nextColorIdentifier */
+    void releaseColorIdentifier(uint32_t _entry);
+
+    /* Ensure identifiers up to and including _maxEntry are never handed
+     * out fresh; used for identifiers baked into restored meshes by a
+     * previous session, which this session's counter knows nothing of. */
+    void reserveColorIdentifiers(uint32_t _maxEntry);
+
 private:
 
     std::atomic<uint32_t> m_entry;
 
+    // Released identifiers, reused oldest-first so a recycled color
+    // stays out of circulation for as long as possible
+    std::deque<uint32_t> m_freeEntries;
+
+    std::mutex m_mutex;
+
 };
 
 }
@@ -1,8 +1,5 @@
 #include "selectionQuery.h"
 
-#include <array>
-
-#include "gl/framebuffer.h"
 #include "labels/label.h"
 #include "labels/labels.h"
 #include "marker/marker.h"
@@ -20,23 +17,10 @@ QueryType SelectionQuery::type() const {
           (m_queryCallback.is<LabelPickCallback>() ? QueryType::label : QueryType::marker);
 }
 
-void SelectionQuery::process(const View& _view, const FrameBuffer& _framebuffer, const MarkerManager& _markerManager,
-                             const TileManager& _tileManager, const Labels& _labels, std::vector<SelectionColorRead>& _colorCache) const {
-
-    glm::vec2 windowCoordinates = _view.normalizedWindowCoordinates(m_position.x, m_position.y);
-
-    GLuint color = 0;
+void SelectionQuery::process(const View& _view, uint32_t _color, const MarkerManager& _markerManager,
+                             const TileManager& _tileManager, const Labels& _labels) const {
 
-    auto it = std::find_if(_colorCache.begin(), _colorCache.end(), [=](const auto& _colorRead) {
-        return m_position == _colorRead.position;
-    });
-
-    if (it == _colorCache.end()) {
-        color = _framebuffer.readAt(windowCoordinates.x, windowCoordinates.y);
-        _colorCache.push_back({color, m_position});
-    } else {
-        color = it->color;
-    }
+    uint32_t color = _color;
 
     switch (type()) {
     case QueryType::feature: {
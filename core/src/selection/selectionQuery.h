@@ -20,21 +20,19 @@ enum class QueryType {
 
 using QueryCallback = variant<FeaturePickCallback, LabelPickCallback, MarkerPickCallback>;
 
-struct SelectionColorRead {
-    uint32_t color;
-    glm::vec2 position;
-};
-
 class SelectionQuery {
 
 public:
     SelectionQuery(glm::vec2 _position, QueryCallback _queryCallback);
 
-    void process(const View& _view, const FrameBuffer& _framebuffer, const MarkerManager& _markerManager,
-                 const TileManager& _tileManager, const Labels& _labels, std::vector<SelectionColorRead>& _cache) const;
+    /* Resolve the query from the selection color read back at its position */
+    void process(const View& _view, uint32_t _color, const MarkerManager& _markerManager,
+                 const TileManager& _tileManager, const Labels& _labels) const;
 
     QueryType type() const;
 
+    glm::vec2 position() const { return m_position; }
+
 private:
     glm::vec2 m_position;
     QueryCallback m_queryCallback;
@@ -13,64 +13,74 @@ Material::Material() {
 }
 
 void Material::setEmission(glm::vec4 _emission){
+    m_generation++;
     m_emission = _emission;
     m_emission_texture.tex.reset();
     setEmissionEnabled(true);
 }
 
 void Material::setEmission(MaterialTexture _emissionTexture){
+    m_generation++;
     m_emission_texture = _emissionTexture;
     m_emission = glm::vec4(m_emission_texture.amount, 1.f);
     setEmissionEnabled((bool)m_emission_texture.tex);
 }
 
 void Material::setAmbient(glm::vec4 _ambient){
+    m_generation++;
     m_ambient = _ambient;
     m_ambient_texture.tex.reset();
     setAmbientEnabled(true);
 }
 
 void Material::setAmbient(MaterialTexture _ambientTexture){
+    m_generation++;
     m_ambient_texture = _ambientTexture;
     m_ambient = glm::vec4(m_ambient_texture.amount, 1.f);
     setAmbientEnabled((bool)m_ambient_texture.tex);
 }
 
 void Material::setDiffuse(glm::vec4 _diffuse){
+    m_generation++;
     m_diffuse = _diffuse;
     m_diffuse_texture.tex.reset();
     setDiffuseEnabled(true);
 }
 
 void Material::setDiffuse(MaterialTexture _diffuseTexture){
+    m_generation++;
     m_diffuse_texture = _diffuseTexture;
     m_diffuse = glm::vec4(m_diffuse_texture.amount, 1.f);
     setDiffuseEnabled((bool)m_diffuse_texture.tex);
 }
 
 void Material::setSpecular(glm::vec4 _specular){
+    m_generation++;
     m_specular = _specular;
     m_specular_texture.tex.reset();
     setSpecularEnabled(true);
 }
 
 void Material::setSpecular(MaterialTexture _specularTexture){
+    m_generation++;
     m_specular_texture = _specularTexture;
     m_specular = glm::vec4(m_specular_texture.amount, 1.f);
     setSpecularEnabled((bool)m_specular_texture.tex);
 }
 
 void Material::setShininess(float _shiny) {
+    m_generation++;
     m_shininess = _shiny;
     setSpecularEnabled(true);
 }
 
-void Material::setEmissionEnabled(bool _enable) { m_bEmission = _enable; }
-void Material::setAmbientEnabled(bool _enable) { m_bAmbient = _enable; }
-void Material::setDiffuseEnabled(bool _enable) { m_bDiffuse = _enable; }
-void Material::setSpecularEnabled(bool _enable) { m_bSpecular = _enable; }
+void Material::setEmissionEnabled(bool _enable) { m_generation++; m_bEmission = _enable; }
+void Material::setAmbientEnabled(bool _enable) { m_generation++; m_bAmbient = _enable; }
+void Material::setDiffuseEnabled(bool _enable) { m_generation++; m_bDiffuse = _enable; }
+void Material::setSpecularEnabled(bool _enable) { m_generation++; m_bSpecular = _enable; }
 
 void Material::setNormal(MaterialTexture _normalTexture){
+    m_generation++;
     m_normal_texture = _normalTexture;
     if (m_normal_texture.mapping == MappingType::spheremap){
         m_normal_texture.mapping = MappingType::planar;
@@ -167,48 +177,59 @@ void Material::setupProgram(RenderState& rs, MaterialUniforms& _uniforms) {
 
     auto& u = _uniforms;
 
+    // Values are re-sent only when the material changed or the program
+    // was relinked, skipping the per-uniform cache lookups on steady
+    // frames entirely. Texture updates and bindings still run every
+    // frame, since the units are assigned in draw order.
+    bool dirty = (u.generation != m_generation) ||
+                 (u.buildNumber != u.shader.buildNumber());
+    u.generation = m_generation;
+    u.buildNumber = u.shader.buildNumber();
+
     if (m_bEmission) {
-        u.shader.setUniformf(rs, u.emission, m_emission);
+        if (dirty) { u.shader.setUniformf(rs, u.emission, m_emission); }
 
         if (m_emission_texture.tex) {
             m_emission_texture.tex->update(rs, rs.nextAvailableTextureUnit());
             m_emission_texture.tex->bind(rs, rs.currentTextureUnit());
             u.shader.setUniformi(rs, u.emissionTexture, rs.currentTextureUnit());
-            u.shader.setUniformf(rs, u.emissionScale, m_emission_texture.scale);
+            if (dirty) { u.shader.setUniformf(rs, u.emissionScale, m_emission_texture.scale); }
         }
     }
 
     if (m_bAmbient) {
-        u.shader.setUniformf(rs, u.ambient, m_ambient);
+        if (dirty) { u.shader.setUniformf(rs, u.ambient, m_ambient); }
 
         if (m_ambient_texture.tex) {
             m_ambient_texture.tex->update(rs, rs.nextAvailableTextureUnit());
             m_ambient_texture.tex->bind(rs, rs.currentTextureUnit());
             u.shader.setUniformi(rs, u.ambientTexture, rs.currentTextureUnit());
-            u.shader.setUniformf(rs, u.ambientScale, m_ambient_texture.scale);
+            if (dirty) { u.shader.setUniformf(rs, u.ambientScale, m_ambient_texture.scale); }
         }
     }
 
     if (m_bDiffuse) {
-        u.shader.setUniformf(rs, u.diffuse, m_diffuse);
+        if (dirty) { u.shader.setUniformf(rs, u.diffuse, m_diffuse); }
 
         if (m_diffuse_texture.tex) {
             m_diffuse_texture.tex->update(rs, rs.nextAvailableTextureUnit());
             m_diffuse_texture.tex->bind(rs, rs.currentTextureUnit());
             u.shader.setUniformi(rs, u.diffuseTexture, rs.currentTextureUnit());
-            u.shader.setUniformf(rs, u.diffuseScale, m_diffuse_texture.scale);
+            if (dirty) { u.shader.setUniformf(rs, u.diffuseScale, m_diffuse_texture.scale); }
         }
     }
 
     if (m_bSpecular) {
-        u.shader.setUniformf(rs, u.specular, m_specular);
-        u.shader.setUniformf(rs, u.shininess, m_shininess);
+        if (dirty) {
+            u.shader.setUniformf(rs, u.specular, m_specular);
+            u.shader.setUniformf(rs, u.shininess, m_shininess);
+        }
 
         if (m_specular_texture.tex) {
             m_specular_texture.tex->update(rs, rs.nextAvailableTextureUnit());
             m_specular_texture.tex->bind(rs, rs.currentTextureUnit());
             u.shader.setUniformi(rs, u.specularTexture, rs.currentTextureUnit());
-            u.shader.setUniformf(rs, u.specularScale, m_specular_texture.scale);
+            if (dirty) { u.shader.setUniformf(rs, u.specularScale, m_specular_texture.scale); }
         }
     }
 
@@ -216,8 +237,10 @@ void Material::setupProgram(RenderState& rs, MaterialUniforms& _uniforms) {
         m_normal_texture.tex->update(rs, rs.nextAvailableTextureUnit());
         m_normal_texture.tex->bind(rs, rs.currentTextureUnit());
         u.shader.setUniformi(rs, u.normalTexture, rs.currentTextureUnit());
-        u.shader.setUniformf(rs, u.normalScale, m_normal_texture.scale);
-        u.shader.setUniformf(rs, u.normalAmount, m_normal_texture.amount);
+        if (dirty) {
+            u.shader.setUniformf(rs, u.normalScale, m_normal_texture.scale);
+            u.shader.setUniformf(rs, u.normalAmount, m_normal_texture.amount);
+        }
     }
 }
 
@@ -39,6 +39,11 @@ struct MaterialUniforms {
 
     ShaderProgram& shader;
 
+    // Material generation and program build the values were last
+    // uploaded for; setupProgram re-sends them only when either moved
+    int64_t generation = -1;
+    int buildNumber = -1;
+
     UniformLocation emission{"u_material.emission"};
     UniformLocation emissionTexture{"material_emission_texture"};
     UniformLocation emissionScale{"u_material.emissionScale"};
@@ -143,6 +148,9 @@ private:
     MaterialTexture m_normal_texture;
 
     float m_shininess = .2f;
+
+    // Bumped by every setter; lets setupProgram skip unchanged values
+    int64_t m_generation = 1;
 };
 
 }
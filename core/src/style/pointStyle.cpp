@@ -58,6 +58,12 @@ void PointStyle::onBeginFrame(RenderState& rs) {
     m_textStyle->onBeginFrame(rs);
 }
 
+bool PointStyle::hasDataForFrame(const std::vector<std::shared_ptr<Tile>>& _tiles,
+                                 const std::vector<std::unique_ptr<Marker>>& _markers) const {
+
+    return m_mesh->numberOfVertices() > 0 || m_textStyle->hasDataForFrame(_tiles, _markers);
+}
+
 void PointStyle::onBeginDrawFrame(RenderState& rs, const View& _view, Scene& _scene) {
     Style::onBeginDrawFrame(rs, _view, _scene);
 
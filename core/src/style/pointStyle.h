@@ -27,6 +27,9 @@ public:
         uint32_t color = 0xffffffff;
         Label::Options labelOptions;
         float extrudeScale = 1.f;
+        // Whether the sprite is stored rotated in a repacked atlas; set
+        // by getUVQuad from the resolved SpriteNode
+        bool spriteRotated = false;
     };
 
     PointStyle(std::string _name, std::shared_ptr<FontContext> _fontContext,
@@ -34,6 +37,8 @@ public:
 
     virtual void onBeginUpdate() override;
     virtual void onBeginDrawFrame(RenderState& rs, const View& _view, Scene& _scene) override;
+    virtual bool hasDataForFrame(const std::vector<std::shared_ptr<Tile>>& _tiles,
+                                 const std::vector<std::unique_ptr<Marker>>& _markers) const override;
     virtual void onBeginFrame(RenderState& rs) override;
     virtual void onBeginDrawSelectionFrame(RenderState& rs, const View& _view, Scene& _scene) override;
     virtual void draw(RenderState& rs, const Tile& _tile) override {}
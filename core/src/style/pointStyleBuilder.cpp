@@ -216,12 +216,24 @@ void PointStyleBuilder::addLabel(const Point& _point, const glm::vec4& _quad,
         v3 = rotateBy(v3, rotation);
     }
 
-    m_quads.push_back({{
-        {v0, {uvBL.x, uvTR.y}},
-        {v1, {uvTR.x, uvTR.y}},
-        {v2, {uvBL.x, uvBL.y}},
-        {v3, {uvTR.x, uvBL.y}}}
-        });
+    if (_params.spriteRotated) {
+        // The sprite is stored rotated 90 degrees clockwise in a
+        // repacked atlas; the corners pick their UVs rotated the other
+        // way, so the sprite renders upright (see SpriteAtlas::repack).
+        m_quads.push_back({{
+            {v0, {uvBL.x, uvBL.y}},
+            {v1, {uvBL.x, uvTR.y}},
+            {v2, {uvTR.x, uvBL.y}},
+            {v3, {uvTR.x, uvTR.y}}}
+            });
+    } else {
+        m_quads.push_back({{
+            {v0, {uvBL.x, uvTR.y}},
+            {v1, {uvTR.x, uvTR.y}},
+            {v2, {uvBL.x, uvBL.y}},
+            {v3, {uvTR.x, uvBL.y}}}
+            });
+    }
 }
 
 bool PointStyleBuilder::getUVQuad(PointStyle::Parameters& _params, glm::vec4& _quad) const {
@@ -243,6 +255,8 @@ bool PointStyleBuilder::getUVQuad(PointStyle::Parameters& _params, glm::vec4& _q
         _quad.y = spriteNode.m_uvBL.y;
         _quad.z = spriteNode.m_uvTR.x;
         _quad.w = spriteNode.m_uvTR.y;
+
+        _params.spriteRotated = spriteNode.m_rotated;
     } else {
         // default point size
         if (std::isnan(_params.size.x)) {
@@ -16,7 +16,9 @@
 #include "shaders/polygon_fs.h"
 #include "shaders/polygon_vs.h"
 
+#include <algorithm>
 #include <cmath>
+#include <thread>
 
 constexpr float position_scale = 8192.0f;
 constexpr float texture_scale = 65535.0f;
@@ -24,6 +26,13 @@ constexpr float normal_scale = 127.0f;
 
 namespace Tangram {
 
+// Vertex fetch bandwidth is the bottleneck on low-end mobile GPUs, so
+// every attribute here is quantized: positions to shorts in tile units,
+// normals to normalized bytes, UVs to normalized ushorts. This matches
+// or beats the sizes of the ES3 packed formats (a byte normal with
+// padding is the 4 bytes of INT_2_10_10_10_REV, a ushort UV pair the
+// 4 bytes of two half-floats) without depending on extensions the ES2
+// baseline lacks.
 
 struct PolygonVertexNoUVs {
 
@@ -109,13 +118,33 @@ public:
         m_meshData.clear();
     }
 
+    bool addFeature(const Feature& _feat, const DrawRule& _rule) override;
+
     bool addPolygon(const Polygon& _polygon, const Properties& _props, const DrawRule& _rule) override;
 
+    void reserveFeatures(size_t _numFeatures, size_t _numPoints) override {
+        // Roofs emit one vertex and at most three triangle indices per
+        // ring point; extruded features top up their extra share in
+        // addFeature.
+        m_meshData.vertices.reserve(m_meshData.vertices.size() + _numPoints);
+        m_meshData.indices.reserve(m_meshData.indices.size() + _numPoints * 3);
+        m_meshData.offsets.reserve(m_meshData.offsets.size() + _numFeatures);
+    }
+
     const Style& style() const override { return m_style; }
 
     std::unique_ptr<StyledMesh> build() override;
 
-    PolygonStyleBuilder(const PolygonStyle& _style) : StyleBuilder(_style), m_style(_style) {}
+    PolygonStyleBuilder(const PolygonStyle& _style) : StyleBuilder(_style), m_style(_style) {
+        // The callback reads m_params at call time, so it can be bound
+        // once instead of being reassigned for every polygon.
+        m_builder.addVertex = [this](const glm::vec3& coord,
+                                     const glm::vec3& normal,
+                                     const glm::vec2& uv) {
+            m_meshData.vertices.push_back({ coord, m_params.order, normal, uv,
+                                            m_params.color, m_params.selectionColor });
+        };
+    }
 
     void parseRule(const DrawRule& _rule, const Properties& _props);
 
@@ -123,6 +152,14 @@ public:
 
 private:
 
+    // Emits roof and wall geometry for one polygon using the previously
+    // parsed m_params; see addFeature() for the per-feature setup.
+    bool buildPolygonGeometry(const Polygon& _polygon, const std::vector<uint16_t>* _earcutIndices);
+
+    // Total point count above which a multipolygon's rings are
+    // tessellated on helper threads
+    static constexpr size_t s_parallelTessellationThreshold = 4096;
+
     const PolygonStyle& m_style;
 
     PolygonBuilder m_builder;
@@ -164,22 +201,85 @@ void PolygonStyleBuilder<V>::parseRule(const DrawRule& _rule, const Properties&
 }
 
 template <class V>
-bool PolygonStyleBuilder<V>::addPolygon(const Polygon& _polygon, const Properties& _props, const DrawRule& _rule) {
+bool PolygonStyleBuilder<V>::addFeature(const Feature& _feat, const DrawRule& _rule) {
+
+    if (_feat.geometryType != GeometryType::polygons || _feat.polygons.empty()) {
+        return StyleBuilder::addFeature(_feat, _rule);
+    }
+
+    if (!checkRule(_rule)) { return false; }
+
+    // The extrusion heights and style params depend only on the rule and
+    // the feature properties; resolve them once per feature instead of
+    // once per polygon.
+    parseRule(_rule, _feat.props);
+
+    size_t numPoints = 0;
+    for (const auto& polygon : _feat.polygons) {
+        for (const auto& ring : polygon) { numPoints += ring.size(); }
+    }
+
+    // Roofs add at most one vertex per point; welded walls add about two
+    // more on straight runs. The batch reserve covers the roof share, so
+    // this only grows for extrusions - and then geometrically, since
+    // reserving the exact need would reallocate once per feature.
+    bool extrude = (m_params.minHeight != m_params.height);
+    size_t needed = m_meshData.vertices.size() + numPoints * (extrude ? 3 : 1);
+    if (needed > m_meshData.vertices.capacity()) {
+        m_meshData.vertices.reserve(std::max(needed, m_meshData.vertices.capacity() * 2));
+    }
 
+    const auto& polygons = _feat.polygons;
+
+    // Tessellate the rings of a large multipolygon on helper threads, so
+    // a single feature with hundreds of rings no longer runs as one
+    // serial earcut pass. The triangle indices are merged back in order
+    // by the serial emission loop below, offset per ring.
+    std::vector<std::vector<uint16_t>> triangles;
+
+    if (polygons.size() >= 2 && numPoints >= s_parallelTessellationThreshold) {
+
+        triangles.resize(polygons.size());
+
+        const size_t numWorkers = 2;
+        std::vector<std::thread> threads;
+
+        for (size_t w = 0; w < numWorkers; w++) {
+            threads.emplace_back([&, w] {
+                    mapbox::detail::Earcut<uint16_t> earcut;
+                    for (size_t i = w; i < polygons.size(); i += numWorkers) {
+                        earcut(polygons[i]);
+                        triangles[i] = std::move(earcut.indices);
+                    }
+                });
+        }
+        for (auto& thread : threads) { thread.join(); }
+    }
+
+    bool added = false;
+    for (size_t i = 0; i < polygons.size(); i++) {
+        added |= buildPolygonGeometry(polygons[i], triangles.empty() ? nullptr : &triangles[i]);
+    }
+
+    return added;
+}
+
+template <class V>
+bool PolygonStyleBuilder<V>::addPolygon(const Polygon& _polygon, const Properties& _props, const DrawRule& _rule) {
     parseRule(_rule, _props);
+    return buildPolygonGeometry(_polygon, nullptr);
+}
 
-    m_builder.addVertex = [this](const glm::vec3& coord,
-                                 const glm::vec3& normal,
-                                 const glm::vec2& uv) {
-        m_meshData.vertices.push_back({ coord, m_params.order, normal, uv, m_params.color, m_params.selectionColor });
-    };
+template <class V>
+bool PolygonStyleBuilder<V>::buildPolygonGeometry(const Polygon& _polygon,
+                                                  const std::vector<uint16_t>* _earcutIndices) {
 
     if (m_params.minHeight != m_params.height) {
         Builders::buildPolygonExtrusion(_polygon, m_params.minHeight,
                                         m_params.height, m_builder);
     }
 
-    Builders::buildPolygon(_polygon, m_params.height, m_builder);
+    Builders::buildPolygon(_polygon, m_params.height, m_builder, _earcutIndices);
 
     m_meshData.indices.insert(m_meshData.indices.end(),
                               m_builder.indices.begin(),
@@ -200,6 +300,7 @@ std::unique_ptr<StyleBuilder> PolygonStyle::createBuilder() const {
     } else {
         auto builder = std::make_unique<PolygonStyleBuilder<PolygonVertexNoUVs>>(*this);
         builder->polygonBuilder().useTexCoords = false;
+        builder->polygonBuilder().weldVertices = true;
         return std::move(builder);
     }
 }
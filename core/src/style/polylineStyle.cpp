@@ -20,6 +20,8 @@
 #include "shaders/polyline_vs.h"
 #include "shaders/polyline_fs.h"
 
+#include <algorithm>
+
 #include "glm/vec3.hpp"
 #include "glm/gtc/type_precision.hpp"
 
@@ -111,11 +113,7 @@ void PolylineStyle::setDashBackgroundColor(const glm::vec4 _dashBackgroundColor)
 void PolylineStyle::constructShaderProgram() {
 
     if (m_dashArray.size() > 0) {
-        TextureOptions options {GL_RGBA, GL_RGBA, {GL_NEAREST, GL_NEAREST}, {GL_CLAMP_TO_EDGE, GL_CLAMP_TO_EDGE}};
-        auto pixels = DashArray::render(m_dashArray);
-
-        m_texture = std::make_shared<Texture>(1, pixels.size(), options);
-        m_texture->setData(pixels.data(), pixels.size());
+        m_texture = DashArray::getTexture(m_dashArray);
 
         if (m_dashBackground) {
             m_shaderProgram->addSourceBlock("defines", "#define TANGRAM_LINE_BACKGROUND_COLOR vec3(" +
@@ -174,11 +172,25 @@ public:
 
     bool addFeature(const Feature& _feat, const DrawRule& _rule) override;
 
+    void reserveFeatures(size_t _numFeatures, size_t _numPoints) override {
+        // The fill emits two vertices per line point, with roughly six
+        // triangle indices - or two in strip layout. Stroke outlines are
+        // the exception, so their mesh keeps growing on demand.
+        auto& fill = m_meshData[0];
+        fill.vertices.reserve(fill.vertices.size() + _numPoints * 2);
+        fill.indices.reserve(fill.indices.size() + _numPoints * (m_builder.useStrips ? 3 : 6));
+        fill.offsets.reserve(fill.offsets.size() + _numFeatures);
+    }
+
     std::unique_ptr<StyledMesh> build() override;
 
     PolylineStyleBuilder(const PolylineStyle& _style)
         : StyleBuilder(_style), m_style(_style),
-          m_meshData(2) {}
+          m_meshData(2) {
+        // A style constructed with GL_TRIANGLE_STRIP gets strip-layout
+        // indices, cutting index memory for long lines by about a third.
+        m_builder.useStrips = (_style.drawMode() == GL_TRIANGLE_STRIP);
+    }
 
     void addMesh(const Line& _line, const Parameters& _params);
 
@@ -425,6 +437,14 @@ void PolylineStyleBuilder<V>::buildLine(const Line& _line, const typename Parame
                                   _att.width, _att.height, _att.color, selection});
     };
 
+    // Two vertices per point in the common case; joins and caps add
+    // more. Past the batch reserve, grow geometrically - reserving the
+    // exact need would reallocate once per line.
+    size_t needed = _mesh.vertices.size() + _line.size() * 2;
+    if (needed > _mesh.vertices.capacity()) {
+        _mesh.vertices.reserve(std::max(needed, _mesh.vertices.capacity() * 2));
+    }
+
     Builders::buildPolyLine(_line, m_builder);
 
     _mesh.indices.insert(_mesh.indices.end(),
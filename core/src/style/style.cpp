@@ -19,6 +19,8 @@
 #include "shaders/rasters_glsl.h"
 #include "shaders/selection_fs.h"
 
+#include <algorithm>
+
 namespace Tangram {
 
 Style::Style(std::string _name, Blending _blendMode, GLenum _drawMode, bool _selection) :
@@ -52,6 +54,40 @@ void Style::constructSelectionShaderProgram() {
     }
 }
 
+bool Style::precompileShaders(RenderState& rs) {
+
+    if (m_shaderProgram && m_shaderProgram->needsBuild()) {
+        m_shaderProgram->use(rs);
+        return true;
+    }
+    if (m_selectionProgram && m_selectionProgram->needsBuild()) {
+        m_selectionProgram->use(rs);
+        return true;
+    }
+    return false;
+}
+
+void Style::rebindLights(const std::vector<std::unique_ptr<Light>>& _lights) {
+
+    for (auto it = m_lights.begin(); it != m_lights.end();) {
+
+        auto found = std::find_if(_lights.begin(), _lights.end(),
+                                  [&](const auto& light) {
+                                      return light->getInstanceName() == it->light->getInstanceName() &&
+                                             light->getType() == it->light->getType();
+                                  });
+
+        if (found != _lights.end()) {
+            it->light = found->get();
+            ++it;
+        } else {
+            LOGW("No matching light '%s' in adopting scene",
+                 it->light->getInstanceName().c_str());
+            it = m_lights.erase(it);
+        }
+    }
+}
+
 void Style::build(const Scene& _scene) {
 
     constructVertexLayout();
@@ -197,8 +233,12 @@ void Style::setupShaderUniforms(RenderState& rs, ShaderProgram& _program, const
     // Reset the currently used texture unit to 0
     rs.resetTextureUnit();
 
-    // Set time uniforms style's shader programs
-    _program.setUniformf(rs, _uniforms.uTime, _scene.time());
+    // u_time changes every frame, so only animated styles pay for the
+    // re-send; everything else below goes through the per-program
+    // uniform cache and reaches the driver only when a value changed.
+    if (m_animated) {
+        _program.setUniformf(rs, _uniforms.uTime, _scene.time());
+    }
 
     _program.setUniformf(rs, _uniforms.uDevicePixelRatio, m_pixelScale);
 
@@ -206,8 +246,10 @@ void Style::setupShaderUniforms(RenderState& rs, ShaderProgram& _program, const
         m_material.material->setupProgram(rs, *m_material.uniforms);
     }
 
-    // Set up lights
+    // Set up lights; each light is re-sent only when its values, the
+    // view, or the program changed since its last upload
     for (const auto& light : m_lights) {
+        if (light.light->upToDate(_view, *light.uniforms)) { continue; }
         light.light->setupProgram(rs, _view, *light.uniforms);
     }
 
@@ -344,6 +386,23 @@ void Style::drawSelectionFrame(Tangram::RenderState& rs, const Tangram::Tile &_t
 
 }
 
+bool Style::hasDataForFrame(const std::vector<std::shared_ptr<Tile>>& _tiles,
+                            const std::vector<std::unique_ptr<Marker>>& _markers) const {
+
+    for (const auto& tile : _tiles) {
+        // Count only tiles the draw loop will not cull, so a style whose
+        // geometry is entirely off-screen skips its program bind and
+        // state setup for the frame.
+        if (tile->isVisible() && tile->getMesh(*this)) { return true; }
+    }
+    for (const auto& marker : _markers) {
+        if (marker->styleId() == m_id && marker->isVisible() && marker->mesh()) {
+            return true;
+        }
+    }
+    return false;
+}
+
 void Style::draw(RenderState& rs, const Tile& _tile) {
 
     auto& styleMesh = _tile.getMesh(*this);
@@ -54,6 +54,18 @@ struct StyledMesh {
     virtual bool draw(RenderState& rs, ShaderProgram& _shader, bool _useVao = true) = 0;
     virtual size_t bufferSize() const = 0;
 
+    /* Pushes the compiled geometry to GPU buffers ahead of the first
+     * draw, so the upload can be scheduled under a frame-time budget
+     * instead of happening lazily mid-draw. No-op for meshes without
+     * static buffers. */
+    virtual void upload(RenderState& rs) {}
+
+    /* Appends the compiled buffers of this mesh to _out for the tile mesh
+     * disk cache. Returns false for meshes that cannot be restored from
+     * raw buffers, like label meshes whose glyph and sprite coordinates
+     * depend on live atlas state. */
+    virtual bool serialize(std::vector<char>& _out) const { return false; }
+
     virtual ~StyledMesh() {}
 };
 
@@ -79,6 +91,12 @@ public:
     /* Build styled vertex data for polygon geometry */
     virtual bool addPolygon(const Polygon& _polygon, const Properties& _props, const DrawRule& _rule);
 
+    /* Hint with the batch about to be built: _numFeatures addFeature
+     * calls carrying _numPoints geometry coordinates in total. Builders
+     * size their vertex storage from it once up front instead of
+     * re-growing the buffers mid-build. */
+    virtual void reserveFeatures(size_t _numFeatures, size_t _numPoints) {}
+
     /* Create a new mesh object using the vertex layout corresponding to this style */
     virtual std::unique_ptr<StyledMesh> build() = 0;
 
@@ -200,6 +218,13 @@ public:
 
     virtual ~Style();
 
+    /* Draw-pass ordering, applied once to the scene's styles at load.
+     * Opaque styles draw first in any order - the depth buffer resolves
+     * them - and blended styles follow back-to-front by blend order.
+     * Within those constraints styles group by blend mode, which also
+     * fixes their depth test and write state, so the render loop toggles
+     * blend and depth state as few times per frame as the blend orders
+     * allow. Ties fall back to the name for a stable order. */
     static bool compare(std::unique_ptr<Style>& a, std::unique_ptr<Style>& b) {
 
         const auto& modeA = a->blendMode();
@@ -253,6 +278,14 @@ public:
      */
     virtual void onBeginDrawFrame(RenderState& rs, const View& _view, Scene& _scene);
 
+    /* Returns true when this style may emit draw calls for the current frame.
+     * Styles that only draw per-tile meshes can be skipped entirely - program
+     * bind, uniform and blend state setup included - when no visible tile or
+     * marker carries a mesh for them.
+     */
+    virtual bool hasDataForFrame(const std::vector<std::shared_ptr<Tile>>& _tiles,
+                                 const std::vector<std::unique_ptr<Marker>>& _markers) const;
+
     virtual void onBeginDrawSelectionFrame(RenderState& rs, const View& _view, Scene& _scene);
 
     /* Perform any unsetup needed after drawing each frame */
@@ -269,6 +302,18 @@ public:
 
     virtual void setLightingType(LightingType _lType);
 
+    /* Compile this style's programs if no frame has needed them yet;
+     * called from the render loop to warm remaining styles one at a time
+     * after the first frame, so a rarely used style does not hitch when
+     * it first gets geometry. Returns true when a program was built. */
+    bool precompileShaders(RenderState& rs);
+
+    /* Re-point the light handles of a built style at the lights of an
+     * adopting scene, matched by instance name and type; used when a scene
+     * swap keeps built tiles and their styles. Handles with no matching
+     * light are dropped rather than left pointing into the old scene. */
+    void rebindLights(const std::vector<std::unique_ptr<Light>>& _lights);
+
     void setAnimated(bool _animated) { m_animated = _animated; }
 
     void setMaterial(const std::shared_ptr<Material>& _material);
@@ -70,6 +70,15 @@ void TextStyle::onBeginFrame(RenderState& rs) {
     for (auto& mesh : m_meshes) { mesh->upload(rs); }
 }
 
+bool TextStyle::hasDataForFrame(const std::vector<std::shared_ptr<Tile>>&,
+                                const std::vector<std::unique_ptr<Marker>>&) const {
+
+    for (const auto& mesh : m_meshes) {
+        if (mesh->numberOfVertices() > 0) { return true; }
+    }
+    return false;
+}
+
 void TextStyle::onBeginDrawFrame(RenderState& rs, const View& _view, Scene& _scene) {
 
     Style::onBeginDrawFrame(rs, _view, _scene);
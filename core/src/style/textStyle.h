@@ -82,6 +82,10 @@ public:
      */
     virtual void onBeginDrawFrame(RenderState& rs, const View& _view, Scene& _scene) override;
 
+    /* Label geometry lives in the style-owned meshes, not in tiles */
+    virtual bool hasDataForFrame(const std::vector<std::shared_ptr<Tile>>& _tiles,
+                                 const std::vector<std::unique_ptr<Marker>>& _markers) const override;
+
     virtual void onBeginDrawSelectionFrame(RenderState& rs, const View& _view, Scene& _scene) override;
 
     virtual void draw(RenderState& rs, const Tile& _tile) override {}
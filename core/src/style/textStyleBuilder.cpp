@@ -229,8 +229,15 @@ void TextStyleBuilder::addLineTextLabels(const Feature& _feat, const TextStyle::
 
     for (auto& line : _feat.lines) {
 
+        // Project the line to vec2 once up front; the scans below revisit
+        // points repeatedly and now read a contiguous span instead of
+        // converting from Point at every access.
+        m_linePoints.clear();
+        m_linePoints.reserve(line.size());
+        for (auto& point : line) { m_linePoints.emplace_back(point.x, point.y); }
+
         for (size_t i = 0; i < line.size() - 1; i++) {
-            glm::vec2 p1 = glm::vec2(line[i]);
+            glm::vec2 p1 = m_linePoints[i];
             glm::vec2 p2;
 
             float segmentLength = 0;
@@ -238,7 +245,7 @@ void TextStyleBuilder::addLineTextLabels(const Feature& _feat, const TextStyle::
             size_t next = i+1;
 
             for (size_t j = next; j < line.size(); j++) {
-                glm::vec2 p = glm::vec2(line[j]);
+                glm::vec2 p = m_linePoints[j];
                 segmentLength = glm::length(p1 - p);
 
                 if (j == next) {
@@ -246,7 +253,7 @@ void TextStyleBuilder::addLineTextLabels(const Feature& _feat, const TextStyle::
                         addLabel(_params, Label::Type::line, { p1, p }, _rule);
                     }
                 } else {
-                    glm::vec2 pp = glm::vec2(line[j-1]);
+                    glm::vec2 pp = m_linePoints[j-1];
 
                     float d = sqPointSegmentDistance(pp, p1, p);
                     if (d > tolerance) { break; }
@@ -383,15 +390,18 @@ TextStyle::Parameters TextStyleBuilder::applyRule(const DrawRule& _rule,
     p.labelOptions.repeatGroup = repeatGroupHash;
     p.labelOptions.repeatDistance *= m_style.pixelScale();
 
-    if (auto* transform = _rule.get<std::string>(StyleParamKey::text_transform)) {
-        TextLabelProperty::transform(*transform, p.transform);
+    // Transform and align are parsed to their enum values at scene load
+    uint32_t transform;
+    if (_rule.get(StyleParamKey::text_transform, transform)) {
+        p.transform = static_cast<TextLabelProperty::Transform>(transform);
     }
 
-    if (auto* align = _rule.get<std::string>(StyleParamKey::text_align)) {
-        bool res = TextLabelProperty::align(*align, p.align);
-        if (!res && p.labelOptions.anchors.count > 0) {
-            p.align = TextLabelProperty::alignFromAnchor(p.labelOptions.anchors[0]);
-        }
+    uint32_t align;
+    if (_rule.get(StyleParamKey::text_align, align)) {
+        p.align = static_cast<TextLabelProperty::Align>(align);
+    } else if (_rule.contains(StyleParamKey::text_align) &&
+               p.labelOptions.anchors.count > 0) {
+        p.align = TextLabelProperty::alignFromAnchor(p.labelOptions.anchors[0]);
     }
 
     _rule.get(StyleParamKey::text_optional, p.labelOptions.optional);
@@ -453,20 +463,20 @@ std::string TextStyleBuilder::resolveTextSource(const std::string& textSource,
 
     std::string tmp, item;
 
-    // Meaning we have a yaml sequence defining fallbacks
-    if (textSource.find(',') != std::string::npos) {
-        std::stringstream ss(textSource);
-
-        // Parse fallbacks
-        while (std::getline(ss, tmp, ',')) {
-            if (props.getAsString(tmp, item)) {
-                return item;
-            }
+    // A comma separated source names its fallbacks; scan the keys in
+    // place instead of splitting through a stringstream per feature
+    size_t start = 0, end;
+    while ((end = textSource.find(',', start)) != std::string::npos) {
+        tmp.assign(textSource, start, end - start);
+        if (props.getAsString(tmp, item)) {
+            return item;
         }
+        start = end + 1;
     }
 
     // Fallback to default text source
-    if (props.getAsString(textSource, item)) {
+    if (start > 0) { tmp.assign(textSource, start, std::string::npos); }
+    if (props.getAsString(start > 0 ? tmp : textSource, item)) {
         return item;
     }
 
@@ -77,6 +77,10 @@ protected:
         TextRange textRanges;
     } m_attributes;
 
+    // Scratch span of vec2 line points, reused across the lines of a
+    // feature by addLineTextLabels
+    std::vector<glm::vec2> m_linePoints;
+
     float m_tileSize = 0;
 };
 
@@ -1,6 +1,7 @@
 #include "tangram.h"
 
 #include "platform.h"
+#include "scene/light.h"
 #include "scene/scene.h"
 #include "scene/sceneLoader.h"
 #include "style/material.h"
@@ -10,6 +11,7 @@
 #include "tile/tileManager.h"
 #include "tile/tile.h"
 #include "gl/error.h"
+#include "gl/mesh.h"
 #include "gl/shaderProgram.h"
 #include "gl/renderState.h"
 #include "gl/primitives.h"
@@ -21,21 +23,36 @@
 #include "util/fastmap.h"
 #include "view/view.h"
 #include "data/clientGeoJsonSource.h"
+#include "data/urlRequestRegistry.h"
 #include "gl.h"
 #include "gl/framebuffer.h"
 #include "gl/hardware.h"
 #include "util/ease.h"
 #include "util/jobQueue.h"
+#include "util/memoryArena.h"
 #include "debug/textDisplay.h"
+#include "debug/trace.h"
 #include "debug/frameInfo.h"
+#include "debug/framePacing.h"
+#include "debug/jsProfiler.h"
 #include "selection/selectionQuery.h"
 
+#include <algorithm>
+#include <chrono>
 #include <cmath>
 #include <bitset>
+#include <thread>
 
 namespace Tangram {
 
-const static size_t MAX_WORKERS = 2;
+// Initial number of tile builder threads when none is requested: leave a
+// core for the render and download threads, but keep at least two workers
+// so parse and build stages can overlap.
+static int defaultWorkerCount() {
+    int cores = std::thread::hardware_concurrency();
+    if (cores <= 0) { return 2; }
+    return std::min(std::max(cores - 2, 2), 6);
+}
 
 enum class EaseField { position, zoom, rotation, tilt };
 
@@ -43,6 +60,9 @@ class Map::Impl {
 
 public:
 
+    explicit Impl(int _numTileWorkers)
+        : tileWorker(_numTileWorkers > 0 ? _numTileWorkers : defaultWorkerCount()) {}
+
     void setScene(std::shared_ptr<Scene>& _scene);
 
     void setEase(EaseField _f, Ease _e);
@@ -68,36 +88,125 @@ public:
     std::vector<SceneUpdate> sceneUpdates;
     std::array<Ease, 4> eases;
 
-    std::shared_ptr<Scene> scene = std::make_shared<Scene>();
+    // Glyph atlases and shaped text are scoped to this map - its GL
+    // context owns the atlas textures - and handed to every scene it
+    // loads, so a reload using the same fonts reuses them.
+    std::shared_ptr<FontContext> fontContext = std::make_shared<FontContext>();
+
+    std::shared_ptr<Scene> scene = std::make_shared<Scene>("", fontContext);
     std::shared_ptr<Scene> nextScene = nullptr;
 
     // NB: Destruction of (managed and loading) tiles must happen
     // before implicit destruction of 'scene' above!
     // In particular any references of Labels and Markers to FontContext
-    TileWorker tileWorker{MAX_WORKERS};
+    TileWorker tileWorker;
     TileManager tileManager{tileWorker};
     MarkerManager markerManager;
     std::unique_ptr<FrameBuffer> selectionBuffer = std::make_unique<FrameBuffer>(0, 0);
 
     bool cacheGlState;
 
+    // Whether the rendered state changed since the last drawn frame;
+    // set by update() and by every mutation that alters what a frame
+    // would show, cleared at the end of render(). While false the
+    // platform loop can keep the previous frame on screen.
+    bool renderDirty = true;
+
+    // Debug flags seen by the last update(), to catch toggles that
+    // change the next frame without any map state moving
+    std::bitset<10> lastDebugFlags;
+
+    /* Note a change to the rendered state and ask the platform for a
+     * frame */
+    void markDirty();
+
+    // Snapshot of the tiles the current frame draws, refreshed at the
+    // end of update() when the visible set changed. render() consumes
+    // the snapshot instead of the live render list, and its shared
+    // ownership keeps the tiles alive even when the live set drops them
+    // in between - what lets the draw loops run without the tiles
+    // mutex, and the first step toward a render loop on its own thread.
+    std::vector<std::shared_ptr<Tile>> frameTiles;
+
+    // Render list version the snapshot was taken at; -1 forces a refresh
+    int64_t frameTilesVersion = -1;
+
     std::vector<SelectionQuery> selectionQueries;
+
+    // Selection reads queued into pack buffers, resolved a frame later
+    // so the readback never stalls the pipeline. All queries of a frame
+    // share one read of the rectangle bounding their positions.
+    struct PendingSelection {
+        std::vector<SelectionQuery> queries;
+        GLuint buffer;
+        int x, y, width, height;
+    };
+    std::vector<PendingSelection> pendingSelections;
+
+    // Offscreen snapshot requests, rendered one per idle frame into a
+    // dedicated framebuffer and read back through a pack buffer, so
+    // thumbnail capture never stalls the interactive frame.
+    struct SnapshotRequest {
+        int width, height;
+        SnapshotCallback callback;
+    };
+    std::vector<SnapshotRequest> snapshotRequests;
+
+    struct PendingSnapshot {
+        GLuint buffer;
+        int width, height;
+        SnapshotCallback callback;
+    };
+    std::vector<PendingSnapshot> pendingSnapshots;
+
+    std::unique_ptr<FrameBuffer> snapshotBuffer;
+
+    // Arena for temporaries that live within a single update or render
+    // call; rewound at the start of each update, so steady-state frames
+    // reuse one block instead of going through the heap.
+    MemoryArena frameArena;
+
+    // Reused between frames; selection reads land here.
+    std::vector<GLuint> selectionPixels;
+
+    /* Sample the selection color for a query from a rectangle of pixels
+     * read back from the selection buffer */
+    GLuint selectionColorAt(const std::vector<GLuint>& _pixels, int _x, int _y,
+                            int _width, int _height, const SelectionQuery& _query);
 };
 
 void Map::Impl::setEase(EaseField _f, Ease _e) {
     eases[static_cast<size_t>(_f)] = _e;
-    requestRender();
+    markDirty();
 }
 void Map::Impl::clearEase(EaseField _f) {
     static Ease none = {};
     eases[static_cast<size_t>(_f)] = none;
 }
 
-static std::bitset<9> g_flags = 0;
+void Map::Impl::markDirty() {
+    renderDirty = true;
+    requestRender();
+}
+
+GLuint Map::Impl::selectionColorAt(const std::vector<GLuint>& _pixels, int _x, int _y,
+                                   int _width, int _height, const SelectionQuery& _query) {
+    auto position = _query.position();
+    auto windowCoordinates = view.normalizedWindowCoordinates(position.x, position.y);
 
-Map::Map() {
+    int x = int(windowCoordinates.x * selectionBuffer->getWidth());
+    int y = int(windowCoordinates.y * selectionBuffer->getHeight());
+    x = std::min(std::max(x, _x), _x + _width - 1);
+    y = std::min(std::max(y, _y), _y + _height - 1);
 
-    impl.reset(new Impl());
+    return _pixels[size_t(y - _y) * _width + (x - _x)];
+}
+
+static std::bitset<10> g_flags = 0;
+
+Map::Map(int _numTileWorkers) {
+
+    impl.reset(new Impl(_numTileWorkers));
 }
 
 Map::~Map() {
@@ -113,12 +222,73 @@ Map::~Map() {
     Primitives::deinit();
 }
 
+// Whether the built tiles of _old remain valid under _new: everything
+// that shapes tile geometry - sources, styles, layers, textures, fonts
+// and the globals baked into rule parameters - must be unchanged, and
+// the lights must keep their names and types so built shaders can be
+// re-pointed at them. Light values may differ when the light is dynamic
+// (passed as uniforms); baked-in values of non-dynamic lights must not.
+static bool sceneTilesCompatible(Scene& _old, Scene& _new) {
+
+    for (const char* key : { "sources", "styles", "layers", "textures", "fonts", "global" }) {
+        YAML::Node oldNode = _old.config()[key];
+        YAML::Node newNode = _new.config()[key];
+        if (bool(oldNode) != bool(newNode)) { return false; }
+        if (oldNode && YAML::Dump(oldNode) != YAML::Dump(newNode)) { return false; }
+    }
+
+    auto& oldLights = _old.lights();
+    auto& newLights = _new.lights();
+    if (oldLights.size() != newLights.size()) { return false; }
+
+    for (size_t i = 0; i < oldLights.size(); i++) {
+        auto& a = *oldLights[i];
+        auto& b = *newLights[i];
+
+        if (a.getInstanceName() != b.getInstanceName() ||
+            a.getType() != b.getType() ||
+            a.getOrigin() != b.getOrigin()) {
+            return false;
+        }
+
+        if (!a.isDynamic() || !b.isDynamic()) {
+            YAML::Node oldLight = _old.config()["lights"][a.getInstanceName()];
+            YAML::Node newLight = _new.config()["lights"][b.getInstanceName()];
+            if (bool(oldLight) != bool(newLight)) { return false; }
+            if (oldLight && YAML::Dump(oldLight) != YAML::Dump(newLight)) { return false; }
+        }
+    }
+
+    return true;
+}
+
 void Map::Impl::setScene(std::shared_ptr<Scene>& _scene) {
+    std::shared_ptr<Scene> oldScene;
     {
         std::lock_guard<std::mutex> lock(sceneMutex);
+        oldScene = scene;
         scene = _scene;
     }
 
+    // When the new scene produces identical tile geometry, keep the
+    // built tiles: adopt the previous scene's styles and glyph atlases
+    // so the kept meshes stay pointed at live objects, and re-point the
+    // styles' light bindings at this scene's lights (the one thing a
+    // theme swap is expected to change).
+    bool keepTiles = oldScene && sceneTilesCompatible(*oldScene, *scene);
+    if (keepTiles) {
+        scene->styles() = std::move(oldScene->styles());
+        scene->fontContext() = oldScene->fontContext();
+        // The kept tiles hold selection colors drawn from the old
+        // scene's counter; adopt it so new builds continue above them
+        // instead of re-allocating the same identifiers.
+        scene->featureSelection() = oldScene->featureSelection();
+        for (auto& style : scene->styles()) {
+            style->rebindLights(scene->lights());
+        }
+        LOG("Scene swap keeps built tiles");
+    }
+
     scene->setPixelScale(view.pixelScale());
 
     auto& camera = scene->camera();
@@ -153,7 +323,13 @@ void Map::Impl::setScene(std::shared_ptr<Scene>& _scene) {
     }
 
     inputHandler.setView(view);
-    tileManager.setDataSources(_scene->dataSources());
+    tileManager.setDataSources(_scene->dataSources(), keepTiles);
+
+    // The snapshot may pin tiles built for the previous scene's styles
+    if (!keepTiles) {
+        frameTiles.clear();
+        frameTilesVersion = -1;
+    }
 
     tileWorker.setScene(_scene);
     markerManager.setScene(_scene);
@@ -170,6 +346,8 @@ void Map::Impl::setScene(std::shared_ptr<Scene>& _scene) {
     if (animated != isContinuousRendering()) {
         setContinuousRendering(animated);
     }
+
+    markDirty();
 }
 
 // NB: Not thread-safe. Must be called on the main/render thread!
@@ -185,7 +363,7 @@ void Map::loadScene(const char* _scenePath, bool _useScenePosition,
         impl->nextScene.reset();
     }
 
-    auto scene = std::make_shared<Scene>(_scenePath);
+    auto scene = std::make_shared<Scene>(_scenePath, impl->fontContext);
     scene->useScenePosition = _useScenePosition;
 
     if (SceneLoader::loadScene(scene, _sceneUpdates)) {
@@ -203,7 +381,7 @@ void Map::loadSceneAsync(const char* _scenePath, bool _useScenePosition,
     {
         std::lock_guard<std::mutex> lock(impl->sceneMutex);
         impl->sceneUpdates.clear();
-        impl->nextScene = std::make_shared<Scene>(_scenePath);
+        impl->nextScene = std::make_shared<Scene>(_scenePath, impl->fontContext);
         impl->nextScene->useScenePosition = _useScenePosition;
         nextScene = impl->nextScene;
     }
@@ -303,9 +481,24 @@ void Map::resize(int _newWidth, int _newHeight) {
 
     impl->view.setSize(_newWidth, _newHeight);
 
-    impl->selectionBuffer = std::make_unique<FrameBuffer>(_newWidth/2, _newHeight/2);
+    // Quarter resolution is plenty for picking; feature IDs are flat
+    // colors, so there is no detail to preserve
+    impl->selectionBuffer = std::make_unique<FrameBuffer>(_newWidth/4, _newHeight/4);
+
+    // Reads queued on the old selection buffer can no longer complete;
+    // answer their callbacks with an empty result
+    for (auto& pending : impl->pendingSelections) {
+        for (auto& query : pending.queries) {
+            query.process(impl->view, 0, impl->markerManager,
+                          impl->tileManager, impl->labels);
+        }
+        GL::deleteBuffers(1, &pending.buffer);
+    }
+    impl->pendingSelections.clear();
 
     Primitives::setResolution(impl->renderState, _newWidth, _newHeight);
+
+    impl->markDirty();
 }
 
 bool Map::update(float _dt) {
@@ -317,9 +510,18 @@ bool Map::update(float _dt) {
     }
 
     FrameInfo::beginUpdate();
+    FramePacing::startFrame();
+    TRACE_SCOPE("update");
 
     impl->jobQueue.runJobs();
 
+    // Per-frame containers below draw from the frame arena; after the
+    // scope is installed their allocations reduce to pointer bumps.
+    // Queued jobs run outside of it, since work they start (and any
+    // callbacks into client code) may allocate beyond the frame.
+    impl->frameArena.reset();
+    MemoryArena::Scope frameScope(&impl->frameArena);
+
     impl->scene->updateTime(_dt);
 
     bool viewComplete = true;
@@ -345,7 +547,15 @@ bool Map::update(float _dt) {
     {
         std::lock_guard<std::mutex> lock(impl->tilesMutex);
 
-        impl->tileManager.updateTileSets(impl->view.state(), impl->view.getVisibleTiles());
+        impl->tileWorker.resetRenderRequest();
+
+        {
+            TRACE_SCOPE("tiles:update");
+            FramePacing::Scope stage(FramePacing::Stage::tiles);
+            impl->tileManager.updateTileSets(impl->view.state(), impl->view.getVisibleTiles(),
+                                             impl->view.visibleTilesChanged(),
+                                             impl->view.getPredictedTiles());
+        }
 
         auto& tiles = impl->tileManager.getVisibleTiles();
         auto& markers = impl->markerManager.markers();
@@ -355,8 +565,11 @@ bool Map::update(float _dt) {
             markersNeedUpdate |= marker->isEasing();
         }
 
+        FramePacing::Scope stage(FramePacing::Stage::labels);
+
         if (impl->view.changedOnLastUpdate() ||
-            impl->tileManager.hasTileSetChanged()) {
+            impl->tileManager.hasTileSetChanged() ||
+            impl->labels.hasPendingPlacements()) {
 
             for (const auto& tile : tiles) {
                 tile->update(_dt, impl->view);
@@ -366,6 +579,15 @@ bool Map::update(float _dt) {
         } else {
             impl->labels.updateLabels(impl->view.state(), _dt, impl->scene->styles(), tiles, markers);
         }
+
+        // Refresh the frame snapshot only when the render list version
+        // moved; steady frames reuse it without any refcount traffic.
+        // The version also covers list changes that never mark the tile
+        // set changed, like a pan onto tiles served from the cache.
+        if (impl->frameTilesVersion != impl->tileManager.getTilesVersion()) {
+            impl->tileManager.cloneVisibleTiles(impl->frameTiles);
+            impl->frameTilesVersion = impl->tileManager.getTilesVersion();
+        }
     }
 
     FrameInfo::endUpdate();
@@ -384,25 +606,82 @@ bool Map::update(float _dt) {
     // Request render if labels are in fading states or markers are easing.
     if (labelsNeedUpdate || markersNeedUpdate) { requestRender(); }
 
+    // The next frame is identical to the last one unless something that
+    // shows up on screen moved. The info overlays redraw their numbers
+    // every frame, a toggled debug flag changes the frame without any
+    // map state moving, and selection passes draw even with a still view.
+    bool debugOverlay = getDebugFlag(DebugFlags::tangram_infos) ||
+                        getDebugFlag(DebugFlags::tangram_stats) ||
+                        getDebugFlag(DebugFlags::selection_buffer);
+
+    if (viewChanged || tilesChanged || labelsNeedUpdate || markersNeedUpdate ||
+        resourceLoading || nextScene || debugOverlay || g_flags != impl->lastDebugFlags ||
+        !impl->selectionQueries.empty() || !impl->pendingSelections.empty() ||
+        !impl->snapshotRequests.empty() || !impl->pendingSnapshots.empty()) {
+        impl->renderDirty = true;
+    }
+    impl->lastDebugFlags = g_flags;
+
+    // The recorded state is what this update settled on, with eases and
+    // inertia already applied, so replay does not depend on their timing.
+    auto& recorder = SessionRecorder::instance();
+    if (recorder.isRecording()) {
+        SessionFrame frame;
+        frame.dt = _dt;
+        getPosition(frame.longitude, frame.latitude);
+        frame.zoom = getZoom();
+        frame.rotation = getRotation();
+        frame.tilt = getTilt();
+        recorder.recordFrame(frame);
+    }
+
     return viewComplete;
 }
 
 void Map::pickFeatureAt(float _x, float _y, FeaturePickCallback _onFeaturePickCallback) {
     impl->selectionQueries.push_back({{_x, _y}, _onFeaturePickCallback});
 
-    requestRender();
+    impl->markDirty();
 }
 
 void Map::pickLabelAt(float _x, float _y, LabelPickCallback _onLabelPickCallback) {
+    // Labels keep their screen-space bounds on the CPU, so a hit can be
+    // resolved right away without waiting for the GPU selection pass
+    {
+        std::lock_guard<std::mutex> lock(impl->tilesMutex);
+
+        if (uint32_t color = impl->labels.getLabelColorAt({_x, _y})) {
+            SelectionQuery query({_x, _y}, _onLabelPickCallback);
+            query.process(impl->view, color, impl->markerManager,
+                          impl->tileManager, impl->labels);
+            return;
+        }
+    }
+
     impl->selectionQueries.push_back({{_x, _y}, _onLabelPickCallback});
 
-    requestRender();
+    impl->markDirty();
 }
 
 void Map::pickMarkerAt(float _x, float _y, MarkerPickCallback _onMarkerPickCallback) {
+    // Point markers are placed as labels, so their screen bounds can be
+    // hit tested on the CPU too; markers with line or polygon geometry
+    // have no screen bounds and go through the GPU selection pass
+    {
+        std::lock_guard<std::mutex> lock(impl->tilesMutex);
+
+        uint32_t color = impl->labels.getLabelColorAt({_x, _y});
+        if (color && impl->markerManager.getMarkerOrNullBySelectionColor(color)) {
+            SelectionQuery query({_x, _y}, _onMarkerPickCallback);
+            query.process(impl->view, color, impl->markerManager,
+                          impl->tileManager, impl->labels);
+            return;
+        }
+    }
+
     impl->selectionQueries.push_back({{_x, _y}, _onMarkerPickCallback});
 
-    requestRender();
+    impl->markDirty();
 }
 
 void Map::render() {
@@ -418,6 +697,9 @@ void Map::render() {
     impl->renderState.cacheDefaultFramebuffer();
 
     FrameInfo::beginFrame();
+    TRACE_SCOPE("render");
+    // Covers both passes and the lazy mesh uploads they trigger
+    FramePacing::Scope stage(FramePacing::Stage::draw);
 
     // Invalidate render states for new frame
     if (!impl->cacheGlState) {
@@ -427,16 +709,116 @@ void Map::render() {
     // Run render-thread tasks
     impl->renderState.jobQueue.runJobs();
 
+    // Upload meshes and raster textures of newly built tiles under a
+    // per-frame time budget, nearest to the view center first. Tiles
+    // that miss the budget stay covered by their proxies and are
+    // completed by a later update once uploaded (see
+    // TileManager::updateTileSet); the budget still admits at least one
+    // tile per frame, so uploads always make progress.
+    if (!impl->tileManager.getUploadQueue().empty()) {
+        // Roughly a quarter of a 60hz frame left for uploads after
+        // update and draw have taken their share
+        constexpr float maxUploadMsPerFrame = 4.f;
+
+        std::lock_guard<std::mutex> lock(impl->tilesMutex);
+        const auto start = std::chrono::steady_clock::now();
+
+        for (auto& upload : impl->tileManager.getUploadQueue()) {
+            upload.second->upload(impl->renderState);
+
+            float elapsed = std::chrono::duration<float, std::milli>(
+                    std::chrono::steady_clock::now() - start).count();
+            if (elapsed > maxUploadMsPerFrame) { break; }
+        }
+
+        // Wake another frame so the next update completes the uploaded
+        // tiles and drains any remainder of the queue.
+        impl->markDirty();
+    }
+
+    // Resolve selection reads queued on a previous frame; their
+    // transfers have completed by now, so mapping does not stall.
+    if (!impl->pendingSelections.empty()) {
+        std::lock_guard<std::mutex> lock(impl->tilesMutex);
+
+        auto& pixels = impl->selectionPixels;
+        for (auto& pending : impl->pendingSelections) {
+            bool ok = impl->selectionBuffer->completeReadRect(pending.buffer,
+                                                              size_t(pending.width) * pending.height,
+                                                              pixels);
+            for (auto& query : pending.queries) {
+                GLuint color = ok ? impl->selectionColorAt(pixels, pending.x, pending.y,
+                                                           pending.width, pending.height, query) : 0;
+                query.process(impl->view, color, impl->markerManager,
+                              impl->tileManager, impl->labels);
+            }
+        }
+        impl->pendingSelections.clear();
+    }
+
+    // Resolve snapshot reads queued on a previous frame
+    if (!impl->pendingSnapshots.empty()) {
+        for (auto& pending : impl->pendingSnapshots) {
+            std::vector<GLuint> pixels;
+            bool ok = impl->snapshotBuffer &&
+                      impl->snapshotBuffer->completeReadRect(pending.buffer,
+                              size_t(pending.width) * pending.height, pixels);
+            if (!ok) { pixels.clear(); }
+            pending.callback(std::move(pixels), pending.width, pending.height);
+        }
+        impl->pendingSnapshots.clear();
+    }
+
     // Render feature selection pass to offscreen framebuffer
     if (impl->selectionQueries.size() > 0 || drawSelectionBuffer) {
+
+        int width = impl->selectionBuffer->getWidth();
+        int height = impl->selectionBuffer->getHeight();
+
+        // One rectangle bounds all query points of this frame; the pass
+        // is scissored to it and read back in a single call, so several
+        // simultaneous picks cost no more than one
+        int minX = width, minY = height, maxX = 0, maxY = 0;
+
+        for (const auto& selectionQuery : impl->selectionQueries) {
+            auto position = selectionQuery.position();
+            auto windowCoordinates = impl->view.normalizedWindowCoordinates(position.x, position.y);
+            int x = int(windowCoordinates.x * width);
+            int y = int(windowCoordinates.y * height);
+            minX = std::min(minX, x);
+            minY = std::min(minY, y);
+            maxX = std::max(maxX, x);
+            maxY = std::max(maxY, y);
+        }
+
+        // A few pixels of padding around each point to be safe against
+        // rounding of the downscaled coordinates
+        const int pad = 2;
+        minX = std::max(minX - pad, 0);
+        minY = std::max(minY - pad, 0);
+        maxX = std::min(maxX + pad + 1, width);
+        maxY = std::min(maxY + pad + 1, height);
+
+        // Restrict the pass to the bounding rectangle; the buffer is
+        // only ever read back inside it, so everything outside need not
+        // be cleared or drawn
+        bool scissor = !drawSelectionBuffer && !impl->selectionQueries.empty();
+        if (scissor) {
+            GL::scissor(minX, minY, maxX - minX, maxY - minY);
+            GL::enable(GL_SCISSOR_TEST);
+        }
+
         impl->selectionBuffer->applyAsRenderTarget(impl->renderState);
 
         std::lock_guard<std::mutex> lock(impl->tilesMutex);
 
+        FrameInfo::beginPass("selection");
+
         for (const auto& style : impl->scene->styles()) {
             style->onBeginDrawSelectionFrame(impl->renderState, impl->view, *(impl->scene));
 
-            for (const auto& tile : impl->tileManager.getVisibleTiles()) {
+            for (const auto& tile : impl->frameTiles) {
+                if (!tile->isVisible()) { continue; }
                 style->drawSelectionFrame(impl->renderState, *tile);
             }
 
@@ -445,11 +827,35 @@ void Map::render() {
             }
         }
 
-        std::vector<SelectionColorRead> colorCache;
-        // Resolve feature selection queries
-        for (const auto& selectionQuery : impl->selectionQueries) {
-            selectionQuery.process(impl->view, *impl->selectionBuffer, impl->markerManager,
-                                   impl->tileManager, impl->labels, colorCache);
+        FrameInfo::endPass();
+
+        if (scissor) {
+            GL::disable(GL_SCISSOR_TEST);
+        }
+
+        if (!impl->selectionQueries.empty()) {
+            int rectWidth = maxX - minX;
+            int rectHeight = maxY - minY;
+
+            // Queue an asynchronous read of the rectangle where the
+            // driver allows it and pick the results up next frame;
+            // otherwise read back synchronously as before.
+            GLuint buffer = impl->selectionBuffer->queueReadRect(minX, minY, rectWidth, rectHeight);
+            if (buffer) {
+                impl->pendingSelections.push_back({std::move(impl->selectionQueries), buffer,
+                                                   minX, minY, rectWidth, rectHeight});
+                impl->markDirty();
+            } else {
+                auto& pixels = impl->selectionPixels;
+                impl->selectionBuffer->readRect(minX, minY, rectWidth, rectHeight, pixels);
+
+                for (const auto& selectionQuery : impl->selectionQueries) {
+                    GLuint color = impl->selectionColorAt(pixels, minX, minY,
+                                                          rectWidth, rectHeight, selectionQuery);
+                    selectionQuery.process(impl->view, color, impl->markerManager,
+                                           impl->tileManager, impl->labels);
+                }
+            }
         }
 
         impl->selectionQueries.clear();
@@ -471,15 +877,42 @@ void Map::render() {
     }
 
     {
-        std::lock_guard<std::mutex> lock(impl->tilesMutex);
+        // The snapshot pins its tiles, so the draw loops need no lock
+        // against the live tile set changing or dropping entries.
+
+        // Raster tile textures defer their mip chains; a tile drawn
+        // above its own zoom is minified, so build the owed chains
+        // before the styles sample them (see RasterSource::createTexture).
+        for (const auto& tile : impl->frameTiles) {
+            if (!tile->isVisible() || tile->rasters().empty()) { continue; }
+            if (tile->getID().z <= int(impl->view.getZoom())) { continue; }
+
+            for (auto& raster : tile->rasters()) {
+                if (raster.isValid()) {
+                    raster.texture->ensureMipmaps(impl->renderState, 0);
+                }
+            }
+        }
 
         // Loop over all styles
         for (const auto& style : impl->scene->styles()) {
 
+            // Skip the program bind, uniform and blend state setup for
+            // styles with nothing to draw this frame; scenes commonly
+            // carry more styles than any one view has geometry for.
+            if (!style->hasDataForFrame(impl->frameTiles,
+                                        impl->markerManager.markers())) {
+                continue;
+            }
+
+            FrameInfo::beginPass(style->getName());
+
             style->onBeginDrawFrame(impl->renderState, impl->view, *(impl->scene));
 
-            // Loop over all tiles in m_tileSet
-            for (const auto& tile : impl->tileManager.getVisibleTiles()) {
+            // Loop over all tiles in m_tileSet, skipping the ones whose
+            // bounding volume projects outside the viewport.
+            for (const auto& tile : impl->frameTiles) {
+                if (!tile->isVisible()) { continue; }
                 style->draw(impl->renderState, *tile);
             }
 
@@ -488,12 +921,95 @@ void Map::render() {
             }
 
             style->onEndDrawFrame();
+
+            FrameInfo::endPass();
         }
     }
 
     impl->labels.drawDebug(impl->renderState, impl->view);
 
+    // With the frame out the door, warm at most one not-yet-compiled
+    // style program: styles without geometry never bind (and so never
+    // compile) in the loop above, and spreading the leftover compiles
+    // across frames keeps a rarely used style from stalling the frame
+    // in which its first geometry arrives.
+    for (const auto& style : impl->scene->styles()) {
+        if (style->precompileShaders(impl->renderState)) { break; }
+    }
+
     FrameInfo::draw(impl->renderState, impl->view, impl->tileManager);
+
+    // Offscreen snapshot pass, after the interactive frame is fully
+    // drawn: on an idle frame - view at rest, labels settled, no tiles
+    // loading - render one queued thumbnail into the dedicated
+    // framebuffer and queue its readback; the pixels are delivered when
+    // a later frame completes the transfer.
+    if (!impl->snapshotRequests.empty()) {
+
+        bool idle = !impl->view.changedOnLastUpdate() &&
+                    !impl->labels.needUpdate() &&
+                    !impl->tileManager.hasLoadingTiles();
+
+        if (idle) {
+            auto request = std::move(impl->snapshotRequests.front());
+            impl->snapshotRequests.erase(impl->snapshotRequests.begin());
+
+            if (!impl->snapshotBuffer ||
+                impl->snapshotBuffer->getWidth() != request.width ||
+                impl->snapshotBuffer->getHeight() != request.height) {
+                impl->snapshotBuffer = std::make_unique<FrameBuffer>(request.width,
+                                                                     request.height);
+            }
+
+            impl->snapshotBuffer->applyAsRenderTarget(impl->renderState,
+                                                      impl->scene->background().asIVec4());
+
+            // Same view, same tiles, smaller raster: the scene scales
+            // with the viewport, so the main draw loop repeats as is.
+            for (const auto& style : impl->scene->styles()) {
+                if (!style->hasDataForFrame(impl->frameTiles,
+                                            impl->markerManager.markers())) {
+                    continue;
+                }
+                style->onBeginDrawFrame(impl->renderState, impl->view, *(impl->scene));
+
+                for (const auto& tile : impl->frameTiles) {
+                    if (!tile->isVisible()) { continue; }
+                    style->draw(impl->renderState, *tile);
+                }
+                for (const auto& marker : impl->markerManager.markers()) {
+                    style->draw(impl->renderState, *marker);
+                }
+                style->onEndDrawFrame();
+            }
+
+            GLuint buffer = impl->snapshotBuffer->queueReadRect(0, 0, request.width,
+                                                                request.height);
+            if (buffer) {
+                impl->pendingSnapshots.push_back({buffer, request.width, request.height,
+                                                  std::move(request.callback)});
+            } else {
+                // Driver without pack buffers: read back synchronously
+                std::vector<GLuint> pixels;
+                impl->snapshotBuffer->readRect(0, 0, request.width, request.height, pixels);
+                request.callback(std::move(pixels), request.width, request.height);
+            }
+        }
+    }
+
+    // The drawn frame now matches the map state; mutations and the next
+    // update() set the flag again when something changes.
+    impl->renderDirty = false;
+
+    // Keep frames coming until the snapshot queue drains and queued
+    // reads are resolved; idleness is re-checked each frame.
+    if (!impl->snapshotRequests.empty() || !impl->pendingSnapshots.empty()) {
+        impl->markDirty();
+    }
+}
+
+bool Map::needsRender() {
+    return impl->renderDirty;
 }
 
 int Map::getViewportHeight() {
@@ -512,12 +1028,21 @@ void Map::captureSnapshot(unsigned int* _data) {
     GL::readPixels(0, 0, impl->view.getWidth(), impl->view.getHeight(), GL_RGBA, GL_UNSIGNED_BYTE, (GLvoid*)_data);
 }
 
+void Map::captureSnapshot(int _width, int _height, SnapshotCallback _callback) {
+
+    if (_width <= 0 || _height <= 0 || !_callback) { return; }
+
+    impl->snapshotRequests.push_back({_width, _height, std::move(_callback)});
+
+    impl->markDirty();
+}
+
 void Map::Impl::setPositionNow(double _lon, double _lat) {
 
     glm::dvec2 meters = view.getMapProjection().LonLatToMeters({ _lon, _lat});
     view.setPosition(meters.x, meters.y);
     inputHandler.cancelFling();
-    requestRender();
+    markDirty();
 
 }
 
@@ -525,6 +1050,7 @@ void Map::setPosition(double _lon, double _lat) {
 
     impl->setPositionNow(_lon, _lat);
     impl->clearEase(EaseField::position);
+    impl->view.clearPredictedPosition();
 
 }
 
@@ -535,6 +1061,10 @@ void Map::setPositionEased(double _lon, double _lat, float _duration, EaseType _
     auto cb = [=](float t) { impl->setPositionNow(ease(lon_start, _lon, t, _e), ease(lat_start, _lat, t, _e)); };
     impl->setEase(EaseField::position, { _duration, cb });
 
+    // Let the view prefetch tiles at the destination while the ease runs.
+    glm::dvec2 meters = impl->view.getMapProjection().LonLatToMeters({ _lon, _lat });
+    impl->view.setPredictedPosition(meters.x, meters.y);
+
 }
 
 void Map::getPosition(double& _lon, double& _lat) {
@@ -550,7 +1080,7 @@ void Map::Impl::setZoomNow(float _z) {
 
     view.setZoom(_z);
     inputHandler.cancelFling();
-    requestRender();
+    markDirty();
 
 }
 
@@ -578,7 +1108,7 @@ float Map::getZoom() {
 void Map::Impl::setRotationNow(float _radians) {
 
     view.setRoll(_radians);
-    requestRender();
+    markDirty();
 
 }
 
@@ -613,7 +1143,7 @@ float Map::getRotation() {
 void Map::Impl::setTiltNow(float _radians) {
 
     view.setPitch(_radians);
-    requestRender();
+    markDirty();
 
 }
 
@@ -688,7 +1218,7 @@ void Map::Impl::setPixelScale(float _pixelsPerPoint) {
 void Map::setCameraType(int _type) {
 
     impl->view.setCameraType(static_cast<CameraType>(_type));
-    requestRender();
+    impl->markDirty();
 
 }
 
@@ -708,13 +1238,134 @@ bool Map::removeDataSource(DataSource& source) {
     return impl->tileManager.removeClientDataSource(source);
 }
 
+void Map::onMemoryPressure(MemoryPressure _pressure) {
+    std::lock_guard<std::mutex> lock(impl->tilesMutex);
+
+    auto& cache = impl->tileManager.getTileCache();
+
+    // The glyph atlases persist across scene loads; shed their
+    // rebuildable caches along with the tiles.
+    impl->scene->fontContext()->releaseUnusedCaches();
+
+    if (_pressure == MemoryPressure::critical) {
+        cache->clear();
+        return;
+    }
+
+    // Halve the cached GPU footprint, dropping the heaviest tiles first;
+    // the remaining budget keeps the warmest tiles for cheap re-entry.
+    cache->evictGpuHeavyTiles(cache->getGpuMemoryUsage() / 2);
+}
+
+MemoryReport Map::getMemoryReport() {
+
+    MemoryReport report;
+
+    {
+        std::lock_guard<std::mutex> lock(impl->tilesMutex);
+
+        for (const auto& tile : impl->tileManager.getVisibleTiles()) {
+            report.tileGpuBytes += tile->getGpuMemoryUsage();
+            report.tileCpuBytes += tile->getCpuMemoryUsage();
+        }
+
+        report.tileCacheBytes = impl->tileManager.getTileCache()->getMemoryUsage();
+        report.tileCacheStats = impl->tileManager.getTileCache()->stats();
+
+        for (const auto& marker : impl->markerManager.markers()) {
+            if (auto* mesh = marker->mesh()) {
+                report.markerBytes += mesh->bufferSize();
+            }
+        }
+    }
+
+    for (const auto& source : impl->scene->dataSources()) {
+        report.rawTileCacheBytes += source->cacheMemoryUsage();
+
+        auto stats = source->rawCacheStats();
+        report.rawTileCacheStats.hits += stats.hits;
+        report.rawTileCacheStats.misses += stats.misses;
+        report.rawTileCacheStats.evictions += stats.evictions;
+        report.rawTileCacheStats.bytes += stats.bytes;
+        report.rawTileCacheStats.highWaterBytes += stats.highWaterBytes;
+    }
+
+    report.textureBytes = impl->scene->textureMemoryUsage();
+
+    if (const auto& fontContext = impl->scene->fontContext()) {
+        report.glyphAtlasBytes = fontContext->glyphTextureMemoryUsage();
+    }
+
+    for (const auto& style : impl->scene->styles()) {
+        report.dynamicMeshBytes += style->dynamicMeshSize();
+    }
+
+    return report;
+}
+
+void Map::setSlowTileCallback(float _thresholdMs, TileStats::SlowTileCallback _callback) {
+    TileStats::instance().setSlowTileCallback(_thresholdMs, std::move(_callback));
+}
+
+TileStats::Histogram Map::getTileStatsHistogram(TileStats::Stage _stage) {
+    return TileStats::instance().histogram(_stage);
+}
+
+void Map::clearTileStats() {
+    TileStats::instance().clear();
+}
+
+void Map::setTileBuildThrottle(int _maxConcurrentBuilds, float _dutyCycle) {
+    impl->tileWorker.setThrottle(_maxConcurrentBuilds, _dutyCycle);
+}
+
+void Map::setFrameBudget(float _budgetMs) {
+    FramePacing::setFrameBudget(_budgetMs);
+}
+
+FramePacingStats Map::getFramePacingStats() {
+    return FramePacing::getStats();
+}
+
+void Map::clearFramePacingStats() {
+    FramePacing::clear();
+}
+
+bool Map::startSessionRecording(const std::string& _path) {
+    return SessionRecorder::instance().start(_path);
+}
+
+void Map::stopSessionRecording() {
+    SessionRecorder::instance().stop();
+}
+
+bool Map::applySessionFrame(SessionReplay& _replay, size_t _frame) {
+    if (_frame >= _replay.frameCount()) { return false; }
+
+    if (_frame == 0) {
+        UrlRequestRegistry::instance().setOfflineProvider(
+                [&_replay](const std::string& _url, std::vector<char>& _data) {
+                    return _replay.getResponse(_url, _data);
+                });
+    }
+
+    auto& frame = _replay.frame(_frame);
+    setPosition(frame.longitude, frame.latitude);
+    setZoom(frame.zoom);
+    setRotation(frame.rotation);
+    setTilt(frame.tilt);
+
+    update(frame.dt);
+    return true;
+}
+
 void Map::clearDataSource(DataSource& _source, bool _data, bool _tiles) {
     std::lock_guard<std::mutex> lock(impl->tilesMutex);
 
     if (_tiles) { impl->tileManager.clearTileSet(_source.id()); }
     if (_data) { _source.clearData(); }
 
-    requestRender();
+    impl->markDirty();
 }
 
 MarkerID Map::markerAdd() {
@@ -723,61 +1374,70 @@ MarkerID Map::markerAdd() {
 
 bool Map::markerRemove(MarkerID _marker) {
     bool success = impl->markerManager.remove(_marker);
-    requestRender();
+    impl->markDirty();
     return success;
 }
 
 bool Map::markerSetPoint(MarkerID _marker, LngLat _lngLat) {
     bool success = impl->markerManager.setPoint(_marker, _lngLat);
-    requestRender();
+    impl->markDirty();
     return success;
 }
 
 bool Map::markerSetPointEased(MarkerID _marker, LngLat _lngLat, float _duration, EaseType ease) {
     bool success = impl->markerManager.setPointEased(_marker, _lngLat, _duration, ease);
-    requestRender();
+    impl->markDirty();
     return success;
 }
 
 bool Map::markerSetPolyline(MarkerID _marker, LngLat* _coordinates, int _count) {
     bool success = impl->markerManager.setPolyline(_marker, _coordinates, _count);
-    requestRender();
+    impl->markDirty();
     return success;
 }
 
 bool Map::markerSetPolygon(MarkerID _marker, LngLat* _coordinates, int* _counts, int _rings) {
     bool success = impl->markerManager.setPolygon(_marker, _coordinates, _counts, _rings);
-    requestRender();
+    impl->markDirty();
     return success;
 }
 
 bool Map::markerSetStyling(MarkerID _marker, const char* _styling) {
     bool success = impl->markerManager.setStyling(_marker, _styling);
-    requestRender();
+    impl->markDirty();
     return success;
 }
 
 bool Map::markerSetBitmap(MarkerID _marker, int _width, int _height, const unsigned int* _data) {
     bool success = impl->markerManager.setBitmap(_marker, _width, _height, _data);
-    requestRender();
+    impl->markDirty();
     return success;
 }
 
 bool Map::markerSetVisible(MarkerID _marker, bool _visible) {
     bool success = impl->markerManager.setVisible(_marker, _visible);
-    requestRender();
+    impl->markDirty();
     return success;
 }
 
 bool Map::markerSetDrawOrder(MarkerID _marker, int _drawOrder) {
     bool success = impl->markerManager.setDrawOrder(_marker, _drawOrder);
-    requestRender();
+    impl->markDirty();
     return success;
 }
 
 void Map::markerRemoveAll() {
     impl->markerManager.removeAll();
-    requestRender();
+    impl->markDirty();
+}
+
+void Map::markerBeginBatch() {
+    impl->markerManager.beginBatch();
+}
+
+void Map::markerCommitBatch() {
+    impl->markerManager.commitBatch();
+    impl->markDirty();
 }
 
 void Map::handleTapGesture(float _posX, float _posY) {
@@ -826,9 +1486,15 @@ void Map::setupGL() {
 
     LOG("setup GL");
 
-    impl->tileManager.clearTileSets();
+    // With retained mesh data everything on screen restores itself from
+    // CPU-side copies: textures re-upload their pixels, shaders recompile
+    // on demand and meshes refill from the compiled copies kept at
+    // upload, so tile and marker rebuilds are unnecessary.
+    if (!MeshBase::retainsCompiledData()) {
+        impl->tileManager.clearTileSets();
 
-    impl->markerManager.rebuildAll();
+        impl->markerManager.rebuildAll();
+    }
 
     // Reconfigure the render states. Increases context 'generation'.
     // The OpenGL context has been destroyed since the last time resources were
@@ -845,12 +1511,18 @@ void Map::setupGL() {
 
     Hardware::printAvailableExtensions();
 
+    // A fresh context invalidates whatever frame was on screen
+    impl->renderDirty = true;
 }
 
 void Map::useCachedGlState(bool _useCache) {
     impl->cacheGlState = _useCache;
 }
 
+void Map::useRetainedMeshData(bool _retain) {
+    MeshBase::retainCompiledData(_retain);
+}
+
 void Map::runAsyncTask(std::function<void()> _task) {
     if (impl->asyncWorker) {
         impl->asyncWorker->enqueue(std::move(_task));
@@ -859,9 +1531,17 @@ void Map::runAsyncTask(std::function<void()> _task) {
 
 void setDebugFlag(DebugFlags _flag, bool _on) {
 
+    if (_flag == DebugFlags::js_profile && !_on && getDebugFlag(_flag)) {
+        // Log what was collected while the flag was on
+        LOG("%s", JsProfiler::report().c_str());
+    }
+
     g_flags.set(_flag, _on);
     // m_view->setZoom(m_view->getZoom()); // Force the view to refresh
 
+    if (_flag == DebugFlags::js_profile) {
+        JsProfiler::setEnabled(_on);
+    }
 }
 
 bool getDebugFlag(DebugFlags _flag) {
@@ -872,7 +1552,15 @@ bool getDebugFlag(DebugFlags _flag) {
 
 void toggleDebugFlag(DebugFlags _flag) {
 
+    if (_flag == DebugFlags::js_profile && getDebugFlag(_flag)) {
+        LOG("%s", JsProfiler::report().c_str());
+    }
+
     g_flags.flip(_flag);
+
+    if (_flag == DebugFlags::js_profile) {
+        JsProfiler::setEnabled(getDebugFlag(_flag));
+    }
     // m_view->setZoom(m_view->getZoom()); // Force the view to refresh
 
     // Rebuild tiles for debug modes that needs it
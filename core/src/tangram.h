@@ -1,6 +1,9 @@
 #pragma once
 
 #include "data/properties.h"
+#include "debug/framePacing.h"
+#include "debug/sessionRecorder.h"
+#include "debug/tileStats.h"
 #include "util/types.h"
 #include <functional>
 #include <memory>
@@ -55,6 +58,11 @@ struct MarkerPickResult {
 // Returns a pointer to the selected marker pick result or null, only valid on the callback scope
 using MarkerPickCallback = std::function<void(const MarkerPickResult*)>;
 
+// Receives the pixels of an offscreen snapshot in the layout described
+// at captureSnapshot; the vector is empty when the read failed
+using SnapshotCallback = std::function<void(std::vector<unsigned int>&& _pixels,
+                                            int _width, int _height)>;
+
 struct SceneUpdate {
     std::string path;
     std::string value;
@@ -68,12 +76,49 @@ enum class EaseType : char {
     sine,
 };
 
+// Severity of a memory-pressure signal from the host application; maps to
+// the moderate and critical levels of Android's onTrimMemory and to iOS
+// memory warnings.
+enum class MemoryPressure : char {
+    moderate = 0,
+    critical,
+};
+
+// Approximate bytes held by each engine subsystem. GPU numbers are derived
+// from the sizes of the data the engine uploaded, not from driver queries,
+// so the driver's actual footprint may differ.
+struct MemoryReport {
+    size_t tileGpuBytes = 0;      // Vertex and index buffers of the tiles in view
+    size_t tileCpuBytes = 0;      // Feature properties retained with those tiles for picking
+    size_t tileCacheBytes = 0;    // Built tiles retained in the tile cache
+    size_t rawTileCacheBytes = 0; // Undecoded tile data cached by the data sources
+    size_t markerBytes = 0;       // Marker meshes
+    size_t textureBytes = 0;      // Scene textures, including sprite atlases
+    size_t glyphAtlasBytes = 0;   // Glyph atlas textures of the font context
+    size_t dynamicMeshBytes = 0;  // Label and point meshes rebuilt each frame
+
+    // Lookup and eviction counters of the built-tile cache and of the
+    // raw tile data caches of all sources together (see CacheStats);
+    // hit rates and high-water marks show whether the configured cache
+    // budgets fit the device.
+    CacheStats tileCacheStats;
+    CacheStats rawTileCacheStats;
+
+    size_t total() const {
+        return tileGpuBytes + tileCpuBytes + tileCacheBytes + rawTileCacheBytes
+             + markerBytes + textureBytes + glyphAtlasBytes + dynamicMeshBytes;
+    }
+};
+
 class Map {
 
 public:
 
     // Create an empty map object. To display a map, call either loadScene() or loadSceneAsync().
-    Map();
+    // @_numTileWorkers: number of tile builder threads to start with; 0 picks a
+    // default based on the available hardware concurrency. The pool may grow up
+    // to the hardware limit under sustained tile load.
+    Map(int _numTileWorkers = 0);
     ~Map();
 
     // Load the scene at the given absolute file path asynchronously
@@ -108,6 +153,13 @@ public:
     // Render a new frame of the map view (if needed)
     void render();
 
+    // Whether the last update() left changes to draw. When false the
+    // next frame would be identical to the last one - no view motion,
+    // tile arrivals, label fades, marker eases, pending selections or
+    // debug overlays - and the platform loop can skip render() entirely,
+    // cutting GPU work while the map idles.
+    bool needsRender();
+
     // Gets the viewport height in physical pixels (framebuffer size)
     int getViewportHeight();
 
@@ -128,6 +180,16 @@ public:
     // Each unsigned int corresponds to an RGBA pixel value
     void captureSnapshot(unsigned int* _data);
 
+    // Capture the current view into an offscreen framebuffer at the
+    // given resolution, without blocking interaction: the frame is
+    // rendered on an idle frame - once the view stopped moving and no
+    // tiles are loading - and read back asynchronously, with _callback
+    // run on the render thread a frame or two later. Pixels are RGBA in
+    // the same layout as captureSnapshot, scaled to _width x _height
+    // (pick the viewport's aspect ratio to avoid distortion); the
+    // pixel vector is empty when the read failed.
+    void captureSnapshot(int _width, int _height, SnapshotCallback _callback);
+
     // Set the position of the map view in degrees longitude and latitude; if duration
     // (in seconds) is provided, position eases to the set value over the duration;
     // calling either version of the setter overrides all previous calls
@@ -248,6 +310,15 @@ public:
     // are invalidated after this.
     void markerRemoveAll();
 
+    // Begin a marker mutation batch: until markerCommitBatch is called, marker changes made with the
+    // functions above defer their mesh rebuilds; changes are not drawn before the batch is committed.
+    // Updating many markers per tick this way rebuilds each changed marker once per batch instead of
+    // once per call.
+    void markerBeginBatch();
+
+    // Apply all marker changes made since markerBeginBatch, rebuilding each changed marker once.
+    void markerCommitBatch();
+
     // Respond to a tap at the given screen coordinates (x right, y down)
     void handleTapGesture(float _posX, float _posY);
 
@@ -274,6 +345,12 @@ public:
     // efficiency, but can cause errors if your application code makes OpenGL calls (false by default)
     void useCachedGlState(bool _use);
 
+    // Set whether mesh data is retained in memory after upload, so that a GL context loss (for
+    // example when the app is backgrounded on Android) restores the viewport directly instead of
+    // re-running all tile builds; costs roughly one CPU-side copy of the loaded geometry and only
+    // affects meshes uploaded after the call, so enable it before loading a scene (false by default)
+    void useRetainedMeshData(bool _retain);
+
     // Create a query to select a feature marked as 'interactive'. The query runs on the next frame.
     // Calls _onFeaturePickCallback once the query has completed, and returns the FeaturePickResult
     // with its associated properties or null if no feature was found.
@@ -293,6 +370,71 @@ public:
     // Run this task asynchronously to Tangram's main update loop.
     void runAsyncTask(std::function<void()> _task);
 
+    // Respond to a memory-pressure signal from the host app by shrinking the
+    // tile cache, evicting the tiles with the largest GPU buffers first; under
+    // critical pressure the cache is dropped entirely. Visible tiles are not
+    // affected.
+    void onMemoryPressure(MemoryPressure _pressure);
+
+    // Throttle background tile building for thermal or battery saver
+    // states: at most _maxConcurrentBuilds tiles build at once, and each
+    // worker thread idles after a task so its work fills roughly
+    // _dutyCycle (0..1] of its wall time. Refreshes keep arriving at
+    // bounded power draw without tearing the map down; pass (0, 1.f) to
+    // restore all-out building. Safe to call at any time.
+    void setTileBuildThrottle(int _maxConcurrentBuilds, float _dutyCycle);
+
+    // Collect the approximate memory held by each engine subsystem. The
+    // report only reads sizes the subsystems already track, so it is cheap
+    // enough to poll every few seconds for monitoring.
+    MemoryReport getMemoryReport();
+
+    // Report tiles whose combined queue wait, parse and build time exceeds
+    // _thresholdMs, with their tile ID, source and per-style build
+    // breakdown; the callback fires on a tile worker thread. An empty
+    // callback turns reporting off.
+    void setSlowTileCallback(float _thresholdMs, TileStats::SlowTileCallback _callback);
+
+    // Get the histogram of per-tile durations recorded for the given
+    // pipeline stage since the last clearTileStats(). Mesh uploads are
+    // not a tracked stage; they happen lazily during rendering and show
+    // up in the frame timings instead.
+    TileStats::Histogram getTileStatsHistogram(TileStats::Stage _stage);
+
+    // Reset the recorded tile stage histograms
+    void clearTileStats();
+
+    // Set the frame interval in milliseconds above which a frame counts
+    // as missed in the pacing stats; 0 restores the 60Hz default. Pass
+    // the display's vsync interval when it differs.
+    void setFrameBudget(float _budgetMs);
+
+    // Get the frame pacing stats collected since the last
+    // clearFramePacingStats(): a histogram of frame intervals, the count
+    // of over-budget frames and their attribution to the dominant engine
+    // stage of that frame. Cheap enough to poll from production telemetry.
+    FramePacingStats getFramePacingStats();
+
+    // Reset the recorded frame pacing stats
+    void clearFramePacingStats();
+
+    // Begin recording this session to a file: the view state of every
+    // update() and the bytes of every network response, for later
+    // replay (see debug/sessionRecorder.h). Returns false when the file
+    // cannot be opened.
+    bool startSessionRecording(const std::string& _path);
+
+    // Finish and close the session recording
+    void stopSessionRecording();
+
+    // Apply frame _frame of a recorded session: set the recorded view
+    // state and run update() with the recorded frame time. On the first
+    // frame the replay is installed as the offline source of all
+    // network responses, so the session runs against the recorded tile
+    // bytes; _replay must outlive the replayed session. Returns false
+    // when _frame is past the end of the recording.
+    bool applySessionFrame(SessionReplay& _replay, size_t _frame);
+
 private:
 
     class Impl;
@@ -310,6 +452,7 @@ enum DebugFlags {
     draw_all_labels,    // Draw all labels
     tangram_stats,      // Tangram frame graph stats
     selection_buffer,   // Render selection framebuffer
+    js_profile,         // Count scene JS function invocations per layer; logs a report when turned off
 };
 
 // Set debug features on or off using a boolean (see debug.h)
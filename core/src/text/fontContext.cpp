@@ -6,6 +6,7 @@
 #define SDF_IMPLEMENTATION
 #include "sdf.h"
 
+#include <cstdio>
 #include <memory>
 #include <regex>
 
@@ -24,6 +25,10 @@ FontContext::FontContext() :
     m_batch(m_atlas, m_scratch) {}
 
 void FontContext::loadFonts() {
+    // The shared context outlives scene reloads; the fallbacks are
+    // already loaded then and the atlases keep their glyphs.
+    if (m_font[0] && m_font[0]->hasFaces()) { return; }
+
     auto fallbacks = systemFontFallbacksHandle();
 
     for (int i = 0, size = BASE_SIZE; i < MAX_STEPS; i++, size += STEP_SIZE) {
@@ -61,44 +66,93 @@ void FontContext::addTexture(alfons::AtlasID id, uint16_t width, uint16_t height
 void FontContext::addGlyph(alfons::AtlasID id, uint16_t gx, uint16_t gy, uint16_t gw, uint16_t gh,
                            const unsigned char* src, uint16_t pad) {
 
-    std::lock_guard<std::mutex> lock(m_textureMutex);
-
     if (id >= max_textures) { return; }
 
-    auto& texData = m_textures[id].texData;
-    auto& texture = m_textures[id].texture;
+    // Build the distance field in a thread-local buffer first. The
+    // transform is the expensive part of glyph generation, and running it
+    // in-place on the atlas kept the texture lock held across it, stalling
+    // the render thread's uploads while a first CJK visit generates
+    // thousands of glyphs. The padded window is zero on its borders just
+    // like the atlas slot, so the result is identical.
+    uint16_t width = gw + pad * 2;
+    uint16_t height = gh + pad * 2;
 
-    size_t stride = GlyphTexture::size;
-    size_t width =  GlyphTexture::size;
+    thread_local std::vector<unsigned char> s_glyphBuffer;
+    thread_local std::vector<unsigned char> s_sdfScratch;
 
-    unsigned char* dst = &texData[(gx + pad) + (gy + pad) * stride];
+    s_glyphBuffer.assign(size_t(width) * size_t(height), 0);
 
     for (size_t y = 0, pos = 0; y < gh; y++, pos += gw) {
-        std::memcpy(dst + (y * stride), src + pos, gw);
+        std::memcpy(&s_glyphBuffer[pad + (y + pad) * width], src + pos, gw);
     }
 
-    dst = &texData[size_t(gx) + (size_t(gy) * width)];
-    gw += pad * 2;
-    gh += pad * 2;
+    size_t bytes = size_t(width) * size_t(height) * sizeof(float) * 3;
+    if (s_sdfScratch.size() < bytes) {
+        s_sdfScratch.resize(bytes);
+    }
+
+    sdfBuildDistanceFieldNoAlloc(s_glyphBuffer.data(), width, m_sdfRadius,
+                                 s_glyphBuffer.data(), width, height, width,
+                                 s_sdfScratch.data());
+
+    std::lock_guard<std::mutex> lock(m_textureMutex);
 
-    size_t bytes = size_t(gw) * size_t(gh) * sizeof(float) * 3;
-    if (m_sdfBuffer.size() < bytes) {
-        m_sdfBuffer.resize(bytes);
+    auto& texData = m_textures[id].texData;
+    auto& texture = m_textures[id].texture;
+
+    // The pixel copy may have been dropped under memory pressure while
+    // the atlas slot was unreferenced; restore it before writing.
+    if (texData.empty()) {
+        texData.resize(GlyphTexture::size * GlyphTexture::size, 0);
     }
 
-    sdfBuildDistanceFieldNoAlloc(dst, width, m_sdfRadius,
-                                 dst, gw, gh, width,
-                                 &m_sdfBuffer[0]);
+    size_t stride = GlyphTexture::size;
+    unsigned char* dst = &texData[size_t(gx) + size_t(gy) * stride];
+
+    for (size_t y = 0; y < height; y++) {
+        std::memcpy(dst + y * stride, &s_glyphBuffer[y * width], width);
+    }
 
-    texture.setDirty(gy, gh);
+    texture.setDirty(gy, height);
     m_textures[id].dirty = true;
 }
 
 void FontContext::releaseAtlas(std::bitset<max_textures> _refs) {
     if (!_refs.any()) { return; }
+
+    // The alfons lock is needed to clear atlases, since a concurrent
+    // layoutText may be rasterizing into them. Lock order matches
+    // layoutText: m_fontMutex before m_textureMutex.
+    std::lock_guard<std::mutex> fontlock(m_fontMutex);
     std::lock_guard<std::mutex> lock(m_textureMutex);
+
     for (size_t i = 0; i < m_textures.size(); i++) {
-        if (_refs[i]) { m_atlasRefCount[i] -= 1; }
+        if (!_refs[i]) { continue; }
+
+        if (--m_atlasRefCount[i] == 0) {
+            m_atlas.clear(i);
+            m_textures[i].texData.assign(GlyphTexture::size *
+                                         GlyphTexture::size, 0);
+        }
+    }
+}
+
+void FontContext::releaseUnusedCaches() {
+    // Lock order matches layoutText: m_fontMutex before m_textureMutex.
+    std::lock_guard<std::mutex> fontlock(m_fontMutex);
+    std::lock_guard<std::mutex> lock(m_textureMutex);
+
+    m_shapingCache.clear();
+
+    // Unreferenced atlas slots were already cleared in alfons by
+    // releaseAtlas; free their pixel copies too. The GL textures stay
+    // allocated for cheap reuse, addGlyph restores the pixels when a
+    // slot fills again.
+    for (size_t i = 0; i < m_textures.size(); i++) {
+        if (m_atlasRefCount[i] == 0) {
+            std::vector<unsigned char>().swap(m_textures[i].texData);
+            m_textures[i].dirty = false;
+        }
     }
 }
 
@@ -106,6 +160,7 @@ void FontContext::updateTextures(RenderState& rs) {
     std::lock_guard<std::mutex> lock(m_textureMutex);
 
     for (auto& gt : m_textures) {
+        if (gt.texData.empty()) { continue; }
         if (gt.dirty || !gt.texture.isValid(rs)) {
             gt.dirty = false;
             auto td = reinterpret_cast<const GLuint*>(gt.texData.data());
@@ -124,25 +179,9 @@ bool FontContext::layoutText(TextStyle::Parameters& _params, const std::string&
                              std::vector<GlyphQuad>& _quads, std::bitset<max_textures>& _refs,
                              glm::vec2& _size, TextRange& _textRanges) {
 
-    std::lock_guard<std::mutex> lock(m_fontMutex);
-
-    alfons::LineLayout line = m_shaper.shape(_params.font, _text);
-
-    if (line.shapes().size() == 0) {
-        LOGD("Empty text line");
-        return false;
-    }
-
-    line.setScale(_params.fontScale);
-
-    // m_batch.drawShapeRange() calls FontContext's TextureCallback for new glyphs
-    // and MeshCallback (drawGlyph) for vertex quads of each glyph in LineLayout.
-
-    m_scratch.quads = &_quads;
-
-    size_t quadsStart = _quads.size();
-    alfons::LineMetrics metrics;
-
+    // Everything that only reads the parameters or writes the caller's
+    // buffers runs outside the alfons lock, so concurrent workers overlap
+    // on it.
     std::array<bool, 3> alignments = {};
     if (_params.align != TextLabelProperty::Align::none) {
         alignments[int(_params.align)] = true;
@@ -157,48 +196,96 @@ bool FontContext::layoutText(TextStyle::Parameters& _params, const std::string&
         }
     }
 
-    if (_params.wordWrap) {
-        m_textWrapper.clearWraps();
+    size_t quadsStart = _quads.size();
+    alfons::LineMetrics metrics;
 
-        float width = m_textWrapper.getShapeRangeWidth(line, MIN_LINE_WIDTH,
-                                                       _params.maxLineWidth);
+    {
+        // Shaping, wrapping and glyph rasterization all go through the
+        // shared freetype faces and the shared atlas, so they stay under
+        // one lock.
+        std::lock_guard<std::mutex> lock(m_fontMutex);
 
-        for (size_t i = 0; i < 3; i++) {
+        alfons::LineLayout line;
 
-            int rangeStart = m_scratch.quads->size();
-            if (!alignments[i]) {
-                _textRanges[i] = Range(rangeStart, 0);
-                continue;
-            }
-            int numLines = m_textWrapper.draw(m_batch, width, line, TextLabelProperty::Align(i),
-                                              _params.lineSpacing, metrics);
-            int rangeEnd = m_scratch.quads->size();
+        ShapingKey key{ _params.font.get(), _text };
 
-            _textRanges[i] = Range(rangeStart, rangeEnd - rangeStart);
+        auto cached = m_shapingCache.find(key);
+        if (cached != m_shapingCache.end()) {
+            line = cached->second;
+        } else {
+            line = m_shaper.shape(_params.font, _text);
 
-            // For single line text alignments are the same
-            if (i == 0 && numLines == 1) {
-                _textRanges[1] = Range(rangeEnd, 0);
-                _textRanges[2] = Range(rangeEnd, 0);
-                break;
+            if (m_shapingCache.size() >= max_shaping_cache_entries) {
+                m_shapingCache.clear();
             }
+            m_shapingCache.emplace(std::move(key), line);
+        }
+
+        if (line.shapes().size() == 0) {
+            LOGD("Empty text line");
+            return false;
         }
-    } else {
-        glm::vec2 position(0);
-        int rangeStart = m_scratch.quads->size();
-        m_batch.drawShapeRange(line, 0, line.shapes().size(), position, metrics);
-        int rangeEnd = m_scratch.quads->size();
 
-        _textRanges[0] = Range(rangeStart, rangeEnd - rangeStart);
+        line.setScale(_params.fontScale);
 
-        _textRanges[1] = Range(rangeEnd, 0);
-        _textRanges[2] = Range(rangeEnd, 0);
-    }
+        // m_batch.drawShapeRange() calls FontContext's TextureCallback for new glyphs
+        // and MeshCallback (drawGlyph) for vertex quads of each glyph in LineLayout.
+
+        m_scratch.quads = &_quads;
 
-    auto it = _quads.begin() + quadsStart;
-    if (it == _quads.end()) {
-        // No glyphs added
-        return false;
+        if (_params.wordWrap) {
+            m_textWrapper.clearWraps();
+
+            float width = m_textWrapper.getShapeRangeWidth(line, MIN_LINE_WIDTH,
+                                                           _params.maxLineWidth);
+
+            for (size_t i = 0; i < 3; i++) {
+
+                int rangeStart = m_scratch.quads->size();
+                if (!alignments[i]) {
+                    _textRanges[i] = Range(rangeStart, 0);
+                    continue;
+                }
+                int numLines = m_textWrapper.draw(m_batch, width, line, TextLabelProperty::Align(i),
+                                                  _params.lineSpacing, metrics);
+                int rangeEnd = m_scratch.quads->size();
+
+                _textRanges[i] = Range(rangeStart, rangeEnd - rangeStart);
+
+                // For single line text alignments are the same
+                if (i == 0 && numLines == 1) {
+                    _textRanges[1] = Range(rangeEnd, 0);
+                    _textRanges[2] = Range(rangeEnd, 0);
+                    break;
+                }
+            }
+        } else {
+            glm::vec2 position(0);
+            int rangeStart = m_scratch.quads->size();
+            m_batch.drawShapeRange(line, 0, line.shapes().size(), position, metrics);
+            int rangeEnd = m_scratch.quads->size();
+
+            _textRanges[0] = Range(rangeStart, rangeEnd - rangeStart);
+
+            _textRanges[1] = Range(rangeEnd, 0);
+            _textRanges[2] = Range(rangeEnd, 0);
+        }
+
+        if (_quads.begin() + quadsStart == _quads.end()) {
+            // No glyphs added
+            return false;
+        }
+
+        // Take the atlas references before releasing the alfons lock, so a
+        // concurrent releaseAtlas cannot recycle a texture the new quads
+        // point into.
+        std::lock_guard<std::mutex> texlock(m_textureMutex);
+        for (auto it = _quads.begin() + quadsStart; it != _quads.end(); ++it) {
+            if (!_refs[it->atlas]) {
+                _refs[it->atlas] = true;
+                m_atlasRefCount[it->atlas]++;
+            }
+        }
     }
 
     // TextLabel parameter: Dimension
@@ -210,29 +297,11 @@ bool FontContext::layoutText(TextStyle::Parameters& _params, const std::string&
     glm::vec2 offset((metrics.aabb.x + width * 0.5) * TextVertex::position_scale,
                      (metrics.aabb.y + height * 0.5) * TextVertex::position_scale);
 
-    {
-        std::lock_guard<std::mutex> lock(m_textureMutex);
-        for (; it != _quads.end(); ++it) {
-
-            if (!_refs[it->atlas]) {
-                _refs[it->atlas] = true;
-                m_atlasRefCount[it->atlas]++;
-            }
-
-            it->quad[0].pos -= offset;
-            it->quad[1].pos -= offset;
-            it->quad[2].pos -= offset;
-            it->quad[3].pos -= offset;
-        }
-
-        // Clear unused textures
-        for (size_t i = 0; i < m_textures.size(); i++) {
-            if (m_atlasRefCount[i] == 0) {
-                m_atlas.clear(i);
-                m_textures[i].texData.assign(GlyphTexture::size *
-                                             GlyphTexture::size, 0);
-            }
-        }
+    for (auto it = _quads.begin() + quadsStart; it != _quads.end(); ++it) {
+        it->quad[0].pos -= offset;
+        it->quad[1].pos -= offset;
+        it->quad[2].pos -= offset;
+        it->quad[3].pos -= offset;
     }
 
     return true;
@@ -243,6 +312,10 @@ void FontContext::addFont(const FontDescription& _ft, alfons::InputSource _sourc
     // NB: Synchronize for calls from download thread
     std::lock_guard<std::mutex> lock(m_fontMutex);
 
+    // Fonts gaining faces changes shaping results for strings that fell
+    // back to missing glyphs; drop them.
+    m_shapingCache.clear();
+
     for (int i = 0, size = BASE_SIZE; i < MAX_STEPS; i++, size += STEP_SIZE) {
         auto font = m_alfons.getFont(_ft.alias, size);
         font->addFace(m_alfons.addFontFace(_source, size));
@@ -289,6 +362,22 @@ std::shared_ptr<alfons::Font> FontContext::getFont(const std::string& _family, c
     std::string bundleFontPath = m_sceneResourceRoot + "fonts/" +
         FontDescription::BundleAlias(_family, _style, _weight);
 
+    // When the bundle font is a plain file, hand the face a path source:
+    // FreeType then maps the file and reads its tables on demand when
+    // the face is first shaped, so unused weights and scripts cost
+    // address space instead of heap. Paths that only resolve through
+    // the platform asset loader (fopen fails) keep the buffer path.
+    if (FILE* file = fopen(bundleFontPath.c_str(), "rb")) {
+        fclose(file);
+
+        font->addFace(m_alfons.addFontFace(alfons::InputSource(bundleFontPath), fontSize));
+
+        if (m_font[sizeIndex]) {
+            font->addFaces(*m_font[sizeIndex]);
+        }
+        return font;
+    }
+
     std::vector<char> fontData = bytesFromFile(bundleFontPath.c_str());
 
     // 2. System font
@@ -18,6 +18,7 @@
 
 #include <bitset>
 #include <mutex>
+#include <unordered_map>
 
 namespace Tangram {
 
@@ -63,6 +64,13 @@ struct FontDescription {
     }
 };
 
+/* Fonts, glyph atlases and shaped text of one map. The context is owned
+ * by the Map - its GL context owns the atlas textures - and shared
+ * across that map's scene loads: font faces are keyed by
+ * family/style/weight in the font manager, so a reload using the same
+ * fonts reuses their atlases and shaping instead of re-rasterizing
+ * every visible glyph. Atlas slots are recycled through the label
+ * reference counts. */
 class FontContext : public alfons::TextureCallback {
 
 public:
@@ -71,8 +79,15 @@ public:
 
     FontContext();
 
+    /* Load the default font and its system fallbacks; no-op when they
+     * are already loaded, as on a scene reload of the shared context. */
     void loadFonts();
 
+    /* Drop caches that can be rebuilt on demand: the shaping cache and
+     * the pixel copies of atlases no live label references. Called
+     * under memory pressure; referenced atlases are untouched. */
+    void releaseUnusedCaches();
+
     /* Synchronized on m_mutex on tile-worker threads
      * Called from alfons when a texture atlas needs to be created
      * Triggered from TextStyleBuilder::prepareLabel
@@ -99,6 +114,16 @@ public:
         return m_textures.size();
     }
 
+    /* Bytes of GPU memory held by the glyph atlas textures */
+    size_t glyphTextureMemoryUsage() {
+        std::lock_guard<std::mutex> lock(m_textureMutex);
+        size_t bytes = 0;
+        for (auto& entry : m_textures) {
+            bytes += entry.texture.gpuMemoryUsage();
+        }
+        return bytes;
+    }
+
     void bindTexture(RenderState& rs, alfons::AtlasID _id, GLuint _unit);
 
     float maxStrokeWidth() { return m_sdfRadius; }
@@ -121,7 +146,6 @@ private:
 
     float m_sdfRadius;
     ScratchBuffer m_scratch;
-    std::vector<unsigned char> m_sdfBuffer;
 
     std::mutex m_fontMutex;
     std::mutex m_textureMutex;
@@ -137,6 +161,31 @@ private:
     // TextShaper to create <LineLayout> for a given text and Font
     alfons::TextShaper m_shaper;
 
+    // Cache of shaping results: the same strings recur across adjacent
+    // tiles and rebuilds, and shaping dominates text build time for
+    // complex scripts. The font identifies size and direction handling;
+    // entries are unscaled, the per-label scale is applied to the copy.
+    // Guarded by m_fontMutex, cleared when fonts gain faces.
+    struct ShapingKey {
+        const alfons::Font* font;
+        std::string text;
+
+        bool operator==(const ShapingKey& _other) const {
+            return font == _other.font && text == _other.text;
+        }
+    };
+
+    struct ShapingKeyHash {
+        size_t operator()(const ShapingKey& _key) const {
+            return std::hash<std::string>{}(_key.text) ^
+                   std::hash<const void*>{}(_key.font);
+        }
+    };
+
+    static constexpr size_t max_shaping_cache_entries = 4096;
+
+    std::unordered_map<ShapingKey, alfons::LineLayout, ShapingKeyHash> m_shapingCache;
+
     // TextBatch to 'draw' <LineLayout>s, i.e. creating glyph textures and glyph quads.
     // It is intialized with a TextureCallback implemented by FontContext for adding glyph
     // textures and a MeshCallback implemented by TextStyleBuilder for adding glyph quads.
@@ -1,6 +1,8 @@
 #include "tile.h"
 
 #include "data/dataSource.h"
+#include "data/properties.h"
+#include "selection/featureSelection.h"
 #include "style/style.h"
 #include "view/view.h"
 #include "tile/tileID.h"
@@ -37,7 +39,13 @@ glm::dvec2 Tile::coordToLngLat(const glm::vec2& _tileCoord, const MapProjection&
     return {degrees.x, degrees.y};
 }
 
-Tile::~Tile() {}
+Tile::~Tile() {
+    if (m_featureSelection) {
+        for (const auto& feature : m_selectionFeatures) {
+            m_featureSelection->releaseColorIdentifier(feature.first);
+        }
+    }
+}
 
 //Note: This could set tile origin to be something different than the one if TileID's wrap is used.
 // But, this is required for wrapped tiles which are picked up from the cache
@@ -53,6 +61,9 @@ void Tile::updateTileOrigin(const int _wrap) {
     auto mapSpan = mapBound.max.x - mapBound.min.x;
 
     m_tileOrigin.x += (mapSpan * _wrap);
+
+    // The cached matrices were built from the previous origin
+    m_viewGeneration = 0;
 }
 
 void Tile::initGeometry(uint32_t _size) {
@@ -61,12 +72,42 @@ void Tile::initGeometry(uint32_t _size) {
 
 void Tile::update(float _dt, const View& _view) {
 
+    // The matrices and the visibility flag depend only on the view and
+    // the tile origin; both are unchanged when the view generation
+    // still matches, so the recompute (and the frustum test) can be
+    // skipped. Updates also run on static frames, e.g. while label
+    // placements settle, and with a few hundred visible tiles across
+    // sources the multiplies add up.
+    if (_view.generation() == m_viewGeneration) { return; }
+    m_viewGeneration = _view.generation();
+
     // Apply tile-view translation to the model matrix
     const auto& viewOrigin = _view.getPosition();
     m_modelMatrix[3][0] = m_tileOrigin.x - viewOrigin.x;
     m_modelMatrix[3][1] = m_tileOrigin.y - viewOrigin.y;
 
     m_mvp = _view.getViewProjectionMatrix() * m_modelMatrix;
+
+    // Conservatively test the tile's bounding box against the view frustum:
+    // the tile is offscreen only when all box corners lie outside the same
+    // clip plane. The box spans one tile unit vertically to cover extruded
+    // geometry. This mostly triggers in pitched views, where tiles at the
+    // edge of the visible set can project entirely outside the viewport.
+    unsigned char allOutside = 0x3f;
+
+    for (int i = 0; i < 8 && allOutside != 0; i++) {
+        glm::vec4 c = m_mvp * glm::vec4(i & 1, (i >> 1) & 1, (i >> 2) & 1, 1.f);
+        unsigned char outside = 0;
+        if (c.x < -c.w) { outside |= 1 << 0; }
+        if (c.x >  c.w) { outside |= 1 << 1; }
+        if (c.y < -c.w) { outside |= 1 << 2; }
+        if (c.y >  c.w) { outside |= 1 << 3; }
+        if (c.z < -c.w) { outside |= 1 << 4; }
+        if (c.z >  c.w) { outside |= 1 << 5; }
+        allOutside &= outside;
+    }
+
+    m_visible = (allOutside == 0);
 }
 
 void Tile::resetState() {
@@ -78,6 +119,24 @@ void Tile::resetState() {
     }
 }
 
+bool Tile::isUploaded() const {
+    if (m_uploaded) { return true; }
+    for (auto& mesh : m_geometry) {
+        if (mesh) { return false; }
+    }
+    return m_rasters.empty();
+}
+
+void Tile::upload(RenderState& _rs) {
+    for (auto& mesh : m_geometry) {
+        if (mesh) { mesh->upload(_rs); }
+    }
+    for (auto& raster : m_rasters) {
+        if (raster.texture) { raster.texture->update(_rs, 0); }
+    }
+    m_uploaded = true;
+}
+
 void Tile::setMesh(const Style& _style, std::unique_ptr<StyledMesh> _mesh) {
     size_t id = _style.getID();
     if (id >= m_geometry.size()) {
@@ -93,8 +152,10 @@ const std::unique_ptr<StyledMesh>& Tile::getMesh(const Style& _style) const {
     return m_geometry[_style.getID()];
 }
 
-void Tile::setSelectionFeatures(const fastmap<uint32_t, std::shared_ptr<Properties>> _selectionFeatures) {
+void Tile::setSelectionFeatures(const fastmap<uint32_t, std::shared_ptr<Properties>> _selectionFeatures,
+                                std::shared_ptr<FeatureSelection> _featureSelection) {
     m_selectionFeatures = _selectionFeatures;
+    m_featureSelection = _featureSelection;
 }
 
 std::shared_ptr<Properties> Tile::getSelectionFeature(uint32_t _id) {
@@ -106,6 +167,10 @@ std::shared_ptr<Properties> Tile::getSelectionFeature(uint32_t _id) {
 }
 
 size_t Tile::getMemoryUsage() const {
+    return getGpuMemoryUsage() + getCpuMemoryUsage();
+}
+
+size_t Tile::getGpuMemoryUsage() const {
     if (m_memoryUsage == 0) {
         for (auto& entry : m_geometry) {
             if (entry) {
@@ -117,4 +182,16 @@ size_t Tile::getMemoryUsage() const {
     return m_memoryUsage;
 }
 
+size_t Tile::getCpuMemoryUsage() const {
+    if (m_cpuMemoryUsage == 0) {
+        for (auto& entry : m_selectionFeatures) {
+            if (entry.second) {
+                m_cpuMemoryUsage += entry.second->memoryUsage();
+            }
+        }
+    }
+
+    return m_cpuMemoryUsage;
+}
+
 }
@@ -14,8 +14,10 @@
 namespace Tangram {
 
 class DataSource;
+class FeatureSelection;
 class MapProjection;
 struct Properties;
+class RenderState;
 class Style;
 class View;
 struct StyledMesh;
@@ -72,7 +74,23 @@ public:
 
     void setMesh(const Style& _style, std::unique_ptr<StyledMesh> _mesh);
 
-    void setSelectionFeatures(const fastmap<uint32_t, std::shared_ptr<Properties>> _selectionFeatures);
+    /* Pushes all static meshes and raster textures of this tile to the
+     * GPU. Called from the render pass upload scheduler before the tile
+     * joins the visible set, so draw never has to upload lazily. */
+    void upload(RenderState& _rs);
+
+    /* Whether upload() has run or there is nothing to upload; tiles
+     * below the budget in a frame stay pending and keep their proxies
+     * until a later frame uploads them */
+    bool isUploaded() const;
+
+    /* Set the map from selection color to feature properties. When the
+     * FeatureSelection the colors were drawn from is given, they are
+     * released back to it on destruction so identifiers get recycled;
+     * colors restored from the mesh cache pass none, since they were
+     * allocated by a previous session. */
+    void setSelectionFeatures(const fastmap<uint32_t, std::shared_ptr<Properties>> _selectionFeatures,
+                              std::shared_ptr<FeatureSelection> _featureSelection = nullptr);
 
     std::shared_ptr<Properties> getSelectionFeature(uint32_t _id);
 
@@ -84,14 +102,26 @@ public:
     /* Update the Tile considering the current view */
     void update(float _dt, const View& _view);
 
+    /* Whether any part of the tile's bounding volume projects into the
+     * viewport; updated in <update()>. Conservative, so drawing may be
+     * skipped for tiles where this is false. */
+    bool isVisible() const { return m_visible; }
+
     /* Update tile origin based on wraping for this tile */
     void updateTileOrigin(const int _wrap);
 
     void resetState();
 
-    /* Get the sum in bytes of static <Mesh>es */
+    /* Get the sum in bytes of static <Mesh>es and CPU-side structures */
     size_t getMemoryUsage() const;
 
+    /* Bytes held in GPU buffers by this tile's meshes */
+    size_t getGpuMemoryUsage() const;
+
+    /* Approximate CPU-side bytes retained with this tile, i.e. the
+     * selection feature properties */
+    size_t getCpuMemoryUsage() const;
+
     int64_t sourceGeneration() const { return m_sourceGeneration; }
 
     int32_t sourceID() const { return m_sourceId; }
@@ -118,6 +148,10 @@ private:
 
     bool m_proxyState = false;
 
+    bool m_visible = true;
+
+    bool m_uploaded = false;
+
     glm::dvec2 m_tileOrigin; // South-West corner of the tile in 2D projection space in meters (e.g. mercator meters)
 
     glm::mat4 m_modelMatrix; // Matrix relating tile-local coordinates to global projection space coordinates;
@@ -127,14 +161,25 @@ private:
 
     glm::mat4 m_mvp;
 
+    // View generation the matrices and the visibility flag were last
+    // computed for; 0 (never a valid generation) forces a recompute
+    int64_t m_viewGeneration = 0;
+
     // Map of <Style>s and their associated <Mesh>es
     std::vector<std::unique_ptr<StyledMesh>> m_geometry;
     std::vector<Raster> m_rasters;
 
+    // Lazily computed GPU (mesh buffers) and CPU (selection properties)
+    // byte counts; accounted separately so the cache can respond to the
+    // right kind of memory pressure.
     mutable size_t m_memoryUsage = 0;
+    mutable size_t m_cpuMemoryUsage = 0;
 
     fastmap<uint32_t, std::shared_ptr<Properties>> m_selectionFeatures;
 
+    /* Pool to return the selection colors to when this tile is destroyed */
+    std::shared_ptr<FeatureSelection> m_featureSelection;
+
 };
 
 }
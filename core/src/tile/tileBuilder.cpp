@@ -3,16 +3,23 @@
 #include "data/dataSource.h"
 #include "data/properties.h"
 #include "data/propertyItem.h"
+#include "debug/trace.h"
 #include "gl/mesh.h"
 #include "log.h"
 #include "scene/dataLayer.h"
 #include "scene/scene.h"
 #include "style/style.h"
 #include "tile/tile.h"
+#include "tile/tileTask.h"
 #include "selection/featureSelection.h"
 #include "util/mapProjection.h"
+#include "util/simplify.h"
 #include "view/view.h"
 
+#include <atomic>
+#include <chrono>
+#include <thread>
+
 namespace Tangram {
 
 TileBuilder::TileBuilder(std::shared_ptr<Scene> _scene)
@@ -24,6 +31,12 @@ TileBuilder::TileBuilder(std::shared_ptr<Scene> _scene)
     for (auto& style : _scene->styles()) {
         m_styleBuilder[style->getName()] = style->createBuilder();
     }
+
+    // Style IDs are indices into the scene's style vector
+    m_styleBuildersById.resize(_scene->styles().size(), nullptr);
+    for (auto& style : _scene->styles()) {
+        m_styleBuildersById[style->getID()] = m_styleBuilder[style->getName()].get();
+    }
 }
 
 TileBuilder::~TileBuilder() {}
@@ -35,19 +48,73 @@ StyleBuilder* TileBuilder::getStyleBuilder(const std::string& _name) {
     return it->second.get();
 }
 
-void TileBuilder::applyStyling(const Feature& _feature, const SceneLayer& _layer) {
+StyleBuilder* TileBuilder::cachedStyleBuilder(const std::string& _name) {
+    auto it = m_styleBuilderIndex.find(&_name);
+    if (it != m_styleBuilderIndex.end()) { return it->second; }
+
+    auto* builder = getStyleBuilder(_name);
+    m_styleBuilderIndex[&_name] = builder;
+    return builder;
+}
+
+void TileBuilder::applyStyling(const Feature& _feature, const DataLayer& _layer, float _pixelToTileUnits) {
 
     // If no rules matched the feature, return immediately
     if (!m_ruleSet.match(_feature, _layer, m_styleContext)) { return; }
 
+    // Thin out geometry whose detail is sub-pixel at this zoom before it
+    // reaches the style builders. The parsed source data is shared across
+    // builds, so the simplified geometry goes into a copy owned by this
+    // builder until the queued jobs have run.
+    const Feature* feature = &_feature;
+
+    float tolerance = _layer.simplifyTolerance() * _pixelToTileUnits;
+
+    if (tolerance > 0.f && _feature.geometryType != GeometryType::points) {
+
+        m_simplifiedFeatures.emplace_back();
+        Feature& simplified = m_simplifiedFeatures.back();
+
+        simplified.geometryType = _feature.geometryType;
+        simplified.props = _feature.props;
+
+        for (const auto& line : _feature.lines) {
+            Line out;
+            simplifyLine(line, tolerance, out);
+            if (out.size() >= 2) { simplified.lines.push_back(std::move(out)); }
+        }
+
+        for (const auto& polygon : _feature.polygons) {
+            Polygon poly;
+            poly.reserve(polygon.size());
+            for (const auto& ring : polygon) {
+                Line out;
+                simplifyLine(ring, tolerance, out);
+                // Rings reduced below a closed triangle are sub-pixel
+                if (out.size() >= 4) { poly.push_back(std::move(out)); }
+            }
+            if (!poly.empty()) { simplified.polygons.push_back(std::move(poly)); }
+        }
+
+        feature = &simplified;
+    }
+
     uint32_t selectionColor = 0;
-    bool added = false;
+    size_t record = m_featureRecords.size();
 
-    // For each matched rule, find the style to be used and
-    // build the feature with the rule's parameters
+    // For each matched rule, find the style to be used and queue the
+    // feature to be built with the rule's parameters
     for (auto& rule : m_ruleSet.matchedRules()) {
 
-        StyleBuilder* style = getStyleBuilder(rule.getStyleName());
+        // Rules carry the scene index of their style; names are only
+        // consulted when the style comes from a dynamic parameter.
+        StyleBuilder* style = nullptr;
+        int styleId = rule.getStyleId();
+        if (styleId >= 0 && size_t(styleId) < m_styleBuildersById.size()) {
+            style = m_styleBuildersById[styleId];
+        } else {
+            style = cachedStyleBuilder(rule.getStyleName());
+        }
 
         if (!style) {
             LOGN("Invalid style %s", rule.getStyleName().c_str());
@@ -69,6 +136,11 @@ void TileBuilder::applyStyling(const Feature& _feature, const SceneLayer& _layer
             rule.selectionColor = 0;
         }
 
+        if (record == m_featureRecords.size()) {
+            m_featureRecords.push_back({&_feature.props, 0, false});
+        }
+        m_featureRecords[record].selectionColor = selectionColor;
+
         // build outline explicitly with outline style
         const auto& outlineStyleName = rule.findParameter(StyleParamKey::outline_style);
         if (outlineStyleName) {
@@ -78,23 +150,145 @@ void TileBuilder::applyStyling(const Feature& _feature, const SceneLayer& _layer
                 LOGN("Invalid style %s", styleName.c_str());
             } else {
                 rule.isOutlineOnly = true;
-                outlineStyle->addFeature(_feature, rule);
+                queueStyleJob(outlineStyle, *feature, record, rule);
                 rule.isOutlineOnly = false;
             }
         }
 
         // build feature with style
-        added |= style->addFeature(_feature, rule);
+        queueStyleJob(style, *feature, record, rule);
+    }
+}
+
+void TileBuilder::queueStyleJob(StyleBuilder* _builder, const Feature& _feature,
+                                size_t _record, const DrawRule& _rule) {
+
+    m_styleJobs.push_back({_builder, &_feature, _record, _rule});
+
+    // The rule's evaluated parameters point into scratch storage that
+    // the next feature reuses, so move them into storage that lives
+    // until the jobs run. Parameters without functions or stops point
+    // into the scene and stay valid as they are.
+    auto& rule = m_styleJobs.back().rule;
+    for (size_t i = 0; i < StyleParamKeySize; i++) {
+        if (!rule.active[i]) { continue; }
+
+        auto*& param = rule.params[i].param;
+        if (param->function >= 0 || param->stops) {
+            m_evaluatedParams.push_back(*param);
+            param = &m_evaluatedParams.back();
+        }
+    }
+}
+
+void TileBuilder::prescreenFeatures(int _zoom, std::vector<uint8_t>& _results,
+                                    const std::vector<std::pair<const Feature*, const DataLayer*>>& _workList) {
+
+    const size_t numWorkers = 2;
+
+    if (m_matchWorkers.empty()) {
+        for (size_t i = 0; i < numWorkers; i++) {
+            auto worker = std::make_unique<MatchWorker>();
+            worker->context.initFunctions(*m_scene);
+            m_matchWorkers.push_back(std::move(worker));
+        }
+    }
+
+    _results.assign(_workList.size(), 0);
+
+    // Chop the layer-major work list into chunks that never span two
+    // layers: each chunk is one layer's filter swept over a contiguous
+    // run of features. Short chunks keep the workers balanced when
+    // layers differ wildly in feature count.
+    const size_t chunkLength = 256;
+
+    struct Chunk { size_t begin, end; };
+    std::vector<Chunk> chunks;
+
+    for (size_t begin = 0; begin < _workList.size();) {
+        const DataLayer* layer = _workList[begin].second;
+        size_t end = begin;
+        while (end < _workList.size() && _workList[end].second == layer) { end++; }
+
+        for (; begin < end; begin += chunkLength) {
+            chunks.push_back({begin, std::min(begin + chunkLength, end)});
+        }
     }
 
-    if (added && (selectionColor != 0)) {
-        m_selectionFeatures[selectionColor] = std::make_shared<Properties>(_feature.props);
+    std::atomic<size_t> nextChunk{0};
+    std::vector<std::thread> threads;
+
+    for (size_t w = 0; w < m_matchWorkers.size(); w++) {
+        threads.emplace_back([&, w] {
+                auto& worker = *m_matchWorkers[w];
+                worker.context.setKeywordZoom(_zoom);
+
+                size_t c;
+                while ((c = nextChunk.fetch_add(1)) < chunks.size()) {
+                    const auto& chunk = chunks[c];
+                    const DataLayer& layer = *_workList[chunk.begin].second;
+
+                    if (!layer.visible()) { continue; }
+
+                    worker.context.setCurrentLayer(&layer.name());
+
+                    // Filter-major: sweep the layer's compiled root filter
+                    // alone over the run first, so one predicate program
+                    // streams over the feature properties with its own
+                    // data staying hot.
+                    for (size_t i = chunk.begin; i < chunk.end; i++) {
+                        worker.context.setFeature(*_workList[i].first);
+                        _results[i] = layer.filterProgram().eval(*_workList[i].first,
+                                                                 worker.context);
+                    }
+
+                    // The sublayer cascade then only runs for features the
+                    // root filter let through.
+                    for (size_t i = chunk.begin; i < chunk.end; i++) {
+                        if (!_results[i]) { continue; }
+                        _results[i] = worker.ruleSet.match(*_workList[i].first, layer,
+                                                           worker.context, true);
+                    }
+                }
+            });
     }
+
+    for (auto& thread : threads) { thread.join(); }
 }
 
-std::shared_ptr<Tile> TileBuilder::build(TileID _tileID, const TileData& _tileData, const DataSource& _source) {
+// Total coordinate count of a feature's geometry, the input to the
+// builders' vertex storage reserves
+static size_t countGeometryPoints(const Feature& _feature) {
+
+    switch (_feature.geometryType) {
+    case GeometryType::points:
+        return _feature.points.size();
+    case GeometryType::lines: {
+        size_t sum = 0;
+        for (const auto& line : _feature.lines) { sum += line.size(); }
+        return sum;
+    }
+    case GeometryType::polygons: {
+        size_t sum = 0;
+        for (const auto& polygon : _feature.polygons) {
+            for (const auto& ring : polygon) { sum += ring.size(); }
+        }
+        return sum;
+    }
+    default:
+        return 0;
+    }
+}
+
+std::shared_ptr<Tile> TileBuilder::build(TileID _tileID, const TileData& _tileData, const DataSource& _source,
+                                         const TileTask* _task) {
 
     m_selectionFeatures.clear();
+    m_styleJobs.clear();
+    m_featureRecords.clear();
+    m_simplifiedFeatures.clear();
+    m_evaluatedParams.clear();
+    m_styleBuildTimes.clear();
 
     auto tile = std::make_shared<Tile>(_tileID, *m_scene->mapProjection(), &_source);
 
@@ -107,10 +301,20 @@ std::shared_ptr<Tile> TileBuilder::build(TileID _tileID, const TileData& _tileDa
             builder.second->setup(*tile);
     }
 
+    // Collect the features to be styled, layer by layer
+    std::vector<std::pair<const Feature*, const DataLayer*>> workList;
+
     for (const auto& datalayer : m_scene->layers()) {
 
         if (datalayer.source() != _source.name()) { continue; }
 
+        // The $zoom keyword is constant for the whole build, so a layer
+        // whose filter cannot pass at this zoom is skipped here, before
+        // any collection or feature work.
+        if (datalayer.filter().matchAtZoom(_tileID.s) == Filter::ZoomMatch::no) {
+            continue;
+        }
+
         for (const auto& collection : _tileData.layers) {
 
             if (!collection.name.empty()) {
@@ -121,10 +325,92 @@ std::shared_ptr<Tile> TileBuilder::build(TileID _tileID, const TileData& _tileDa
                 if (!layerContainsCollection) { continue; }
             }
 
+            // Skip the whole collection when no feature in it carries
+            // a property key the layer's filter requires
+            if ((datalayer.requiredKeysBloom() & ~collection.keyBloom) != 0) {
+                continue;
+            }
+
             for (const auto& feat : collection.features) {
-                applyStyling(feat, datalayer);
+                workList.emplace_back(&feat, &datalayer);
+            }
+        }
+    }
+
+    // For large tiles, evaluate layer filters on helper threads so the
+    // serial styling loop below only touches matching features.
+    std::vector<uint8_t> matches;
+    if (workList.size() >= s_parallelMatchThreshold) {
+        TRACE_SCOPE("build:match");
+        prescreenFeatures(_tileID.s, matches, workList);
+    }
+
+    // One pixel in tile-local units, accounting for overzoom scaling
+    float pixelToTileUnits = 1.f / (m_scene->mapProjection()->TileSize()
+                                    * (1 << std::max(0, _tileID.s - _tileID.z)));
+
+    for (size_t i = 0; i < workList.size(); i++) {
+        // Abandon the build mid-tile when the task was canceled,
+        // freeing this worker for a tile that is still needed.
+        if (_task && _task->isCanceled()) { return nullptr; }
+
+        if (!matches.empty() && !matches[i]) { continue; }
+
+        applyStyling(*workList[i].first, *workList[i].second, pixelToTileUnits);
+    }
+
+    if (_task && _task->isCanceled()) { return nullptr; }
+
+    // Run the queued jobs grouped by style: each builder processes its
+    // whole batch in one loop with a constant call target, keeping one
+    // builder's code and mesh data hot instead of interleaving styles
+    // feature by feature.
+    for (auto& builder : m_styleBuilder) {
+        StyleBuilder* style = builder.second.get();
+        if (!style) { continue; }
+
+        // Count the batch's geometry first, so the builder can size its
+        // vertex storage once up front instead of re-growing the buffers
+        // while the features build.
+        size_t batchFeatures = 0;
+        size_t batchPoints = 0;
+
+        for (auto& job : m_styleJobs) {
+            if (job.builder != style) { continue; }
+            batchFeatures++;
+            batchPoints += countGeometryPoints(*job.feature);
+        }
+
+        if (batchFeatures == 0) { continue; }
+
+        style->reserveFeatures(batchFeatures, batchPoints);
+
+        // One trace slice per style batch of this tile
+        TRACE_SCOPE("build:style");
+
+        auto batchStart = std::chrono::steady_clock::now();
+
+        for (auto& job : m_styleJobs) {
+            if (job.builder != style) { continue; }
+
+            bool added = style->addFeature(*job.feature, job.rule);
+            if (!job.rule.isOutlineOnly) {
+                m_featureRecords[job.record].added |= added;
             }
         }
+
+        float ms = std::chrono::duration<float, std::milli>(
+            std::chrono::steady_clock::now() - batchStart).count();
+        m_styleBuildTimes.emplace_back(style->style().getName(), ms);
+
+        if (_task && _task->isCanceled()) { return nullptr; }
+    }
+
+    for (auto& record : m_featureRecords) {
+        if (record.added && record.selectionColor != 0) {
+            m_selectionFeatures[record.selectionColor] =
+                std::make_shared<Properties>(*record.props);
+        }
     }
 
     for (auto& builder : m_styleBuilder) {
@@ -134,13 +420,19 @@ std::shared_ptr<Tile> TileBuilder::build(TileID _tileID, const TileData& _tileDa
 
     float tileSize = m_scene->mapProjection()->TileSize() * m_scene->pixelScale();
 
-    m_labelLayout.process(_tileID, tile->getInverseScale(), tileSize);
+    {
+        TRACE_SCOPE("build:label-layout");
+        m_labelLayout.process(_tileID, tile->getInverseScale(), tileSize);
+    }
 
-    for (auto& builder : m_styleBuilder) {
-        tile->setMesh(builder.second->style(), builder.second->build());
+    {
+        TRACE_SCOPE("build:mesh");
+        for (auto& builder : m_styleBuilder) {
+            tile->setMesh(builder.second->style(), builder.second->build());
+        }
     }
 
-    tile->setSelectionFeatures(m_selectionFeatures);
+    tile->setSelectionFeatures(m_selectionFeatures, m_scene->featureSelection());
 
     return tile;
 }
@@ -5,6 +5,8 @@
 #include "scene/drawRule.h"
 #include "labels/labelCollider.h"
 
+#include <deque>
+
 namespace Tangram {
 
 class DataLayer;
@@ -13,6 +15,7 @@ struct Feature;
 struct Properties;
 class Tile;
 class StyleBuilder;
+class TileTask;
 struct TileData;
 
 class TileBuilder {
@@ -25,14 +28,74 @@ public:
 
     StyleBuilder* getStyleBuilder(const std::string& _name);
 
-    std::shared_ptr<Tile> build(TileID _tileID, const TileData& _data, const DataSource& _source);
+    // Builds a tile from _data. When _task is given, cancellation is
+    // checked between features and returns null to abort the build.
+    std::shared_ptr<Tile> build(TileID _tileID, const TileData& _data, const DataSource& _source,
+                                const TileTask* _task = nullptr);
 
     const Scene& scene() const { return *m_scene; }
 
+    // Milliseconds spent per style batch of the last build, for
+    // slow-tile reports; styles without jobs are not listed.
+    const std::vector<std::pair<std::string, float>>& styleBuildTimes() const {
+        return m_styleBuildTimes;
+    }
+
 private:
 
-    // Determine and apply DrawRules for a @_feature
-    void applyStyling(const Feature& _feature, const SceneLayer& _layer);
+    // Determine and apply DrawRules for a @_feature. _pixelToTileUnits
+    // converts the layer's simplification tolerance from pixels into
+    // the tile-local units of the feature geometry.
+    void applyStyling(const Feature& _feature, const DataLayer& _layer, float _pixelToTileUnits);
+
+    // Evaluate layer filters for all work-list entries on helper threads,
+    // marking the features that match any rule. Work is split into
+    // same-layer chunks, and within a chunk the layer's compiled root
+    // filter is swept over all features before any sublayer cascade runs,
+    // so each predicate program streams over the feature properties
+    // instead of alternating with the full rule match. Lets the serial
+    // styling loop skip non-matching features of large tiles without
+    // paying for their filter evaluation on the build thread.
+    void prescreenFeatures(int _zoom, std::vector<uint8_t>& _results,
+                           const std::vector<std::pair<const Feature*, const DataLayer*>>& _workList);
+
+    // A feature build deferred until all features of the tile have been
+    // matched and evaluated, so the builders can run grouped by style
+    // instead of interleaved feature by feature.
+    struct StyleJob {
+        StyleBuilder* builder;
+        const Feature* feature;
+        // Index of the source feature's entry in m_featureRecords
+        size_t record;
+        DrawRule rule;
+    };
+
+    // Per-source-feature bookkeeping for deferred jobs: selection
+    // properties are recorded only once the jobs have actually added
+    // geometry for the feature.
+    struct FeatureRecord {
+        const Properties* props;
+        uint32_t selectionColor;
+        bool added;
+    };
+
+    // Queue a feature build for _builder, moving the rule's evaluated
+    // parameters out of the merge set's scratch storage so they stay
+    // valid until the job runs.
+    void queueStyleJob(StyleBuilder* _builder, const Feature& _feature,
+                       size_t _record, const DrawRule& _rule);
+
+    // Per-helper-thread state for the parallel pre-match pass. Kept for
+    // the lifetime of the TileBuilder to reuse the duktape heaps.
+    struct MatchWorker {
+        StyleContext context;
+        DrawRuleMergeSet ruleSet;
+    };
+
+    // Feature count above which the pre-match pass fans out
+    static constexpr size_t s_parallelMatchThreshold = 512;
+
+    std::vector<std::unique_ptr<MatchWorker>> m_matchWorkers;
 
     std::shared_ptr<Scene> m_scene;
 
@@ -41,8 +104,31 @@ private:
 
     LabelCollider m_labelLayout;
 
+    // Resolve the style builder for a rule's style name through the
+    // identity of the name string. Before rules are evaluated their
+    // parameters point into the scene's layer data, so the address of
+    // the name string stands in for its contents and repeat dispatch
+    // skips hashing and comparing the name. Only valid for strings
+    // owned by the scene of this builder.
+    StyleBuilder* cachedStyleBuilder(const std::string& _name);
+
     fastmap<std::string, std::unique_ptr<StyleBuilder>> m_styleBuilder;
 
+    fastmap<const std::string*, StyleBuilder*> m_styleBuilderIndex;
+
+    // Builders indexed by scene style ID for rules resolved at load
+    std::vector<StyleBuilder*> m_styleBuildersById;
+
+    std::vector<StyleJob> m_styleJobs;
+    std::vector<FeatureRecord> m_featureRecords;
+
+    std::vector<std::pair<std::string, float>> m_styleBuildTimes;
+
+    // Owns the geometry and parameter values the queued jobs point
+    // into; deques keep element addresses stable while growing.
+    std::deque<Feature> m_simplifiedFeatures;
+    std::deque<StyleParam> m_evaluatedParams;
+
     fastmap<uint32_t, std::shared_ptr<Properties>> m_selectionFeatures;
 };
 
@@ -3,6 +3,7 @@
 #include "tile/tile.h"
 #include "tile/tileHash.h"
 #include "tile/tileID.h"
+#include "util/types.h"
 #include "log.h"
 
 #include <unordered_map>
@@ -40,7 +41,6 @@ class TileCache {
 public:
 
     TileCache(size_t _cacheSizeMB) :
-        m_cacheUsage(0),
         m_cacheMaxUsage(_cacheSizeMB) {}
 
     std::vector<TileID> put(int32_t _sourceId, std::shared_ptr<Tile> _tile) {
@@ -48,7 +48,12 @@ public:
 
         m_cacheList.push_front({k, _tile});
         m_cacheMap[k] = m_cacheList.begin();
-        m_cacheUsage += _tile->getMemoryUsage();
+        m_cpuUsage += _tile->getCpuMemoryUsage();
+        m_gpuUsage += _tile->getGpuMemoryUsage();
+
+        if (size_t(m_cpuUsage + m_gpuUsage) > m_highWater) {
+            m_highWater = m_cpuUsage + m_gpuUsage;
+        }
 
         return limitCacheSize(m_cacheMaxUsage);
     }
@@ -62,7 +67,11 @@ public:
             std::swap(tile, (*(it->second)).tile);
             m_cacheList.erase(it->second);
             m_cacheMap.erase(it);
-            m_cacheUsage -= tile->getMemoryUsage();
+            m_cpuUsage -= tile->getCpuMemoryUsage();
+            m_gpuUsage -= tile->getGpuMemoryUsage();
+            m_hits++;
+        } else {
+            m_misses++;
         }
         return tile;
     }
@@ -82,17 +91,33 @@ public:
         std::vector<TileID> poppedTileIDs;
         m_cacheMaxUsage = _cacheSizeBytes;
 
-        while (m_cacheUsage > m_cacheMaxUsage) {
+        while (size_t(m_cpuUsage + m_gpuUsage) > m_cacheMaxUsage) {
             if (m_cacheList.empty()) {
                 LOGE("Invalid cache state!");
-                m_cacheUsage = 0;
+                m_cpuUsage = 0;
+                m_gpuUsage = 0;
                 break;
             }
-            auto& tile = m_cacheList.back().tile;
-            poppedTileIDs.push_back(tile->getID());
-            m_cacheUsage -= tile->getMemoryUsage();
-            m_cacheMap.erase(m_cacheList.back().key);
-            m_cacheList.pop_back();
+            popEntry(std::prev(m_cacheList.end()), poppedTileIDs);
+        }
+        return poppedTileIDs;
+    }
+
+    /* Evict tiles until the GPU-side usage is at most _gpuBudgetBytes,
+     * largest GPU consumers first; used under memory pressure, where
+     * freeing the most per eviction matters more than keeping the
+     * recently used tiles. */
+    std::vector<TileID> evictGpuHeavyTiles(size_t _gpuBudgetBytes) {
+        std::vector<TileID> poppedTileIDs;
+
+        while (size_t(m_gpuUsage) > _gpuBudgetBytes && !m_cacheList.empty()) {
+            auto heaviest = m_cacheList.begin();
+            for (auto it = m_cacheList.begin(); it != m_cacheList.end(); ++it) {
+                if (it->tile->getGpuMemoryUsage() > heaviest->tile->getGpuMemoryUsage()) {
+                    heaviest = it;
+                }
+            }
+            popEntry(heaviest, poppedTileIDs);
         }
         return poppedTileIDs;
     }
@@ -105,18 +130,55 @@ public:
         return sum;
     }
 
+    size_t getCpuMemoryUsage() const { return m_cpuUsage; }
+
+    size_t getGpuMemoryUsage() const { return m_gpuUsage; }
+
+    /* Lifetime lookup and eviction counters; clear() resets the cache
+     * contents but keeps them, so telemetry sees cumulative numbers */
+    CacheStats stats() const {
+        CacheStats stats;
+        stats.hits = m_hits;
+        stats.misses = m_misses;
+        stats.evictions = m_evictions;
+        stats.bytes = m_cpuUsage + m_gpuUsage;
+        stats.highWaterBytes = m_highWater;
+        return stats;
+    }
+
     void clear() {
         m_cacheMap.clear();
         m_cacheList.clear();
-        m_cacheUsage = 0;
+        m_cpuUsage = 0;
+        m_gpuUsage = 0;
     }
 
 private:
+
+    void popEntry(CacheList::iterator _it, std::vector<TileID>& _popped) {
+        auto& tile = _it->tile;
+        _popped.push_back(tile->getID());
+        m_cpuUsage -= tile->getCpuMemoryUsage();
+        m_gpuUsage -= tile->getGpuMemoryUsage();
+        m_cacheMap.erase(_it->key);
+        m_cacheList.erase(_it);
+        m_evictions++;
+    }
+
     CacheMap m_cacheMap;
     CacheList m_cacheList;
 
-    int m_cacheUsage;
-    int m_cacheMaxUsage;
+    // CPU-side (selection properties) and GPU-side (mesh buffers) usage
+    // are accounted separately so pressure signals can target the side
+    // that is actually scarce.
+    int64_t m_cpuUsage = 0;
+    int64_t m_gpuUsage = 0;
+    size_t m_cacheMaxUsage;
+
+    uint64_t m_hits = 0;
+    uint64_t m_misses = 0;
+    uint64_t m_evictions = 0;
+    size_t m_highWater = 0;
 };
 
 }
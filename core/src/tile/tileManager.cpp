@@ -4,12 +4,14 @@
 #include "platform.h"
 #include "tile/tile.h"
 #include "tileCache.h"
+#include "tileMeshCache.h"
 #include "util/mapProjection.h"
 #include "view/view.h"
 
 #include "glm/gtx/norm.hpp"
 
 #include <algorithm>
+#include <future>
 
 #define DBG(...) // LOGD(__VA_ARGS__)
 
@@ -24,7 +26,9 @@ TileManager::TileManager(TileTaskQueue& _tileWorker) :
     m_dataCallback = TileTaskCb{[this](std::shared_ptr<TileTask>&& task) {
 
          if (task->isReady()) {
-             requestRender();
+             if (!m_renderRequested.exchange(true)) {
+                 requestRender();
+             }
 
         } else if (task->hasData()) {
             m_workers.enqueue(std::move(task));
@@ -39,9 +43,15 @@ TileManager::~TileManager() {
     m_tileSets.clear();
 }
 
-void TileManager::setDataSources(const std::vector<std::shared_ptr<DataSource>>& _sources) {
+void TileManager::setDataSources(const std::vector<std::shared_ptr<DataSource>>& _sources,
+                                 bool _keepTiles) {
 
-    m_tileCache->clear();
+    if (!_keepTiles) { m_tileCache->clear(); }
+
+    // Sets may be dropped or cleared below; the non-owning render list
+    // must not outlive their entries
+    m_tiles.clear();
+    m_tilesVersion++;
 
     // remove sources that are not in new scene - there must be a better way..
     auto it = std::remove_if(
@@ -57,7 +67,7 @@ void TileManager::setDataSources(const std::vector<std::shared_ptr<DataSource>>&
                 }
             }
             // Clear cache
-            tileSet.tiles.clear();
+            if (!_keepTiles) { tileSet.tiles.clear(); }
             return false;
         });
 
@@ -91,6 +101,8 @@ bool TileManager::removeClientDataSource(DataSource& dataSource) {
             it->source->clearRasters();
             // Remove the tile set associated with this data source
             it = m_tileSets.erase(it);
+            m_tiles.clear();
+            m_tilesVersion++;
             removed = true;
         } else {
             ++it;
@@ -101,52 +113,211 @@ bool TileManager::removeClientDataSource(DataSource& dataSource) {
 
 void TileManager::clearTileSets() {
     for (auto& tileSet : m_tileSets) {
+        for (auto& prefetch : tileSet.prefetches) { prefetch.second->cancel(); }
+        tileSet.prefetches.clear();
         tileSet.tiles.clear();
     }
 
+    // The render list points into the entries just cleared
+    m_tiles.clear();
+    m_tilesVersion++;
+
     m_tileCache->clear();
 }
 
 void TileManager::clearTileSet(int32_t _sourceId) {
     for (auto& tileSet : m_tileSets) {
         if (tileSet.source->id() != _sourceId) { continue; }
+        for (auto& prefetch : tileSet.prefetches) { prefetch.second->cancel(); }
+        tileSet.prefetches.clear();
         tileSet.tiles.clear();
     }
 
+    m_tiles.clear();
+    m_tilesVersion++;
+
     m_tileCache->clear();
     m_tileSetChanged = true;
 }
 
 void TileManager::updateTileSets(const ViewState& _view,
-                                 const std::set<TileID>& _visibleTiles) {
-    m_tiles.clear();
+                                 const std::vector<TileID>& _visibleTiles,
+                                 bool _visibleTilesChanged,
+                                 const std::vector<TileID>& _predictedTiles) {
     m_loadPending = 0;
     m_tilesInProgress = 0;
     m_tileSetChanged = false;
 
+    // Ready tasks are drained below; re-arm the coalesced render
+    // request so completions until the next tick wake the platform
+    // at most once.
+    m_renderRequested = false;
+
+    std::vector<TileSet*> activeSets;
     for (auto& tileSet : m_tileSets) {
         // check if tile set is active for zoom (zoom might be below min_zoom)
         if (tileSet.source->isActiveForZoom(_view.zoom)) {
-            updateTileSet(tileSet, _view, _visibleTiles);
+            activeSets.push_back(&tileSet);
         }
     }
 
+    // Update the sets in parallel tasks: each update only writes into its
+    // own set and scratch, with the shared tile cache behind m_cacheMutex.
+    // The main thread takes the first set itself, so extra threads only
+    // appear when several sources are active.
+    std::vector<std::future<void>> pending;
+    for (size_t i = 1; i < activeSets.size(); i++) {
+        pending.push_back(std::async(std::launch::async, [&, set = activeSets[i]]() {
+                    updateTileSet(*set, _view, _visibleTiles);
+                }));
+    }
+    if (!activeSets.empty()) {
+        updateTileSet(*activeSets[0], _view, _visibleTiles);
+    }
+    for (auto& future : pending) { future.wait(); }
+
+    // Merge the per-set results. The per-set render lists arrive sorted
+    // and unique, so successive merges keep the scratch list ordered at
+    // linear cost in the tile count.
+    m_tilesScratch.clear();
+    m_uploadQueue.clear();
+    for (auto* set : activeSets) {
+        size_t middle = m_tilesScratch.size();
+        m_tilesScratch.insert(m_tilesScratch.end(),
+                              set->updateTiles.begin(), set->updateTiles.end());
+        std::inplace_merge(m_tilesScratch.begin(), m_tilesScratch.begin() + middle,
+                           m_tilesScratch.end(),
+                           [](auto& a, auto& b) { return a->getID() < b->getID(); });
+
+        for (auto& loadTask : set->updateLoadTasks) {
+            m_loadTasks.emplace_back(loadTask.first, set, loadTask.second);
+        }
+
+        m_uploadQueue.insert(m_uploadQueue.end(),
+                             set->updateUploadQueue.begin(),
+                             set->updateUploadQueue.end());
+
+        m_tilesInProgress += set->updateTilesInProgress;
+        m_loadPending += set->updateLoadPending;
+        m_tileSetChanged |= set->updateTileSetChanged;
+    }
+
+    // Pending uploads are drained nearest-first by the render pass
+    std::sort(m_uploadQueue.begin(), m_uploadQueue.end(),
+              [](auto& a, auto& b) { return a.first < b.first; });
+
+    // Load tasks are handled nearest-first across all sources
+    std::sort(m_loadTasks.begin(), m_loadTasks.end(),
+              [](auto& a, auto& b) { return std::get<0>(a) < std::get<0>(b); });
+
     loadTiles();
 
-    // Make m_tiles an unique list of tiles for rendering sorted from
-    // high to low zoom-levels.
-    std::sort(m_tiles.begin(), m_tiles.end(), [](auto& a, auto& b){
-            return a->getID() < b->getID(); });
+    if (m_prefetchMargin > 0) {
+        // Collect a ring of tiles around the visible set, plus their
+        // parents and any predicted tiles, to warm up at background
+        // priority. The ring only depends on these inputs, so it is
+        // reused until one of them changes.
+        if (_visibleTilesChanged || m_prefetchRing.empty() ||
+            _predictedTiles != m_lastPredictedTiles) {
+            m_prefetchRing.clear();
+
+            for (const auto& id : _visibleTiles) {
+                for (int dx = -m_prefetchMargin; dx <= m_prefetchMargin; dx++) {
+                    for (int dy = -m_prefetchMargin; dy <= m_prefetchMargin; dy++) {
+                        if (dx == 0 && dy == 0) { continue; }
+
+                        TileID neighbor(id.x + dx, id.y + dy, id.z, id.s, id.wrap);
+                        if (neighbor.isValid()) {
+                            m_prefetchRing.push_back(neighbor);
+                        }
+                    }
+                }
+
+                auto parent = id.getParent();
+                if (parent.isValid()) {
+                    m_prefetchRing.push_back(parent);
+                }
+            }
+
+            // Tiles along the fling path or at the ease destination start
+            // loading now instead of when the view reaches them.
+            m_prefetchRing.insert(m_prefetchRing.end(),
+                                  _predictedTiles.begin(), _predictedTiles.end());
+
+            std::sort(m_prefetchRing.begin(), m_prefetchRing.end());
+            m_prefetchRing.erase(std::unique(m_prefetchRing.begin(), m_prefetchRing.end()),
+                                 m_prefetchRing.end());
+
+            // Visible tiles get loaded at regular priority already.
+            m_prefetchRing.erase(
+                std::remove_if(m_prefetchRing.begin(), m_prefetchRing.end(),
+                               [&](const TileID& id) {
+                                   return std::binary_search(_visibleTiles.begin(),
+                                                             _visibleTiles.end(), id);
+                               }),
+                m_prefetchRing.end());
+
+            m_lastPredictedTiles = _predictedTiles;
+        }
+
+        for (auto& tileSet : m_tileSets) {
+            if (tileSet.source->isActiveForZoom(_view.zoom)) {
+                updatePrefetches(tileSet, m_prefetchRing, _view);
+            }
+        }
+    }
 
-    // Remove duplicates: Proxy tiles could have been added more than once
-    m_tiles.erase(std::unique(m_tiles.begin(), m_tiles.end()), m_tiles.end());
+    // Swap in the merged render list only when it differs from the one
+    // in place, bumping the version so consumers can key cached per-frame
+    // state off the list. The comparison is on pointer values only; it
+    // cannot confuse a dropped tile with a new one at the same address,
+    // since the render snapshot keeps the previous list's tiles alive.
+    if (m_tilesScratch != m_tiles) {
+        std::swap(m_tiles, m_tilesScratch);
+        m_tilesVersion++;
+    }
+}
+
+void TileManager::cloneVisibleTiles(std::vector<std::shared_ptr<Tile>>& _out) {
+
+    _out.clear();
+    _out.reserve(m_tiles.size());
+
+    for (Tile* tile : m_tiles) {
+        std::shared_ptr<Tile> ref;
+
+        for (auto& tileSet : m_tileSets) {
+            if (tileSet.source->id() != tile->sourceID()) { continue; }
+
+            auto it = tileSet.tiles.find(tile->getID());
+            if (it != tileSet.tiles.end() && it->second.tile.get() == tile) {
+                ref = it->second.tile;
+            }
+            break;
+        }
+
+        if (!ref) {
+            // Transiently, the pointer may be backed by the tile cache
+            std::lock_guard<std::mutex> lock(m_cacheMutex);
+            ref = m_tileCache->contains(tile->sourceID(), tile->getID());
+        }
+
+        if (ref) { _out.push_back(std::move(ref)); }
+    }
 }
 
 void TileManager::updateTileSet(TileSet& _tileSet, const ViewState& _view,
-                                const std::set<TileID>& _visibleTiles) {
+                                const std::vector<TileID>& _visibleTiles) {
 
     bool newTiles = false;
 
+    _tileSet.updateTiles.clear();
+    _tileSet.updateLoadTasks.clear();
+    _tileSet.updateUploadQueue.clear();
+    _tileSet.updateTilesInProgress = 0;
+    _tileSet.updateLoadPending = 0;
+    _tileSet.updateTileSetChanged = false;
+
     if (_tileSet.sourceGeneration != _tileSet.source->generation()) {
         _tileSet.sourceGeneration = _tileSet.source->generation();
     }
@@ -160,9 +331,25 @@ void TileManager::updateTileSet(TileSet& _tileSet, const ViewState& _view,
     auto& tiles = _tileSet.tiles;
 
     // Check for ready tasks, move Tile to active TileSet and unset Proxies.
+    // A tile only completes once its meshes and raster textures are on the
+    // GPU: tasks still waiting on that are queued here and the render pass
+    // uploads them under a per-frame time budget, nearest to the view
+    // center first, so a burst of ready tiles cannot blow a frame on
+    // glBufferData time. Deferred tasks stay ready, with proxy tiles
+    // covering them until a later update completes them.
     for (auto& it : tiles) {
         auto& entry = it.second;
         if (entry.newData()) {
+            if (!entry.task->tile()->isUploaded()) {
+                auto tileCenter = _view.mapProjection->TileCenter(it.first);
+                double distance = glm::length2(tileCenter - _view.center);
+                _tileSet.updateUploadQueue.emplace_back(distance, entry.task->tile());
+                // Keep the tile set marked changed so the next update
+                // completes the task once its uploads are done.
+                _tileSet.updateTileSetChanged = true;
+                continue;
+            }
+
             clearProxyTiles(_tileSet, it.first, entry, removeTiles);
             entry.task->complete();
 
@@ -170,13 +357,13 @@ void TileManager::updateTileSet(TileSet& _tileSet, const ViewState& _view,
             entry.task.reset();
             newTiles = true;
 
-            m_tileSetChanged = true;
+            _tileSet.updateTileSetChanged = true;
         }
     }
 
     const auto* visibleTiles = &_visibleTiles;
 
-    std::set<TileID> mappedTiles;
+    std::vector<TileID> mappedTiles;
     if (_view.zoom > _tileSet.source->maxZoom()) {
         for (const auto& id : _visibleTiles) {
             auto tile = id.withMaxSourceZoom(_tileSet.source->maxZoom());
@@ -187,42 +374,51 @@ void TileManager::updateTileSet(TileSet& _tileSet, const ViewState& _view,
                                             tile.z == t.z &&
                                             tile.wrap == t.wrap; });
             if (other == mappedTiles.end()) {
-                mappedTiles.insert(tile);
+                mappedTiles.push_back(tile);
             } else if (other->s < tile.s) {
-                mappedTiles.erase(other);
-                mappedTiles.insert(tile);
+                *other = tile;
             }
         }
+        // The merge loop below expects a sorted range.
+        std::sort(mappedTiles.begin(), mappedTiles.end());
         visibleTiles = &mappedTiles;
     }
 
-    // Loop over visibleTiles and add any needed tiles to tileSet
-    auto curTilesIt = tiles.begin();
+    // Loop over visibleTiles and add any needed tiles to tileSet.
+    // Adding a visible tile or a proxy pulled from cache inserts into the
+    // flat tile storage and shifts its entries, so merge against a snapshot
+    // of the current keys and look entries up where they are needed.
+    std::vector<TileID> curTileIds;
+    curTileIds.reserve(tiles.size());
+    for (auto& it : tiles) { curTileIds.push_back(it.first); }
+
+    auto curTilesIt = curTileIds.begin();
     auto visTilesIt = visibleTiles->begin();
 
     auto generation = _tileSet.source->generation();
 
-    while (visTilesIt != visibleTiles->end() || curTilesIt != tiles.end()) {
+    while (visTilesIt != visibleTiles->end() || curTilesIt != curTileIds.end()) {
 
         auto& visTileId = visTilesIt == visibleTiles->end()
             ? NOT_A_TILE : *visTilesIt;
 
-        auto& curTileId = curTilesIt == tiles.end()
-            ? NOT_A_TILE : curTilesIt->first;
+        auto& curTileId = curTilesIt == curTileIds.end()
+            ? NOT_A_TILE : *curTilesIt;
 
         if (visTileId == curTileId) {
             // tiles in both sets match
             assert(visTilesIt != visibleTiles->end() &&
-                   curTilesIt != tiles.end());
+                   curTilesIt != curTileIds.end());
 
-            auto& entry = curTilesIt->second;
+            auto& entry = tiles.find(curTileId)->second;
             entry.setVisible(true);
 
             if (entry.isReady()) {
-                m_tiles.push_back(entry.tile);
+                _tileSet.updateTiles.push_back(entry.tile.get());
 
                 if (!entry.isLoading() &&
-                    (entry.tile->sourceGeneration() < generation)) {
+                    (entry.tile->sourceGeneration() < generation) &&
+                    _tileSet.source->tileNeedsRebuild(visTileId, entry.tile->sourceGeneration())) {
                     // Tile needs update - enqueue for loading
                     enqueueTask(_tileSet, visTileId, _view);
                 }
@@ -230,10 +426,11 @@ void TileManager::updateTileSet(TileSet& _tileSet, const ViewState& _view,
 
                 if (entry.isLoading() && entry.rastersPending() == 0) {
                     if (newTiles) {
-                        // check again for proxies
-                        updateProxyTiles(_tileSet, visTileId, entry);
+                        // check again for proxies; may insert, so no use
+                        // of 'entry' past this point
+                        updateProxyTiles(_tileSet, visTileId);
                     }
-                    m_tilesInProgress++;
+                    _tileSet.updateTilesInProgress++;
                 } else if (!bool(entry.task) ||
                            (entry.rastersPending() > 0 && !entry.isCanceled()) ||
                            (entry.isCanceled() && (entry.task->sourceGeneration() < generation))) {
@@ -245,7 +442,7 @@ void TileManager::updateTileSet(TileSet& _tileSet, const ViewState& _view,
                     // Not yet available - enqueue for loading
                     enqueueTask(_tileSet, visTileId, _view);
 
-                    m_tilesInProgress++;
+                    _tileSet.updateTilesInProgress++;
                 }
             }
 
@@ -262,20 +459,20 @@ void TileManager::updateTileSet(TileSet& _tileSet, const ViewState& _view,
             if (!addTile(_tileSet, visTileId)) {
                 // Not in cache - enqueue for loading
                 enqueueTask(_tileSet, visTileId, _view);
-                m_tilesInProgress++;
+                _tileSet.updateTilesInProgress++;
             }
 
             ++visTilesIt;
 
         } else {
             // tileSet has a tile not present in visibleTiles
-            assert(curTilesIt != tiles.end());
+            assert(curTilesIt != curTileIds.end());
 
-            auto& entry = curTilesIt->second;
+            auto& entry = tiles.find(curTileId)->second;
 
             if (entry.getProxyCounter() > 0) {
                 if (entry.isReady()) {
-                    m_tiles.push_back(entry.tile);
+                    _tileSet.updateTiles.push_back(entry.tile.get());
                 } else if (curTileId.z < maxZoom) {
                     // Cancel loading
                     removeTiles.push_back(curTileId);
@@ -331,21 +528,22 @@ void TileManager::updateTileSet(TileSet& _tileSet, const ViewState& _view,
             auto& id = it.first;
             auto& task = entry.task;
 
-            // Update tile distance to map center for load priority.
+            // Update tile distance to the velocity-projected map center
+            // for load priority.
             auto tileCenter = _view.mapProjection->TileCenter(id);
             double scaleDiv = exp2(id.z - _view.zoom);
             if (scaleDiv < 1) { scaleDiv = 0.1/scaleDiv; } // prefer parent tiles
-            task->setPriority(glm::length2(tileCenter - _view.center) * scaleDiv);
+            task->setPriority(glm::length2(tileCenter - _view.predictedCenter) * scaleDiv);
             task->setProxyState(entry.getProxyCounter() > 0);
 
             // Count tiles that are currently being downloaded to
             // limit download requests.
             if (!task->hasData()) {
-                m_loadPending++;
+                _tileSet.updateLoadPending++;
             }
 
             for (auto& subTask : task->subTasks()) {
-                if (!subTask->hasData()) { m_loadPending++; }
+                if (!subTask->hasData()) { _tileSet.updateLoadPending++; }
             }
         }
 
@@ -354,21 +552,83 @@ void TileManager::updateTileSet(TileSet& _tileSet, const ViewState& _view,
             entry.tile->setProxyState(entry.getProxyCounter() > 0);
         }
     }
+
+    // Sort the set's render list from high to low zoom-levels, here so
+    // the work runs on the set's own task when several sources update in
+    // parallel; updateTileSets only merges the sorted lists. Duplicates -
+    // a proxy can be added more than once - share a pointer within one
+    // set and so end up adjacent.
+    std::sort(_tileSet.updateTiles.begin(), _tileSet.updateTiles.end(),
+              [](auto& a, auto& b) { return a->getID() < b->getID(); });
+
+    _tileSet.updateTiles.erase(std::unique(_tileSet.updateTiles.begin(),
+                                           _tileSet.updateTiles.end()),
+                               _tileSet.updateTiles.end());
+}
+
+void TileManager::updatePrefetches(TileSet& _tileSet, const std::vector<TileID>& _prefetchTiles,
+                                   const ViewState& _view) {
+
+    auto& prefetches = _tileSet.prefetches;
+    auto sourceId = _tileSet.source->id();
+
+    // Park finished prefetch results in the cache, drop tasks for tiles
+    // that are no longer within the prefetch margin.
+    for (auto it = prefetches.begin(); it != prefetches.end();) {
+        auto& task = it->second;
+
+        if (task->isReady()) {
+            m_tileCache->put(sourceId, task->tile());
+            it = prefetches.erase(it);
+        } else if (task->isCanceled() ||
+                   !std::binary_search(_prefetchTiles.begin(), _prefetchTiles.end(), it->first)) {
+            task->cancel();
+            it = prefetches.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    for (const auto& id : _prefetchTiles) {
+
+        if (id.z > _tileSet.source->maxZoom()) { continue; }
+
+        // Already tracked as visible or proxy tile, in flight, or warm
+        if (_tileSet.tiles.find(id) != _tileSet.tiles.end()) { continue; }
+        if (prefetches.find(id) != prefetches.end()) { continue; }
+        if (m_tileCache->contains(sourceId, id)) { continue; }
+
+        auto task = _tileSet.source->createTask(id);
+
+        // Order prefetches behind all visible and proxy builds
+        auto tileCenter = _view.mapProjection->TileCenter(id);
+        task->setPriority(glm::length2(tileCenter - _view.predictedCenter));
+        task->setProxyState(true);
+        task->setPrefetch(true);
+
+        if (task->hasData()) {
+            prefetches.emplace(id, task);
+            m_dataCallback.func(std::move(task));
+
+        } else if (m_loadPending < MAX_DOWNLOADS) {
+            prefetches.emplace(id, task);
+            if (_tileSet.source->loadTileData(std::move(task), m_dataCallback)) {
+                m_loadPending++;
+            } else {
+                prefetches.erase(id);
+            }
+        }
+    }
 }
 
 void TileManager::enqueueTask(TileSet& _tileSet, const TileID& _tileID,
                               const ViewState& _view) {
 
-    // Keep the items sorted by distance
     auto tileCenter = _view.mapProjection->TileCenter(_tileID);
-    double distance = glm::length2(tileCenter - _view.center);
-
-    auto it = std::upper_bound(m_loadTasks.begin(), m_loadTasks.end(), distance,
-                               [](auto& distance, auto& other){
-                                   return distance < std::get<0>(other);
-                               });
+    double distance = glm::length2(tileCenter - _view.predictedCenter);
 
-    m_loadTasks.insert(it, std::make_tuple(distance, &_tileSet, _tileID));
+    // Collected per set; updateTileSets sorts the merged list by distance
+    _tileSet.updateLoadTasks.emplace_back(distance, _tileID);
 }
 
 // create and download raster references store these
@@ -428,15 +688,29 @@ void TileManager::loadTiles() {
         auto tileIt = tileSet.tiles.find(tileId);
         auto& entry = tileIt->second;
 
-        if (entry.task && entry.rastersPending() > 0 && !entry.isCanceled()) {
-            // just load the rasters and continue,
-            // the main tile task has already started loading
-            loadSubTasks(tileSet.source->rasterSources(), entry.task, tileId);
+        if (entry.task && !entry.isCanceled() &&
+            entry.task->sourceGeneration() == tileSet.source->generation()) {
+            // The main tile task has already started loading (possibly
+            // adopted from a prefetch) - just load pending rasters.
+            if (entry.rastersPending() > 0) {
+                loadSubTasks(tileSet.source->rasterSources(), entry.task, tileId);
+            }
             continue;
         }
 
         auto task = tileSet.source->createTask(tileId);
 
+        if (!tileSet.clientDataSource && !tileSet.source->isRaster() &&
+            tileSet.source->rasterSources().empty() &&
+            TileMeshCache::contains(*tileSet.source, tileId)) {
+            // A built tile from an earlier run is on disk; restore it on
+            // a worker instead of fetching and building from raw data.
+            task->setRestore();
+            entry.task = task;
+            m_workers.enqueue(std::move(task));
+            continue;
+        }
+
         if (task->hasData()) {
             // Note: Set implicit 'loading' state
             entry.task = task;
@@ -466,11 +740,15 @@ void TileManager::loadTiles() {
 
 bool TileManager::addTile(TileSet& _tileSet, const TileID& _tileID) {
 
-    auto tile = m_tileCache->get(_tileSet.source->id(), _tileID);
+    std::shared_ptr<Tile> tile;
+    {
+        std::lock_guard<std::mutex> lock(m_cacheMutex);
+        tile = m_tileCache->get(_tileSet.source->id(), _tileID);
+    }
 
     if (tile) {
         if (tile->sourceGeneration() == _tileSet.source->generation()) {
-            m_tiles.push_back(tile);
+            _tileSet.updateTiles.push_back(tile.get());
 
             // Update tile origin based on wrap (set in the new tileID)
             tile->updateTileOrigin(_tileID.wrap);
@@ -485,18 +763,30 @@ bool TileManager::addTile(TileSet& _tileSet, const TileID& _tileID) {
     }
 
     // Add TileEntry to TileSet
-    auto entry = _tileSet.tiles.emplace(_tileID, tile);
+    auto& entry = _tileSet.tiles[_tileID];
+    entry.tile = tile;
+    entry.setVisible(true);
 
     if (!tile) {
-        // Add Proxy if corresponding proxy MapTile ready
-        updateProxyTiles(_tileSet, _tileID, entry.first->second);
+        // Adopt an in-flight prefetch load for this tile, if any
+        auto prefetch = _tileSet.prefetches.find(_tileID);
+        if (prefetch != _tileSet.prefetches.end()) {
+            if (!prefetch->second->isCanceled()) {
+                entry.task = std::move(prefetch->second);
+                entry.task->setProxyState(false);
+            }
+            _tileSet.prefetches.erase(prefetch);
+        }
+
+        // Add Proxy if corresponding proxy MapTile ready; this may insert
+        // into the flat tile storage and relocate 'entry'
+        updateProxyTiles(_tileSet, _tileID);
     }
-    entry.first->second.setVisible(true);
 
     return bool(tile);
 }
 
-void TileManager::removeTile(TileSet& _tileSet, std::map<TileID, TileEntry>::iterator& _tileIt) {
+void TileManager::removeTile(TileSet& _tileSet, fastmap<TileID, TileEntry>::iterator& _tileIt) {
 
     auto& id = _tileIt->first;
     auto& entry = _tileIt->second;
@@ -511,7 +801,11 @@ void TileManager::removeTile(TileSet& _tileSet, std::map<TileID, TileEntry>::ite
 
     } else if (entry.isReady()) {
         // Add to cache
-        auto poppedTiles = m_tileCache->put(_tileSet.source->id(), entry.tile);
+        std::vector<TileID> poppedTiles;
+        {
+            std::lock_guard<std::mutex> lock(m_cacheMutex);
+            poppedTiles = m_tileCache->put(_tileSet.source->id(), entry.tile);
+        }
         for (auto& tileID : poppedTiles) {
             _tileSet.source->clearRaster(tileID);
         }
@@ -524,7 +818,7 @@ void TileManager::removeTile(TileSet& _tileSet, std::map<TileID, TileEntry>::ite
     _tileIt = _tileSet.tiles.erase(_tileIt);
 }
 
-bool TileManager::updateProxyTile(TileSet& _tileSet, TileEntry& _tile,
+bool TileManager::updateProxyTile(TileSet& _tileSet, const TileID& _tileID,
                                   const TileID& _proxyTileId,
                                   const ProxyID _proxyId) {
 
@@ -532,17 +826,23 @@ bool TileManager::updateProxyTile(TileSet& _tileSet, TileEntry& _tile,
 
     auto& tiles = _tileSet.tiles;
 
+    // Re-find the proxied tile on every call: a previous call may have
+    // inserted into the flat tile storage and relocated its entries.
+    auto tileIt = tiles.find(_tileID);
+    if (tileIt == tiles.end()) { return false; }
+    auto& tile = tileIt->second;
+
     // check if the proxy exists in the visible tile set
     {
         const auto& it = tiles.find(_proxyTileId);
         if (it != tiles.end()) {
             auto& entry = it->second;
 
-            if (!entry.isCanceled() && _tile.setProxy(_proxyId)) {
+            if (!entry.isCanceled() && tile.setProxy(_proxyId)) {
                 entry.incProxyCounter();
 
                 if (entry.isReady()) {
-                    m_tiles.push_back(entry.tile);
+                    _tileSet.updateTiles.push_back(entry.tile.get());
                 }
 
                 // Note: No need to check the cache: When the tile is in
@@ -554,14 +854,20 @@ bool TileManager::updateProxyTile(TileSet& _tileSet, TileEntry& _tile,
 
     // check if the proxy exists in the cache
     {
-        auto proxyTile = m_tileCache->get(_tileSet.source->id(), _proxyTileId);
-        if (proxyTile && _tile.setProxy(_proxyId)) {
+        std::shared_ptr<Tile> proxyTile;
+        {
+            std::lock_guard<std::mutex> lock(m_cacheMutex);
+            proxyTile = m_tileCache->get(_tileSet.source->id(), _proxyTileId);
+        }
+        if (proxyTile && tile.setProxy(_proxyId)) {
 
-            auto result = tiles.emplace(_proxyTileId, proxyTile);
-            auto& entry = result.first->second;
+            // Inserting invalidates 'tile' and 'tileIt'; neither is used
+            // past this point.
+            auto& entry = tiles[_proxyTileId];
+            entry.tile = proxyTile;
             entry.incProxyCounter();
 
-            m_tiles.push_back(proxyTile);
+            _tileSet.updateTiles.push_back(proxyTile.get());
             return true;
         }
     }
@@ -569,29 +875,83 @@ bool TileManager::updateProxyTile(TileSet& _tileSet, TileEntry& _tile,
     return false;
 }
 
-void TileManager::updateProxyTiles(TileSet& _tileSet, const TileID& _tileID, TileEntry& _tile) {
-    // TODO: this should be improved to use the nearest proxy tile available.
-    // Currently it would use parent or grand*parent  as proxies even if the
-    // child proxies would be more appropriate
+void TileManager::updateProxyTiles(TileSet& _tileSet, const TileID& _tileID) {
 
-    // Try parent proxy
-    auto parentID = _tileID.getParent();
     auto minZoom = _tileSet.source->minDisplayZoom();
+    auto parentID = _tileID.getParent();
+    auto grandparentID = parentID.getParent();
+
+    // Peek at a ready proxy candidate without pinning it, so the possible
+    // proxy sets can be compared by the memory they would retain. Holds a
+    // reference, since a concurrent set update may evict cached tiles.
+    auto peekProxy = [&](const TileID& id) -> std::shared_ptr<Tile> {
+        if (!id.isValid()) { return nullptr; }
+        auto it = _tileSet.tiles.find(id);
+        if (it != _tileSet.tiles.end()) {
+            return it->second.isReady() ? it->second.tile : nullptr;
+        }
+        std::lock_guard<std::mutex> lock(m_cacheMutex);
+        return m_tileCache->contains(_tileSet.source->id(), id);
+    };
+
+    // A single ancestor always covers the tile; take the cheaper of parent
+    // and grandparent when both are ready.
+    auto parent = (minZoom <= parentID.z) ? peekProxy(parentID) : nullptr;
+    auto grandparent = (minZoom <= grandparentID.z) ? peekProxy(grandparentID) : nullptr;
+
+    bool haveAncestor = parent || grandparent;
+    bool preferGrandparent = grandparent &&
+        (!parent || grandparent->getMemoryUsage() < parent->getMemoryUsage());
+    size_t ancestorCost = preferGrandparent ? grandparent->getMemoryUsage()
+                        : parent ? parent->getMemoryUsage() : 0;
+
+    // Four ready children also cover the tile, but usually at several times
+    // the cost of a coarser ancestor, and fewer than four leave a display
+    // gap - so a partial child set only beats having no ancestor at all.
+    size_t childCost = 0;
+    int childCount = 0;
+    bool childrenAllowed = _tileSet.source->maxZoom() > _tileID.z;
+    if (childrenAllowed) {
+        for (int i = 0; i < 4; i++) {
+            if (auto child = peekProxy(_tileID.getChild(i, _tileSet.source->maxZoom()))) {
+                childCost += child->getMemoryUsage();
+                childCount++;
+            } else {
+                childCount = 0;
+                break;
+            }
+        }
+    }
+
+    if (childCount == 4 && haveAncestor && childCost < ancestorCost) {
+        bool covered = false;
+        for (int i = 0; i < 4; i++) {
+            auto childID = _tileID.getChild(i, _tileSet.source->maxZoom());
+            covered |= updateProxyTile(_tileSet, _tileID, childID, static_cast<ProxyID>(1 << i));
+        }
+        if (covered) { return; }
+    }
+
+    // Pin the cheaper ready ancestor first; with neither ready this falls
+    // back to the old order, where a still-loading parent is worth keeping.
+    if (preferGrandparent
+            && updateProxyTile(_tileSet, _tileID, grandparentID, ProxyID::parent2)) {
+        return;
+    }
     if (minZoom <= parentID.z
-            && updateProxyTile(_tileSet, _tile, parentID, ProxyID::parent)) {
+            && updateProxyTile(_tileSet, _tileID, parentID, ProxyID::parent)) {
         return;
     }
-    // Try grandparent
-    auto grandparentID = parentID.getParent();
-    if (minZoom <= grandparentID.z
-            && updateProxyTile(_tileSet, _tile, grandparentID, ProxyID::parent2)) {
+    if (!preferGrandparent && minZoom <= grandparentID.z
+            && updateProxyTile(_tileSet, _tileID, grandparentID, ProxyID::parent2)) {
         return;
     }
-    // Try children
-    if (_tileSet.source->maxZoom() > _tileID.z) {
+
+    // Last resort: any partial child set beats an empty area.
+    if (childrenAllowed) {
         for (int i = 0; i < 4; i++) {
             auto childID = _tileID.getChild(i, _tileSet.source->maxZoom());
-            updateProxyTile(_tileSet, _tile, childID, static_cast<ProxyID>(1 << i));
+            updateProxyTile(_tileSet, _tileID, childID, static_cast<ProxyID>(1 << i));
         }
     }
 }
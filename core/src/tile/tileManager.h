@@ -12,7 +12,6 @@
 #include <memory>
 #include <mutex>
 #include <tuple>
-#include <set>
 #include <data/dataSource.h>
 
 namespace Tangram {
@@ -37,11 +36,23 @@ public:
 
     virtual ~TileManager();
 
-    /* Sets the tile DataSources */
-    void setDataSources(const std::vector<std::shared_ptr<DataSource>>& _sources);
-
-    /* Updates visible tile set and load missing tiles */
-    void updateTileSets(const ViewState& _view, const std::set<TileID>& _visibleTiles);
+    /* Sets the tile DataSources. When _keepTiles is set, built tiles of
+     * sources retained from the previous scene stay in place instead of
+     * being cleared; used by scene swaps whose tile geometry is unchanged. */
+    void setDataSources(const std::vector<std::shared_ptr<DataSource>>& _sources,
+                        bool _keepTiles = false);
+
+    /* Updates visible tile set and load missing tiles. _visibleTiles must
+     * be sorted and free of duplicates; _visibleTilesChanged says whether
+     * it differs from the previous update, letting derived sets like the
+     * prefetch ring be reused instead of recomputed every frame.
+     * _predictedTiles (sorted, unique, disjoint from _visibleTiles) are
+     * tiles along the predicted view trajectory - fling path or ease
+     * destination - added to the prefetch ring so they load before the
+     * view arrives. */
+    void updateTileSets(const ViewState& _view, const std::vector<TileID>& _visibleTiles,
+                        bool _visibleTilesChanged = true,
+                        const std::vector<TileID>& _predictedTiles = {});
 
     void clearTileSets();
 
@@ -50,6 +61,24 @@ public:
     /* Returns the set of currently visible tiles */
     const auto& getVisibleTiles() const { return m_tiles; }
 
+    /* Version of the render list, bumped whenever its contents change.
+     * Steady updates leave the list and the version untouched, so a
+     * consumer can key cached per-frame state - like the render tile
+     * snapshot - off the version instead of re-deriving it every frame. */
+    int64_t getTilesVersion() const { return m_tilesVersion; }
+
+    /* Copy owning references of the visible tiles into _out, preserving
+     * render order. The copy pins the tiles, so a caller can keep
+     * drawing the set while the live one changes underneath. */
+    void cloneVisibleTiles(std::vector<std::shared_ptr<Tile>>& _out);
+
+    /* Tiles whose build finished but whose meshes and raster textures
+     * have not reached the GPU yet, nearest to the view center first.
+     * The render pass drains this under a per-frame time budget; a tile
+     * joins the visible set on the update after its upload, with proxy
+     * tiles covering it until then. */
+    const auto& getUploadQueue() const { return m_uploadQueue; }
+
     bool hasTileSetChanged() { return m_tileSetChanged; }
 
     bool hasLoadingTiles() { return m_tilesInProgress > 0; }
@@ -67,6 +96,11 @@ public:
      */
     void setCacheSize(size_t _cacheSize);
 
+    /* @_margin: Number of tile rings around the visible set to load at
+     * background priority (along with parent tiles); 0 disables prefetching.
+     */
+    void setPrefetchMargin(int _margin) { m_prefetchMargin = _margin; m_prefetchRing.clear(); }
+
 private:
 
     enum class ProxyID : uint8_t {
@@ -177,12 +211,39 @@ private:
             : source(_source), clientDataSource(_clientDataSource) {}
 
         std::shared_ptr<DataSource> source;
-        std::map<TileID, TileEntry> tiles;
+
+        // Sorted flat storage: updateTileSet traverses all entries every
+        // frame, which stays a linear scan of contiguous memory here while
+        // a node-based map would chase pointers. Inserting invalidates
+        // iterators and entry references, so mutating passes work on key
+        // snapshots or re-find entries by TileID.
+        fastmap<TileID, TileEntry> tiles;
+
+        // In-flight loads for tiles just outside the visible set; built
+        // results are parked in the TileCache until they become visible.
+        std::map<TileID, std::shared_ptr<TileTask>> prefetches;
+
         int64_t sourceGeneration = 0;
         bool clientDataSource;
+
+        // Scratch output of updateTileSet, which may run on its own task
+        // when several sources are active; merged into the shared lists
+        // by updateTileSets afterwards. Kept on the set so the vector
+        // capacity is reused across frames.
+        std::vector<Tile*> updateTiles;
+        std::vector<std::pair<double, TileID>> updateLoadTasks;
+        std::vector<std::pair<double, std::shared_ptr<Tile>>> updateUploadQueue;
+        int32_t updateTilesInProgress = 0;
+        int32_t updateLoadPending = 0;
+        bool updateTileSetChanged = false;
     };
 
-    void updateTileSet(TileSet& tileSet, const ViewState& _view, const std::set<TileID>& _visibleTiles);
+    void updateTileSet(TileSet& tileSet, const ViewState& _view, const std::vector<TileID>& _visibleTiles);
+
+    /* Starts background-priority loads for _prefetchTiles (sorted, unique)
+     * and parks finished prefetch results in the TileCache. */
+    void updatePrefetches(TileSet& _tileSet, const std::vector<TileID>& _prefetchTiles,
+                          const ViewState& _view);
 
     void enqueueTask(TileSet& _tileSet, const TileID& _tileID, const ViewState& _view);
 
@@ -200,14 +261,15 @@ private:
     /*
      * Removes a tile from m_tileSet
      */
-    void removeTile(TileSet& _tileSet, std::map<TileID, TileEntry>::iterator& _tileIter);
+    void removeTile(TileSet& _tileSet, fastmap<TileID, TileEntry>::iterator& _tileIter);
 
     /*
      * Checks and updates m_tileSet with proxy tiles for every new visible tile
-     *  @_tile: Tile, the new visible tile for which proxies needs to be added
+     *  @_tileID: TileID of the new visible tile for which proxies needs to be
+     *  added; passed by id since adding a proxy may reallocate the tile storage
      */
-    bool updateProxyTile(TileSet& _tileSet, TileEntry& _tile, const TileID& _proxy, const ProxyID _proxyID);
-    void updateProxyTiles(TileSet& _tileSet, const TileID& _tileID, TileEntry& _tile);
+    bool updateProxyTile(TileSet& _tileSet, const TileID& _tileID, const TileID& _proxy, const ProxyID _proxyID);
+    void updateProxyTiles(TileSet& _tileSet, const TileID& _tileID);
 
     /*
      * Once a visible tile finishes loading and is added to m_tileSet, all
@@ -218,17 +280,52 @@ private:
     int32_t m_loadPending = 0;
     int32_t m_tilesInProgress = 0;
 
+    int m_prefetchMargin = 1;
+
+    // Ring of tiles around the visible set plus predicted tiles to warm
+    // up; reused while its inputs are unchanged between updates.
+    std::vector<TileID> m_prefetchRing;
+    std::vector<TileID> m_lastPredictedTiles;
+
     std::vector<TileSet> m_tileSets;
 
-    /* Current tiles ready for rendering */
-    std::vector<std::shared_ptr<Tile>> m_tiles;
+    /* Current tiles ready for rendering. Non-owning: every pointer is
+     * backed by a live TileEntry (or, transiently, the tile cache), and
+     * the list is rebuilt by updateTileSets before any entry it points
+     * into can be dropped. Anything that clears tile entries outside of
+     * updateTileSets must clear this list too. Keeping the render list
+     * free of shared_ptr copies avoids per-tile refcount traffic every
+     * frame. */
+    std::vector<Tile*> m_tiles;
+
+    // Merge target for the per-set render lists; swapped with m_tiles
+    // only when the merged list differs, keeping both allocations warm.
+    std::vector<Tile*> m_tilesScratch;
+
+    // Bumped whenever m_tiles changes; never decreases.
+    int64_t m_tilesVersion = 1;
+
+    /* Pending uploads merged from the per-set queues, sorted by squared
+     * distance to the view center. Owning references: the tiles must
+     * outlive the render pass that uploads them even if their task is
+     * canceled in between. */
+    std::vector<std::pair<double, std::shared_ptr<Tile>>> m_uploadQueue;
 
     std::unique_ptr<TileCache> m_tileCache;
 
+    // Guards m_tileCache while the per-set updates run in parallel; the
+    // sets touch disjoint cache keys, so only container integrity needs
+    // protection, not cross-call atomicity.
+    std::mutex m_cacheMutex;
+
     TileTaskQueue& m_workers;
 
     bool m_tileSetChanged = false;
 
+    // Coalesces render requests from completing raster sub-tasks to one
+    // platform wakeup per update tick.
+    std::atomic<bool> m_renderRequested{false};
+
     /* Callback for DataSource:
      * Passes TileTask back with data for further processing by <TileWorker>s
      */
@@ -0,0 +1,300 @@
+#include "tileMeshCache.h"
+
+#include "data/dataSource.h"
+#include "data/properties.h"
+#include "gl/mesh.h"
+#include "platform.h"
+#include "scene/scene.h"
+#include "selection/featureSelection.h"
+#include "style/style.h"
+#include "tile/tile.h"
+#include "log.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+
+namespace Tangram {
+namespace TileMeshCache {
+
+static std::string s_cachePath;
+
+// Written by the scene loading thread, read by tile workers; the tile
+// sets of an outgoing scene are cleared before the new key is used, so a
+// torn read can at worst miss.
+static std::atomic<uint64_t> s_sceneKey{0};
+
+// Bump whenever the entry layout or the mesh buffer format changes; old
+// entries then simply miss.
+static const uint32_t format_version = 1;
+
+static const char format_magic[4] = { 'T', 'G', 'T', 'M' };
+
+struct EntryHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t styleCount;
+    uint32_t featureCount;
+};
+
+static uint64_t fnv1a(uint64_t _hash, const char* _data, size_t _size) {
+    for (size_t i = 0; i < _size; i++) {
+        _hash = (_hash ^ uint8_t(_data[i])) * 0x100000001b3;
+    }
+    return _hash;
+}
+
+void setCachePath(const std::string& _path) {
+    s_cachePath = _path;
+}
+
+void setScene(const std::string& _scenePath, const std::vector<SceneUpdate>& _updates) {
+
+    uint64_t hash = 0xcbf29ce484222325;
+    hash = fnv1a(hash, _scenePath.data(), _scenePath.size());
+
+    auto root = stringFromFile(_scenePath.c_str());
+    hash = fnv1a(hash, root.data(), root.size());
+
+    for (const auto& update : _updates) {
+        hash = fnv1a(hash, update.path.data(), update.path.size());
+        hash = fnv1a(hash, update.value.data(), update.value.size());
+    }
+
+    s_sceneKey = hash;
+}
+
+// Key the entry on the active scene, the source name and generation and
+// the tile coordinates. Source names are stable across runs while source
+// ids are not; generations of unmodified sources restart at the same
+// value, so entries of a previous run keep matching.
+static std::string entryPath(const DataSource& _source, const TileID& _tileId) {
+
+    uint64_t hash = s_sceneKey.load();
+
+    const auto& name = _source.name();
+    hash = fnv1a(hash, name.data(), name.size());
+
+    int64_t generation = _source.generation();
+    hash = fnv1a(hash, reinterpret_cast<const char*>(&generation), sizeof(generation));
+
+    int32_t coords[5] = { _tileId.x, _tileId.y, _tileId.z, _tileId.s, _tileId.wrap };
+    hash = fnv1a(hash, reinterpret_cast<const char*>(coords), sizeof(coords));
+
+    char entry[32];
+    snprintf(entry, sizeof(entry), "%016" PRIx64 ".tgtm", hash);
+
+    return s_cachePath + "/" + entry;
+}
+
+bool contains(const DataSource& _source, const TileID& _tileId) {
+
+    if (s_cachePath.empty() || s_sceneKey == 0) { return false; }
+
+    FILE* file = fopen(entryPath(_source, _tileId).c_str(), "rb");
+    if (!file) { return false; }
+    fclose(file);
+
+    return true;
+}
+
+void store(const Scene& _scene, const DataSource& _source, const Tile& _tile) {
+
+    if (s_cachePath.empty() || s_sceneKey == 0) { return; }
+
+    auto path = entryPath(_source, _tile.getID());
+
+    if (FILE* present = fopen(path.c_str(), "rb")) {
+        fclose(present);
+        return;
+    }
+
+    std::vector<char> payload;
+    auto append = [&](const void* _data, size_t _size) {
+        auto* bytes = reinterpret_cast<const char*>(_data);
+        payload.insert(payload.end(), bytes, bytes + _size);
+    };
+    auto appendString = [&](const std::string& _string) {
+        uint32_t length = _string.size();
+        append(&length, sizeof(length));
+        append(_string.data(), _string.size());
+    };
+
+    uint32_t styleCount = 0;
+    for (const auto& style : _scene.styles()) {
+        const auto& mesh = _tile.getMesh(*style);
+        if (!mesh) { continue; }
+
+        std::vector<char> buffers;
+        if (!mesh->serialize(buffers)) {
+            // A label mesh; this tile cannot be restored from raw buffers
+            return;
+        }
+
+        appendString(style->getName());
+        uint32_t size = buffers.size();
+        append(&size, sizeof(size));
+        append(buffers.data(), buffers.size());
+        styleCount++;
+    }
+
+    uint32_t featureCount = 0;
+    for (const auto& feature : _tile.getSelectionFeatures()) {
+        if (!feature.second) { continue; }
+
+        uint32_t id = feature.first;
+        append(&id, sizeof(id));
+
+        const auto& items = feature.second->items();
+        uint32_t itemCount = items.size();
+        append(&itemCount, sizeof(itemCount));
+
+        for (const auto& item : items) {
+            appendString(item.key);
+            uint8_t isString = item.value.is<std::string>();
+            append(&isString, sizeof(isString));
+            if (isString) {
+                appendString(item.value.get<std::string>());
+            } else {
+                double number = item.value.is<double>() ? item.value.get<double>() : 0;
+                append(&number, sizeof(number));
+            }
+        }
+        featureCount++;
+    }
+
+    EntryHeader header;
+    memcpy(header.magic, format_magic, sizeof(format_magic));
+    header.version = format_version;
+    header.styleCount = styleCount;
+    header.featureCount = featureCount;
+
+    FILE* file = fopen(path.c_str(), "wb");
+    if (!file) { return; }
+
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+              fwrite(payload.data(), 1, payload.size(), file) == payload.size();
+    fclose(file);
+
+    if (!ok) { std::remove(path.c_str()); }
+}
+
+std::shared_ptr<Tile> load(const Scene& _scene, const DataSource& _source,
+                           const TileID& _tileId) {
+
+    if (s_cachePath.empty() || s_sceneKey == 0) { return nullptr; }
+
+    auto path = entryPath(_source, _tileId);
+
+    FILE* file = fopen(path.c_str(), "rb");
+    if (!file) { return nullptr; }
+
+    EntryHeader header;
+    std::vector<char> payload;
+
+    bool ok = fread(&header, sizeof(header), 1, file) == 1 &&
+              memcmp(header.magic, format_magic, sizeof(format_magic)) == 0 &&
+              header.version == format_version;
+    if (ok) {
+        long begin = ftell(file);
+        fseek(file, 0, SEEK_END);
+        payload.resize(ftell(file) - begin);
+        fseek(file, begin, SEEK_SET);
+        ok = fread(payload.data(), 1, payload.size(), file) == payload.size();
+    }
+    fclose(file);
+
+    const char* pos = payload.data();
+    const char* end = pos + payload.size();
+
+    auto read = [&](void* _data, size_t _size) {
+        if (size_t(end - pos) < _size) { return false; }
+        memcpy(_data, pos, _size);
+        pos += _size;
+        return true;
+    };
+    auto readString = [&](std::string& _string) {
+        uint32_t length = 0;
+        if (!read(&length, sizeof(length)) || size_t(end - pos) < length) { return false; }
+        _string.assign(pos, length);
+        pos += length;
+        return true;
+    };
+
+    std::shared_ptr<Tile> tile;
+    if (ok) {
+        tile = std::make_shared<Tile>(_tileId, *_scene.mapProjection(), &_source);
+        tile->initGeometry(_scene.styles().size());
+    }
+
+    for (uint32_t i = 0; ok && i < header.styleCount; i++) {
+        std::string name;
+        uint32_t size = 0;
+        ok = readString(name) && read(&size, sizeof(size)) && size_t(end - pos) >= size;
+        if (!ok) { break; }
+
+        const Style* style = nullptr;
+        for (const auto& s : _scene.styles()) {
+            if (s->getName() == name) { style = s.get(); break; }
+        }
+
+        if (style) {
+            auto mesh = std::make_unique<RestoredMesh>(style->vertexLayout(),
+                                                       style->drawMode());
+            ok = mesh->restore(pos, size);
+            if (ok) { tile->setMesh(*style, std::move(mesh)); }
+        } else {
+            ok = false;
+        }
+        pos += size;
+    }
+
+    fastmap<uint32_t, std::shared_ptr<Properties>> features;
+    uint32_t maxSelectionId = 0;
+    for (uint32_t i = 0; ok && i < header.featureCount; i++) {
+        uint32_t id = 0;
+        uint32_t itemCount = 0;
+        ok = read(&id, sizeof(id)) && read(&itemCount, sizeof(itemCount));
+        maxSelectionId = std::max(maxSelectionId, id);
+
+        auto props = std::make_shared<Properties>();
+        for (uint32_t n = 0; ok && n < itemCount; n++) {
+            std::string key;
+            uint8_t isString = 0;
+            ok = readString(key) && read(&isString, sizeof(isString));
+            if (!ok) { break; }
+
+            if (isString) {
+                std::string value;
+                if ((ok = readString(value))) { props->set(std::move(key), std::move(value)); }
+            } else {
+                double number = 0;
+                if ((ok = read(&number, sizeof(number)))) { props->set(std::move(key), number); }
+            }
+        }
+        if (ok) { features[id] = std::move(props); }
+    }
+
+    if (!ok || pos != end) {
+        LOGW("Removing malformed tile mesh cache entry %s", path.c_str());
+        std::remove(path.c_str());
+        return nullptr;
+    }
+
+    // The restored meshes carry selection colors baked into their vertex
+    // data by a previous session, whose counter does not restart with
+    // this one; move the live counter past them so new builds cannot
+    // hand the same identifiers out again.
+    if (maxSelectionId > 0) {
+        _scene.featureSelection()->reserveColorIdentifiers(maxSelectionId);
+    }
+
+    tile->setSelectionFeatures(features);
+
+    return tile;
+}
+
+}
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "tangram.h"
+#include "tile/tileID.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Tangram {
+
+class DataSource;
+class Scene;
+class Tile;
+
+/*
+ * TileMeshCache - On-disk cache of built tiles, keyed by the active scene,
+ * the data source name and generation, and the tile coordinates. An entry
+ * holds the compiled vertex and index buffers of the tile's meshes plus its
+ * selection feature properties, so a relaunch into the same viewport
+ * restores tiles with file reads and GL uploads only, skipping the fetch,
+ * parse and build stages entirely. The cache is inactive until the host
+ * application provides a writable directory with setCachePath().
+ *
+ * Only tiles whose meshes round-trip through raw buffers are stored; label
+ * meshes reference glyph and sprite atlas state of the running instance
+ * and make their tile ineligible. The scene key uses the same inputs as
+ * SceneCache, and shares its caveat that edits to imported scene files are
+ * not revalidated.
+ */
+namespace TileMeshCache {
+
+/* Set the directory used to store built tiles; an empty string disables
+ * the cache. The directory must already exist and be writable. */
+void setCachePath(const std::string& _path);
+
+/* Bind entries to the scene being loaded; called when a scene is resolved. */
+void setScene(const std::string& _scenePath, const std::vector<SceneUpdate>& _updates);
+
+/* Whether a stored entry exists for this tile of _source. */
+bool contains(const DataSource& _source, const TileID& _tileId);
+
+/* Store the built meshes and selection properties of _tile; no-op when the
+ * cache is disabled, an entry exists already, or the tile is ineligible. */
+void store(const Scene& _scene, const DataSource& _source, const Tile& _tile);
+
+/* Restore a tile from its stored entry; returns null and removes the entry
+ * when it is missing or malformed. */
+std::shared_ptr<Tile> load(const Scene& _scene, const DataSource& _source,
+                           const TileID& _tileId);
+
+}
+
+}
@@ -1,8 +1,11 @@
 #include "tileTask.h"
 #include "data/dataSource.h"
 #include "tile/tileBuilder.h"
+#include "tile/tileMeshCache.h"
 #include "scene/scene.h"
+#include "util/compression.h"
 #include "util/mapProjection.h"
+#include "util/memoryArena.h"
 #include "tile/tile.h"
 
 namespace Tangram {
@@ -14,14 +17,96 @@ TileTask::TileTask(TileID& _tileId, std::shared_ptr<DataSource> _source, int _su
     m_sourceGeneration(_source->generation()),
     m_priority(0) {}
 
+void TileTask::parse(TileBuilder& _tileBuilder) {
+
+    // Rebuilding the same data tile at another styling zoom - e.g. the
+    // children of a proxy right after a one-level zoom past the source
+    // max-zoom, or a cached tile re-entering the view - reuses the
+    // decode done for the earlier build.
+    m_tileData = m_source->parsedDataGet(m_tileId, m_sourceGeneration);
+
+    if (!m_tileData) {
+        // All geometry decoded below is bump-allocated from one arena
+        // and freed wholesale when the TileData goes away.
+        auto arena = std::make_shared<MemoryArena>();
+        {
+            MemoryArena::Scope scope(arena.get());
+            m_tileData = m_source->parse(*this, *_tileBuilder.scene().mapProjection());
+        }
+
+        if (m_tileData) {
+            m_tileData->arena = std::move(arena);
+            m_source->parsedDataPut(m_tileId, m_sourceGeneration, m_tileData);
+        }
+    }
+
+    if (!m_tileData) {
+        cancel();
+    }
+}
+
 void TileTask::process(TileBuilder& _tileBuilder) {
 
-    auto tileData = m_source->parse(*this, *_tileBuilder.scene().mapProjection());
+    if (m_restore) {
+        m_tile = TileMeshCache::load(_tileBuilder.scene(), *m_source, m_tileId);
+        if (!m_tile) {
+            // The entry vanished or was malformed (load() removed it);
+            // cancel like a failed load, the tile is retried when the
+            // source generation increases.
+            cancel();
+        }
+        return;
+    }
+
+    if (!m_tileData) {
+        parse(_tileBuilder);
+    }
 
-    if (tileData) {
-        m_tile = _tileBuilder.build(m_tileId, *tileData, *m_source);
-    } else {
+    if (m_canceled) { return; }
+
+    m_tile = _tileBuilder.build(m_tileId, *m_tileData, *m_source, this);
+
+    m_tileData.reset();
+
+    if (!m_tile) {
         cancel();
+        return;
+    }
+
+    // Store plain-mesh tiles for instant restore on the next launch;
+    // store() skips tiles whose meshes cannot be serialized. Raster and
+    // client sources are left out - their tiles reference textures or
+    // content of the running instance.
+    if (!isSubTask() && m_subTasks.empty() && !m_source->isRaster() &&
+        !m_source->isClient() && m_source->rasterSources().empty()) {
+        TileMeshCache::store(_tileBuilder.scene(), *m_source, *m_tile);
+    }
+}
+
+void DownloadTileTask::decompressRawData() {
+
+    if (rawTileDataCompressed) {
+        auto plain = std::make_shared<std::vector<char>>();
+        if (lzDecompress(*rawTileData, *plain)) {
+            rawTileData = std::move(plain);
+        } else {
+            // Never produced by RawCache; treat like a failed download.
+            // The shared cache buffer stays untouched.
+            rawTileData = std::make_shared<std::vector<char>>();
+        }
+        rawTileDataCompressed = false;
+    }
+
+    // Responses the platform network layer passed through undecoded
+    // keep their transport gzip all the way into the caches; unpack
+    // here, on the worker, right before the format parse.
+    if (rawTileData && isGzipped(*rawTileData)) {
+        auto plain = std::make_shared<std::vector<char>>();
+        if (gzipDecompress(*rawTileData, *plain)) {
+            rawTileData = std::move(plain);
+        } else {
+            rawTileData = std::make_shared<std::vector<char>>();
+        }
     }
 }
 
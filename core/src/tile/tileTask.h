@@ -1,6 +1,7 @@
 #pragma once
 
 #include "tile/tileID.h"
+#include "platform.h"
 
 #include <memory>
 #include <vector>
@@ -54,11 +55,31 @@ public:
     void setProxyState(bool isProxy) { m_proxyState = isProxy; }
     bool isProxy() const { return m_proxyState; }
 
+    // Mark this task as a speculative prefetch; its network request
+    // yields to fetches for tiles that are actually on screen.
+    void setPrefetch(bool isPrefetch) { m_prefetch = isPrefetch; }
+    bool isPrefetch() const { return m_prefetch; }
+
+    // Mark this task to restore its tile from the tile mesh disk cache
+    // instead of fetching, parsing and building; set by TileManager when
+    // a stored entry exists, consumed by process().
+    void setRestore() { m_restore = true; }
+    bool isRestore() const { return m_restore; }
+
     auto& subTasks() { return m_subTasks; }
     int subTaskId() const { return m_subTaskId; }
     bool isSubTask() const { return m_subTaskId >= 0; }
 
-    // running on worker thread
+    // running on worker thread: decode raw tile data into TileData.
+    // Split from process() so the memory-bound parse stage of one tile
+    // can overlap with the compute-bound build stage of another.
+    virtual void parse(TileBuilder& _tileBuilder);
+
+    // Whether the parse stage still has to run for this task
+    virtual bool needsParsing() const { return !m_tileData; }
+
+    // running on worker thread: build styled meshes from parsed data,
+    // parsing first if the parse stage did not run separately.
     virtual void process(TileBuilder& _tileBuilder);
 
     // running on main thread when the tile is added to
@@ -67,6 +88,15 @@ public:
     // onDone for sub-tasks
     virtual void complete(TileTask& _mainTask) {}
 
+    // Stage durations of this task, stamped by TileWorker and summarized
+    // by TileStats once the build stage is done. Tasks pass through the
+    // worker queues twice - once for parse, once for build - so the
+    // queue wait accumulates across both.
+    int64_t enqueuedAt = 0;
+    float queueWaitMs = 0.f;
+    float parseMs = 0.f;
+    float buildMs = 0.f;
+
 protected:
 
     const TileID m_tileId;
@@ -81,6 +111,9 @@ protected:
 
     const int64_t m_sourceGeneration;
 
+    // Parsed tile data, set by the parse stage and consumed by the build stage
+    std::shared_ptr<TileData> m_tileData;
+
     // Tile result, set when tile was  sucessfully created
     std::shared_ptr<Tile> m_tile;
 
@@ -88,6 +121,8 @@ protected:
 
     std::atomic<float> m_priority;
     bool m_proxyState = false;
+    bool m_prefetch = false;
+    bool m_restore = false;
 };
 
 class DownloadTileTask : public TileTask {
@@ -96,10 +131,31 @@ public:
         : TileTask(_tileId, _source, _subTask) {}
 
     virtual bool hasData() const override {
-        return rawTileData && !rawTileData->empty();
+        return rawTileData && !rawTileData->empty() && !rawTileDataStale;
     }
+
+    // running on worker thread: inflate a compressed cache entry, or a
+    // gzip response the network layer left undecoded, before decoding
+    // it. The cache keeps its compressed copy; this task gets its own
+    // plain buffer.
+    void parse(TileBuilder& _tileBuilder) override {
+        decompressRawData();
+        TileTask::parse(_tileBuilder);
+    }
+
+    void decompressRawData();
+
     // Raw tile data that will be processed by DataSource.
     std::shared_ptr<std::vector<char>> rawTileData;
+
+    // Set when rawTileData holds a compressed RawCache entry
+    bool rawTileDataCompressed = false;
+
+    // Set when rawTileData is a copy kept across a generation bump that
+    // the server has not confirmed yet; cachedValidators then name it
+    // for a conditional refetch, and a 304 puts it back into service.
+    bool rawTileDataStale = false;
+    UrlValidators cachedValidators;
 };
 
 struct TileTaskQueue {
@@ -5,22 +5,109 @@
 #include "tile/tileID.h"
 #include "tile/tileTask.h"
 #include "tile/tileBuilder.h"
+#include "debug/tileStats.h"
+#include "debug/trace.h"
 #include "tangram.h"
 #include "log.h"
 
 #include <algorithm>
+#include <chrono>
 
 #define WORKER_NICENESS 10
 
 namespace Tangram {
 
+namespace {
+
+// Orders pending tasks so that the visually most important one is the
+// min_element of a deque.
+bool taskComesFirst(const std::shared_ptr<TileTask>& a, const std::shared_ptr<TileTask>& b) {
+    if (a->isProxy() != b->isProxy()) {
+        return !a->isProxy();
+    }
+    if (a->source().id() == b->source().id() &&
+        a->sourceGeneration() != b->sourceGeneration()) {
+        return a->sourceGeneration() < b->sourceGeneration();
+    }
+    return a->getPriority() < b->getPriority();
+}
+
+// Take the best non-canceled task out of _queue, dropping canceled
+// entries along the way. _queue must be locked by the caller.
+std::shared_ptr<TileTask> popBest(std::deque<std::shared_ptr<TileTask>>& _queue,
+                                  std::atomic<int>& _pending) {
+
+    auto removes = std::remove_if(_queue.begin(), _queue.end(),
+                                  [](const auto& a) { return a->isCanceled(); });
+
+    if (removes != _queue.end()) {
+        _pending -= std::distance(removes, _queue.end());
+        _queue.erase(removes, _queue.end());
+    }
+
+    if (_queue.empty()) { return nullptr; }
+
+    auto it = std::min_element(_queue.begin(), _queue.end(), taskComesFirst);
+
+    auto task = std::move(*it);
+    _queue.erase(it);
+    _pending--;
+
+    return task;
+}
+
+int64_t timeNowMicroseconds() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+}
+
 TileWorker::TileWorker(int _num_worker) {
     m_running = true;
+    m_pendingTasks = 0;
+    m_sleepingWorkers = 0;
+    m_activeWorkers = 0;
+    m_nextWorker = 0;
+
+    // Allocate slots up to the hardware limit, but only start the
+    // requested number of threads; growPool() starts the rest when the
+    // backlog calls for it.
+    int maxWorkers = std::max<int>(_num_worker, std::thread::hardware_concurrency());
+
+    for (int i = 0; i < maxWorkers; i++) {
+        m_workers.push_back(std::make_unique<Worker>());
+    }
 
     for (int i = 0; i < _num_worker; i++) {
-        auto worker = std::make_unique<Worker>();
-        worker->thread = std::thread(&TileWorker::run, this, worker.get());
-        m_workers.push_back(std::move(worker));
+        startWorker(*m_workers[i]);
+    }
+}
+
+void TileWorker::startWorker(Worker& _worker) {
+    _worker.active = true;
+    m_activeWorkers++;
+    _worker.thread = std::thread(&TileWorker::run, this, &_worker);
+}
+
+void TileWorker::growPool() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    if (!m_running) { return; }
+
+    if (!m_scene) { return; }
+
+    // Bringing more cores in defeats the point of a bounded power draw;
+    // the backlog drains at the throttled pace instead.
+    if (m_maxConcurrentTasks > 0 || m_dutyCyclePct < 100) { return; }
+
+    for (auto& worker : m_workers) {
+        if (worker->active) { continue; }
+
+        // The new thread constructs its own builder before taking tasks.
+        worker->pendingScene = m_scene;
+        startWorker(*worker);
+        return;
     }
 }
 
@@ -30,6 +117,36 @@ TileWorker::~TileWorker(){
     }
 }
 
+std::shared_ptr<TileTask> TileWorker::takeTask(Worker* _worker) {
+
+    {
+        std::unique_lock<std::mutex> lock(_worker->mutex);
+
+        // Drain the shared handoff ring into the local deque first, so
+        // ring entries take part in priority selection.
+        std::shared_ptr<TileTask> incoming;
+        while (m_sharedQueue.pop(incoming)) {
+            _worker->queue.push_back(std::move(incoming));
+        }
+
+        if (auto task = popBest(_worker->queue, m_pendingTasks)) {
+            return task;
+        }
+    }
+
+    // Own deque is drained - steal from a sibling.
+    for (auto& other : m_workers) {
+        if (other.get() == _worker) { continue; }
+
+        std::unique_lock<std::mutex> lock(other->mutex);
+        if (auto task = popBest(other->queue, m_pendingTasks)) {
+            return task;
+        }
+    }
+
+    return nullptr;
+}
+
 void TileWorker::run(Worker* instance) {
 
     setCurrentThreadPriority(WORKER_NICENESS);
@@ -38,85 +155,195 @@ void TileWorker::run(Worker* instance) {
 
     while (true) {
 
-        std::shared_ptr<TileTask> task;
+        std::shared_ptr<Scene> pendingScene;
         {
             std::unique_lock<std::mutex> lock(m_mutex);
 
+            m_sleepingWorkers++;
             m_condition.wait(lock, [&, this]{
-                    return !m_running || !m_queue.empty();
+                    return !m_running || m_pendingTasks > 0 || instance->pendingScene;
                 });
+            m_sleepingWorkers--;
 
             if (instance->tileBuilder) {
                 builder = std::move(instance->tileBuilder);
                 LOG("Passed new TileBuilder to TileWorker");
             }
+            pendingScene = std::move(instance->pendingScene);
 
             // Check if thread should stop
             if (!m_running) {
                 break;
             }
+        }
 
-            if (!builder) {
-                continue;
-            }
+        if (pendingScene) {
+            // Construct and warm the builder here, off the render thread;
+            // with all workers woken on a scene swap this runs
+            // concurrently across the pool before the first task arrives.
+            TRACE_SCOPE("worker:scene-setup");
+            builder = std::make_unique<TileBuilder>(pendingScene);
+        }
 
-            // Remove all canceled tasks
-            auto removes = std::remove_if(m_queue.begin(), m_queue.end(),
-                                          [](const auto& a) { return a->isCanceled(); });
+        if (!builder) {
+            continue;
+        }
 
-            m_queue.erase(removes, m_queue.end());
+        // Throttled mode: reserve one of the capped build slots, or
+        // park until a finishing worker frees one.
+        int maxConcurrent = m_maxConcurrentTasks.load();
+        if (maxConcurrent > 0 && m_runningTasks.fetch_add(1) >= maxConcurrent) {
+            m_runningTasks--;
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_condition.wait_for(lock, std::chrono::milliseconds(50), [&, this] {
+                    return !m_running || m_runningTasks < maxConcurrent;
+                });
+            continue;
+        }
 
-            if (m_queue.empty()) {
-                continue;
-            }
+        int64_t taskStart = timeNowMicroseconds();
 
-            // Pop highest priority tile from queue
-            auto it = std::min_element(m_queue.begin(), m_queue.end(),
-                [](const auto& a, const auto& b) {
-                    if (a->isProxy() != b->isProxy()) {
-                        return !a->isProxy();
-                    }
-                    if (a->source().id() == b->source().id() &&
-                        a->sourceGeneration() != b->sourceGeneration()) {
-                        return a->sourceGeneration() < b->sourceGeneration();
-                    }
-                    return a->getPriority() < b->getPriority();
-                });
+        auto task = takeTask(instance);
 
-            task = std::move(*it);
-            m_queue.erase(it);
+        if (!task || task->isCanceled()) {
+            if (maxConcurrent > 0) { m_runningTasks--; }
+            continue;
         }
 
-        if (task->isCanceled()) {
-            continue;
+        // Tasks come through the queues once for parse and once for
+        // build; sum the waits of both rounds.
+        if (task->enqueuedAt > 0) {
+            task->queueWaitMs += (timeNowMicroseconds() - task->enqueuedAt) / 1000.f;
+        }
+
+        if (task->needsParsing()) {
+            {
+                TRACE_SCOPE("tile:parse");
+                int64_t start = timeNowMicroseconds();
+                task->parse(*builder);
+                task->parseMs = (timeNowMicroseconds() - start) / 1000.f;
+            }
+
+            // Hand the compute-bound build stage back to the pool so the
+            // next raw tile can be decoded while this one is built.
+            if (!task->isCanceled() && !task->isReady()) {
+                enqueue(std::move(task));
+                throttleAfterTask(maxConcurrent > 0, taskStart);
+                continue;
+            }
+        } else {
+            TRACE_SCOPE("tile:build");
+            int64_t start = timeNowMicroseconds();
+            task->process(*builder);
+            task->buildMs = (timeNowMicroseconds() - start) / 1000.f;
+
+            if (!task->isCanceled()) {
+                TileStats::instance().report(task->tileId(), task->source().name(),
+                                             task->queueWaitMs, task->parseMs,
+                                             task->buildMs, builder->styleBuildTimes());
+            }
         }
 
-        // const clock_t begin = clock();
+        if (!m_renderRequested.exchange(true)) {
+            requestRender();
+        }
 
-        task->process(*builder);
+        throttleAfterTask(maxConcurrent > 0, taskStart);
+    }
+}
 
-        // float loadTime = (float(clock() - begin) / CLOCKS_PER_SEC) * 1000;
-        // LOG("loadTime %s - %f", task->tileID.toString().c_str(), loadTime);
+void TileWorker::throttleAfterTask(bool _throttled, int64_t _taskStart) {
 
-        requestRender();
+    if (_throttled) {
+        m_runningTasks--;
+        m_condition.notify_one();
     }
+
+    int duty = m_dutyCyclePct.load();
+    if (duty >= 100) { return; }
+
+    // Idle long enough that the task's work amounts to roughly the duty
+    // cycle of this worker's wall time, capped so stop() and throttle
+    // changes stay responsive.
+    int64_t busy = timeNowMicroseconds() - _taskStart;
+    int64_t idle = std::min(busy * (100 - duty) / duty, int64_t(250000));
+    if (idle <= 0) { return; }
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_condition.wait_for(lock, std::chrono::microseconds(idle),
+                         [this]{ return !m_running; });
 }
 
 void TileWorker::setScene(std::shared_ptr<Scene>& _scene) {
-    for (auto& worker : m_workers) {
-        worker->tileBuilder = std::make_unique<TileBuilder>(_scene);
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_scene = _scene;
+        for (auto& worker : m_workers) {
+            if (!worker->active) { continue; }
+            worker->pendingScene = _scene;
+            worker->tileBuilder.reset();
+        }
     }
+    // Wake the whole pool so every worker constructs its builder now,
+    // while the scene swap finishes on this thread, rather than when its
+    // first task arrives.
+    m_condition.notify_all();
+}
+
+void TileWorker::setThrottle(int _maxConcurrentBuilds, float _dutyCycle) {
+
+    m_maxConcurrentTasks = std::max(_maxConcurrentBuilds, 0);
+
+    // Keep a floor under the duty cycle so background refreshes still
+    // make progress.
+    int pct = int(_dutyCycle * 100.f + 0.5f);
+    m_dutyCyclePct = std::min(std::max(pct, 5), 100);
+
+    // Wake the pool so parked workers re-check the new limits.
+    m_condition.notify_all();
 }
 
 void TileWorker::enqueue(std::shared_ptr<TileTask>&& task) {
+
+    if (!m_running) {
+        return;
+    }
+
+    task->enqueuedAt = timeNowMicroseconds();
+
+    if (!m_sharedQueue.push(std::move(task))) {
+        // Ring momentarily full - fall back to a worker deque; an uneven
+        // split is fine since idle workers steal from loaded ones.
+        auto& worker = m_workers[m_nextWorker++ % m_workers.size()];
+        std::unique_lock<std::mutex> lock(worker->mutex);
+        worker->queue.push_back(std::move(task));
+    }
+
+    // The count must move and the wakeup decision must fall under
+    // m_mutex: a worker that evaluated the wait predicate but has not
+    // blocked yet holds the lock, so this section cannot run before it
+    // parks and the notify cannot be lost. m_sleepingWorkers is only
+    // meaningful under the same lock for the same reason.
+    bool grow = false;
     {
         std::unique_lock<std::mutex> lock(m_mutex);
-        if (!m_running) {
-            return;
+
+        m_pendingTasks++;
+
+        // Only pay for a wakeup when a worker is actually parked.
+        if (m_sleepingWorkers > 0) {
+            m_condition.notify_one();
+
+        } else if (m_pendingTasks > 2 * m_activeWorkers &&
+                   m_activeWorkers < int(m_workers.size())) {
+            // All workers busy and the backlog keeps growing - bring
+            // another core into the pool. growPool() takes m_mutex
+            // itself, so it runs after the lock is dropped.
+            grow = true;
         }
-        m_queue.push_back(std::move(task));
     }
-    m_condition.notify_one();
+
+    if (grow) { growPool(); }
 }
 
 void TileWorker::stop() {
@@ -128,10 +355,16 @@ void TileWorker::stop() {
     m_condition.notify_all();
 
     for (auto& worker : m_workers) {
-        worker->thread.join();
+        if (worker->thread.joinable()) {
+            worker->thread.join();
+        }
+        worker->queue.clear();
     }
 
-    m_queue.clear();
+    std::shared_ptr<TileTask> task;
+    while (m_sharedQueue.pop(task)) { task.reset(); }
+
+    m_pendingTasks = 0;
 }
 
 }
@@ -2,9 +2,11 @@
 
 #include "tile/tileTask.h"
 #include "util/jobQueue.h"
+#include "util/mpmcQueue.h"
 
 #include <memory>
 #include <vector>
+#include <deque>
 #include <condition_variable>
 #include <thread>
 #include <mutex>
@@ -32,23 +34,100 @@ public:
 
     void setScene(std::shared_ptr<Scene>& _scene);
 
+    // Re-arms the coalesced render request; called once per update tick
+    // so that any number of task completions in between trigger at most
+    // one platform wakeup.
+    void resetRenderRequest() { m_renderRequested = false; }
+
+    // Throttled scheduling for low-power states: at most
+    // _maxConcurrentBuilds tasks run at once and each worker idles after
+    // a task until its work fills roughly _dutyCycle of its wall time,
+    // so background refreshes proceed at bounded power draw. A zero cap
+    // and a duty cycle of 1 restore all-out scheduling; switchable at
+    // runtime, tasks already running finish unthrottled.
+    void setThrottle(int _maxConcurrentBuilds, float _dutyCycle);
+
 private:
 
     struct Worker {
         std::thread thread;
         std::unique_ptr<TileBuilder> tileBuilder;
+
+        // Scene for which this worker should construct its next
+        // TileBuilder on its own thread; set on a scene swap so the
+        // builders (style builders, duktape function bindings) warm up
+        // concurrently instead of serially on the caller's thread.
+        std::shared_ptr<Scene> pendingScene;
+
+        // Whether this slot's thread has been started. Slots are all
+        // allocated up-front so m_workers never reallocates while
+        // threads iterate it for stealing.
+        bool active = false;
+
+        // Local task deque: the owning thread pops from it and idle
+        // siblings steal from it. Guarded by its own mutex so that
+        // enqueueing and stealing don't contend on one global lock.
+        std::mutex mutex;
+        std::deque<std::shared_ptr<TileTask>> queue;
     };
 
     void run(Worker* instance);
 
+    void startWorker(Worker& _worker);
+
+    // Starts the thread of an inactive worker slot; called when the
+    // pending backlog outgrows the active pool.
+    void growPool();
+
+    // Pop the best pending task from _worker's own deque, or steal one
+    // from a sibling when the own deque is empty. Returns null when no
+    // work is available anywhere.
+    std::shared_ptr<TileTask> takeTask(Worker* _worker);
+
+    // Release the build slot reserved for a throttled task and insert
+    // the duty-cycle idle time owed for the work since _taskStart.
+    void throttleAfterTask(bool _throttled, int64_t _taskStart);
+
     bool m_running;
 
     std::vector<std::unique_ptr<Worker>> m_workers;
 
-    std::condition_variable m_condition;
+    // Number of worker slots with a running thread
+    std::atomic<int> m_activeWorkers;
+
+    // Scene reference kept for TileBuilders of workers started later
+    std::shared_ptr<Scene> m_scene;
 
+    std::condition_variable m_condition;
     std::mutex m_mutex;
-    std::vector<std::shared_ptr<TileTask>> m_queue;
+
+    // Lock-free handoff ring: enqueue() pushes here without taking any
+    // lock; workers drain it into their local deques. The deque path is
+    // only used as fallback when the ring is momentarily full.
+    MPMCQueue<std::shared_ptr<TileTask>> m_sharedQueue{256};
+
+    // Total number of tasks in the ring and all worker deques, used as
+    // the wakeup predicate without touching any lock.
+    std::atomic<int> m_pendingTasks;
+
+    // Number of workers currently blocked on m_condition; lets enqueue()
+    // skip the notify entirely while all workers are busy.
+    std::atomic<int> m_sleepingWorkers;
+
+    // Set by the first task completion after resetRenderRequest();
+    // further completions in the same tick skip the platform wakeup.
+    std::atomic<bool> m_renderRequested{false};
+
+    // Round-robin target for the deque fallback path
+    std::atomic<unsigned int> m_nextWorker;
+
+    // Throttle state (see setThrottle): a zero cap means unlimited, a
+    // duty cycle of 100 percent adds no idle time.
+    std::atomic<int> m_maxConcurrentTasks{0};
+    std::atomic<int> m_dutyCyclePct{100};
+
+    // Number of workers currently processing a task while throttled
+    std::atomic<int> m_runningTasks{0};
 };
 
 }
@@ -1,3 +1,8 @@
+#pragma once
+
+#include "util/inlineFunction.h"
+
+#include <condition_variable>
 #include <thread>
 #include <mutex>
 #include <deque>
@@ -7,6 +12,10 @@ namespace Tangram {
 class AsyncWorker {
 public:
 
+    // Large enough to hold a std::function handed through the
+    // Map::runAsyncTask API alongside direct lambda captures.
+    using Task = InlineFunction<void(), 96>;
+
     AsyncWorker() {
         thread = std::thread(&AsyncWorker::run, this);
     }
@@ -20,7 +29,7 @@ public:
         thread.join();
     }
 
-    void enqueue(std::function<void()> _task) {
+    void enqueue(Task _task) {
         {
             std::unique_lock<std::mutex> lock(m_mutex);
             if (!m_running) { return; }
@@ -34,7 +43,7 @@ private:
 
     void run() {
         while (true) {
-            std::function<void()> task;
+            Task task;
             {
                 std::unique_lock<std::mutex> lock(m_mutex);
                 m_condition.wait(lock, [&]{ return !m_running || !m_queue.empty(); });
@@ -51,7 +60,7 @@ private:
     bool m_running = true;
     std::condition_variable m_condition;
     std::mutex m_mutex;
-    std::deque<std::function<void()>> m_queue;
+    std::deque<Task> m_queue;
 };
 
 }
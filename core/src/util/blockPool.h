@@ -0,0 +1,86 @@
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Tangram {
+
+/* Freelist of fixed-size memory blocks for objects that are created and
+ * destroyed in quick succession, like the TileTasks churned while
+ * panning. The block size locks to the first allocation; requests of
+ * other sizes pass through to the global heap. Holders of a PoolAllocator
+ * share ownership of the pool, so blocks can be returned safely after
+ * the object owning the pool is gone.
+ */
+class BlockPool {
+
+public:
+
+    /* Upper bound on pooled blocks; enough for the tasks in flight
+     * during a fast pan without holding on to a whole burst forever. */
+    static constexpr size_t max_blocks = 64;
+
+    ~BlockPool() {
+        for (void* block : m_blocks) { ::operator delete(block); }
+    }
+
+    void* allocate(size_t _bytes) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_blockSize == 0) { m_blockSize = _bytes; }
+
+            if (_bytes == m_blockSize && !m_blocks.empty()) {
+                void* block = m_blocks.back();
+                m_blocks.pop_back();
+                return block;
+            }
+        }
+        return ::operator new(_bytes);
+    }
+
+    void deallocate(void* _block, size_t _bytes) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (_bytes == m_blockSize && m_blocks.size() < max_blocks) {
+                m_blocks.push_back(_block);
+                return;
+            }
+        }
+        ::operator delete(_block);
+    }
+
+private:
+
+    std::mutex m_mutex;
+    std::vector<void*> m_blocks;
+    size_t m_blockSize = 0;
+};
+
+/* Allocator drawing from a shared BlockPool; with allocate_shared the
+ * object and its control block land in one pooled allocation. */
+template<typename T>
+struct PoolAllocator {
+
+    using value_type = T;
+
+    std::shared_ptr<BlockPool> pool;
+
+    explicit PoolAllocator(std::shared_ptr<BlockPool> _pool) : pool(std::move(_pool)) {}
+
+    template<typename U>
+    PoolAllocator(const PoolAllocator<U>& _other) : pool(_other.pool) {}
+
+    T* allocate(size_t _n) {
+        return static_cast<T*>(pool->allocate(_n * sizeof(T)));
+    }
+
+    void deallocate(T* _ptr, size_t _n) {
+        pool->deallocate(_ptr, _n * sizeof(T));
+    }
+
+    bool operator==(const PoolAllocator& _other) const { return pool == _other.pool; }
+    bool operator!=(const PoolAllocator& _other) const { return pool != _other.pool; }
+};
+
+}
@@ -29,7 +29,8 @@ JoinTypes JoinTypeFromString(const std::string& str) {
     return JoinTypes::miter;
 }
 
-void Builders::buildPolygon(const Polygon& _polygon, float _height, PolygonBuilder& _ctx) {
+void Builders::buildPolygon(const Polygon& _polygon, float _height, PolygonBuilder& _ctx,
+                            const std::vector<uint16_t>* _earcutIndices) {
 
     glm::vec2 min, max;
     if (_ctx.useTexCoords) {
@@ -44,8 +45,12 @@ void Builders::buildPolygon(const Polygon& _polygon, float _height, PolygonBuild
         }
     }
 
-    // Run earcut, triangles are stored in _ctx.earcut.indices
-    _ctx.earcut(_polygon);
+    const std::vector<uint16_t>* triangles = _earcutIndices;
+    if (!triangles) {
+        // Run earcut, triangles are stored in _ctx.earcut.indices
+        _ctx.earcut(_polygon);
+        triangles = &_ctx.earcut.indices;
+    }
 
     size_t sumPoints = 0;
     for (auto& line : _polygon) {
@@ -55,7 +60,7 @@ void Builders::buildPolygon(const Polygon& _polygon, float _height, PolygonBuild
     // Mark the points that are referenced by indices as used.
     size_t sumVertices = 0;
     _ctx.used.assign(sumPoints, 0);
-    for (auto i : _ctx.earcut.indices) {
+    for (auto i : *triangles) {
         if (_ctx.used[i] == 0) {
             _ctx.used[i] = 1;
             sumVertices++;
@@ -65,6 +70,8 @@ void Builders::buildPolygon(const Polygon& _polygon, float _height, PolygonBuild
     uint16_t vertexDataOffset = _ctx.numVertices;
     _ctx.numVertices += sumVertices;
 
+    _ctx.indices.reserve(_ctx.indices.size() + triangles->size());
+
     size_t ring = 0;
     size_t offset = 0;
 
@@ -96,18 +103,56 @@ void Builders::buildPolygon(const Polygon& _polygon, float _height, PolygonBuild
         }
     }
 
-    for (auto i : _ctx.earcut.indices) {
+    for (auto i : *triangles) {
         _ctx.indices.push_back(vertexDataOffset + _ctx.used[i]);
     }
 }
 
-void Builders::buildPolygonExtrusion(const Polygon& _polygon, float _minHeight, float _maxHeight, PolygonBuilder& _ctx) {
+// Key for welding extrusion wall vertices, quantizing position and normal
+// exactly like the polygon vertex layout does (position to 1/8192 tile
+// units, normal components to 1/127). Wall normals are horizontal, so the
+// z component is left out of the key.
+static uint64_t weldKey(const glm::vec3& _pos, const glm::vec3& _normal) {
+
+    const float positionScale = 8192.0f;
+    const float normalScale = 127.0f;
+
+    uint64_t x = (uint16_t)(int16_t)glm::round(_pos.x * positionScale);
+    uint64_t y = (uint16_t)(int16_t)glm::round(_pos.y * positionScale);
+    uint64_t z = (uint16_t)(int16_t)glm::round(_pos.z * positionScale);
+    uint64_t nx = (uint8_t)(int8_t)glm::round(_normal.x * normalScale);
+    uint64_t ny = (uint8_t)(int8_t)glm::round(_normal.y * normalScale);
 
-    auto vertexDataOffset = _ctx.numVertices;
+    return x | y << 16 | z << 32 | nx << 48 | ny << 56;
+}
+
+void Builders::buildPolygonExtrusion(const Polygon& _polygon, float _minHeight, float _maxHeight, PolygonBuilder& _ctx) {
 
     static const glm::vec3 upVector(0.0f, 0.0f, 1.0f);
     glm::vec3 normalVector;
 
+    size_t numSegments = 0;
+    for (auto& line : _polygon) {
+        if (!line.empty()) { numSegments += line.size() - 1; }
+    }
+    _ctx.indices.reserve(_ctx.indices.size() + numSegments * 6);
+
+    bool weld = _ctx.weldVertices && !_ctx.useTexCoords;
+    if (weld) { _ctx.weldMap.clear(); }
+
+    // Adds a wall vertex, reusing the index of a previously emitted vertex
+    // that welds to the same position and normal.
+    auto emitVertex = [&](const glm::vec3& _coord, const glm::vec3& _normal,
+                          const glm::vec2& _uv) -> uint16_t {
+        if (weld) {
+            auto entry = _ctx.weldMap.emplace(weldKey(_coord, _normal),
+                                              (uint16_t)_ctx.numVertices);
+            if (!entry.second) { return entry.first->second; }
+        }
+        _ctx.addVertex(_coord, _normal, _uv);
+        return _ctx.numVertices++;
+    };
+
     for (auto& line : _polygon) {
 
         size_t lineSize = line.size();
@@ -128,33 +173,28 @@ void Builders::buildPolygonExtrusion(const Polygon& _polygon, float _minHeight,
 
             // 1st vertex top
             a.z = _maxHeight;
-            _ctx.addVertex(a, normalVector, glm::vec2(1.,1.));
+            uint16_t aTop = emitVertex(a, normalVector, glm::vec2(1.,1.));
 
             // 2nd vertex top
             b.z = _maxHeight;
-            _ctx.addVertex(b, normalVector, glm::vec2(0.,1.));
+            uint16_t bTop = emitVertex(b, normalVector, glm::vec2(0.,1.));
 
             // 1st vertex bottom
             a.z = _minHeight;
-            _ctx.addVertex(a, normalVector, glm::vec2(1.,0.));
+            uint16_t aBottom = emitVertex(a, normalVector, glm::vec2(1.,0.));
 
             // 2nd vertex bottom
             b.z = _minHeight;
-            _ctx.addVertex(b, normalVector, glm::vec2(0.,0.));
-
-            // Start the index from the previous state of the vertex Data
-            _ctx.indices.push_back(vertexDataOffset);
-            _ctx.indices.push_back(vertexDataOffset + 1);
-            _ctx.indices.push_back(vertexDataOffset + 2);
+            uint16_t bBottom = emitVertex(b, normalVector, glm::vec2(0.,0.));
 
-            _ctx.indices.push_back(vertexDataOffset + 1);
-            _ctx.indices.push_back(vertexDataOffset + 3);
-            _ctx.indices.push_back(vertexDataOffset + 2);
+            _ctx.indices.push_back(aTop);
+            _ctx.indices.push_back(bTop);
+            _ctx.indices.push_back(aBottom);
 
-            vertexDataOffset += 4;
+            _ctx.indices.push_back(bTop);
+            _ctx.indices.push_back(bBottom);
+            _ctx.indices.push_back(aBottom);
         }
-
-        _ctx.numVertices = vertexDataOffset;
     }
 }
 
@@ -182,6 +222,72 @@ void indexPairs( int _nPairs, int _nVertices, std::vector<uint16_t>& _indicesOut
     }
 }
 
+// --- Strip emission ---------------------------------------------------
+// With PolyLineBuilder::useStrips the index list describes one
+// GL_TRIANGLE_STRIP. Each run of connected quads becomes a strip chunk
+// that starts with a duplicated first index and ends with a duplicated
+// last index, so concatenated chunks - including feature index lists
+// merged into one buffer by Mesh::compile - meet only in degenerate
+// triangles. Chunks keep even length, which preserves the strip's
+// winding parity across chunk boundaries; the leading duplicate flips
+// parity so the first real triangle matches the triangle-list winding.
+
+// Terminate the open strip run with its trailing duplicate.
+static void stripCloseRun(PolyLineBuilder& _ctx) {
+    if (_ctx.stripLast < 0) { return; }
+
+    _ctx.indices.push_back(_ctx.stripLast);
+    if (_ctx.indices.size() % 2 != 0) {
+        _ctx.indices.push_back(_ctx.stripLast);
+    }
+    _ctx.stripLast = -1;
+}
+
+// Add the quad formed by the two previous and the two newest vertices,
+// extending the open run when the pairs are consecutive.
+static void stripAddQuad(PolyLineBuilder& _ctx) {
+    int nVertices = _ctx.numVertices;
+
+    if (_ctx.stripLast == nVertices - 3) {
+        _ctx.indices.push_back(nVertices - 2);
+        _ctx.indices.push_back(nVertices - 1);
+    } else {
+        stripCloseRun(_ctx);
+        _ctx.indices.push_back(nVertices - 4);
+        _ctx.indices.push_back(nVertices - 4);
+        _ctx.indices.push_back(nVertices - 3);
+        _ctx.indices.push_back(nVertices - 2);
+        _ctx.indices.push_back(nVertices - 1);
+    }
+    _ctx.stripLast = nVertices - 1;
+}
+
+// Add a single triangle (with the winding of _a, _b, _c) as its own
+// degenerate-stitched chunk; used for the fan triangles of joins and
+// round caps.
+static void stripAddTriangle(uint16_t _a, uint16_t _b, uint16_t _c, PolyLineBuilder& _ctx) {
+    stripCloseRun(_ctx);
+
+    _ctx.indices.push_back(_b);
+    _ctx.indices.push_back(_b);
+    _ctx.indices.push_back(_a);
+    _ctx.indices.push_back(_c);
+    _ctx.indices.push_back(_c);
+    if (_ctx.indices.size() % 2 != 0) {
+        _ctx.indices.push_back(_c);
+    }
+}
+
+// Emit indices for the quad formed by the last two vertex pairs, in the
+// builder's triangle or strip layout.
+static void indexQuad(PolyLineBuilder& _ctx) {
+    if (_ctx.useStrips) {
+        stripAddQuad(_ctx);
+    } else {
+        indexPairs(1, _ctx.numVertices, _ctx.indices);
+    }
+}
+
 //  Tessalate a fan geometry between points A       B
 //  using their normals from a center        \ . . /
 //  and interpolating their UVs               \ p /
@@ -218,9 +324,17 @@ void addFan(const glm::vec3& _pC,
         addPolyLineVertex(_pC, radial, uv, _ctx);
 
         // Add indices
-        _ctx.indices.push_back(startIndex); // center vertex
-        _ctx.indices.push_back(startIndex + i + (angle > 0 ? 1 : 2));
-        _ctx.indices.push_back(startIndex + i + (angle > 0 ? 2 : 1));
+        uint16_t center = startIndex;
+        uint16_t b = startIndex + i + (angle > 0 ? 1 : 2);
+        uint16_t c = startIndex + i + (angle > 0 ? 2 : 1);
+
+        if (_ctx.useStrips) {
+            stripAddTriangle(center, b, c, _ctx);
+        } else {
+            _ctx.indices.push_back(center); // center vertex
+            _ctx.indices.push_back(b);
+            _ctx.indices.push_back(c);
+        }
     }
 
 }
@@ -239,7 +353,7 @@ void addCap(const glm::vec3& _coord, const glm::vec2& _normal, int _numCorners,
         addPolyLineVertex(_coord, _normal + tangent, {0.f, v}, _ctx);
         addPolyLineVertex(_coord, -_normal + tangent, {0.f, v}, _ctx);
         if (!_isBeginning) { // At the beginning of a line we can't form triangles with previous vertices
-            indexPairs(1, _ctx.numVertices, _ctx.indices);
+            indexQuad(_ctx);
         }
         return;
     }
@@ -287,6 +401,37 @@ void buildPolyLineSegment(const Line& _line, PolyLineBuilder& _ctx, size_t _star
                    (origLineSize - _startIndex + _endIndex));
     if (lineSize < 2) { return; }
 
+    // Pre-size for the common miter case; fans and caps may add more.
+    _ctx.indices.reserve(_ctx.indices.size() + lineSize * 6);
+
+    // Compute all segment normals for this run in one batched pass over
+    // contiguous points, instead of normalizing inside the join logic.
+    // The straight-line form over adjacent points is what the compiler
+    // can turn into vector loads and parallel rsqrt lanes.
+    auto& normals = _ctx.scratchNormals;
+    normals.clear();
+    normals.reserve(lineSize - 1);
+
+    auto segmentNormal = [](const glm::vec3& _a, const glm::vec3& _b) {
+        glm::vec2 n(_b.y - _a.y, _a.x - _b.x);
+        float len2 = n.x * n.x + n.y * n.y;
+        // Zero-length segments are skipped by the emission loop below.
+        return len2 > 0.f ? n * glm::inversesqrt(len2) : glm::vec2(0.f);
+    };
+
+    if (_startIndex + (size_t)lineSize <= origLineSize) {
+        const Point* points = &_line[_startIndex];
+        for (int i = 0; i < lineSize - 1; i++) {
+            normals.push_back(segmentNormal(points[i], points[i + 1]));
+        }
+    } else {
+        // Wrapped run (closed polygon) - fall back to indexed access
+        for (int i = 0; i < lineSize - 1; i++) {
+            normals.push_back(segmentNormal(_line[(_startIndex + i) % origLineSize],
+                                            _line[(_startIndex + i + 1) % origLineSize]));
+        }
+    }
+
     glm::vec3 coordCurr(_line[_startIndex]);
     // get the Point using wrapped index in the original line geometry
     glm::vec3 coordNext(_line[(_startIndex + 1) % origLineSize]);
@@ -296,7 +441,7 @@ void buildPolyLineSegment(const Line& _line, PolyLineBuilder& _ctx, size_t _star
     int trianglesOnJoin = (int)_ctx.join;
 
     // Process first point in line with an end cap
-    normNext = glm::normalize(perp2d(coordCurr, coordNext));
+    normNext = normals[0];
 
     if (endCap) {
         addCap(coordCurr, normNext, cornersOnCap, true, _ctx);
@@ -320,7 +465,7 @@ void buildPolyLineSegment(const Line& _line, PolyLineBuilder& _ctx, size_t _star
         }
 
         normPrev = normNext;
-        normNext = glm::normalize(perp2d(coordCurr, coordNext));
+        normNext = normals[i];
 
         // Compute "normal" for miter joint
         miterVec = normPrev + normNext;
@@ -350,7 +495,7 @@ void buildPolyLineSegment(const Line& _line, PolyLineBuilder& _ctx, size_t _star
 
             addPolyLineVertex(coordCurr, miterVec, {1.0, v}, _ctx); // right corner
             addPolyLineVertex(coordCurr, -miterVec, {0.0, v}, _ctx); // left corner
-            indexPairs(1, _ctx.numVertices, _ctx.indices);
+            indexQuad(_ctx);
 
         } else {
 
@@ -362,7 +507,7 @@ void buildPolyLineSegment(const Line& _line, PolyLineBuilder& _ctx, size_t _star
 
                 addPolyLineVertex(coordCurr, miterVec, {1.0f, v}, _ctx); // right (inner) corner
                 addPolyLineVertex(coordCurr, -normPrev, {0.0f, v}, _ctx); // left (outer) corner
-                indexPairs(1, _ctx.numVertices, _ctx.indices);
+                indexQuad(_ctx);
 
                 addFan(coordCurr, -normPrev, -normNext, miterVec, {0.f, v}, {0.f, v}, {1.f, v}, trianglesOnJoin, _ctx);
 
@@ -373,7 +518,7 @@ void buildPolyLineSegment(const Line& _line, PolyLineBuilder& _ctx, size_t _star
 
                 addPolyLineVertex(coordCurr, normPrev, {1.0f, v}, _ctx); // right (outer) corner
                 addPolyLineVertex(coordCurr, -miterVec, {0.0f, v}, _ctx); // left (inner) corner
-                indexPairs(1, _ctx.numVertices, _ctx.indices);
+                indexQuad(_ctx);
 
                 addFan(coordCurr, normPrev, normNext, -miterVec, {1.f, v}, {1.f, v}, {0.0f, v}, trianglesOnJoin, _ctx);
 
@@ -388,7 +533,7 @@ void buildPolyLineSegment(const Line& _line, PolyLineBuilder& _ctx, size_t _star
     // Process last point in line with a cap
     addPolyLineVertex(coordNext, normNext, {1.f, distance}, _ctx); // right corner
     addPolyLineVertex(coordNext, -normNext, {0.f, distance}, _ctx); // left corner
-    indexPairs(1, _ctx.numVertices, _ctx.indices);
+    indexQuad(_ctx);
     if (endCap) {
         addCap(coordNext, normNext, cornersOnCap, false, _ctx);
     }
@@ -436,6 +581,8 @@ void Builders::buildPolyLine(const Line& _line, PolyLineBuilder& _ctx) {
 
     }
 
+    if (_ctx.useStrips) { stripCloseRun(_ctx); }
+
 }
 
 void Builders::buildQuadAtPoint(const glm::vec2& _screenPosition, const glm::vec2& _size, const glm::vec2& _uvBL, const glm::vec2& _uvTR, SpriteBuilder& _ctx) {
@@ -3,6 +3,7 @@
 #include "data/tileData.h"
 
 #include <functional>
+#include <unordered_map>
 #include <vector>
 
 #include "earcut.hpp/include/earcut.hpp"
@@ -35,6 +36,10 @@ typedef std::function<void(const glm::vec3& coord, const glm::vec3& normal, cons
 
 /* PolygonBuilder context,
  * see Builders::buildPolygon() and Builders::buildPolygonExtrusion()
+ *
+ * Builder contexts are long-lived per StyleBuilder; clear() resets the
+ * counters but keeps the scratch allocations (indices, used, earcut
+ * state) warm for the next feature.
  */
 struct PolygonBuilder {
     std::vector<uint16_t> indices; // indices for drawing the polyon as triangles are added to this vector
@@ -44,6 +49,13 @@ struct PolygonBuilder {
     size_t numVertices = 0;
     bool useTexCoords;
 
+    // Share extrusion wall vertices whose position and normal quantize to
+    // the same mesh-layout values, instead of emitting four vertices per
+    // quad. Only applied when useTexCoords is off, since welded vertices
+    // would also share their texture coordinates.
+    bool weldVertices = false;
+    std::unordered_map<uint64_t, uint16_t> weldMap;
+
     mapbox::detail::Earcut<uint16_t> earcut;
 
     PolygonBuilder(PolygonVertexFn _addVertex = [](auto&,auto&,auto&){},
@@ -53,6 +65,7 @@ struct PolygonBuilder {
     void clear() {
         numVertices = 0;
         indices.clear();
+        weldMap.clear();
     }
 };
 
@@ -70,6 +83,7 @@ typedef std::function<void(const glm::vec3& coord, const glm::vec2& enormal, con
  */
 struct PolyLineBuilder {
     std::vector<uint16_t> indices; // indices for drawing the polyline as triangles are added to this vector
+    std::vector<glm::vec2> scratchNormals; // per-segment normals, computed in one batched pass per line
     PolyLineVertexFn addVertex;
     size_t numVertices = 0;
     float miterLimit = 3.f;
@@ -79,6 +93,13 @@ struct PolyLineBuilder {
     bool closedPolygon;
     bool useTexCoords = false;
 
+    // Emit GL_TRIANGLE_STRIP indices instead of independent triangles,
+    // stitching runs with degenerate triangles. Long quad runs then take
+    // two indices per segment instead of six. Only valid for meshes drawn
+    // with GL_TRIANGLE_STRIP.
+    bool useStrips = false;
+    int stripLast = -1; // last index of the open strip run, -1 when closed
+
     PolyLineBuilder(PolyLineVertexFn _addVertex = [](auto&,auto&,auto&){},
                     CapTypes _cap = CapTypes::butt,
                     JoinTypes _join = JoinTypes::bevel,
@@ -88,6 +109,7 @@ struct PolyLineBuilder {
     void clear() {
         numVertices = 0;
         indices.clear();
+        stripLast = -1;
     }
 };
 
@@ -115,8 +137,12 @@ public:
     /* Build a tesselated polygon
      * @_polygon input coordinates describing the polygon
      * @_ctx output vectors, see <PolygonBuilder>
+     * @_earcutIndices optional pre-computed triangulation of _polygon, in
+     * the linear ring-point order produced by Earcut; when given, the
+     * tessellation step is skipped and only vertex emission runs
      */
-    static void buildPolygon(const Polygon& _polygon, float _height, PolygonBuilder& _ctx);
+    static void buildPolygon(const Polygon& _polygon, float _height, PolygonBuilder& _ctx,
+                             const std::vector<uint16_t>* _earcutIndices = nullptr);
 
     /* Build extruded 'walls' from a polygon
      * @_polygon input coordinates describing the polygon
@@ -0,0 +1,465 @@
+#include "compression.h"
+
+#include <cstdint>
+#include <cstring>
+
+namespace Tangram {
+
+namespace {
+
+constexpr size_t min_match = 4;
+constexpr size_t max_offset = 65535;
+constexpr size_t hash_bits = 13;
+
+uint32_t read32(const uint8_t* _p) {
+    uint32_t v;
+    std::memcpy(&v, _p, sizeof(v));
+    return v;
+}
+
+uint32_t hash32(uint32_t _seq) {
+    return (_seq * 2654435761u) >> (32 - hash_bits);
+}
+
+/* Token layout, after a 4 byte little-endian original size:
+ * one byte holding the literal run length (high nibble) and the match
+ * length minus min_match (low nibble). A nibble of 15 continues in
+ * following bytes, each adding its value, until one is less than 255.
+ * The literal bytes follow, then a 2 byte little-endian match offset.
+ * The final token carries only literals and no offset. */
+
+void putLength(std::vector<char>& _out, size_t _len) {
+    while (_len >= 255) {
+        _out.push_back(char(255));
+        _len -= 255;
+    }
+    _out.push_back(char(_len));
+}
+
+void putToken(std::vector<char>& _out, const uint8_t* _literals, size_t _litLen,
+              size_t _matchLen, size_t _offset) {
+
+    size_t litNibble = _litLen < 15 ? _litLen : 15;
+    size_t matchNibble = _matchLen < min_match + 15 ? _matchLen - min_match : 15;
+    if (_matchLen == 0) { matchNibble = 0; }
+
+    _out.push_back(char((litNibble << 4) | matchNibble));
+
+    if (litNibble == 15) { putLength(_out, _litLen - 15); }
+    _out.insert(_out.end(), _literals, _literals + _litLen);
+
+    if (_matchLen == 0) { return; }
+
+    _out.push_back(char(_offset & 0xff));
+    _out.push_back(char(_offset >> 8));
+    if (matchNibble == 15) { putLength(_out, _matchLen - min_match - 15); }
+}
+
+/* Reads the continuation bytes of an extended length nibble */
+bool readExtra(const uint8_t*& _in, const uint8_t* _end, size_t& _len) {
+    uint8_t byte;
+    do {
+        if (_in == _end) { return false; }
+        byte = *_in++;
+        _len += byte;
+    } while (byte == 255);
+    return true;
+}
+
+/* --- gzip / DEFLATE (RFC 1951, 1952) ---
+ *
+ * Bit-serial inflate after the 'puff' reference decoder: small and
+ * allocation-light rather than fast, which is fine for one tile payload
+ * per worker invocation. */
+
+// Refuse members claiming more than this once decompressed, so a
+// malformed or hostile trailer cannot drive allocation.
+constexpr size_t max_member_size = size_t(1) << 30;
+
+struct BitReader {
+    const uint8_t* data;
+    size_t size;
+    size_t pos;
+    uint32_t bitBuf;
+    int bitCount;
+    bool ok;
+
+    BitReader(const uint8_t* _data, size_t _size)
+        : data(_data), size(_size), pos(0), bitBuf(0), bitCount(0), ok(true) {}
+
+    uint32_t bits(int _n) {
+        while (bitCount < _n) {
+            if (pos == size) { ok = false; return 0; }
+            bitBuf |= uint32_t(data[pos++]) << bitCount;
+            bitCount += 8;
+        }
+        uint32_t v = bitBuf & ((1u << _n) - 1);
+        bitBuf >>= _n;
+        bitCount -= _n;
+        return v;
+    }
+
+    /* Drop to the next byte boundary, for stored blocks */
+    void alignByte() {
+        int drop = bitCount & 7;
+        bitBuf >>= drop;
+        bitCount -= drop;
+    }
+};
+
+/* A canonical Huffman code, decoded one bit at a time by counting how
+ * many codes exist per length */
+struct Huffman {
+    int counts[16];
+    uint16_t symbols[288];
+
+    /* Returns false for an over-subscribed set of code lengths */
+    bool build(const uint8_t* _lengths, int _n) {
+        for (int i = 0; i < 16; i++) { counts[i] = 0; }
+        for (int i = 0; i < _n; i++) { counts[_lengths[i]]++; }
+
+        int left = 1;
+        for (int len = 1; len < 16; len++) {
+            left <<= 1;
+            left -= counts[len];
+            if (left < 0) { return false; }
+        }
+
+        int offsets[16];
+        offsets[1] = 0;
+        for (int len = 1; len < 15; len++) {
+            offsets[len + 1] = offsets[len] + counts[len];
+        }
+        for (int i = 0; i < _n; i++) {
+            if (_lengths[i]) { symbols[offsets[_lengths[i]]++] = uint16_t(i); }
+        }
+        return true;
+    }
+
+    int decode(BitReader& _br) const {
+        int code = 0, first = 0, index = 0;
+        for (int len = 1; len < 16; len++) {
+            code |= int(_br.bits(1));
+            int count = counts[len];
+            if (code - first < count) { return symbols[index + code - first]; }
+            index += count;
+            first = (first + count) << 1;
+            code <<= 1;
+        }
+        return -1;
+    }
+};
+
+const uint16_t length_base[29] = {
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+    35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+const uint8_t length_extra[29] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+    3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+const uint16_t dist_base[30] = {
+    1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+    257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145,
+    8193, 12289, 16385, 24577 };
+const uint8_t dist_extra[30] = {
+    0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+    7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+bool inflateSymbols(BitReader& _br, std::vector<char>& _out, size_t _maxOut,
+                    const Huffman& _litCodes, const Huffman& _distCodes) {
+    while (true) {
+        if (_out.size() > _maxOut) { return false; }
+
+        int sym = _litCodes.decode(_br);
+        if (!_br.ok || sym < 0) { return false; }
+
+        if (sym < 256) {
+            _out.push_back(char(sym));
+        } else if (sym == 256) {
+            return true;
+        } else {
+            sym -= 257;
+            if (sym >= 29) { return false; }
+            size_t len = length_base[sym] + _br.bits(length_extra[sym]);
+
+            int dsym = _distCodes.decode(_br);
+            if (!_br.ok || dsym < 0 || dsym >= 30) { return false; }
+            size_t dist = dist_base[dsym] + _br.bits(dist_extra[dsym]);
+            if (!_br.ok || dist > _out.size()) { return false; }
+
+            // Byte-wise copy; matches may overlap their own output
+            size_t from = _out.size() - dist;
+            for (size_t k = 0; k < len; k++) { _out.push_back(_out[from + k]); }
+        }
+    }
+}
+
+bool inflateFixed(BitReader& _br, std::vector<char>& _out, size_t _maxOut) {
+
+    static const struct FixedCodes {
+        Huffman lit, dist;
+        FixedCodes() {
+            uint8_t lengths[288];
+            int i = 0;
+            for (; i < 144; i++) { lengths[i] = 8; }
+            for (; i < 256; i++) { lengths[i] = 9; }
+            for (; i < 280; i++) { lengths[i] = 7; }
+            for (; i < 288; i++) { lengths[i] = 8; }
+            lit.build(lengths, 288);
+            for (i = 0; i < 30; i++) { lengths[i] = 5; }
+            dist.build(lengths, 30);
+        }
+    } codes;
+
+    return inflateSymbols(_br, _out, _maxOut, codes.lit, codes.dist);
+}
+
+bool inflateDynamic(BitReader& _br, std::vector<char>& _out, size_t _maxOut) {
+
+    int hlit = int(_br.bits(5)) + 257;
+    int hdist = int(_br.bits(5)) + 1;
+    int hclen = int(_br.bits(4)) + 4;
+    if (!_br.ok || hlit > 286 || hdist > 30) { return false; }
+
+    static const uint8_t order[19] = {
+        16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+
+    uint8_t clLengths[19] = {};
+    for (int i = 0; i < hclen; i++) { clLengths[order[i]] = uint8_t(_br.bits(3)); }
+    if (!_br.ok) { return false; }
+
+    Huffman clCodes;
+    if (!clCodes.build(clLengths, 19)) { return false; }
+
+    // The literal and distance code lengths share one run-length
+    // encoded sequence
+    uint8_t lengths[286 + 30] = {};
+    int n = 0;
+    while (n < hlit + hdist) {
+        int sym = clCodes.decode(_br);
+        if (!_br.ok || sym < 0) { return false; }
+
+        if (sym < 16) {
+            lengths[n++] = uint8_t(sym);
+        } else {
+            uint8_t repeated = 0;
+            int repeat;
+            if (sym == 16) {
+                if (n == 0) { return false; }
+                repeated = lengths[n - 1];
+                repeat = 3 + int(_br.bits(2));
+            } else if (sym == 17) {
+                repeat = 3 + int(_br.bits(3));
+            } else {
+                repeat = 11 + int(_br.bits(7));
+            }
+            if (!_br.ok || n + repeat > hlit + hdist) { return false; }
+            while (repeat--) { lengths[n++] = repeated; }
+        }
+    }
+
+    // The end-of-block code must be present
+    if (lengths[256] == 0) { return false; }
+
+    Huffman litCodes, distCodes;
+    if (!litCodes.build(lengths, hlit) ||
+        !distCodes.build(lengths + hlit, hdist)) { return false; }
+
+    return inflateSymbols(_br, _out, _maxOut, litCodes, distCodes);
+}
+
+bool inflate(BitReader& _br, std::vector<char>& _out, size_t _maxOut) {
+
+    bool last = false;
+    while (!last) {
+        last = _br.bits(1);
+        uint32_t type = _br.bits(2);
+        if (!_br.ok) { return false; }
+
+        if (type == 0) {
+            _br.alignByte();
+            uint32_t len = _br.bits(16);
+            uint32_t nlen = _br.bits(16);
+            if (!_br.ok || (len ^ nlen) != 0xffff) { return false; }
+            if (_out.size() + len > _maxOut) { return false; }
+            for (uint32_t i = 0; i < len; i++) { _out.push_back(char(_br.bits(8))); }
+            if (!_br.ok) { return false; }
+        } else if (type == 1) {
+            if (!inflateFixed(_br, _out, _maxOut)) { return false; }
+        } else if (type == 2) {
+            if (!inflateDynamic(_br, _out, _maxOut)) { return false; }
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+uint32_t crc32(const std::vector<char>& _data) {
+
+    static const struct Crc32Table {
+        uint32_t t[256];
+        Crc32Table() {
+            for (uint32_t i = 0; i < 256; i++) {
+                uint32_t c = i;
+                for (int k = 0; k < 8; k++) {
+                    c = (c & 1) ? 0xedb88320u ^ (c >> 1) : c >> 1;
+                }
+                t[i] = c;
+            }
+        }
+    } table;
+
+    uint32_t c = 0xffffffffu;
+    for (char byte : _data) {
+        c = table.t[(c ^ uint8_t(byte)) & 0xff] ^ (c >> 8);
+    }
+    return c ^ 0xffffffffu;
+}
+
+}
+
+bool lzCompress(const std::vector<char>& _data, std::vector<char>& _out) {
+
+    const uint8_t* src = reinterpret_cast<const uint8_t*>(_data.data());
+    const size_t n = _data.size();
+
+    if (n < min_match || n > UINT32_MAX) { return false; }
+
+    _out.clear();
+    _out.reserve(n / 2);
+    uint32_t size = uint32_t(n);
+    _out.push_back(char(size & 0xff));
+    _out.push_back(char((size >> 8) & 0xff));
+    _out.push_back(char((size >> 16) & 0xff));
+    _out.push_back(char(size >> 24));
+
+    int32_t table[1 << hash_bits];
+    std::memset(table, 0xff, sizeof(table));
+
+    size_t anchor = 0;
+    size_t i = 0;
+
+    while (i + min_match <= n) {
+
+        uint32_t seq = read32(src + i);
+        uint32_t h = hash32(seq);
+        int32_t candidate = table[h];
+        table[h] = int32_t(i);
+
+        if (candidate >= 0 && i - candidate <= max_offset &&
+            read32(src + candidate) == seq) {
+
+            size_t len = min_match;
+            while (i + len < n && src[candidate + len] == src[i + len]) { len++; }
+
+            putToken(_out, src + anchor, i - anchor, len, i - candidate);
+
+            i += len;
+            anchor = i;
+        } else {
+            i++;
+        }
+
+        if (_out.size() + (i - anchor) >= n) { return false; }
+    }
+
+    putToken(_out, src + anchor, n - anchor, 0, 0);
+
+    return _out.size() < n;
+}
+
+bool lzDecompress(const std::vector<char>& _compressed, std::vector<char>& _out) {
+
+    const uint8_t* in = reinterpret_cast<const uint8_t*>(_compressed.data());
+    const uint8_t* end = in + _compressed.size();
+
+    if (_compressed.size() < 4) { return false; }
+
+    size_t size = size_t(in[0]) | size_t(in[1]) << 8 | size_t(in[2]) << 16 | size_t(in[3]) << 24;
+    in += 4;
+
+    _out.clear();
+    _out.reserve(size);
+
+    while (in != end) {
+
+        uint8_t token = *in++;
+
+        size_t litLen = token >> 4;
+        if (litLen == 15 && !readExtra(in, end, litLen)) { return false; }
+        if (size_t(end - in) < litLen) { return false; }
+
+        _out.insert(_out.end(), in, in + litLen);
+        in += litLen;
+
+        // The final token carries no match
+        if (in == end) { break; }
+
+        if (end - in < 2) { return false; }
+        size_t offset = size_t(in[0]) | size_t(in[1]) << 8;
+        in += 2;
+
+        size_t matchLen = (token & 15) + min_match;
+        if ((token & 15) == 15 && !readExtra(in, end, matchLen)) { return false; }
+
+        if (offset == 0 || offset > _out.size()) { return false; }
+
+        // Byte-wise copy; matches may overlap their own output
+        size_t from = _out.size() - offset;
+        for (size_t k = 0; k < matchLen; k++) {
+            _out.push_back(_out[from + k]);
+        }
+    }
+
+    return _out.size() == size;
+}
+
+bool isGzipped(const std::vector<char>& _data) {
+    return _data.size() > 10 &&
+           uint8_t(_data[0]) == 0x1f &&
+           uint8_t(_data[1]) == 0x8b &&
+           uint8_t(_data[2]) == 8; // compression method: deflate
+}
+
+bool gzipDecompress(const std::vector<char>& _compressed, std::vector<char>& _out) {
+
+    const uint8_t* in = reinterpret_cast<const uint8_t*>(_compressed.data());
+    const size_t n = _compressed.size();
+
+    // Smallest member: 10 byte header, empty deflate stream, 8 byte trailer
+    if (!isGzipped(_compressed) || n < 20) { return false; }
+
+    uint8_t flags = in[3];
+    if (flags & 0xe0) { return false; } // reserved bits
+
+    size_t pos = 10;
+    if (flags & 4) { // FEXTRA
+        if (pos + 2 > n) { return false; }
+        pos += 2 + (size_t(in[pos]) | size_t(in[pos + 1]) << 8);
+    }
+    for (uint8_t field : { uint8_t(8), uint8_t(16) }) { // FNAME, FCOMMENT
+        if (flags & field) {
+            while (pos < n && in[pos]) { pos++; }
+            if (pos == n) { return false; }
+            pos++;
+        }
+    }
+    if (flags & 2) { pos += 2; } // FHCRC, not verified
+
+    if (pos + 8 > n) { return false; }
+
+    // The trailer names the checksum and size of the decompressed member
+    uint32_t crc = read32(in + n - 8);
+    uint32_t size = read32(in + n - 4);
+    if (size > max_member_size) { return false; }
+
+    _out.clear();
+    _out.reserve(size);
+
+    BitReader br(in + pos, n - pos - 8);
+    if (!inflate(br, _out, size)) { return false; }
+
+    return _out.size() == size && crc32(_out) == crc;
+}
+
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <vector>
+
+namespace Tangram {
+
+/* Byte-oriented LZ codec for in-memory caches.
+ *
+ * Trades ratio for speed and zero dependencies: greedy LZ77 matching
+ * over a 64KB window in an LZ4-style token format. Tile payloads (JSON,
+ * protobuf) typically shrink to a third, so a byte-budgeted cache holds
+ * about three times as many entries. The format is internal - nothing
+ * compressed here is ever written to disk or the network.
+ */
+
+/* Compress _data into _out, replacing its contents. Returns false when
+ * the input does not shrink; _out is then unspecified and callers
+ * should keep the original. */
+bool lzCompress(const std::vector<char>& _data, std::vector<char>& _out);
+
+/* Decompress a buffer produced by lzCompress, replacing the contents of
+ * _out. Returns false on malformed input. */
+bool lzDecompress(const std::vector<char>& _compressed, std::vector<char>& _out);
+
+/* True when _data starts with a gzip member header. */
+bool isGzipped(const std::vector<char>& _data);
+
+/* Inflate a gzip member (RFC 1952) into _out, replacing its contents.
+ * Lets the tile pipeline unpack responses that the platform network
+ * layer passed through undecoded, keeping transfer threads I/O-only.
+ * Returns false on malformed input, a checksum mismatch, or a member
+ * claiming an implausibly large decompressed size. */
+bool gzipDecompress(const std::vector<char>& _compressed, std::vector<char>& _out);
+
+}
@@ -1,5 +1,10 @@
 #include "dashArray.h"
 
+#include "gl/texture.h"
+
+#include <map>
+#include <mutex>
+
 namespace Tangram {
 
 std::vector<unsigned int> DashArray::render(std::vector<int> _pattern,
@@ -21,4 +26,43 @@ std::vector<unsigned int> DashArray::render(std::vector<int> _pattern,
     return dashArray;
 }
 
+std::shared_ptr<Texture> DashArray::getTexture(const std::vector<int>& _pattern,
+    unsigned int _dashColor, unsigned int _backgroundColor)
+{
+    struct Key {
+        std::vector<int> pattern;
+        unsigned int dashColor;
+        unsigned int backgroundColor;
+
+        bool operator<(const Key& _other) const {
+            if (pattern != _other.pattern) { return pattern < _other.pattern; }
+            if (dashColor != _other.dashColor) { return dashColor < _other.dashColor; }
+            return backgroundColor < _other.backgroundColor;
+        }
+    };
+
+    // Dash specs are few and small; keep the textures for the lifetime
+    // of the process so scene reloads reuse them.
+    static std::map<Key, std::shared_ptr<Texture>> cache;
+    static std::mutex cacheMutex;
+
+    Key key { _pattern, _dashColor, _backgroundColor };
+
+    std::lock_guard<std::mutex> lock(cacheMutex);
+
+    auto entry = cache.find(key);
+    if (entry != cache.end()) { return entry->second; }
+
+    auto pixels = render(_pattern, _dashColor, _backgroundColor);
+
+    TextureOptions options {GL_RGBA, GL_RGBA, {GL_NEAREST, GL_NEAREST}, {GL_CLAMP_TO_EDGE, GL_CLAMP_TO_EDGE}};
+
+    auto texture = std::make_shared<Texture>(1, pixels.size(), options);
+    texture->setData(pixels.data(), pixels.size());
+
+    cache.emplace(std::move(key), texture);
+
+    return texture;
+}
+
 }
@@ -1,13 +1,24 @@
 #pragma once
 
+#include <memory>
 #include <vector>
 
 namespace Tangram {
 
+class Texture;
+
 struct DashArray {
     static std::vector<unsigned int> render(std::vector<int> _pattern,
         unsigned int _dashColor = 0xffffffff,
         unsigned int _backgroundColor = 0x00000000);
+
+    // Returns a 1xN texture of the rasterized dash pattern. Identical
+    // patterns share one texture across styles and scene reloads, so
+    // style setup during a scene swap does not redo the rasterization
+    // or allocate duplicate textures.
+    static std::shared_ptr<Texture> getTexture(const std::vector<int>& _pattern,
+        unsigned int _dashColor = 0xffffffff,
+        unsigned int _backgroundColor = 0x00000000);
 };
 
 }
@@ -48,12 +48,14 @@ Extrude parseExtrudeString(const std::string& _str) {
 float getLowerExtrudeMeters(const Extrude& _extrude, const Properties& _props) {
 
     const static std::string key_min_height("min_height");
+    const static uint32_t key_min_height_hash = Properties::keyHash(key_min_height);
 
     double lower = 0;
 
     if (std::isnan(_extrude[0])) {
         // A NAN indicates that the default property should be used for this height
-        _props.getNumber(key_min_height, lower);
+        const auto& value = _props.get(key_min_height, key_min_height_hash);
+        if (value.is<double>()) { lower = value.get<double>(); }
     } else {
         lower = _extrude[0];
     }
@@ -65,12 +67,14 @@ float getLowerExtrudeMeters(const Extrude& _extrude, const Properties& _props) {
 float getUpperExtrudeMeters(const Extrude& _extrude, const Properties& _props) {
 
     const static std::string key_height("height");
+    const static uint32_t key_height_hash = Properties::keyHash(key_height);
 
     double upper = 0;
 
     if (std::isnan(_extrude[1])) {
         // A NAN indicates that the default property should be used for this height
-        _props.getNumber(key_height, upper);
+        const auto& value = _props.get(key_height, key_height_hash);
+        if (value.is<double>()) { upper = value.get<double>(); }
     } else {
         upper = _extrude[1];
     }
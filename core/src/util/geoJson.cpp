@@ -28,14 +28,30 @@ bool GeoJson::isFeatureCollection(const JsonValue& _in) {
 }
 
 Point GeoJson::getPoint(const JsonValue& _in, const Transform& _proj) {
-    return _proj(glm::dvec2(_in[0].GetDouble(), _in[1].GetDouble()));
+    glm::dvec2 lonLat(_in[0].GetDouble(), _in[1].GetDouble());
+    _proj(&lonLat, 1);
+    return Point(lonLat.x, lonLat.y, 0);
 }
 
 Line GeoJson::getLine(const JsonValue& _in, const Transform& _proj) {
 
-    Line line;
+    // Read all coordinates of the line first, so the projection runs as
+    // one batched pass instead of once per point.
+    std::vector<glm::dvec2> lonLats;
+    lonLats.reserve(_in.Size());
+
     for (auto itr = _in.Begin(); itr != _in.End(); ++itr) {
-        line.push_back(getPoint(*itr, _proj));
+        const auto& point = *itr;
+        lonLats.push_back(glm::dvec2(point[0].GetDouble(), point[1].GetDouble()));
+    }
+
+    _proj(lonLats.data(), lonLats.size());
+
+    Line line;
+    line.reserve(lonLats.size());
+
+    for (const auto& p : lonLats) {
+        line.push_back(Point(p.x, p.y, 0));
     }
     return line;
 
@@ -53,24 +69,22 @@ Polygon GeoJson::getPolygon(const JsonValue& _in, const Transform& _proj) {
 
 Properties GeoJson::getProperties(const JsonValue& _in, int32_t _sourceId) {
 
-    std::vector<PropertyItem> items;
-    items.reserve(_in.MemberCount());
+    Properties properties;
+    properties.sourceId = _sourceId;
+    properties.reserve(_in.MemberCount());
 
     for (auto it = _in.MemberBegin(); it != _in.MemberEnd(); ++it) {
 
         const auto& name = it->name.GetString();
         const auto& value = it->value;
         if (value.IsNumber()) {
-            items.emplace_back(name, value.GetDouble());
+            properties.emplaceBack(name, value.GetDouble());
         } else if (it->value.IsString()) {
-            items.emplace_back(name, value.GetString());
+            properties.emplaceBack(name, value.GetString());
         }
 
     }
 
-    Properties properties;
-    properties.sourceId = _sourceId;
-    properties.setSorted(std::move(items));
     properties.sort();
 
     return properties;
@@ -149,6 +163,8 @@ Layer GeoJson::getLayer(const JsonValue& _in, const Transform& _proj, int32_t _s
         layer.features.push_back(getFeature(*featureIt, _proj, _sourceId));
     }
 
+    layer.buildKeyBloom();
+
     return layer;
 
 }
@@ -101,30 +101,6 @@ glm::vec2 worldToScreenSpace(const glm::mat4& _mvp, const glm::vec4& _worldPosit
     return clipToScreenSpace(clipCoords, _screenSize);
 }
 
-glm::vec2 centroid(const std::vector<std::vector<glm::vec3>>& _polygon) {
-
-    if (_polygon.empty()) {
-        return glm::vec2();
-    }
-
-    // We will consider only the outer ring of the polygon when calculating
-    // the centroid - holes will be ignored. It would be possible to transform
-    // a polygon with holes into a polygon that covers the same set of points
-    // without any holes, but that seems overly complex for our needs.
-    const auto& ring = _polygon.front();
-    glm::vec2 centroid;
-    float area = 0.f;
-
-    for (auto curr = ring.begin(), prev = ring.end() - 1; curr != ring.end(); prev = curr, ++curr) {
-        float a = (prev->x * curr->y - curr->x * prev->y);
-        centroid.x += (prev->x + curr->x) * a;
-        centroid.y += (prev->y + curr->y) * a;
-        area += a;
-    }
-
-    return centroid / (3.f * area);
-}
-
 // square distance from a point <_p> to a segment <_p1,_p2>
 // http://stackoverflow.com/questions/849211/shortest-distance-between-a-point-and-a-line-segment
 //
@@ -145,6 +121,43 @@ float sqSegmentDistance(const glm::vec2& _p, const glm::vec2& _p1, const glm::ve
     return glm::length2(_p - _p1);
 }
 
+namespace {
+
+template<typename Point>
+void sqSegmentDistancesImpl(const Point* _points, size_t _count,
+                            const glm::vec2& _a, const glm::vec2& _b, float* _outSqDist) {
+    float dx = _b.x - _a.x;
+    float dy = _b.y - _a.y;
+    float lengthSq = dx * dx + dy * dy;
+
+    // Clamping the projection parameter instead of branching on it keeps
+    // the loop body straight-line code; a degenerate segment makes every
+    // projection land on _a, matching sqSegmentDistance.
+    float invLengthSq = (lengthSq != 0.f) ? 1.f / lengthSq : 0.f;
+
+    for (size_t i = 0; i < _count; i++) {
+        float px = _points[i].x - _a.x;
+        float py = _points[i].y - _a.y;
+        float t = (px * dx + py * dy) * invLengthSq;
+        t = (t < 0.f) ? 0.f : ((t > 1.f) ? 1.f : t);
+        float ox = px - dx * t;
+        float oy = py - dy * t;
+        _outSqDist[i] = ox * ox + oy * oy;
+    }
+}
+
+}
+
+void sqSegmentDistances(const glm::vec2* _points, size_t _count,
+                        const glm::vec2& _a, const glm::vec2& _b, float* _outSqDist) {
+    sqSegmentDistancesImpl(_points, _count, _a, _b, _outSqDist);
+}
+
+void sqSegmentDistances(const glm::vec3* _points, size_t _count,
+                        const glm::vec2& _a, const glm::vec2& _b, float* _outSqDist) {
+    sqSegmentDistancesImpl(_points, _count, _a, _b, _outSqDist);
+}
+
 bool isPowerOfTwo(int _value) {
     return (_value & (_value - 1)) == 0;
 }
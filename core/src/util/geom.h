@@ -106,8 +106,32 @@ glm::vec2 worldToScreenSpace(const glm::mat4& _mvp, const glm::vec4& _worldPosit
 
 glm::vec2 worldToScreenSpace(const glm::mat4& _mvp, const glm::vec4& _worldPosition, const glm::vec2& _screenSize, bool& _clipped);
 
-/* Computes the geometric center of the two dimensional region defined by the polygon */
-glm::vec2 centroid(const std::vector<std::vector<glm::vec3>>& _polygon);
+/* Computes the geometric center of the two dimensional region defined by the
+ * polygon; works with any nested container of glm::vec3-like rings */
+template<class Polygon>
+glm::vec2 centroid(const Polygon& _polygon) {
+
+    if (_polygon.empty()) {
+        return glm::vec2();
+    }
+
+    // We will consider only the outer ring of the polygon when calculating
+    // the centroid - holes will be ignored. It would be possible to transform
+    // a polygon with holes into a polygon that covers the same set of points
+    // without any holes, but that seems overly complex for our needs.
+    const auto& ring = _polygon.front();
+    glm::vec2 centroid;
+    float area = 0.f;
+
+    for (auto curr = ring.begin(), prev = ring.end() - 1; curr != ring.end(); prev = curr, ++curr) {
+        float a = (prev->x * curr->y - curr->x * prev->y);
+        centroid.x += (prev->x + curr->x) * a;
+        centroid.y += (prev->y + curr->y) * a;
+        area += a;
+    }
+
+    return centroid / (3.f * area);
+}
 
 inline glm::vec2 rotateBy(const glm::vec2& _in, const glm::vec2& _normal) {
     return {
@@ -118,6 +142,15 @@ inline glm::vec2 rotateBy(const glm::vec2& _in, const glm::vec2& _normal) {
 
 float sqSegmentDistance(const glm::vec2& _p, const glm::vec2& _p1, const glm::vec2& _p2);
 
+/* Squared distance from each of _count contiguous points to the segment
+ * <_a,_b>, written to _outSqDist. The loop body is branchless so the
+ * compiler can vectorize it; prefer this over calling sqSegmentDistance
+ * point-by-point when scanning a span of points against one segment. */
+void sqSegmentDistances(const glm::vec2* _points, size_t _count,
+                        const glm::vec2& _a, const glm::vec2& _b, float* _outSqDist);
+void sqSegmentDistances(const glm::vec3* _points, size_t _count,
+                        const glm::vec2& _a, const glm::vec2& _b, float* _outSqDist);
+
 bool isPowerOfTwo(int _value);
 
 float sqPointSegmentDistance(const glm::vec2& _p, const glm::vec2& _a, const glm::vec2& _b);
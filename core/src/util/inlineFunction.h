@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace Tangram {
+
+/* Move-only callable with fixed-size inline storage and no heap
+ * fallback: a callable whose captures exceed the storage is rejected at
+ * compile time instead of silently allocating, the failure mode of
+ * std::function once captures outgrow its small-buffer space. Used for
+ * the cross-thread job queues, so posting a job never allocates. */
+template<typename Signature, size_t Storage = 64>
+class InlineFunction;
+
+template<typename R, typename... Args, size_t Storage>
+class InlineFunction<R(Args...), Storage> {
+
+public:
+
+    InlineFunction() {}
+
+    template<typename F,
+             typename = typename std::enable_if<
+                 !std::is_same<typename std::decay<F>::type, InlineFunction>::value>::type>
+    InlineFunction(F&& _fn) {
+        using Fn = typename std::decay<F>::type;
+        static_assert(sizeof(Fn) <= Storage,
+                      "Captures exceed the inline storage of this job type");
+        static_assert(alignof(Fn) <= alignof(typename std::aligned_storage<Storage>::type),
+                      "Callable alignment exceeds the inline storage alignment");
+
+        new (&m_storage) Fn(std::forward<F>(_fn));
+        m_invoke = [](void* _s, Args... _args) -> R {
+            return (*static_cast<Fn*>(_s))(std::forward<Args>(_args)...);
+        };
+        m_relocate = [](void* _from, void* _to) {
+            Fn* fn = static_cast<Fn*>(_from);
+            if (_to) { new (_to) Fn(std::move(*fn)); }
+            fn->~Fn();
+        };
+    }
+
+    InlineFunction(InlineFunction&& _other) {
+        moveIn(_other);
+    }
+
+    InlineFunction& operator=(InlineFunction&& _other) {
+        if (this != &_other) {
+            reset();
+            moveIn(_other);
+        }
+        return *this;
+    }
+
+    InlineFunction(const InlineFunction&) = delete;
+    InlineFunction& operator=(const InlineFunction&) = delete;
+
+    ~InlineFunction() { reset(); }
+
+    R operator()(Args... _args) {
+        return m_invoke(&m_storage, std::forward<Args>(_args)...);
+    }
+
+    explicit operator bool() const { return m_invoke != nullptr; }
+
+private:
+
+    void reset() {
+        if (m_relocate) { m_relocate(&m_storage, nullptr); }
+        m_invoke = nullptr;
+        m_relocate = nullptr;
+    }
+
+    void moveIn(InlineFunction& _other) {
+        if (_other.m_relocate) {
+            _other.m_relocate(&_other.m_storage, &m_storage);
+        }
+        m_invoke = _other.m_invoke;
+        m_relocate = _other.m_relocate;
+        _other.m_invoke = nullptr;
+        _other.m_relocate = nullptr;
+    }
+
+    typename std::aligned_storage<Storage>::type m_storage;
+
+    R (*m_invoke)(void*, Args...) = nullptr;
+
+    // Move-constructs the callable into the second argument (when given)
+    // and destroys the original; doubles as the destructor.
+    void (*m_relocate)(void*, void*) = nullptr;
+};
+
+}
@@ -42,7 +42,11 @@ void InputHandler::update(float _dt) {
         m_velocityZoom -= _dt * DAMPING_ZOOM * m_velocityZoom;
         m_view.zoom(m_velocityZoom * _dt);
 
+        m_view.setPanVelocity(m_velocityPan);
+
         requestRender();
+    } else {
+        m_view.setPanVelocity({ 0.f, 0.f });
     }
 }
 
@@ -161,6 +165,8 @@ void InputHandler::cancelFling() {
 void InputHandler::onGesture() {
 
     setVelocity(0.f, { 0.f, 0.f });
+    // A new gesture invalidates any eased transition's destination.
+    m_view.clearPredictedPosition();
     requestRender();
 
 }
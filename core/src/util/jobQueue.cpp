@@ -13,7 +13,7 @@ void JobQueue::add(Job job) {
 
     if (!m_stopped) {
         std::lock_guard<std::mutex> lock(m_mutex);
-        m_jobs.push_back(job);
+        m_jobs.push_back(std::move(job));
     } else {
         job();
     }
@@ -25,7 +25,7 @@ void JobQueue::runJobs() {
         Job job;
         {
             std::lock_guard<std::mutex> lock(m_mutex);
-            job.swap(m_jobs[i]);
+            job = std::move(m_jobs[i]);
         }
         job();
     }
@@ -1,6 +1,7 @@
 #pragma once
 
-#include <functional>
+#include "util/inlineFunction.h"
+
 #include <mutex>
 #include <vector>
 
@@ -12,7 +13,9 @@ namespace Tangram {
 class JobQueue {
 
 public:
-    using Job = std::function<void()>;
+    // Storage is sized for the largest job posted in the engine: a
+    // Disposer task plus the RenderState pointer it is bound with.
+    using Job = InlineFunction<void(), 96>;
 
     JobQueue() = default;
 
@@ -23,4 +23,40 @@ namespace Tangram {
 
     }
 
+    JsonDocument JsonParseStream(StreamedBuffer& _stream, const char** _error, size_t* _errorOffset) {
+
+        JsonDocument document;
+        StreamedBuffer::Reader reader(_stream);
+        rapidjson::EncodedInputStream<rapidjson::UTF8<char>, StreamedBuffer::Reader> istream(reader);
+        document.ParseStream(istream);
+
+        *_error = nullptr;
+        *_errorOffset = 0;
+        if (document.HasParseError()) {
+            *_error = rapidjson::GetParseError_En(document.GetParseError());
+            *_errorOffset = document.GetErrorOffset();
+        }
+
+        return document;
+
+    }
+
+    JsonDocument JsonParseInsitu(char* _bytes, size_t _length, const char** _error, size_t* _errorOffset) {
+
+        _bytes[_length] = '\0';
+
+        JsonDocument document;
+        document.ParseInsitu(_bytes);
+
+        *_error = nullptr;
+        *_errorOffset = 0;
+        if (document.HasParseError()) {
+            *_error = rapidjson::GetParseError_En(document.GetParseError());
+            *_errorOffset = document.GetErrorOffset();
+        }
+
+        return document;
+
+    }
+
 }
@@ -1,7 +1,22 @@
 #pragma once
 
+// Enable rapidjson's vectorized whitespace skipping where the target
+// instruction set allows it. These must be defined before any rapidjson
+// header is included; core only includes rapidjson through this wrapper.
+#if !defined(RAPIDJSON_SSE42) && !defined(RAPIDJSON_SSE2) && !defined(RAPIDJSON_NEON)
+#if defined(__SSE4_2__)
+#define RAPIDJSON_SSE42
+#elif defined(__SSE2__)
+#define RAPIDJSON_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define RAPIDJSON_NEON
+#endif
+#endif
+
 #include "rapidjson/document.h"
 
+#include "util/streamedBuffer.h"
+
 namespace Tangram {
 
     using JsonDocument = rapidjson::Document;
@@ -9,4 +24,19 @@ namespace Tangram {
 
     JsonDocument JsonParseBytes(const char* _bytes, size_t _length, const char** _error, size_t* _errorOffset);
 
+    /* Parses a document from a StreamedBuffer as its bytes arrive,
+     * blocking on the stream tail until the producer delivers more, so
+     * the parse overlaps with the transfer feeding the stream. Strings
+     * are copied into the document; the stream's chunks need not outlive
+     * it. A stream finished with failure truncates the input and
+     * surfaces as a parse error. */
+    JsonDocument JsonParseStream(StreamedBuffer& _stream, const char** _error, size_t* _errorOffset);
+
+    /* Parses _bytes in place: strings in the resulting document point into
+     * the buffer instead of being copied, which skips one allocation and
+     * copy per string. The buffer is modified (unescaped and terminated),
+     * must hold a writable byte past _length for the terminator, and must
+     * stay alive for the lifetime of the returned document. */
+    JsonDocument JsonParseInsitu(char* _bytes, size_t _length, const char** _error, size_t* _errorOffset);
+
 }
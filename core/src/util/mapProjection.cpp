@@ -16,6 +16,14 @@ MercatorProjection::MercatorProjection(int _tileSize) :
     m_Res = 2.0 * HALF_CIRCUMFERENCE * invTileSize;
 }
 
+void MapProjection::LonLatToTileUnits(glm::dvec2* _lonLats, size_t _count,
+                                      glm::dvec2 _origin, double _scale) const {
+    for (size_t i = 0; i < _count; i++) {
+        glm::dvec2 meters = LonLatToMeters(_lonLats[i]);
+        _lonLats[i] = (meters - _origin) * _scale;
+    }
+}
+
 glm::dvec2 MercatorProjection::LonLatToMeters(const glm::dvec2 _lonLat) const {
     glm::dvec2 meters;
     meters.x = _lonLat.x * HALF_CIRCUMFERENCE * INV_180;
@@ -24,6 +32,21 @@ glm::dvec2 MercatorProjection::LonLatToMeters(const glm::dvec2 _lonLat) const {
     return (meters);
 }
 
+void MercatorProjection::LonLatToTileUnits(glm::dvec2* _lonLats, size_t _count,
+                                           glm::dvec2 _origin, double _scale) const {
+    // Straight-line form of LonLatToMeters with the tile transform folded
+    // in; the loop body is free of calls apart from log/tan, so whole
+    // coordinate arrays run through one pass per geometry.
+    const double metersPerDegree = HALF_CIRCUMFERENCE * INV_180;
+
+    for (size_t i = 0; i < _count; i++) {
+        double x = _lonLats[i].x * metersPerDegree;
+        double y = log( tan( PI*0.25 + _lonLats[i].y * PI * INV_360)) * (double)R_EARTH;
+        _lonLats[i].x = (x - _origin.x) * _scale;
+        _lonLats[i].y = (y - _origin.y) * _scale;
+    }
+}
+
 glm::dvec2 MercatorProjection::MetersToLonLat(const glm::dvec2 _meters) const {
     glm::dvec2 lonLat;
     double invHalfCircum = 1.0/HALF_CIRCUMFERENCE;
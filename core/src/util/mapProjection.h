@@ -34,6 +34,20 @@ public:
      */
     virtual glm::dvec2 LonLatToMeters(const glm::dvec2 _lonLat) const = 0;
 
+    /*
+     * Batched LonLat to tile-local units: projects _count positions to
+     * meters, then offsets by _origin and scales by _scale, in place.
+     * One call per geometry replaces the per-point virtual dispatch
+     * during tile parsing; projections can override with a tight loop.
+     *  Arguments:
+     *    _lonLats: array of lon/lat positions, overwritten with the result
+     *    _count: number of positions in _lonLats
+     *    _origin: projection-meter origin subtracted from each position
+     *    _scale: scale applied after the origin offset
+     */
+    virtual void LonLatToTileUnits(glm::dvec2* _lonLats, size_t _count,
+                                   glm::dvec2 _origin, double _scale) const;
+
     /*
      * ProjectionType-Meters to Lon Lat
      *  Arguments:
@@ -159,6 +173,8 @@ public:
     MercatorProjection(int  _tileSize=256);
 
     virtual glm::dvec2 LonLatToMeters(const glm::dvec2 _lonLat) const override;
+    virtual void LonLatToTileUnits(glm::dvec2* _lonLats, size_t _count,
+                                   glm::dvec2 _origin, double _scale) const override;
     virtual glm::dvec2 MetersToLonLat(const glm::dvec2 _meters) const override;
     virtual glm::dvec2 PixelsToMeters(const glm::dvec2 _pix, const int _zoom) const override;
     virtual glm::dvec2 MetersToPixel(const glm::dvec2 _meters, const int _zoom) const override;
@@ -0,0 +1,7 @@
+#include "memoryArena.h"
+
+namespace Tangram {
+
+thread_local MemoryArena* MemoryArena::s_current = nullptr;
+
+}
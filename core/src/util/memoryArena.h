@@ -0,0 +1,139 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace Tangram {
+
+/* Bump allocator for allocations that share one lifetime: the geometry
+ * containers of a TileData, and the per-frame temporaries of the map
+ * update (see Map::update).
+ *
+ * All coordinates parsed for one tile are freed together when the tile
+ * data is dropped, so parse-time allocation reduces to a pointer bump
+ * and teardown to releasing the arena blocks. An arena is installed for
+ * the current thread with MemoryArena::Scope; containers created while
+ * no arena is installed fall back to the global heap.
+ */
+class MemoryArena {
+
+public:
+
+    static constexpr size_t BLOCK_SIZE = 128 * 1024;
+
+    MemoryArena() {}
+
+    MemoryArena(const MemoryArena&) = delete;
+    MemoryArena& operator=(const MemoryArena&) = delete;
+
+    void* allocate(size_t _bytes, size_t _align) {
+
+        auto p = reinterpret_cast<uintptr_t>(m_ptr);
+        auto aligned = (p + _align - 1) & ~uintptr_t(_align - 1);
+
+        if (!m_ptr || aligned + _bytes > reinterpret_cast<uintptr_t>(m_end)) {
+            return allocateBlock(_bytes, _align);
+        }
+
+        m_ptr = reinterpret_cast<char*>(aligned + _bytes);
+        return reinterpret_cast<void*>(aligned);
+    }
+
+    size_t totalBytes() const { return m_total; }
+
+    /* Rewind the arena so the memory of its blocks is reused by later
+     * allocations. After the first few cycles the block list settles
+     * into a single block sized for a whole cycle, so steady-state use
+     * stops touching the heap. Everything allocated from the arena must
+     * be dead before it is rewound. */
+    void reset() {
+        if (m_blocks.empty()) { return; }
+
+        if (m_blocks.size() > 1) {
+            size_t total = m_total;
+            m_blocks.clear();
+            m_blocks.push_back(std::unique_ptr<char[]>(new char[total]));
+            m_ptr = m_blocks.back().get();
+            m_end = m_ptr + total;
+        } else {
+            m_ptr = m_blocks.front().get();
+        }
+    }
+
+    /* Installs an arena as the allocation target of the current thread
+     * for the lifetime of the scope. */
+    class Scope {
+    public:
+        explicit Scope(MemoryArena* _arena) : m_previous(s_current) {
+            s_current = _arena;
+        }
+        ~Scope() {
+            s_current = m_previous;
+        }
+    private:
+        MemoryArena* m_previous;
+    };
+
+    static MemoryArena* current() { return s_current; }
+
+private:
+
+    void* allocateBlock(size_t _bytes, size_t _align) {
+        size_t blockSize = std::max(BLOCK_SIZE, _bytes + _align);
+
+        m_blocks.push_back(std::unique_ptr<char[]>(new char[blockSize]));
+        m_total += blockSize;
+
+        m_ptr = m_blocks.back().get();
+        m_end = m_ptr + blockSize;
+
+        return allocate(_bytes, _align);
+    }
+
+    std::vector<std::unique_ptr<char[]>> m_blocks;
+    char* m_ptr = nullptr;
+    char* m_end = nullptr;
+    size_t m_total = 0;
+
+    static thread_local MemoryArena* s_current;
+};
+
+/* Minimal allocator binding a container to the thread's current arena
+ * at construction time. Deallocation of arena memory is a no-op; the
+ * memory is released with the arena. */
+template<typename T>
+struct ArenaAllocator {
+
+    using value_type = T;
+
+    MemoryArena* arena;
+
+    ArenaAllocator() : arena(MemoryArena::current()) {}
+
+    template<typename U>
+    ArenaAllocator(const ArenaAllocator<U>& _other) : arena(_other.arena) {}
+
+    T* allocate(size_t _n) {
+        if (arena) {
+            return static_cast<T*>(arena->allocate(_n * sizeof(T), alignof(T)));
+        }
+        return static_cast<T*>(::operator new(_n * sizeof(T)));
+    }
+
+    void deallocate(T* _ptr, size_t) {
+        if (!arena) { ::operator delete(_ptr); }
+    }
+
+    bool operator==(const ArenaAllocator& _other) const { return arena == _other.arena; }
+    bool operator!=(const ArenaAllocator& _other) const { return arena != _other.arena; }
+};
+
+/* Vector drawing from the thread's current arena; for transients that
+ * do not outlive the enclosing arena scope. */
+template<typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Tangram {
+
+/* Bounded lock-free multi-producer/multi-consumer queue, after Dmitry
+ * Vyukov's bounded MPMC ring. push() and pop() never block; push()
+ * returns false and leaves its argument untouched when the ring is
+ * full, pop() returns false when it is empty.
+ *
+ * The capacity must be a power of two.
+ */
+template<typename T>
+class MPMCQueue {
+
+public:
+
+    explicit MPMCQueue(std::size_t _capacity)
+        : m_cells(_capacity),
+          m_mask(_capacity - 1) {
+
+        assert(_capacity >= 2 && (_capacity & (_capacity - 1)) == 0);
+
+        for (std::size_t i = 0; i < _capacity; i++) {
+            m_cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MPMCQueue(const MPMCQueue&) = delete;
+    MPMCQueue& operator=(const MPMCQueue&) = delete;
+
+    bool push(T&& _value) {
+        Cell* cell;
+        std::size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+
+        while (true) {
+            cell = &m_cells[pos & m_mask];
+            std::size_t seq = cell->sequence.load(std::memory_order_acquire);
+            std::intptr_t diff = std::intptr_t(seq) - std::intptr_t(pos);
+
+            if (diff == 0) {
+                if (m_enqueuePos.compare_exchange_weak(pos, pos + 1,
+                                                       std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                // Ring is full
+                return false;
+            } else {
+                pos = m_enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->value = std::move(_value);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    bool pop(T& _value) {
+        Cell* cell;
+        std::size_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+
+        while (true) {
+            cell = &m_cells[pos & m_mask];
+            std::size_t seq = cell->sequence.load(std::memory_order_acquire);
+            std::intptr_t diff = std::intptr_t(seq) - std::intptr_t(pos + 1);
+
+            if (diff == 0) {
+                if (m_dequeuePos.compare_exchange_weak(pos, pos + 1,
+                                                       std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                // Ring is empty
+                return false;
+            } else {
+                pos = m_dequeuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        _value = std::move(cell->value);
+        cell->sequence.store(pos + m_mask + 1, std::memory_order_release);
+
+        return true;
+    }
+
+private:
+
+    struct Cell {
+        std::atomic<std::size_t> sequence;
+        T value;
+    };
+
+    std::vector<Cell> m_cells;
+    const std::size_t m_mask;
+
+    std::atomic<std::size_t> m_enqueuePos{0};
+    std::atomic<std::size_t> m_dequeuePos{0};
+};
+
+}
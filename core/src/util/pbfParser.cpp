@@ -91,6 +91,8 @@ Feature PbfParser::getFeature(ParserContext& _ctx, protobuf::message _featureIn)
     _ctx.featureTags.clear();
     _ctx.featureTags.assign(_ctx.keys.size(), -1);
 
+    int numTags = 0;
+
 
     while(_featureIn.next()) {
         switch(_featureIn.tag) {
@@ -122,6 +124,7 @@ Feature PbfParser::getFeature(ParserContext& _ctx, protobuf::message _featureIn)
                         return feature;
                     }
 
+                    if (_ctx.featureTags[tagKey] < 0) { numTags++; }
                     _ctx.featureTags[tagKey] = valueKey;
                 }
                 break;
@@ -140,16 +143,21 @@ Feature PbfParser::getFeature(ParserContext& _ctx, protobuf::message _featureIn)
         }
     }
 
-    std::vector<Properties::Item> properties;
-    properties.reserve(_ctx.featureTags.size());
+    feature.props.clear();
+    feature.props.reserve(numTags);
 
     for (int tagKey : _ctx.orderedKeys) {
         int tagValue = _ctx.featureTags[tagKey];
         if (tagValue >= 0) {
-            properties.emplace_back(_ctx.keys[tagKey], _ctx.values[tagValue]);
+            // Transfer values that no later feature references; this
+            // avoids one string allocation per name-like tag.
+            if (!_ctx.valueRefs.empty() && --_ctx.valueRefs[tagValue] == 0) {
+                feature.props.emplaceBack(_ctx.keys[tagKey], std::move(_ctx.values[tagValue]));
+            } else {
+                feature.props.emplaceBack(_ctx.keys[tagKey], _ctx.values[tagValue]);
+            }
         }
     }
-    feature.props.setSorted(std::move(properties));
 
     switch(feature.geometryType) {
         case GeometryType::points:
@@ -307,6 +315,35 @@ Layer PbfParser::getLayer(ParserContext& _ctx, protobuf::message _layerIn) {
                   return Properties::keyComparator(_ctx.keys[a], _ctx.keys[b]);
               });
 
+    // Count value references across all features, so getFeature can
+    // move values claimed by exactly one feature out of the context.
+    _ctx.valueRefs.clear();
+    _ctx.valueRefs.assign(_ctx.values.size(), 0);
+
+    for (auto featureItr : _ctx.featureMsgs) {
+        do {
+            auto featureMsg = featureItr.getMessage();
+
+            while (featureMsg.next()) {
+                if (featureMsg.tag == FEATURE_TAGS) {
+                    protobuf::message tagsMsg = featureMsg.getMessage();
+
+                    while (tagsMsg) {
+                        tagsMsg.varint();
+                        if (!tagsMsg) { break; }
+
+                        uint64_t valueKey = tagsMsg.varint();
+                        if (valueKey < _ctx.valueRefs.size()) {
+                            _ctx.valueRefs[valueKey]++;
+                        }
+                    }
+                } else {
+                    featureMsg.skip();
+                }
+            }
+        } while (featureItr.next() && featureItr.tag == LAYER_FEATURE);
+    }
+
     layer.features.reserve(numFeatures);
     for (auto& featureItr : _ctx.featureMsgs) {
         do {
@@ -317,6 +354,8 @@ Layer PbfParser::getLayer(ParserContext& _ctx, protobuf::message _layerIn) {
         } while (featureItr.next() && featureItr.tag == LAYER_FEATURE);
     }
 
+    layer.buildKeyBloom();
+
     return layer;
 }
 
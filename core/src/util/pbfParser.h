@@ -28,6 +28,9 @@ namespace PbfParser {
         Geometry geometry;
         // Map Key ID -> Tag values
         std::vector<int> featureTags;
+        // Remaining references per value; values referenced by a single
+        // feature are moved into its Properties instead of copied.
+        std::vector<int> valueRefs;
         // Key IDs sorted by Property key ordering
         std::vector<int> orderedKeys;
 
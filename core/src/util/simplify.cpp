@@ -0,0 +1,77 @@
+#include "simplify.h"
+
+#include "util/geom.h"
+
+#include <vector>
+
+namespace Tangram {
+
+void simplifyLine(const Line& _in, float _tolerance, Line& _out) {
+
+    _out.clear();
+
+    size_t n = _in.size();
+
+    if (n < 3 || _tolerance <= 0.f) {
+        _out.assign(_in.begin(), _in.end());
+        return;
+    }
+
+    float sqTolerance = _tolerance * _tolerance;
+
+    std::vector<uint8_t> keep(n, 0);
+    keep[0] = 1;
+    keep[n - 1] = 1;
+
+    size_t numKept = 2;
+
+    // Iterative Douglas-Peucker; ranges still to refine are kept on an
+    // explicit stack to bound stack depth on degenerate inputs.
+    std::vector<std::pair<size_t, size_t>> ranges;
+    ranges.emplace_back(0, n - 1);
+
+    // Scratch for the batch distance kernel, reused across ranges
+    std::vector<float> sqDists(n);
+
+    while (!ranges.empty()) {
+
+        size_t first = ranges.back().first;
+        size_t last = ranges.back().second;
+        ranges.pop_back();
+
+        if (last <= first + 1) { continue; }
+
+        glm::vec2 a(_in[first]);
+        glm::vec2 b(_in[last]);
+
+        // Distances of all interior points to the range's chord in one
+        // vectorizable pass, then pick the farthest.
+        size_t count = last - first - 1;
+        sqSegmentDistances(&_in[first + 1], count, a, b, sqDists.data());
+
+        float maxSqDist = 0.f;
+        size_t index = first;
+
+        for (size_t i = 0; i < count; i++) {
+            if (sqDists[i] > maxSqDist) {
+                maxSqDist = sqDists[i];
+                index = first + 1 + i;
+            }
+        }
+
+        if (maxSqDist > sqTolerance) {
+            keep[index] = 1;
+            numKept++;
+            ranges.emplace_back(first, index);
+            ranges.emplace_back(index, last);
+        }
+    }
+
+    _out.reserve(numKept);
+
+    for (size_t i = 0; i < n; i++) {
+        if (keep[i]) { _out.push_back(_in[i]); }
+    }
+}
+
+}
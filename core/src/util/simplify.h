@@ -0,0 +1,16 @@
+#pragma once
+
+#include "data/tileData.h"
+
+namespace Tangram {
+
+/* Douglas-Peucker simplification of a line or ring.
+ *
+ * Copies the points of _in whose removal would move the line by more
+ * than _tolerance (in the units of the input coordinates) into _out;
+ * the first and last point are always kept. With a tolerance of zero
+ * the line is copied unchanged.
+ */
+void simplifyLine(const Line& _in, float _tolerance, Line& _out);
+
+}
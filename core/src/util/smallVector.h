@@ -0,0 +1,168 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace Tangram {
+
+/* Vector with inline storage for up to N elements, spilling to the heap
+ * only when it grows beyond that. Meant for per-feature containers whose
+ * typical size is small and known, where the one heap allocation of a
+ * std::vector dominates the cost of the container. Only the part of the
+ * vector interface the map core uses is provided. */
+template<typename T, size_t N>
+class SmallVector {
+
+public:
+
+    using value_type = T;
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    SmallVector() : m_data(inlineData()) {}
+
+    SmallVector(const SmallVector& _other) : m_data(inlineData()) {
+        reserve(_other.m_size);
+        for (size_t i = 0; i < _other.m_size; i++) {
+            new (m_data + i) T(_other.m_data[i]);
+        }
+        m_size = _other.m_size;
+    }
+
+    SmallVector(SmallVector&& _other) : m_data(inlineData()) {
+        adopt(std::move(_other));
+    }
+
+    SmallVector& operator=(const SmallVector& _other) {
+        if (this != &_other) {
+            clear();
+            reserve(_other.m_size);
+            for (size_t i = 0; i < _other.m_size; i++) {
+                new (m_data + i) T(_other.m_data[i]);
+            }
+            m_size = _other.m_size;
+        }
+        return *this;
+    }
+
+    SmallVector& operator=(SmallVector&& _other) {
+        if (this != &_other) {
+            clear();
+            if (m_data != inlineData()) {
+                ::operator delete(m_data);
+                m_data = inlineData();
+                m_capacity = N;
+            }
+            adopt(std::move(_other));
+        }
+        return *this;
+    }
+
+    ~SmallVector() {
+        clear();
+        if (m_data != inlineData()) {
+            ::operator delete(m_data);
+        }
+    }
+
+    iterator begin() { return m_data; }
+    iterator end() { return m_data + m_size; }
+    const_iterator begin() const { return m_data; }
+    const_iterator end() const { return m_data + m_size; }
+
+    T& operator[](size_t _index) { return m_data[_index]; }
+    const T& operator[](size_t _index) const { return m_data[_index]; }
+
+    T& back() { return m_data[m_size - 1]; }
+    const T& back() const { return m_data[m_size - 1]; }
+
+    size_t size() const { return m_size; }
+    size_t capacity() const { return m_capacity; }
+    bool empty() const { return m_size == 0; }
+
+    /* Whether the elements still live in the in-object buffer */
+    bool isInline() const { return m_data == inlineData(); }
+
+    void clear() {
+        for (size_t i = 0; i < m_size; i++) {
+            m_data[i].~T();
+        }
+        m_size = 0;
+    }
+
+    void reserve(size_t _capacity) {
+        if (_capacity > m_capacity) {
+            grow(_capacity);
+        }
+    }
+
+    void push_back(const T& _value) { emplace_back(_value); }
+    void push_back(T&& _value) { emplace_back(std::move(_value)); }
+
+    template<typename... Args>
+    T& emplace_back(Args&&... _args) {
+        if (m_size == m_capacity) {
+            grow(m_capacity * 2);
+        }
+        new (m_data + m_size) T(std::forward<Args>(_args)...);
+        return m_data[m_size++];
+    }
+
+    template<typename... Args>
+    iterator emplace(const_iterator _pos, Args&&... _args) {
+        size_t index = _pos - m_data;
+        emplace_back(std::forward<Args>(_args)...);
+        std::rotate(m_data + index, m_data + m_size - 1, m_data + m_size);
+        return m_data + index;
+    }
+
+private:
+
+    T* inlineData() { return reinterpret_cast<T*>(&m_inline); }
+    const T* inlineData() const { return reinterpret_cast<const T*>(&m_inline); }
+
+    void grow(size_t _capacity) {
+        T* data = static_cast<T*>(::operator new(_capacity * sizeof(T)));
+        for (size_t i = 0; i < m_size; i++) {
+            new (data + i) T(std::move(m_data[i]));
+            m_data[i].~T();
+        }
+        if (m_data != inlineData()) {
+            ::operator delete(m_data);
+        }
+        m_data = data;
+        m_capacity = _capacity;
+    }
+
+    void adopt(SmallVector&& _other) {
+        if (!_other.isInline()) {
+            m_data = _other.m_data;
+            m_capacity = _other.m_capacity;
+            m_size = _other.m_size;
+            _other.m_data = _other.inlineData();
+            _other.m_capacity = N;
+            _other.m_size = 0;
+        } else {
+            for (size_t i = 0; i < _other.m_size; i++) {
+                new (m_data + i) T(std::move(_other.m_data[i]));
+                _other.m_data[i].~T();
+            }
+            m_size = _other.m_size;
+            _other.m_size = 0;
+        }
+    }
+
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type m_inline[N];
+
+    T* m_data;
+
+    size_t m_size = 0;
+
+    size_t m_capacity = N;
+
+};
+
+}
@@ -0,0 +1,67 @@
+#include "util/streamedBuffer.h"
+
+namespace Tangram {
+
+void StreamedBuffer::append(const char* _data, size_t _size) {
+
+    if (_size == 0) { return; }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_done) { return; }
+
+        m_chunks.emplace_back(_data, _data + _size);
+        m_size += _size;
+    }
+    m_condition.notify_all();
+}
+
+void StreamedBuffer::finish(bool _ok) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_done) { return; }
+
+        m_done = true;
+        m_ok = _ok;
+    }
+    m_condition.notify_all();
+}
+
+bool StreamedBuffer::success() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_done && m_ok;
+}
+
+std::vector<char> StreamedBuffer::take() {
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_condition.wait(lock, [&]{ return m_done; });
+
+    std::vector<char> buffer;
+    if (!m_ok) { return buffer; }
+
+    buffer.reserve(m_size);
+    for (auto& chunk : m_chunks) {
+        buffer.insert(buffer.end(), chunk.begin(), chunk.end());
+    }
+    return buffer;
+}
+
+bool StreamedBuffer::Reader::advance() {
+
+    std::unique_lock<std::mutex> lock(m_source.m_mutex);
+
+    while (true) {
+        if (m_nextChunk < m_source.m_chunks.size()) {
+            m_current = &m_source.m_chunks[m_nextChunk++];
+            m_offset = 0;
+            return true;
+        }
+        if (m_source.m_done) {
+            m_current = nullptr;
+            return false;
+        }
+        m_source.m_condition.wait(lock);
+    }
+}
+
+}
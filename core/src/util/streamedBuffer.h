@@ -0,0 +1,109 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+namespace Tangram {
+
+/* A byte stream filled chunk by chunk from one thread and read
+ * sequentially from another, so a consumer can start working on a
+ * network response while the rest of it is still in transit.
+ *
+ * The producer appends chunks as they arrive and calls finish() exactly
+ * once; the consumer reads through a Reader, which blocks at the tail
+ * until more data or the finish arrives. All chunks are kept, so after a
+ * successful finish take() can still hand out the complete response for
+ * the caches that want the whole buffer.
+ */
+class StreamedBuffer {
+
+public:
+
+    /* Append _size bytes to the tail of the stream. Appends after
+     * finish() are dropped. */
+    void append(const char* _data, size_t _size);
+
+    /* End the stream, waking blocked readers; _ok is false when the
+     * transfer failed or was aborted. Only the first call counts, so
+     * both the producer and a canceling owner may safely finish. */
+    void finish(bool _ok);
+
+    /* Whether the stream ended successfully; false while still open */
+    bool success() const;
+
+    /* Wait for the stream to end and return all of its bytes in one
+     * buffer, or an empty buffer when it did not end successfully. */
+    std::vector<char> take();
+
+    /* Sequential reader over the stream, modeled on the rapidjson input
+     * stream concept so a document can parse straight from it. Reads
+     * past the buffered tail block until the producer delivers more;
+     * past the end of a finished stream they return '\0'. Only chunk
+     * boundaries take the lock - within a chunk reads touch plain
+     * pointers. One reader per thread; the Put side of the concept is
+     * never called for an input stream.
+     */
+    class Reader {
+
+    public:
+
+        using Ch = char;
+
+        explicit Reader(StreamedBuffer& _source) : m_source(_source) {}
+
+        Ch Peek() {
+            if (!ensure()) { return '\0'; }
+            return (*m_current)[m_offset];
+        }
+
+        Ch Take() {
+            if (!ensure()) { return '\0'; }
+            m_tell++;
+            return (*m_current)[m_offset++];
+        }
+
+        size_t Tell() const { return m_tell; }
+
+        Ch* PutBegin() { return nullptr; }
+        void Put(Ch) {}
+        void Flush() {}
+        size_t PutEnd(Ch*) { return 0; }
+
+    private:
+
+        bool ensure() {
+            if (m_current && m_offset < m_current->size()) { return true; }
+            return advance();
+        }
+
+        /* Move to the next chunk, waiting for the producer if the
+         * stream is still open; false once a finished stream ran dry */
+        bool advance();
+
+        StreamedBuffer& m_source;
+        const std::vector<char>* m_current = nullptr;
+        size_t m_nextChunk = 0;
+        size_t m_offset = 0;
+        size_t m_tell = 0;
+    };
+
+private:
+
+    friend class Reader;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_condition;
+
+    // Chunks in arrival order; deque elements stay put when more are
+    // appended, so a Reader may hold a pointer into one without the lock
+    std::deque<std::vector<char>> m_chunks;
+    size_t m_size = 0;
+
+    bool m_done = false;
+    bool m_ok = false;
+};
+
+}
@@ -38,7 +38,12 @@ Topology getTopology(const JsonDocument& _document, const Transform& _proj) {
 
     topo.arcs.reserve(jsonArcs.Size());
 
-    // Decode and transform the points that make up 'arcs'
+    // Decode and transform the points that make up 'arcs'. Each arc is
+    // decoded exactly once here; geometries only copy slices of these
+    // pre-projected points. Splitting the JSON reads from the math keeps
+    // the delta+transform loop tight enough for the compiler to batch.
+    std::vector<glm::dvec2> positions;
+
     for (auto jsonArcsIt = jsonArcs.Begin(); jsonArcsIt != jsonArcs.End(); ++jsonArcsIt) {
 
         const auto& jsonArc = *jsonArcsIt;
@@ -47,8 +52,8 @@ Topology getTopology(const JsonDocument& _document, const Transform& _proj) {
             continue;
         }
 
-        Line arc;
-        arc.reserve(jsonArc.Size());
+        positions.clear();
+        positions.reserve(jsonArc.Size());
 
         // Quantized position
         glm::ivec2 q;
@@ -57,10 +62,32 @@ Topology getTopology(const JsonDocument& _document, const Transform& _proj) {
 
             const auto& jsonCoords = *jsonCoordsIt;
 
-            arc.push_back(getPoint(jsonCoords, topo, q));
+            if (!jsonCoords.IsArray() || jsonCoords.Size() < 2) {
+                positions.push_back(glm::dvec2(q));
+                continue;
+            }
+
+            q.x += jsonCoords[0].GetInt();
+            q.y += jsonCoords[1].GetInt();
+
+            positions.push_back(glm::dvec2(q));
         }
 
-        topo.arcs.push_back(arc);
+        // Batched dequantization, then one projection pass per arc
+        for (auto& pos : positions) {
+            pos = pos * topo.scale + topo.translate;
+        }
+
+        topo.proj(positions.data(), positions.size());
+
+        Line arc;
+        arc.reserve(positions.size());
+
+        for (const auto& pos : positions) {
+            arc.push_back(Point(pos.x, pos.y, 0));
+        }
+
+        topo.arcs.push_back(std::move(arc));
     }
 
     return topo;
@@ -75,7 +102,10 @@ Point getPoint(const JsonValue& _coordinates, const Topology& _topology, glm::iv
     _cursor.x += _coordinates[0].GetInt();
     _cursor.y += _coordinates[1].GetInt();
 
-    return _topology.proj(glm::dvec2(_cursor) * _topology.scale + _topology.translate);
+    glm::dvec2 position = glm::dvec2(_cursor) * _topology.scale + _topology.translate;
+    _topology.proj(&position, 1);
+
+    return Point(position.x, position.y, 0);
 
 }
 
@@ -87,6 +117,24 @@ Line getLine(const JsonValue& _arcs, const Topology& _topology) {
         return line;
     }
 
+    // Sum up referenced arc lengths first, so the points of each arc can
+    // then be appended with one bulk copy into pre-sized storage.
+    size_t numPoints = 0;
+
+    for (auto arcIt = _arcs.Begin(); arcIt != _arcs.End(); ++arcIt) {
+
+        auto index = arcIt->GetInt();
+        if (index < 0) { index = -1 - index; }
+
+        if (index < 0 || (std::vector<Line>::size_type)index >= _topology.arcs.size()) {
+            continue;
+        }
+
+        numPoints += _topology.arcs[index].size();
+    }
+
+    line.reserve(numPoints);
+
     for (auto arcIt = _arcs.Begin(); arcIt != _arcs.End(); ++arcIt) {
 
         auto index = arcIt->GetInt();
@@ -101,27 +149,19 @@ Line getLine(const JsonValue& _arcs, const Topology& _topology) {
         }
 
         const auto& arc = _topology.arcs[index];
-
-        auto begin = arc.begin();
-        auto end = arc.end();
-        size_t inc = 1;
-        if (reverse) {
-            begin = arc.end() - 1;
-            end = arc.begin() - 1;
-            inc = -inc;
-        }
+        if (arc.empty()) { continue; }
 
         // If a line is made from multiple arcs, the first position of an arc must
         // be equal to the last position of the previous arc. So when reconstructing
         // the geometry, the first position of each arc except the first may be dropped
-        if (arcIt != _arcs.Begin()) {
-            begin = begin + inc;
-        }
+        size_t skip = (arcIt != _arcs.Begin()) ? 1 : 0;
+        if (skip >= arc.size()) { continue; }
 
-        for (auto pointIt = begin; pointIt != end; pointIt += inc) {
-            line.push_back(*pointIt);
+        if (reverse) {
+            line.insert(line.end(), arc.rbegin() + skip, arc.rend());
+        } else {
+            line.insert(line.end(), arc.begin() + skip, arc.end());
         }
-
     }
 
     return line;
@@ -136,10 +176,11 @@ Polygon getPolygon(const JsonValue& _arcSets, const Topology& _topology) {
         return polygon;
     }
 
+    polygon.reserve(_arcSets.Size());
+
     for (auto arcSetIt = _arcSets.Begin(); arcSetIt != _arcSets.End(); ++arcSetIt) {
 
-        auto ring = getLine(*arcSetIt, _topology);
-        polygon.push_back(ring);
+        polygon.push_back(getLine(*arcSetIt, _topology));
 
     }
 
@@ -237,6 +278,8 @@ Layer getLayer(JsonValue::MemberIterator& _objectIt, const Topology& _topology,
         }
     }
 
+    layer.buildKeyBloom();
+
     return layer;
 
 }
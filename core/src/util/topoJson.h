@@ -9,7 +9,9 @@ namespace Tangram {
 
 namespace TopoJson {
 
-using Transform = std::function<Point(glm::dvec2 _lonLat)>;
+// Converts an array of lon/lat positions into tile-local coordinates in
+// one batched pass, writing the result in place
+using Transform = std::function<void(glm::dvec2* _lonLats, size_t _count)>;
 
 struct Topology {
     glm::dvec2 scale = { 1., 1. };
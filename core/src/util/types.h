@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <vector>
 
 namespace Tangram {
@@ -37,4 +38,16 @@ typedef std::vector<LngLat> Coordinates;
 
 typedef uint32_t MarkerID;
 
+// Lookup and eviction counters of one cache tier; counters accumulate
+// over the cache's lifetime, bytes reflect the current state.
+struct CacheStats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;
+    size_t bytes = 0;
+    // Largest usage the cache ever reached; compare against the
+    // configured budget to see whether the cache actually fills up
+    size_t highWaterBytes = 0;
+};
+
 }
@@ -3,11 +3,25 @@
 #include "log.h"
 #include "csscolorparser.hpp"
 
+#include <thread>
+
 #define MAP_DELIM '.'
 #define SEQ_DELIM '#'
 
 namespace Tangram {
 
+void releaseDocumentAsync(Node& node) {
+
+    if (!node.IsDefined()) { return; }
+
+    // The copied node shares the document memory; once the caller's
+    // reference is reset below, the worker holds the last one (unless the
+    // document is shared elsewhere) and the whole node pool is freed there.
+    std::thread([doc = node]() {}).detach();
+
+    node.reset();
+}
+
 YamlPath YamlPathBuffer::toYamlPath() {
     size_t length = 0;
 
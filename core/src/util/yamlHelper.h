@@ -53,6 +53,14 @@ inline T parseVec(const Node& node) {
     return vec;
 }
 
+// Detach the given root node from its caller and destroy the document on a
+// worker thread. A large scene document frees hundreds of thousands of
+// individually allocated yaml-cpp nodes on teardown; releasing it as one
+// operation off the calling thread keeps scene swaps from stalling on it.
+// No-op for undefined nodes. Other holders of the same document are
+// unaffected; the worker only drops this reference.
+void releaseDocumentAsync(Node& node);
+
 glm::vec4 getColorAsVec4(const Node& node);
 
 std::string parseSequence(const Node& node);
@@ -5,9 +5,11 @@
 #include "util/rasterize.h"
 #include "scene/stops.h"
 #include "glm/gtc/matrix_transform.hpp"
+#include "glm/gtx/norm.hpp"
 #include "glm/gtx/rotate_vector.hpp"
 #include "log.h"
 
+#include <algorithm>
 #include <cmath>
 
 #define MAX_LOD 6
@@ -69,10 +71,19 @@ void View::setCameraType(CameraType _type) {
 
 ViewState View::state() const {
 
+    // Look ahead a fraction of a second along the current pan velocity,
+    // so tiles about to enter the view are built before the center ones
+    // that are about to leave it.
+    const double lookAheadSeconds = 0.35;
+
+    glm::dvec2 predicted(m_pos.x + m_panVelocity.x * lookAheadSeconds,
+                         -(m_pos.y + m_panVelocity.y * lookAheadSeconds));
+
     return {
         m_projection.get(),
         m_changed,
         glm::dvec2(m_pos.x, -m_pos.y),
+        predicted,
         m_zoom,
         powf(2.f, m_zoom),
         m_zoom - std::floor(m_zoom),
@@ -258,6 +269,8 @@ void View::update(bool _constrainToWorldBounds) {
 
     }
 
+    if (m_changed) { m_generation++; }
+
 }
 
 glm::dmat2 View::getBoundsRect() const {
@@ -434,11 +447,38 @@ glm::vec2 View::lonLatToScreenPosition(double lon, double lat, bool& clipped) co
     return screenPosition;
 }
 
+void View::setPredictedPosition(double _x, double _y) {
+    m_predictedPos = { _x, _y };
+    m_hasPredictedPos = true;
+    m_dirtyTiles = true;
+}
+
 void View::updateTiles() {
 
+    // Keep the previous visible set to detect whether this update
+    // actually entered or exited any tiles; the buffers are swapped so
+    // both keep their capacity across frames.
+    std::swap(m_visibleTiles, m_lastVisibleTiles);
     m_visibleTiles.clear();
+    m_visibleTilesChanged = false;
 
     int zoom = int(m_zoom);
+
+    // Hysteresis across integer zoom boundaries: while the zoom stays
+    // within the window around the boundary it last crossed, keep
+    // tiling at the level already built instead of loading the adjacent
+    // one, so pinching or speed-based auto-zoom hovering at e.g. z15.0
+    // does not discard and rebuild both levels repeatedly. Moving past
+    // the window, or by more than one level, switches as before.
+    if (zoom != m_tileZoom && m_tileZoom >= 0) {
+        if (zoom == m_tileZoom + 1 && m_zoom < zoom + m_zoomHysteresis) {
+            zoom = m_tileZoom;
+        } else if (zoom == m_tileZoom - 1 && m_zoom > m_tileZoom - m_zoomHysteresis) {
+            zoom = m_tileZoom;
+        }
+    }
+    m_tileZoom = zoom;
+
     int maxTileIndex = 1 << zoom;
 
     // Bounds of view trapezoid in world space (i.e. view frustum projected onto z = 0 plane)
@@ -454,6 +494,8 @@ void View::updateTiles() {
 
     // if all of our raycasts have a negative intersection distance, we have no area to cover
     if (t0 < .0 && t1 < 0. && t2 < 0. && t3 < 0.) {
+        m_visibleTilesChanged = !m_lastVisibleTiles.empty();
+        m_predictedTiles.clear();
         return;
     }
 
@@ -478,10 +520,10 @@ void View::updateTiles() {
     // Scan options - avoid heap allocation for std::function
     // [1] http://www.drdobbs.com/cpp/efficient-use-of-lambda-expressions-and/232500059?pgno=2
     struct ScanParams {
-        ScanParams(std::set<TileID>& _tiles, int _zoom)
+        ScanParams(std::vector<TileID>& _tiles, int _zoom)
             : tiles(_tiles), zoom(_zoom) {}
 
-        std::set<TileID>& tiles;
+        std::vector<TileID>& tiles;
         int zoom;
         int maxZoom = int(s_maxZoom);
 
@@ -515,7 +557,7 @@ void View::updateTiles() {
         }
     }
 
-    Rasterize::ScanCallback s = [&opt](int x, int y) {
+    auto scanTile = [](ScanParams& opt, int x, int y) {
 
         int lod = 0;
         while (lod < MAX_LOD && x >= opt.x_limit_pos[lod]) { lod++; }
@@ -535,11 +577,13 @@ void View::updateTiles() {
         tile.w = (x - tile.x) >> opt.zoom; // wrap
 
         if (tile != opt.last) {
-            opt.tiles.emplace(tile.x, tile.y, tile.z, tile.z, tile.w);
+            opt.tiles.emplace_back(tile.x, tile.y, tile.z, tile.z, tile.w);
             opt.last = tile;
         }
     };
 
+    Rasterize::ScanCallback s = [&](int x, int y) { scanTile(opt, x, y); };
+
     // Rasterize view trapezoid into tiles
     Rasterize::scanTriangle(a, b, c, 0, maxTileIndex, s);
     Rasterize::scanTriangle(c, d, a, 0, maxTileIndex, s);
@@ -549,6 +593,64 @@ void View::updateTiles() {
     // (which should remain visible, even though the base of the tile is not).
     Rasterize::scanTriangle(a, b, e, 0, maxTileIndex, s);
 
+    // The scans emit tiles in row order with only adjacent duplicates
+    // filtered; one sort of the reused vector replaces the per-tile tree
+    // inserts of a std::set.
+    std::sort(m_visibleTiles.begin(), m_visibleTiles.end());
+    m_visibleTiles.erase(std::unique(m_visibleTiles.begin(), m_visibleTiles.end()),
+                         m_visibleTiles.end());
+
+    m_visibleTilesChanged = (m_visibleTiles != m_lastVisibleTiles);
+
+    // Scan the trapezoid once more at the position the view is heading to,
+    // so tiles there can start loading before the view arrives: the fling
+    // resting point extrapolated from the pan velocity, or the destination
+    // of an eased transition, whichever is further out.
+    m_predictedTiles.clear();
+
+    // InputHandler damps the pan velocity with a decay of 4/s, so the
+    // total distance a fling still has to cover is velocity / 4.
+    const double flingRestSeconds = 0.25;
+    glm::dvec2 offset = glm::dvec2(m_panVelocity) * flingRestSeconds;
+
+    if (m_hasPredictedPos) {
+        glm::dvec2 easeOffset = m_predictedPos - glm::dvec2(m_pos.x, m_pos.y);
+        if (glm::length2(easeOffset) > glm::length2(offset)) { offset = easeOffset; }
+    }
+
+    // Offset of the predicted view in tile space; skip the extra scan when
+    // the prediction stays within a fraction of a tile.
+    glm::dvec2 doff = offset * tileSpaceAxes;
+
+    if (std::abs(doff.x) > 0.25 || std::abs(doff.y) > 0.25) {
+
+        ScanParams predicted{ m_predictedTiles, zoom };
+        predicted.maxZoom = opt.maxZoom;
+        std::copy(std::begin(opt.x_limit_pos), std::end(opt.x_limit_pos), predicted.x_limit_pos);
+        std::copy(std::begin(opt.x_limit_neg), std::end(opt.x_limit_neg), predicted.x_limit_neg);
+        std::copy(std::begin(opt.y_limit_pos), std::end(opt.y_limit_pos), predicted.y_limit_pos);
+        std::copy(std::begin(opt.y_limit_neg), std::end(opt.y_limit_neg), predicted.y_limit_neg);
+
+        Rasterize::ScanCallback sp = [&](int x, int y) { scanTile(predicted, x, y); };
+
+        Rasterize::scanTriangle(a + doff, b + doff, c + doff, 0, maxTileIndex, sp);
+        Rasterize::scanTriangle(c + doff, d + doff, a + doff, 0, maxTileIndex, sp);
+        Rasterize::scanTriangle(a + doff, b + doff, e + doff, 0, maxTileIndex, sp);
+
+        std::sort(m_predictedTiles.begin(), m_predictedTiles.end());
+        m_predictedTiles.erase(std::unique(m_predictedTiles.begin(), m_predictedTiles.end()),
+                               m_predictedTiles.end());
+
+        // Already loading at regular priority.
+        m_predictedTiles.erase(
+            std::remove_if(m_predictedTiles.begin(), m_predictedTiles.end(),
+                           [&](const TileID& id) {
+                               return std::binary_search(m_visibleTiles.begin(),
+                                                         m_visibleTiles.end(), id);
+                           }),
+            m_predictedTiles.end());
+    }
+
     m_dirtyTiles = false;
 
 }
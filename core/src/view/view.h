@@ -8,8 +8,8 @@
 #include "util/mapProjection.h"
 #include "view/viewConstraint.h"
 
-#include <set>
 #include <memory>
+#include <vector>
 
 namespace Tangram {
 
@@ -25,6 +25,9 @@ struct ViewState {
     const MapProjection* mapProjection;
     bool changedOnLastUpdate;
     glm::dvec2 center;
+    // View center extrapolated along the current pan velocity; used to
+    // prioritize tile loads towards where the view is heading.
+    glm::dvec2 predictedCenter;
     float zoom;
     double zoomScale;
     float fractZoom;
@@ -116,9 +119,19 @@ public:
     /* Moves the position of the view */
     void translate(double _dx, double _dy);
 
+    /* Sets the current pan velocity (in projection units per second), used to
+     * extrapolate the view center for tile load prioritization */
+    void setPanVelocity(glm::vec2 _velocity) { m_panVelocity = _velocity; }
+
     /* Changes zoom by the given amount */
     void zoom(float _dz);
 
+    /* Sets the fractional zoom window within which crossing an integer
+     * zoom boundary keeps tiling at the previous level, so a zoom
+     * hovering around a boundary does not rebuild both levels over and
+     * over; 0 switches levels exactly at the boundary again */
+    void setZoomHysteresis(float _fraction) { m_zoomHysteresis = _fraction; m_dirtyTiles = true; }
+
     /* Changes the roll angle by the given amount in radians */
     void roll(float _drad);
 
@@ -181,12 +194,33 @@ public:
     /* Gets the screen position from a latitude/longitude */
     glm::vec2 lonLatToScreenPosition(double lon, double lat, bool& clipped) const;
 
-    /* Returns the set of all tiles visible at the current position and zoom */
-    const std::set<TileID>& getVisibleTiles() { return m_visibleTiles; }
+    /* Returns all tiles visible at the current position and zoom, as a
+     * sorted vector without duplicates */
+    const std::vector<TileID>& getVisibleTiles() { return m_visibleTiles; }
+
+    /* Returns true if the visible tile set differs from the one of the
+     * previous update; false when the view only moved within the same tiles */
+    bool visibleTilesChanged() const { return m_visibleTilesChanged; }
+
+    /* Returns tiles (sorted, unique, not currently visible) that the view
+     * is predicted to reach - along the current fling or at an eased
+     * transition's destination - for prefetching ahead of arrival */
+    const std::vector<TileID>& getPredictedTiles() { return m_predictedTiles; }
+
+    /* Sets the world-space position an eased transition is heading to, so
+     * updateTiles can prefetch tiles there before the view arrives */
+    void setPredictedPosition(double _x, double _y);
+
+    void clearPredictedPosition() { m_hasPredictedPos = false; }
 
     /* Returns true if the view properties have changed since the last call to update() */
     bool changedOnLastUpdate() const { return m_changed; }
 
+    /* Monotonic counter bumped by every update() that changed the view;
+     * derived per-view data (e.g. tile matrices) can be cached against
+     * it and recomputed only when the number moves */
+    int64_t generation() const { return m_generation; }
+
     /* TODO: API for setting these */
     constexpr static float s_maxZoom = 20.5;
     constexpr static float s_minZoom = 0.0;
@@ -208,11 +242,23 @@ protected:
     std::shared_ptr<MapProjection> m_projection;
     std::shared_ptr<Stops> m_fovStops;
     std::shared_ptr<Stops> m_maxPitchStops;
-    std::set<TileID> m_visibleTiles;
+    // Visible tiles of the last update and the update before it; kept
+    // sorted and reused across updates so a pan does not reallocate or
+    // tree-insert per tile and per frame.
+    std::vector<TileID> m_visibleTiles;
+    std::vector<TileID> m_lastVisibleTiles;
+    bool m_visibleTilesChanged = false;
+
+    // Tiles at the predicted view position, excluding visible ones;
+    // consumed by the tile manager as prefetch candidates.
+    std::vector<TileID> m_predictedTiles;
+    glm::dvec2 m_predictedPos = { 0.0, 0.0 };
+    bool m_hasPredictedPos = false;
 
     ViewConstraint m_constraint;
 
     glm::dvec3 m_pos;
+    glm::vec2 m_panVelocity = { 0.f, 0.f };
     glm::vec3 m_eye;
     glm::vec2 m_obliqueAxis;
     glm::vec2 m_vanishingPoint;
@@ -230,6 +276,11 @@ protected:
 
     float m_zoom = 0.f;
 
+    // Integer zoom the visible tile set was last generated at; held
+    // within m_zoomHysteresis of a level boundary.
+    int m_tileZoom = -1;
+    float m_zoomHysteresis = 0.1f;
+
     float m_width;
     float m_height;
 
@@ -246,6 +297,8 @@ protected:
     bool m_dirtyTiles;
     bool m_changed;
 
+    int64_t m_generation = 1;
+
 };
 
 }
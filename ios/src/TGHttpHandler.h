@@ -8,7 +8,9 @@
 
 #import <Foundation/Foundation.h>
 
-typedef void(^DownloadCompletionHandler)(NSData*, NSURLResponse*, NSError*);
+typedef void(^DownloadResponseHandler)(NSURLResponse*);
+typedef void(^DownloadChunkHandler)(NSData*);
+typedef void(^DownloadCompletionHandler)(NSURLResponse*, NSError*);
 
 @interface TGHttpHandler : NSObject
 
@@ -16,7 +18,10 @@ typedef void(^DownloadCompletionHandler)(NSData*, NSURLResponse*, NSError*);
 
 - (instancetype)initWithCachePath:(NSString*)cachePath cacheMemoryCapacity:(NSUInteger)memoryCapacity cacheDiskCapacity:(NSUInteger)diskCapacity;
 
-- (void)downloadRequestAsync:(NSString*)url completionHandler:(DownloadCompletionHandler)completionHandler;
+/* Starts a download whose body is delivered through chunkHandler as it
+ * arrives, after responseHandler has seen the response headers; the
+ * completion handler fires once, after the last chunk or on failure. */
+- (void)downloadRequestAsync:(NSString*)url responseHandler:(DownloadResponseHandler)responseHandler chunkHandler:(DownloadChunkHandler)chunkHandler completionHandler:(DownloadCompletionHandler)completionHandler;
 
 - (void)cancelDownloadRequestAsync:(NSString*)url;
 
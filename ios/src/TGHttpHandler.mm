@@ -8,13 +8,31 @@
 
 #import "TGHttpHandler.h"
 
-@interface TGHttpHandler()
+/* Handler blocks for one in-flight download, keyed by task identifier on
+ * the session delegate. Responses stream through these as they arrive, so
+ * request buffers fill chunk by chunk instead of the session accumulating
+ * the body in NSData for a completion handler to copy out afterwards. */
+@interface TGStreamingDownload : NSObject
+
+@property (copy, nonatomic) DownloadResponseHandler responseHandler;
+@property (copy, nonatomic) DownloadChunkHandler chunkHandler;
+@property (copy, nonatomic) DownloadCompletionHandler completionHandler;
+
+@end
+
+@implementation TGStreamingDownload
+@end
+
+@interface TGHttpHandler() <NSURLSessionDataDelegate>
 
 @property (strong, nonatomic) NSURLSession* session;
 @property (strong, nonatomic) NSURLSessionConfiguration* configuration;
+@property (strong, nonatomic) NSMutableDictionary* downloads;
 
 + (NSURLSessionConfiguration*)defaultConfiguration;
 
+- (void)createSession;
+
 @end
 
 @implementation TGHttpHandler
@@ -25,7 +43,7 @@
 
     if (self) {
         self.configuration = [TGHttpHandler defaultSessionConfiguration];
-        self.session = [NSURLSession sessionWithConfiguration:self.configuration];
+        [self createSession];
     }
 
     return self;
@@ -38,12 +56,24 @@
     if (self) {
         self.configuration = [TGHttpHandler defaultSessionConfiguration];
         [self setCachePath:cachePath cacheMemoryCapacity:memoryCapacity cacheDiskCapacity:diskCapacity];
-        self.session = [NSURLSession sessionWithConfiguration:self.configuration];
+        [self createSession];
     }
 
     return self;
 }
 
+- (void)createSession
+{
+    self.downloads = [[NSMutableDictionary alloc] init];
+
+    NSOperationQueue* delegateQueue = [[NSOperationQueue alloc] init];
+    delegateQueue.maxConcurrentOperationCount = 1;
+
+    self.session = [NSURLSession sessionWithConfiguration:self.configuration
+                                                 delegate:self
+                                            delegateQueue:delegateQueue];
+}
+
 + (NSURLSessionConfiguration*)defaultSessionConfiguration
 {
     NSURLSessionConfiguration* sessionConfiguration = [NSURLSessionConfiguration defaultSessionConfiguration];
@@ -64,14 +94,53 @@
     self.configuration.requestCachePolicy = NSURLRequestUseProtocolCachePolicy;
 }
 
-- (void)downloadRequestAsync:(NSString*)url completionHandler:(DownloadCompletionHandler)completionHandler
+- (void)downloadRequestAsync:(NSString*)url responseHandler:(DownloadResponseHandler)responseHandler chunkHandler:(DownloadChunkHandler)chunkHandler completionHandler:(DownloadCompletionHandler)completionHandler
 {
-    NSURLSessionDataTask* dataTask = [self.session dataTaskWithURL:[NSURL URLWithString:url]
-                                                                      completionHandler:completionHandler];
+    TGStreamingDownload* download = [[TGStreamingDownload alloc] init];
+    download.responseHandler = responseHandler;
+    download.chunkHandler = chunkHandler;
+    download.completionHandler = completionHandler;
+
+    NSURLSessionDataTask* dataTask = [self.session dataTaskWithURL:[NSURL URLWithString:url]];
+
+    @synchronized (self.downloads) {
+        [self.downloads setObject:download forKey:@(dataTask.taskIdentifier)];
+    }
 
     [dataTask resume];
 }
 
+- (TGStreamingDownload*)downloadForTask:(NSURLSessionTask*)task
+{
+    @synchronized (self.downloads) {
+        return [self.downloads objectForKey:@(task.taskIdentifier)];
+    }
+}
+
+- (void)URLSession:(NSURLSession*)session dataTask:(NSURLSessionDataTask*)dataTask didReceiveResponse:(NSURLResponse*)response completionHandler:(void (^)(NSURLSessionResponseDisposition))completionHandler
+{
+    TGStreamingDownload* download = [self downloadForTask:dataTask];
+    if (download.responseHandler) { download.responseHandler(response); }
+    completionHandler(NSURLSessionResponseAllow);
+}
+
+- (void)URLSession:(NSURLSession*)session dataTask:(NSURLSessionDataTask*)dataTask didReceiveData:(NSData*)data
+{
+    TGStreamingDownload* download = [self downloadForTask:dataTask];
+    if (download.chunkHandler) { download.chunkHandler(data); }
+}
+
+- (void)URLSession:(NSURLSession*)session task:(NSURLSessionTask*)task didCompleteWithError:(NSError*)error
+{
+    TGStreamingDownload* download = [self downloadForTask:task];
+
+    @synchronized (self.downloads) {
+        [self.downloads removeObjectForKey:@(task.taskIdentifier)];
+    }
+
+    if (download.completionHandler) { download.completionHandler(task.response, error); }
+}
+
 - (void)cancelDownloadRequestAsync:(NSString*)url
 {
     [self.session getTasksWithCompletionHandler:^(NSArray* dataTasks, NSArray* uploadTasks, NSArray* downloadTasks) {
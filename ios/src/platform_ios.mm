@@ -252,38 +252,110 @@ bool startUrlRequest(const std::string& _url, UrlCallback _callback) {
         return false;
     }
 
-    DownloadCompletionHandler handler = ^void (NSData* data, NSURLResponse* response, NSError* error) {
+    // The body streams into this buffer chunk by chunk, sized up front from
+    // Content-Length, instead of the session accumulating NSData that would
+    // have to be copied out whole on completion.
+    auto content = std::make_shared<std::vector<char>>();
 
-        NSHTTPURLResponse* httpResponse = (NSHTTPURLResponse*)response;
+    NSString* url = [NSString stringWithUTF8String:_url.c_str()];
+    [httpHandler downloadRequestAsync:url
+        responseHandler:^void (NSURLResponse* response) {
 
-        int statusCode = [httpResponse statusCode];
+            long long length = [response expectedContentLength];
+            if (length > 0) { content->reserve(length); }
 
-        std::vector<char> rawDataVec;
+        }
+        chunkHandler:^void (NSData* data) {
 
-        if (error != nil) {
+            [data enumerateByteRangesUsingBlock:^(const void* bytes, NSRange byteRange, BOOL* stop) {
+                const char* begin = static_cast<const char*>(bytes);
+                content->insert(content->end(), begin, begin + byteRange.length);
+            }];
 
-            LOGE("Response \"%s\" with error \"%s\".", response, [error.localizedDescription UTF8String]);
+        }
+        completionHandler:^void (NSURLResponse* response, NSError* error) {
 
-        } else if (statusCode < 200 || statusCode >= 300) {
+            NSHTTPURLResponse* httpResponse = (NSHTTPURLResponse*)response;
 
-            LOGE("Unsuccessful status code %d: \"%s\" from: %s",
-                statusCode,
-                [[NSHTTPURLResponse localizedStringForStatusCode: statusCode] UTF8String],
-                [response.URL.absoluteString UTF8String]);
-            _callback(std::move(rawDataVec));
+            int statusCode = [httpResponse statusCode];
 
-        } else {
+            if (error != nil) {
 
-            int dataLength = [data length];
-            rawDataVec.resize(dataLength);
-            memcpy(rawDataVec.data(), (char *)[data bytes], dataLength);
-            _callback(std::move(rawDataVec));
+                LOGE("Response \"%s\" with error \"%s\".", response, [error.localizedDescription UTF8String]);
 
-        }
-    };
+            } else if (statusCode < 200 || statusCode >= 300) {
+
+                LOGE("Unsuccessful status code %d: \"%s\" from: %s",
+                    statusCode,
+                    [[NSHTTPURLResponse localizedStringForStatusCode: statusCode] UTF8String],
+                    [response.URL.absoluteString UTF8String]);
+                _callback({});
+
+            } else {
+
+                _callback(std::move(*content));
+
+            }
+        }];
+
+    return true;
+}
+
+bool startUrlRequest(const std::string& _url, const UrlValidators& _validators,
+                     UrlRevalidateCallback _callback) {
+
+    // TGHttpHandler has no request-header support; fetch in full and
+    // report no validators.
+    return startUrlRequest(_url,
+            [callback = std::move(_callback)](std::vector<char>&& _data) mutable {
+                callback(std::move(_data), UrlValidators{}, false);
+            });
+}
+
+bool startUrlRequestStream(const std::string& _url, UrlChunkCallback _chunk,
+                           UrlStreamFinishCallback _finish) {
+
+    TGHttpHandler* httpHandler = [viewController httpHandler];
+
+    if (!httpHandler) {
+        return false;
+    }
+
+    // Chunks feed the consumer as they arrive, gated on a successful status
+    // so an error page is never handed to the parser.
+    auto accept = std::make_shared<bool>(false);
 
     NSString* url = [NSString stringWithUTF8String:_url.c_str()];
-    [httpHandler downloadRequestAsync:url completionHandler:handler];
+    [httpHandler downloadRequestAsync:url
+        responseHandler:^void (NSURLResponse* response) {
+
+            int statusCode = [(NSHTTPURLResponse*)response statusCode];
+            *accept = statusCode >= 200 && statusCode < 300;
+
+        }
+        chunkHandler:^void (NSData* data) {
+
+            if (!*accept) { return; }
+            [data enumerateByteRangesUsingBlock:^(const void* bytes, NSRange byteRange, BOOL* stop) {
+                _chunk(static_cast<const char*>(bytes), byteRange.length);
+            }];
+
+        }
+        completionHandler:^void (NSURLResponse* response, NSError* error) {
+
+            if (error != nil) {
+                LOGE("Response \"%s\" with error \"%s\".", response, [error.localizedDescription UTF8String]);
+            } else if (!*accept) {
+                NSHTTPURLResponse* httpResponse = (NSHTTPURLResponse*)response;
+                int statusCode = [httpResponse statusCode];
+                LOGE("Unsuccessful status code %d: \"%s\" from: %s",
+                    statusCode,
+                    [[NSHTTPURLResponse localizedStringForStatusCode: statusCode] UTF8String],
+                    [response.URL.absoluteString UTF8String]);
+            }
+
+            _finish(error == nil && *accept, UrlValidators{});
+        }];
 
     return true;
 }
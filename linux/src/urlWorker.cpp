@@ -1,84 +1,294 @@
 #include "urlWorker.h"
 #include "log.h"
 
-static size_t write_data(void *_buffer, size_t _size, size_t _nmemb, void *_dataPtr) {
+#include <algorithm>
+#include <cctype>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+// A few shared connections are enough once streams multiplex over them;
+// HTTP/1 servers still get one transfer per connection.
+#define MAX_HOST_CONNECTIONS 4L
+
+static size_t write_data(void* _buffer, size_t _size, size_t _nmemb, void* _dataPtr) {
 
     const size_t realSize = _size * _nmemb;
 
-    std::stringstream* stream = (std::stringstream*)_dataPtr;
+    UrlTask* task = (UrlTask*)_dataPtr;
 
-    stream->write((const char*)_buffer, realSize);
+    if (task->chunk) {
+        // Streamed request: hand the bytes on while the transfer runs
+        task->chunk((const char*)_buffer, realSize);
+    } else {
+        task->content.insert(task->content.end(),
+                             (char*)_buffer, (char*)_buffer + realSize);
+    }
 
     return realSize;
 }
 
-UrlWorker::UrlWorker() {
-    m_curlHandle = curl_easy_init();
+static size_t header_data(char* _buffer, size_t _size, size_t _nitems, void* _dataPtr) {
+
+    const size_t realSize = _size * _nitems;
+
+    UrlValidators* validators = (UrlValidators*)_dataPtr;
+
+    const char* colon = (const char*)memchr(_buffer, ':', realSize);
+    if (colon) {
+        std::string name(_buffer, colon - _buffer);
+        std::transform(name.begin(), name.end(), name.begin(),
+                       [](char c) { return std::tolower(c); });
+
+        std::string value(colon + 1, _buffer + realSize);
+        value.erase(0, value.find_first_not_of(" \t"));
+        value.erase(value.find_last_not_of(" \t\r\n") + 1);
+
+        if (name == "etag") {
+            validators->etag = value;
+        } else if (name == "last-modified") {
+            validators->lastModified = value;
+        }
+    }
+
+    return realSize;
 }
 
-UrlWorker::~UrlWorker() {
-    // wait for thread to finish
-    if (m_future.valid()) { m_future.get(); }
+UrlSession::UrlSession() {
+    curl_global_init(CURL_GLOBAL_DEFAULT);
 
-    curl_easy_cleanup(m_curlHandle);
+    if (pipe2(m_wakeFds, O_NONBLOCK | O_CLOEXEC) != 0) {
+        // Without the pipe the session falls back to the wait timeout.
+        m_wakeFds[0] = m_wakeFds[1] = -1;
+    }
 }
 
-void UrlWorker::perform(std::unique_ptr<UrlTask> _task) {
+UrlSession::~UrlSession() {
+    stop();
+    if (m_wakeFds[0] >= 0) {
+        close(m_wakeFds[0]);
+        close(m_wakeFds[1]);
+    }
+    curl_global_cleanup();
+}
 
-    m_task = std::move(_task);
+void UrlSession::wake() {
+    if (m_wakeFds[1] < 0) { return; }
 
-    m_future = std::async(std::launch::async, [&]() {
+    // A full pipe means the thread has wakeups queued already.
+    char byte = 0;
+    ssize_t unused = write(m_wakeFds[1], &byte, 1);
+    (void)unused;
+}
 
-        // set up curl to perform fetch
-        curl_easy_setopt(m_curlHandle, CURLOPT_WRITEFUNCTION, write_data);
-        curl_easy_setopt(m_curlHandle, CURLOPT_WRITEDATA, &m_stream);
-        curl_easy_setopt(m_curlHandle, CURLOPT_URL, m_task->url.c_str());
-        curl_easy_setopt(m_curlHandle, CURLOPT_HEADER, 0L);
-        curl_easy_setopt(m_curlHandle, CURLOPT_VERBOSE, 0L);
-        curl_easy_setopt(m_curlHandle, CURLOPT_ACCEPT_ENCODING, "gzip");
+void UrlSession::enqueue(std::unique_ptr<UrlTask> _task) {
 
-        LOGD("Fetching URL: %s", m_task->url.c_str());
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_running) { return; }
 
-        // Reset stream
-        m_stream.seekp(0);
+    m_pending.push_back(std::move(_task));
 
-        CURLcode result = curl_easy_perform(m_curlHandle);
+    if (!m_thread.joinable()) {
+        m_thread = std::thread(&UrlSession::run, this);
+    } else {
+        wake();
+    }
+}
 
-        long httpStatusCode = 0;
-        curl_easy_getinfo(m_curlHandle, CURLINFO_RESPONSE_CODE, &httpStatusCode);
+void UrlSession::cancel(const std::string& _url) {
 
-        if (result == CURLE_OK && httpStatusCode == 200) {
-            size_t nBytes = m_stream.tellp();
-            m_stream.seekp(0);
+    std::lock_guard<std::mutex> lock(m_mutex);
 
-            m_task->content.resize(nBytes);
-            m_stream.seekg(0);
-            m_stream.read(m_task->content.data(), nBytes);
-        } else {
-            LOGE("curl_easy_perform failed: %s - %d",
-                 curl_easy_strerror(result), httpStatusCode);
+    for (auto it = m_pending.begin(); it != m_pending.end(); ++it) {
+        if ((*it)->url == _url) {
+            m_pending.erase(it);
+            return;
         }
+    }
+    // Not pending; let the session thread drop the active transfer
+    m_canceled.push_back(_url);
+    wake();
+}
+
+void UrlSession::stop() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_running = false;
+        m_pending.clear();
+    }
+    wake();
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
 
-        m_task->callback(std::move(m_task->content));
-        m_task.reset();
+void UrlSession::run() {
 
-        // Run processNetworkQueue() for pending tasks
-        requestRender();
+    m_multiHandle = curl_multi_init();
 
-        return true;
-    });
+    // Let concurrent transfers to one host share its connections as
+    // HTTP/2 streams instead of waiting for a worker slot.
+    curl_multi_setopt(m_multiHandle, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+    curl_multi_setopt(m_multiHandle, CURLMOPT_MAX_HOST_CONNECTIONS, MAX_HOST_CONNECTIONS);
+
+    while (true) {
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            if (!m_running && m_active.empty()) { break; }
+
+            while (!m_pending.empty()) {
+                auto task = std::move(m_pending.front());
+                m_pending.pop_front();
+                startTask(std::move(task));
+            }
+            for (auto& url : m_canceled) {
+                dropTask(url);
+            }
+            m_canceled.clear();
+        }
+
+        int activeTransfers = 0;
+        curl_multi_perform(m_multiHandle, &activeTransfers);
+
+        int msgsLeft = 0;
+        while (CURLMsg* msg = curl_multi_info_read(m_multiHandle, &msgsLeft)) {
+            if (msg->msg == CURLMSG_DONE) {
+                finishTask(msg->easy_handle, msg->data.result);
+            }
+        }
+
+        // Wake on transfer activity or on the self-pipe, which enqueue,
+        // cancel and stop write to; the timeout only backstops the rare
+        // setup where the pipe could not be created.
+        struct curl_waitfd wakefd = {};
+        wakefd.fd = m_wakeFds[0];
+        wakefd.events = CURL_WAIT_POLLIN;
+
+        int numfds = 0;
+        curl_multi_wait(m_multiHandle, &wakefd, m_wakeFds[0] >= 0 ? 1 : 0,
+                        100, &numfds);
+
+        if (m_wakeFds[0] >= 0) {
+            // Coalesce any number of wakeups; the loop re-checks the
+            // lists at its top.
+            char buffer[64];
+            while (read(m_wakeFds[0], buffer, sizeof(buffer)) > 0) {}
+        }
+    }
+
+    curl_multi_cleanup(m_multiHandle);
+    m_multiHandle = nullptr;
 }
 
-void UrlWorker::reset() {
-    m_task.reset();
+void UrlSession::startTask(std::unique_ptr<UrlTask> _task) {
+
+    CURL* handle = curl_easy_init();
+    _task->handle = handle;
+
+    curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, write_data);
+    curl_easy_setopt(handle, CURLOPT_WRITEDATA, _task.get());
+    curl_easy_setopt(handle, CURLOPT_URL, _task->url.c_str());
+    curl_easy_setopt(handle, CURLOPT_HEADER, 0L);
+    curl_easy_setopt(handle, CURLOPT_VERBOSE, 0L);
+    curl_easy_setopt(handle, CURLOPT_ACCEPT_ENCODING, "gzip");
+    if (_task->rawBody) {
+        // Still advertise gzip, but skip curl's inline inflate: it runs
+        // in the write callback on the session thread and would stall
+        // every other transfer behind a large tile's decompression.
+        curl_easy_setopt(handle, CURLOPT_HTTP_CONTENT_DECODING, 0L);
+    }
+    curl_easy_setopt(handle, CURLOPT_PRIVATE, _task.get());
+    curl_easy_setopt(handle, CURLOPT_HEADERFUNCTION, header_data);
+    curl_easy_setopt(handle, CURLOPT_HEADERDATA, &_task->validators);
+
+    // Revalidate the cached copy instead of downloading it again when
+    // the caller knows what it holds; the server answers 304 if the
+    // resource is unchanged.
+    if (!_task->sendValidators.empty()) {
+        struct curl_slist* headers = nullptr;
+        if (!_task->sendValidators.etag.empty()) {
+            headers = curl_slist_append(headers,
+                    ("If-None-Match: " + _task->sendValidators.etag).c_str());
+        }
+        if (!_task->sendValidators.lastModified.empty()) {
+            headers = curl_slist_append(headers,
+                    ("If-Modified-Since: " + _task->sendValidators.lastModified).c_str());
+        }
+        curl_easy_setopt(handle, CURLOPT_HTTPHEADER, headers);
+        _task->requestHeaders = headers;
+    }
+
+#if LIBCURL_VERSION_NUM >= 0x072F00 // 7.47.0
+    // Negotiate HTTP/2 over TLS when the server offers it and prefer
+    // waiting for a multiplexed connection over opening another one.
+    curl_easy_setopt(handle, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2TLS);
+    curl_easy_setopt(handle, CURLOPT_PIPEWAIT, 1L);
+#endif
+
+    LOGD("Fetching URL: %s", _task->url.c_str());
+
+    curl_multi_add_handle(m_multiHandle, handle);
+
+    m_active.push_back(std::move(_task));
 }
 
-void UrlWorker::join() {
-    if (m_future.valid()) {
-        m_future.get();
+void UrlSession::finishTask(CURL* _handle, CURLcode _result) {
+
+    auto it = std::find_if(m_active.begin(), m_active.end(),
+                           [&](const auto& task) { return task->handle == _handle; });
+    if (it == m_active.end()) { return; }
+
+    auto task = std::move(*it);
+    m_active.erase(it);
+
+    long httpStatusCode = 0;
+    curl_easy_getinfo(_handle, CURLINFO_RESPONSE_CODE, &httpStatusCode);
+
+    curl_multi_remove_handle(m_multiHandle, _handle);
+    curl_easy_cleanup(_handle);
+    if (task->requestHeaders) {
+        curl_slist_free_all(task->requestHeaders);
+    }
+
+    bool notModified = (httpStatusCode == 304);
+
+    if (_result != CURLE_OK || (httpStatusCode != 200 && !notModified)) {
+        LOGE("curl transfer failed: %s - %d",
+             curl_easy_strerror(_result), httpStatusCode);
+        task->content.clear();
+
+        if (task->finish) {
+            task->finish(false, std::move(task->validators));
+            requestRender();
+            return;
+        }
+    }
+    if (notModified) { task->content.clear(); }
+
+    if (task->finish) {
+        // Streamed request: the body already went out through the chunk
+        // callback, only the outcome is left to deliver
+        task->finish(true, std::move(task->validators));
+    } else {
+        task->callback(std::move(task->content), std::move(task->validators), notModified);
     }
+
+    // Wake the main loop for the completed tile
+    requestRender();
 }
 
-bool UrlWorker::hasTask(const std::string& _url) {
-    return (m_task && m_task->url == _url);
+void UrlSession::dropTask(const std::string& _url) {
+
+    auto it = std::find_if(m_active.begin(), m_active.end(),
+                           [&](const auto& task) { return task->url == _url; });
+    if (it == m_active.end()) { return; }
+
+    curl_multi_remove_handle(m_multiHandle, (*it)->handle);
+    curl_easy_cleanup((*it)->handle);
+    if ((*it)->requestHeaders) {
+        curl_slist_free_all((*it)->requestHeaders);
+    }
+    m_active.erase(it);
 }
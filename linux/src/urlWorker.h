@@ -1,47 +1,101 @@
 #pragma once
 
-#include <future>
+#include <list>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
 #include <vector>
-#include <sstream>
 
 #include "platform.h"
 
 #include <curl/curl.h>
 
 struct UrlTask {
-    UrlCallback callback;
+    UrlRevalidateCallback callback;
+    // Set instead of callback for a streamed request: body data is
+    // forwarded chunk by chunk and never buffered in content
+    UrlChunkCallback chunk;
+    UrlStreamFinishCallback finish;
     const std::string url;
+    // Validators sent as conditional request headers, empty for a plain fetch
+    UrlValidators sendValidators;
+    // Validators of the response, filled by the header callback
+    UrlValidators validators;
     std::vector<char> content;
+    // Deliver the body without decoding its Content-Encoding, keeping
+    // the transfer thread I/O-only; the consumer inflates on a worker
+    bool rawBody = false;
+    CURL* handle = nullptr;
+    struct curl_slist* requestHeaders = nullptr;
 
-    UrlTask(UrlTask&& _other) : 
-        callback(std::move(_other.callback)),
-        url(std::move(_other.url)),
-        content(std::move(_other.content)) {
+    UrlTask(const std::string& _url, UrlRevalidateCallback _callback,
+            UrlValidators _validators = {}) :
+        callback(std::move(_callback)),
+        url(_url),
+        sendValidators(std::move(_validators)) {
     }
 
-    UrlTask(const std::string& _url, const UrlCallback& _callback) : 
-        callback(_callback),
+    UrlTask(const std::string& _url, UrlChunkCallback _chunk,
+            UrlStreamFinishCallback _finish) :
+        chunk(std::move(_chunk)),
+        finish(std::move(_finish)),
         url(_url) {
     }
 };
 
-class UrlWorker {
-    public:
-        void perform(std::unique_ptr<UrlTask> _task);
-        void reset();
-        bool isAvailable() { return !bool(m_task); }
-        bool hasTask(const std::string& _url);
-        void join();
+/* Drives all URL requests over one curl multi handle on a dedicated
+ * thread. Transfers negotiate HTTP/2 where the server offers it and are
+ * multiplexed over a few warm connections, so a viewport's worth of
+ * queued tile fetches does not pay connection setup and a full round
+ * trip per request. The thread is started on the first request and
+ * joined by stop().
+ */
+class UrlSession {
 
-        UrlWorker();
-        ~UrlWorker();
+public:
 
-    private:
-        std::unique_ptr<UrlTask> m_task;
-        std::stringstream m_stream;
-        CURL* m_curlHandle = nullptr;
+    UrlSession();
+    ~UrlSession();
 
-        std::future<bool> m_future;
-};
+    void enqueue(std::unique_ptr<UrlTask> _task);
+
+    /* Drop the pending or active request for _url, if any. Its callback
+     * is not invoked. */
+    void cancel(const std::string& _url);
+
+    /* Finish active transfers, drop pending ones and join the thread */
+    void stop();
+
+private:
+
+    void run();
+
+    /* Wake the session thread out of curl_multi_wait; called whenever
+     * another thread changes the pending or canceled lists so a fresh
+     * request is picked up immediately instead of on the next poll. */
+    void wake();
 
+    /* The functions below run on the session thread, which owns all
+     * curl handles after setup. */
+    void startTask(std::unique_ptr<UrlTask> _task);
+    void finishTask(CURL* _handle, CURLcode _result);
+    void dropTask(const std::string& _url);
+
+    CURLM* m_multiHandle = nullptr;
+
+    // Self-pipe registered with curl_multi_wait; wake() writes to [1]
+    // and the session thread drains [0]
+    int m_wakeFds[2] = {-1, -1};
+
+    std::thread m_thread;
+    std::mutex m_mutex;
+    bool m_running = true;
+
+    // Requests handed over by other threads, picked up each loop
+    std::list<std::unique_ptr<UrlTask>> m_pending;
+    std::list<std::string> m_canceled;
+
+    // Transfers currently added to the multi handle; session thread only
+    std::vector<std::unique_ptr<UrlTask>> m_active;
+};
@@ -28,6 +28,98 @@ static std::mutex s_urlRequestsMutex;
 
 NSURLSession* defaultSession;
 
+typedef void(^TGResponseReceived)(NSURLResponse* response);
+typedef void(^TGChunkReceived)(NSData* data);
+typedef void(^TGRequestCompleted)(NSURLResponse* response, NSError* error);
+
+// Handler blocks for one in-flight download, keyed by task identifier on
+// the session delegate. Responses stream through these as they arrive, so
+// request buffers fill chunk by chunk instead of the session accumulating
+// the body in NSData for a completion handler to copy out afterwards.
+@interface TGStreamingDownload : NSObject
+
+@property (copy, nonatomic) TGResponseReceived responseReceived;
+@property (copy, nonatomic) TGChunkReceived chunkReceived;
+@property (copy, nonatomic) TGRequestCompleted completed;
+
+@end
+
+@implementation TGStreamingDownload
+@end
+
+@interface TGUrlSessionDelegate : NSObject<NSURLSessionDataDelegate>
+// Accessed only on the session's serial delegate queue.
+@property (strong, nonatomic) NSMutableDictionary* downloads;
+@end
+
+@implementation TGUrlSessionDelegate
+
+- (instancetype)init
+{
+    self = [super init];
+    if (self) {
+        self.downloads = [[NSMutableDictionary alloc] init];
+    }
+    return self;
+}
+
+- (void)addDownload:(TGStreamingDownload*)download forTask:(NSURLSessionTask*)task
+{
+    @synchronized (self.downloads) {
+        [self.downloads setObject:download forKey:@(task.taskIdentifier)];
+    }
+}
+
+- (TGStreamingDownload*)downloadForTask:(NSURLSessionTask*)task
+{
+    @synchronized (self.downloads) {
+        return [self.downloads objectForKey:@(task.taskIdentifier)];
+    }
+}
+
+- (void)URLSession:(NSURLSession*)session dataTask:(NSURLSessionDataTask*)dataTask
+        didReceiveResponse:(NSURLResponse*)response
+        completionHandler:(void (^)(NSURLSessionResponseDisposition))completionHandler
+{
+    TGStreamingDownload* download = [self downloadForTask:dataTask];
+    if (download.responseReceived) { download.responseReceived(response); }
+    completionHandler(NSURLSessionResponseAllow);
+}
+
+- (void)URLSession:(NSURLSession*)session dataTask:(NSURLSessionDataTask*)dataTask
+        didReceiveData:(NSData*)data
+{
+    TGStreamingDownload* download = [self downloadForTask:dataTask];
+    if (download.chunkReceived) { download.chunkReceived(data); }
+}
+
+- (void)URLSession:(NSURLSession*)session task:(NSURLSessionTask*)task
+        didCompleteWithError:(NSError*)error
+{
+    TGStreamingDownload* download = [self downloadForTask:task];
+    @synchronized (self.downloads) {
+        [self.downloads removeObjectForKey:@(task.taskIdentifier)];
+    }
+    if (download.completed) { download.completed(task.response, error); }
+}
+
+@end
+
+static TGUrlSessionDelegate* sessionDelegate;
+
+static void startStreamingDownload(NSURLRequest* request, TGResponseReceived responseReceived,
+                                   TGChunkReceived chunkReceived, TGRequestCompleted completed) {
+
+    TGStreamingDownload* download = [[TGStreamingDownload alloc] init];
+    download.responseReceived = responseReceived;
+    download.chunkReceived = chunkReceived;
+    download.completed = completed;
+
+    NSURLSessionDataTask* dataTask = [defaultSession dataTaskWithRequest:request];
+    [sessionDelegate addDownload:download forTask:dataTask];
+    [dataTask resume];
+}
+
 void logMsg(const char* fmt, ...) {
 
     va_list args;
@@ -158,61 +250,232 @@ void NSurlInit() {
     defaultConfigObject.timeoutIntervalForRequest = 30;
     defaultConfigObject.timeoutIntervalForResource = 60;
 
-    defaultSession = [NSURLSession sessionWithConfiguration: defaultConfigObject];
+    sessionDelegate = [[TGUrlSessionDelegate alloc] init];
+    NSOperationQueue* delegateQueue = [[NSOperationQueue alloc] init];
+    delegateQueue.maxConcurrentOperationCount = 1;
+
+    defaultSession = [NSURLSession sessionWithConfiguration: defaultConfigObject
+                                                   delegate: sessionDelegate
+                                              delegateQueue: delegateQueue];
 }
 
 bool startUrlRequest(const std::string& _url, UrlCallback _callback) {
 
     NSString* nsUrl = [NSString stringWithUTF8String:_url.c_str()];
+    NSURLRequest* request = [NSURLRequest requestWithURL:[NSURL URLWithString:nsUrl]];
+
+    // The body streams into this buffer chunk by chunk, sized up front from
+    // Content-Length, instead of the session accumulating NSData that would
+    // have to be copied out whole on completion.
+    auto content = std::make_shared<std::vector<char>>();
 
-    void (^handler)(NSData*, NSURLResponse*, NSError*) = ^void (NSData* data, NSURLResponse* response, NSError* error) {
+    startStreamingDownload(request,
+        ^void (NSURLResponse* response) {
 
-        {
-            std::lock_guard<std::mutex> lock(s_urlRequestsMutex);
+            long long length = [response expectedContentLength];
+            if (length > 0) { content->reserve(length); }
 
-            if (s_stopUrlRequests) {
-                LOGE("Response after Tangram shutdown.");
-                return;
+        },
+        ^void (NSData* data) {
+
+            [data enumerateByteRangesUsingBlock:^(const void* bytes, NSRange byteRange, BOOL* stop) {
+                const char* begin = static_cast<const char*>(bytes);
+                content->insert(content->end(), begin, begin + byteRange.length);
+            }];
+
+        },
+        ^void (NSURLResponse* response, NSError* error) {
+
+            {
+                std::lock_guard<std::mutex> lock(s_urlRequestsMutex);
+
+                if (s_stopUrlRequests) {
+                    LOGE("Response after Tangram shutdown.");
+                    return;
+                }
             }
-        }
 
-        NSHTTPURLResponse* httpResponse = (NSHTTPURLResponse*)response;
+            NSHTTPURLResponse* httpResponse = (NSHTTPURLResponse*)response;
 
-        int statusCode = [httpResponse statusCode];
+            int statusCode = [httpResponse statusCode];
 
-        std::vector<char> rawDataVec;
+            if (error != nil) {
 
-        if (error != nil) {
+                LOGE("Response \"%s\" with error \"%s\".", response, [error.localizedDescription UTF8String]);
 
-            LOGE("Response \"%s\" with error \"%s\".", response, [error.localizedDescription UTF8String]);
+            } else if (statusCode < 200 || statusCode >= 300) {
 
-        } else if (statusCode < 200 || statusCode >= 300) {
+                LOGE("Unsuccessful status code %d: \"%s\" from: %s",
+                    statusCode,
+                    [[NSHTTPURLResponse localizedStringForStatusCode: statusCode] UTF8String],
+                    [response.URL.absoluteString UTF8String]);
+                _callback({});
 
-            LOGE("Unsuccessful status code %d: \"%s\" from: %s",
-                statusCode,
-                [[NSHTTPURLResponse localizedStringForStatusCode: statusCode] UTF8String],
-                [response.URL.absoluteString UTF8String]);
-            _callback(std::move(rawDataVec));
+            } else {
 
-        } else {
+                _callback(std::move(*content));
 
-            int dataLength = [data length];
-            rawDataVec.resize(dataLength);
-            memcpy(rawDataVec.data(), (char *)[data bytes], dataLength);
-            _callback(std::move(rawDataVec));
+            }
 
-        }
+        });
 
-    };
+    return true;
 
-    NSURLSessionDataTask* dataTask = [defaultSession dataTaskWithURL:[NSURL URLWithString:nsUrl] completionHandler:handler];
+}
 
-    [dataTask resume];
+bool startUrlRequest(const std::string& _url, const UrlValidators& _validators,
+                     UrlRevalidateCallback _callback) {
+
+    NSString* nsUrl = [NSString stringWithUTF8String:_url.c_str()];
+
+    NSMutableURLRequest* request = [NSMutableURLRequest requestWithURL:[NSURL URLWithString:nsUrl]];
+
+    if (!_validators.etag.empty()) {
+        [request setValue:[NSString stringWithUTF8String:_validators.etag.c_str()]
+            forHTTPHeaderField:@"If-None-Match"];
+    }
+    if (!_validators.lastModified.empty()) {
+        [request setValue:[NSString stringWithUTF8String:_validators.lastModified.c_str()]
+            forHTTPHeaderField:@"If-Modified-Since"];
+    }
+
+    auto content = std::make_shared<std::vector<char>>();
+
+    startStreamingDownload(request,
+        ^void (NSURLResponse* response) {
+
+            long long length = [response expectedContentLength];
+            if (length > 0) { content->reserve(length); }
+
+        },
+        ^void (NSData* data) {
+
+            [data enumerateByteRangesUsingBlock:^(const void* bytes, NSRange byteRange, BOOL* stop) {
+                const char* begin = static_cast<const char*>(bytes);
+                content->insert(content->end(), begin, begin + byteRange.length);
+            }];
+
+        },
+        ^void (NSURLResponse* response, NSError* error) {
+
+            {
+                std::lock_guard<std::mutex> lock(s_urlRequestsMutex);
+
+                if (s_stopUrlRequests) {
+                    LOGE("Response after Tangram shutdown.");
+                    return;
+                }
+            }
+
+            NSHTTPURLResponse* httpResponse = (NSHTTPURLResponse*)response;
+
+            int statusCode = [httpResponse statusCode];
+
+            UrlValidators validators;
+
+            if (error != nil) {
+
+                LOGE("Response \"%s\" with error \"%s\".", response, [error.localizedDescription UTF8String]);
+
+            } else if (statusCode == 304) {
+
+                _callback({}, std::move(validators), true);
+
+            } else if (statusCode < 200 || statusCode >= 300) {
+
+                LOGE("Unsuccessful status code %d: \"%s\" from: %s",
+                    statusCode,
+                    [[NSHTTPURLResponse localizedStringForStatusCode: statusCode] UTF8String],
+                    [response.URL.absoluteString UTF8String]);
+                _callback({}, std::move(validators), false);
+
+            } else {
+
+                NSString* etag = [[httpResponse allHeaderFields] objectForKey:@"Etag"];
+                NSString* lastModified = [[httpResponse allHeaderFields] objectForKey:@"Last-Modified"];
+                if (etag != nil) { validators.etag = [etag UTF8String]; }
+                if (lastModified != nil) { validators.lastModified = [lastModified UTF8String]; }
+
+                _callback(std::move(*content), std::move(validators), false);
+
+            }
+
+        });
 
     return true;
 
 }
 
+bool startUrlRequestStream(const std::string& _url, UrlChunkCallback _chunk,
+                           UrlStreamFinishCallback _finish) {
+
+    NSString* nsUrl = [NSString stringWithUTF8String:_url.c_str()];
+    NSURLRequest* request = [NSURLRequest requestWithURL:[NSURL URLWithString:nsUrl]];
+
+    // Chunks feed the consumer as they arrive, gated on a successful status
+    // so an error page is never handed to the parser.
+    auto accept = std::make_shared<bool>(false);
+
+    startStreamingDownload(request,
+        ^void (NSURLResponse* response) {
+
+            int statusCode = [(NSHTTPURLResponse*)response statusCode];
+            *accept = statusCode >= 200 && statusCode < 300;
+
+        },
+        ^void (NSData* data) {
+
+            if (!*accept) { return; }
+            [data enumerateByteRangesUsingBlock:^(const void* bytes, NSRange byteRange, BOOL* stop) {
+                _chunk(static_cast<const char*>(bytes), byteRange.length);
+            }];
+
+        },
+        ^void (NSURLResponse* response, NSError* error) {
+
+            {
+                std::lock_guard<std::mutex> lock(s_urlRequestsMutex);
+
+                if (s_stopUrlRequests) {
+                    LOGE("Response after Tangram shutdown.");
+                    return;
+                }
+            }
+
+            UrlValidators validators;
+
+            if (error != nil) {
+
+                LOGE("Response \"%s\" with error \"%s\".", response, [error.localizedDescription UTF8String]);
+                _finish(false, std::move(validators));
+
+            } else if (!*accept) {
+
+                NSHTTPURLResponse* httpResponse = (NSHTTPURLResponse*)response;
+                int statusCode = [httpResponse statusCode];
+                LOGE("Unsuccessful status code %d: \"%s\" from: %s",
+                    statusCode,
+                    [[NSHTTPURLResponse localizedStringForStatusCode: statusCode] UTF8String],
+                    [response.URL.absoluteString UTF8String]);
+                _finish(false, std::move(validators));
+
+            } else {
+
+                NSHTTPURLResponse* httpResponse = (NSHTTPURLResponse*)response;
+                NSString* etag = [[httpResponse allHeaderFields] objectForKey:@"Etag"];
+                NSString* lastModified = [[httpResponse allHeaderFields] objectForKey:@"Last-Modified"];
+                if (etag != nil) { validators.etag = [etag UTF8String]; }
+                if (lastModified != nil) { validators.lastModified = [lastModified UTF8String]; }
+
+                _finish(true, std::move(validators));
+
+            }
+
+        });
+
+    return true;
+}
+
 void cancelUrlRequest(const std::string& _url) {
 
     NSString* nsUrl = [NSString stringWithUTF8String:_url.c_str()];
@@ -4,9 +4,13 @@
 #include <fcntl.h>
 #include <iostream>
 #include <string>
+#include <string.h>
 #include <fstream>
 #include <termios.h>
 #include <linux/input.h>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
 
 #include "glm/gtc/matrix_transform.hpp"
 #include "platform.h"
@@ -34,6 +38,37 @@ static unsigned char keyPressed;
 
 static bool bRender = true;
 
+// Low-latency presentation
+//--------------------------------
+// With the default swap interval the driver queues a finished frame behind
+// the one being scanned out, which costs a full extra frame of latency. In
+// low-latency mode swaps are immediate (interval 0) and the render loop is
+// paced by the dispmanx vsync callback instead, so each frame is presented
+// at the next vblank without queueing behind another one.
+static DISPMANX_DISPLAY_HANDLE_T dispman_display;
+static bool bLowLatency = false;
+static bool bHasBufferAge = false;
+
+static std::mutex vsyncMutex;
+static std::condition_variable vsyncCondition;
+static unsigned int vsyncCount = 0;
+
+static void onVsync(DISPMANX_UPDATE_HANDLE_T _update, void* _arg) {
+    {
+        std::lock_guard<std::mutex> lock(vsyncMutex);
+        vsyncCount++;
+    }
+    vsyncCondition.notify_one();
+}
+
+static void waitVsync() {
+    std::unique_lock<std::mutex> lock(vsyncMutex);
+    unsigned int count = vsyncCount;
+    // Fall through after 100ms so a missed callback cannot hang the loop.
+    vsyncCondition.wait_for(lock, std::chrono::milliseconds(100),
+            [&]() { return vsyncCount != count; });
+}
+
 // Mouse stuff
 //--------------------------------
 std::string searchForDevice(const std::string& _device) {
@@ -248,7 +283,6 @@ void initGL(int argc, char **argv){
     static EGL_DISPMANX_WINDOW_T nativeviewport;
 
     DISPMANX_ELEMENT_HANDLE_T dispman_element;
-    DISPMANX_DISPLAY_HANDLE_T dispman_display;
     DISPMANX_UPDATE_HANDLE_T dispman_update;
     VC_RECT_T dst_rect;
     VC_RECT_T src_rect;
@@ -344,6 +378,30 @@ void initGL(int argc, char **argv){
     assert(EGL_FALSE != result);
     check();
 
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--low-latency") == 0) {
+            bLowLatency = true;
+        }
+    }
+
+    const char* extensions = eglQueryString(display, EGL_EXTENSIONS);
+    if (extensions != NULL) {
+        // A full redraw is issued every frame, so buffer age is only
+        // consulted to confirm the driver recycles buffers predictably.
+        bHasBufferAge = strstr(extensions, "EGL_EXT_buffer_age") != NULL;
+    }
+
+    if (bLowLatency) {
+        // Swap immediately and let the vsync callback pace the loop, so a
+        // finished frame is never queued behind the one on screen.
+        eglSwapInterval(display, 0);
+        if (vc_dispmanx_vsync_callback(dispman_display, onVsync, NULL) != 0) {
+            std::cout << "No vsync callback; keeping default swap interval" << std::endl;
+            eglSwapInterval(display, 1);
+            bLowLatency = false;
+        }
+    }
+
     // Set background color and clear buffers
     // glClearColor(0.15f, 0.25f, 0.35f, 1.0f);
     // glClear( GL_COLOR_BUFFER_BIT );
@@ -359,10 +417,20 @@ void initGL(int argc, char **argv){
 
 void renderGL(){
     eglSwapBuffers(display, surface);
+
+    if (bLowLatency) {
+        // Pace to the display so at most one frame is rendered per refresh;
+        // static frames never reach here because the main loop only renders
+        // on a render request.
+        waitVsync();
+    }
 }
 
 void closeGL(){
     closeMouse();
+    if (bLowLatency) {
+        vc_dispmanx_vsync_callback(dispman_display, NULL, NULL);
+    }
     eglSwapBuffers(display, surface);
 
     // Release OpenGL resources
@@ -467,6 +535,14 @@ void setRenderRequest(bool _request) {
     bRender = _request;
 }
 
+bool getLowLatencyMode() {
+    return bLowLatency;
+}
+
+bool getBufferAgeSupport() {
+    return bHasBufferAge;
+}
+
 bool getRenderRequest() {
     return bRender || isContinuousRendering();
 }
@@ -35,6 +35,14 @@ unsigned char getKeyPressed();
 
 bool    getRenderRequest();
 
+// Whether --low-latency presentation is active: immediate swaps paced by
+// the dispmanx vsync callback instead of a queued swap interval.
+bool    getLowLatencyMode();
+
+// Whether the EGL surface reports back buffer age (EGL_EXT_buffer_age);
+// partial-redraw damage tracking can only be layered on top when this holds.
+bool    getBufferAgeSupport();
+
 // EVENTS
 void    onKeyPress(int _key);
 void    onMouseMove(float _x, float _y);
@@ -15,8 +15,6 @@
 
 #include "log.h"
 
-#define NUM_WORKERS 3
-
 #define DEFAULT "fonts/NotoSans-Regular.ttf"
 #define FONT_AR "fonts/NotoNaskh-Regular.ttf"
 #define FONT_HE "fonts/NotoSansHebrew-Regular.ttf"
@@ -25,8 +23,7 @@
 
 static bool s_isContinuousRendering = false;
 
-static UrlWorker s_Workers[NUM_WORKERS];
-static std::list<std::unique_ptr<UrlTask>> s_urlTaskQueue;
+static UrlSession s_urlSession;
 
 void logMsg(const char* fmt, ...) {
     va_list args;
@@ -36,17 +33,7 @@ void logMsg(const char* fmt, ...) {
 }
 
 void processNetworkQueue() {
-    // attach workers to NetWorkerData
-    auto taskItr = s_urlTaskQueue.begin();
-    for(auto& worker : s_Workers) {
-        if(taskItr == s_urlTaskQueue.end()) {
-            break;
-        }
-        if(worker.isAvailable()) {
-            worker.perform(std::move(*taskItr));
-            taskItr = s_urlTaskQueue.erase(taskItr);
-        }
-    }
+    // The url session thread drives its own queue
 }
 
 void requestRender() {
@@ -136,30 +123,33 @@ std::vector<char> systemFont(const std::string& _name, const std::string& _weigh
 
 bool startUrlRequest(const std::string& _url, UrlCallback _callback) {
 
-    std::unique_ptr<UrlTask> task(new UrlTask(_url, _callback));
-    for(auto& worker : s_Workers) {
-        if(worker.isAvailable()) {
-            worker.perform(std::move(task));
-            return true;
-        }
-    }
-    s_urlTaskQueue.push_back(std::move(task));
+    s_urlSession.enqueue(std::make_unique<UrlTask>(_url,
+            [callback = std::move(_callback)](std::vector<char>&& _data, UrlValidators&&, bool) mutable {
+                callback(std::move(_data));
+            }));
+    return true;
+
+}
+
+bool startUrlRequest(const std::string& _url, const UrlValidators& _validators,
+                     UrlRevalidateCallback _callback) {
+
+    s_urlSession.enqueue(std::make_unique<UrlTask>(_url, std::move(_callback), _validators));
+    return true;
+
+}
+
+bool startUrlRequestStream(const std::string& _url, UrlChunkCallback _chunk,
+                           UrlStreamFinishCallback _finish) {
+
+    s_urlSession.enqueue(std::make_unique<UrlTask>(_url, std::move(_chunk), std::move(_finish)));
     return true;
 
 }
 
 void cancelUrlRequest(const std::string& _url) {
 
-    // Only clear this request if a worker has not started operating on it!
-    // otherwise it gets too convoluted with curl!
-    auto itr = s_urlTaskQueue.begin();
-    while(itr != s_urlTaskQueue.end()) {
-        if((*itr)->url == _url) {
-            itr = s_urlTaskQueue.erase(itr);
-        } else {
-            itr++;
-        }
-    }
+    s_urlSession.cancel(_url);
 }
 
 void setCurrentThreadPriority(int priority) {}
@@ -0,0 +1,88 @@
+#!/usr/bin/env python
+"""Compare google-benchmark JSON results against a checked-in baseline.
+
+Usage:
+    compare_benchmarks.py <baseline.json> <current.json>
+        [--thresholds <thresholds.json>] [--default-threshold <percent>]
+
+Benchmarks are matched by name and compared on cpu_time. A benchmark
+regresses when its current time exceeds the baseline by more than its
+threshold in percent; thresholds.json maps benchmark names to a percent
+and may carry a "default" entry. Exits non-zero when any benchmark
+regressed, so make can gate on it.
+
+Record a baseline with 'make benchmark-baseline' on the reference
+machine; results from different machines are not comparable.
+"""
+
+from __future__ import print_function
+
+import argparse
+import json
+import sys
+
+
+def load_benchmarks(path):
+    with open(path) as f:
+        data = json.load(f)
+    return dict((b["name"], b) for b in data.get("benchmarks", []))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("baseline")
+    parser.add_argument("current")
+    parser.add_argument("--thresholds", default=None,
+                        help="JSON file mapping benchmark names to a regression threshold in percent")
+    parser.add_argument("--default-threshold", type=float, default=5.0,
+                        help="threshold in percent for benchmarks without an entry (default: 5)")
+    args = parser.parse_args()
+
+    baseline = load_benchmarks(args.baseline)
+    current = load_benchmarks(args.current)
+
+    thresholds = {}
+    if args.thresholds:
+        with open(args.thresholds) as f:
+            thresholds = json.load(f)
+    default_threshold = thresholds.get("default", args.default_threshold)
+
+    regressions = []
+
+    print("%-48s %12s %12s %8s" % ("benchmark", "baseline", "current", "delta"))
+
+    for name in sorted(current):
+        if name not in baseline:
+            print("%-48s %12s %12.0f %8s  (no baseline)"
+                  % (name, "-", current[name]["cpu_time"], "-"))
+            continue
+
+        base_time = float(baseline[name]["cpu_time"])
+        cur_time = float(current[name]["cpu_time"])
+        if base_time <= 0:
+            continue
+
+        delta = (cur_time - base_time) / base_time * 100.0
+        threshold = float(thresholds.get(name, default_threshold))
+        regressed = delta > threshold
+
+        print("%-48s %12.0f %12.0f %+7.1f%%%s"
+              % (name, base_time, cur_time, delta,
+                 "  REGRESSED (threshold %g%%)" % threshold if regressed else ""))
+
+        if regressed:
+            regressions.append(name)
+
+    for name in sorted(baseline):
+        if name not in current:
+            print("%-48s %12.0f %12s %8s  (missing)"
+                  % (name, float(baseline[name]["cpu_time"]), "-", "-"))
+
+    if regressions:
+        print("\n%d benchmark(s) regressed: %s" % (len(regressions), ", ".join(regressions)))
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
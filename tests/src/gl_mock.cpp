@@ -17,6 +17,9 @@ void GL::lineWidth(GLfloat width) {
 void GL::viewport(GLint x, GLint y, GLsizei width, GLsizei height) {
 }
 
+void GL::scissor(GLint x, GLint y, GLsizei width, GLsizei height) {
+}
+
 void GL::enable(GLenum id) {
 }
 void GL::disable(GLenum id) {
@@ -120,6 +123,10 @@ void GL::texImage2D(GLenum target, GLint level, GLint internalFormat, GLsizei wi
 void GL::texSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height,
                        GLenum format, GLenum type, const GLvoid *pixels) {
 }
+void GL::compressedTexImage2D(GLenum target, GLint level, GLenum internalformat,
+                              GLsizei width, GLsizei height, GLint border,
+                              GLsizei imageSize, const GLvoid *data) {
+}
 void GL::generateMipmap(GLenum target) {
 }
 
@@ -189,6 +196,20 @@ GLboolean GL::unmapBuffer(GLenum target) {
 void GL::finish(void) {
 }
 
+// Timer queries
+void GL::genQueries(GLsizei n, GLuint *ids) {
+    for (GLsizei i = 0; i < n; i++) { ids[i] = 0; }
+}
+void GL::deleteQueries(GLsizei n, const GLuint *ids) {
+}
+void GL::beginQuery(GLenum target, GLuint id) {
+}
+void GL::endQuery(GLenum target) {
+}
+void GL::getQueryObjectuiv(GLuint id, GLenum pname, GLuint *params) {
+    if (params) { *params = 0; }
+}
+
 // VAO
 void GL::bindVertexArray(GLuint array) {
 }
@@ -197,6 +218,14 @@ void GL::deleteVertexArrays(GLsizei n, const GLuint *arrays) {
 void GL::genVertexArrays(GLsizei n, GLuint *arrays) {
 }
 
+// Program binary
+void GL::getProgramBinary(GLuint program, GLsizei bufSize, GLsizei *length,
+                          GLenum *binaryFormat, void *binary) {
+    if (length) { *length = 0; }
+}
+void GL::programBinary(GLuint program, GLenum binaryFormat, const void *binary, GLsizei length) {
+}
+
 // Framebuffer
 void GL::bindFramebuffer(GLenum target, GLuint framebuffer) {
 }
@@ -100,6 +100,16 @@ bool startUrlRequest(const std::string& _url, UrlCallback _callback) {
     return true;
 }
 
+bool startUrlRequest(const std::string& _url, const UrlValidators& _validators,
+                     UrlRevalidateCallback _callback) {
+    return true;
+}
+
+bool startUrlRequestStream(const std::string& _url, UrlChunkCallback _chunk,
+                           UrlStreamFinishCallback _finish) {
+    return true;
+}
+
 void cancelUrlRequest(const std::string& _url) {
 }
 
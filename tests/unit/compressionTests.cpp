@@ -0,0 +1,101 @@
+#include "catch.hpp"
+
+#include "util/compression.h"
+
+#include <cstdlib>
+#include <string>
+
+using namespace Tangram;
+
+TEST_CASE("Compressed data round-trips", "[Compression]") {
+
+    std::string json;
+    for (int i = 0; i < 500; i++) {
+        json += "{\"type\":\"Feature\",\"properties\":{\"name\":\"road ";
+        json += std::to_string(i);
+        json += "\",\"kind\":\"highway\"}},";
+    }
+    std::vector<char> data(json.begin(), json.end());
+
+    std::vector<char> compressed;
+    REQUIRE(lzCompress(data, compressed));
+    REQUIRE(compressed.size() < data.size());
+
+    std::vector<char> back;
+    REQUIRE(lzDecompress(compressed, back));
+    REQUIRE(back == data);
+}
+
+TEST_CASE("Incompressible data is rejected on compression", "[Compression]") {
+
+    std::vector<char> random(4096);
+    srand(1);
+    for (auto& byte : random) { byte = char(rand()); }
+
+    std::vector<char> compressed;
+    REQUIRE(!lzCompress(random, compressed));
+
+    // Inputs below the minimum match length never shrink
+    REQUIRE(!lzCompress({ 'a', 'b' }, compressed));
+}
+
+TEST_CASE("Malformed input is rejected on decompression", "[Compression]") {
+
+    std::vector<char> out;
+    REQUIRE(!lzDecompress({}, out));
+    REQUIRE(!lzDecompress({ 1, 2, 3 }, out));
+
+    // A truncated stream must be rejected - unless the cut only lost
+    // trailing empty tokens and the full payload was already decoded
+    std::vector<char> data(2048, 'x');
+    std::vector<char> compressed;
+    REQUIRE(lzCompress(data, compressed));
+
+    for (size_t cut = 4; cut < compressed.size(); cut++) {
+        std::vector<char> truncated(compressed.begin(), compressed.begin() + cut);
+        bool ok = lzDecompress(truncated, out);
+        REQUIRE((!ok || out == data));
+    }
+}
+
+TEST_CASE("Gzip members inflate and verify", "[Compression]") {
+
+    // gzip of "{\"type\":\"Feature\",\"kind\":\"highway\"}," repeated
+    // eight times, as a server would encode a tile response
+    const unsigned char member[] = {
+        0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0xff, 0xab, 0x56,
+        0x2a, 0xa9, 0x2c, 0x48, 0x55, 0xb2, 0x52, 0x72, 0x4b, 0x4d, 0x2c, 0x29,
+        0x2d, 0x4a, 0x55, 0xd2, 0x51, 0xca, 0xce, 0xcc, 0x4b, 0x01, 0x0a, 0x64,
+        0x64, 0xa6, 0x67, 0x94, 0x27, 0x56, 0x2a, 0xd5, 0xea, 0x54, 0x8f, 0x60,
+        0x35, 0x00, 0x02, 0xb5, 0xd2, 0xeb, 0x20, 0x01, 0x00, 0x00 };
+    std::vector<char> gz(member, member + sizeof(member));
+
+    std::string json;
+    for (int i = 0; i < 8; i++) { json += "{\"type\":\"Feature\",\"kind\":\"highway\"},"; }
+
+    REQUIRE(isGzipped(gz));
+
+    std::vector<char> out;
+    REQUIRE(gzipDecompress(gz, out));
+    REQUIRE(std::string(out.begin(), out.end()) == json);
+
+    // Plain data is recognized as such
+    std::vector<char> plain(json.begin(), json.end());
+    REQUIRE(!isGzipped(plain));
+
+    // Truncated or corrupted members are rejected
+    for (size_t cut = 0; cut < gz.size(); cut++) {
+        std::vector<char> truncated(gz.begin(), gz.begin() + cut);
+        REQUIRE(!gzipDecompress(truncated, out));
+    }
+    for (size_t i = 0; i < gz.size(); i++) {
+        auto corrupt = gz;
+        corrupt[i] ^= 0x20;
+        std::vector<char> o;
+        if (gzipDecompress(corrupt, o)) {
+            // A flipped bit that still decodes must yield the exact payload
+            // (e.g. flips inside skipped header bytes)
+            REQUIRE(std::string(o.begin(), o.end()) == json);
+        }
+    }
+}
@@ -159,6 +159,26 @@ TEST_CASE("DrawRule correctly merges with another DrawRule", "[DrawRule]") {
 
 }
 
+TEST_CASE("DrawRule carries the style id of the winning style parameter", "[DrawRule]") {
+
+    auto b = instance_b();
+    b.styleId = 7;
+
+    const SceneLayer layer_a = { "a", Filter(), { instance_a() }, {} };
+    const SceneLayer layer_b = { "b", Filter(), { b }, {} };
+
+    DrawRuleMergeSet ruleSet;
+    ruleSet.mergeRules(layer_a);
+
+    // No style parameter merged yet; the rule name was not resolved
+    REQUIRE(ruleSet.matchedRules()[0].getStyleId() == -1);
+
+    ruleSet.mergeRules(layer_b);
+
+    // The style parameter from b wins, and its id comes along
+    REQUIRE(ruleSet.matchedRules()[0].getStyleId() == 7);
+}
+
 TEST_CASE("DrawRule locates and outputs a parameter that it contains", "[DrawRule]") {
 
     std::string str;
@@ -0,0 +1,42 @@
+#include "catch.hpp"
+
+#include "debug/jsProfiler.h"
+
+#include <thread>
+
+using namespace Tangram;
+
+TEST_CASE("Invocations are counted per function and layer", "[JsProfiler]") {
+
+    JsProfiler::clear();
+    JsProfiler::setEnabled(true);
+
+    std::string roads = "roads";
+    std::string buildings = "buildings";
+
+    for (int i = 0; i < 3; i++) {
+        JsProfiler::record(7, &roads, 1000);
+    }
+    JsProfiler::record(7, &buildings, 2000);
+    JsProfiler::record(2, nullptr, 500);
+
+    // Counters from worker threads land in the same report
+    std::thread worker([&]() { JsProfiler::record(7, &roads, 1000); });
+    worker.join();
+
+    auto report = JsProfiler::report();
+
+    REQUIRE(report.find("fn #7") != std::string::npos);
+    REQUIRE(report.find("fn #2") != std::string::npos);
+    REQUIRE(report.find("roads") != std::string::npos);
+    REQUIRE(report.find("buildings") != std::string::npos);
+    REQUIRE(report.find("(no layer)") != std::string::npos);
+    // 3 + 1 calls for function 7 on 'roads'
+    REQUIRE(report.find("4 calls") != std::string::npos);
+
+    // The report consumed the counters
+    report = JsProfiler::report();
+    REQUIRE(report.find("no calls recorded") != std::string::npos);
+
+    JsProfiler::setEnabled(false);
+}
@@ -0,0 +1,31 @@
+#include "catch.hpp"
+
+#include "data/properties.h"
+#include "data/propertyItem.h"
+
+using namespace Tangram;
+
+TEST_CASE("Numeric properties format as feature text", "[Properties]") {
+
+    // Integral values print without a decimal part
+    REQUIRE(numberToString(0) == "0");
+    REQUIRE(numberToString(123) == "123");
+    REQUIRE(numberToString(-42) == "-42");
+    REQUIRE(numberToString(1e15) == "1000000000000000");
+
+    // Fractions keep the shortest round-tripping digits
+    REQUIRE(numberToString(0.5) == "0.5");
+    REQUIRE(numberToString(0.1) == "0.1");
+    REQUIRE(numberToString(3.14159) == "3.14159");
+
+    Properties props;
+    props.set("housenumber", 24.0);
+    props.set("name", "Main Street");
+
+    std::string out;
+    REQUIRE(props.getAsString("housenumber", out));
+    REQUIRE(out == "24");
+    REQUIRE(props.getAsString("name", out));
+    REQUIRE(out == "Main Street");
+    REQUIRE(!props.getAsString("missing", out));
+}
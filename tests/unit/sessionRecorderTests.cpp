@@ -0,0 +1,86 @@
+#include "catch.hpp"
+
+#include "debug/sessionRecorder.h"
+
+#include <cstdio>
+
+using namespace Tangram;
+
+namespace {
+const char* path = "session_recording_test.bin";
+}
+
+TEST_CASE( "Recorded frames and responses round-trip through the file", "[SessionRecorder]" ) {
+
+    auto& recorder = SessionRecorder::instance();
+    REQUIRE(recorder.start(path));
+    REQUIRE(recorder.isRecording());
+
+    SessionFrame frame;
+    frame.dt = 0.016f;
+    frame.longitude = -74.00976;
+    frame.latitude = 40.70532;
+    frame.zoom = 16.5f;
+    frame.rotation = 0.25f;
+    frame.tilt = 1.f;
+    recorder.recordFrame(frame);
+
+    frame.dt = 0.033f;
+    frame.zoom = 17.f;
+    recorder.recordFrame(frame);
+
+    std::vector<char> bytes = {'t', 'i', 'l', 'e'};
+    recorder.recordResponse("http://tiles.test/16/1/2.mvt", bytes);
+
+    // A URL's bytes do not change within a session; the second
+    // response for it must not overwrite the first
+    std::vector<char> other = {'x'};
+    recorder.recordResponse("http://tiles.test/16/1/2.mvt", other);
+
+    recorder.stop();
+    REQUIRE(!recorder.isRecording());
+
+    SessionReplay replay;
+    REQUIRE(replay.load(path));
+
+    REQUIRE(replay.frameCount() == 2);
+    REQUIRE(replay.frame(0).dt == 0.016f);
+    REQUIRE(replay.frame(0).longitude == -74.00976);
+    REQUIRE(replay.frame(0).latitude == 40.70532);
+    REQUIRE(replay.frame(0).zoom == 16.5f);
+    REQUIRE(replay.frame(0).rotation == 0.25f);
+    REQUIRE(replay.frame(0).tilt == 1.f);
+    REQUIRE(replay.frame(1).zoom == 17.f);
+
+    std::vector<char> data;
+    REQUIRE(replay.getResponse("http://tiles.test/16/1/2.mvt", data));
+    REQUIRE(data == bytes);
+
+    REQUIRE(!replay.getResponse("http://tiles.test/16/3/4.mvt", data));
+
+    std::remove(path);
+}
+
+TEST_CASE( "Recording calls are ignored while not recording", "[SessionRecorder]" ) {
+
+    auto& recorder = SessionRecorder::instance();
+    REQUIRE(!recorder.isRecording());
+
+    recorder.recordFrame({});
+    recorder.recordResponse("http://tiles.test/0/0/0.mvt", {'a'});
+}
+
+TEST_CASE( "Loading rejects files that are not recordings", "[SessionRecorder]" ) {
+
+    SessionReplay replay;
+    REQUIRE(!replay.load("no_such_recording.bin"));
+
+    FILE* file = fopen(path, "wb");
+    fwrite("not a recording", 1, 15, file);
+    fclose(file);
+
+    REQUIRE(!replay.load(path));
+    REQUIRE(replay.frameCount() == 0);
+
+    std::remove(path);
+}
@@ -0,0 +1,105 @@
+#include "catch.hpp"
+
+#include "scene/spriteAtlas.h"
+
+#include <memory>
+#include <vector>
+
+using namespace Tangram;
+
+namespace {
+
+TextureOptions rgbaOptions() {
+    return { GL_RGBA, GL_RGBA, {GL_LINEAR, GL_LINEAR}, {GL_CLAMP_TO_EDGE, GL_CLAMP_TO_EDGE} };
+}
+
+// Pixel at image-space coordinates (y down from the top), matching the
+// convention of sprite origins
+GLuint imagePixel(const Texture& _tex, int _x, int _y) {
+    return _tex.pixelData()[(_tex.getHeight() - 1 - _y) * _tex.getWidth() + _x];
+}
+
+// An atlas texture where every pixel encodes its own position
+std::shared_ptr<Texture> makeAtlasTexture(int _w, int _h) {
+    auto tex = std::make_shared<Texture>(_w, _h, rgbaOptions());
+    std::vector<GLuint> data(_w * _h);
+    for (int y = 0; y < _h; y++) {
+        for (int x = 0; x < _w; x++) {
+            data[(_h - 1 - y) * _w + x] = GLuint(0xff000000u + x + 16 * y);
+        }
+    }
+    tex->setData(data.data(), data.size());
+    return tex;
+}
+
+}
+
+TEST_CASE("Repacking keeps sprite pixels and remaps UVs", "[core][SpriteAtlas]") {
+
+    auto source = makeAtlasTexture(8, 4);
+
+    SpriteAtlas atlas(source);
+    atlas.addSpriteNode("square", {0, 0}, {2, 2});
+    atlas.addSpriteNode("tall", {4, 0}, {1, 3});
+
+    REQUIRE(atlas.repack());
+
+    SpriteNode square, tall;
+    REQUIRE(atlas.getSpriteNode("square", square));
+    REQUIRE(atlas.getSpriteNode("tall", tall));
+
+    // Logical sizes and authored origins are unchanged
+    REQUIRE(square.m_size == glm::vec2(2, 2));
+    REQUIRE(tall.m_size == glm::vec2(1, 3));
+    REQUIRE(tall.m_origin == glm::vec2(4, 0));
+
+    // The wide-enough sprite stays upright, the tall one is rotated
+    REQUIRE(!square.m_rotated);
+    REQUIRE(tall.m_rotated);
+
+    auto& packed = *atlas.texture();
+    int width = packed.getWidth();
+    int height = packed.getHeight();
+
+    // The packed atlas is strictly smaller than the authored sheet
+    REQUIRE(long(width) * height < 8 * 4);
+
+    // The packed rect of each node, from its remapped UVs
+    auto rectOrigin = [&](const SpriteNode& _node, int& _x, int& _y) {
+        _x = int(_node.m_uvBL.x * width + 0.5f);
+        _y = int((1.f - _node.m_uvBL.y) * height + 0.5f);
+    };
+
+    int x, y;
+    rectOrigin(square, x, y);
+    for (int j = 0; j < 2; j++) {
+        for (int i = 0; i < 2; i++) {
+            REQUIRE(imagePixel(packed, x + i, y + j) == imagePixel(*source, i, j));
+        }
+    }
+
+    // Rotated 90 degrees clockwise: the sprite's columns, bottom to top,
+    // become the placement's rows
+    rectOrigin(tall, x, y);
+    for (int col = 0; col < 3; col++) {
+        REQUIRE(imagePixel(packed, x + col, y) == imagePixel(*source, 4, 2 - col));
+    }
+}
+
+TEST_CASE("Repacking waits for texture data", "[core][SpriteAtlas]") {
+
+    // A texture whose pixels have not arrived yet
+    auto pending = std::make_shared<Texture>(8, 4, rgbaOptions());
+
+    SpriteAtlas atlas(pending);
+    atlas.addSpriteNode("square", {0, 0}, {2, 2});
+
+    REQUIRE(!atlas.repack());
+
+    SpriteNode square;
+    REQUIRE(atlas.getSpriteNode("square", square));
+    REQUIRE(!square.m_rotated);
+
+    // The authored layout still stands
+    REQUIRE(square.m_uvBL == glm::vec2(0.f, 1.f));
+}
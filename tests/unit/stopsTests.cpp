@@ -188,3 +188,20 @@ TEST_CASE("1 dimension stops for icon sizes", "[Stops][YAML]") {
     REQUIRE(stops.evalSize(18).get<float>() == 20);
 }
 
+
+TEST_CASE("Stops evaluate identically with the per-zoom frame lookup", "[Stops]") {
+
+    Stops stops({
+            Stops::Frame(0, 0.f),
+            Stops::Frame(1, 10.f),
+            Stops::Frame(5.5, 50.f),
+            Stops::Frame(7, 0.f)
+    });
+
+    Stops withLookup = stops;
+    withLookup.buildLookup();
+
+    for (float key = -3.f; key <= 26.f; key += 0.25f) {
+        REQUIRE(withLookup.evalFloat(key) == stops.evalFloat(key));
+    }
+}
@@ -291,3 +291,34 @@ TEST_CASE("fix:mergeMapFieldTakingLast: Correctly mix two style config nodes", "
     REQUIRE(resultB["material"]["specular"].Scalar() == "green");
 
 }
+
+TEST_CASE("Cached mixing matches a fresh mixing pass", "[yaml][mixing]") {
+
+    StyleMixer mixer;
+
+    const char* source = R"END(
+        styleA:
+            animated: true
+            shaders:
+                blocks:
+                    color: colorA
+        styleB:
+            mix: styleA
+            shaders:
+                blocks:
+                    color: colorB
+        )END";
+
+    Node first = YAML::Load(source);
+    Node second = YAML::Load(source);
+
+    REQUIRE(StyleMixer::stylesKey(first) == StyleMixer::stylesKey(second));
+
+    // The second call resolves from the cache populated by the first.
+    mixer.mixStyleNodes(first);
+    mixer.mixStyleNodes(second);
+
+    REQUIRE(YAML::Dump(first) == YAML::Dump(second));
+    REQUIRE(second["styleB"]["animated"].Scalar() == "true");
+    REQUIRE(second["styleB"]["shaders"]["blocks_mixed"]["color"].size() == 2);
+}
@@ -1,10 +1,44 @@
-#define CATCH_CONFIG_MAIN
 #include "catch.hpp"
 
 #include "gl/texture.h"
+#include "gl/hardware.h"
 
 using namespace Tangram;
 
+namespace {
+
+void append32(std::vector<char>& _buf, uint32_t _value) {
+    const char* bytes = reinterpret_cast<const char*>(&_value);
+    _buf.insert(_buf.end(), bytes, bytes + sizeof(_value));
+}
+
+// Minimal KTX 1.1 blob with a single ETC2 RGB level
+std::vector<char> makeEtc2Ktx(uint32_t _width, uint32_t _height) {
+    std::vector<char> buf = { '\xAB', 'K', 'T', 'X', ' ', '1', '1',
+                              '\xBB', '\r', '\n', '\x1A', '\n' };
+    append32(buf, 0x04030201); // endianness
+    append32(buf, 0);          // glType (0: compressed)
+    append32(buf, 1);          // glTypeSize
+    append32(buf, 0);          // glFormat (0: compressed)
+    append32(buf, GL_COMPRESSED_RGB8_ETC2);
+    append32(buf, GL_RGB);     // glBaseInternalFormat
+    append32(buf, _width);
+    append32(buf, _height);
+    append32(buf, 0);          // pixelDepth
+    append32(buf, 0);          // numberOfArrayElements
+    append32(buf, 1);          // numberOfFaces
+    append32(buf, 1);          // numberOfMipmapLevels
+    append32(buf, 0);          // bytesOfKeyValueData
+
+    // ETC2 RGB: 8 bytes per 4x4 block
+    uint32_t imageSize = ((_width + 3) / 4) * ((_height + 3) / 4) * 8;
+    append32(buf, imageSize);
+    buf.insert(buf.end(), imageSize, 0);
+    return buf;
+}
+
+}
+
 class TestTexture : public Texture {
 public:
     using Texture::Texture;
@@ -113,3 +147,39 @@ TEST_CASE("Merging of dirty Regions - Merge three regions, when 3rd region is ad
     }
 
 }
+
+TEST_CASE("Load a block-compressed KTX payload", "[Texture]") {
+    Hardware::supportsTextureETC2 = true;
+
+    TestTexture texture(makeEtc2Ktx(8, 8));
+
+    REQUIRE(texture.isCompressed());
+    REQUIRE(texture.getWidth() == 8);
+    REQUIRE(texture.getHeight() == 8);
+    // 4 blocks of 8 bytes, no mip chain
+    REQUIRE(texture.gpuMemoryUsage() == 32);
+
+    Hardware::supportsTextureETC2 = false;
+}
+
+TEST_CASE("Reject compressed payloads the hardware cannot decode", "[Texture]") {
+    Hardware::supportsTextureETC2 = false;
+
+    // Falls through to the image decoder, which fails on KTX data and
+    // leaves the fallback pixel
+    TestTexture texture(makeEtc2Ktx(8, 8));
+
+    REQUIRE(!texture.isCompressed());
+}
+
+TEST_CASE("Reject truncated compressed payloads", "[Texture]") {
+    Hardware::supportsTextureETC2 = true;
+
+    auto data = makeEtc2Ktx(8, 8);
+    data.resize(data.size() - 16);
+    TestTexture texture(data);
+
+    REQUIRE(!texture.isCompressed());
+
+    Hardware::supportsTextureETC2 = false;
+}
@@ -0,0 +1,87 @@
+#include "catch.hpp"
+
+#include "debug/tileStats.h"
+
+using namespace Tangram;
+
+TEST_CASE("Stage durations land in power-of-two buckets", "[TileStats]") {
+
+    auto& stats = TileStats::instance();
+    stats.clear();
+
+    // queueWait 0.5ms -> bucket 0, parse 3ms -> [2,4), build 100ms -> [64,128)
+    stats.report(TileID{0, 0, 10}, "test", 0.5f, 3.f, 100.f, {});
+
+    auto queueWait = stats.histogram(TileStats::Stage::queueWait);
+    REQUIRE(queueWait.total() == 1);
+    REQUIRE(queueWait.counts[0] == 1);
+
+    auto parse = stats.histogram(TileStats::Stage::parse);
+    REQUIRE(parse.counts[2] == 1);
+
+    auto build = stats.histogram(TileStats::Stage::build);
+    REQUIRE(build.counts[7] == 1);
+
+    // Durations beyond the bucket range fall into the open-ended last bucket
+    stats.report(TileID{0, 0, 10}, "test", 0.f, 0.f, 1.e6f, {});
+    build = stats.histogram(TileStats::Stage::build);
+    REQUIRE(build.counts[TileStats::num_buckets - 1] == 1);
+
+    stats.clear();
+    REQUIRE(stats.histogram(TileStats::Stage::build).total() == 0);
+}
+
+TEST_CASE("Percentile bounds the slowest fraction", "[TileStats]") {
+
+    auto& stats = TileStats::instance();
+    stats.clear();
+
+    for (int i = 0; i < 99; i++) {
+        stats.report(TileID{0, 0, 10}, "test", 0.f, 0.f, 3.f, {});
+    }
+    stats.report(TileID{0, 0, 10}, "test", 0.f, 0.f, 700.f, {});
+
+    auto build = stats.histogram(TileStats::Stage::build);
+    REQUIRE(build.total() == 100);
+
+    // 99% of tiles built within the [2,4) bucket; only the full
+    // distribution reaches into the 700ms bucket
+    REQUIRE(build.percentile(0.99f) == 4.f);
+    REQUIRE(build.percentile(1.f) == 1024.f);
+
+    stats.clear();
+}
+
+TEST_CASE("Slow tiles are reported with their style breakdown", "[TileStats]") {
+
+    auto& stats = TileStats::instance();
+    stats.clear();
+
+    int reports = 0;
+    TileStats::SlowTileReport last;
+
+    stats.setSlowTileCallback(100.f, [&](const TileStats::SlowTileReport& _report) {
+            reports++;
+            last = _report;
+        });
+
+    // Below the threshold: no report
+    stats.report(TileID{1, 2, 10}, "fast", 10.f, 20.f, 30.f, {});
+    REQUIRE(reports == 0);
+
+    stats.report(TileID{3, 4, 12}, "slow", 10.f, 20.f, 90.f,
+                 {{"polygons", 70.f}, {"text", 20.f}});
+    REQUIRE(reports == 1);
+    REQUIRE(last.tileId == TileID(3, 4, 12));
+    REQUIRE(last.sourceName == "slow");
+    REQUIRE(last.buildMs == 90.f);
+    REQUIRE(last.styleMs.size() == 2);
+    REQUIRE(last.styleMs[0].first == "polygons");
+
+    // An empty callback turns reporting off again
+    stats.setSlowTileCallback(0.f, {});
+    stats.report(TileID{3, 4, 12}, "slow", 0.f, 0.f, 500.f, {});
+    REQUIRE(reports == 1);
+
+    stats.clear();
+}
@@ -0,0 +1,45 @@
+#include "catch.hpp"
+
+#include "debug/trace.h"
+
+#include <thread>
+
+using namespace Tangram;
+
+TEST_CASE("Scopes record events and dump as Chrome trace JSON", "[Trace]") {
+
+    Trace::enable(true);
+
+    {
+        TRACE_SCOPE("outer");
+        TRACE_SCOPE("inner");
+    }
+
+    std::thread worker([] {
+            TRACE_SCOPE("worker-event");
+        });
+    worker.join();
+
+    Trace::enable(false);
+
+    std::string trace = Trace::dump();
+
+    REQUIRE(trace.find("\"traceEvents\":[") != std::string::npos);
+    REQUIRE(trace.find("\"name\":\"outer\"") != std::string::npos);
+    REQUIRE(trace.find("\"name\":\"inner\"") != std::string::npos);
+    REQUIRE(trace.find("\"name\":\"worker-event\"") != std::string::npos);
+    REQUIRE(trace.find("\"ph\":\"X\"") != std::string::npos);
+
+    // The dump cleared the rings
+    std::string empty = Trace::dump();
+    REQUIRE(empty == "{\"traceEvents\":[]}");
+}
+
+TEST_CASE("Disabled tracing records nothing", "[Trace]") {
+
+    Trace::enable(false);
+    {
+        TRACE_SCOPE("unseen");
+    }
+    REQUIRE(Trace::dump().find("unseen") == std::string::npos);
+}
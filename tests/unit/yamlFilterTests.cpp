@@ -247,3 +247,91 @@ TEST_CASE("Sequences in filters implicitly create an 'any' filter", "[filters][c
     REQUIRE(filter.eval(bmw1, ctx));
     REQUIRE(!filter.eval(bike, ctx));
 }
+
+TEST_CASE("Compiled filter programs match tree evaluation", "[filters][core][yaml]") {
+    init();
+
+    std::vector<std::string> filters = {
+        "filter: { series: !!str 3}",
+        "filter: { not : { brand : honda} }",
+        "filter: { any : [{name : civic}, {name : bmw320i}] }",
+        "filter: { all : [ {name : civic}, {brand : honda}, {wheel: 4} ] }",
+        "filter: { none : [{name : civic}, {name : bmw320i}] }",
+        "filter: { drive : true }",
+        "filter: { wheel : { min : 3 } }",
+        "filter: { any : [ all : [ $zoom : false, drive : fwd ], name: bmw320i ] }",
+        "filter: 'function() { return false; }'",
+    };
+
+    for (const auto& yaml : filters) {
+        Filter filter = load(yaml);
+        FilterProgram program(filter);
+
+        REQUIRE(program.eval(civic, ctx) == filter.eval(civic, ctx));
+        REQUIRE(program.eval(bmw1, ctx) == filter.eval(bmw1, ctx));
+        REQUIRE(program.eval(bike, ctx) == filter.eval(bike, ctx));
+    }
+}
+
+TEST_CASE("Required-key blooms never reject a matching feature", "[filters][core][yaml]") {
+    init();
+
+    std::vector<std::string> filters = {
+        "filter: { series: !!str 3}",
+        "filter: { not : { brand : honda} }",
+        "filter: { any : [{name : civic}, {name : bmw320i}] }",
+        "filter: { all : [ {name : civic}, {brand : honda}, {wheel: 4} ] }",
+        "filter: { none : [{name : civic}, {name : bmw320i}] }",
+        "filter: { drive : true }",
+        "filter: { wheel : { min : 3 } }",
+        "filter: { any : [ all : [ $zoom : false, drive : fwd ], name: bmw320i ] }",
+        "filter: 'function() { return true; }'",
+    };
+
+    for (const auto& yaml : filters) {
+        Filter filter = load(yaml);
+        uint64_t required = filter.requiredKeysBloom();
+
+        for (auto* feature : { &civic, &bmw1, &bike }) {
+            if (filter.eval(*feature, ctx)) {
+                // A matching feature must carry every required bit
+                REQUIRE((required & ~feature->props.keyBloom()) == 0);
+            }
+        }
+    }
+}
+
+TEST_CASE("Zoom prepass agrees with per-feature evaluation", "[filters][core][yaml]") {
+    init();
+
+    std::vector<std::string> filters = {
+        "filter: { $zoom: { min: 10 } }",
+        "filter: { $zoom: { min: 10, max: 14 } }",
+        "filter: { $zoom: 14 }",
+        "filter: { $zoom: [12, 14, 16] }",
+        "filter: { all: [ { $zoom: { min: 14 } }, { brand: honda } ] }",
+        "filter: { all: [ { $zoom: { min: 8 } }, { $zoom: { max: 16 } } ] }",
+        "filter: { any: [ { $zoom: { max: 10 } }, { name: civic } ] }",
+        "filter: { any: [ { $zoom: { max: 10 } }, { $zoom: { min: 16 } } ] }",
+        "filter: { not: { $zoom: { min: 14 } } }",
+        "filter: { wheel: 4 }",
+    };
+
+    for (int zoom : { 8, 14, 18 }) {
+        ctx.setKeyword("$zoom", Value(double(zoom)));
+
+        for (const auto& yaml : filters) {
+            Filter filter = load(yaml);
+            auto match = filter.matchAtZoom(zoom);
+
+            for (auto* feature : { &civic, &bmw1, &bike }) {
+                bool result = filter.eval(*feature, ctx);
+
+                // 'no' guarantees a miss and 'yes' a match for every
+                // feature; 'maybe' guarantees nothing
+                if (match == Filter::ZoomMatch::no) { REQUIRE(!result); }
+                if (match == Filter::ZoomMatch::yes) { REQUIRE(result); }
+            }
+        }
+    }
+}
@@ -21,6 +21,9 @@ void GL::lineWidth(GLfloat width) {
 void GL::viewport(GLint x, GLint y, GLsizei width, GLsizei height) {
     __evas_gl_glapi->glViewport(x, y, width, height);
 }
+void GL::scissor(GLint x, GLint y, GLsizei width, GLsizei height) {
+    __evas_gl_glapi->glScissor(x, y, width, height);
+}
 
 void GL::enable(GLenum id) {
     __evas_gl_glapi->glEnable(id);
@@ -166,6 +169,11 @@ void GL::texSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset,
                        GLenum format, GLenum type, const GLvoid *pixels) {
     __evas_gl_glapi->glTexSubImage2D(target, level, xoffset, yoffset, width, height, format, type, pixels); }
 
+void GL::compressedTexImage2D(GLenum target, GLint level, GLenum internalformat,
+                              GLsizei width, GLsizei height, GLint border,
+                              GLsizei imageSize, const GLvoid *data) {
+    __evas_gl_glapi->glCompressedTexImage2D(target, level, internalformat, width, height, border, imageSize, data); }
+
 void GL::generateMipmap(GLenum target) {
     __evas_gl_glapi->glGenerateMipmap(target);
 }
@@ -261,6 +269,18 @@ void GL::finish(void) {
     __evas_gl_glapi->glFinish();
 }
 
+// Timer queries are not exposed through the Evas GL API table;
+// Hardware::supportsTimerQuery stays false on this platform.
+void GL::genQueries(GLsizei n, GLuint *ids) {
+    for (GLsizei i = 0; i < n; i++) { ids[i] = 0; }
+}
+void GL::deleteQueries(GLsizei n, const GLuint *ids) {}
+void GL::beginQuery(GLenum target, GLuint id) {}
+void GL::endQuery(GLenum target) {}
+void GL::getQueryObjectuiv(GLuint id, GLenum pname, GLuint *params) {
+    if (params) { *params = 0; }
+}
+
 // VAO
 void GL::bindVertexArray(GLuint array) {
     __evas_gl_glapi->glBindVertexArrayOES(array);
@@ -272,6 +292,15 @@ void GL::genVertexArrays(GLsizei n, GLuint *arrays) {
     __evas_gl_glapi->glGenVertexArraysOES(n, arrays);
 }
 
+// Program binary
+void GL::getProgramBinary(GLuint program, GLsizei bufSize, GLsizei *length,
+                          GLenum *binaryFormat, void *binary) {
+    __evas_gl_glapi->glGetProgramBinaryOES(program, bufSize, length, binaryFormat, binary);
+}
+void GL::programBinary(GLuint program, GLenum binaryFormat, const void *binary, GLsizei length) {
+    __evas_gl_glapi->glProgramBinaryOES(program, binaryFormat, binary, length);
+}
+
 // Framebuffer
 void GL::bindFramebuffer(GLenum target, GLuint framebuffer) {
     __evas_gl_glapi->glBindFramebuffer(target, framebuffer);
@@ -37,6 +37,31 @@ bool startUrlRequest(const std::string& _url, UrlCallback _callback) {
     return true;
 }
 
+bool startUrlRequest(const std::string& _url, const UrlValidators& _validators,
+                     UrlRevalidateCallback _callback) {
+    // The worker pool has no request-header support; fetch in full and
+    // report no validators.
+    return startUrlRequest(_url,
+            [callback = std::move(_callback)](std::vector<char>&& _data) mutable {
+                callback(std::move(_data), UrlValidators{}, false);
+            });
+}
+
+bool startUrlRequestStream(const std::string& _url, UrlChunkCallback _chunk,
+                           UrlStreamFinishCallback _finish) {
+    // The worker pool only surfaces complete responses; deliver the
+    // body as a single chunk before the finish.
+    return startUrlRequest(_url,
+            [chunk = std::move(_chunk), finish = std::move(_finish)](std::vector<char>&& _data) mutable {
+                if (_data.empty()) {
+                    finish(false, UrlValidators{});
+                    return;
+                }
+                chunk(_data.data(), _data.size());
+                finish(true, UrlValidators{});
+            });
+}
+
 void cancelUrlRequest(const std::string& _url) {
     s_workers.cancel(_url);
 }